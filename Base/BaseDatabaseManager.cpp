@@ -4,6 +4,10 @@
 #include <QElapsedTimer>
 #include <QThread>
 
+#include "AuditTrail.h"
+#include "TraceSpan.h"
+#include "WorkloadCapture.h"
+
 // ============================================================================
 // 连接池实现
 // ============================================================================
@@ -17,33 +21,47 @@ void ConnectionPool::cleanupFinishedThreads() {
   for (const QString& tid : stale) {
     auto& q = m_availableByThread[tid];
     while (!q.isEmpty()) {
-      QSqlDatabase::removeDatabase(q.dequeue());
+      removeConnectionUnsafe(q.dequeue());
     }
     m_availableByThread.remove(tid);
     m_activeTxByThread.remove(tid);
+    m_txHooksByThread.remove(tid);
     m_threadRefs.remove(tid);
   }
 }
 
+void ConnectionPool::removeConnectionUnsafe(const QString& name) {
+  // 先卸下变更钩子：钩子上下文随之释放，连接关闭时不再回调
+  if (m_changeFeed) m_changeFeed->detach(name);
+  // 先丢弃句柄，统计不会再读到即将关闭的连接
+  m_nativeHandles.remove(name);
+  // 缓存的语句须在关闭连接前终结
+  m_statementCaches.remove(name);
+  QSqlDatabase::removeDatabase(name);
+}
+
 ConnectionPool::ConnectionPool(const DatabaseConfig& config)
-    : m_connectionNamePrefix(config.connectionName), m_config(config) {}
+    : m_connectionNamePrefix(config.connectionName),
+      m_config(config),
+      m_mutex(QString("ConnectionPool::m_mutex[%1]").arg(config.dbName)) {}
 
 ConnectionPool::~ConnectionPool() {
-  QMutexLocker locker(&m_mutex);
+  ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
   // 先清空可用
   for (auto& q : m_availableByThread) {
-    while (!q.isEmpty()) QSqlDatabase::removeDatabase(q.dequeue());
+    while (!q.isEmpty()) removeConnectionUnsafe(q.dequeue());
   }
   // 再移除使用中（理论上关闭前应已归还）
   for (const QString& name : m_usedConnections) {
-    QSqlDatabase::removeDatabase(name);
+    removeConnectionUnsafe(name);
   }
   m_usedConnections.clear();
   m_connOwner.clear();
 }
 
 QString ConnectionPool::acquireConnection() {
-  QMutexLocker locker(&m_mutex);
+  DB_TRACE_SPAN("pool.acquire");
+  ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
   const QString tid = currentTid();
 
   cleanupFinishedThreads();
@@ -63,7 +81,10 @@ QString ConnectionPool::acquireConnection() {
   }
 
   // 全局连接总数达上限则失败
-  if (totalConnectionsUnsafe() >= m_config.maxConnections) return QString();
+  if (totalConnectionsUnsafe() >= m_config.maxConnections) {
+    ++m_exhaustedCount;
+    return QString();
+  }
 
   QString name = createConnectionInCurrentThread();  // 在当前线程创建
   if (!name.isEmpty()) {
@@ -74,7 +95,10 @@ QString ConnectionPool::acquireConnection() {
 }
 
 void ConnectionPool::releaseConnection(const QString& name) {
-  QMutexLocker locker(&m_mutex);
+  DB_TRACE_SPAN("pool.release");
+  // 连接上已落定的提交在归还前发布：此时不在SQLite写锁内，也不持池锁
+  if (ChangeFeed* feed = changeFeed()) feed->dispatch(name);
+  ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
   cleanupFinishedThreads();
   if (!m_usedConnections.contains(name)) return;
   // 若该连接正被某线程作为活动事务绑定，则忽略释放
@@ -88,13 +112,13 @@ void ConnectionPool::releaseConnection(const QString& name) {
 }
 
 int ConnectionPool::forceCloseIdleConnections() {
-  QMutexLocker locker(&m_mutex);
+  ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
   int closed = 0;
   for (auto it = m_availableByThread.begin(); it != m_availableByThread.end();
        ++it) {
     auto& q = it.value();
     while (!q.isEmpty()) {
-      QSqlDatabase::removeDatabase(q.dequeue());
+      removeConnectionUnsafe(q.dequeue());
       ++closed;
     }
   }
@@ -102,7 +126,7 @@ int ConnectionPool::forceCloseIdleConnections() {
 }
 
 int ConnectionPool::availableCount() const {
-  QMutexLocker locker(&m_mutex);
+  ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
   int total = 0;
   for (auto it = m_availableByThread.constBegin();
        it != m_availableByThread.constEnd(); ++it) {
@@ -112,10 +136,47 @@ int ConnectionPool::availableCount() const {
 }
 
 int ConnectionPool::usedCount() const {
-  QMutexLocker locker(&m_mutex);
+  ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
   return m_usedConnections.size();
 }
 
+QHash<QString, SqliteMemoryStats> ConnectionPool::connectionMemoryStats()
+    const {
+  // 持锁期间连接不会被移除，句柄保持有效
+  ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
+  QHash<QString, SqliteMemoryStats> stats;
+  for (auto it = m_nativeHandles.constBegin(); it != m_nativeHandles.constEnd();
+       ++it) {
+    // 多线程模式下连接没有互斥锁，不读取正被其他线程使用的连接
+    if (NativeStatement::multiThreadMode() &&
+        m_usedConnections.contains(it.key())) {
+      continue;
+    }
+    stats.insert(it.key(), SqliteMemory::connection(it.value()));
+  }
+  return stats;
+}
+
+SqliteMemoryStats ConnectionPool::memoryStats() const {
+  ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
+  SqliteMemoryStats total;
+  for (auto it = m_nativeHandles.constBegin(); it != m_nativeHandles.constEnd();
+       ++it) {
+    if (NativeStatement::multiThreadMode() &&
+        m_usedConnections.contains(it.key())) {
+      continue;
+    }
+    total.merge(SqliteMemory::connection(it.value()));
+  }
+  return total;
+}
+
+NativeStatementCache* ConnectionPool::statementCache(
+    const QString& connectionName) const {
+  ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
+  return m_statementCaches.value(connectionName).get();
+}
+
 QString ConnectionPool::createConnection() {
   QString connectionName =
       QString("%1_%2").arg(m_connectionNamePrefix).arg(++m_connectionCounter);
@@ -139,6 +200,7 @@ QString ConnectionPool::createConnection() {
 }
 
 QString ConnectionPool::createConnectionInCurrentThread() {
+  DB_TRACE_SPAN("pool.connect");
   QString threadId =
       QString::number(reinterpret_cast<qintptr>(QThread::currentThread()));
   QString connectionName = QString("%1_%2_%3")
@@ -166,6 +228,9 @@ QString ConnectionPool::createConnectionInCurrentThread() {
 void ConnectionPool::configureDatabase(QSqlDatabase& db) {
   QSqlQuery query(db);
 
+  // 负载采集按配置名区分语句所属的库
+  WorkloadCapture::tagConnection(db, m_config.dbName);
+
   // 启用外键约束
   if (m_config.enableForeignKeys) {
     query.exec("PRAGMA foreign_keys = ON");
@@ -181,11 +246,28 @@ void ConnectionPool::configureDatabase(QSqlDatabase& db) {
 
   // 设置缓存大小
   query.exec("PRAGMA cache_size = 10000");
+
+  // 挂接变更捕获钩子（调用方已持有 m_mutex）
+  if (m_changeFeed) m_changeFeed->attach(db);
+
+  // 注册原生SQL函数（表达式索引等依赖它们，每条连接都要有）
+  QString error;
+  if (!SqlFunctions::apply(db, m_sqlFunctions, &error)) {
+    qWarning() << error;
+  }
+
+  // 记下句柄供内存统计从其他线程读取
+  if (void* handle = SqliteMemory::nativeHandle(db)) {
+    m_nativeHandles.insert(db.connectionName(), handle);
+    m_statementCaches.insert(db.connectionName(),
+                             std::make_shared<NativeStatementCache>(handle));
+  }
 }
 
 // ---- 线程事务：开始/提交/回滚 ----
 QString ConnectionPool::beginThreadTransaction() {
-  QMutexLocker locker(&m_mutex);
+  DB_TRACE_SPAN("tx.begin");
+  ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
   const QString tid = currentTid();
   if (m_activeTxByThread.contains(tid)) {
     return m_activeTxByThread.value(tid);  // 已有事务，复用
@@ -209,7 +291,7 @@ QString ConnectionPool::beginThreadTransaction() {
   // 在这条连接上开启事务
   locker.unlock();
   QSqlDatabase db = QSqlDatabase::database(name);
-  if (!db.isOpen() || !db.transaction()) {
+  if (!db.isOpen() || !SqlExec::begin(db)) {
     locker.relock();
     // 回退：放回可用队列
     m_usedConnections.remove(name);
@@ -222,34 +304,76 @@ QString ConnectionPool::beginThreadTransaction() {
 }
 
 bool ConnectionPool::commitThreadTransaction() {
+  DB_TRACE_SPAN("tx.commit");
   QString name;
+  QVector<TxHook> hooks;
   {
-    QMutexLocker locker(&m_mutex);
+    ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
     const QString tid = currentTid();
     name = m_activeTxByThread.take(tid);
+    hooks = m_txHooksByThread.take(tid);
   }
   if (name.isEmpty()) return false;
   QSqlDatabase db = QSqlDatabase::database(name);
-  bool ok = db.commit();
+  bool ok = SqlExec::commit(db);
+  if (!ok) SqlExec::rollback(db);  // 提交失败的事务不会生效
   // 提交后归还连接
   releaseConnection(name);
+  runTxHooks(hooks, ok);
   return ok;
 }
 
 bool ConnectionPool::rollbackThreadTransaction() {
+  DB_TRACE_SPAN("tx.rollback");
   QString name;
+  QVector<TxHook> hooks;
   {
-    QMutexLocker locker(&m_mutex);
+    ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
     const QString tid = currentTid();
     name = m_activeTxByThread.take(tid);
+    hooks = m_txHooksByThread.take(tid);
   }
   if (name.isEmpty()) return false;
   QSqlDatabase db = QSqlDatabase::database(name);
-  bool ok = db.rollback();
+  bool ok = SqlExec::rollback(db);
   releaseConnection(name);
+  runTxHooks(hooks, false);
   return ok;
 }
 
+bool ConnectionPool::hasThreadTransaction() const {
+  ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
+  return m_activeTxByThread.contains(currentTid());
+}
+
+bool ConnectionPool::afterThreadTransaction(
+    std::function<void()> onCommit, std::function<void()> onRollback) {
+  {
+    ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
+    const QString tid = currentTid();
+    if (m_activeTxByThread.contains(tid)) {
+      m_txHooksByThread[tid].append(
+          TxHook{std::move(onCommit), std::move(onRollback)});
+      return true;
+    }
+  }
+  if (onCommit) onCommit();
+  return false;
+}
+
+void ConnectionPool::runTxHooks(const QVector<TxHook>& hooks,
+                                bool committed) {
+  if (committed) {
+    for (const TxHook& hook : hooks) {
+      if (hook.onCommit) hook.onCommit();
+    }
+    return;
+  }
+  for (int i = hooks.size() - 1; i >= 0; --i) {
+    if (hooks[i].onRollback) hooks[i].onRollback();
+  }
+}
+
 // ============================================================================
 // BaseDatabaseManager实现
 // ============================================================================
@@ -260,9 +384,15 @@ BaseDatabaseManager::BaseDatabaseManager(DatabaseType dbType,
     : QObject(parent),
       m_databaseType(dbType),
       m_config(config),
-      m_healthCheckTimer(nullptr) {
-  // 初始化连接池
+      m_dbMutex(
+          QString("BaseDatabaseManager::m_dbMutex[%1]").arg(config.dbName)),
+      m_healthCheckTimer(nullptr),
+      m_statsMutex(
+          QString("BaseDatabaseManager::m_statsMutex[%1]").arg(config.dbName)) {
+  // 初始化变更流与连接池
+  m_changeFeed = std::make_unique<ChangeFeed>(config.dbName);
   m_connectionPool = std::make_unique<ConnectionPool>(config);
+  m_connectionPool->setChangeFeed(m_changeFeed.get());
 
   // 初始化统计信息
   m_stats.lastQueryTime = QDateTime::currentDateTime();
@@ -278,68 +408,103 @@ BaseDatabaseManager::~BaseDatabaseManager() {
 }
 
 bool BaseDatabaseManager::initialize() {
-  QMutexLocker locker(&m_dbMutex);
+  ProfiledMutexLocker locker(&m_dbMutex, DB_LOCK_SITE);
 
   qInfo() << QString("初始化数据库 [%1]: %2")
                  .arg(m_config.dbName)
                  .arg(m_config.filePath);
 
+  m_startupProfile.begin();
+  const bool ok = initializePhases();
+  m_startupProfile.finish(ok);
+  if (ok) {
+    qInfo() << QString("数据库初始化完成 [%1]，耗时 %2 ms")
+                   .arg(m_config.dbName)
+                   .arg(m_startupProfile.totalUs() / 1000.0, 0, 'f', 1);
+    emit databaseInitialized(true);
+  }
+  return ok;
+}
+
+bool BaseDatabaseManager::initializePhases() {
   try {
     // 若连接池已在 close() 中释放，则此处重建
     if (!m_connectionPool) {
+      StartupProfile::Scope phase(&m_startupProfile, "pool");
       m_connectionPool = std::make_unique<ConnectionPool>(m_config);
+      m_connectionPool->setChangeFeed(m_changeFeed.get());
     }
+    m_connectionPool->setSqlFunctions(sqlFunctions());
 
     // 创建数据库目录
-    if (!createDatabaseDirectory()) {
-      emit databaseError("创建数据库目录失败");
-      return false;
+    {
+      StartupProfile::Scope phase(&m_startupProfile, "directory");
+      if (!createDatabaseDirectory()) {
+        emit databaseError("创建数据库目录失败");
+        return phase.fail();
+      }
     }
 
     // 建立主连接
-    m_database = QSqlDatabase::addDatabase("QSQLITE", m_config.connectionName);
-
-    m_database.setConnectOptions(
-        QString("QSQLITE_BUSY_TIMEOUT=%1").arg(m_config.busyTimeout));
-
-    m_database.setDatabaseName(m_config.filePath);
-
-    if (!m_database.open()) {
-      QString error =
-          QString("打开数据库失败: %1").arg(m_database.lastError().text());
-      qCritical() << error;
-      emit databaseError(error);
-      return false;
+    {
+      StartupProfile::Scope phase(&m_startupProfile, "open");
+      m_database =
+          QSqlDatabase::addDatabase("QSQLITE", m_config.connectionName);
+
+      m_database.setConnectOptions(
+          QString("QSQLITE_BUSY_TIMEOUT=%1").arg(m_config.busyTimeout));
+
+      m_database.setDatabaseName(m_config.filePath);
+
+      if (!m_database.open()) {
+        QString error =
+            QString("打开数据库失败: %1").arg(m_database.lastError().text());
+        qCritical() << error;
+        emit databaseError(error);
+        return phase.fail();
+      }
     }
 
     // 配置数据库连接
-    if (!configureDatabaseConnection()) {
-      emit databaseError("配置数据库连接失败");
-      return false;
+    {
+      StartupProfile::Scope phase(&m_startupProfile, "configure");
+      if (!configureDatabaseConnection()) {
+        emit databaseError("配置数据库连接失败");
+        return phase.fail();
+      }
     }
 
     // 执行初始化SQL
-    if (!executeInitSql()) {
-      emit databaseError("执行初始化SQL失败");
-      return false;
+    {
+      StartupProfile::Scope phase(&m_startupProfile, "initSql");
+      if (!executeInitSql()) {
+        emit databaseError("执行初始化SQL失败");
+        return phase.fail();
+      }
     }
 
     // 注册表
-    registerTables();
+    {
+      StartupProfile::Scope phase(&m_startupProfile, "registerTables");
+      registerTables();
+    }
 
     // 创建所有表
-    if (!createAllTables()) {
-      emit databaseError("创建数据表失败");
-      return false;
+    {
+      StartupProfile::Scope phase(&m_startupProfile, "createTables");
+      if (!createAllTables()) {
+        emit databaseError("创建数据表失败");
+        return phase.fail();
+      }
     }
 
     // 初始化健康检查
     qInfo() << "数据库表创建阶段完成，开始初始化健康检查...";
-    initializeHealthCheck();
+    {
+      StartupProfile::Scope phase(&m_startupProfile, "healthTimer");
+      initializeHealthCheck();
+    }
     qInfo() << "健康检查初始化完成";
-
-    qInfo() << QString("数据库初始化完成 [%1]").arg(m_config.dbName);
-    emit databaseInitialized(true);
     return true;
 
   } catch (const std::exception& e) {
@@ -352,7 +517,7 @@ bool BaseDatabaseManager::initialize() {
 }
 
 void BaseDatabaseManager::close() {
-  QMutexLocker locker(&m_dbMutex);
+  ProfiledMutexLocker locker(&m_dbMutex, DB_LOCK_SITE);
 
   // 停止健康检查
   if (m_healthCheckTimer) {
@@ -378,6 +543,7 @@ void BaseDatabaseManager::close() {
 
   // 关闭主连接
   QString connectionName = m_config.connectionName;
+  m_changeFeed->detach(connectionName);
   if (m_database.isOpen()) {
     m_database.close();
   }
@@ -393,19 +559,22 @@ void BaseDatabaseManager::close() {
 }
 
 bool BaseDatabaseManager::isOpen() const {
-  QMutexLocker locker(&m_dbMutex);
+  ProfiledMutexLocker locker(&m_dbMutex, DB_LOCK_SITE);
   return m_database.isOpen();
 }
 
 bool BaseDatabaseManager::beginTransaction() {
-  QMutexLocker locker(&m_dbMutex);
+  ProfiledMutexLocker locker(&m_dbMutex, DB_LOCK_SITE);
   // 优先使用连接池的“线程事务”，以绑定具体连接
   if (m_connectionPool) {
+    const bool reused = m_connectionPool->hasThreadTransaction();
     const QString name = m_connectionPool->beginThreadTransaction();
     if (name.isEmpty()) {
       qWarning() << "开始线程事务失败";
       return false;
     }
+    // 审计记录随事务暂存：提交后入队，回滚则丢弃（复用的事务不再加层）
+    if (!reused) AuditTrail::beginDeferred(&m_database);
     emit transactionBegin();
     qDebug() << "事务开始（池连接）:" << name;
     return true;
@@ -415,19 +584,27 @@ bool BaseDatabaseManager::beginTransaction() {
     qWarning() << "数据库未打开，无法开始事务";
     return false;
   }
-  const bool ok = m_database.transaction();
-  if (ok) emit transactionBegin();
+  // 主连接上已落定的自动提交写入先发布，不与新事务的回滚混在一起
+  m_changeFeed->dispatch(m_database.connectionName());
+  const bool ok = SqlExec::begin(m_database);
+  if (ok) {
+    AuditTrail::beginDeferred(&m_database);
+    emit transactionBegin();
+  }
   return ok;
 }
 
 bool BaseDatabaseManager::commitTransaction() {
-  QMutexLocker locker(&m_dbMutex);
+  ProfiledMutexLocker locker(&m_dbMutex, DB_LOCK_SITE);
   if (m_connectionPool) {
+    const bool active = m_connectionPool->hasThreadTransaction();
     const bool ok = m_connectionPool->commitThreadTransaction();
     if (!ok) {
+      if (active) AuditTrail::discardDeferred(&m_database);
       qWarning() << "提交线程事务失败";
       return false;
     }
+    AuditTrail::commitDeferred(&m_database);
     emit transactionCommitted();
     qDebug() << "事务提交成功（池连接）";
     return true;
@@ -436,15 +613,21 @@ bool BaseDatabaseManager::commitTransaction() {
     qWarning() << "数据库未打开，无法提交事务";
     return false;
   }
-  const bool ok = m_database.commit();
-  if (ok) emit transactionCommitted();
+  const bool ok = SqlExec::commit(m_database);
+  if (ok) {
+    m_changeFeed->dispatch(m_database.connectionName());
+    AuditTrail::commitDeferred(&m_database);
+    emit transactionCommitted();
+  }
   return ok;
 }
 
 bool BaseDatabaseManager::rollbackTransaction() {
-  QMutexLocker locker(&m_dbMutex);
+  ProfiledMutexLocker locker(&m_dbMutex, DB_LOCK_SITE);
   if (m_connectionPool) {
+    const bool active = m_connectionPool->hasThreadTransaction();
     const bool ok = m_connectionPool->rollbackThreadTransaction();
+    if (active) AuditTrail::discardDeferred(&m_database);
     if (!ok) {
       qWarning() << "回滚线程事务失败";
       return false;
@@ -457,8 +640,11 @@ bool BaseDatabaseManager::rollbackTransaction() {
     qWarning() << "数据库未打开，无法回滚事务";
     return false;
   }
-  const bool ok = m_database.rollback();
-  if (ok) emit transactionRolledBack();
+  const bool ok = SqlExec::rollback(m_database);
+  if (ok) {
+    AuditTrail::discardDeferred(&m_database);
+    emit transactionRolledBack();
+  }
   return ok;
 }
 
@@ -496,7 +682,11 @@ bool BaseDatabaseManager::createAllTables() {
 
     try {
       qDebug() << "调用 createTable() 方法...";
+      StartupProfile::Scope phase(
+          &m_startupProfile,
+          QString("createTable[%1]").arg(table->tableName()));
       bool result = table->createTable();
+      if (!result) phase.fail();
       qDebug() << "createTable() 返回结果:" << result;
 
       if (result) {
@@ -554,7 +744,7 @@ bool BaseDatabaseManager::dropAllTables() {
 }
 
 bool BaseDatabaseManager::healthCheck() {
-  QMutexLocker locker(&m_dbMutex);
+  ProfiledMutexLocker locker(&m_dbMutex, DB_LOCK_SITE);
 
   if (!m_database.isOpen()) {
     return false;
@@ -578,7 +768,7 @@ bool BaseDatabaseManager::healthCheck() {
 }
 
 bool BaseDatabaseManager::optimizeDatabase() {
-  QMutexLocker locker(&m_dbMutex);
+  ProfiledMutexLocker locker(&m_dbMutex, DB_LOCK_SITE);
 
   if (!m_database.isOpen()) {
     return false;
@@ -600,7 +790,7 @@ bool BaseDatabaseManager::optimizeDatabase() {
   if (m_config.enableWAL) {
     QElapsedTimer t;
     t.start();
-    bool walOk = query.exec("PRAGMA wal_checkpoint(TRUNCATE)");
+    bool walOk = SqlExec::run(query, "PRAGMA wal_checkpoint(TRUNCATE)");
     recordQueryStats(walOk, static_cast<double>(t.elapsed()));
     // walOk 失败不立即置 overall 失败，仅记录日志由下面流程汇总
   }
@@ -608,7 +798,7 @@ bool BaseDatabaseManager::optimizeDatabase() {
   {
     QElapsedTimer t;
     t.start();
-    bool ok = query.exec("VACUUM");
+    bool ok = SqlExec::run(query, "VACUUM");
     recordQueryStats(ok, static_cast<double>(t.elapsed()));
     if (!ok) {
       qWarning() << "VACUUM失败:" << query.lastError().text();
@@ -619,7 +809,7 @@ bool BaseDatabaseManager::optimizeDatabase() {
   {
     QElapsedTimer t;
     t.start();
-    bool ok = query.exec("ANALYZE");
+    bool ok = SqlExec::run(query, "ANALYZE");
     recordQueryStats(ok, static_cast<double>(t.elapsed()));
     if (!ok) {
       qWarning() << "ANALYZE失败:" << query.lastError().text();
@@ -634,7 +824,7 @@ bool BaseDatabaseManager::optimizeDatabase() {
 }
 
 bool BaseDatabaseManager::backupDatabase(const QString& backupPath) {
-  QMutexLocker locker(&m_dbMutex);
+  ProfiledMutexLocker locker(&m_dbMutex, DB_LOCK_SITE);
 
   if (!m_database.isOpen()) {
     return false;
@@ -710,12 +900,25 @@ bool BaseDatabaseManager::restoreDatabase(const QString& backupPath) {
 }
 
 BaseDatabaseManager::DatabaseStats BaseDatabaseManager::getStatistics() const {
-  QMutexLocker locker(&m_statsMutex);
-  return m_stats;
+  DatabaseStats stats;
+  {
+    ProfiledMutexLocker locker(&m_statsMutex, DB_LOCK_SITE);
+    stats = m_stats;
+  }
+
+  // 内存与页缓存在调用时现采：主连接加池内全部打开的连接
+  {
+    ProfiledMutexLocker locker(&m_dbMutex, DB_LOCK_SITE);
+    stats.sqlite =
+        SqliteMemory::connection(SqliteMemory::nativeHandle(m_database));
+    if (m_connectionPool) stats.sqlite.merge(m_connectionPool->memoryStats());
+  }
+  stats.sqliteProcess = SqliteMemory::process();
+  return stats;
 }
 
 void BaseDatabaseManager::resetStatistics() {
-  QMutexLocker locker(&m_statsMutex);
+  ProfiledMutexLocker locker(&m_statsMutex, DB_LOCK_SITE);
   m_stats = DatabaseStats{};
   m_stats.lastQueryTime = QDateTime::currentDateTime();
 }
@@ -731,6 +934,11 @@ qint64 BaseDatabaseManager::getDatabaseSize() const {
   return total;
 }
 
+StartupProfile BaseDatabaseManager::startupProfile() const {
+  ProfiledMutexLocker locker(&m_dbMutex, DB_LOCK_SITE);
+  return m_startupProfile;
+}
+
 bool BaseDatabaseManager::createDatabaseDirectory() {
   QFileInfo fileInfo(m_config.filePath);
   QDir dir = fileInfo.absoluteDir();
@@ -748,10 +956,18 @@ bool BaseDatabaseManager::createDatabaseDirectory() {
 
 bool BaseDatabaseManager::configureDatabaseConnection() {
   QSqlQuery query(m_database);
+  WorkloadCapture::tagConnection(m_database, m_config.dbName);
+
+  // 每个 PRAGMA 单独计时（journal_mode 切换 WAL 时要写文件头）
+  auto pragma = [this, &query](const char* name, const QString& sql) {
+    StartupProfile::Scope phase(&m_startupProfile,
+                                QString("pragma.%1").arg(name));
+    return query.exec(sql) || phase.fail();
+  };
 
   // 启用外键约束
   if (m_config.enableForeignKeys) {
-    if (!query.exec("PRAGMA foreign_keys = ON")) {
+    if (!pragma("foreign_keys", "PRAGMA foreign_keys = ON")) {
       qWarning() << "启用外键约束失败:" << query.lastError().text();
       return false;
     }
@@ -759,19 +975,34 @@ bool BaseDatabaseManager::configureDatabaseConnection() {
 
   // 设置WAL模式
   if (m_config.enableWAL) {
-    if (!query.exec("PRAGMA journal_mode = WAL")) {
+    if (!pragma("journal_mode", "PRAGMA journal_mode = WAL")) {
       qWarning() << "设置WAL模式失败:" << query.lastError().text();
       return false;
     }
   }
 
   // 其他优化设置
-  query.exec(QString("PRAGMA busy_timeout = %1").arg(m_config.busyTimeout));
-  query.exec("PRAGMA synchronous = NORMAL");
-  query.exec("PRAGMA cache_size = 10000");
-  query.exec("PRAGMA temp_store = MEMORY");
+  pragma("busy_timeout",
+         QString("PRAGMA busy_timeout = %1").arg(m_config.busyTimeout));
+  pragma("synchronous", "PRAGMA synchronous = NORMAL");
+  pragma("cache_size", "PRAGMA cache_size = 10000");
+  pragma("temp_store", "PRAGMA temp_store = MEMORY");
   // 可选：确保触发器不会递归
-  query.exec("PRAGMA recursive_triggers = OFF");
+  pragma("recursive_triggers", "PRAGMA recursive_triggers = OFF");
+
+  // 主连接同样注册原生SQL函数
+  {
+    StartupProfile::Scope phase(&m_startupProfile, "sqlFunctions");
+    QString error;
+    if (!SqlFunctions::apply(m_database, sqlFunctions(), &error)) {
+      qWarning() << error;
+      phase.fail();
+    }
+  }
+
+  // 主连接同样挂接变更捕获钩子
+  StartupProfile::Scope phase(&m_startupProfile, "changeFeed.attach");
+  m_changeFeed->attach(m_database);
 
   return true;
 }
@@ -798,7 +1029,7 @@ bool BaseDatabaseManager::executeInitSql() {
 }
 
 void BaseDatabaseManager::recordQueryStats(bool success, double queryTime) {
-  QMutexLocker locker(&m_statsMutex);
+  ProfiledMutexLocker locker(&m_statsMutex, DB_LOCK_SITE);
 
   m_stats.totalQueries++;
   if (success) {
@@ -840,7 +1071,7 @@ bool BaseDatabaseManager::executeQueryWithStats(const QString& queryStr,
     query.addBindValue(param);
   }
 
-  bool success = query.exec();
+  bool success = SqlExec::run(query);
   double queryTime = timer.elapsed();
 
   recordQueryStats(success, queryTime);
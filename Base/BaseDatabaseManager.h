@@ -13,10 +13,15 @@
 #include <QSqlQuery>
 #include <QThread>
 #include <QTimer>
+#include <functional>
 #include <memory>
 #include <unordered_map>
 
+#include "ChangeFeed.h"
 #include "DatabaseFramework.h"
+#include "SqlFunctions.h"
+#include "SqliteMemory.h"
+#include "StartupProfile.h"
 
 /**
  * @brief 连接池类
@@ -28,13 +33,25 @@ class ConnectionPool {
   DatabaseConfig m_config;                 ///< 数据库配置
   QQueue<QString> m_availableConnections;  ///< 可用连接队列
   QSet<QString> m_usedConnections;         ///< 已使用连接集合
-  mutable QMutex m_mutex;                  ///< 线程安全锁
+  mutable ProfiledMutex m_mutex;           ///< 线程安全锁
   int m_connectionCounter = 0;             ///< 连接计数器
+  quint64 m_exhaustedCount = 0;            ///< 因达到连接上限而获取失败的次数
   QHash<QString, QQueue<QString>> m_availableByThread;  // key: threadId
   QHash<QString, QString> m_connOwner;                  // connName -> threadId
   QHash<QString, QString>
       m_activeTxByThread;  // threadId -> connName  (活动事务绑定)
   QHash<QString, QPointer<QThread>> m_threadRefs;
+  QHash<QString, void*> m_nativeHandles;  // connName -> sqlite3句柄（内存统计）
+  QHash<QString, std::shared_ptr<NativeStatementCache>>
+      m_statementCaches;  // connName -> 原生语句缓存
+  /// 线程事务结束时要执行的动作
+  struct TxHook {
+    std::function<void()> onCommit;    ///< 提交成功后执行
+    std::function<void()> onRollback;  ///< 回滚或提交失败后执行（可为空）
+  };
+  QHash<QString, QVector<TxHook>> m_txHooksByThread;  // threadId -> 待执行动作
+  ChangeFeed* m_changeFeed = nullptr;  ///< 新连接要挂接的变更流（不拥有）
+  QList<SqlFunction> m_sqlFunctions;   ///< 新连接要注册的原生SQL函数
 
   static QString currentTid() {
     return QString::number(reinterpret_cast<qintptr>(QThread::currentThread()));
@@ -42,6 +59,9 @@ class ConnectionPool {
 
   void cleanupFinishedThreads();
 
+  // 关闭并移除一条已配置的连接（调用方持有 m_mutex）
+  void removeConnectionUnsafe(const QString& name);
+
   int totalConnectionsUnsafe() const {
     int n = m_usedConnections.size();
     for (const auto& q : m_availableByThread) n += q.size();
@@ -87,6 +107,62 @@ class ConnectionPool {
    */
   int usedCount() const;
 
+  /**
+   * @brief 获取连接池耗尽次数
+   * @return 因连接总数达到上限而获取失败的累计次数
+   */
+  quint64 exhaustedCount() const {
+    ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
+    return m_exhaustedCount;
+  }
+
+  /**
+   * @brief 设置变更流，此后新建的连接都装上变更捕获钩子
+   * @param feed 变更流（不拥有，须比连接池活得久）
+   */
+  void setChangeFeed(ChangeFeed* feed) {
+    ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
+    m_changeFeed = feed;
+  }
+
+  /**
+   * @brief 设置原生SQL函数，此后新建的连接都注册这些函数
+   * @param functions 函数列表
+   */
+  void setSqlFunctions(const QList<SqlFunction>& functions) {
+    ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
+    m_sqlFunctions = functions;
+  }
+
+  /**
+   * @brief 获取变更流
+   * @return 变更流指针（未设置时为nullptr）
+   */
+  ChangeFeed* changeFeed() const {
+    ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
+    return m_changeFeed;
+  }
+
+  /**
+   * @brief 采集池内每条打开连接的内存与页缓存统计
+   * @return 连接名 -> 统计（非 sqlite_native 构建时为空）
+   */
+  QHash<QString, SqliteMemoryStats> connectionMemoryStats() const;
+
+  /**
+   * @brief 池内全部打开连接的内存与页缓存合计
+   * @return 合计统计（connections 为参与统计的连接数）
+   */
+  SqliteMemoryStats memoryStats() const;
+
+  /**
+   * @brief 获取连接的原生语句缓存
+   * 只应由当前持有该连接的线程使用；连接移出连接池前缓存被清空。
+   * @param connectionName 连接名称
+   * @return 语句缓存（非 sqlite_native 构建或连接不存在时为nullptr）
+   */
+  NativeStatementCache* statementCache(const QString& connectionName) const;
+
  private:
   /**
    * @brief 创建新连接
@@ -102,11 +178,31 @@ class ConnectionPool {
    */
   void configureDatabase(QSqlDatabase& db);
 
+  /**
+   * @brief 执行事务结束动作（调用方不持有 m_mutex）
+   * @param hooks 登记的动作
+   * @param committed 事务是否已提交
+   */
+  static void runTxHooks(const QVector<TxHook>& hooks, bool committed);
+
  public:
   // 线程级事务：开始/提交/回滚（绑定当前线程的一条连接）
   QString beginThreadTransaction();  // 返回绑定的连接名（失败则为空）
   bool commitThreadTransaction();    // 提交并释放绑定
   bool rollbackThreadTransaction();  // 回滚并释放绑定
+  bool hasThreadTransaction() const;  // 当前线程是否已有活动事务
+
+  /**
+   * @brief 登记当前线程事务结束时的动作
+   * 当前线程有活动事务时暂存：提交成功后按登记顺序执行 onCommit，回滚或
+   * 提交失败后逆序执行 onRollback；没有活动事务时立即执行 onCommit。
+   * 动作在释放连接池锁之后执行，可以再访问连接池。
+   * @param onCommit 提交后的动作
+   * @param onRollback 回滚后的动作（可为空）
+   * @return 是否已暂存（false 表示 onCommit 已立即执行）
+   */
+  bool afterThreadTransaction(std::function<void()> onCommit,
+                              std::function<void()> onRollback = {});
 };
 
 /**
@@ -121,19 +217,22 @@ class BaseDatabaseManager : public QObject {
    * @brief 数据库统计信息结构体
    */
   struct DatabaseStats {
-    qint64 totalQueries = 0;       ///< 总查询次数
-    qint64 successfulQueries = 0;  ///< 成功查询次数
-    qint64 failedQueries = 0;      ///< 失败查询次数
-    QDateTime lastQueryTime;       ///< 最后查询时间
-    double avgQueryTime = 0.0;     ///< 平均查询时间(毫秒)
+    qint64 totalQueries = 0;           ///< 总查询次数
+    qint64 successfulQueries = 0;      ///< 成功查询次数
+    qint64 failedQueries = 0;          ///< 失败查询次数
+    QDateTime lastQueryTime;           ///< 最后查询时间
+    double avgQueryTime = 0.0;         ///< 平均查询时间(毫秒)
+    SqliteMemoryStats sqlite;          ///< 主连接与池内连接的内存、页缓存合计
+    SqliteProcessStats sqliteProcess;  ///< 进程级SQLite内存（各库相同）
   };
 
  protected:
   DatabaseType m_databaseType;                       ///< 数据库类型
   DatabaseConfig m_config;                           ///< 数据库配置
+  std::unique_ptr<ChangeFeed> m_changeFeed;          ///< 变更流
   std::unique_ptr<ConnectionPool> m_connectionPool;  ///< 连接池
   QSqlDatabase m_database;                           ///< 主数据库连接
-  mutable QMutex m_dbMutex;  ///< 数据库操作互斥锁
+  mutable ProfiledMutex m_dbMutex;                   ///< 数据库操作互斥锁
 
   // 表管理
   std::unordered_map<TableType, std::unique_ptr<ITableOperations>>
@@ -141,8 +240,10 @@ class BaseDatabaseManager : public QObject {
   QTimer* m_healthCheckTimer;  ///< 健康检查定时器
 
   // 统计信息
-  mutable QMutex m_statsMutex;  ///< 统计信息互斥锁
-  DatabaseStats m_stats;        ///< 统计信息
+  mutable ProfiledMutex m_statsMutex;  ///< 统计信息互斥锁
+  DatabaseStats m_stats;               ///< 统计信息
+
+  StartupProfile m_startupProfile;  ///< 最近一次 initialize() 的阶段耗时
 
  public:
   /**
@@ -194,6 +295,19 @@ class BaseDatabaseManager : public QObject {
    */
   const DatabaseConfig& config() const { return m_config; }
 
+  /**
+   * @brief 获取本数据库的变更流
+   * 以 sqlite_native 构建时覆盖全部连接上的提交（含原始SQL与触发器）
+   * @return 变更流指针
+   */
+  ChangeFeed* changeFeed() const { return m_changeFeed.get(); }
+
+  /**
+   * @brief 获取连接池
+   * @return 连接池指针（未初始化时为nullptr）
+   */
+  ConnectionPool* connectionPool() const { return m_connectionPool.get(); }
+
   // ========================================================================
   // 事务管理
   // ========================================================================
@@ -342,6 +456,15 @@ class BaseDatabaseManager : public QObject {
    */
   qint64 getDatabaseSize() const;
 
+  /**
+   * @brief 获取最近一次 initialize() 的阶段耗时
+   * 阶段依次为 pool（仅 close() 后重新初始化时）、directory、open、
+   * configure（其下每个 PRAGMA 一项）、initSql、registerTables、
+   * createTables（其下每张表一项）、healthTimer
+   * @return 启动阶段计时（未初始化过时为空）
+   */
+  StartupProfile startupProfile() const;
+
  signals:
   /**
    * @brief 数据库初始化完成信号
@@ -383,6 +506,13 @@ class BaseDatabaseManager : public QObject {
    */
   virtual void registerTables() = 0;
 
+  /**
+   * @brief 子类可重写：本库连接上注册的原生SQL函数
+   * 主连接与连接池的每条连接在配置时注册（仅 sqlite_native 构建）
+   * @return 函数列表（默认为空）
+   */
+  virtual QList<SqlFunction> sqlFunctions() const { return {}; }
+
   /**
    * @brief 创建数据库目录
    * @return 是否成功
@@ -425,6 +555,12 @@ class BaseDatabaseManager : public QObject {
   void performHealthCheck();
 
  private:
+  /**
+   * @brief 按阶段执行初始化（调用方持有 m_dbMutex 并已开始计时）
+   * @return 是否成功
+   */
+  bool initializePhases();
+
   /**
    * @brief 初始化健康检查定时器
    */
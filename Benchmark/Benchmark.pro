@@ -0,0 +1,33 @@
+# Benchmark.pro - 相机信息基准测试与压测程序（与主程序共用框架源文件）
+include($$PWD/../DataBase.pri)
+
+# 输出目录配置（与主程序分开，避免目标文件互相覆盖）
+DESTDIR = $$PWD/../bin
+OBJECTS_DIR = $$PWD/../build/bench/obj
+MOC_DIR = $$PWD/../build/bench/moc
+RCC_DIR = $$PWD/../build/bench/rcc
+
+INCLUDEPATH += $$PWD
+
+CONFIG(debug, debug|release) {
+    DEFINES += DEBUG_MODE
+    TARGET = DataBaseBench_d
+} else {
+    TARGET = DataBaseBench
+}
+
+HEADERS += \
+    BenchmarkRunner.h \
+    CameraFleetGenerator.h \
+    LatencyHistogram.h \
+    PoolBenchmarks.h \
+    StartupBenchmark.h \
+    StressHarness.h
+
+SOURCES += \
+    BenchmarkRunner.cpp \
+    CameraFleetGenerator.cpp \
+    PoolBenchmarks.cpp \
+    StartupBenchmark.cpp \
+    StressHarness.cpp \
+    main.cpp
@@ -0,0 +1,160 @@
+﻿// BenchmarkRunner.cpp - 基准测试的计时、统计与JSON输出实现
+#include "BenchmarkRunner.h"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QSysInfo>
+#include <QTextStream>
+#include <QVector>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 最近秩法分位数（sorted 已升序且非空）
+double percentile(const QVector<double>& sorted, double p) {
+  const int rank = static_cast<int>(std::ceil(p * sorted.size()));
+  return sorted.at(qBound(0, rank - 1, sorted.size() - 1));
+}
+
+}  // namespace
+
+QJsonObject BenchmarkResult::toJson() const {
+  QJsonObject o;
+  o["name"] = name;
+  o["datasetRows"] = datasetRows;
+  o["samples"] = samples;
+  o["opsPerSample"] = opsPerSample;
+  o["totalMs"] = totalMs;
+  o["opsPerSec"] = opsPerSec;
+  QJsonObject latency;
+  latency["min"] = minUs;
+  latency["mean"] = meanUs;
+  latency["p50"] = p50Us;
+  latency["p90"] = p90Us;
+  latency["p99"] = p99Us;
+  latency["max"] = maxUs;
+  o["latencyUs"] = latency;
+  o["ok"] = ok;
+  if (!ok) o["error"] = error;
+  return o;
+}
+
+BenchmarkRunner::BenchmarkRunner(const BenchmarkOptions& options,
+                                 qint64 datasetRows)
+    : m_options(options), m_datasetRows(datasetRows) {}
+
+bool BenchmarkRunner::selected(const QString& name) const {
+  if (m_options.filters.isEmpty()) return true;
+  for (const QString& f : m_options.filters) {
+    if (name.contains(f, Qt::CaseInsensitive)) return true;
+  }
+  return false;
+}
+
+bool BenchmarkRunner::run(const QString& name, Scale scale,
+                          qint64 opsPerSample, const Body& body) {
+  if (!selected(name)) return false;
+
+  BenchmarkResult r;
+  r.name = name;
+  r.datasetRows = m_datasetRows;
+  r.opsPerSample = qMax<qint64>(1, opsPerSample);
+
+  QString error;
+  for (int i = 0; i < m_options.warmup; ++i) {
+    if (!body(-1 - i, &error) && r.ok) {
+      r.ok = false;
+      r.error = error;
+    }
+  }
+
+  const int samples = qMax(
+      1, scale == Scale::SINGLE ? m_options.samples : m_options.repetitions);
+  QVector<double> latencies;
+  latencies.reserve(samples);
+  qint64 totalNs = 0;
+
+  QElapsedTimer timer;
+  for (int i = 0; i < samples; ++i) {
+    timer.start();
+    const bool ok = body(i, &error);
+    const qint64 ns = timer.nsecsElapsed();
+    totalNs += ns;
+    latencies.append(static_cast<double>(ns) / 1000.0 / r.opsPerSample);
+    if (!ok && r.ok) {
+      r.ok = false;
+      r.error = error;
+    }
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  double sum = 0.0;
+  for (double l : latencies) sum += l;
+
+  r.samples = samples;
+  r.totalMs = static_cast<double>(totalNs) / 1e6;
+  r.opsPerSec = totalNs > 0 ? static_cast<double>(samples) * r.opsPerSample *
+                                  1e9 / static_cast<double>(totalNs)
+                            : 0.0;
+  r.minUs = latencies.first();
+  r.meanUs = sum / latencies.size();
+  r.p50Us = percentile(latencies, 0.50);
+  r.p90Us = percentile(latencies, 0.90);
+  r.p99Us = percentile(latencies, 0.99);
+  r.maxUs = latencies.last();
+  m_results.append(r);
+  return true;
+}
+
+QJsonObject BenchmarkRunner::environment() {
+  QJsonObject m;
+  m["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+  m["qtVersion"] = QString(qVersion());
+  m["host"] = QSysInfo::machineHostName();
+  m["os"] = QSysInfo::prettyProductName();
+  m["cpuArchitecture"] = QSysInfo::currentCpuArchitecture();
+  return m;
+}
+
+QJsonObject BenchmarkRunner::report(const QJsonObject& meta) const {
+  QJsonObject m = environment();
+  for (auto it = meta.constBegin(); it != meta.constEnd(); ++it) {
+    m[it.key()] = it.value();
+  }
+  m["datasetRows"] = m_datasetRows;
+  m["warmup"] = m_options.warmup;
+  m["repetitions"] = m_options.repetitions;
+  m["samples"] = m_options.samples;
+
+  QJsonArray results;
+  for (const BenchmarkResult& r : m_results) results.append(r.toJson());
+
+  QJsonObject root;
+  root["schema"] = 1;
+  root["meta"] = m;
+  root["results"] = results;
+  return root;
+}
+
+void BenchmarkRunner::printSummary() const {
+  QTextStream out(stderr);
+  out << QString("%1 %2 %3 %4 %5 %6\n")
+             .arg("benchmark", -24)
+             .arg("ops/s", 14)
+             .arg("p50(us)", 12)
+             .arg("p90(us)", 12)
+             .arg("p99(us)", 12)
+             .arg("status", 8);
+  for (const BenchmarkResult& r : m_results) {
+    out << QString("%1 %2 %3 %4 %5 %6\n")
+               .arg(r.name, -24)
+               .arg(r.opsPerSec, 14, 'f', 1)
+               .arg(r.p50Us, 12, 'f', 1)
+               .arg(r.p90Us, 12, 'f', 1)
+               .arg(r.p99Us, 12, 'f', 1)
+               .arg(r.ok ? "ok" : "FAILED", 8);
+  }
+  out.flush();
+}
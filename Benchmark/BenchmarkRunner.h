@@ -0,0 +1,117 @@
+﻿// BenchmarkRunner.h - 基准测试的计时、统计与JSON输出
+#ifndef BENCHMARK_RUNNER_H
+#define BENCHMARK_RUNNER_H
+
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <functional>
+
+/**
+ * @brief 基准运行参数
+ */
+struct BenchmarkOptions {
+  int warmup = 3;        ///< 预热次数（不计入统计）
+  int repetitions = 20;  ///< 重量级操作（批量、备份等）的采样次数
+  int samples = 1000;    ///< 单次操作（点查等）的采样次数
+  QStringList filters;   ///< 只运行名称包含其一的基准（为空全部运行）
+};
+
+/**
+ * @brief 单个基准的结果
+ * 每次采样计时一次调用；调用内完成 opsPerSample 次操作，
+ * 延迟按单次操作折算（微秒），吞吐按全部采样合计计算
+ */
+struct BenchmarkResult {
+  QString name;             ///< 基准名称
+  qint64 datasetRows = 0;   ///< 数据集行数
+  int samples = 0;          ///< 采样次数
+  qint64 opsPerSample = 1;  ///< 每次采样完成的操作数
+  double totalMs = 0.0;     ///< 采样总耗时（毫秒）
+  double opsPerSec = 0.0;   ///< 吞吐（操作/秒）
+  double minUs = 0.0;       ///< 最小延迟
+  double meanUs = 0.0;      ///< 平均延迟
+  double p50Us = 0.0;       ///< 中位延迟
+  double p90Us = 0.0;       ///< 90分位延迟
+  double p99Us = 0.0;       ///< 99分位延迟
+  double maxUs = 0.0;       ///< 最大延迟
+  bool ok = true;           ///< 是否全部采样成功
+  QString error;            ///< 首个失败原因
+
+  /**
+   * @brief 转为JSON对象
+   * @return JSON对象
+   */
+  QJsonObject toJson() const;
+};
+
+/**
+ * @brief 基准运行器
+ * 依次执行各基准的预热与采样，收集延迟分布，最后输出机器可读的JSON，
+ * 便于不同版本、不同机器之间比较。
+ */
+class BenchmarkRunner {
+ public:
+  /// 一次采样：index 为采样序号（预热为负），返回是否成功，失败时写 error
+  using Body = std::function<bool(int index, QString* error)>;
+
+  /**
+   * @brief 采样规模
+   */
+  enum class Scale {
+    SINGLE = 0,  ///< 单次操作，按 samples 采样
+    HEAVY = 1    ///< 重量级操作，按 repetitions 采样
+  };
+
+  /**
+   * @brief 构造函数
+   * @param options 运行参数
+   * @param datasetRows 数据集行数（写入结果与元数据）
+   */
+  BenchmarkRunner(const BenchmarkOptions& options, qint64 datasetRows);
+
+  /**
+   * @brief 运行一个基准（被过滤掉时直接返回false）
+   * @param name 基准名称
+   * @param scale 采样规模
+   * @param opsPerSample 每次采样完成的操作数
+   * @param body 采样函数
+   * @return 是否运行
+   */
+  bool run(const QString& name, Scale scale, qint64 opsPerSample,
+           const Body& body);
+
+  /**
+   * @brief 已完成的结果
+   * @return 结果列表（按运行顺序）
+   */
+  const QList<BenchmarkResult>& results() const { return m_results; }
+
+  /**
+   * @brief 生成完整报告
+   * @param meta 附加元数据（合并进 meta 字段）
+   * @return 报告JSON（schema、meta、results）
+   */
+  QJsonObject report(const QJsonObject& meta = QJsonObject()) const;
+
+  /**
+   * @brief 运行环境元数据（时间、Qt版本、主机、系统、CPU架构）
+   * @return JSON对象
+   */
+  static QJsonObject environment();
+
+  /**
+   * @brief 以表格形式把结果摘要打印到标准错误
+   */
+  void printSummary() const;
+
+ private:
+  bool selected(const QString& name) const;
+
+  BenchmarkOptions m_options;
+  qint64 m_datasetRows;
+  QList<BenchmarkResult> m_results;
+};
+
+#endif  // BENCHMARK_RUNNER_H
@@ -0,0 +1,95 @@
+﻿// CameraFleetGenerator.cpp - 基准测试用的合成相机数据集实现
+#include "CameraFleetGenerator.h"
+
+#include <QVector>
+
+namespace {
+
+// splitmix64 终结函数：把相邻输入打散为无关输出
+quint64 mix(quint64 x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+// 按累计权重取值，前几项占大头
+int pickSkewed(quint64 h, const QVector<int>& cumulative) {
+  const int r = static_cast<int>(h % static_cast<quint64>(cumulative.last()));
+  for (int i = 0; i < cumulative.size(); ++i) {
+    if (r < cumulative[i]) return i;
+  }
+  return cumulative.size() - 1;
+}
+
+const QStringList& connectionTypes() {
+  static const QStringList k = {"GigE", "USB3", "10GigE", "CoaXPress",
+                                "CameraLink"};
+  return k;
+}
+
+const QVector<int>& manufacturerWeights() {
+  static const QVector<int> k = {30, 50, 64, 74, 81, 86, 90, 93, 95, 97, 99,
+                                 100};
+  return k;
+}
+
+const QVector<int>& connectionWeights() {
+  static const QVector<int> k = {45, 75, 87, 95, 100};
+  return k;
+}
+
+}  // namespace
+
+CameraFleetGenerator::CameraFleetGenerator(quint64 seed) : m_seed(seed) {}
+
+const QStringList& CameraFleetGenerator::manufacturers() {
+  static const QStringList k = {
+      "Basler",   "Hikrobot", "FLIR",  "Allied Vision", "Daheng", "IDS",
+      "JAI",      "Teledyne", "Sony",  "Baumer",        "Omron",  "Mikrotron"};
+  return k;
+}
+
+quint64 CameraFleetGenerator::hash(qint64 index, quint64 salt) const {
+  return mix(static_cast<quint64>(index) ^ mix(m_seed + salt));
+}
+
+QString CameraFleetGenerator::serialFor(qint64 index) const {
+  // 乘奇数在模 2^48 下可逆，行号互异则序列号互异
+  const quint64 scrambled =
+      (static_cast<quint64>(index) * 0x9e3779b97f4bULL + m_seed) &
+      0xffffffffffffULL;
+  return QString("SN%1").arg(scrambled, 12, 16, QLatin1Char('0')).toUpper();
+}
+
+CameraInfo CameraFleetGenerator::make(qint64 index) const {
+  static const qint64 kBaseSecs =
+      QDateTime(QDate(2020, 1, 1), QTime(0, 0)).toSecsSinceEpoch();
+  static const qint64 kSpanSecs = 3LL * 365 * 24 * 3600;
+
+  CameraInfo camera;
+  const int maker = pickSkewed(hash(index, 1), manufacturerWeights());
+  camera.manufacturer = manufacturers().at(maker);
+  camera.connectionType =
+      connectionTypes().at(pickSkewed(hash(index, 2), connectionWeights()));
+  const quint64 v = hash(index, 3);
+  camera.version = QString("v%1.%2").arg(1 + v % 4).arg((v >> 8) % 10);
+  camera.name = QString("%1-CAM-%2")
+                    .arg(camera.manufacturer.left(3).toUpper())
+                    .arg(index, 8, 10, QLatin1Char('0'));
+  camera.serialNumber = serialFor(index);
+
+  const qint64 created =
+      kBaseSecs + static_cast<qint64>(hash(index, 4) % kSpanSecs);
+  camera.createdAt = QDateTime::fromSecsSinceEpoch(created);
+  camera.updatedAt = camera.createdAt.addSecs(
+      static_cast<qint64>(hash(index, 5) % (30 * 24 * 3600)));
+  return camera;
+}
+
+QList<CameraInfo> CameraFleetGenerator::batch(qint64 first, int count) const {
+  QList<CameraInfo> cameras;
+  cameras.reserve(count);
+  for (int i = 0; i < count; ++i) cameras.append(make(first + i));
+  return cameras;
+}
@@ -0,0 +1,62 @@
+﻿// CameraFleetGenerator.h - 基准测试用的合成相机数据集
+#ifndef CAMERA_FLEET_GENERATOR_H
+#define CAMERA_FLEET_GENERATOR_H
+
+#include <QDateTime>
+#include <QList>
+#include <QString>
+
+#include "DeviceDatabaseManager/DeviceDataBaseStruct.h"
+
+/**
+ * @brief 合成相机机群生成器
+ * 每个字段都由行号与种子经哈希直接算出，不依赖随机数状态：任意行可
+ * 单独重建，查找类基准按行号即可得到对应的序列号而无需保存数据集。
+ * 序列号由行号经可逆变换得到，互不重复且插入顺序与索引顺序无关；
+ * 制造商、连接方式按偏斜分布取值，接近真实机群的低基数列。
+ */
+class CameraFleetGenerator {
+ public:
+  static constexpr quint64 kDefaultSeed = 0x5eed2024;  ///< 默认种子
+
+  /**
+   * @brief 构造函数
+   * @param seed 种子（相同种子生成相同数据集）
+   */
+  explicit CameraFleetGenerator(quint64 seed = kDefaultSeed);
+
+  /**
+   * @brief 生成第 index 行
+   * @param index 行号（从0开始）
+   * @return 相机信息（id未设置）
+   */
+  CameraInfo make(qint64 index) const;
+
+  /**
+   * @brief 生成连续的一批行
+   * @param first 起始行号
+   * @param count 行数
+   * @return 相机信息列表
+   */
+  QList<CameraInfo> batch(qint64 first, int count) const;
+
+  /**
+   * @brief 第 index 行的序列号
+   * @param index 行号
+   * @return 序列号
+   */
+  QString serialFor(qint64 index) const;
+
+  /**
+   * @brief 制造商取值表（搜索类基准的关键字来源）
+   * @return 制造商列表
+   */
+  static const QStringList& manufacturers();
+
+ private:
+  quint64 hash(qint64 index, quint64 salt) const;
+
+  quint64 m_seed;
+};
+
+#endif  // CAMERA_FLEET_GENERATOR_H
@@ -0,0 +1,112 @@
+﻿// LatencyHistogram.h - 定长对数分桶的延迟直方图
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <QJsonObject>
+#include <QVector>
+#include <QtAlgorithms>
+#include <limits>
+
+/**
+ * @brief 延迟直方图
+ * 以纳秒记录，每个2的幂区间再均分为8个子桶（相对误差约6%），
+ * 桶数固定，长时间压测也不随采样数增长；各线程各持一份，结束后合并。
+ */
+class LatencyHistogram {
+ public:
+  LatencyHistogram() : m_buckets(kBucketCount, 0) {}
+
+  /**
+   * @brief 记录一次延迟
+   * @param ns 延迟（纳秒）
+   */
+  void record(qint64 ns) {
+    const quint64 v = ns > 0 ? static_cast<quint64>(ns) : 0;
+    ++m_buckets[bucketOf(v)];
+    ++m_count;
+    m_sumNs += static_cast<double>(v);
+    m_minNs = qMin(m_minNs, v);
+    m_maxNs = qMax(m_maxNs, v);
+  }
+
+  /**
+   * @brief 合并另一个直方图
+   * @param other 另一个直方图
+   */
+  void merge(const LatencyHistogram& other) {
+    for (int i = 0; i < kBucketCount; ++i) m_buckets[i] += other.m_buckets[i];
+    m_count += other.m_count;
+    m_sumNs += other.m_sumNs;
+    m_minNs = qMin(m_minNs, other.m_minNs);
+    m_maxNs = qMax(m_maxNs, other.m_maxNs);
+  }
+
+  quint64 count() const { return m_count; }
+
+  /**
+   * @brief 分位数
+   * @param p 分位（0~1）
+   * @return 延迟（微秒，取所在桶的中点并限制在实测最值之间）
+   */
+  double percentileUs(double p) const {
+    if (m_count == 0) return 0.0;
+    const quint64 rank =
+        qMax<quint64>(1, static_cast<quint64>(p * m_count + 0.5));
+    quint64 seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+      seen += m_buckets[i];
+      if (seen >= rank) {
+        const double mid = (lowerBound(i) + lowerBound(i + 1)) / 2.0;
+        return qBound(static_cast<double>(m_minNs), mid,
+                      static_cast<double>(m_maxNs)) /
+               1000.0;
+      }
+    }
+    return m_maxNs / 1000.0;
+  }
+
+  /**
+   * @brief 转为JSON对象（延迟单位为微秒）
+   * @return JSON对象
+   */
+  QJsonObject toJson() const {
+    QJsonObject o;
+    o["count"] = static_cast<qint64>(m_count);
+    o["min"] = m_count ? m_minNs / 1000.0 : 0.0;
+    o["mean"] = m_count ? m_sumNs / m_count / 1000.0 : 0.0;
+    o["p50"] = percentileUs(0.50);
+    o["p90"] = percentileUs(0.90);
+    o["p99"] = percentileUs(0.99);
+    o["p999"] = percentileUs(0.999);
+    o["max"] = m_maxNs / 1000.0;
+    return o;
+  }
+
+ private:
+  static constexpr int kSubBits = 3;              ///< 每个2的幂区间的子桶位数
+  static constexpr int kSub = 1 << kSubBits;      ///< 子桶数
+  static constexpr int kBucketCount = kSub * 62;  ///< 覆盖全部 quint64
+
+  static int bucketOf(quint64 v) {
+    if (v < kSub) return static_cast<int>(v);
+    const int e = 63 - static_cast<int>(qCountLeadingZeroBits(v));
+    const int sub = static_cast<int>(v >> (e - kSubBits)) - kSub;
+    return kSub + (e - kSubBits) * kSub + sub;
+  }
+
+  static double lowerBound(int bucket) {
+    if (bucket < kSub) return bucket;
+    const int e = (bucket - kSub) / kSub + kSubBits;
+    const int sub = (bucket - kSub) % kSub;
+    return static_cast<double>(kSub + sub) *
+           static_cast<double>(1ULL << (e - kSubBits));
+  }
+
+  QVector<quint64> m_buckets;
+  quint64 m_count = 0;
+  double m_sumNs = 0.0;
+  quint64 m_minNs = std::numeric_limits<quint64>::max();
+  quint64 m_maxNs = 0;
+};
+
+#endif  // LATENCY_HISTOGRAM_H
@@ -0,0 +1,249 @@
+﻿// PoolBenchmarks.cpp - 连接池争用微基准实现
+#include "PoolBenchmarks.h"
+
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QThread>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "BaseDatabaseManager.h"
+#include "LatencyHistogram.h"
+#include "LockFreeRingBuffer.h"
+
+namespace {
+
+constexpr int kHandoffDepth = 8;  // handoff 每对线程之间的交接队列深度
+
+}  // namespace
+
+/**
+ * @brief 单个线程的计数（线程内独占，结束后汇总）
+ */
+struct PoolBenchmarks::Worker {
+  LatencyHistogram latency;
+  quint64 ops = 0;
+  quint64 failures = 0;
+};
+
+PoolBenchmarks::PoolBenchmarks(const PoolBenchOptions& options)
+    : m_options(options) {}
+
+QStringList PoolBenchmarks::scenarios() {
+  return {"acquire_release", "handoff", "thread_tx", "max_connections",
+          "thread_churn"};
+}
+
+bool PoolBenchmarks::selected(const QString& name) const {
+  if (m_options.filters.isEmpty()) return true;
+  for (const QString& f : m_options.filters) {
+    if (name.contains(f)) return true;
+  }
+  return false;
+}
+
+QJsonArray PoolBenchmarks::run() {
+  using Scenario = QJsonObject (PoolBenchmarks::*)(int);
+  const Scenario table[] = {
+      &PoolBenchmarks::acquireRelease, &PoolBenchmarks::handoff,
+      &PoolBenchmarks::threadTransaction, &PoolBenchmarks::maxConnections,
+      &PoolBenchmarks::threadChurn};
+  const QStringList names = scenarios();
+
+  QJsonArray results;
+  for (int s = 0; s < names.size(); ++s) {
+    if (!selected(names.at(s))) continue;
+    for (int threads : m_options.threadCounts) {
+      if (threads <= 0) continue;
+      const QJsonObject point = (this->*table[s])(threads);
+      if (!point.isEmpty()) results.append(point);
+    }
+  }
+  return results;
+}
+
+QJsonObject PoolBenchmarks::measure(
+    const QString& name, int threads, int maxConnections,
+    const Op& op) {
+  DatabaseConfig config("POOL_BENCH", ":memory:");
+  config.maxConnections = maxConnections;
+  config.enableWAL = false;
+  config.enableForeignKeys = false;
+  ConnectionPool pool(config);
+
+  QVector<Worker> workers(threads);
+  Worker* slots = workers.data();
+  std::atomic<int> ready{0};
+  std::atomic<bool> go{false};
+  m_stop.store(false);
+
+  std::vector<std::thread> runners;
+  runners.reserve(threads);
+  for (int i = 0; i < threads; ++i) {
+    runners.emplace_back([this, &op, &pool, &ready, &go, slots, i]() {
+      Worker& w = slots[i];
+      ready.fetch_add(1);
+      while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+
+      QElapsedTimer timer;
+      while (!m_stop.load(std::memory_order_relaxed)) {
+        timer.start();
+        const Outcome outcome = op(&pool, i);
+        if (outcome == Outcome::OK) {
+          w.latency.record(timer.nsecsElapsed());
+          ++w.ops;
+        } else if (outcome == Outcome::FAILED) {
+          ++w.failures;
+        }
+      }
+    });
+  }
+
+  // 所有线程就绪后同时起跑，避免先启动的线程独占前段时间
+  while (ready.load() < threads) std::this_thread::yield();
+  QElapsedTimer clock;
+  clock.start();
+  go.store(true, std::memory_order_release);
+  QThread::msleep(static_cast<unsigned long>(m_options.durationMs));
+  m_stop.store(true);
+  for (auto& t : runners) t.join();
+  const qint64 elapsedNs = clock.nsecsElapsed();
+
+  LatencyHistogram latency;
+  quint64 ops = 0;
+  quint64 failures = 0;
+  quint64 minOps = std::numeric_limits<quint64>::max();
+  quint64 maxOps = 0;
+  int starved = 0;
+  double sumSquares = 0.0;
+  for (const Worker& w : workers) {
+    latency.merge(w.latency);
+    ops += w.ops;
+    failures += w.failures;
+    minOps = qMin(minOps, w.ops);
+    maxOps = qMax(maxOps, w.ops);
+    if (w.ops == 0) ++starved;
+    sumSquares += static_cast<double>(w.ops) * w.ops;
+  }
+
+  // Jain 公平性指数：(Σx)² / (n·Σx²)，各线程完成数相同时为1，
+  // 只有一个线程有进展时为 1/n
+  QJsonObject fairness;
+  fairness["jain"] =
+      sumSquares > 0 ? static_cast<double>(ops) * ops / (threads * sumSquares)
+                     : 0.0;
+  fairness["minOps"] = static_cast<qint64>(minOps);
+  fairness["maxOps"] = static_cast<qint64>(maxOps);
+  fairness["starvedThreads"] = starved;
+
+  const double nsPerOp =
+      ops > 0 ? static_cast<double>(elapsedNs) * threads / ops : 0.0;
+  QJsonObject point;
+  point["name"] = name;
+  point["threads"] = threads;
+  point["maxConnections"] = maxConnections;
+  point["durationMs"] = elapsedNs / 1e6;
+  point["ops"] = static_cast<qint64>(ops);
+  point["failures"] = static_cast<qint64>(failures);
+  point["nsPerOp"] = nsPerOp;
+  point["opsPerSec"] = elapsedNs > 0 ? ops * 1e9 / elapsedNs : 0.0;
+  point["latencyUs"] = latency.toJson();
+  point["fairness"] = fairness;
+  point["poolExhausted"] = static_cast<qint64>(pool.exhaustedCount());
+
+  QTextStream(stderr) << QString("%1 %2 线程: %3 ns/op，Jain %4，"
+                                 "失败 %5，饥饿线程 %6\n")
+                             .arg(name, -16)
+                             .arg(threads, 3)
+                             .arg(nsPerOp, 10, 'f', 1)
+                             .arg(fairness["jain"].toDouble(), 0, 'f', 3)
+                             .arg(failures)
+                             .arg(starved);
+  return point;
+}
+
+PoolBenchmarks::Outcome PoolBenchmarks::acquireAndRelease(ConnectionPool* pool,
+                                                           int) {
+  const QString name = pool->acquireConnection();
+  if (name.isEmpty()) return Outcome::FAILED;
+  pool->releaseConnection(name);
+  return Outcome::OK;
+}
+
+QJsonObject PoolBenchmarks::acquireRelease(int threads) {
+  // 上限留足余量：每个线程只会用到自己的一条连接
+  return measure("acquire_release", threads, threads * 2, acquireAndRelease);
+}
+
+QJsonObject PoolBenchmarks::handoff(int threads) {
+  // 偶数号线程获取并交给下一个线程归还，线程数需成对
+  const int pairs = threads / 2;
+  if (pairs == 0) return QJsonObject();
+
+  using Queue = LockFreeRingBuffer<QString>;
+  std::vector<std::unique_ptr<Queue>> queues;
+  for (int i = 0; i < pairs; ++i) {
+    queues.push_back(std::make_unique<Queue>(kHandoffDepth));
+  }
+
+  // 每个获取线程最多同时持有队列深度加一条连接
+  return measure(
+      "handoff", pairs * 2, pairs * (kHandoffDepth + 2),
+      [this, &queues](ConnectionPool* pool, int index) {
+        Queue& queue = *queues[index / 2];
+        if (index % 2 == 0) {
+          QString name = pool->acquireConnection();
+          if (name.isEmpty()) return Outcome::FAILED;
+          while (!queue.tryPush(std::move(name))) {
+            if (m_stop.load(std::memory_order_relaxed)) {
+              pool->releaseConnection(name);
+              return Outcome::IDLE;
+            }
+            std::this_thread::yield();
+          }
+          return Outcome::OK;
+        }
+
+        QString name;
+        if (!queue.tryPop(name)) {
+          std::this_thread::yield();
+          return Outcome::IDLE;
+        }
+        // 在非属主线程归还：连接回到属主线程的可用队列
+        pool->releaseConnection(name);
+        return Outcome::OK;
+      });
+}
+
+QJsonObject PoolBenchmarks::threadTransaction(int threads) {
+  return measure("thread_tx", threads, threads * 2,
+                 [](ConnectionPool* pool, int) {
+                   if (pool->beginThreadTransaction().isEmpty()) {
+                     return Outcome::FAILED;
+                   }
+                   return pool->commitThreadTransaction() ? Outcome::OK
+                                                          : Outcome::FAILED;
+                 });
+}
+
+QJsonObject PoolBenchmarks::maxConnections(int threads) {
+  // 连接按线程绑定、不在线程间迁移：先取得连接的线程一直成功，
+  // 其余线程一直失败，公平性指标反映的正是这种饥饿
+  return measure("max_connections", threads, qMax(1, threads / 2),
+                 acquireAndRelease);
+}
+
+QJsonObject PoolBenchmarks::threadChurn(int threads) {
+  // 已退出线程的连接要到下一次获取时才被回收，上限按两倍并发线程留足
+  return measure("thread_churn", threads, threads * 4,
+                 [](ConnectionPool* pool, int) {
+                   bool ok = false;
+                   std::thread shortLived([pool, &ok]() {
+                     ok = acquireAndRelease(pool, 0) == Outcome::OK;
+                   });
+                   shortLived.join();
+                   return ok ? Outcome::OK : Outcome::FAILED;
+                 });
+}
@@ -0,0 +1,90 @@
+﻿// PoolBenchmarks.h - 连接池争用微基准
+#ifndef POOL_BENCHMARKS_H
+#define POOL_BENCHMARKS_H
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+#include <functional>
+
+class ConnectionPool;
+
+/**
+ * @brief 连接池微基准参数
+ */
+struct PoolBenchOptions {
+  int durationMs = 500;                                  ///< 每个测点的时长
+  QVector<int> threadCounts = {1, 2, 4, 8, 16, 32, 64};  ///< 各测点线程数
+  QStringList filters;  ///< 只运行名称包含其一的场景（为空全部）
+};
+
+/**
+ * @brief 连接池争用微基准
+ * 直接针对 ConnectionPool 运行，连接全部打开 ":memory:" 库（每条连接
+ * 各自一个私有内存库），不涉及磁盘与SQLite锁，只测连接池自身的开销：
+ *   acquire_release    每个线程在本线程内反复获取/归还
+ *   handoff            成对线程：一个获取，另一个归还（跨线程归还）
+ *   thread_tx          反复 beginThreadTransaction/commitThreadTransaction
+ *   max_connections    上限为线程数一半时的获取（失败路径与饥饿）
+ *   thread_churn       每次操作启动一个短命线程获取/归还一次后退出，
+ *                      下一次获取触发 cleanupFinishedThreads 回收其连接
+ * 每个场景在各线程数下运行固定时长，报告 ns/op（线程时间/操作数）、
+ * 吞吐、单次延迟分位数，以及各线程完成数的公平性（Jain 指数、最少/最多、
+ * 零完成的饥饿线程数）。
+ */
+class PoolBenchmarks {
+ public:
+  explicit PoolBenchmarks(const PoolBenchOptions& options);
+
+  /**
+   * @brief 运行全部（未被过滤的）场景
+   * @return 各场景、各线程数的测点结果
+   */
+  QJsonArray run();
+
+  /**
+   * @brief 场景名称（按运行顺序）
+   */
+  static QStringList scenarios();
+
+ private:
+  /// 单次操作的结果
+  enum class Outcome {
+    OK = 0,      ///< 完成，计入操作数与延迟
+    FAILED = 1,  ///< 未取得连接等失败
+    IDLE = 2     ///< 无事可做（如交接队列为空），不计入
+  };
+
+  /// 单次操作：index 为线程序号
+  using Op = std::function<Outcome(ConnectionPool* pool, int index)>;
+
+  struct Worker;
+
+  bool selected(const QString& name) const;
+  static Outcome acquireAndRelease(ConnectionPool* pool, int index);
+
+  /**
+   * @brief 以 threads 个线程运行 op 固定时长
+   * @param name 场景名称
+   * @param threads 线程数
+   * @param maxConnections 连接池上限
+   * @param op 单次操作（各线程并发调用）
+   * @return 测点结果
+   */
+  QJsonObject measure(const QString& name, int threads, int maxConnections,
+                      const Op& op);
+
+  QJsonObject acquireRelease(int threads);
+  QJsonObject handoff(int threads);
+  QJsonObject threadTransaction(int threads);
+  QJsonObject maxConnections(int threads);
+  QJsonObject threadChurn(int threads);
+
+  PoolBenchOptions m_options;
+  std::atomic<bool> m_stop{false};
+};
+
+#endif  // POOL_BENCHMARKS_H
@@ -0,0 +1,117 @@
+﻿// StartupBenchmark.cpp - 冷启动与热启动基准实现
+#include "StartupBenchmark.h"
+
+#include <QDir>
+#include <QJsonArray>
+#include <QMap>
+#include <QStringList>
+#include <QTextStream>
+
+#include "DatabaseRegistry.h"
+#include "LatencyHistogram.h"
+
+namespace {
+
+/// 按阶段路径汇总的直方图（保持首次出现的顺序）
+struct PhaseHistograms {
+  QStringList order;
+  QMap<QString, LatencyHistogram> byPath;
+
+  void record(const QString& path, qint64 us) {
+    if (!byPath.contains(path)) order << path;
+    byPath[path].record(us * 1000);
+  }
+};
+
+/**
+ * @brief 把一份阶段列表按嵌套展开为路径（如 DeviceDB/configure/pragma.x）
+ * @param prefix 路径前缀（为空表示顶层）
+ * @param profile StartupProfile::toJson() 的结果
+ * @param out 汇总
+ */
+void collect(const QString& prefix, const QJsonObject& profile,
+             PhaseHistograms* out) {
+  QStringList stack;
+  for (const QJsonValue& v : profile["phases"].toArray()) {
+    const QJsonObject p = v.toObject();
+    const int depth = p["depth"].toInt();
+    while (stack.size() > depth) stack.removeLast();
+    stack << p["name"].toString();
+    const QString path =
+        (prefix.isEmpty() ? QString() : prefix + "/") + stack.join('/');
+    out->record(path, static_cast<qint64>(p["durationUs"].toDouble()));
+  }
+}
+
+}  // namespace
+
+StartupBenchmark::StartupBenchmark(const QString& dirPath, int iterations)
+    : m_dirPath(dirPath), m_iterations(iterations) {}
+
+QJsonObject StartupBenchmark::run() {
+  QJsonObject results;
+  results["cold"] = runMode("cold");
+  results["warm"] = runMode("warm");
+  return results;
+}
+
+QJsonObject StartupBenchmark::runMode(const QString& mode) {
+  const bool cold = mode == "cold";
+  const QString warmDir = QDir(m_dirPath).absoluteFilePath("startup_warm");
+  LatencyHistogram total;
+  PhaseHistograms phases;
+  QJsonObject lastReport;
+  int failures = 0;
+
+  // 热启动先建好库，这次不计入
+  const int first = cold ? 0 : -1;
+  for (int i = first; i < m_iterations; ++i) {
+    const QString dir =
+        cold ? QDir(m_dirPath).absoluteFilePath(
+                   QString("startup_cold_%1").arg(i))
+             : warmDir;
+    if (cold) QDir(dir).removeRecursively();
+
+    DatabaseRegistry* registry = DatabaseRegistry::getInstance();
+    const bool ok = registry->initialize(dir);
+    const QJsonObject report = registry->startupReport();
+    DatabaseRegistry::destroyInstance();
+    if (cold) QDir(dir).removeRecursively();
+    if (i < 0) continue;
+
+    if (!ok) ++failures;
+    total.record(static_cast<qint64>(report["totalUs"].toDouble()) * 1000);
+    collect(QString(), report, &phases);
+    const QJsonObject databases = report["databases"].toObject();
+    for (auto it = databases.begin(); it != databases.end(); ++it) {
+      collect(it.key(), it.value().toObject(), &phases);
+    }
+    lastReport = report;
+  }
+
+  if (!cold) QDir(warmDir).removeRecursively();
+
+  QJsonArray phaseArray;
+  for (const QString& path : phases.order) {
+    QJsonObject o = phases.byPath[path].toJson();
+    o["phase"] = path;
+    phaseArray.append(o);
+  }
+
+  const QJsonObject totalJson = total.toJson();
+  QTextStream(stderr) << QString("%1 启动: p50 %2 ms，p99 %3 ms（%4 次）\n")
+                             .arg(mode)
+                             .arg(totalJson["p50"].toDouble() / 1000.0, 0,
+                                  'f', 2)
+                             .arg(totalJson["p99"].toDouble() / 1000.0, 0,
+                                  'f', 2)
+                             .arg(m_iterations);
+
+  QJsonObject result;
+  result["iterations"] = m_iterations;
+  result["failures"] = failures;
+  result["totalUs"] = totalJson;
+  result["phases"] = phaseArray;
+  result["lastReport"] = lastReport;
+  return result;
+}
@@ -0,0 +1,45 @@
+﻿// StartupBenchmark.h - 冷启动与热启动基准
+#ifndef STARTUP_BENCHMARK_H
+#define STARTUP_BENCHMARK_H
+
+#include <QJsonObject>
+#include <QString>
+
+/**
+ * @brief 启动基准
+ * 反复创建并初始化 DatabaseRegistry（全部业务库），从各次的启动报告中
+ * 汇总总耗时与每个阶段的分位数：
+ *   cold  每次使用新的空目录，包含建库、切换 WAL 与建表建索引
+ *   warm  反复打开同一目录下已建好的库（首次打开不计入）
+ * 进程内无法清空操作系统的页缓存，cold 衡量的是"首次启动"而非
+ * "开机后首次读盘"。
+ */
+class StartupBenchmark {
+ public:
+  /**
+   * @brief 构造函数
+   * @param dirPath 工作目录（各次启动的数据目录建在其下）
+   * @param iterations 每种模式的启动次数
+   */
+  StartupBenchmark(const QString& dirPath, int iterations);
+
+  /**
+   * @brief 运行冷、热两种启动
+   * @return {"cold": {...}, "warm": {...}}，各含 totalUs、按阶段路径的
+   * phases 与最后一次的完整启动报告 lastReport
+   */
+  QJsonObject run();
+
+ private:
+  /**
+   * @brief 运行一种模式
+   * @param mode 模式名（cold/warm）
+   * @return 该模式的汇总
+   */
+  QJsonObject runMode(const QString& mode);
+
+  QString m_dirPath;  ///< 工作目录
+  int m_iterations;   ///< 每种模式的启动次数
+};
+
+#endif  // STARTUP_BENCHMARK_H
@@ -0,0 +1,332 @@
+﻿// StressHarness.cpp - 多线程混合负载压测实现
+#include "StressHarness.h"
+
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QThread>
+#include <random>
+#include <thread>
+
+#include "DeviceDatabaseManager/CameraInfoTable.h"
+#include "DeviceDatabaseManager/DeviceDatabaseManager.h"
+#include "LatencyHistogram.h"
+
+namespace {
+
+constexpr int kOpCount = 6;
+constexpr int kFirstWriteOp = static_cast<int>(StressOp::INSERT);
+
+}  // namespace
+
+/**
+ * @brief 单个线程的计数（线程内独占，结束后汇总）
+ */
+struct StressHarness::Worker {
+  LatencyHistogram latency[kOpCount];
+  quint64 errors[kOpCount] = {};
+  quint64 misses[kOpCount] = {};  ///< 目标行已被删除等，不计为错误
+  quint64 busy = 0;               ///< SQLite 忙（database is locked）
+  quint64 timeouts = 0;           ///< 等满 busy_timeout 后仍失败
+  quint64 poolErrors = 0;         ///< 未取得连接
+  quint64 otherErrors = 0;
+  QString firstError;
+};
+
+StressHarness::StressHarness(DeviceDatabaseManager* db,
+                             const CameraFleetGenerator& gen,
+                             qint64 seededRows, quint64 seed)
+    : m_db(db),
+      m_gen(gen),
+      m_seed(seed),
+      m_walPath(db->config().filePath + "-wal"),
+      m_nextIndex(seededRows),
+      m_maxId(seededRows) {}
+
+QString StressHarness::opName(StressOp op) {
+  switch (op) {
+    case StressOp::READ:
+      return "read";
+    case StressOp::SEARCH:
+      return "search";
+    case StressOp::PAGE:
+      return "page";
+    case StressOp::INSERT:
+      return "insert";
+    case StressOp::UPDATE:
+      return "update";
+    case StressOp::REMOVE:
+      return "remove";
+  }
+  return QString();
+}
+
+bool StressHarness::parseMix(const QString& text, StressOptions* options) {
+  for (const QString& part : text.split(',', QString::SkipEmptyParts)) {
+    const QStringList kv = part.split('=');
+    if (kv.size() != 2) return false;
+    bool ok = false;
+    const int weight = kv[1].trimmed().toInt(&ok);
+    if (!ok || weight < 0) return false;
+
+    int op = -1;
+    for (int i = 0; i < kOpCount; ++i) {
+      if (opName(static_cast<StressOp>(i)) == kv[0].trimmed()) op = i;
+    }
+    if (op < 0) return false;
+    options->weights[op] = weight;
+  }
+  return true;
+}
+
+qint64 StressHarness::walBytes() const {
+  const QFileInfo info(m_walPath);
+  return info.exists() ? info.size() : 0;
+}
+
+void StressHarness::runWorker(Worker* w, bool writer,
+                              const StressOptions& options) {
+  std::mt19937_64 rng(m_seed ^ reinterpret_cast<quintptr>(w));
+  const int first = writer ? kFirstWriteOp : 0;
+  int total = 0;
+  for (int i = first; i < first + 3; ++i) total += options.weights[i];
+  if (total <= 0) return;
+
+  const qint64 timeoutNs =
+      static_cast<qint64>(m_db->config().busyTimeout) * 1000 * 1000;
+  const QStringList& makers = CameraFleetGenerator::manufacturers();
+  auto randomId = [&]() {
+    const qint64 max = qMax<qint64>(1, m_maxId.load());
+    return static_cast<int>(rng() % static_cast<quint64>(max)) + 1;
+  };
+
+  QElapsedTimer timer;
+  while (!m_stop.load(std::memory_order_relaxed)) {
+    int r = static_cast<int>(rng() % static_cast<quint64>(total));
+    int op = first;
+    while (r >= options.weights[op]) r -= options.weights[op++];
+
+    bool ok = true;
+    QString error;
+    DbErrorCode code = DbErrorCode::NONE;
+    timer.start();
+    switch (static_cast<StressOp>(op)) {
+      case StressOp::READ: {
+        auto res = m_db->getCamera(randomId());
+        ok = res.success;
+        error = res.errorMessage;
+        code = res.errorCode;
+        break;
+      }
+      case StressOp::SEARCH: {
+        const int maker = static_cast<int>(rng() % makers.size());
+        auto res = m_db->searchCameras(makers.at(maker));
+        ok = res.success;
+        error = res.errorMessage;
+        code = res.errorCode;
+        break;
+      }
+      case StressOp::PAGE: {
+        PageParams params;
+        params.pageSize = options.pageSize;
+        params.orderBy = "name";
+        const qint64 pages = qMax<qint64>(1, m_maxId.load() / params.pageSize);
+        params.pageIndex = static_cast<int>(rng() % pages) + 1;
+        auto res = m_db->cameraInfoTable()->selectByPage(params);
+        ok = res.success;
+        error = res.errorMessage;
+        code = res.errorCode;
+        break;
+      }
+      case StressOp::INSERT: {
+        auto res = m_db->addCamera(m_gen.make(m_nextIndex.fetch_add(1)));
+        ok = res.success;
+        error = res.errorMessage;
+        code = res.errorCode;
+        if (ok) {
+          qint64 seen = m_maxId.load();
+          while (res.data > seen &&
+                 !m_maxId.compare_exchange_weak(seen, res.data)) {
+          }
+        }
+        break;
+      }
+      case StressOp::UPDATE: {
+        auto cur = m_db->getCamera(randomId());
+        ok = cur.success;
+        error = cur.errorMessage;
+        code = cur.errorCode;
+        if (ok) {
+          cur.data.version = QString("v%1").arg(rng() % 100);
+          auto res = m_db->updateCamera(cur.data);
+          ok = res.success;
+          error = res.errorMessage;
+          code = res.errorCode;
+        }
+        break;
+      }
+      case StressOp::REMOVE: {
+        auto res = m_db->removeCamera(randomId());
+        ok = res.success;
+        error = res.errorMessage;
+        code = res.errorCode;
+        break;
+      }
+    }
+    const qint64 ns = timer.nsecsElapsed();
+    w->latency[op].record(ns);
+    m_ops.fetch_add(1, std::memory_order_relaxed);
+    if (ok) continue;
+
+    if (code == DbErrorCode::NOT_FOUND) {
+      ++w->misses[op];
+      continue;
+    }
+    ++w->errors[op];
+    switch (code) {
+      case DbErrorCode::BUSY:
+        if (ns >= timeoutNs) {
+          ++w->timeouts;
+        } else {
+          ++w->busy;
+        }
+        break;
+      case DbErrorCode::NOT_OPEN:
+        // 表类在连接池耗尽时拿到无效连接，统一报告为此错误
+        ++w->poolErrors;
+        break;
+      default:
+        ++w->otherErrors;
+        break;
+    }
+    if (w->firstError.isEmpty()) w->firstError = error;
+  }
+}
+
+QJsonObject StressHarness::run(const StressOptions& options) {
+  const int threads = options.readers + options.writers;
+  QVector<Worker> workers(threads);
+  ConnectionPool* pool = m_db->connectionPool();
+  const quint64 exhaustedBefore = pool ? pool->exhaustedCount() : 0;
+  const qint64 walStart = walBytes();
+  qint64 walMax = walStart;
+
+  m_ops.store(0);
+  m_stop.store(false);
+  std::vector<std::thread> runners;
+  runners.reserve(threads);
+  for (int i = 0; i < threads; ++i) {
+    const bool writer = i >= options.readers;
+    Worker* w = &workers[i];
+    runners.emplace_back(
+        [this, w, writer, &options]() { runWorker(w, writer, options); });
+  }
+
+  // 按间隔采样吞吐与WAL大小
+  QJsonArray timeline;
+  QElapsedTimer clock;
+  clock.start();
+  quint64 lastOps = 0;
+  qint64 lastMs = 0;
+  while (lastMs < options.durationMs) {
+    const qint64 remain = options.durationMs - lastMs;
+    QThread::msleep(static_cast<unsigned long>(
+        qMin<qint64>(options.intervalMs, remain)));
+    const qint64 nowMs = clock.elapsed();
+    const quint64 ops = m_ops.load();
+    const qint64 wal = walBytes();
+    walMax = qMax(walMax, wal);
+
+    QJsonObject point;
+    point["tMs"] = nowMs;
+    point["ops"] = static_cast<qint64>(ops - lastOps);
+    point["opsPerSec"] =
+        nowMs > lastMs ? (ops - lastOps) * 1000.0 / (nowMs - lastMs) : 0.0;
+    point["walBytes"] = wal;
+    timeline.append(point);
+    lastOps = ops;
+    lastMs = nowMs;
+  }
+  m_stop.store(true);
+  for (auto& t : runners) t.join();
+  const qint64 elapsedMs = clock.elapsed();
+
+  // 汇总各线程计数
+  Worker sum;
+  for (const Worker& w : workers) {
+    for (int i = 0; i < kOpCount; ++i) {
+      sum.latency[i].merge(w.latency[i]);
+      sum.errors[i] += w.errors[i];
+      sum.misses[i] += w.misses[i];
+    }
+    sum.busy += w.busy;
+    sum.timeouts += w.timeouts;
+    sum.poolErrors += w.poolErrors;
+    sum.otherErrors += w.otherErrors;
+    if (sum.firstError.isEmpty()) sum.firstError = w.firstError;
+  }
+
+  QJsonObject operations;
+  for (int i = 0; i < kOpCount; ++i) {
+    if (sum.latency[i].count() == 0) continue;
+    QJsonObject o = sum.latency[i].toJson();
+    o["errors"] = static_cast<qint64>(sum.errors[i]);
+    o["misses"] = static_cast<qint64>(sum.misses[i]);
+    operations[opName(static_cast<StressOp>(i))] = o;
+  }
+
+  QJsonObject errors;
+  errors["busy"] = static_cast<qint64>(sum.busy);
+  errors["timeout"] = static_cast<qint64>(sum.timeouts);
+  errors["pool"] = static_cast<qint64>(sum.poolErrors);
+  errors["other"] = static_cast<qint64>(sum.otherErrors);
+  if (!sum.firstError.isEmpty()) errors["firstError"] = sum.firstError;
+
+  QJsonObject wal;
+  wal["startBytes"] = walStart;
+  wal["maxBytes"] = walMax;
+  wal["endBytes"] = walBytes();
+
+  const quint64 totalOps = m_ops.load();
+  QJsonObject report;
+  report["threads"] = threads;
+  report["readers"] = options.readers;
+  report["writers"] = options.writers;
+  report["durationMs"] = elapsedMs;
+  report["totalOps"] = static_cast<qint64>(totalOps);
+  report["opsPerSec"] = elapsedMs > 0 ? totalOps * 1000.0 / elapsedMs : 0.0;
+  report["operations"] = operations;
+  report["errors"] = errors;
+  report["poolExhaustedEvents"] = static_cast<qint64>(
+      pool ? pool->exhaustedCount() - exhaustedBefore : 0);
+  report["wal"] = wal;
+  const BaseDatabaseManager::DatabaseStats dbStats = m_db->getStatistics();
+  report["sqliteMemory"] = dbStats.sqlite.toJson();
+  report["sqliteProcess"] = dbStats.sqliteProcess.toJson();
+  report["timeline"] = timeline;
+  return report;
+}
+
+QJsonArray StressHarness::scale(const StressOptions& options,
+                                const QVector<int>& threadCounts) {
+  const int base = qMax(1, options.readers + options.writers);
+  QJsonArray curve;
+  for (int threads : threadCounts) {
+    if (threads <= 0) continue;
+    StressOptions step = options;
+    step.writers =
+        qRound(static_cast<double>(threads) * options.writers / base);
+    if (threads > 1) {
+      if (options.writers > 0) step.writers = qMax(1, step.writers);
+      if (options.readers > 0) step.writers = qMin(threads - 1, step.writers);
+    }
+    step.readers = threads - step.writers;
+
+    QTextStream(stderr) << QString("扩展曲线: %1 线程（读%2 写%3）\n")
+                               .arg(threads)
+                               .arg(step.readers)
+                               .arg(step.writers);
+    curve.append(run(step));
+  }
+  return curve;
+}
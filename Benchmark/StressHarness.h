@@ -0,0 +1,106 @@
+﻿// StressHarness.h - 多线程混合负载压测
+#ifndef STRESS_HARNESS_H
+#define STRESS_HARNESS_H
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+#include <atomic>
+
+#include "CameraFleetGenerator.h"
+
+class DeviceDatabaseManager;
+
+/**
+ * @brief 压测操作类型
+ */
+enum class StressOp {
+  READ = 0,    ///< 按ID读取（读线程）
+  SEARCH = 1,  ///< 关键词搜索（读线程）
+  PAGE = 2,    ///< 分页查询（读线程）
+  INSERT = 3,  ///< 新增（写线程）
+  UPDATE = 4,  ///< 更新（写线程）
+  REMOVE = 5   ///< 删除（写线程）
+};
+
+/**
+ * @brief 压测参数
+ * 读线程按 read/search/page 的权重、写线程按 insert/update/remove 的
+ * 权重随机选择操作
+ */
+struct StressOptions {
+  int readers = 4;                          ///< 读线程数
+  int writers = 2;                          ///< 写线程数
+  int durationMs = 10000;                   ///< 每轮持续时间（毫秒）
+  int intervalMs = 1000;                    ///< 吞吐与WAL采样间隔（毫秒）
+  int pageSize = 50;                        ///< 分页查询的页大小
+  int weights[6] = {80, 5, 15, 60, 35, 5};  ///< 各操作权重（按StressOp）
+};
+
+/**
+ * @brief 多线程混合负载压测
+ * 针对 DeviceDatabaseManager 运行固定时长的读写混合负载，报告：
+ * 按间隔采样的吞吐与WAL文件大小、各操作类型的延迟分位数、
+ * busy/超时/连接池耗尽等错误计数；也可按线程数逐级运行得到扩展曲线。
+ */
+class StressHarness {
+ public:
+  /**
+   * @brief 构造函数
+   * @param db 已初始化并装载数据集的设备数据库
+   * @param gen 生成数据集所用的生成器（新增行沿用同一生成规则）
+   * @param seededRows 数据集行数（ID为1~seededRows）
+   * @param seed 随机种子
+   */
+  StressHarness(DeviceDatabaseManager* db, const CameraFleetGenerator& gen,
+                qint64 seededRows, quint64 seed);
+
+  /**
+   * @brief 运行一轮压测
+   * @param options 压测参数
+   * @return 本轮报告
+   */
+  QJsonObject run(const StressOptions& options);
+
+  /**
+   * @brief 按线程数逐级运行，得到扩展曲线
+   * 每级保持 options 中读写线程的比例（至少各一个，线程数为1时取多数）
+   * @param options 压测参数（读写线程数只用于确定比例）
+   * @param threadCounts 各级总线程数
+   * @return 各级报告
+   */
+  QJsonArray scale(const StressOptions& options,
+                   const QVector<int>& threadCounts);
+
+  /**
+   * @brief 操作类型名称
+   */
+  static QString opName(StressOp op);
+
+  /**
+   * @brief 解析 "read=80,search=5,..." 形式的权重
+   * @param text 权重描述
+   * @param options 写入的参数
+   * @return 是否解析成功
+   */
+  static bool parseMix(const QString& text, StressOptions* options);
+
+ private:
+  struct Worker;
+
+  qint64 walBytes() const;
+  void runWorker(Worker* worker, bool writer, const StressOptions& options);
+
+  DeviceDatabaseManager* m_db;
+  CameraFleetGenerator m_gen;
+  quint64 m_seed;
+  QString m_walPath;
+
+  std::atomic<qint64> m_nextIndex;  ///< 下一个新增行的行号
+  std::atomic<qint64> m_maxId;      ///< 已知最大ID（随机读写的上界）
+  std::atomic<quint64> m_ops{0};    ///< 本轮已完成操作数
+  std::atomic<bool> m_stop{false};
+};
+
+#endif  // STRESS_HARNESS_H
@@ -0,0 +1,588 @@
+﻿// main.cpp - 相机信息基准测试与压测程序
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <random>
+
+#include "BenchmarkRunner.h"
+#include "CameraFleetGenerator.h"
+#include "DeviceDatabaseManager/CameraInfoTable.h"
+#include "DeviceDatabaseManager/DeviceDatabaseManager.h"
+#include "PoolBenchmarks.h"
+#include "StartupBenchmark.h"
+#include "StressHarness.h"
+#include "TraceSpan.h"
+#include "WorkloadCapture.h"
+
+namespace {
+
+constexpr int kPopulateChunk = 10000;  // 装载数据集时每个事务的行数
+constexpr int kBatchSize = 1000;       // batch_insert 每次采样的行数
+constexpr int kPageSize = 50;          // 分页基准的页大小
+constexpr int kDecodeRows = 1000;      // 解码基准每次读取的行数
+
+bool g_verbose = false;
+
+// 框架在热路径上打印大量调试/信息日志，计时期间默认只保留警告以上
+void benchMessageHandler(QtMsgType type, const QMessageLogContext&,
+                         const QString& msg) {
+  if (!g_verbose && (type == QtDebugMsg || type == QtInfoMsg)) return;
+  QTextStream(stderr) << msg << '\n';
+}
+
+// 解析 "5000"、"10k"、"2M" 形式的行数
+qint64 parseRows(const QString& text) {
+  QString t = text.trimmed().toLower();
+  qint64 scale = 1;
+  if (t.endsWith('k')) {
+    scale = 1000;
+    t.chop(1);
+  } else if (t.endsWith('m')) {
+    scale = 1000 * 1000;
+    t.chop(1);
+  }
+  bool ok = false;
+  const qint64 n = t.toLongLong(&ok);
+  return ok && n > 0 ? n * scale : -1;
+}
+
+bool populate(CameraInfoTable* table, const CameraFleetGenerator& gen,
+              qint64 rows) {
+  // 进度与摘要写到标准错误，标准输出只留给JSON
+  QTextStream out(stderr);
+  QElapsedTimer timer;
+  timer.start();
+  qint64 reported = 0;
+  for (qint64 first = 0; first < rows; first += kPopulateChunk) {
+    const int count = static_cast<int>(qMin<qint64>(kPopulateChunk,
+                                                    rows - first));
+    auto r = table->batchInsert(gen.batch(first, count));
+    if (!r.success || r.data != count) {
+      QTextStream(stderr) << "装载数据集失败: " << r.errorMessage << '\n';
+      return false;
+    }
+    if ((first + count) * 10 / rows > reported) {
+      reported = (first + count) * 10 / rows;
+      out << QString("装载 %1 / %2 行（%3 秒）\n")
+                 .arg(first + count)
+                 .arg(rows)
+                 .arg(timer.elapsed() / 1000.0, 0, 'f', 1);
+      out.flush();
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief 运行基准套件（只读基准在前，写入与维护基准在后）
+ * @return 是否全部成功
+ */
+bool runBenchmarks(DeviceDatabaseManager& db, const CameraFleetGenerator& gen,
+                   qint64 rows, quint64 seed, const BenchmarkOptions& options,
+                   const QString& dirPath, QJsonObject* report) {
+  CameraInfoTable* table = db.cameraInfoTable();
+  std::mt19937_64 rng(seed);
+  auto randomIndex = [&rng, rows]() {
+    return static_cast<qint64>(rng() % static_cast<quint64>(rows));
+  };
+  const QStringList& makers = CameraFleetGenerator::manufacturers();
+
+  BenchmarkRunner runner(options, rows);
+  using Scale = BenchmarkRunner::Scale;
+
+  // ---- 只读基准（数据集保持不变）----
+
+  runner.run("point_lookup", Scale::SINGLE, 1, [&](int, QString* error) {
+    // 新库的自增ID与行号一一对应
+    auto r = db.getCamera(static_cast<int>(randomIndex() + 1));
+    if (!r.success) *error = r.errorMessage;
+    return r.success;
+  });
+
+  runner.run("point_lookup_sql", Scale::SINGLE, 1, [&](int, QString* error) {
+    auto r = table->selectById(static_cast<int>(randomIndex() + 1));
+    if (!r.success) *error = r.errorMessage;
+    return r.success;
+  });
+
+  runner.run("serial_lookup", Scale::SINGLE, 1, [&](int, QString* error) {
+    auto r = db.getCameraBySerialNumber(gen.serialFor(randomIndex()));
+    if (!r.success) *error = r.errorMessage;
+    return r.success;
+  });
+
+  runner.run("serial_lookup_sql", Scale::SINGLE, 1, [&](int, QString* error) {
+    auto r = table->selectBySerialNumber(gen.serialFor(randomIndex()));
+    if (!r.success) *error = r.errorMessage;
+    return r.success;
+  });
+
+  // sqlite_native 构建中上面的查找走原生语句，这里关掉它对比 QSqlQuery
+  if (NativeStatement::available()) {
+    NativeStatement::setEnabled(false);
+    runner.run("point_lookup_qsqlquery", Scale::SINGLE, 1,
+               [&](int, QString* error) {
+                 auto r = table->selectById(
+                     static_cast<int>(randomIndex() + 1));
+                 if (!r.success) *error = r.errorMessage;
+                 return r.success;
+               });
+    runner.run("serial_lookup_qsqlquery", Scale::SINGLE, 1,
+               [&](int, QString* error) {
+                 auto r = table->selectBySerialNumber(
+                     gen.serialFor(randomIndex()));
+                 if (!r.success) *error = r.errorMessage;
+                 return r.success;
+               });
+    NativeStatement::setEnabled(true);
+  }
+
+  // 与 serial_lookup_sql 同一查找，经条件查询构建器生成
+  runner.run("criteria_lookup", Scale::SINGLE, 1, [&](int, QString* error) {
+    auto r = table->select(table->tableQuery().where(
+        "serial_number", QueryOp::EQ, gen.serialFor(randomIndex())));
+    if (!r.success) *error = r.errorMessage;
+    return r.success && r.data.size() == 1;
+  });
+
+  // 不存在的序列号：数据集之外的下标，对比序列号索引与直接查库
+  MembershipIndex* serialIndex = table->serialIndex();
+  serialIndex->rebuild();
+  auto missingSerial = [&]() {
+    return gen.serialFor((Q_INT64_C(1) << 40) + randomIndex());
+  };
+  auto runMiss = [&](const QString& name) {
+    runner.run(name, Scale::SINGLE, 1, [&](int, QString* error) {
+      if (table->serialNumberExists(missingSerial())) {
+        *error = "不存在的序列号被判定为存在";
+        return false;
+      }
+      return true;
+    });
+  };
+  runMiss("serial_exists_miss");
+  serialIndex->setEnabled(false);
+  runMiss("serial_exists_miss_db");
+  serialIndex->setEnabled(true);
+
+  runner.run("search", Scale::HEAVY, 1, [&](int i, QString* error) {
+    const QString& keyword = makers.at(qAbs(i) % makers.size());
+    auto r = db.searchCameras(keyword);
+    if (!r.success) *error = r.errorMessage;
+    return r.success;
+  });
+
+  PageParams page;
+  page.pageSize = kPageSize;
+  page.orderBy = "name";
+  runner.run("page_first", Scale::SINGLE, 1, [&](int, QString* error) {
+    page.pageIndex = 1;
+    auto r = table->selectByPage(page);
+    if (!r.success) *error = r.errorMessage;
+    return r.success;
+  });
+
+  runner.run("page_n", Scale::HEAVY, 1, [&](int, QString* error) {
+    // 随机深页：OFFSET 的代价随页码线性增长
+    page.pageIndex = static_cast<int>(randomIndex() / kPageSize) + 1;
+    auto r = table->selectByPage(page);
+    if (!r.success) *error = r.errorMessage;
+    return r.success;
+  });
+
+  // 行解码：sqlite_native 构建中低基数列以 UTF-16 视图查驻留池，
+  // decode_rows_alloc 关掉视图查找，每个单元格先构造 QString 再查池
+  auto runDecode = [&](const QString& name) {
+    runner.run(name, Scale::HEAVY, kDecodeRows, [&](int i, QString* error) {
+      const qint64 offset =
+          rows > kDecodeRows ? (qAbs(i) * kDecodeRows) % (rows - kDecodeRows)
+                             : 0;
+      auto r = table->select(
+          table->tableQuery().orderBy("id").limit(kDecodeRows, offset));
+      if (!r.success) *error = r.errorMessage;
+      return r.success;
+    });
+  };
+  if (NativeStatement::available()) {
+    runDecode("decode_rows");
+    table->interner()->setViewLookup(false);
+    runDecode("decode_rows_alloc");
+    table->interner()->setViewLookup(true);
+  }
+
+  runner.run("statistics", Scale::HEAVY, 1, [&](int, QString* error) {
+    const auto stats = db.getCameraStatistics();
+    if (stats.isEmpty()) *error = "统计结果为空";
+    return !stats.isEmpty();
+  });
+
+  // ---- 写入基准（在数据集之后追加新行）----
+
+  qint64 next = rows;
+  runner.run("insert", Scale::SINGLE, 1, [&](int, QString* error) {
+    auto r = db.addCamera(gen.make(next++));
+    if (!r.success) *error = r.errorMessage;
+    return r.success;
+  });
+
+  if (NativeStatement::available()) {
+    NativeStatement::setEnabled(false);
+    runner.run("insert_qsqlquery", Scale::SINGLE, 1, [&](int, QString* error) {
+      auto r = db.addCamera(gen.make(next++));
+      if (!r.success) *error = r.errorMessage;
+      return r.success;
+    });
+    NativeStatement::setEnabled(true);
+  }
+
+  runner.run("batch_insert", Scale::HEAVY, kBatchSize,
+             [&](int, QString* error) {
+               auto r = db.importCameras(gen.batch(next, kBatchSize));
+               next += kBatchSize;
+               if (!r.success) *error = r.errorMessage;
+               return r.success;
+             });
+
+  // ---- 维护基准 ----
+
+  runner.run("backup", Scale::HEAVY, 1, [&](int i, QString* error) {
+    const QString path =
+        QDir(dirPath).absoluteFilePath(QString("backup_%1.db").arg(i));
+    QFile::remove(path);
+    const bool ok = db.backupDatabase(path);
+    QFile::remove(path);
+    if (!ok) *error = "备份失败";
+    return ok;
+  });
+
+  runner.run("optimize", Scale::HEAVY, 1, [&](int, QString* error) {
+    const bool ok = db.optimizeDatabase();
+    if (!ok) *error = "优化失败";
+    return ok;
+  });
+
+  runner.printSummary();
+  *report = runner.report();
+  report->insert("serialIndex", serialIndex->stats().toJson());
+
+  for (const BenchmarkResult& r : runner.results()) {
+    if (!r.ok) return false;
+  }
+  return true;
+}
+
+/**
+ * @brief 运行多线程混合负载压测（可选扩展曲线）
+ * @return 参数是否有效（压测中的错误计入报告，不视为失败）
+ */
+bool runStress(const QCommandLineParser& parser, DeviceDatabaseManager& db,
+               const CameraFleetGenerator& gen, qint64 rows, quint64 seed,
+               QJsonObject* report) {
+  StressOptions options;
+  options.readers = qMax(0, parser.value("readers").toInt());
+  options.writers = qMax(0, parser.value("writers").toInt());
+  options.durationMs = qMax(1, parser.value("duration").toInt());
+  options.intervalMs = qMax(1, parser.value("interval").toInt());
+  if (parser.isSet("mix") && !StressHarness::parseMix(parser.value("mix"),
+                                                       &options)) {
+    QTextStream(stderr) << "无效的操作权重: " << parser.value("mix") << '\n';
+    return false;
+  }
+  if (options.readers + options.writers <= 0) {
+    QTextStream(stderr) << "读写线程数不能都为0\n";
+    return false;
+  }
+
+  StressHarness harness(&db, gen, rows, seed);
+  QTextStream err(stderr);
+
+  const QJsonObject run = harness.run(options);
+  err << QString("压测: %1 读 + %2 写，%3 ops/s，busy %4，超时 %5，"
+                 "连接池耗尽 %6\n")
+             .arg(options.readers)
+             .arg(options.writers)
+             .arg(run["opsPerSec"].toDouble(), 0, 'f', 1)
+             .arg(run["errors"].toObject()["busy"].toInt())
+             .arg(run["errors"].toObject()["timeout"].toInt())
+             .arg(run["poolExhaustedEvents"].toInt());
+
+  QJsonObject meta = BenchmarkRunner::environment();
+  meta["mode"] = "stress";
+  meta["datasetRows"] = rows;
+  meta["maxConnections"] = db.config().maxConnections;
+  meta["busyTimeoutMs"] = db.config().busyTimeout;
+  QJsonObject weights;
+  for (int i = 0; i < 6; ++i) {
+    weights[StressHarness::opName(static_cast<StressOp>(i))] =
+        options.weights[i];
+  }
+  meta["weights"] = weights;
+
+  report->insert("schema", 1);
+  report->insert("meta", meta);
+  report->insert("run", run);
+
+  if (parser.isSet("scale")) {
+    QVector<int> counts;
+    for (const QString& c :
+         parser.value("scale").split(',', QString::SkipEmptyParts)) {
+      counts.append(c.trimmed().toInt());
+    }
+    const QJsonArray curve = harness.scale(options, counts);
+    for (const QJsonValue& v : curve) {
+      const QJsonObject step = v.toObject();
+      err << QString("%1 线程: %2 ops/s\n")
+                 .arg(step["threads"].toInt(), 3)
+                 .arg(step["opsPerSec"].toDouble(), 0, 'f', 1);
+    }
+    report->insert("scaling", curve);
+  }
+  return true;
+}
+
+/**
+ * @brief 运行连接池争用微基准（内存库，不装载数据集）
+ * @return 参数是否有效
+ */
+bool runPool(const QCommandLineParser& parser, QJsonObject* report) {
+  PoolBenchOptions options;
+  options.durationMs = qMax(1, parser.value("pool-duration").toInt());
+  options.threadCounts.clear();
+  for (const QString& c :
+       parser.value("pool-threads").split(',', QString::SkipEmptyParts)) {
+    const int n = c.trimmed().toInt();
+    if (n <= 0) {
+      QTextStream(stderr) << "无效的线程数: " << c << '\n';
+      return false;
+    }
+    options.threadCounts.append(n);
+  }
+  if (parser.isSet("filter")) {
+    options.filters =
+        parser.value("filter").split(',', QString::SkipEmptyParts);
+  }
+
+  PoolBenchmarks bench(options);
+  const QJsonArray results = bench.run();
+
+  QJsonObject meta = BenchmarkRunner::environment();
+  meta["mode"] = "pool";
+  meta["durationMs"] = options.durationMs;
+
+  report->insert("schema", 1);
+  report->insert("meta", meta);
+  report->insert("results", results);
+  return true;
+}
+
+/**
+ * @brief 运行冷启动与热启动基准（全部业务库，不装载数据集）
+ * @return 是否每次启动都成功
+ */
+bool runStartup(const QCommandLineParser& parser, const QString& dirPath,
+                QJsonObject* report) {
+  const int iterations = qMax(1, parser.value("startup-iterations").toInt());
+  StartupBenchmark bench(dirPath, iterations);
+  const QJsonObject results = bench.run();
+
+  QJsonObject meta = BenchmarkRunner::environment();
+  meta["mode"] = "startup";
+  meta["iterations"] = iterations;
+
+  report->insert("schema", 1);
+  report->insert("meta", meta);
+  report->insert("results", results);
+  return results["cold"].toObject()["failures"].toInt() == 0 &&
+         results["warm"].toObject()["failures"].toInt() == 0;
+}
+
+/**
+ * @brief 补充构建信息后输出JSON报告
+ * @return 进程退出码
+ */
+int writeReport(const QCommandLineParser& parser, QJsonObject report,
+                bool ok) {
+  QJsonObject meta = report["meta"].toObject();
+#ifdef DB_SQLITE_NATIVE
+  meta["sqliteNative"] = true;
+#else
+  meta["sqliteNative"] = false;
+#endif
+  meta["sqliteMultiThread"] = NativeStatement::multiThreadMode();
+  report["meta"] = meta;
+
+  const QByteArray json = QJsonDocument(report).toJson();
+  if (parser.isSet("output")) {
+    QFile file(parser.value("output"));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+      QTextStream(stderr) << "无法写入结果文件: " << file.fileName() << '\n';
+      return 1;
+    }
+    file.write(json);
+  } else {
+    QTextStream(stdout) << json;
+  }
+  return ok ? 0 : 1;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  QCoreApplication app(argc, argv);
+  app.setApplicationName("DataBaseBench");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("相机信息表基准测试");
+  parser.addHelpOption();
+  parser.addOptions({
+      {"rows", "数据集行数（支持k/M后缀，1k~10M）", "n", "10k"},
+      {"warmup", "每个基准的预热次数", "n", "3"},
+      {"repetitions", "重量级基准的采样次数", "n", "20"},
+      {"samples", "单次操作基准的采样次数", "n", "1000"},
+      {"filter", "只运行名称包含这些子串的基准（逗号分隔）", "names"},
+      {"seed", "数据集种子", "n",
+       QString::number(CameraFleetGenerator::kDefaultSeed)},
+      {"dir", "数据库目录（默认临时目录，结束后删除）", "path"},
+      {"output", "JSON结果文件（默认输出到标准输出）", "file"},
+      {"max-connections", "连接池上限", "n", "10"},
+      {"stress", "运行多线程混合负载压测而非基准套件"},
+      {"readers", "压测读线程数", "n", "4"},
+      {"writers", "压测写线程数", "n", "2"},
+      {"duration", "每轮压测时长（毫秒）", "ms", "10000"},
+      {"interval", "吞吐采样间隔（毫秒）", "ms", "1000"},
+      {"mix", "操作权重（如 read=80,page=15,insert=60）", "weights"},
+      {"scale", "按这些总线程数逐级压测（逗号分隔，如 1,2,4,8,16,32,64）",
+       "counts"},
+      {"pool", "运行连接池争用微基准（内存库）而非基准套件"},
+      {"pool-threads", "连接池微基准的各级线程数（逗号分隔）", "counts",
+       "1,2,4,8,16,32,64"},
+      {"pool-duration", "连接池微基准每个测点的时长（毫秒）", "ms", "500"},
+      {"startup", "运行注册中心冷启动与热启动基准而非基准套件"},
+      {"startup-iterations", "启动基准每种模式的启动次数", "n", "20"},
+      {"trace", "记录各阶段耗时区间并写出追踪事件JSON（Perfetto可打开）",
+       "file"},
+      {"lock-profile", "统计框架互斥锁的争用并写入报告的 locks 字段"},
+      {"capture", "把计时阶段执行的语句写入负载日志（DataBaseReplay 可重放）",
+       "file"},
+      {"sqlite-multithread",
+       "以SQLite多线程模式（连接不带互斥锁）打开连接，需 sqlite_native"},
+      {"verbose", "保留框架的调试与信息日志"},
+  });
+  parser.process(app);
+
+  g_verbose = parser.isSet("verbose");
+  qInstallMessageHandler(benchMessageHandler);
+  // 须在打开任何连接之前切换
+  if (parser.isSet("sqlite-multithread") &&
+      !NativeStatement::enableMultiThreadMode()) {
+    return 2;
+  }
+
+  if (parser.isSet("pool")) {
+    QJsonObject report;
+    const bool ok = runPool(parser, &report);
+    if (report.isEmpty()) return 2;
+    return writeReport(parser, report, ok);
+  }
+
+  if (parser.isSet("startup")) {
+    QTemporaryDir startupDir;
+    const QString dirPath =
+        parser.isSet("dir") ? parser.value("dir") : startupDir.path();
+    QDir().mkpath(dirPath);
+    QJsonObject report;
+    const bool ok = runStartup(parser, dirPath, &report);
+    return writeReport(parser, report, ok);
+  }
+
+  const qint64 rows = parseRows(parser.value("rows"));
+  if (rows <= 0) {
+    QTextStream(stderr) << "无效的行数: " << parser.value("rows") << '\n';
+    return 2;
+  }
+
+  BenchmarkOptions options;
+  options.warmup = qMax(0, parser.value("warmup").toInt());
+  options.repetitions = qMax(1, parser.value("repetitions").toInt());
+  options.samples = qMax(1, parser.value("samples").toInt());
+  if (parser.isSet("filter")) {
+    options.filters =
+        parser.value("filter").split(',', QString::SkipEmptyParts);
+  }
+  const quint64 seed = parser.value("seed").toULongLong();
+
+  QTemporaryDir tempDir;
+  const QString dirPath =
+      parser.isSet("dir") ? parser.value("dir") : tempDir.path();
+  QDir().mkpath(dirPath);
+  const QString dbPath = QDir(dirPath).absoluteFilePath("device_bench.db");
+  QFile::remove(dbPath);
+
+  DatabaseConfig config("DEVICE_BENCH", dbPath);
+  config.maxConnections = qMax(1, parser.value("max-connections").toInt());
+  DeviceDatabaseManager db(config);
+  if (!db.initialize()) {
+    QTextStream(stderr) << "数据库初始化失败: " << dbPath << '\n';
+    return 1;
+  }
+  CameraInfoTable* table = db.cameraInfoTable();
+  // 审计在基准中不落盘，关闭采集以免计入无关开销
+  table->operations()->setAuditEnabled(false);
+
+  CameraFleetGenerator gen(seed);
+  if (!populate(table, gen, rows)) return 1;
+  if (!db.cameraInfoMirror()->load().success) {
+    QTextStream(stderr) << "加载相机信息镜像失败\n";
+    return 1;
+  }
+
+  // 追踪只覆盖计时阶段，装载数据集的区间不计入
+  if (parser.isSet("trace")) Tracer::setEnabled(true);
+  if (parser.isSet("lock-profile")) {
+    LockProfiler::reset();
+    LockProfiler::setEnabled(true);
+  }
+  if (parser.isSet("capture")) {
+    QString error;
+    if (!WorkloadCapture::start(parser.value("capture"),
+                                WorkloadRedaction::NONE, &error)) {
+      QTextStream(stderr) << error << '\n';
+      return 1;
+    }
+  }
+  QJsonObject report;
+  const bool ok =
+      parser.isSet("stress")
+          ? runStress(parser, db, gen, rows, seed, &report)
+          : runBenchmarks(db, gen, rows, seed, options, dirPath, &report);
+  if (parser.isSet("capture")) {
+    const WorkloadCapture::Stats captured = WorkloadCapture::stop();
+    QTextStream(stderr) << QString("负载日志: %1 条语句，%2 字节\n")
+                               .arg(captured.statements)
+                               .arg(captured.bytes);
+  }
+  db.close();
+  if (parser.isSet("trace")) {
+    Tracer::setEnabled(false);
+    if (!Tracer::writeJson(parser.value("trace"))) {
+      QTextStream(stderr) << "无法写入追踪文件: " << parser.value("trace")
+                          << '\n';
+    }
+  }
+  if (report.isEmpty()) return 2;
+  if (parser.isSet("lock-profile")) {
+    LockProfiler::setEnabled(false);
+    QTextStream(stderr) << LockProfiler::summary();
+    report["locks"] = LockProfiler::report();
+  }
+
+  QJsonObject meta = report["meta"].toObject();
+  meta["seed"] = QString::number(seed);
+  report["meta"] = meta;
+  return writeReport(parser, report, ok);
+}
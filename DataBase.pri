@@ -0,0 +1,117 @@
+﻿# DataBase.pri - 框架公共配置与源文件（主程序与基准测试工程共用）
+
+QT += core sql
+QT -= gui
+
+# 编码设置
+msvc {
+    QMAKE_CFLAGS += /utf-8
+    QMAKE_CXXFLAGS += /utf-8
+    DEFINES += UNICODE _UNICODE
+}
+
+gcc {
+    QMAKE_CXXFLAGS += -finput-charset=UTF-8 -fexec-charset=UTF-8
+}
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+INCLUDEPATH += $$PWD/Base
+INCLUDEPATH += $$PWD/FrameWork
+INCLUDEPATH += $$PWD/Functions
+INCLUDEPATH += $$PWD/Registry
+
+# 编译器警告选项
+gcc {
+    QMAKE_CXXFLAGS += -Wall
+}
+msvc {
+    QMAKE_CXXFLAGS += /W4
+}
+
+# Windows 特定库
+win32 {
+    LIBS += -lkernel32
+}
+
+# 可选：直接调用SQLite C API（变更捕获钩子等），qmake CONFIG+=sqlite_native
+# 要求Qt的QSQLITE驱动以 -system-sqlite 构建，与此处链接同一份sqlite3
+sqlite_native {
+    DEFINES += DB_SQLITE_NATIVE
+    LIBS += -lsqlite3
+}
+
+HEADERS += \
+    $$PWD/Base/BaseDatabaseManager.h \
+    $$PWD/FrameWork/AsyncBatchWriter.h \
+    $$PWD/FrameWork/AuditTrail.h \
+    $$PWD/FrameWork/ChangeFeed.h \
+    $$PWD/FrameWork/ColumnarResult.h \
+    $$PWD/FrameWork/ContentAddressedStore.h \
+    $$PWD/FrameWork/DatabaseFramework.h \
+    $$PWD/FrameWork/LazyTableModel.h \
+    $$PWD/FrameWork/LiveQuery.h \
+    $$PWD/FrameWork/LockProfiler.h \
+    $$PWD/FrameWork/LockFreeRingBuffer.h \
+    $$PWD/FrameWork/MembershipIndex.h \
+    $$PWD/FrameWork/MirroredTable.h \
+    $$PWD/FrameWork/NativeStatement.h \
+    $$PWD/FrameWork/QueryPlanChecker.h \
+    $$PWD/FrameWork/SimdKernels.h \
+    $$PWD/FrameWork/SqlFunctions.h \
+    $$PWD/FrameWork/SqliteMemory.h \
+    $$PWD/FrameWork/SqliteNative.h \
+    $$PWD/FrameWork/StartupProfile.h \
+    $$PWD/FrameWork/StringInterner.h \
+    $$PWD/FrameWork/SystemLogSink.h \
+    $$PWD/FrameWork/TableQuery.h \
+    $$PWD/FrameWork/TraceSpan.h \
+    $$PWD/FrameWork/WorkloadCapture.h \
+    $$PWD/Functions/DataDatabaseManager/DataDataBaseStruct.h \
+    $$PWD/Functions/DataDatabaseManager/DataDatabaseManager.h \
+    $$PWD/Functions/DataDatabaseManager/FileAttachmentTable.h \
+    $$PWD/Functions/DataDatabaseManager/SystemLogTable.h \
+    $$PWD/Functions/DeviceDatabaseManager/CameraInfoTable.h \
+    $$PWD/Functions/DeviceDatabaseManager/DeviceDataBaseStruct.h \
+    $$PWD/Functions/DeviceDatabaseManager/DeviceDatabaseManager.h \
+    $$PWD/Functions/DeviceDatabaseManager/DeviceSqlFunctions.h \
+    $$PWD/Functions/ExperimentDatabaseManager/ExperimentDataBaseStruct.h \
+    $$PWD/Functions/ExperimentDatabaseManager/ExperimentDatabaseManager.h \
+    $$PWD/Functions/ExperimentDatabaseManager/ExperimentDataTable.h \
+    $$PWD/Functions/ExperimentDatabaseManager/ImageDataTable.h \
+    $$PWD/Functions/SystemDatabaseManager/OperationAuditTable.h \
+    $$PWD/Functions/SystemDatabaseManager/SystemDatabaseManager.h \
+    $$PWD/Registry/DatabaseRegistry.h
+
+SOURCES += \
+    $$PWD/Base/BaseDatabaseManager.cpp \
+    $$PWD/FrameWork/AuditTrail.cpp \
+    $$PWD/FrameWork/ChangeFeed.cpp \
+    $$PWD/FrameWork/ColumnarResult.cpp \
+    $$PWD/FrameWork/ContentAddressedStore.cpp \
+    $$PWD/FrameWork/DatabaseFramework.cpp \
+    $$PWD/FrameWork/LockProfiler.cpp \
+    $$PWD/FrameWork/MembershipIndex.cpp \
+    $$PWD/FrameWork/NativeStatement.cpp \
+    $$PWD/FrameWork/QueryPlanChecker.cpp \
+    $$PWD/FrameWork/SqlFunctions.cpp \
+    $$PWD/FrameWork/SqliteMemory.cpp \
+    $$PWD/FrameWork/StartupProfile.cpp \
+    $$PWD/FrameWork/StringInterner.cpp \
+    $$PWD/FrameWork/SystemLogSink.cpp \
+    $$PWD/FrameWork/TableQuery.cpp \
+    $$PWD/FrameWork/TraceSpan.cpp \
+    $$PWD/FrameWork/WorkloadCapture.cpp \
+    $$PWD/Functions/DataDatabaseManager/DataDatabaseManager.cpp \
+    $$PWD/Functions/DataDatabaseManager/FileAttachmentTable.cpp \
+    $$PWD/Functions/DataDatabaseManager/SystemLogTable.cpp \
+    $$PWD/Functions/DeviceDatabaseManager/CameraInfoTable.cpp \
+    $$PWD/Functions/DeviceDatabaseManager/DeviceDatabaseManager.cpp \
+    $$PWD/Functions/DeviceDatabaseManager/DeviceSqlFunctions.cpp \
+    $$PWD/Functions/ExperimentDatabaseManager/ExperimentDatabaseManager.cpp \
+    $$PWD/Functions/ExperimentDatabaseManager/ExperimentDataTable.cpp \
+    $$PWD/Functions/ExperimentDatabaseManager/ImageDataTable.cpp \
+    $$PWD/Functions/SystemDatabaseManager/OperationAuditTable.cpp \
+    $$PWD/Functions/SystemDatabaseManager/SystemDatabaseManager.cpp \
+    $$PWD/Registry/DatabaseRegistry.cpp
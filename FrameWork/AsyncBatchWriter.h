@@ -0,0 +1,304 @@
+﻿// AsyncBatchWriter.h - 无锁队列 + 后台批量写入线程
+#ifndef ASYNC_BATCH_WRITER_H
+#define ASYNC_BATCH_WRITER_H
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+
+#include "LockFreeRingBuffer.h"
+
+/**
+ * @brief 队列溢出策略
+ */
+enum class OverflowPolicy {
+  DROP,  ///< 队列满时丢弃新记录并计数
+  BLOCK  ///< 队列满时生产者等待写线程腾出空间（可限时）
+};
+
+/**
+ * @brief 异步批量写入器
+ * 生产者只做一次无锁入队；后台线程按批次取出记录并交给刷写回调，
+ * 刷写回调通常在一个事务内完成整批落盘。
+ * @tparam T 记录类型
+ */
+template <typename T>
+class AsyncBatchWriter {
+ public:
+  /**
+   * @brief 写入器参数
+   */
+  struct Options {
+    int capacity = 8192;         ///< 队列容量（向上取整为 2 的幂）
+    int batchSize = 512;         ///< 单批最大记录数
+    int flushIntervalMs = 200;   ///< 空闲时最长刷写间隔（毫秒）
+    OverflowPolicy overflowPolicy = OverflowPolicy::DROP;  ///< 溢出策略
+    /// 刷写失败的批次留在队首，隔一个刷写间隔后连同新记录按原顺序重试；
+    /// 仅在停止时仍失败才放弃（计入 failed）
+    bool retainFailedBatches = false;
+    /// BLOCK 策略下生产者最长等待（毫秒，<0 不限）。超时即丢弃并计数，
+    /// 此后直到下一批刷写成功前队列满时不再等待，立即丢弃
+    int blockTimeoutMs = -1;
+  };
+
+  /**
+   * @brief 运行计数
+   */
+  struct Stats {
+    quint64 enqueued = 0;       ///< 成功入队数
+    quint64 dropped = 0;        ///< 因队列满被丢弃数
+    quint64 blockedWaits = 0;   ///< 生产者因队列满而等待的次数
+    quint64 written = 0;        ///< 刷写成功的记录数
+    quint64 failed = 0;         ///< 刷写失败（已放弃）的记录数
+    quint64 batches = 0;        ///< 刷写批次数
+    quint64 failedBatches = 0;  ///< 失败批次数（含保留重试的失败尝试）
+  };
+
+  /// 刷写回调：在写线程中调用，返回整批是否成功
+  using FlushFn = std::function<bool(QVector<T>&)>;
+
+ private:
+  Options m_options;
+  FlushFn m_flushFn;
+  std::unique_ptr<LockFreeRingBuffer<T>> m_ring;
+  std::thread m_thread;
+  std::atomic<bool> m_running{false};
+  std::atomic<Qt::HANDLE> m_writerThreadId{nullptr};
+  /// 正在 push() 中的生产者数：写线程等其归零才退出，队列因此不会在
+  /// 生产者仍持有它时被 start() 替换
+  std::atomic<int> m_inFlight{0};
+  std::atomic<int> m_spaceWaiters{0};  ///< 因队列满而等待空位的生产者数
+  std::atomic<bool> m_stalled{false};  ///< 限时等待已超时，刷写成功前不再等
+
+  QMutex m_wakeMutex;
+  QWaitCondition m_wakeCond;     ///< 唤醒写线程
+  QWaitCondition m_drainedCond;  ///< 通知 flush() 等待者
+  QWaitCondition m_spaceCond;    ///< 通知阻塞的生产者队列已有空位
+
+  std::atomic<quint64> m_enqueued{0};
+  std::atomic<quint64> m_dropped{0};
+  std::atomic<quint64> m_blockedWaits{0};
+  std::atomic<quint64> m_written{0};
+  std::atomic<quint64> m_failed{0};
+  std::atomic<quint64> m_batches{0};
+  std::atomic<quint64> m_failedBatches{0};
+  std::atomic<quint64> m_processed{0};  ///< 已处理（成功+失败）记录数
+
+  void run() {
+    m_writerThreadId.store(QThread::currentThreadId());
+    QVector<T> batch;
+    batch.reserve(m_options.batchSize);
+
+    for (;;) {
+      T item;
+      while (batch.size() < m_options.batchSize && m_ring->tryPop(item)) {
+        batch.append(std::move(item));
+      }
+      if (!batch.isEmpty() && m_spaceWaiters.load() > 0) {
+        QMutexLocker locker(&m_wakeMutex);
+        m_spaceCond.wakeAll();
+      }
+
+      if (!batch.isEmpty()) {
+        const quint64 n = static_cast<quint64>(batch.size());
+        const bool ok = m_flushFn ? m_flushFn(batch) : true;
+        m_batches.fetch_add(1);
+        if (!ok) m_failedBatches.fetch_add(1);
+        if (!ok && m_options.retainFailedBatches && m_running.load()) {
+          // 批次留在队首，不计入已处理：flush() 会一直等到它真正落盘
+          QMutexLocker locker(&m_wakeMutex);
+          if (m_running.load()) {
+            m_wakeCond.wait(
+                &m_wakeMutex,
+                static_cast<unsigned long>(m_options.flushIntervalMs));
+          }
+          continue;
+        }
+        if (ok) m_stalled.store(false);
+        (ok ? m_written : m_failed).fetch_add(n);
+        m_processed.fetch_add(n);
+        batch.clear();
+        m_drainedCond.wakeAll();
+        continue;  // 队列可能仍有积压，继续取下一批
+      }
+
+      QMutexLocker locker(&m_wakeMutex);
+      if (!m_running.load() && m_inFlight.load() == 0 &&
+          m_ring->emptyApprox()) {
+        break;
+      }
+      m_drainedCond.wakeAll();
+      m_wakeCond.wait(&m_wakeMutex,
+                      static_cast<unsigned long>(m_options.flushIntervalMs));
+    }
+
+    m_writerThreadId.store(nullptr);
+  }
+
+ public:
+  AsyncBatchWriter() = default;
+  ~AsyncBatchWriter() { stop(); }
+
+  AsyncBatchWriter(const AsyncBatchWriter&) = delete;
+  AsyncBatchWriter& operator=(const AsyncBatchWriter&) = delete;
+
+  /**
+   * @brief 启动写线程
+   * @param options 写入器参数
+   * @param flushFn 刷写回调
+   * @return 已在运行时返回false
+   */
+  bool start(const Options& options, FlushFn flushFn) {
+    if (m_running.load()) return false;
+    // 上次运行的写线程已在 stop() 中等在途生产者归零后退出；此处再确认
+    // 一次，保证没有生产者仍在访问旧队列
+    while (m_inFlight.load() != 0) std::this_thread::yield();
+    m_options = options;
+    if (m_options.batchSize <= 0) m_options.batchSize = 1;
+    if (m_options.flushIntervalMs <= 0) m_options.flushIntervalMs = 1;
+    m_flushFn = std::move(flushFn);
+    m_ring = std::make_unique<LockFreeRingBuffer<T>>(
+        static_cast<size_t>(qMax(2, m_options.capacity)));
+    m_processed.store(m_enqueued.load());  // 重启后从当前位置重新对齐
+    m_stalled.store(false);
+    m_running.store(true);
+    m_thread = std::thread([this]() { run(); });
+    return true;
+  }
+
+  /**
+   * @brief 停止写线程（先排空队列中的全部记录）
+   */
+  void stop() {
+    if (!m_running.exchange(false)) return;
+    {
+      QMutexLocker locker(&m_wakeMutex);
+      m_wakeCond.wakeAll();
+      m_spaceCond.wakeAll();  // 阻塞的生产者放弃等待
+    }
+    if (m_thread.joinable()) m_thread.join();
+    m_flushFn = nullptr;
+  }
+
+  /**
+   * @brief 是否正在运行
+   * @return 是否运行
+   */
+  bool isRunning() const { return m_running.load(); }
+
+  /**
+   * @brief 当前线程是否为写线程
+   * @return 是否为写线程
+   */
+  bool isWriterThread() const {
+    const Qt::HANDLE id = m_writerThreadId.load();
+    return id != nullptr && id == QThread::currentThreadId();
+  }
+
+  /**
+   * @brief 生产者入队（不做任何 I/O）
+   * @param item 记录
+   * @return 是否入队成功（未运行或被丢弃时返回false）
+   */
+  bool push(T&& item) {
+    // 先登记在途再检查运行状态：写线程看到在途为0且已停止后，之后的
+    // 生产者必然看到已停止，不再访问队列
+    m_inFlight.fetch_add(1);
+    struct InFlightGuard {
+      std::atomic<int>& count;
+      ~InFlightGuard() { count.fetch_sub(1); }
+    } guard{m_inFlight};
+    if (!m_running.load()) return false;
+
+    if (m_ring->tryPush(std::move(item))) {
+      const quint64 n = m_enqueued.fetch_add(1) + 1;
+      // 攒满一批时提前唤醒写线程；其余情况依赖刷写间隔
+      if (n % static_cast<quint64>(m_options.batchSize) == 0) {
+        m_wakeCond.wakeOne();
+      }
+      return true;
+    }
+
+    if (m_options.overflowPolicy == OverflowPolicy::DROP ||
+        isWriterThread() || m_stalled.load()) {
+      m_dropped.fetch_add(1);
+      return false;
+    }
+
+    // 写线程取走一批后唤醒等待者；10ms 超时只是兜底，不靠它推进。
+    // 生产者可能持有表锁或事务，等待须有上限
+    m_blockedWaits.fetch_add(1);
+    m_spaceWaiters.fetch_add(1);
+    QElapsedTimer waited;
+    waited.start();
+    QMutexLocker locker(&m_wakeMutex);
+    while (m_running.load()) {
+      m_wakeCond.wakeOne();
+      if (m_ring->tryPush(std::move(item))) {
+        m_spaceWaiters.fetch_sub(1);
+        m_enqueued.fetch_add(1);
+        return true;
+      }
+      if (m_options.blockTimeoutMs >= 0 &&
+          waited.elapsed() >= m_options.blockTimeoutMs) {
+        m_stalled.store(true);
+        break;
+      }
+      m_spaceCond.wait(&m_wakeMutex, 10);
+    }
+    m_spaceWaiters.fetch_sub(1);
+    m_dropped.fetch_add(1);
+    return false;
+  }
+
+  /**
+   * @brief 等待调用前已入队的记录全部处理完毕
+   * @param timeoutMs 最长等待时间（毫秒）
+   * @return 是否在超时前处理完毕
+   */
+  bool flush(int timeoutMs = 5000) {
+    if (!m_running.load() || isWriterThread()) return false;
+    const quint64 target = m_enqueued.load();
+    QMutexLocker locker(&m_wakeMutex);
+    QElapsedTimer timer;
+    timer.start();
+    while (m_processed.load() < target) {
+      const qint64 remaining = timeoutMs - timer.elapsed();
+      if (remaining <= 0 || !m_running.load()) return false;
+      m_wakeCond.wakeOne();
+      const qint64 slice = qMin<qint64>(remaining, 50);
+      m_drainedCond.wait(&m_wakeMutex, static_cast<unsigned long>(slice));
+    }
+    return true;
+  }
+
+  /**
+   * @brief 获取运行计数
+   * @return 计数快照
+   */
+  Stats stats() const {
+    Stats s;
+    s.enqueued = m_enqueued.load();
+    s.dropped = m_dropped.load();
+    s.blockedWaits = m_blockedWaits.load();
+    s.written = m_written.load();
+    s.failed = m_failed.load();
+    s.batches = m_batches.load();
+    s.failedBatches = m_failedBatches.load();
+    return s;
+  }
+
+  /**
+   * @brief 队列中待处理的近似记录数
+   * @return 记录数
+   */
+  size_t pendingApprox() const { return m_ring ? m_ring->sizeApprox() : 0; }
+};
+
+#endif  // ASYNC_BATCH_WRITER_H
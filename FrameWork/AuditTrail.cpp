@@ -0,0 +1,216 @@
+﻿// AuditTrail.cpp - 操作审计采集与哈希链实现
+#include "AuditTrail.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QHash>
+#include <QThread>
+
+namespace {
+
+/**
+ * @brief 线程级延迟缓冲
+ * marks 记录每层延迟开始时 pending 与 actions 的长度，用于嵌套作用域的
+ * 局部丢弃
+ */
+struct DeferredBuffer {
+  struct Mark {
+    int pending = 0;
+    int actions = 0;
+  };
+  QVector<AuditRecord> pending;
+  QVector<std::function<void()>> actions;  ///< 提交后执行的动作
+  QVector<Mark> marks;
+};
+
+/// 按数据库区分：一个库的提交不会释放另一个库事务中暂存的记录
+thread_local QHash<const void*, DeferredBuffer> t_deferred;
+thread_local QString t_actor;
+
+constexpr int kStoreRetries = 3;  ///< 刷写失败时的重试次数
+
+}  // namespace
+
+// ============================================================================
+// AuditTrail::DeferredScope实现
+// ============================================================================
+
+AuditTrail::DeferredScope::DeferredScope(const void* scope) : m_scope(scope) {
+  AuditTrail::beginDeferred(m_scope);
+}
+
+AuditTrail::DeferredScope::~DeferredScope() {
+  if (m_active) AuditTrail::discardDeferred(m_scope);
+}
+
+void AuditTrail::DeferredScope::commit() {
+  if (!m_active) return;
+  m_active = false;
+  AuditTrail::commitDeferred(m_scope);
+}
+
+// ============================================================================
+// AuditTrail实现
+// ============================================================================
+
+AuditTrail::~AuditTrail() { stop(); }
+
+AuditTrail* AuditTrail::instance() {
+  static AuditTrail trail;
+  return &trail;
+}
+
+AuditTrail::Options AuditTrail::defaultOptions() {
+  Options options;
+  options.capacity = 16384;
+  options.batchSize = 256;
+  options.flushIntervalMs = 100;
+  options.overflowPolicy = OverflowPolicy::BLOCK;
+  options.retainFailedBatches = true;
+  // 生产者在写入信号中调用，常持有表锁与事务：系统库长时间不可写时
+  // 限时等待后丢弃并记录缺口，不让所有库的写入随之停顿
+  options.blockTimeoutMs = 200;
+  return options;
+}
+
+bool AuditTrail::start(StoreFn store, const QByteArray& lastHash,
+                       const Options& options) {
+  if (m_writer.isRunning()) return false;
+  m_store = std::move(store);
+  m_lastHash = lastHash.isEmpty() ? genesisHash() : lastHash;
+  return m_writer.start(options, [this](QVector<AuditRecord>& batch) {
+    return writeBatch(batch);
+  });
+}
+
+void AuditTrail::stop() {
+  m_writer.stop();
+  m_store = nullptr;
+}
+
+void AuditTrail::capture(const void* scope, const QString& tableName,
+                         AuditAction action, qint64 recordId,
+                         const QString& details) {
+  if (!m_writer.isRunning()) return;
+
+  AuditRecord record;
+  record.timestampMs = QDateTime::currentMSecsSinceEpoch();
+  record.tableName = tableName;
+  record.action = action;
+  record.recordId = recordId;
+  record.actor = t_actor;
+  record.details = details;
+  record.threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+
+  auto it = t_deferred.find(scope);
+  if (it != t_deferred.end()) {
+    it->pending.append(std::move(record));
+    return;
+  }
+  enqueue(std::move(record));
+}
+
+void AuditTrail::enqueue(AuditRecord&& record) {
+  if (m_writer.push(std::move(record))) {
+    if (m_gapDropped.load() > 0) {
+      const quint64 gap = m_gapDropped.exchange(0);
+      if (gap > 0) {
+        qWarning() << "审计队列恢复，此前丢弃的记录数（审计缺口）:" << gap;
+      }
+    }
+    return;
+  }
+  if (!m_writer.isRunning()) return;
+  if (m_gapDropped.fetch_add(1) == 0) {
+    qWarning() << "审计落盘受阻、队列已满，开始丢弃记录（审计缺口）";
+  }
+}
+
+bool AuditTrail::writeBatch(QVector<AuditRecord>& batch) {
+  if (!m_store) return false;
+
+  // 哈希链按落盘顺序串接；整批失败时回退链尾，写入器把该批留在队首，
+  // 下次连同新记录从同一链尾重算，库内链条因此连续且不缺记录
+  const QByteArray chainTail = m_lastHash;
+  QByteArray prev = chainTail;
+  for (AuditRecord& record : batch) {
+    record.prevHash = prev;
+    record.hash = computeHash(prev, record);
+    prev = record.hash;
+  }
+
+  for (int attempt = 0; attempt < kStoreRetries; ++attempt) {
+    if (m_store(batch)) {
+      m_lastHash = prev;
+      return true;
+    }
+    QThread::msleep(static_cast<unsigned long>(50 * (attempt + 1)));
+  }
+
+  m_lastHash = chainTail;
+  if (m_writer.isRunning()) {
+    qWarning() << "审计记录落盘失败，保留批次待重试:" << batch.size();
+  } else {
+    qWarning() << "审计记录落盘失败，停止时放弃批次:" << batch.size();
+  }
+  return false;
+}
+
+void AuditTrail::beginDeferred(const void* scope) {
+  DeferredBuffer& buffer = t_deferred[scope];
+  buffer.marks.append({buffer.pending.size(), buffer.actions.size()});
+}
+
+void AuditTrail::commitDeferred(const void* scope) {
+  auto it = t_deferred.find(scope);
+  if (it == t_deferred.end()) return;
+  it->marks.removeLast();
+  if (!it->marks.isEmpty()) return;  // 内层提交并入外层
+
+  QVector<AuditRecord> pending;
+  QVector<std::function<void()>> actions;
+  pending.swap(it->pending);
+  actions.swap(it->actions);
+  t_deferred.erase(it);
+  AuditTrail* trail = instance();
+  for (AuditRecord& record : pending) trail->enqueue(std::move(record));
+  for (const auto& action : actions) action();
+}
+
+void AuditTrail::discardDeferred(const void* scope) {
+  auto it = t_deferred.find(scope);
+  if (it == t_deferred.end()) return;
+  const DeferredBuffer::Mark mark = it->marks.takeLast();
+  it->pending.resize(mark.pending);
+  it->actions.resize(mark.actions);
+  if (it->marks.isEmpty()) t_deferred.erase(it);
+}
+
+void AuditTrail::runAfterCommit(const void* scope,
+                                std::function<void()> action) {
+  auto it = t_deferred.find(scope);
+  if (it == t_deferred.end()) {
+    action();
+    return;
+  }
+  it->actions.append(std::move(action));
+}
+
+void AuditTrail::setActor(const QString& actor) { t_actor = actor; }
+
+QByteArray AuditTrail::genesisHash() { return QByteArray(32, '\0'); }
+
+QByteArray AuditTrail::computeHash(const QByteArray& prevHash,
+                                   const AuditRecord& record) {
+  // 固定流版本与字段顺序，保证跨版本可复算
+  QByteArray canonical;
+  QDataStream stream(&canonical, QIODevice::WriteOnly);
+  stream.setVersion(QDataStream::Qt_5_12);
+  stream << prevHash << record.timestampMs << record.tableName
+         << static_cast<qint32>(record.action) << record.recordId
+         << record.actor << record.details
+         << static_cast<quint64>(record.threadId);
+
+  return QCryptographicHash::hash(canonical, QCryptographicHash::Sha256);
+}
@@ -0,0 +1,211 @@
+﻿// AuditTrail.h - 操作审计采集与哈希链
+#ifndef AUDIT_TRAIL_H
+#define AUDIT_TRAIL_H
+
+#include <QByteArray>
+#include <QString>
+#include <atomic>
+
+#include "AsyncBatchWriter.h"
+
+/**
+ * @brief 审计动作
+ */
+enum class AuditAction {
+  INSERT = 1,  ///< 插入
+  UPDATE = 2,  ///< 更新
+  REMOVE = 3   ///< 删除（避开 Windows 头文件中的 DELETE 宏）
+};
+
+/**
+ * @brief 操作审计记录
+ * prevHash/hash 由写线程按落盘顺序计算，构成可校验的哈希链
+ */
+struct AuditRecord {
+  qint64 id = -1;                          ///< 记录ID（落盘后有效）
+  qint64 timestampMs = 0;                  ///< 时间戳（自纪元起毫秒）
+  QString tableName;                       ///< 被修改的表
+  AuditAction action = AuditAction::INSERT;  ///< 动作
+  qint64 recordId = -1;                    ///< 被修改记录的ID
+  QString actor;                           ///< 操作者（线程级设置）
+  QString details;                         ///< 附加说明
+  quint64 threadId = 0;                    ///< 产生记录的线程ID
+  QByteArray prevHash;                     ///< 前一条记录的哈希
+  QByteArray hash;                         ///< 本条记录的哈希
+};
+
+/**
+ * @brief 操作审计采集器（进程级单例）
+ * BaseTableOperations 的写入信号在发出线程上直接调用 capture()；
+ * 记录先进入按数据库区分的线程级延迟缓冲（该库事务提交时释放、回滚时
+ * 丢弃），再经无锁队列由后台线程计算哈希链并批量写入 OPERATION_AUDIT 表；
+ * 落盘失败的批次留在队首重试，不跳过，链条因此保持连续。落盘长时间受阻
+ * 使队列满时，生产者（常持有表锁）最多等待 blockTimeoutMs，之后丢弃并
+ * 计入 Stats::dropped，缺口的开始与恢复各记一条警告。
+ */
+class AuditTrail {
+ public:
+  /// 持久化回调：在写线程中调用，需在一个事务内写完整批记录
+  using StoreFn = std::function<bool(QVector<AuditRecord>&)>;
+  using Options = AsyncBatchWriter<AuditRecord>::Options;
+  using Stats = AsyncBatchWriter<AuditRecord>::Stats;
+
+  /**
+   * @brief 延迟作用域（RAII）
+   * 作用域内该数据库采集的记录在commit()后才入队，未提交即析构则丢弃
+   */
+  class DeferredScope {
+   public:
+    /**
+     * @brief 开始延迟
+     * @param scope 数据库标识（所属管理器主连接的地址）
+     */
+    explicit DeferredScope(const void* scope);
+    ~DeferredScope();
+    DeferredScope(const DeferredScope&) = delete;
+    DeferredScope& operator=(const DeferredScope&) = delete;
+
+    /**
+     * @brief 提交作用域内的审计记录
+     */
+    void commit();
+
+   private:
+    const void* m_scope;
+    bool m_active = true;
+  };
+
+ private:
+  AsyncBatchWriter<AuditRecord> m_writer;
+  StoreFn m_store;
+  QByteArray m_lastHash;                 ///< 链尾哈希（仅写线程访问）
+  std::atomic<quint64> m_gapDropped{0};  ///< 当前缺口内丢弃的记录数
+
+  AuditTrail() = default;
+
+  bool writeBatch(QVector<AuditRecord>& batch);
+
+  /// 入队；队列满而被丢弃时记录缺口
+  void enqueue(AuditRecord&& record);
+
+ public:
+  ~AuditTrail();
+
+  AuditTrail(const AuditTrail&) = delete;
+  AuditTrail& operator=(const AuditTrail&) = delete;
+
+  /**
+   * @brief 获取单例
+   * @return 采集器指针
+   */
+  static AuditTrail* instance();
+
+  /**
+   * @brief 启动后台写线程
+   * @param store 持久化回调
+   * @param lastHash 已落盘链尾的哈希（空表传空）
+   * @param options 队列与批次参数（默认队列满时限时阻塞，超时丢弃）
+   * @return 是否启动（已运行时返回false）
+   */
+  bool start(StoreFn store, const QByteArray& lastHash,
+             const Options& options = defaultOptions());
+
+  /**
+   * @brief 停止后台写线程，退出前写完队列中的记录
+   */
+  void stop();
+
+  /**
+   * @brief 是否正在运行
+   * @return 是否运行
+   */
+  bool isRunning() const { return m_writer.isRunning(); }
+
+  /**
+   * @brief 采集一条审计记录（仅拷贝参数）
+   * @param scope 数据库标识（所属管理器主连接的地址）
+   * @param tableName 表名
+   * @param action 动作
+   * @param recordId 记录ID
+   * @param details 附加说明
+   */
+  void capture(const void* scope, const QString& tableName, AuditAction action,
+               qint64 recordId, const QString& details = QString());
+
+  /**
+   * @brief 等待已入队记录全部落盘
+   * @param timeoutMs 最长等待时间（毫秒）
+   * @return 是否在超时前落盘
+   */
+  bool flush(int timeoutMs = 5000) { return m_writer.flush(timeoutMs); }
+
+  /**
+   * @brief 获取运行计数
+   * @return 计数快照
+   */
+  Stats stats() const { return m_writer.stats(); }
+
+  // ========================================================================
+  // 线程级延迟缓冲（按数据库区分，与该库的线程事务一一对应，可嵌套）
+  // ========================================================================
+
+  /**
+   * @brief 开始延迟：之后本线程在该数据库采集的记录暂存
+   * @param scope 数据库标识（所属管理器主连接的地址）
+   */
+  static void beginDeferred(const void* scope);
+
+  /**
+   * @brief 提交延迟：该数据库最外层提交时把其暂存记录入队
+   * @param scope 数据库标识
+   */
+  static void commitDeferred(const void* scope);
+
+  /**
+   * @brief 丢弃延迟：丢弃该数据库本层开始后暂存的记录
+   * @param scope 数据库标识
+   */
+  static void discardDeferred(const void* scope);
+
+  /**
+   * @brief 在该数据库的延迟提交后执行动作
+   * 本线程在该库有未结束的延迟时，动作排在最外层提交、记录入队之后执行，
+   * 丢弃时一并丢弃；否则立即执行（写入已自动提交）
+   * @param scope 数据库标识
+   * @param action 动作
+   */
+  static void runAfterCommit(const void* scope, std::function<void()> action);
+
+  /**
+   * @brief 设置当前线程的操作者标识
+   * @param actor 操作者
+   */
+  static void setActor(const QString& actor);
+
+  // ========================================================================
+  // 哈希链
+  // ========================================================================
+
+  /**
+   * @brief 链首哈希（全零）
+   * @return 哈希值
+   */
+  static QByteArray genesisHash();
+
+  /**
+   * @brief 计算记录哈希：SHA-256(prevHash || 规范化字段)
+   * @param prevHash 前一条记录的哈希
+   * @param record 审计记录（不含id与哈希字段）
+   * @return 哈希值
+   */
+  static QByteArray computeHash(const QByteArray& prevHash,
+                                const AuditRecord& record);
+
+  /**
+   * @brief 默认参数
+   * @return 队列满时阻塞、失败批次保留重试的参数
+   */
+  static Options defaultOptions();
+};
+
+#endif  // AUDIT_TRAIL_H
@@ -0,0 +1,273 @@
+﻿// ChangeFeed.cpp - 数据库变更捕获（CDC）流实现
+#include "ChangeFeed.h"
+
+#include <QDateTime>
+#include <QDebug>
+
+#include "SqliteNative.h"
+
+/**
+ * @brief 单条连接的钩子上下文
+ * pending 为当前事务内的行变更；提交钩子把它移入 committed，待连接归还
+ * 时由 dispatch() 发布。提交钩子在提交落定前调用，unsettledFrom 记下
+ * 尚未确认落定的第一项，提交失败回滚时只作废这部分。钩子与 dispatch()
+ * 总在持有该连接的线程中调用，暂存区无需加锁
+ */
+struct ChangeFeed::ConnectionCapture {
+  ChangeFeed* feed = nullptr;
+  void* handle = nullptr;  ///< sqlite3 句柄
+  QVector<ChangeEvent> pending;
+  QVector<QVector<ChangeEvent>> committed;  ///< 已提交、尚未发布的事务
+  int unsettledFrom = -1;  ///< committed 中未确认落定的起始下标（-1为无）
+};
+
+ChangeFeed::ChangeFeed(const QString& name) : m_name(name) {}
+
+ChangeFeed::~ChangeFeed() {
+  QHash<quint64, std::shared_ptr<Subscriber>> subscribers;
+  {
+    QMutexLocker locker(&m_subscribersMutex);
+    subscribers.swap(m_subscribers);
+  }
+  for (const auto& s : subscribers) s->writer.stop();
+}
+
+bool ChangeFeed::nativeHooksAvailable() {
+#ifdef DB_SQLITE_NATIVE
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool ChangeFeed::attach(const QSqlDatabase& db) {
+#ifdef DB_SQLITE_NATIVE
+  sqlite3* handle = SqliteNative::handle(db);
+  if (!handle) {
+    qWarning() << "变更捕获: 无法取得sqlite3句柄" << db.connectionName();
+    return false;
+  }
+
+  auto capture = std::make_shared<ConnectionCapture>();
+  capture->feed = this;
+  capture->handle = handle;
+
+  sqlite3_update_hook(
+      handle,
+      [](void* ctx, int op, const char*, const char* table,
+         sqlite3_int64 rowid) {
+        auto* c = static_cast<ConnectionCapture*>(ctx);
+        // 自动提交的语句说明此前没有未结束的事务，之前的提交均已落定
+        if (sqlite3_get_autocommit(static_cast<sqlite3*>(c->handle))) {
+          c->unsettledFrom = -1;
+        }
+        ChangeEvent e;
+        e.table = QString::fromUtf8(table);
+        e.op = op == SQLITE_INSERT   ? ChangeOp::INSERT
+               : op == SQLITE_UPDATE ? ChangeOp::UPDATE
+                                     : ChangeOp::REMOVE;
+        e.rowid = rowid;
+        c->pending.append(std::move(e));
+      },
+      capture.get());
+
+  // 提交钩子在写锁内、提交落定前调用，只暂存不发布（发布可能因背压
+  // 阻塞）；返回0表示允许提交
+  sqlite3_commit_hook(
+      handle,
+      [](void* ctx) -> int {
+        auto* c = static_cast<ConnectionCapture*>(ctx);
+        if (!c->pending.isEmpty()) {
+          if (c->unsettledFrom < 0) c->unsettledFrom = c->committed.size();
+          c->committed.append(QVector<ChangeEvent>());
+          c->committed.last().swap(c->pending);
+        }
+        return 0;
+      },
+      capture.get());
+
+  // 提交失败被回滚时，只作废该事务移入 committed 的变更；此前已落定、
+  // 尚未发布的事务保留
+  sqlite3_rollback_hook(
+      handle,
+      [](void* ctx) {
+        auto* c = static_cast<ConnectionCapture*>(ctx);
+        c->pending.clear();
+        if (c->unsettledFrom >= 0) {
+          c->committed.resize(c->unsettledFrom);
+          c->unsettledFrom = -1;
+        }
+      },
+      capture.get());
+
+  QMutexLocker locker(&m_captureMutex);
+  m_captures.insert(db.connectionName(), std::move(capture));
+  return true;
+#else
+  Q_UNUSED(db);
+  return false;
+#endif
+}
+
+void ChangeFeed::detach(const QString& connection) {
+#ifdef DB_SQLITE_NATIVE
+  std::shared_ptr<ConnectionCapture> capture;
+  {
+    QMutexLocker locker(&m_captureMutex);
+    capture = m_captures.take(connection);
+  }
+  if (!capture) return;
+  auto* handle = static_cast<sqlite3*>(capture->handle);
+  sqlite3_update_hook(handle, nullptr, nullptr);
+  sqlite3_commit_hook(handle, nullptr, nullptr);
+  sqlite3_rollback_hook(handle, nullptr, nullptr);
+#else
+  Q_UNUSED(connection);
+#endif
+}
+
+void ChangeFeed::dispatch(const QString& connection) {
+#ifdef DB_SQLITE_NATIVE
+  std::shared_ptr<ConnectionCapture> capture;
+  {
+    QMutexLocker locker(&m_captureMutex);
+    capture = m_captures.value(connection);
+  }
+  if (!capture || capture->committed.isEmpty()) return;
+  // 仍在事务中说明提交没有落定（如返回忙），等事务真正结束再发布
+  if (!sqlite3_get_autocommit(static_cast<sqlite3*>(capture->handle))) return;
+
+  QVector<QVector<ChangeEvent>> committed;
+  committed.swap(capture->committed);
+  capture->unsettledFrom = -1;
+  for (QVector<ChangeEvent>& changes : committed) publish(std::move(changes));
+#else
+  Q_UNUSED(connection);
+#endif
+}
+
+void ChangeFeed::stageReset(const QSqlDatabase& db, const QString& table) {
+#ifdef DB_SQLITE_NATIVE
+  std::shared_ptr<ConnectionCapture> capture;
+  {
+    QMutexLocker locker(&m_captureMutex);
+    capture = m_captures.value(db.connectionName());
+  }
+  if (!capture) return;
+  ChangeEvent e;
+  e.table = table;
+  e.op = ChangeOp::RESET;
+  // 事务内随事务提交或回滚；自动提交的语句已落定，作为单独事务待发布
+  if (!sqlite3_get_autocommit(static_cast<sqlite3*>(capture->handle))) {
+    capture->pending.append(std::move(e));
+  } else {
+    capture->unsettledFrom = -1;
+    capture->committed.append({e});
+  }
+#else
+  Q_UNUSED(db);
+  Q_UNUSED(table);
+#endif
+}
+
+void ChangeFeed::publish(QVector<ChangeEvent> changes) {
+  if (changes.isEmpty()) return;
+
+  QMutexLocker publishLocker(&m_publishMutex);
+
+  ChangeTransaction tx;
+  tx.sequence = m_sequence.fetch_add(1) + 1;
+  tx.committedAtMs = QDateTime::currentMSecsSinceEpoch();
+  tx.changes = std::move(changes);
+  m_changeCount.fetch_add(static_cast<quint64>(tx.changes.size()));
+
+  QList<std::shared_ptr<Subscriber>> targets;
+  {
+    QMutexLocker locker(&m_subscribersMutex);
+    targets = m_subscribers.values();
+  }
+
+  // 阻塞策略的订阅队列满时在此等待，发布锁保证等待期间顺序不乱
+  for (const auto& s : targets) {
+    if (s->tables.isEmpty()) {
+      ChangeTransaction copy = tx;
+      s->writer.push(std::move(copy));
+      continue;
+    }
+
+    ChangeTransaction filtered;
+    filtered.sequence = tx.sequence;
+    filtered.committedAtMs = tx.committedAtMs;
+    for (const ChangeEvent& e : tx.changes) {
+      if (s->tables.contains(e.table)) filtered.changes.append(e);
+    }
+    if (!filtered.changes.isEmpty()) s->writer.push(std::move(filtered));
+  }
+}
+
+void ChangeFeed::publishRow(const QString& table, ChangeOp op, qint64 rowid) {
+  ChangeEvent e;
+  e.table = table;
+  e.op = op;
+  e.rowid = rowid;
+  publish({e});
+}
+
+quint64 ChangeFeed::subscribe(Handler handler,
+                              const SubscribeOptions& options) {
+  auto s = std::make_shared<Subscriber>();
+  s->tables = options.tables;
+
+  AsyncBatchWriter<ChangeTransaction>::Options writerOptions;
+  writerOptions.capacity = options.capacity;
+  writerOptions.batchSize = options.batchSize;
+  writerOptions.flushIntervalMs = options.flushIntervalMs;
+  writerOptions.overflowPolicy = options.overflowPolicy;
+  s->writer.start(writerOptions, std::move(handler));
+
+  QMutexLocker locker(&m_subscribersMutex);
+  const quint64 id = m_nextSubscriberId++;
+  m_subscribers.insert(id, std::move(s));
+  return id;
+}
+
+void ChangeFeed::unsubscribe(quint64 id) {
+  std::shared_ptr<Subscriber> s;
+  {
+    QMutexLocker locker(&m_subscribersMutex);
+    s = m_subscribers.take(id);
+  }
+  if (s) s->writer.stop();
+}
+
+bool ChangeFeed::flush(quint64 id, int timeoutMs) {
+  std::shared_ptr<Subscriber> s;
+  {
+    QMutexLocker locker(&m_subscribersMutex);
+    s = m_subscribers.value(id);
+  }
+  return s ? s->writer.flush(timeoutMs) : false;
+}
+
+AsyncBatchWriter<ChangeTransaction>::Stats ChangeFeed::subscriptionStats(
+    quint64 id) const {
+  QMutexLocker locker(&m_subscribersMutex);
+  const auto s = m_subscribers.value(id);
+  return s ? s->writer.stats() : AsyncBatchWriter<ChangeTransaction>::Stats();
+}
+
+ChangeFeed::Stats ChangeFeed::stats() const {
+  Stats st;
+  st.lastSequence = m_sequence.load();
+  st.transactions = st.lastSequence;
+  st.changes = m_changeCount.load();
+  {
+    QMutexLocker locker(&m_subscribersMutex);
+    st.subscribers = m_subscribers.size();
+  }
+  {
+    QMutexLocker locker(&m_captureMutex);
+    st.attachedConnections = m_captures.size();
+  }
+  return st;
+}
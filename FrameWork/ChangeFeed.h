@@ -0,0 +1,217 @@
+﻿// ChangeFeed.h - 数据库变更捕获（CDC）流
+#ifndef CHANGE_FEED_H
+#define CHANGE_FEED_H
+
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QSqlDatabase>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include "AsyncBatchWriter.h"
+
+/**
+ * @brief 变更类型
+ */
+enum class ChangeOp {
+  INSERT = 0,  ///< 插入
+  UPDATE = 1,  ///< 更新
+  REMOVE = 2,  ///< 删除（避开 Windows 的 DELETE 宏）
+  RESET = 3    ///< 整表变化（清空表等无法逐行报告的操作）
+};
+
+/**
+ * @brief 单行变更
+ */
+struct ChangeEvent {
+  QString table;                   ///< 表名
+  ChangeOp op = ChangeOp::INSERT;  ///< 变更类型
+  qint64 rowid = 0;                ///< 行ID（RESET时为0）
+};
+
+/**
+ * @brief 一个已提交事务内的全部变更
+ */
+struct ChangeTransaction {
+  quint64 sequence = 0;          ///< 库内单调递增的发布序号（从1开始）
+  qint64 committedAtMs = 0;      ///< 提交时间（自纪元起毫秒）
+  QVector<ChangeEvent> changes;  ///< 按发生顺序排列的变更
+};
+
+/**
+ * @brief 变更捕获流
+ * 每个数据库一个实例。以 sqlite_native 构建时，连接池中每条连接都装上
+ * sqlite3 的更新/提交/回滚钩子：更新钩子把行变更暂存在连接上，提交钩子
+ * 在写锁内只把整组变更标为已提交，回滚钩子丢弃暂存。连接归还连接池时
+ * （提交已落定、写锁已释放）由 dispatch() 把已提交的事务发布出去，背压
+ * 因此只阻塞发布线程，不会卡住持有写锁的提交。原始SQL、触发器造成的
+ * 变更同样可见；序号按发布顺序分配，同一连接上的事务保持提交顺序。
+ *
+ * 未以 sqlite_native 构建时退化为表操作类的写入信号：只覆盖经由表类
+ * 的写入，每行变更随框架的事务边界（线程事务与表类的批量事务）在提交后
+ * 发布为单独事务，回滚则丢弃。
+ *
+ * 订阅者各自拥有一条有界队列与消费线程（AsyncBatchWriter），按批收到
+ * 事务；队列满时按订阅参数丢弃或阻塞提交线程（背压）。
+ * 变更只携带rowid，消费者应按需重读行；保存点回滚的变更可能多报。
+ */
+class ChangeFeed {
+ public:
+  /// 订阅回调：在该订阅的消费线程中调用，返回是否处理成功
+  using Handler = std::function<bool(QVector<ChangeTransaction>&)>;
+
+  /**
+   * @brief 订阅参数
+   */
+  struct SubscribeOptions {
+    QSet<QString> tables;      ///< 只接收这些表的变更（为空表示全部）
+    int capacity = 4096;       ///< 队列容量（事务数）
+    int batchSize = 256;       ///< 单批最大事务数
+    int flushIntervalMs = 50;  ///< 空闲时最长投递间隔（毫秒）
+    OverflowPolicy overflowPolicy = OverflowPolicy::DROP;  ///< 队列满策略
+  };
+
+  /**
+   * @brief 运行计数
+   */
+  struct Stats {
+    quint64 transactions = 0;     ///< 已发布事务数
+    quint64 changes = 0;          ///< 已发布行变更数
+    quint64 lastSequence = 0;     ///< 最后一个提交序号
+    int attachedConnections = 0;  ///< 已装钩子的连接数
+    int subscribers = 0;          ///< 订阅数
+  };
+
+  explicit ChangeFeed(const QString& name);
+  ~ChangeFeed();
+
+  ChangeFeed(const ChangeFeed&) = delete;
+  ChangeFeed& operator=(const ChangeFeed&) = delete;
+
+  /**
+   * @brief 是否以原生钩子构建
+   * @return 是否可捕获原始SQL与触发器产生的变更
+   */
+  static bool nativeHooksAvailable();
+
+  /**
+   * @brief 在连接上安装钩子（非原生构建时为空操作）
+   * 应在连接打开后、首次写入前调用
+   * @param db 已打开的连接
+   * @return 是否已安装
+   */
+  bool attach(const QSqlDatabase& db);
+
+  /**
+   * @brief 卸下连接上的钩子（关闭连接前调用；非原生构建时为空操作）
+   * @param connection 连接名
+   */
+  void detach(const QString& connection);
+
+  /**
+   * @brief 发布连接上已落定的提交（连接归还时在持有该连接的线程中调用）
+   * 连接仍在事务中时不发布，待事务结束后的下一次调用
+   * @param connection 连接名
+   */
+  void dispatch(const QString& connection);
+
+  /**
+   * @brief 在连接上暂存整表变化（原生构建；随所在事务提交或回滚）
+   * 钩子无法逐行报告的操作（清空表）调用；非原生构建时为空操作
+   * @param db 执行该操作的连接
+   * @param table 表名
+   */
+  void stageReset(const QSqlDatabase& db, const QString& table);
+
+  /**
+   * @brief 发布一个已提交事务（dispatch() 与非原生回退路径调用）
+   * @param changes 变更（为空时忽略）
+   */
+  void publish(QVector<ChangeEvent> changes);
+
+  /**
+   * @brief 发布单行变更（非原生回退路径）
+   */
+  void publishRow(const QString& table, ChangeOp op, qint64 rowid);
+
+  /**
+   * @brief 发布整表变化（清空表等钩子无法逐行报告的操作）
+   * @param table 表名
+   */
+  void publishReset(const QString& table) {
+    publishRow(table, ChangeOp::RESET, 0);
+  }
+
+  /**
+   * @brief 订阅变更
+   * @param handler 回调（在订阅的消费线程中调用）
+   * @param options 订阅参数
+   * @return 订阅ID（>0）
+   */
+  quint64 subscribe(Handler handler, const SubscribeOptions& options);
+  quint64 subscribe(Handler handler) {
+    return subscribe(std::move(handler), SubscribeOptions());
+  }
+
+  /**
+   * @brief 取消订阅（先投递完已入队的事务）
+   * 不得在该订阅自己的回调中调用
+   * @param id 订阅ID
+   */
+  void unsubscribe(quint64 id);
+
+  /**
+   * @brief 等待订阅处理完调用前已发布的事务
+   * @param id 订阅ID
+   * @param timeoutMs 最长等待时间（毫秒）
+   * @return 是否在超时前处理完毕
+   */
+  bool flush(quint64 id, int timeoutMs = 5000);
+
+  /**
+   * @brief 获取订阅的队列计数
+   * @param id 订阅ID
+   * @return 计数快照（订阅不存在时为空）
+   */
+  AsyncBatchWriter<ChangeTransaction>::Stats subscriptionStats(
+      quint64 id) const;
+
+  /**
+   * @brief 获取运行计数
+   * @return 计数快照
+   */
+  Stats stats() const;
+
+  /**
+   * @brief 名称（通常为数据库名）
+   * @return 名称
+   */
+  QString name() const { return m_name; }
+
+ private:
+  struct Subscriber {
+    QSet<QString> tables;
+    AsyncBatchWriter<ChangeTransaction> writer;
+  };
+
+  struct ConnectionCapture;
+
+  QString m_name;
+
+  QMutex m_publishMutex;  ///< 串行化发布，保证各订阅收到同一顺序
+  std::atomic<quint64> m_sequence{0};
+  std::atomic<quint64> m_changeCount{0};
+
+  mutable QMutex m_subscribersMutex;  ///< 保护订阅表
+  QHash<quint64, std::shared_ptr<Subscriber>> m_subscribers;
+  quint64 m_nextSubscriberId = 1;
+
+  mutable QMutex m_captureMutex;  ///< 保护连接钩子上下文
+  QHash<QString, std::shared_ptr<ConnectionCapture>> m_captures;  ///< 按连接名
+};
+
+#endif  // CHANGE_FEED_H
@@ -0,0 +1,156 @@
+﻿// ColumnarResult.cpp - 列式（结构数组）批量查询结果实现
+#include "ColumnarResult.h"
+
+#include <QSqlQuery>
+#include <QVariant>
+
+#include "NativeStatement.h"
+
+ColumnarResult::ColumnarResult(const QVector<ColumnSpec>& columns) {
+  m_columns.reserve(columns.size());
+  for (const ColumnSpec& spec : columns) {
+    Column c;
+    c.spec = spec;
+    if (spec.type == ColumnType::TEXT) c.offsets.append(0);
+    m_columns.append(std::move(c));
+  }
+}
+
+void ColumnarResult::reserve(int rows) {
+  for (Column& c : m_columns) {
+    switch (c.spec.type) {
+      case ColumnType::INTEGER:
+      case ColumnType::DATETIME:
+        c.ints.reserve(rows);
+        break;
+      case ColumnType::REAL:
+        c.reals.reserve(rows);
+        break;
+      case ColumnType::TEXT:
+        c.offsets.reserve(rows + 1);
+        break;
+    }
+  }
+}
+
+void ColumnarResult::setNull(Column& column, int row) {
+  const int word = row / 64;
+  if (column.nulls.size() <= word) column.nulls.resize(word + 1);
+  column.nulls[word] |= quint64(1) << (row % 64);
+}
+
+void ColumnarResult::appendRow(const QSqlQuery& query) {
+  const int row = m_rowCount;
+  for (int i = 0; i < m_columns.size(); ++i) {
+    Column& c = m_columns[i];
+    const QVariant v = query.value(i);
+    const bool null = v.isNull();
+    if (null) setNull(c, row);
+
+    switch (c.spec.type) {
+      case ColumnType::INTEGER:
+        c.ints.append(null ? 0 : v.toLongLong());
+        break;
+      case ColumnType::REAL:
+        c.reals.append(null ? 0.0 : v.toDouble());
+        break;
+      case ColumnType::DATETIME:
+        c.ints.append(null ? 0 : v.toDateTime().toMSecsSinceEpoch());
+        break;
+      case ColumnType::TEXT:
+        if (!null) c.arena.append(v.toString());
+        c.offsets.append(c.arena.size());
+        break;
+    }
+  }
+  ++m_rowCount;
+}
+
+void ColumnarResult::appendRow(const NativeStatement& stmt) {
+  const int row = m_rowCount;
+  for (int i = 0; i < m_columns.size(); ++i) {
+    Column& c = m_columns[i];
+    const bool null = stmt.columnIsNull(i);
+    if (null) setNull(c, row);
+
+    switch (c.spec.type) {
+      case ColumnType::INTEGER:
+        c.ints.append(null ? 0 : stmt.columnInt64(i));
+        break;
+      case ColumnType::REAL:
+        c.reals.append(null ? 0.0 : stmt.columnDouble(i));
+        break;
+      case ColumnType::DATETIME:
+        c.ints.append(null ? 0 : stmt.columnDateTime(i).toMSecsSinceEpoch());
+        break;
+      case ColumnType::TEXT:
+        if (!null) c.arena.append(stmt.columnText(i));
+        c.offsets.append(c.arena.size());
+        break;
+    }
+  }
+  ++m_rowCount;
+}
+
+int ColumnarResult::appendAll(QSqlQuery& query) {
+  int n = 0;
+  while (query.next()) {
+    appendRow(query);
+    ++n;
+  }
+  return n;
+}
+
+void ColumnarResult::squeeze() {
+  for (Column& c : m_columns) {
+    c.ints.squeeze();
+    c.reals.squeeze();
+    c.arena.squeeze();
+    c.offsets.squeeze();
+    c.nulls.squeeze();
+  }
+}
+
+int ColumnarResult::columnIndex(const QString& name) const {
+  for (int i = 0; i < m_columns.size(); ++i) {
+    if (m_columns[i].spec.name == name) return i;
+  }
+  return -1;
+}
+
+bool ColumnarResult::isNull(int col, int row) const {
+  const QVector<quint64>& nulls = m_columns[col].nulls;
+  const int word = row / 64;
+  return word < nulls.size() && (nulls[word] >> (row % 64)) & 1;
+}
+
+qint64 ColumnarResult::integer(int col, int row) const {
+  return m_columns[col].ints[row];
+}
+
+double ColumnarResult::real(int col, int row) const {
+  return m_columns[col].reals[row];
+}
+
+QStringView ColumnarResult::text(int col, int row) const {
+  const Column& c = m_columns[col];
+  const int begin = c.offsets[row];
+  return QStringView(c.arena).mid(begin, c.offsets[row + 1] - begin);
+}
+
+QDateTime ColumnarResult::dateTime(int col, int row) const {
+  if (isNull(col, row)) return QDateTime();
+  return QDateTime::fromMSecsSinceEpoch(m_columns[col].ints[row]);
+}
+
+qint64 ColumnarResult::memoryBytes() const {
+  qint64 bytes = 0;
+  for (const Column& c : m_columns) {
+    bytes += qint64(c.ints.capacity()) * sizeof(qint64);
+    bytes += qint64(c.reals.capacity()) * sizeof(double);
+    bytes += qint64(c.arena.capacity()) * sizeof(QChar);
+    bytes += qint64(c.offsets.capacity()) * sizeof(int);
+    bytes += qint64(c.nulls.capacity()) * sizeof(quint64);
+  }
+  return bytes;
+}
@@ -0,0 +1,200 @@
+﻿// ColumnarResult.h - 列式（结构数组）批量查询结果
+#ifndef COLUMNAR_RESULT_H
+#define COLUMNAR_RESULT_H
+
+#include <QDateTime>
+#include <QString>
+#include <QStringView>
+#include <QVector>
+
+class NativeStatement;
+class QSqlQuery;
+
+/**
+ * @brief 列存储类型
+ */
+enum class ColumnType {
+  INTEGER = 0,  ///< 整数，存为 qint64 数组
+  REAL = 1,     ///< 浮点，存为 double 数组
+  TEXT = 2,     ///< 文本，存入单块字符区并以偏移表定位
+  DATETIME = 3  ///< 时间，存为自纪元起毫秒的 qint64 数组
+};
+
+/**
+ * @brief 列定义
+ */
+struct ColumnSpec {
+  QString name;                        ///< 列名
+  ColumnType type = ColumnType::TEXT;  ///< 存储类型
+};
+
+/**
+ * @brief 列式批量查询结果
+ * 大结果集（全表扫描、导出）的替代结果类型：每列连续存放，整数与时间
+ * 为平坦数组，同列全部文本拼在一块 UTF-16 字符区中、按偏移表切分，
+ * 不再为每行分配实体对象及其中的 QString/QDateTime。
+ * 按列顺序扫描时内存连续，适合统计与导出；需要逐行访问时用 RowView，
+ * 其文本以 QStringView 直接指向字符区，不产生拷贝。
+ *
+ * 结果构建完成后只读，可在线程间共享（隐式共享，复制代价低）。
+ * RowView 与 QStringView 引用结果内部存储，不得超出结果的生命周期。
+ */
+class ColumnarResult {
+ public:
+  /**
+   * @brief 行视图（不拥有数据）
+   */
+  class RowView {
+   public:
+    RowView(const ColumnarResult* result, int row)
+        : m_result(result), m_row(row) {}
+
+    int row() const { return m_row; }
+    bool isNull(int col) const { return m_result->isNull(col, m_row); }
+    qint64 integer(int col) const { return m_result->integer(col, m_row); }
+    double real(int col) const { return m_result->real(col, m_row); }
+    QStringView text(int col) const { return m_result->text(col, m_row); }
+    QDateTime dateTime(int col) const {
+      return m_result->dateTime(col, m_row);
+    }
+
+   private:
+    const ColumnarResult* m_result;
+    int m_row;
+  };
+
+  /**
+   * @brief 行迭代器（支持范围for）
+   */
+  class const_iterator {
+   public:
+    const_iterator(const ColumnarResult* result, int row)
+        : m_result(result), m_row(row) {}
+    RowView operator*() const { return RowView(m_result, m_row); }
+    const_iterator& operator++() {
+      ++m_row;
+      return *this;
+    }
+    bool operator!=(const const_iterator& other) const {
+      return m_row != other.m_row;
+    }
+
+   private:
+    const ColumnarResult* m_result;
+    int m_row;
+  };
+
+  ColumnarResult() = default;
+
+  /**
+   * @brief 构造函数
+   * @param columns 列定义（顺序须与查询的结果列一致）
+   */
+  explicit ColumnarResult(const QVector<ColumnSpec>& columns);
+
+  /**
+   * @brief 预留行容量（整数、时间等定长列）
+   * @param rows 预计行数
+   */
+  void reserve(int rows);
+
+  /**
+   * @brief 把查询当前行追加为一行
+   * @param query 已定位到有效行的查询
+   */
+  void appendRow(const QSqlQuery& query);
+
+  /**
+   * @brief 把原生语句当前行追加为一行（取值规则同上）
+   * @param stmt 已取到一行的原生语句
+   */
+  void appendRow(const NativeStatement& stmt);
+
+  /**
+   * @brief 读取查询余下的全部行
+   * @param query 已执行的查询（宜设为只前向）
+   * @return 读取的行数
+   */
+  int appendAll(QSqlQuery& query);
+
+  /**
+   * @brief 释放多余容量（构建完成后调用）
+   */
+  void squeeze();
+
+  int rowCount() const { return m_rowCount; }
+  int columnCount() const { return m_columns.size(); }
+  bool isEmpty() const { return m_rowCount == 0; }
+
+  /**
+   * @brief 列定义
+   * @param col 列号
+   * @return 列定义
+   */
+  const ColumnSpec& column(int col) const { return m_columns[col].spec; }
+
+  /**
+   * @brief 按列名查找列号
+   * @param name 列名
+   * @return 列号（不存在时为-1）
+   */
+  int columnIndex(const QString& name) const;
+
+  RowView row(int i) const { return RowView(this, i); }
+  RowView operator[](int i) const { return row(i); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, m_rowCount); }
+
+  // ========================================================================
+  // 单元访问
+  // ========================================================================
+
+  bool isNull(int col, int row) const;
+  qint64 integer(int col, int row) const;
+  double real(int col, int row) const;
+  QStringView text(int col, int row) const;
+  QDateTime dateTime(int col, int row) const;
+
+  // ========================================================================
+  // 整列访问（按列扫描）
+  // ========================================================================
+
+  /**
+   * @brief 整数列或时间列（毫秒）的连续数组
+   * @param col 列号
+   * @return 列数组（空值处为0）
+   */
+  const QVector<qint64>& integers(int col) const {
+    return m_columns[col].ints;
+  }
+
+  /**
+   * @brief 浮点列的连续数组
+   * @param col 列号
+   * @return 列数组（空值处为0）
+   */
+  const QVector<double>& reals(int col) const { return m_columns[col].reals; }
+
+  /**
+   * @brief 结果占用的堆内存估计（按容量计算）
+   * @return 字节数
+   */
+  qint64 memoryBytes() const;
+
+ private:
+  struct Column {
+    ColumnSpec spec;
+    QVector<qint64> ints;    ///< INTEGER 与 DATETIME 列
+    QVector<double> reals;   ///< REAL 列
+    QString arena;           ///< TEXT 列的字符区
+    QVector<int> offsets;    ///< TEXT 列第i行的起点，末尾多一项终点
+    QVector<quint64> nulls;  ///< 空值位图（出现首个空值时才分配）
+  };
+
+  void setNull(Column& column, int row);
+
+  QVector<Column> m_columns;
+  int m_rowCount = 0;
+};
+
+#endif  // COLUMNAR_RESULT_H
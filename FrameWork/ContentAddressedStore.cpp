@@ -0,0 +1,308 @@
+﻿// ContentAddressedStore.cpp - 内容寻址文件存储实现
+#include "ContentAddressedStore.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief 简单并行循环：线程按原子游标领取下标，适合耗时不均的文件任务
+ */
+template <typename Fn>
+void parallelFor(int count, int threads, Fn fn) {
+  if (count <= 0) return;
+  if (threads <= 0) threads = QThread::idealThreadCount();
+  threads = qBound(1, threads, count);
+
+  std::atomic<int> next{0};
+  auto worker = [&]() {
+    for (int i = next.fetch_add(1); i < count; i = next.fetch_add(1)) fn(i);
+  };
+
+  std::vector<std::thread> pool;
+  pool.reserve(static_cast<size_t>(threads - 1));
+  for (int t = 1; t < threads; ++t) pool.emplace_back(worker);
+  worker();  // 调用线程也参与
+  for (std::thread& th : pool) th.join();
+}
+
+}  // namespace
+
+// ============================================================================
+// ContentWriter实现
+// ============================================================================
+
+ContentWriter::ContentWriter(const ContentAddressedStore* store)
+    : m_store(store),
+      m_temp(std::make_unique<QTemporaryFile>(store->tempDir() +
+                                              "/XXXXXX.part")),
+      m_hash(std::make_unique<QCryptographicHash>(QCryptographicHash::Sha256)) {
+  if (!m_temp->open()) {
+    m_error = QString("创建临时文件失败: %1").arg(m_temp->errorString());
+    m_temp.reset();
+  }
+}
+
+bool ContentWriter::write(const char* data, qint64 size) {
+  if (!m_temp) {
+    if (m_error.isEmpty()) m_error = "写入器已提交或已放弃";
+    return false;
+  }
+  if (size <= 0) return true;
+
+  if (m_temp->write(data, size) != size) {
+    m_error = QString("写入临时文件失败: %1").arg(m_temp->errorString());
+    return false;
+  }
+  m_hash->addData(data, static_cast<int>(size));
+  m_written += size;
+  return true;
+}
+
+QString ContentWriter::commit(bool* existed) {
+  if (existed) *existed = false;
+  if (!m_temp) {
+    if (m_error.isEmpty()) m_error = "写入器已提交或已放弃";
+    return QString();
+  }
+
+  const QString digest = QString::fromLatin1(m_hash->result().toHex());
+  const QString target = m_store->pathFor(digest);
+  QDir().mkpath(QFileInfo(target).absolutePath());
+
+  // 已有同内容对象：丢弃临时文件即完成去重
+  if (QFile::exists(target)) {
+    if (existed) *existed = true;
+    m_temp.reset();
+    return digest;
+  }
+
+  if (!m_temp->flush()) {
+    m_error = QString("刷新临时文件失败: %1").arg(m_temp->errorString());
+    m_temp.reset();
+    return QString();
+  }
+  m_temp->close();
+
+  if (m_temp->rename(target)) {
+    m_temp->setAutoRemove(false);
+    m_temp.reset();
+    return digest;
+  }
+
+  // 并发写入同一内容时对方先完成改名
+  if (QFile::exists(target)) {
+    if (existed) *existed = true;
+    m_temp.reset();
+    return digest;
+  }
+
+  m_error = QString("对象入库失败: %1").arg(m_temp->errorString());
+  m_temp.reset();
+  return QString();
+}
+
+void ContentWriter::abort() {
+  m_temp.reset();  // QTemporaryFile 析构时删除临时文件
+  m_error = "写入已放弃";
+}
+
+// ============================================================================
+// ContentAddressedStore实现
+// ============================================================================
+
+ContentAddressedStore::ContentAddressedStore(const QString& rootDir)
+    : m_root(QDir(rootDir).absolutePath()) {}
+
+bool ContentAddressedStore::open() {
+  QDir root(m_root);
+  if (!root.mkpath("objects") || !root.mkpath("tmp")) {
+    qCritical() << "创建内容存储目录失败:" << m_root;
+    return false;
+  }
+
+  // 清理上次异常退出残留的临时文件
+  QDir tmp(tempDir());
+  const QStringList stale = tmp.entryList({"*.part"}, QDir::Files);
+  for (const QString& name : stale) {
+    tmp.remove(name);
+  }
+  if (!stale.isEmpty()) {
+    qInfo() << "清理内容存储临时文件:" << stale.size();
+  }
+  return true;
+}
+
+QString ContentAddressedStore::tempDir() const { return m_root + "/tmp"; }
+
+QString ContentAddressedStore::pathFor(const QString& digest) const {
+  if (!isValidDigest(digest)) return QString();
+  return QString("%1/objects/%2/%3")
+      .arg(m_root, digest.left(2), digest.mid(2));
+}
+
+bool ContentAddressedStore::contains(const QString& digest) const {
+  const QString path = pathFor(digest);
+  return !path.isEmpty() && QFile::exists(path);
+}
+
+qint64 ContentAddressedStore::sizeOf(const QString& digest) const {
+  const QString path = pathFor(digest);
+  if (path.isEmpty()) return -1;
+  QFileInfo info(path);
+  return info.exists() ? info.size() : -1;
+}
+
+ContentView ContentAddressedStore::view(const QString& digest) const {
+  ContentView view;
+  const QString path = pathFor(digest);
+  if (path.isEmpty()) return view;
+
+  auto file = std::make_shared<QFile>(path);
+  if (!file->open(QIODevice::ReadOnly)) {
+    qWarning() << "打开内容对象失败:" << digest << file->errorString();
+    return view;
+  }
+
+  view.m_digest = digest;
+  view.m_size = file->size();
+  if (view.m_size > 0) {
+    view.m_data = file->map(0, view.m_size);
+    if (!view.m_data) {
+      qWarning() << "映射内容对象失败:" << digest << file->errorString();
+      return ContentView();
+    }
+  }
+  view.m_file = std::move(file);  // 映射随最后一个视图拷贝释放
+  view.m_valid = true;
+  return view;
+}
+
+QString ContentAddressedStore::put(const QByteArray& data,
+                                   bool* existed) const {
+  ContentWriter w = writer();
+  if (!w.write(data)) {
+    qWarning() << "写入内容失败:" << w.errorString();
+    return QString();
+  }
+  const QString digest = w.commit(existed);
+  if (digest.isEmpty()) qWarning() << "写入内容失败:" << w.errorString();
+  return digest;
+}
+
+QString ContentAddressedStore::putFile(const QString& filePath, bool* existed,
+                                       QString* error) const {
+  QFile source(filePath);
+  if (!source.open(QIODevice::ReadOnly)) {
+    if (error) *error = QString("打开文件失败: %1").arg(source.errorString());
+    return QString();
+  }
+
+  ContentWriter w = writer();
+  QByteArray buffer(static_cast<int>(kChunkSize), Qt::Uninitialized);
+  while (!source.atEnd()) {
+    const qint64 n = source.read(buffer.data(), buffer.size());
+    if (n < 0) {
+      if (error) *error = QString("读取文件失败: %1").arg(source.errorString());
+      return QString();
+    }
+    if (!w.write(buffer.constData(), n)) {
+      if (error) *error = w.errorString();
+      return QString();
+    }
+  }
+
+  const QString digest = w.commit(existed);
+  if (digest.isEmpty() && error) *error = w.errorString();
+  return digest;
+}
+
+QVector<FileDigest> ContentAddressedStore::putFiles(
+    const QStringList& filePaths, int threads) const {
+  QVector<FileDigest> results(filePaths.size());
+  parallelFor(filePaths.size(), threads, [&](int i) {
+    FileDigest& r = results[i];
+    r.path = filePaths.at(i);
+    r.digest = putFile(r.path, nullptr, &r.error);
+    if (!r.digest.isEmpty()) r.size = sizeOf(r.digest);
+  });
+  return results;
+}
+
+FileDigest ContentAddressedStore::hashFile(const QString& filePath) {
+  FileDigest r;
+  r.path = filePath;
+
+  QFile file(filePath);
+  if (!file.open(QIODevice::ReadOnly)) {
+    r.error = QString("打开文件失败: %1").arg(file.errorString());
+    return r;
+  }
+
+  QCryptographicHash hash(QCryptographicHash::Sha256);
+  QByteArray buffer(static_cast<int>(kChunkSize), Qt::Uninitialized);
+  qint64 total = 0;
+  while (!file.atEnd()) {
+    const qint64 n = file.read(buffer.data(), buffer.size());
+    if (n < 0) {
+      r.error = QString("读取文件失败: %1").arg(file.errorString());
+      return r;
+    }
+    hash.addData(buffer.constData(), static_cast<int>(n));
+    total += n;
+  }
+
+  r.digest = QString::fromLatin1(hash.result().toHex());
+  r.size = total;
+  return r;
+}
+
+QVector<FileDigest> ContentAddressedStore::hashFiles(
+    const QStringList& filePaths, int threads) {
+  QVector<FileDigest> results(filePaths.size());
+  parallelFor(filePaths.size(), threads,
+              [&](int i) { results[i] = hashFile(filePaths.at(i)); });
+  return results;
+}
+
+qint64 ContentAddressedStore::modifiedSecs(const QString& digest) const {
+  const QString path = pathFor(digest);
+  if (path.isEmpty()) return -1;
+  QFileInfo info(path);
+  return info.exists() ? info.lastModified().toSecsSinceEpoch() : -1;
+}
+
+bool ContentAddressedStore::remove(const QString& digest) const {
+  const QString path = pathFor(digest);
+  if (path.isEmpty()) return false;
+  return QFile::remove(path) || !QFile::exists(path);
+}
+
+QStringList ContentAddressedStore::digests() const {
+  QStringList result;
+  QDirIterator it(m_root + "/objects", QDir::Files,
+                  QDirIterator::Subdirectories);
+  while (it.hasNext()) {
+    it.next();
+    const QString digest = it.fileInfo().dir().dirName() + it.fileName();
+    if (isValidDigest(digest)) result.append(digest);
+  }
+  return result;
+}
+
+bool ContentAddressedStore::isValidDigest(const QString& digest) {
+  if (digest.size() != 64) return false;
+  for (const QChar c : digest) {
+    const ushort u = c.unicode();
+    if (!((u >= '0' && u <= '9') || (u >= 'a' && u <= 'f'))) return false;
+  }
+  return true;
+}
@@ -0,0 +1,274 @@
+﻿// ContentAddressedStore.h - 内容寻址文件存储
+#ifndef CONTENT_ADDRESSED_STORE_H
+#define CONTENT_ADDRESSED_STORE_H
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QString>
+#include <QStringList>
+#include <QTemporaryFile>
+#include <QVector>
+#include <memory>
+
+class ContentAddressedStore;
+
+/**
+ * @brief 单个文件的摘要结果
+ */
+struct FileDigest {
+  QString path;      ///< 文件路径
+  QString digest;    ///< SHA-256十六进制串（失败时为空）
+  qint64 size = -1;  ///< 文件大小
+  QString error;     ///< 错误描述
+};
+
+/**
+ * @brief 内容只读视图（零拷贝）
+ * 通过 QFile::map 映射对象文件，视图及其拷贝共享同一映射，
+ * 最后一个拷贝析构时解除映射。视图存活期间对象文件不应被删除。
+ */
+class ContentView {
+ public:
+  ContentView() = default;
+
+  /**
+   * @brief 是否有效
+   * @return 映射成功（或空对象）时为true
+   */
+  bool isValid() const { return m_valid; }
+
+  /**
+   * @brief 映射数据首地址
+   * @return 数据指针（空对象返回nullptr）
+   */
+  const uchar* data() const { return m_data; }
+
+  /**
+   * @brief 数据长度
+   * @return 字节数
+   */
+  qint64 size() const { return m_size; }
+
+  /**
+   * @brief 内容摘要
+   * @return SHA-256十六进制串
+   */
+  const QString& digest() const { return m_digest; }
+
+  /**
+   * @brief 以QByteArray形式访问（fromRawData，不拷贝）
+   * 返回值不得比视图活得更久
+   * @return 字节数组视图
+   */
+  QByteArray bytes() const {
+    return QByteArray::fromRawData(reinterpret_cast<const char*>(m_data),
+                                   static_cast<int>(m_size));
+  }
+
+ private:
+  friend class ContentAddressedStore;
+
+  std::shared_ptr<QFile> m_file;  ///< 持有映射的文件
+  const uchar* m_data = nullptr;
+  qint64 m_size = 0;
+  QString m_digest;
+  bool m_valid = false;
+};
+
+/**
+ * @brief 流式内容写入器
+ * 分块写入临时文件并增量计算摘要；commit() 时按摘要原子改名入库，
+ * 内容已存在则丢弃临时文件（去重）。未提交即析构视为放弃。
+ */
+class ContentWriter {
+ public:
+  explicit ContentWriter(const ContentAddressedStore* store);
+  ~ContentWriter() = default;
+
+  ContentWriter(const ContentWriter&) = delete;
+  ContentWriter& operator=(const ContentWriter&) = delete;
+  ContentWriter(ContentWriter&&) = default;
+  ContentWriter& operator=(ContentWriter&&) = default;
+
+  /**
+   * @brief 写入一块数据
+   * @param data 数据指针
+   * @param size 字节数
+   * @return 是否成功
+   */
+  bool write(const char* data, qint64 size);
+  bool write(const QByteArray& chunk) {
+    return write(chunk.constData(), chunk.size());
+  }
+
+  /**
+   * @brief 已写入字节数
+   * @return 字节数
+   */
+  qint64 bytesWritten() const { return m_written; }
+
+  /**
+   * @brief 提交内容
+   * @param existed 输出：内容此前是否已存在
+   * @return 内容摘要，失败返回空串
+   */
+  QString commit(bool* existed = nullptr);
+
+  /**
+   * @brief 放弃写入并删除临时文件
+   */
+  void abort();
+
+  /**
+   * @brief 最近一次错误
+   * @return 错误描述
+   */
+  QString errorString() const { return m_error; }
+
+ private:
+  const ContentAddressedStore* m_store;
+  std::unique_ptr<QTemporaryFile> m_temp;
+  std::unique_ptr<QCryptographicHash> m_hash;
+  qint64 m_written = 0;
+  QString m_error;
+};
+
+/**
+ * @brief 内容寻址文件存储
+ * 对象按 SHA-256 摘要存放在 <root>/objects/xx/yyyy...，同一内容只存一份；
+ * 写入先落到 <root>/tmp 再原子改名，崩溃不会留下半个对象。
+ * 本类只管文件，引用关系由使用方的数据表维护。
+ */
+class ContentAddressedStore {
+ public:
+  static constexpr qint64 kChunkSize = 1 << 20;  ///< 流式读写块大小
+
+  explicit ContentAddressedStore(const QString& rootDir);
+
+  /**
+   * @brief 创建目录结构并清理残留临时文件
+   * @return 是否成功
+   */
+  bool open();
+
+  /**
+   * @brief 根目录
+   * @return 路径
+   */
+  QString rootPath() const { return m_root; }
+
+  /**
+   * @brief 对象文件路径
+   * @param digest 内容摘要
+   * @return 路径（摘要非法时为空）
+   */
+  QString pathFor(const QString& digest) const;
+
+  /**
+   * @brief 对象是否存在
+   * @param digest 内容摘要
+   * @return 是否存在
+   */
+  bool contains(const QString& digest) const;
+
+  /**
+   * @brief 对象大小
+   * @param digest 内容摘要
+   * @return 字节数，不存在返回-1
+   */
+  qint64 sizeOf(const QString& digest) const;
+
+  /**
+   * @brief 映射对象为只读视图
+   * @param digest 内容摘要
+   * @return 视图（失败时isValid()为false）
+   */
+  ContentView view(const QString& digest) const;
+
+  /**
+   * @brief 开始一次流式写入
+   * @return 写入器
+   */
+  ContentWriter writer() const { return ContentWriter(this); }
+
+  /**
+   * @brief 写入一段内存数据
+   * @param data 数据
+   * @param existed 输出：内容此前是否已存在
+   * @return 内容摘要，失败返回空串
+   */
+  QString put(const QByteArray& data, bool* existed = nullptr) const;
+
+  /**
+   * @brief 分块复制一个外部文件入库
+   * @param filePath 源文件
+   * @param existed 输出：内容此前是否已存在
+   * @param error 输出：错误描述
+   * @return 内容摘要，失败返回空串
+   */
+  QString putFile(const QString& filePath, bool* existed = nullptr,
+                  QString* error = nullptr) const;
+
+  /**
+   * @brief 并行复制多个外部文件入库（每个线程一个文件，流式读写）
+   * @param filePaths 源文件列表
+   * @param threads 线程数（<=0 时取CPU核数）
+   * @return 与输入一一对应的结果
+   */
+  QVector<FileDigest> putFiles(const QStringList& filePaths,
+                               int threads = 0) const;
+
+  /**
+   * @brief 删除对象
+   * 仍被映射时（Windows）删除会失败，调用方可稍后重试
+   * @param digest 内容摘要
+   * @return 是否已不存在
+   */
+  bool remove(const QString& digest) const;
+
+  /**
+   * @brief 列出全部对象摘要
+   * @return 摘要列表
+   */
+  QStringList digests() const;
+
+  /**
+   * @brief 对象文件最后修改时间（自纪元起秒）
+   * @param digest 内容摘要
+   * @return 秒数，不存在返回-1
+   */
+  qint64 modifiedSecs(const QString& digest) const;
+
+  /**
+   * @brief 流式计算文件摘要（不入库）
+   * @param filePath 文件路径
+   * @return 摘要结果
+   */
+  static FileDigest hashFile(const QString& filePath);
+
+  /**
+   * @brief 并行计算多个文件的摘要（不入库）
+   * 工作线程按原子游标领取文件，每个文件按块流式读取
+   * @param filePaths 文件列表
+   * @param threads 线程数（<=0 时取CPU核数）
+   * @return 与输入一一对应的结果
+   */
+  static QVector<FileDigest> hashFiles(const QStringList& filePaths,
+                                       int threads = 0);
+
+  /**
+   * @brief 摘要格式校验（64位小写十六进制）
+   * @param digest 内容摘要
+   * @return 是否合法
+   */
+  static bool isValidDigest(const QString& digest);
+
+ private:
+  friend class ContentWriter;
+
+  QString tempDir() const;
+
+  QString m_root;
+};
+
+#endif  // CONTENT_ADDRESSED_STORE_H
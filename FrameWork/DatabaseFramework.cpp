@@ -9,8 +9,42 @@
 #include <QSqlError>
 #include <QSqlQuery>
 
+#include "AuditTrail.h"
 #include "BaseDatabaseManager.h"  // 新增：提供 ConnectionPool 的完整定义
 #include "DatabaseFramework.h"
+#include "SystemLogSink.h"
+#include "TraceSpan.h"
+#include "WorkloadCapture.h"
+
+// ============================================================================
+// 错误类别
+// ============================================================================
+
+DbErrorCode dbErrorCode(int sqliteCode) {
+  switch (sqliteCode & 0xff) {  // 扩展结果码的低8位为主结果码
+    case 0:    // SQLITE_OK
+    case 100:  // SQLITE_ROW
+    case 101:  // SQLITE_DONE
+      return DbErrorCode::NONE;
+    case 5:    // SQLITE_BUSY
+    case 6:    // SQLITE_LOCKED
+      return DbErrorCode::BUSY;
+    case 14:   // SQLITE_CANTOPEN
+      return DbErrorCode::NOT_OPEN;
+    case 19:   // SQLITE_CONSTRAINT
+      return DbErrorCode::CONSTRAINT;
+    default:
+      return DbErrorCode::OTHER;
+  }
+}
+
+DbErrorCode dbErrorCode(const QSqlError& error) {
+  if (error.type() == QSqlError::NoError) return DbErrorCode::NONE;
+  if (error.type() == QSqlError::ConnectionError) return DbErrorCode::NOT_OPEN;
+  bool ok = false;
+  const int code = error.nativeErrorCode().toInt(&ok);
+  return ok ? dbErrorCode(code) : DbErrorCode::OTHER;
+}
 
 // ============================================================================
 // DatabaseConfig实现
@@ -117,10 +151,89 @@ BaseTableOperations::BaseTableOperations(QSqlDatabase* db,
                                          ConnectionPool* pool, QObject* parent)
     : QObject(parent),
       m_database(db),
+      m_mutex(QString("BaseTableOperations::m_mutex[%1]").arg(tableName)),
       m_tableName(tableName),
       m_tableType(tableType),
       m_pool(pool) {
   logOperation("构造函数", QString("表操作对象已创建: %1").arg(tableName));
+
+  // 写入信号在发出线程上直接采集审计记录，事务内的记录由AuditTrail按所属
+  // 数据库暂存到提交
+  connect(
+      this, &BaseTableOperations::recordInserted, this,
+      [this](int id) {
+        if (m_auditEnabled) {
+          AuditTrail::instance()->capture(m_database, m_tableName,
+                                          AuditAction::INSERT, id);
+        }
+      },
+      Qt::DirectConnection);
+  connect(
+      this, &BaseTableOperations::recordUpdated, this,
+      [this](int id) {
+        if (m_auditEnabled) {
+          AuditTrail::instance()->capture(m_database, m_tableName,
+                                          AuditAction::UPDATE, id);
+        }
+      },
+      Qt::DirectConnection);
+  connect(
+      this, &BaseTableOperations::recordDeleted, this,
+      [this](int id) {
+        if (m_auditEnabled) {
+          AuditTrail::instance()->capture(m_database, m_tableName,
+                                          AuditAction::REMOVE, id);
+        }
+      },
+      Qt::DirectConnection);
+
+#ifndef DB_SQLITE_NATIVE
+  // 未装原生钩子时，写入信号即为变更流的来源；信号可能在事务提交前发出，
+  // 与审计记录一样随所属库的延迟作用域在提交后发布、回滚时丢弃
+  if (ChangeFeed* feed = changeFeed()) {
+    auto publishAfterCommit = [this, feed](ChangeOp op, int id) {
+      const QString table = m_tableName;
+      AuditTrail::runAfterCommit(m_database, [feed, table, op, id]() {
+        feed->publishRow(table, op, id);
+      });
+    };
+    connect(
+        this, &BaseTableOperations::recordInserted, this,
+        [publishAfterCommit](int id) {
+          publishAfterCommit(ChangeOp::INSERT, id);
+        },
+        Qt::DirectConnection);
+    connect(
+        this, &BaseTableOperations::recordUpdated, this,
+        [publishAfterCommit](int id) {
+          publishAfterCommit(ChangeOp::UPDATE, id);
+        },
+        Qt::DirectConnection);
+    connect(
+        this, &BaseTableOperations::recordDeleted, this,
+        [publishAfterCommit](int id) {
+          publishAfterCommit(ChangeOp::REMOVE, id);
+        },
+        Qt::DirectConnection);
+  }
+#endif
+}
+
+ChangeFeed* BaseTableOperations::changeFeed() const {
+  return m_pool ? m_pool->changeFeed() : nullptr;
+}
+
+bool BaseTableOperations::inThreadTransaction() const {
+  return m_pool && m_pool->hasThreadTransaction();
+}
+
+void BaseTableOperations::afterCommit(
+    std::function<void()> onCommit, std::function<void()> onRollback) const {
+  if (m_pool) {
+    m_pool->afterThreadTransaction(std::move(onCommit), std::move(onRollback));
+  } else if (onCommit) {
+    onCommit();
+  }
 }
 
 BaseTableOperations::ScopedDb::~ScopedDb() {
@@ -129,7 +242,16 @@ BaseTableOperations::ScopedDb::~ScopedDb() {
   }
 }
 
+NativeStatementCache* BaseTableOperations::ScopedDb::statements() const {
+  if (!pool || name.isEmpty() || !NativeStatement::enabled() ||
+      WorkloadCapture::enabled()) {
+    return nullptr;
+  }
+  return pool->statementCache(name);
+}
+
 BaseTableOperations::ScopedDb BaseTableOperations::acquireDb() const {
+  DB_TRACE_SPAN("table.acquireDb");
   qDebug() << "BaseTableOperations::acquireDb() 开始";
 
   if (m_pool) {
@@ -153,28 +275,28 @@ BaseTableOperations::ScopedDb BaseTableOperations::acquireDb() const {
 }
 
 bool BaseTableOperations::tableExists() {
-  QMutexLocker locker(&m_mutex);
+  ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
   auto c = acquireDb();
   if (!c.db.isOpen()) return false;
 
   QSqlQuery query(c.db);
   query.prepare("SELECT name FROM sqlite_master WHERE type='table' AND name=?");
   query.addBindValue(m_tableName);
-  return query.exec() && query.next();
+  return SqlExec::run(query) && query.next();
 }
 
 int BaseTableOperations::getTotalCount() const {
-  QMutexLocker locker(&m_mutex);
+  ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
   auto c = acquireDb();
   if (!c.db.isOpen()) return 0;
 
   QSqlQuery query(c.db);
   query.prepare(QString("SELECT COUNT(*) FROM %1").arg(m_tableName));
-  return (query.exec() && query.next()) ? query.value(0).toInt() : 0;
+  return (SqlExec::run(query) && query.next()) ? query.value(0).toInt() : 0;
 }
 
 bool BaseTableOperations::dropTable() {
-  QMutexLocker locker(&m_mutex);
+  ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
   auto c = acquireDb();
   if (!c.db.isOpen()) return false;
 
@@ -187,15 +309,79 @@ bool BaseTableOperations::dropTable() {
 }
 
 bool BaseTableOperations::truncateTable() {
-  QMutexLocker locker(&m_mutex);
+  bool ok = false;
+  {
+    ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
+    auto c = acquireDb();
+    if (!c.db.isOpen()) return false;
+
+    QSqlQuery query(c.db);
+    ok = SqlExec::run(query, QString("DELETE FROM %1").arg(m_tableName));
+    logOperation(ok ? "清空表成功" : "清空表失败",
+                 ok ? m_tableName : query.lastError().text());
+
+    // 无条件DELETE走截断优化，更新钩子不会逐行报告；整表变化同样在提交
+    // 后发布
+    if (ok) {
+      if (ChangeFeed* feed = changeFeed()) {
+#ifdef DB_SQLITE_NATIVE
+        feed->stageReset(c.db, m_tableName);
+#else
+        const QString table = m_tableName;
+        AuditTrail::runAfterCommit(
+            m_database, [feed, table]() { feed->publishReset(table); });
+#endif
+      }
+    }
+  }
+  // 释放表锁与连接后再通知，接收方可以在槽中同步重读整表
+  if (ok) emit tableReset();
+  return ok;
+}
+
+bool BaseTableOperations::runQuery(
+    const QString& sql, const QVariantList& values,
+    const std::function<void(const QSqlQuery&)>& onRow,
+    const std::function<void(const NativeStatement&)>& onNativeRow,
+    QString* error, DbErrorCode* code) const {
+  DB_TRACE_SPAN("table.query");
   auto c = acquireDb();
-  if (!c.db.isOpen()) return false;
+  if (!c.db.isOpen()) {
+    *error = "数据库未打开";
+    if (code) *code = DbErrorCode::NOT_OPEN;
+    return false;
+  }
+
+  TraceSpan lockSpan("table.lock");
+  ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
+  lockSpan.finish();
+
+  NativeStatement stmt(onNativeRow ? c.statements() : nullptr, sql);
+  if (stmt.isValid()) {
+    for (int i = 0; i < values.size(); ++i) stmt.bind(i + 1, values.at(i));
+    TraceSpan execSpan("sql.exec");
+    while (stmt.next()) onNativeRow(stmt);
+    if (stmt.failed()) {
+      *error = QString("查询 %1 失败: %2").arg(m_tableName, stmt.lastError());
+      if (code) *code = dbErrorCode(stmt.lastErrorCode());
+      return false;
+    }
+    return true;
+  }
 
   QSqlQuery query(c.db);
-  const bool ok = query.exec(QString("DELETE FROM %1").arg(m_tableName));
-  logOperation(ok ? "清空表成功" : "清空表失败",
-               ok ? m_tableName : query.lastError().text());
-  return ok;
+  query.setForwardOnly(true);
+  query.prepare(sql);
+  for (const QVariant& v : values) query.addBindValue(v);
+  TraceSpan execSpan("sql.exec");
+  if (!SqlExec::run(query)) {
+    *error = QString("查询 %1 失败: %2")
+                 .arg(m_tableName, query.lastError().text());
+    if (code) *code = dbErrorCode(query.lastError());
+    return false;
+  }
+  while (query.next()) onRow(query);
+  return true;
 }
 
 bool BaseTableOperations::executeQuery(const QString& sql,
@@ -209,10 +395,11 @@ bool BaseTableOperations::executeQuery(const QString& sql,
   QElapsedTimer t;
   t.start();
 
+  DB_TRACE_SPAN("sql.exec");
   QSqlQuery query(c.db);
   query.prepare(sql);
   for (const auto& p : params) query.addBindValue(p);
-  const bool ok = query.exec();
+  const bool ok = SqlExec::run(query);
   const qint64 ms = t.elapsed();
 
   if (!ok) {
@@ -230,6 +417,12 @@ bool BaseTableOperations::executeQuery(const QString& sql,
 
 void BaseTableOperations::logOperation(const QString& operation,
                                        const QString& details) const {
+  // 汇聚器运行时只拷贝参数入队，格式化与落盘由后台写线程完成
+  if (SystemLogSink::instance()->append(LogLevel::INFO, m_tableName, operation,
+                                        details)) {
+    return;
+  }
+
   QString logMessage =
       QString("[%1:%2] %3")
           .arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss"))
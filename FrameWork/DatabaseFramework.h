@@ -5,19 +5,28 @@
 // 只保留必要的Qt核心头文件
 #include <QDateTime>
 #include <QDebug>
+#include <QHash>
 #include <QMutex>
 #include <QObject>
 #include <QSqlDatabase>
+#include <QSqlQuery>
 #include <QStringList>
 #include <QUuid>
 #include <QVariant>
+#include <functional>
 #include <memory>
+#include <type_traits>
 #include <unordered_map>
 
+#include "ColumnarResult.h"
+#include "LockProfiler.h"
+#include "NativeStatement.h"
+#include "TableQuery.h"
+
 // 使用前向声明替代包含
-class QSqlQuery;
 class QSqlError;
 class ConnectionPool;
+class ChangeFeed;
 
 // ============================================================================
 // 枚举定义
@@ -89,47 +98,147 @@ enum class LogLevel {
   CRITICAL  ///< 严重错误
 };
 
+/**
+ * @brief 操作失败的错误类别
+ * 调用方按类别处理失败，不依赖（本地化的）错误信息文本
+ */
+enum class DbErrorCode {
+  NONE,        ///< 无错误
+  NOT_FOUND,   ///< 记录不存在
+  NOT_OPEN,    ///< 数据库未打开或连接池无可用连接
+  BUSY,        ///< 数据库忙或被锁（SQLITE_BUSY / SQLITE_LOCKED）
+  CONSTRAINT,  ///< 违反约束（唯一、非空等）
+  INVALID,     ///< 参数或数据校验失败
+  OTHER        ///< 其他错误
+};
+
+/**
+ * @brief 由 SQLite 结果码得到错误类别
+ * @param sqliteCode 主结果码或扩展结果码
+ * @return 错误类别（0 为 NONE，无法归类为 OTHER）
+ */
+DbErrorCode dbErrorCode(int sqliteCode);
+
+/**
+ * @brief 由 QSQLITE 驱动的错误得到错误类别（取 nativeErrorCode）
+ * @param error 驱动错误
+ * @return 错误类别
+ */
+DbErrorCode dbErrorCode(const QSqlError& error);
+
 // ============================================================================
 // 工具类和结果类
 // ============================================================================
 
 /**
  * @brief 数据库操作结果模板类
- * 用于封装数据库操作的结果，包含成功状态、错误信息和返回数据
+ * 用于封装数据库操作的结果，包含成功状态、错误信息和返回数据。
+ * 数据可移入或原地构造；失败结果复制一份共享的空值而不调用T的默认
+ * 构造（Qt隐式共享类型的空值复制不分配内存）
  * @tparam T 返回数据的类型
  */
 template <typename T>
 class DbResult {
  public:
-  bool success;          ///< 操作是否成功
-  QString errorMessage;  ///< 错误信息
-  T data;                ///< 返回的数据
+  bool success;           ///< 操作是否成功
+  QString errorMessage;   ///< 错误信息
+  DbErrorCode errorCode;  ///< 错误类别（成功时为NONE）
+  T data;                 ///< 返回的数据
+
+  /**
+   * @brief 构造失败的空结果
+   */
+  DbResult()
+      : success(false), errorCode(DbErrorCode::OTHER), data(emptyData()) {}
+
+  /**
+   * @brief 构造不带数据的结果
+   * @param s 操作是否成功
+   * @param msg 错误信息
+   */
+  DbResult(bool s, QString msg = QString())
+      : success(s),
+        errorMessage(std::move(msg)),
+        errorCode(s ? DbErrorCode::NONE : DbErrorCode::OTHER),
+        data(emptyData()) {}
+
+  /**
+   * @brief 构造函数
+   * @param s 操作是否成功
+   * @param msg 错误信息
+   * @param d 返回的数据（复制）
+   */
+  DbResult(bool s, const QString& msg, const T& d)
+      : success(s),
+        errorMessage(msg),
+        errorCode(s ? DbErrorCode::NONE : DbErrorCode::OTHER),
+        data(d) {}
 
   /**
    * @brief 构造函数
    * @param s 操作是否成功
    * @param msg 错误信息
-   * @param d 返回的数据
+   * @param d 返回的数据（移入）
    */
-  DbResult(bool s = false, const QString& msg = "", const T& d = T())
-      : success(s), errorMessage(msg), data(d) {}
+  DbResult(bool s, QString msg, T&& d)
+      : success(s),
+        errorMessage(std::move(msg)),
+        errorCode(s ? DbErrorCode::NONE : DbErrorCode::OTHER),
+        data(std::move(d)) {}
+
+  /**
+   * @brief 创建成功的结果（数据为空值）
+   * @return 成功的DbResult对象
+   */
+  static DbResult Success() { return DbResult(true); }
 
   /**
    * @brief 创建成功的结果
-   * @param data 返回的数据
+   * @param data 返回的数据（复制；传右值时移入）
+   * @return 成功的DbResult对象
+   */
+  static DbResult Success(const T& data) {
+    return DbResult(true, QString(), data);
+  }
+  static DbResult Success(T&& data) {
+    return DbResult(true, QString(), std::move(data));
+  }
+
+  /**
+   * @brief 创建成功的结果，数据以给定参数原地构造
+   * @param args T的构造参数
    * @return 成功的DbResult对象
    */
-  static DbResult Success(const T& data = T()) {
-    return DbResult(true, "", data);
+  template <typename... Args>
+  static DbResult Emplace(Args&&... args) {
+    return DbResult(InPlace(), std::forward<Args>(args)...);
   }
 
   /**
-   * @brief 创建失败的结果
+   * @brief 创建失败的结果（不构造新的T）
    * @param msg 错误信息
+   * @param code 错误类别
    * @return 失败的DbResult对象
    */
-  static DbResult Error(const QString& msg) {
-    return DbResult(false, msg, T());
+  static DbResult Error(QString msg, DbErrorCode code = DbErrorCode::OTHER) {
+    DbResult result(false, std::move(msg));
+    result.errorCode = code;
+    return result;
+  }
+
+ private:
+  struct InPlace {};
+
+  template <typename... Args>
+  explicit DbResult(InPlace, Args&&... args)
+      : success(true),
+        errorCode(DbErrorCode::NONE),
+        data(std::forward<Args>(args)...) {}
+
+  /// 每个T一份的空值，首次使用时构造
+  static const T& emptyData() {
+    static const T empty{};
+    return empty;
   }
 };
 
@@ -252,6 +361,20 @@ struct PageResult {
         pageSize(params.pageSize) {
     totalPages = (totalCount + pageSize - 1) / pageSize;
   }
+
+  /**
+   * @brief 构造函数（移入数据列表）
+   * @param list 数据列表
+   * @param total 总记录数
+   * @param params 分页参数
+   */
+  PageResult(QList<T>&& list, int total, const PageParams& params)
+      : data(std::move(list)),
+        totalCount(total),
+        currentPage(params.pageIndex),
+        pageSize(params.pageSize) {
+    totalPages = (totalCount + pageSize - 1) / pageSize;
+  }
 };
 
 // ============================================================================
@@ -322,7 +445,7 @@ class BaseTableOperations : public QObject, public ITableOperations {
 
  public:
   QSqlDatabase* m_database;  // 主连接句柄（不拥有）
-  mutable QMutex m_mutex;
+  mutable ProfiledMutex m_mutex;
   QString m_tableName;
   TableType m_tableType;
 
@@ -336,6 +459,10 @@ class BaseTableOperations : public QObject, public ITableOperations {
     QSqlDatabase db;       // 该次操作用到的 QSqlDatabase 句柄
     ConnectionPool* pool;  // 用于归还连接
     ~ScopedDb();  // 在 .cpp 里实现：若 name 非空，归还连接
+
+    // 池连接的原生语句缓存；原生路径关闭、采集负载中（语句须经
+    // SqlExec 记录）或使用主连接时为nullptr，调用方退回 QSqlQuery
+    NativeStatementCache* statements() const;
   };
 
   // 新增：获取一个可用的 db（有池则取池连接，否则用主连接）
@@ -356,16 +483,66 @@ class BaseTableOperations : public QObject, public ITableOperations {
   bool truncateTable() override;
   virtual bool createTable() override = 0;
 
+  /**
+   * @brief 设置是否采集操作审计（日志、审计等只追加表应关闭）
+   * @param enabled 是否采集
+   */
+  void setAuditEnabled(bool enabled) { m_auditEnabled = enabled; }
+  bool auditEnabled() const { return m_auditEnabled; }
+
+  /**
+   * @brief 所属数据库的变更流
+   * @return 变更流指针（无连接池时为nullptr）
+   */
+  ChangeFeed* changeFeed() const;
+
+  /**
+   * @brief 当前线程是否有活动的线程事务
+   * @return 有活动事务时为 true（无连接池时恒为 false）
+   */
+  bool inThreadTransaction() const;
+
+  /**
+   * @brief 在当前线程事务结束后执行动作
+   * 有活动线程事务时提交后执行 onCommit、回滚后执行 onRollback；
+   * 否则（含无连接池）立即执行 onCommit
+   * @param onCommit 提交后的动作
+   * @param onRollback 回滚后的动作（可为空）
+   */
+  void afterCommit(std::function<void()> onCommit,
+                   std::function<void()> onRollback = {}) const;
+
  signals:
   void recordInserted(int id);
   void recordUpdated(int id);
   void recordDeleted(int id);
+  void tableReset();  ///< 整表变化（清空表，释放表锁后发出），无法逐行报告
   void databaseError(const QString& error);
 
  public:
   bool executeQuery(const QString& sql, const QVariantList& params = {}) const;
+
+  /**
+   * @brief 执行条件查询生成的语句并逐行回调（持表锁）
+   * 池连接上有原生语句缓存时按 SQL 文本取缓存的预编译语句，否则用
+   * QSqlQuery；每行只回调与所走路径对应的一个
+   * @param sql 只含占位符的语句
+   * @param values 按位置绑定的取值
+   * @param onRow QSqlQuery 路径的行回调
+   * @param onNativeRow 原生路径的行回调（为空时总走 QSqlQuery）
+   * @param error 失败时的错误信息
+   * @param code 失败时的错误类别（可为空）
+   * @return 是否成功
+   */
+  bool runQuery(const QString& sql, const QVariantList& values,
+                const std::function<void(const QSqlQuery&)>& onRow,
+                const std::function<void(const NativeStatement&)>& onNativeRow,
+                QString* error, DbErrorCode* code = nullptr) const;
   void logOperation(const QString& operation,
                     const QString& details = "") const;
+
+ private:
+  bool m_auditEnabled = true;  ///< 写入信号是否转为操作审计记录
 };
 
 // ============================================================================
@@ -449,6 +626,178 @@ class BaseTable {
    * @return 操作结果，包含成功插入的记录数
    */
   virtual DbResult<int> batchInsert(const QList<T>& entities) = 0;
+
+  // ========================================================================
+  // 可选覆盖的虚函数
+  // ========================================================================
+
+  /**
+   * @brief 按ID批量查询记录（实时查询据此只重读受影响的行）
+   * 默认逐个调用selectById，子类宜以单条 IN 查询覆盖（见 selectRowsByIds）
+   * @param ids 记录ID列表
+   * @return 操作结果，ID到记录的映射（不存在的ID不出现在结果中）；
+   *         任一ID因不存在以外的原因读取失败时返回错误并列出这些ID
+   */
+  virtual DbResult<QHash<int, T>> selectByIds(const QList<int>& ids) const {
+    QHash<int, T> rows;
+    QStringList failed;
+    DbResult<T> firstError;
+    for (int id : ids) {
+      DbResult<T> r = selectById(id);
+      if (r.success) {
+        rows.insert(id, std::move(r.data));
+      } else if (r.errorCode != DbErrorCode::NOT_FOUND) {
+        if (failed.isEmpty()) firstError = std::move(r);
+        failed.append(QString::number(id));
+      }
+    }
+    if (!failed.isEmpty()) {
+      return DbResult<QHash<int, T>>::Error(
+          QString("按ID查询失败（ID: %1）: %2")
+              .arg(failed.join(','), firstError.errorMessage),
+          firstError.errorCode);
+    }
+    return DbResult<QHash<int, T>>::Success(std::move(rows));
+  }
+
+  /**
+   * @brief 以列式结果查询所有记录（大结果集扫描、导出用）
+   * 默认不支持，行数可能很大的表宜覆盖
+   * @return 操作结果，包含列式结果（列顺序与selectAll的查询列一致）
+   */
+  virtual DbResult<ColumnarResult> selectAllColumnar() const {
+    return DbResult<ColumnarResult>::Error("该表不支持列式查询");
+  }
+
+  // ========================================================================
+  // 条件查询
+  // ========================================================================
+
+  /**
+   * @brief 条件查询允许的列（白名单，顺序即实体查询的结果列顺序）
+   * 默认为空，即不支持条件查询
+   */
+  virtual QVector<ColumnSpec> queryColumns() const { return {}; }
+
+  /**
+   * @brief 新建本表的条件查询
+   */
+  TableQuery tableQuery() const {
+    return TableQuery(m_baseOps ? m_baseOps->tableName() : QString(),
+                      queryColumns());
+  }
+
+  /**
+   * @brief 按条件查询记录（不得带投影）
+   * 默认不支持，子类以 selectRows 覆盖
+   * @param query 条件查询
+   * @return 操作结果，包含记录列表
+   */
+  virtual DbResult<QList<T>> select(const TableQuery& query) const {
+    Q_UNUSED(query);
+    return DbResult<QList<T>>::Error("该表不支持条件查询");
+  }
+
+  /**
+   * @brief 按条件查询为列式结果（可带投影）
+   * @param query 条件查询
+   * @return 操作结果，列为 query.resultColumns()
+   */
+  DbResult<ColumnarResult> selectColumnar(const TableQuery& query) const {
+    if (!query.isValid()) return DbResult<ColumnarResult>::Error(query.error());
+    if (!m_baseOps) return DbResult<ColumnarResult>::Error("表未初始化");
+    ColumnarResult result(query.resultColumns());
+    QString error;
+    DbErrorCode code = DbErrorCode::NONE;
+    const bool ok = m_baseOps->runQuery(
+        query.sql(), query.bindValues(),
+        [&result](const QSqlQuery& row) { result.appendRow(row); },
+        [&result](const NativeStatement& row) { result.appendRow(row); },
+        &error, &code);
+    if (!ok) return DbResult<ColumnarResult>::Error(error, code);
+    result.squeeze();
+    return DbResult<ColumnarResult>::Success(std::move(result));
+  }
+
+  /**
+   * @brief 统计满足条件的记录数（忽略投影、排序与行数限制）
+   * @param query 条件查询
+   * @return 操作结果，包含记录数
+   */
+  DbResult<int> count(const TableQuery& query) const {
+    if (!query.isValid()) return DbResult<int>::Error(query.error());
+    if (!m_baseOps) return DbResult<int>::Error("表未初始化");
+    int n = 0;
+    QString error;
+    DbErrorCode code = DbErrorCode::NONE;
+    const bool ok = m_baseOps->runQuery(
+        query.countSql(), query.countBindValues(),
+        [&n](const QSqlQuery& row) { n = row.value(0).toInt(); },
+        [&n](const NativeStatement& row) { n = row.columnInt(0); }, &error,
+        &code);
+    if (!ok) return DbResult<int>::Error(error, code);
+    return DbResult<int>::Success(n);
+  }
+
+ protected:
+  /**
+   * @brief select 的通用实现
+   * @param query 条件查询
+   * @param build 由当前行构建实体（列顺序同 queryColumns()），接受
+   *        QSqlQuery；也接受 NativeStatement 时可走原生路径
+   * @return 操作结果，包含记录列表
+   */
+  template <typename Build>
+  DbResult<QList<T>> selectRows(const TableQuery& query, Build build) const {
+    if (!query.isValid()) return DbResult<QList<T>>::Error(query.error());
+    if (query.hasProjection()) {
+      return DbResult<QList<T>>::Error(
+          "实体查询须取全部列，投影请用 selectColumnar");
+    }
+    if (!m_baseOps) return DbResult<QList<T>>::Error("表未初始化");
+    QList<T> rows;
+    std::function<void(const NativeStatement&)> onNativeRow;
+    if constexpr (std::is_invocable_v<Build, const NativeStatement&>) {
+      onNativeRow = [&](const NativeStatement& row) {
+        rows.append(build(row));
+      };
+    }
+    QString error;
+    DbErrorCode code = DbErrorCode::NONE;
+    const bool ok = m_baseOps->runQuery(
+        query.sql(), query.bindValues(),
+        [&](const QSqlQuery& row) { rows.append(build(row)); }, onNativeRow,
+        &error, &code);
+    if (!ok) return DbResult<QList<T>>::Error(error, code);
+    return DbResult<QList<T>>::Success(std::move(rows));
+  }
+
+  /**
+   * @brief selectByIds 的条件查询实现：每批一条 id IN (...) 查询
+   * 要求表支持条件查询且实体有 id 成员；ID 超过 IN 列表上限时分批
+   * @param ids 记录ID列表
+   * @return 操作结果，ID到记录的映射（不存在的ID不出现在结果中）
+   */
+  DbResult<QHash<int, T>> selectRowsByIds(const QList<int>& ids) const {
+    QHash<int, T> rows;
+    rows.reserve(ids.size());
+    for (int begin = 0; begin < ids.size();
+         begin += TableQuery::kMaxInValues) {
+      const int end = qMin(begin + TableQuery::kMaxInValues, ids.size());
+      QVariantList chunk;
+      chunk.reserve(end - begin);
+      for (int i = begin; i < end; ++i) chunk.append(ids.at(i));
+      DbResult<QList<T>> r = select(tableQuery().whereIn("id", chunk));
+      if (!r.success) {
+        return DbResult<QHash<int, T>>::Error(r.errorMessage, r.errorCode);
+      }
+      for (T& row : r.data) {
+        const int id = row.id;
+        rows.insert(id, std::move(row));
+      }
+    }
+    return DbResult<QHash<int, T>>::Success(std::move(rows));
+  }
 };
 
 #endif  // DATABASE_FRAMEWORK_H
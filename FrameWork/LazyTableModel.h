@@ -0,0 +1,563 @@
+﻿// LazyTableModel.h - 按需分页加载的表格模型适配器
+#ifndef LAZY_TABLE_MODEL_H
+#define LAZY_TABLE_MODEL_H
+
+#include <QAbstractTableModel>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QRunnable>
+#include <QSet>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThreadPool>
+#include <QVector>
+#include <algorithm>
+#include <functional>
+
+#include "ChangeFeed.h"
+#include "DatabaseFramework.h"
+#include "WorkloadCapture.h"
+
+/**
+ * @brief 表格模型参数
+ */
+struct LazyTableModelOptions {
+  int pageSize = 200;        ///< 每页行数
+  int maxResidentPages = 8;  ///< 常驻内存的最多页数
+  int prefetchPages = 1;     ///< 距已加载末尾不足几页时提前加载下一页
+  bool descending = false;   ///< 是否按id降序（新记录在前）
+};
+
+/**
+ * @brief 后台任务（Qt 5.14 的 QThreadPool 尚不接受函数对象）
+ */
+class LazyTableTask : public QRunnable {
+ public:
+  explicit LazyTableTask(std::function<void()> fn) : m_fn(std::move(fn)) {}
+  void run() override { m_fn(); }
+
+ private:
+  std::function<void()> m_fn;
+};
+
+/**
+ * @brief 任意 BaseTable<T> 的按需加载表格模型
+ * 按id做键集分页：fetchMore 在后台线程取下一页的id与行，到达后追加到
+ * 模型末尾；视图访问接近已加载末尾的行时提前取下一页，滚动时不必等待。
+ *
+ * 模型为已加载的每行保留一个id（4字节），行内容只保留最近访问的
+ * maxResidentPages 页，超出时淘汰最久未访问的页；被淘汰的行再次显示时
+ * 按页在后台重读，到达前该行显示为空。
+ *
+ * 模型订阅所属库的变更流（只含已提交的事务，回滚的写入不会出现），
+ * 变更排队送达模型线程：新增行插入到已加载范围内的对应位置（尚未加载
+ * 到的部分留待分页），更新行在后台重读，删除行直接移除，清空表或变更流
+ * 队列溢出时模型重置。非 sqlite_native 构建中绕过表类的原始SQL写入需
+ * 调用 reload()。
+ *
+ * 模板类不能使用 Q_OBJECT，模型不声明新的信号与槽，只用基类信号。
+ * 须在拥有它的线程（通常为界面线程）中使用；表须比模型存活更久。
+ * @tparam T 数据实体类型
+ */
+template <typename T>
+class LazyTableModel : public QAbstractTableModel {
+ public:
+  /**
+   * @brief 列定义
+   */
+  struct Column {
+    QString header;                           ///< 列标题
+    std::function<QVariant(const T&)> value;  ///< 取显示值
+  };
+
+  /**
+   * @brief 构造函数（首页在构造后立即开始加载）
+   * @param table 数据表
+   * @param columns 列定义
+   * @param options 模型参数
+   * @param parent 父对象
+   */
+  LazyTableModel(BaseTable<T>* table, QVector<Column> columns,
+                 const LazyTableModelOptions& options = {},
+                 QObject* parent = nullptr)
+      : QAbstractTableModel(parent),
+        m_table(table),
+        m_columns(std::move(columns)),
+        m_options(options) {
+    m_options.pageSize = qMax(1, m_options.pageSize);
+    m_options.maxResidentPages = qMax(1, m_options.maxResidentPages);
+    m_options.prefetchPages = qMax(0, m_options.prefetchPages);
+    // 单线程执行，后台结果按提交顺序到达
+    m_workers.setMaxThreadCount(1);
+
+    BaseTableOperations* ops = m_table ? m_table->baseOperations() : nullptr;
+    if (!ops) {
+      m_atEnd = true;
+      m_lastError = "表未初始化或已释放";
+      return;
+    }
+
+    // 变更在消费线程中收到，排队到模型线程后再处理
+    if (ChangeFeed* feed = ops->changeFeed()) {
+      ChangeFeed::SubscribeOptions subscribeOptions;
+      subscribeOptions.tables = {ops->tableName()};
+      m_feed = feed;
+      m_subscription = feed->subscribe(
+          [this](QVector<ChangeTransaction>& batch) {
+            QVector<ChangeEvent> changes;
+            for (const ChangeTransaction& tx : batch) changes += tx.changes;
+            // 队列溢出丢弃过变更：增量无从补回，整体重新加载
+            const quint64 dropped =
+                m_feed->subscriptionStats(m_subscription).dropped;
+            const bool overflow = dropped != m_droppedSeen;
+            m_droppedSeen = dropped;
+            QMetaObject::invokeMethod(
+                this,
+                [this, changes, overflow]() { onChanges(changes, overflow); },
+                Qt::QueuedConnection);
+            return true;
+          },
+          subscribeOptions);
+    }
+
+    startFetch();
+  }
+
+  ~LazyTableModel() override {
+    // 先停订阅（返回后不再有回调），再等待在途任务结束；其后排队的
+    // 结果随对象析构被丢弃
+    if (m_feed && m_subscription) m_feed->unsubscribe(m_subscription);
+    m_workers.clear();
+    m_workers.waitForDone();
+  }
+
+  // ========================================================================
+  // QAbstractTableModel
+  // ========================================================================
+
+  int rowCount(const QModelIndex& parent = QModelIndex()) const override {
+    return parent.isValid() ? 0 : m_ids.size();
+  }
+
+  int columnCount(const QModelIndex& parent = QModelIndex()) const override {
+    return parent.isValid() ? 0 : m_columns.size();
+  }
+
+  QVariant data(const QModelIndex& index,
+                int role = Qt::DisplayRole) const override {
+    if (!index.isValid() || index.row() >= m_ids.size()) return QVariant();
+    if (role != Qt::DisplayRole && role != Qt::EditRole) return QVariant();
+
+    auto* self = const_cast<LazyTableModel*>(this);
+    self->prefetchNear(index.row());
+
+    const auto it = m_rows.constFind(m_ids.at(index.row()));
+    if (it == m_rows.constEnd()) {
+      self->loadPageAt(index.row());
+      return QVariant();
+    }
+    self->touch(it->page);
+    return m_columns.at(index.column()).value(it->row);
+  }
+
+  QVariant headerData(int section, Qt::Orientation orientation,
+                      int role = Qt::DisplayRole) const override {
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole &&
+        section >= 0 && section < m_columns.size()) {
+      return m_columns.at(section).header;
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+  }
+
+  bool canFetchMore(const QModelIndex& parent) const override {
+    return !parent.isValid() && !m_atEnd;
+  }
+
+  void fetchMore(const QModelIndex& parent) override {
+    if (!parent.isValid()) startFetch();
+  }
+
+  // ========================================================================
+  // 扩展接口
+  // ========================================================================
+
+  /**
+   * @brief 丢弃已加载内容并从首页重新加载
+   */
+  void reload() {
+    beginResetModel();
+    ++m_generation;
+    m_ids.clear();
+    m_rows.clear();
+    m_pageOrder.clear();
+    m_pageIds.clear();
+    m_loading.clear();
+    m_pendingInserts.clear();
+    m_cursor = 0;
+    m_atEnd = false;
+    m_fetching = false;
+    m_lastError.clear();
+    endResetModel();
+    startFetch();
+  }
+
+  /**
+   * @brief 等待后台任务完成并处理其结果（测试与批处理用）
+   * @param timeoutMs 最长等待时间（毫秒）
+   * @return 是否在超时前完成
+   */
+  bool waitForIdle(int timeoutMs = 5000) {
+    bool done = true;
+    if (m_feed && m_subscription) {
+      done = m_feed->flush(m_subscription, timeoutMs);
+      // 送达的变更可能再启动后台重读
+      QCoreApplication::sendPostedEvents(this);
+    }
+    done = m_workers.waitForDone(timeoutMs) && done;
+    QCoreApplication::sendPostedEvents(this);
+    return done;
+  }
+
+  /**
+   * @brief 行对应的记录ID
+   * @param row 行号
+   * @return 记录ID（越界时为-1）
+   */
+  int idAt(int row) const {
+    return row >= 0 && row < m_ids.size() ? m_ids.at(row) : -1;
+  }
+
+  /**
+   * @brief 当前常驻内存的行数
+   * @return 行数
+   */
+  int residentRowCount() const { return m_rows.size(); }
+
+  /**
+   * @brief 最近一次后台加载的错误
+   * 行读取失败时错误信息列出失败的ID（见 BaseTable::selectByIds）
+   * @return 错误信息（无错误时为空）
+   */
+  QString lastError() const { return m_lastError; }
+
+ private:
+  struct Resident {
+    T row;
+    quint64 page = 0;  ///< 所属加载批次
+  };
+
+  // ========================================================================
+  // 分页与按需加载（模型线程）
+  // ========================================================================
+
+  void prefetchNear(int row) {
+    const int threshold = m_options.prefetchPages * m_options.pageSize;
+    if (m_ids.size() - row <= threshold) startFetch();
+  }
+
+  /**
+   * @brief 在后台取游标之后的下一页
+   */
+  void startFetch() {
+    if (m_fetching || m_atEnd || !m_table) return;
+    m_fetching = true;
+
+    const quint64 generation = m_generation;
+    const qint64 cursor = m_cursor;
+    const bool first = m_ids.isEmpty() && m_cursor == 0;
+    run([this, generation, cursor, first]() {
+      QVector<int> ids;
+      QString error;
+      DbResult<QHash<int, T>> rows;
+      if (queryPageIds(cursor, first, &ids, &error)) {
+        rows = m_table->selectByIds(ids.toList());
+        if (!rows.success) error = rows.errorMessage;
+      }
+      QMetaObject::invokeMethod(
+          this,
+          [this, generation, ids, rows, error]() {
+            onPageFetched(generation, ids, rows.data, error);
+          },
+          Qt::QueuedConnection);
+    });
+  }
+
+  void onPageFetched(quint64 generation, const QVector<int>& ids,
+                     const QHash<int, T>& rows, const QString& error) {
+    if (generation != m_generation) return;
+    m_fetching = false;
+    if (!error.isEmpty()) {
+      // 停止自动分页，避免出错时反复重试；reload() 可恢复
+      m_lastError = error;
+      m_atEnd = true;
+      qWarning() << "表格模型加载失败:" << error;
+      return;
+    }
+
+    m_atEnd = ids.size() < m_options.pageSize;
+    if (!ids.isEmpty()) m_cursor = ids.last();
+
+    // 已由写入通知插入的id不再重复追加
+    QVector<int> fresh;
+    fresh.reserve(ids.size());
+    for (int id : ids) {
+      if (m_ids.isEmpty() || before(m_ids.last(), id)) fresh.append(id);
+    }
+    if (!fresh.isEmpty()) {
+      beginInsertRows(QModelIndex(), m_ids.size(),
+                      m_ids.size() + fresh.size() - 1);
+      m_ids += fresh;
+      endInsertRows();
+    }
+    addPage(fresh, rows);
+
+    QList<int> pending = m_pendingInserts.values();
+    m_pendingInserts.clear();
+    std::sort(pending.begin(), pending.end(),
+              [this](int a, int b) { return before(a, b); });
+    for (int id : pending) onInserted(id);
+  }
+
+  /**
+   * @brief 在后台重读某行所在页中不在内存的行
+   */
+  void loadPageAt(int row) {
+    const int begin = row - row % m_options.pageSize;
+    const int end = qMin(begin + m_options.pageSize, m_ids.size());
+    QList<int> missing;
+    for (int i = begin; i < end; ++i) {
+      const int id = m_ids.at(i);
+      if (!m_rows.contains(id) && !m_loading.contains(id)) missing.append(id);
+    }
+    loadRows(missing);
+  }
+
+  void loadRows(const QList<int>& ids) {
+    if (ids.isEmpty() || !m_table) return;
+    for (int id : ids) m_loading.insert(id);
+
+    const quint64 generation = m_generation;
+    run([this, generation, ids]() {
+      DbResult<QHash<int, T>> rows = m_table->selectByIds(ids);
+      QMetaObject::invokeMethod(
+          this,
+          [this, generation, ids, rows]() {
+            onRowsLoaded(generation, ids, rows);
+          },
+          Qt::QueuedConnection);
+    });
+  }
+
+  void onRowsLoaded(quint64 generation, const QList<int>& ids,
+                    const DbResult<QHash<int, T>>& rows) {
+    if (generation != m_generation) return;
+    for (int id : ids) m_loading.remove(id);
+    if (!rows.success) {
+      m_lastError = rows.errorMessage;
+      qWarning() << "表格模型重读失败:" << rows.errorMessage;
+      return;
+    }
+
+    QVector<int> present;
+    for (int id : ids) {
+      if (rows.data.contains(id) && rowOf(id) >= 0) present.append(id);
+    }
+    addPage(present, rows.data);
+    emitRowsChanged(present);
+  }
+
+  /**
+   * @brief 把一批行作为一页放入内存，超出上限时淘汰最久未访问的页
+   */
+  void addPage(const QVector<int>& ids, const QHash<int, T>& rows) {
+    if (ids.isEmpty()) return;
+    const quint64 page = ++m_pageSeq;
+    for (int id : ids) {
+      const auto it = rows.constFind(id);
+      if (it != rows.constEnd()) m_rows.insert(id, Resident{*it, page});
+    }
+    m_pageIds.insert(page, ids);
+    m_pageOrder.append(page);
+
+    while (m_pageOrder.size() > m_options.maxResidentPages) {
+      const quint64 oldest = m_pageOrder.takeFirst();
+      for (int id : m_pageIds.take(oldest)) {
+        const auto it = m_rows.find(id);
+        // 行可能已被后来的批次重读，只淘汰仍属本批的
+        if (it != m_rows.end() && it->page == oldest) m_rows.erase(it);
+      }
+    }
+  }
+
+  void touch(quint64 page) {
+    if (!m_pageOrder.isEmpty() && m_pageOrder.last() == page) return;
+    if (m_pageOrder.removeOne(page)) m_pageOrder.append(page);
+  }
+
+  void emitRowsChanged(const QVector<int>& ids) {
+    int first = m_ids.size();
+    int last = -1;
+    for (int id : ids) {
+      const int row = rowOf(id);
+      if (row < 0) continue;
+      first = qMin(first, row);
+      last = qMax(last, row);
+    }
+    if (last < 0) return;
+    emit dataChanged(index(first, 0), index(last, m_columns.size() - 1));
+  }
+
+  // ========================================================================
+  // 变更通知（模型线程）
+  // ========================================================================
+
+  void onChanges(const QVector<ChangeEvent>& changes, bool overflow) {
+    bool reset = overflow;
+    for (const ChangeEvent& e : changes) {
+      if (e.op == ChangeOp::RESET) reset = true;
+    }
+    if (reset) {
+      reload();
+      return;
+    }
+    for (const ChangeEvent& e : changes) {
+      const int id = static_cast<int>(e.rowid);
+      switch (e.op) {
+        case ChangeOp::INSERT:
+          onInserted(id);
+          break;
+        case ChangeOp::UPDATE:
+          onUpdated(id);
+          break;
+        case ChangeOp::REMOVE:
+          onDeleted(id);
+          break;
+        case ChangeOp::RESET:
+          break;
+      }
+    }
+  }
+
+  void onInserted(int id) {
+    const auto pos = std::lower_bound(
+        m_ids.begin(), m_ids.end(), id,
+        [this](int a, int b) { return before(a, b); });
+    if (pos != m_ids.end() && *pos == id) return;
+    // 落在未加载部分的新行留待后续分页取得；在途的一页可能早于该行
+    // 提交而不含它，先记下，该页到达后再判断
+    if (pos == m_ids.end() && !m_atEnd) {
+      if (m_fetching) m_pendingInserts.insert(id);
+      return;
+    }
+
+    const int row = static_cast<int>(pos - m_ids.begin());
+    beginInsertRows(QModelIndex(), row, row);
+    m_ids.insert(row, id);
+    endInsertRows();
+    if (row == m_ids.size() - 1) m_cursor = id;
+  }
+
+  void onUpdated(int id) {
+    if (rowOf(id) < 0 || m_loading.contains(id)) return;
+    // 不在内存的行下次显示时自然读到新值
+    if (m_rows.contains(id)) loadRows({id});
+  }
+
+  void onDeleted(int id) {
+    m_pendingInserts.remove(id);
+    const int row = rowOf(id);
+    if (row < 0) return;
+    beginRemoveRows(QModelIndex(), row, row);
+    m_ids.remove(row);
+    m_rows.remove(id);
+    endRemoveRows();
+  }
+
+  // ========================================================================
+  // 辅助函数
+  // ========================================================================
+
+  /**
+   * @brief 按模型排序 a 是否在 b 之前
+   */
+  bool before(int a, int b) const {
+    return m_options.descending ? a > b : a < b;
+  }
+
+  int rowOf(int id) const {
+    const auto pos = std::lower_bound(
+        m_ids.begin(), m_ids.end(), id,
+        [this](int a, int b) { return before(a, b); });
+    return pos != m_ids.end() && *pos == id
+               ? static_cast<int>(pos - m_ids.begin())
+               : -1;
+  }
+
+  void run(std::function<void()> fn) {
+    m_workers.start(new LazyTableTask(std::move(fn)));
+  }
+
+  /**
+   * @brief 键集分页：只取游标之后一页的id（后台线程，表锁只在本函数内持有）
+   */
+  bool queryPageIds(qint64 cursor, bool first, QVector<int>* out,
+                    QString* error) const {
+    BaseTableOperations* ops = m_table->baseOperations();
+    if (!ops) {
+      *error = "表未初始化或已释放";
+      return false;
+    }
+    auto c = ops->acquireDb();
+    if (!c.db.isOpen()) {
+      *error = "数据库未打开";
+      return false;
+    }
+
+    const bool desc = m_options.descending;
+    const QString sql =
+        QString("SELECT id FROM %1 %2 ORDER BY id %3 LIMIT %4")
+            .arg(ops->tableName(),
+                 first ? QString() : desc ? "WHERE id < ?" : "WHERE id > ?",
+                 desc ? "DESC" : "ASC")
+            .arg(m_options.pageSize);
+
+    ProfiledMutexLocker locker(&ops->m_mutex, DB_LOCK_SITE);
+    QSqlQuery query(c.db);
+    query.setForwardOnly(true);
+    query.prepare(sql);
+    if (!first) query.addBindValue(cursor);
+    if (!SqlExec::run(query)) {
+      *error = QString("分页查询失败: %1").arg(query.lastError().text());
+      return false;
+    }
+    while (query.next()) out->append(query.value(0).toInt());
+    return true;
+  }
+
+  BaseTable<T>* m_table;
+  QVector<Column> m_columns;
+  LazyTableModelOptions m_options;
+
+  QVector<int> m_ids;           ///< 已加载行的id（按模型排序）
+  QHash<int, Resident> m_rows;  ///< 常驻内存的行
+  QList<quint64> m_pageOrder;   ///< 常驻批次，按最近访问先后排列
+  QSet<int> m_loading;          ///< 正在后台重读的id
+  QSet<int> m_pendingInserts;   ///< 分页在途期间收到的末尾新增
+  /// 批次 -> 其中的id
+  QHash<quint64, QVector<int>> m_pageIds;
+  quint64 m_pageSeq = 0;
+
+  qint64 m_cursor = 0;       ///< 键集游标（最后取到的id）
+  bool m_atEnd = false;      ///< 是否已取到表末尾
+  bool m_fetching = false;   ///< 是否有分页在途
+  quint64 m_generation = 0;  ///< 重置代数，用于丢弃过期结果
+  QString m_lastError;
+
+  ChangeFeed* m_feed = nullptr;  ///< 变更流（不拥有）
+  quint64 m_subscription = 0;    ///< 变更流订阅ID
+  quint64 m_droppedSeen = 0;     ///< 已处理过的队列丢弃数（消费线程）
+
+  QThreadPool m_workers;  ///< 后台加载线程
+};
+
+#endif  // LAZY_TABLE_MODEL_H
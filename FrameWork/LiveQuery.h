@@ -0,0 +1,624 @@
+﻿// LiveQuery.h - 实时查询：初始结果 + 行级增量差异
+#ifndef LIVE_QUERY_H
+#define LIVE_QUERY_H
+
+#include <QByteArray>
+#include <QDebug>
+#include <QMutex>
+#include <QSet>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QVector>
+#include <algorithm>
+#include <functional>
+
+#include "ChangeFeed.h"
+#include "DatabaseFramework.h"
+#include "TableQuery.h"
+#include "WorkloadCapture.h"
+
+/**
+ * @brief 实时查询条件
+ */
+struct LiveQuerySpec {
+  QString where;             ///< 过滤条件（SQL表达式，可含?占位符；空为全部）
+  QVariantList params;       ///< 过滤条件的绑定参数
+  QString orderBy;           ///< 排序列（须为表中的列；为空按id）
+  bool ascending = true;     ///< 是否升序
+  int limit = 0;             ///< 最多返回行数（<=0 不限）
+  int queueCapacity = 4096;  ///< 变更队列容量（事务数；溢出后整体重载）
+};
+
+/**
+ * @brief 行级差异类型
+ */
+enum class LiveChangeKind {
+  INSERTED = 0,  ///< 在 index 处插入
+  UPDATED = 1,   ///< index 处的行内容变化
+  REMOVED = 2,   ///< 删除 index 处的行
+  MOVED = 3      ///< 从 fromIndex 取出后插入到 index（同 QList::move）
+};
+
+/**
+ * @brief 单条行级差异
+ * 一批差异须按顺序依次应用，每条的下标都基于应用完前一条后的列表
+ */
+template <typename T>
+struct LiveRowChange {
+  LiveChangeKind kind = LiveChangeKind::UPDATED;  ///< 差异类型
+  int id = 0;                                     ///< 行ID
+  int index = -1;                                 ///< 目标位置
+  int fromIndex = -1;                             ///< 原位置（仅MOVED）
+  T row;                                          ///< 新内容（插入/更新）
+};
+
+/**
+ * @brief 实时查询
+ * 订阅表所在库的变更流：每批变更只对受影响的rowid重新求值过滤条件
+ * 与排序键（一条 id IN (...) 查询），再经 BaseTable::selectByIds 重读
+ * 命中的行，据此在内存中维护有序结果窗口并产生行级差异；不重跑整条
+ * 查询。窗口因删除或移出而不足 limit 时，以窗口末行为键集游标补齐。
+ * 整表变化（RESET）时重新加载一次并与旧结果比对。订阅队列满时丢弃
+ * 新变更而不阻塞提交线程；消费时发现订阅有过丢弃，同样整体重新加载，
+ * 丢失的增量因此不会让结果永久偏离。
+ *
+ * 排序比较按 SQLite 的 BINARY 规则在内存中进行（NULL < 数值 < 文本 <
+ * BLOB），排序列不应声明其他排序规则。回调在订阅的消费线程中调用，
+ * 不得在回调中 stop() 或析构本对象；表对象须比实时查询活得久。
+ * 非 sqlite_native 构建下变更来自表类写入信号，批量写入的行可能在
+ * 提交前被求值而暂时缺失，直到该行再次变化。
+ * @tparam T 数据实体类型
+ */
+template <typename T>
+class LiveQuery {
+ public:
+  /// 差异回调：在订阅的消费线程中调用
+  using Callback = std::function<void(const QVector<LiveRowChange<T>>&)>;
+
+  /**
+   * @brief 构造函数（调用 start() 后才开始订阅）
+   * @param table 表对象
+   * @param spec 查询条件
+   * @param callback 差异回调
+   */
+  LiveQuery(BaseTable<T>* table, const LiveQuerySpec& spec, Callback callback)
+      : m_table(table), m_spec(spec), m_callback(std::move(callback)) {}
+
+  ~LiveQuery() { stop(); }
+
+  LiveQuery(const LiveQuery&) = delete;
+  LiveQuery& operator=(const LiveQuery&) = delete;
+
+  /**
+   * @brief 订阅变更并加载初始结果
+   * 先订阅后加载，加载期间到达的变更在加载完成后照常求值
+   * @return 操作结果，包含初始结果
+   */
+  DbResult<QList<T>> start() {
+    BaseTableOperations* ops = m_table ? m_table->baseOperations() : nullptr;
+    if (!ops) return DbResult<QList<T>>::Error("表未初始化或已释放");
+    ChangeFeed* feed = ops->changeFeed();
+    if (!feed) return DbResult<QList<T>>::Error("表未关联变更流（需连接池）");
+
+    QString error;
+    if (!m_spec.orderBy.isEmpty() && !columnExists(m_spec.orderBy, &error)) {
+      return DbResult<QList<T>>::Error(
+          error.isEmpty() ? QString("无效的排序列: %1").arg(m_spec.orderBy)
+                          : error);
+    }
+
+    quint64 subscription = 0;
+    QList<T> rows;
+    {
+      QMutexLocker locker(&m_mutex);
+      if (m_subscription) return DbResult<QList<T>>::Error("实时查询已启动");
+      m_keyColumn = m_spec.orderBy.isEmpty() ? "id" : m_spec.orderBy;
+
+      ChangeFeed::SubscribeOptions options;
+      options.tables = {ops->tableName()};
+      options.capacity = m_spec.queueCapacity;
+      m_droppedSeen = 0;
+      subscription = feed->subscribe(
+          [this](QVector<ChangeTransaction>& batch) {
+            onChanges(batch);
+            return true;
+          },
+          options);
+
+      QVector<Entry> entries;
+      if (loadWindow(&entries, &error)) {
+        m_entries = entries;
+        m_feed = feed;
+        m_subscription = subscription;
+        m_started = true;
+        subscription = 0;
+        for (const Entry& e : m_entries) rows.append(e.row);
+      }
+    }
+
+    // 加载失败：已释放锁，消费线程可正常退出
+    if (subscription) {
+      feed->unsubscribe(subscription);
+      return DbResult<QList<T>>::Error(error);
+    }
+    return DbResult<QList<T>>::Success(std::move(rows));
+  }
+
+  /**
+   * @brief 取消订阅（已入队的变更被丢弃，不再回调）
+   */
+  void stop() {
+    ChangeFeed* feed = nullptr;
+    quint64 subscription = 0;
+    {
+      QMutexLocker locker(&m_mutex);
+      m_started = false;
+      feed = m_feed;
+      subscription = m_subscription;
+      m_feed = nullptr;
+      m_subscription = 0;
+    }
+    if (feed && subscription) feed->unsubscribe(subscription);
+  }
+
+  /**
+   * @brief 等待调用前已发布的变更处理完毕（含回调）
+   * @param timeoutMs 最长等待时间（毫秒）
+   * @return 是否在超时前处理完毕
+   */
+  bool flush(int timeoutMs = 5000) {
+    ChangeFeed* feed = nullptr;
+    quint64 subscription = 0;
+    {
+      QMutexLocker locker(&m_mutex);
+      feed = m_feed;
+      subscription = m_subscription;
+    }
+    return feed && subscription ? feed->flush(subscription, timeoutMs) : false;
+  }
+
+  /**
+   * @brief 当前结果
+   * @return 与已回调的全部差异一致的结果列表
+   */
+  QList<T> snapshot() const {
+    QMutexLocker locker(&m_mutex);
+    QList<T> rows;
+    rows.reserve(m_entries.size());
+    for (const Entry& e : m_entries) rows.append(e.row);
+    return rows;
+  }
+
+  bool isActive() const {
+    QMutexLocker locker(&m_mutex);
+    return m_started;
+  }
+
+ private:
+  struct Entry {
+    int id = 0;
+    QVariant key;
+    T row;
+  };
+
+  // ==========================================================================
+  // 变更处理
+  // ==========================================================================
+
+  void onChanges(const QVector<ChangeTransaction>& batch) {
+    QSet<int> affected;
+    bool reset = false;
+    for (const ChangeTransaction& tx : batch) {
+      for (const ChangeEvent& e : tx.changes) {
+        if (e.op == ChangeOp::RESET) {
+          reset = true;
+        } else {
+          affected.insert(static_cast<int>(e.rowid));
+        }
+      }
+    }
+
+    QVector<LiveRowChange<T>> diff;
+    {
+      QMutexLocker locker(&m_mutex);
+      if (!m_started) return;
+      // 队列溢出丢弃过变更：增量无从补回，整体重新加载一次
+      const quint64 dropped = m_feed->subscriptionStats(m_subscription).dropped;
+      if (dropped != m_droppedSeen) {
+        m_droppedSeen = dropped;
+        reset = true;
+      }
+      QString error;
+      const bool ok = reset ? reload(&diff, &error)
+                            : applyAffected(affected, &diff, &error);
+      if (!ok) qWarning() << "实时查询求值失败:" << error;
+    }
+    if (!diff.isEmpty() && m_callback) m_callback(diff);
+  }
+
+  /**
+   * @brief 只对受影响的行重新求值并更新窗口（持 m_mutex）
+   */
+  bool applyAffected(const QSet<int>& affected,
+                     QVector<LiveRowChange<T>>* diff, QString* error) {
+    if (affected.isEmpty()) return true;
+
+    QList<int> ids = affected.values();
+    std::sort(ids.begin(), ids.end());
+
+    // 同 TableQuery::whereIn：ID 作为绑定参数，每批不超过 IN 上限，
+    // 占位符个数补齐到 2 的幂（重复最后一个ID），语句只有有限几种形状
+    QVector<Entry> matched;
+    for (int begin = 0; begin < ids.size();
+         begin += TableQuery::kMaxInValues) {
+      const int end = qMin(begin + TableQuery::kMaxInValues, ids.size());
+      int bucket = 1;
+      while (bucket < end - begin) bucket <<= 1;
+      QStringList marks;
+      QVariantList params;
+      params.reserve(bucket + m_spec.params.size());
+      for (int i = 0; i < bucket; ++i) {
+        marks << "?";
+        params << ids.at(qMin(begin + i, end - 1));
+      }
+      params << m_spec.params;
+
+      QString sql = selectClause() + " WHERE id IN (" + marks.join(", ") + ")";
+      if (!m_spec.where.isEmpty()) sql += " AND (" + m_spec.where + ")";
+      if (!queryKeys(sql, params, &matched, error)) return false;
+    }
+    if (!fetchRows(&matched, error)) return false;
+
+    QHash<int, Entry> matchedById;
+    for (const Entry& e : matched) matchedById.insert(e.id, e);
+
+    for (int id : ids) {
+      const int oldIndex = indexOf(id);
+      if (oldIndex >= 0) m_entries.remove(oldIndex);
+
+      const auto it = matchedById.constFind(id);
+      if (it == matchedById.constEnd()) {
+        if (oldIndex >= 0) append(diff, LiveChangeKind::REMOVED, id, oldIndex);
+        continue;
+      }
+
+      // 落在窗口之后：窗口外可能还有更靠前的行，交给补齐按序取回
+      const int pos = lowerBound(*it);
+      if ((m_spec.limit > 0 && pos >= m_spec.limit) ||
+          (m_hasMore && pos == m_entries.size())) {
+        m_hasMore = true;
+        if (oldIndex >= 0) append(diff, LiveChangeKind::REMOVED, id, oldIndex);
+        continue;
+      }
+
+      m_entries.insert(pos, *it);
+      if (oldIndex < 0) {
+        append(diff, LiveChangeKind::INSERTED, id, pos, -1, &it->row);
+      } else {
+        if (oldIndex != pos) {
+          append(diff, LiveChangeKind::MOVED, id, pos, oldIndex);
+        }
+        append(diff, LiveChangeKind::UPDATED, id, pos, -1, &it->row);
+      }
+
+      if (m_spec.limit > 0 && m_entries.size() > m_spec.limit) {
+        const Entry last = m_entries.takeLast();
+        append(diff, LiveChangeKind::REMOVED, last.id, m_entries.size());
+        m_hasMore = true;
+      }
+    }
+
+    return backfill(diff, error);
+  }
+
+  /**
+   * @brief 窗口不足 limit 时从末行之后补齐（持 m_mutex）
+   */
+  bool backfill(QVector<LiveRowChange<T>>* diff, QString* error) {
+    if (m_spec.limit <= 0 || !m_hasMore || m_entries.size() >= m_spec.limit) {
+      return true;
+    }
+    const int need = m_spec.limit - m_entries.size();
+
+    QStringList conditions;
+    QVariantList params;
+    if (!m_spec.where.isEmpty()) {
+      conditions.append("(" + m_spec.where + ")");
+      params = m_spec.params;
+    }
+    if (!m_entries.isEmpty()) {
+      const Entry& last = m_entries.last();
+      const QString& k = m_keyColumn;
+      // SQLite 中 NULL 最小：升序排在最前，降序排在最后
+      if (last.key.isNull()) {
+        conditions.append(
+            m_spec.ascending
+                ? QString("((%1 IS NULL AND id > ?) OR %1 IS NOT NULL)").arg(k)
+                : QString("(%1 IS NULL AND id < ?)").arg(k));
+        params << last.id;
+      } else {
+        conditions.append(
+            m_spec.ascending
+                ? QString("(%1 > ? OR (%1 = ? AND id > ?))").arg(k)
+                : QString("(%1 < ? OR (%1 = ? AND id < ?) OR %1 IS NULL)")
+                      .arg(k));
+        params << last.key << last.key << last.id;
+      }
+    }
+
+    QString sql = selectClause();
+    if (!conditions.isEmpty()) sql += " WHERE " + conditions.join(" AND ");
+    sql += " " + orderClause() + QString(" LIMIT %1").arg(need + 1);
+
+    QVector<Entry> more;
+    if (!queryKeys(sql, params, &more, error)) return false;
+    m_hasMore = more.size() > need;
+    if (m_hasMore) more.resize(need);
+    if (!fetchRows(&more, error)) return false;
+
+    for (const Entry& e : more) {
+      m_entries.append(e);
+      append(diff, LiveChangeKind::INSERTED, e.id, m_entries.size() - 1, -1,
+             &e.row);
+    }
+    return true;
+  }
+
+  /**
+   * @brief 整表重新加载并与旧窗口比对（持 m_mutex）
+   */
+  bool reload(QVector<LiveRowChange<T>>* diff, QString* error) {
+    QVector<Entry> fresh;
+    if (!loadWindow(&fresh, error)) return false;
+
+    QSet<int> freshIds;
+    for (const Entry& e : fresh) freshIds.insert(e.id);
+    for (int i = m_entries.size() - 1; i >= 0; --i) {
+      if (!freshIds.contains(m_entries[i].id)) {
+        append(diff, LiveChangeKind::REMOVED, m_entries[i].id, i);
+        m_entries.remove(i);
+      }
+    }
+
+    for (int j = 0; j < fresh.size(); ++j) {
+      const Entry& e = fresh[j];
+      const int k = indexOf(e.id);
+      if (k == j) {
+        m_entries[j] = e;
+        append(diff, LiveChangeKind::UPDATED, e.id, j, -1, &e.row);
+      } else if (k > j) {
+        m_entries.remove(k);
+        m_entries.insert(j, e);
+        append(diff, LiveChangeKind::MOVED, e.id, j, k);
+        append(diff, LiveChangeKind::UPDATED, e.id, j, -1, &e.row);
+      } else {
+        m_entries.insert(j, e);
+        append(diff, LiveChangeKind::INSERTED, e.id, j, -1, &e.row);
+      }
+    }
+    return true;
+  }
+
+  // ==========================================================================
+  // 查询辅助
+  // ==========================================================================
+
+  /**
+   * @brief 按查询条件加载完整窗口
+   */
+  bool loadWindow(QVector<Entry>* out, QString* error) {
+    QString sql = selectClause();
+    if (!m_spec.where.isEmpty()) sql += " WHERE (" + m_spec.where + ")";
+    sql += " " + orderClause();
+    if (m_spec.limit > 0) sql += QString(" LIMIT %1").arg(m_spec.limit + 1);
+
+    if (!queryKeys(sql, m_spec.params, out, error)) return false;
+    m_hasMore = m_spec.limit > 0 && out->size() > m_spec.limit;
+    if (m_hasMore) out->resize(m_spec.limit);
+    return fetchRows(out, error);
+  }
+
+  QString selectClause() const {
+    return QString("SELECT id, %1 FROM %2")
+        .arg(m_keyColumn, m_table->baseOperations()->tableName());
+  }
+
+  QString orderClause() const {
+    return QString("ORDER BY %1 %2, id %2")
+        .arg(m_keyColumn, m_spec.ascending ? "ASC" : "DESC");
+  }
+
+  /**
+   * @brief 执行只取 id 与排序键的查询（表锁只在本函数内持有）
+   */
+  bool queryKeys(const QString& sql, const QVariantList& params,
+                 QVector<Entry>* out, QString* error) const {
+    BaseTableOperations* ops = m_table->baseOperations();
+    if (!ops) {
+      *error = "表未初始化或已释放";
+      return false;
+    }
+    auto c = ops->acquireDb();
+    if (!c.db.isOpen()) {
+      *error = "数据库未打开";
+      return false;
+    }
+
+    ProfiledMutexLocker locker(&ops->m_mutex, DB_LOCK_SITE);
+    QSqlQuery query(c.db);
+    query.setForwardOnly(true);
+    if (!query.prepare(sql)) {
+      *error = QString("实时查询语句无效: %1").arg(query.lastError().text());
+      return false;
+    }
+    for (const QVariant& p : params) query.addBindValue(p);
+    if (!SqlExec::run(query)) {
+      *error = QString("实时查询执行失败: %1").arg(query.lastError().text());
+      return false;
+    }
+    while (query.next()) {
+      Entry e;
+      e.id = query.value(0).toInt();
+      e.key = query.value(1);
+      out->append(e);
+    }
+    return true;
+  }
+
+  /**
+   * @brief 读取整行；两次查询之间被删除的行从列表中剔除
+   */
+  bool fetchRows(QVector<Entry>* entries, QString* error) {
+    if (entries->isEmpty()) return true;
+    QList<int> ids;
+    ids.reserve(entries->size());
+    for (const Entry& e : *entries) ids.append(e.id);
+
+    const DbResult<QHash<int, T>> r = m_table->selectByIds(ids);
+    if (!r.success) {
+      *error = r.errorMessage;
+      return false;
+    }
+
+    QVector<Entry> kept;
+    kept.reserve(entries->size());
+    for (Entry& e : *entries) {
+      const auto it = r.data.constFind(e.id);
+      if (it == r.data.constEnd()) {
+        m_hasMore = m_spec.limit > 0;
+        continue;
+      }
+      e.row = *it;
+      kept.append(std::move(e));
+    }
+    entries->swap(kept);
+    return true;
+  }
+
+  bool columnExists(const QString& column, QString* error) const {
+    BaseTableOperations* ops = m_table->baseOperations();
+    auto c = ops->acquireDb();
+    if (!c.db.isOpen()) {
+      *error = "数据库未打开";
+      return false;
+    }
+    ProfiledMutexLocker locker(&ops->m_mutex, DB_LOCK_SITE);
+    QSqlQuery query(c.db);
+    if (!query.exec(QString("PRAGMA table_info(%1)").arg(ops->tableName()))) {
+      *error = QString("读取表结构失败: %1").arg(query.lastError().text());
+      return false;
+    }
+    while (query.next()) {
+      if (query.value(1).toString() == column) return true;
+    }
+    return false;
+  }
+
+  // ==========================================================================
+  // 窗口辅助
+  // ==========================================================================
+
+  int indexOf(int id) const {
+    for (int i = 0; i < m_entries.size(); ++i) {
+      if (m_entries[i].id == id) return i;
+    }
+    return -1;
+  }
+
+  int lowerBound(const Entry& e) const {
+    const auto it = std::lower_bound(
+        m_entries.begin(), m_entries.end(), e,
+        [this](const Entry& a, const Entry& b) { return before(a, b); });
+    return static_cast<int>(it - m_entries.begin());
+  }
+
+  /// a 是否排在 b 之前（排序键相同按 id，降序整体反转）
+  bool before(const Entry& a, const Entry& b) const {
+    int cmp = compareKeys(a.key, b.key);
+    if (cmp == 0) cmp = a.id < b.id ? -1 : (a.id > b.id ? 1 : 0);
+    return m_spec.ascending ? cmp < 0 : cmp > 0;
+  }
+
+  /// 按 SQLite BINARY 规则比较：NULL < 数值 < 文本 < BLOB
+  static int compareKeys(const QVariant& a, const QVariant& b) {
+    const int ra = typeRank(a);
+    const int rb = typeRank(b);
+    if (ra != rb) return ra < rb ? -1 : 1;
+    switch (ra) {
+      case 0:
+        return 0;
+      case 1: {
+        if (isInteger(a) && isInteger(b)) {
+          const qlonglong x = a.toLongLong();
+          const qlonglong y = b.toLongLong();
+          return x < y ? -1 : (x > y ? 1 : 0);
+        }
+        const double x = a.toDouble();
+        const double y = b.toDouble();
+        return x < y ? -1 : (x > y ? 1 : 0);
+      }
+      case 2: {
+        const QByteArray x = a.toString().toUtf8();
+        const QByteArray y = b.toString().toUtf8();
+        return x < y ? -1 : (y < x ? 1 : 0);
+      }
+      default: {
+        const QByteArray x = a.toByteArray();
+        const QByteArray y = b.toByteArray();
+        return x < y ? -1 : (y < x ? 1 : 0);
+      }
+    }
+  }
+
+  static int typeRank(const QVariant& v) {
+    if (v.isNull()) return 0;
+    switch (v.userType()) {
+      case QMetaType::QString:
+        return 2;
+      case QMetaType::QByteArray:
+        return 3;
+      default:
+        return 1;
+    }
+  }
+
+  static bool isInteger(const QVariant& v) {
+    switch (v.userType()) {
+      case QMetaType::Int:
+      case QMetaType::UInt:
+      case QMetaType::LongLong:
+      case QMetaType::ULongLong:
+      case QMetaType::Bool:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  static void append(QVector<LiveRowChange<T>>* diff, LiveChangeKind kind,
+                     int id, int index, int fromIndex = -1,
+                     const T* row = nullptr) {
+    LiveRowChange<T> change;
+    change.kind = kind;
+    change.id = id;
+    change.index = index;
+    change.fromIndex = fromIndex;
+    if (row) change.row = *row;
+    diff->append(std::move(change));
+  }
+
+  BaseTable<T>* m_table;  ///< 表对象（不拥有）
+  LiveQuerySpec m_spec;   ///< 查询条件
+  Callback m_callback;    ///< 差异回调
+  QString m_keyColumn;    ///< 实际排序列（未指定时为id）
+
+  mutable QMutex m_mutex;        ///< 保护窗口与订阅状态
+  QVector<Entry> m_entries;      ///< 当前结果窗口（按排序键、id有序）
+  bool m_hasMore = false;        ///< 窗口之后是否可能还有命中行
+  bool m_started = false;        ///< 是否已加载初始结果
+  ChangeFeed* m_feed = nullptr;  ///< 变更流（不拥有）
+  quint64 m_subscription = 0;    ///< 订阅ID
+  quint64 m_droppedSeen = 0;     ///< 已处理过的队列丢弃数
+};
+
+#endif  // LIVE_QUERY_H
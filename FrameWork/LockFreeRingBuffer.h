@@ -0,0 +1,137 @@
+﻿// LockFreeRingBuffer.h - 有界无锁环形队列
+#ifndef LOCK_FREE_RING_BUFFER_H
+#define LOCK_FREE_RING_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+/**
+ * @brief 有界多生产者/多消费者无锁环形队列
+ * 基于每个槽位的序号实现（Vyukov 算法），入队与出队均为无锁操作，
+ * 不做任何内存分配。容量在构造时向上取整为 2 的幂。
+ * @tparam T 元素类型（需可默认构造、可移动赋值）
+ */
+template <typename T>
+class LockFreeRingBuffer {
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence{0};  ///< 槽位序号
+    T value;                          ///< 槽位数据
+  };
+
+  static constexpr size_t kCacheLine = 64;
+
+  std::unique_ptr<Cell[]> m_cells;  ///< 槽位数组
+  size_t m_mask = 0;                ///< 容量掩码
+  alignas(kCacheLine) std::atomic<size_t> m_enqueuePos{0};  ///< 入队位置
+  alignas(kCacheLine) std::atomic<size_t> m_dequeuePos{0};  ///< 出队位置
+
+  static size_t roundUpToPowerOfTwo(size_t n) {
+    size_t v = 2;
+    while (v < n) v <<= 1;
+    return v;
+  }
+
+ public:
+  /**
+   * @brief 构造函数
+   * @param capacity 期望容量（向上取整为 2 的幂）
+   */
+  explicit LockFreeRingBuffer(size_t capacity) {
+    const size_t size = roundUpToPowerOfTwo(capacity);
+    m_cells.reset(new Cell[size]);
+    m_mask = size - 1;
+    for (size_t i = 0; i < size; ++i) {
+      m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  LockFreeRingBuffer(const LockFreeRingBuffer&) = delete;
+  LockFreeRingBuffer& operator=(const LockFreeRingBuffer&) = delete;
+
+  /**
+   * @brief 尝试入队
+   * @param item 元素（成功时被移走）
+   * @return 队列已满时返回false
+   */
+  bool tryPush(T&& item) {
+    Cell* cell = nullptr;
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+      cell = &m_cells[pos & m_mask];
+      const size_t seq = cell->sequence.load(std::memory_order_acquire);
+      const intptr_t diff =
+          static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (m_enqueuePos.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;  // 已满
+      } else {
+        pos = m_enqueuePos.load(std::memory_order_relaxed);
+      }
+    }
+    cell->value = std::move(item);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief 尝试出队
+   * @param out 输出元素
+   * @return 队列为空时返回false
+   */
+  bool tryPop(T& out) {
+    Cell* cell = nullptr;
+    size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+    for (;;) {
+      cell = &m_cells[pos & m_mask];
+      const size_t seq = cell->sequence.load(std::memory_order_acquire);
+      const intptr_t diff =
+          static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (m_dequeuePos.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;  // 为空
+      } else {
+        pos = m_dequeuePos.load(std::memory_order_relaxed);
+      }
+    }
+    out = std::move(cell->value);
+    cell->value = T();  // 及时释放槽位持有的资源
+    cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief 获取容量
+   * @return 槽位数量
+   */
+  size_t capacity() const { return m_mask + 1; }
+
+  /**
+   * @brief 获取近似元素数量（并发下仅供参考）
+   * @return 元素数量
+   */
+  size_t sizeApprox() const {
+    const size_t enq = m_enqueuePos.load(std::memory_order_relaxed);
+    const size_t deq = m_dequeuePos.load(std::memory_order_relaxed);
+    return enq >= deq ? enq - deq : 0;
+  }
+
+  /**
+   * @brief 队列是否为空（并发下仅供参考）
+   * @return 是否为空
+   */
+  bool emptyApprox() const { return sizeApprox() == 0; }
+};
+
+#endif  // LOCK_FREE_RING_BUFFER_H
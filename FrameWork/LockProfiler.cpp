@@ -0,0 +1,338 @@
+﻿// LockProfiler.cpp - 框架互斥锁的争用剖析实现
+#include "LockProfiler.h"
+
+#include <QHash>
+#include <QJsonObject>
+#include <QMap>
+#include <QPair>
+#include <QTextStream>
+#include <QVector>
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+constexpr int kBuckets = 48;   // 按纳秒数的二进制位数分桶（0 号桶为零等待）
+constexpr int kMaxSites = 64;  // 每把锁记录的加锁位置数（2 的幂）
+
+qint64 nowNs() {
+  using Clock = std::chrono::steady_clock;
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             Clock::now().time_since_epoch())
+      .count();
+}
+
+int bucketOf(quint64 ns) {
+  int b = 0;
+  while (ns && b < kBuckets - 1) {
+    ns >>= 1;
+    ++b;
+  }
+  return b;
+}
+
+void atomicMax(std::atomic<quint64>& target, quint64 value) {
+  quint64 seen = target.load(std::memory_order_relaxed);
+  while (value > seen &&
+         !target.compare_exchange_weak(seen, value,
+                                       std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace
+
+/**
+ * @brief 同名锁的合并统计（创建后常驻，不释放）
+ * 全部为原子计数，记录路径不加锁
+ */
+struct LockProfile {
+  /// 单个加锁位置的计数
+  struct Site {
+    std::atomic<const char*> site{nullptr};
+    std::atomic<quint64> count{0};
+    std::atomic<quint64> contended{0};
+    std::atomic<quint64> waitNs{0};
+    std::atomic<quint64> holdNs{0};
+  };
+
+  QString name;
+  std::atomic<int> instances{0};
+  std::atomic<quint64> acquisitions{0};
+  std::atomic<quint64> contended{0};
+  std::atomic<quint64> waitNs{0};
+  std::atomic<quint64> holdNs{0};
+  std::atomic<quint64> maxWaitNs{0};
+  std::atomic<quint64> maxHoldNs{0};
+  std::atomic<quint64> unattributed{0};  ///< 位置槽位用尽后的加锁次数
+  std::atomic<quint64> waitBuckets[kBuckets] = {};
+  std::atomic<quint64> holdBuckets[kBuckets] = {};
+  Site sites[kMaxSites];
+
+  int siteSlot(const char* site) {
+    if (!site) return -1;
+    const uint h = qHash(reinterpret_cast<quintptr>(site));
+    for (int i = 0; i < kMaxSites; ++i) {
+      Site& s = sites[(h + i) & (kMaxSites - 1)];
+      const char* cur = s.site.load(std::memory_order_acquire);
+      if (cur == site) return (h + i) & (kMaxSites - 1);
+      if (!cur && (s.site.compare_exchange_strong(cur, site) || cur == site)) {
+        return (h + i) & (kMaxSites - 1);
+      }
+    }
+    return -1;
+  }
+};
+
+namespace {
+
+struct ProfileRegistry {
+  QMutex mutex;
+  QHash<QString, LockProfile*> byName;
+};
+
+ProfileRegistry& profiles() {
+  static ProfileRegistry r;
+  return r;
+}
+
+QList<LockProfile*> allProfiles() {
+  ProfileRegistry& r = profiles();
+  QMutexLocker locker(&r.mutex);
+  return r.byName.values();
+}
+
+// 分桶的上界作为分位数的估计
+quint64 percentileNs(const std::atomic<quint64>* buckets, double p) {
+  quint64 total = 0;
+  quint64 counts[kBuckets];
+  for (int i = 0; i < kBuckets; ++i) {
+    counts[i] = buckets[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  if (total == 0) return 0;
+  const quint64 rank = qMax<quint64>(1, static_cast<quint64>(p * total + 0.5));
+  quint64 seen = 0;
+  for (int i = 0; i < kBuckets; ++i) {
+    seen += counts[i];
+    if (seen >= rank) return i == 0 ? 0 : (1ULL << i) - 1;
+  }
+  return 0;
+}
+
+QJsonObject timing(quint64 totalNs, quint64 maxNs,
+                   const std::atomic<quint64>* buckets) {
+  QJsonObject o;
+  o["totalNs"] = static_cast<qint64>(totalNs);
+  o["maxNs"] = static_cast<qint64>(maxNs);
+  o["p50Ns"] = static_cast<qint64>(percentileNs(buckets, 0.50));
+  o["p90Ns"] = static_cast<qint64>(percentileNs(buckets, 0.90));
+  o["p99Ns"] = static_cast<qint64>(percentileNs(buckets, 0.99));
+  QJsonArray histogram;
+  for (int i = 0; i < kBuckets; ++i) {
+    histogram.append(
+        static_cast<qint64>(buckets[i].load(std::memory_order_relaxed)));
+  }
+  // 第 i 个元素为落在 [2^(i-1), 2^i) 纳秒内的次数，末尾的零已截去
+  while (!histogram.isEmpty() && histogram.last().toDouble() == 0) {
+    histogram.removeLast();
+  }
+  o["log2Histogram"] = histogram;
+  return o;
+}
+
+QString siteText(const char* site) {
+  const QString s = QString::fromLatin1(site);
+  const int slash = qMax(s.lastIndexOf('/'), s.lastIndexOf('\\'));
+  return s.mid(slash + 1);
+}
+
+}  // namespace
+
+// ---- LockProfiler ----
+
+void LockProfiler::setEnabled(bool enabled) {
+  s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void LockProfiler::reset() {
+  for (LockProfile* p : allProfiles()) {
+    p->acquisitions.store(0);
+    p->contended.store(0);
+    p->waitNs.store(0);
+    p->holdNs.store(0);
+    p->maxWaitNs.store(0);
+    p->maxHoldNs.store(0);
+    p->unattributed.store(0);
+    for (int i = 0; i < kBuckets; ++i) {
+      p->waitBuckets[i].store(0);
+      p->holdBuckets[i].store(0);
+    }
+    for (LockProfile::Site& s : p->sites) {
+      s.count.store(0);
+      s.contended.store(0);
+      s.waitNs.store(0);
+      s.holdNs.store(0);
+    }
+  }
+}
+
+QJsonArray LockProfiler::report(int topSites) {
+  QList<LockProfile*> list = allProfiles();
+  std::sort(list.begin(), list.end(), [](LockProfile* a, LockProfile* b) {
+    return a->waitNs.load() > b->waitNs.load();
+  });
+
+  QJsonArray locks;
+  for (LockProfile* p : list) {
+    const quint64 acquisitions = p->acquisitions.load();
+    if (acquisitions == 0) continue;
+
+    // 同一位置可能因编译单元不同而有多个字面量地址，按文本合并
+    struct SiteSum {
+      quint64 count = 0, contended = 0, waitNs = 0, holdNs = 0;
+    };
+    QMap<QString, SiteSum> bySite;
+    for (const LockProfile::Site& s : p->sites) {
+      const char* site = s.site.load(std::memory_order_acquire);
+      if (!site || s.count.load() == 0) continue;
+      SiteSum& sum = bySite[siteText(site)];
+      sum.count += s.count.load();
+      sum.contended += s.contended.load();
+      sum.waitNs += s.waitNs.load();
+      sum.holdNs += s.holdNs.load();
+    }
+    QList<QPair<QString, SiteSum>> sites;
+    for (auto it = bySite.constBegin(); it != bySite.constEnd(); ++it) {
+      sites.append({it.key(), it.value()});
+    }
+    std::sort(sites.begin(), sites.end(), [](const auto& a, const auto& b) {
+      return a.second.waitNs != b.second.waitNs
+                 ? a.second.waitNs > b.second.waitNs
+                 : a.second.holdNs > b.second.holdNs;
+    });
+
+    QJsonArray top;
+    for (int i = 0; i < sites.size() && i < topSites; ++i) {
+      QJsonObject s;
+      s["site"] = sites[i].first;
+      s["acquisitions"] = static_cast<qint64>(sites[i].second.count);
+      s["contended"] = static_cast<qint64>(sites[i].second.contended);
+      s["waitNs"] = static_cast<qint64>(sites[i].second.waitNs);
+      s["holdNs"] = static_cast<qint64>(sites[i].second.holdNs);
+      top.append(s);
+    }
+
+    const quint64 contended = p->contended.load();
+    QJsonObject o;
+    o["name"] = p->name;
+    o["instances"] = p->instances.load();
+    o["acquisitions"] = static_cast<qint64>(acquisitions);
+    o["contended"] = static_cast<qint64>(contended);
+    o["contentionRate"] = static_cast<double>(contended) / acquisitions;
+    o["wait"] = timing(p->waitNs.load(), p->maxWaitNs.load(), p->waitBuckets);
+    o["hold"] = timing(p->holdNs.load(), p->maxHoldNs.load(), p->holdBuckets);
+    o["topSites"] = top;
+    o["unattributed"] = static_cast<qint64>(p->unattributed.load());
+    locks.append(o);
+  }
+  return locks;
+}
+
+QString LockProfiler::summary() {
+  QString text;
+  QTextStream out(&text);
+  out << QString("%1 %2 %3 %4 %5 %6\n")
+             .arg("lock", -40)
+             .arg("acquire", 10)
+             .arg("contended", 10)
+             .arg("wait(ms)", 10)
+             .arg("hold(ms)", 10)
+             .arg("p99hold(us)", 12);
+  for (const QJsonValue& v : report(1)) {
+    const QJsonObject o = v.toObject();
+    const QJsonObject wait = o["wait"].toObject();
+    const QJsonObject hold = o["hold"].toObject();
+    out << QString("%1 %2 %3 %4 %5 %6\n")
+               .arg(o["name"].toString(), -40)
+               .arg(static_cast<qint64>(o["acquisitions"].toDouble()), 10)
+               .arg(static_cast<qint64>(o["contended"].toDouble()), 10)
+               .arg(wait["totalNs"].toDouble() / 1e6, 10, 'f', 2)
+               .arg(hold["totalNs"].toDouble() / 1e6, 10, 'f', 2)
+               .arg(hold["p99Ns"].toDouble() / 1e3, 12, 'f', 1);
+    const QJsonArray top = o["topSites"].toArray();
+    if (!top.isEmpty()) {
+      out << "    最多等待: " << top.first().toObject()["site"].toString()
+          << '\n';
+    }
+  }
+  out.flush();
+  return text;
+}
+
+// ---- ProfiledMutex ----
+
+ProfiledMutex::ProfiledMutex(const QString& name) {
+  ProfileRegistry& r = profiles();
+  QMutexLocker locker(&r.mutex);
+  LockProfile*& p = r.byName[name];
+  if (!p) {
+    p = new LockProfile();
+    p->name = name;
+  }
+  p->instances.fetch_add(1);
+  m_profile = p;
+}
+
+ProfiledMutex::~ProfiledMutex() { m_profile->instances.fetch_sub(1); }
+
+QString ProfiledMutex::name() const { return m_profile->name; }
+
+void ProfiledMutex::lockProfiled(const char* site) {
+  const int slot = m_profile->siteSlot(site);
+  quint64 waitNs = 0;
+  const bool contended = !m_mutex.tryLock();
+  if (contended) {
+    const qint64 begin = nowNs();
+    m_mutex.lock();
+    waitNs = static_cast<quint64>(nowNs() - begin);
+  }
+  m_profiled = true;
+  m_siteSlot = slot;
+  m_acquiredNs = nowNs();
+
+  LockProfile* p = m_profile;
+  p->acquisitions.fetch_add(1, std::memory_order_relaxed);
+  p->waitBuckets[contended ? bucketOf(waitNs) : 0].fetch_add(
+      1, std::memory_order_relaxed);
+  if (contended) {
+    p->contended.fetch_add(1, std::memory_order_relaxed);
+    p->waitNs.fetch_add(waitNs, std::memory_order_relaxed);
+    atomicMax(p->maxWaitNs, waitNs);
+  }
+  if (slot < 0) {
+    p->unattributed.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  LockProfile::Site& s = p->sites[slot];
+  s.count.fetch_add(1, std::memory_order_relaxed);
+  if (contended) {
+    s.contended.fetch_add(1, std::memory_order_relaxed);
+    s.waitNs.fetch_add(waitNs, std::memory_order_relaxed);
+  }
+}
+
+void ProfiledMutex::unlockProfiled() {
+  // 先取出持有者字段再解锁，解锁后可能立即被其他线程改写
+  const quint64 holdNs = static_cast<quint64>(nowNs() - m_acquiredNs);
+  const int slot = m_siteSlot;
+  m_profiled = false;
+  m_mutex.unlock();
+
+  LockProfile* p = m_profile;
+  p->holdNs.fetch_add(holdNs, std::memory_order_relaxed);
+  p->holdBuckets[bucketOf(holdNs)].fetch_add(1, std::memory_order_relaxed);
+  atomicMax(p->maxHoldNs, holdNs);
+  if (slot >= 0) {
+    p->sites[slot].holdNs.fetch_add(holdNs, std::memory_order_relaxed);
+  }
+}
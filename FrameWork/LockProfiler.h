@@ -0,0 +1,155 @@
+﻿// LockProfiler.h - 框架互斥锁的争用剖析
+#ifndef LOCK_PROFILER_H
+#define LOCK_PROFILER_H
+
+#include <QJsonArray>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+
+struct LockProfile;
+
+/**
+ * @brief 互斥锁争用剖析器
+ * 统计各 ProfiledMutex 的加锁次数、争用次数、等待与持有时间直方图，
+ * 以及等待时间最多的加锁位置。同名的锁（如多个库的同类连接池锁）
+ * 合并统计。默认关闭，可在运行中随时开启、清零与导出。
+ */
+class LockProfiler {
+ public:
+  /**
+   * @brief 是否正在统计
+   */
+  static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief 开启或关闭统计（已有数据保留到 reset）
+   * @param enabled 是否统计
+   */
+  static void setEnabled(bool enabled);
+
+  /**
+   * @brief 清零全部统计（并发加锁时可能漏计少量样本）
+   */
+  static void reset();
+
+  /**
+   * @brief 导出报告，按总等待时间降序
+   * 每项含 name、instances、acquisitions、contended、wait/hold 的
+   * 总计、最大值与分位数（纳秒），以及 topSites
+   * @param topSites 每把锁列出的加锁位置数
+   * @return 各锁的统计
+   */
+  static QJsonArray report(int topSites = 5);
+
+  /**
+   * @brief 以表格形式输出摘要（便于写日志）
+   * @return 多行文本
+   */
+  static QString summary();
+
+ private:
+  static inline std::atomic<bool> s_enabled{false};
+};
+
+/**
+ * @brief 带剖析的互斥锁
+ * 用法与 QMutex 相同，但需配合 ProfiledMutexLocker 记录加锁位置。
+ * 关闭剖析时加锁与解锁各只多一次分支；开启时先 tryLock，失败才计时
+ * 等待，因此无争用的加锁不读时钟等待时间。
+ */
+class ProfiledMutex {
+ public:
+  /**
+   * @brief 构造函数
+   * @param name 统计名（同名的锁合并统计）
+   */
+  explicit ProfiledMutex(const QString& name);
+  ~ProfiledMutex();
+
+  ProfiledMutex(const ProfiledMutex&) = delete;
+  ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+  /**
+   * @brief 加锁
+   * @param site 加锁位置（字符串字面量，通常为 DB_LOCK_SITE）
+   */
+  void lock(const char* site) {
+    if (!LockProfiler::enabled()) {
+      m_mutex.lock();
+      m_profiled = false;
+      return;
+    }
+    lockProfiled(site);
+  }
+
+  /**
+   * @brief 解锁
+   */
+  void unlock() {
+    if (!m_profiled) {
+      m_mutex.unlock();
+      return;
+    }
+    unlockProfiled();
+  }
+
+  /**
+   * @brief 统计名
+   */
+  QString name() const;
+
+ private:
+  void lockProfiled(const char* site);
+  void unlockProfiled();
+
+  QMutex m_mutex;
+  LockProfile* m_profile;   ///< 同名锁共享的统计（进程内常驻）
+  bool m_profiled = false;  ///< 本次持有是否在统计（以下字段由持有者写）
+  int m_siteSlot = -1;      ///< 本次加锁位置的槽位
+  qint64 m_acquiredNs = 0;  ///< 本次取得锁的时间
+};
+
+/**
+ * @brief ProfiledMutex 的作用域守卫（接口同 QMutexLocker）
+ */
+class ProfiledMutexLocker {
+ public:
+  ProfiledMutexLocker(ProfiledMutex* mutex, const char* site)
+      : m_mutex(mutex), m_site(site) {
+    m_mutex->lock(m_site);
+    m_locked = true;
+  }
+
+  ~ProfiledMutexLocker() { unlock(); }
+
+  ProfiledMutexLocker(const ProfiledMutexLocker&) = delete;
+  ProfiledMutexLocker& operator=(const ProfiledMutexLocker&) = delete;
+
+  void unlock() {
+    if (!m_locked) return;
+    m_locked = false;
+    m_mutex->unlock();
+  }
+
+  void relock() {
+    if (m_locked) return;
+    m_mutex->lock(m_site);
+    m_locked = true;
+  }
+
+  ProfiledMutex* mutex() const { return m_mutex; }
+
+ private:
+  ProfiledMutex* m_mutex;
+  const char* m_site;
+  bool m_locked = false;
+};
+
+#define DB_LOCK_STRINGIFY_INNER(x) #x
+#define DB_LOCK_STRINGIFY(x) DB_LOCK_STRINGIFY_INNER(x)
+
+/// 当前加锁位置（"文件:行"）
+#define DB_LOCK_SITE __FILE__ ":" DB_LOCK_STRINGIFY(__LINE__)
+
+#endif  // LOCK_PROFILER_H
@@ -0,0 +1,249 @@
+﻿// MembershipIndex.cpp - 布隆过滤器与后台重建的成员索引实现
+#include "MembershipIndex.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <algorithm>
+
+namespace {
+
+/// splitmix64 终混，把散列的各位充分打散
+quint64 mix(quint64 x) {
+  x ^= x >> 30;
+  x *= Q_UINT64_C(0xbf58476d1ce4e5b9);
+  x ^= x >> 27;
+  x *= Q_UINT64_C(0x94d049bb133111eb);
+  x ^= x >> 31;
+  return x;
+}
+
+}  // namespace
+
+BloomFilter::BloomFilter(qint64 expectedKeys, int bitsPerKey) {
+  const qint64 bits = std::max<qint64>(expectedKeys, 1) * bitsPerKey;
+  m_blocks = 1;
+  while (m_blocks * kBlockBits < bits) m_blocks <<= 1;
+  // k ≈ ln2 * bitsPerKey；每个位置取 9 位，64 位散列最多 7 个
+  m_hashes = std::max(1, std::min(7, bitsPerKey * 69 / 100));
+  const qint64 words = m_blocks * kBlockWords;
+  m_words.reset(new std::atomic<quint64>[words]);
+  for (qint64 i = 0; i < words; ++i) {
+    m_words[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+quint64 BloomFilter::hash(const QString& key) {
+  // FNV-1a（按 UTF-16 码元）
+  quint64 h = Q_UINT64_C(0xcbf29ce484222325);
+  const ushort* p = key.utf16();
+  for (int i = 0; i < key.size(); ++i) {
+    h ^= p[i];
+    h *= Q_UINT64_C(0x100000001b3);
+  }
+  return mix(h);
+}
+
+void BloomFilter::add(quint64 h) {
+  std::atomic<quint64>* block =
+      &m_words[(h & static_cast<quint64>(m_blocks - 1)) * kBlockWords];
+  quint64 positions = mix(h ^ Q_UINT64_C(0x9e3779b97f4a7c15));
+  for (int i = 0; i < m_hashes; ++i, positions >>= 9) {
+    const int bit = static_cast<int>(positions & (kBlockBits - 1));
+    block[bit >> 6].fetch_or(Q_UINT64_C(1) << (bit & 63),
+                             std::memory_order_relaxed);
+  }
+}
+
+bool BloomFilter::mightContain(quint64 h) const {
+  const std::atomic<quint64>* block =
+      &m_words[(h & static_cast<quint64>(m_blocks - 1)) * kBlockWords];
+  quint64 positions = mix(h ^ Q_UINT64_C(0x9e3779b97f4a7c15));
+  for (int i = 0; i < m_hashes; ++i, positions >>= 9) {
+    const int bit = static_cast<int>(positions & (kBlockBits - 1));
+    if (!(block[bit >> 6].load(std::memory_order_relaxed) &
+          (Q_UINT64_C(1) << (bit & 63)))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+QJsonObject MembershipIndexStats::toJson() const {
+  QJsonObject o;
+  o["ready"] = ready;
+  o["enabled"] = enabled;
+  o["keys"] = keys;
+  o["capacity"] = capacity;
+  o["bits"] = bits;
+  o["lookups"] = static_cast<qint64>(lookups);
+  o["negatives"] = static_cast<qint64>(negatives);
+  o["falsePositives"] = static_cast<qint64>(falsePositives);
+  o["falsePositiveRate"] = falsePositiveRate();
+  o["rebuilds"] = rebuilds;
+  o["lastRebuildMs"] = lastRebuildMs;
+  return o;
+}
+
+class MembershipIndex::ReadGuard {
+ public:
+  explicit ReadGuard(const MembershipIndex* index) {
+    // 登记后纪元未变才算数，否则换代可能已在等另一个计数
+    for (;;) {
+      const unsigned epoch = index->m_epoch.load();
+      m_counter = &index->m_readers[epoch & 1];
+      m_counter->fetch_add(1);
+      if (index->m_epoch.load() == epoch) break;
+      m_counter->fetch_sub(1);
+    }
+  }
+  ~ReadGuard() { m_counter->fetch_sub(1, std::memory_order_release); }
+
+ private:
+  std::atomic<int>* m_counter;
+};
+
+MembershipIndex::MembershipIndex(const QString& name, CountFn count,
+                                 ScanFn scan, int bitsPerKey)
+    : m_name(name),
+      m_count(std::move(count)),
+      m_scan(std::move(scan)),
+      m_bitsPerKey(bitsPerKey) {}
+
+MembershipIndex::~MembershipIndex() { stop(); }
+
+bool MembershipIndex::mightContain(const QString& key) const {
+  if (!m_enabled.load(std::memory_order_relaxed)) return true;
+  const quint64 h = BloomFilter::hash(key);
+  {
+    ReadGuard guard(this);
+    const BloomFilter* filter = m_filter.load();
+    if (!filter) return true;
+    m_lookups.fetch_add(1, std::memory_order_relaxed);
+    if (filter->mightContain(h)) return true;
+  }
+  m_negatives.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+void MembershipIndex::add(const QString& key) {
+  const quint64 h = BloomFilter::hash(key);
+  if (m_rebuilding.load()) {
+    QMutexLocker locker(&m_pendingMutex);
+    // 重建中：另记一份，换代前补入新过滤器（换代也持此锁，可直接访问）
+    if (m_rebuilding.load()) m_pending.append(h);
+    if (BloomFilter* filter = m_filter.load()) filter->add(h);
+  } else {
+    ReadGuard guard(this);
+    BloomFilter* filter = m_filter.load();
+    if (!filter) return;
+    filter->add(h);
+  }
+  m_keys.fetch_add(1, std::memory_order_relaxed);
+  maybeRebuild();
+}
+
+void MembershipIndex::remove() {
+  if (!isReady()) return;
+  m_removed.fetch_add(1, std::memory_order_relaxed);
+  maybeRebuild();
+}
+
+void MembershipIndex::maybeRebuild() {
+  const qint64 capacity = m_capacity.load(std::memory_order_relaxed);
+  if (capacity <= 0 || m_rebuilding.load()) return;
+  if (m_keys.load(std::memory_order_relaxed) > capacity ||
+      m_removed.load(std::memory_order_relaxed) > capacity / 2) {
+    rebuildAsync();
+  }
+}
+
+bool MembershipIndex::rebuild() {
+  QMutexLocker rebuildLocker(&m_rebuildMutex);
+  QElapsedTimer timer;
+  timer.start();
+  {
+    QMutexLocker locker(&m_pendingMutex);
+    m_pending.clear();
+    m_rebuilding.store(true);
+  }
+
+  const qint64 count = m_count();
+  bool ok = count >= 0;
+  const qint64 capacity = std::max<qint64>(count * 2, 1024);
+  std::unique_ptr<BloomFilter> filter;
+  qint64 keys = 0;
+  if (ok) {
+    filter.reset(new BloomFilter(capacity, m_bitsPerKey));
+    ok = m_scan([&](const QString& key) {
+      filter->add(BloomFilter::hash(key));
+      ++keys;
+      return !m_cancel.load(std::memory_order_relaxed);
+    });
+  }
+
+  QMutexLocker locker(&m_pendingMutex);
+  if (ok) {
+    for (quint64 h : m_pending) filter->add(h);
+    keys += m_pending.size();
+    // 换上新过滤器后翻转纪元：之后登记的访问都在新纪元并读到新过滤器，
+    // 等旧纪元的访问结束即可释放旧过滤器
+    m_filter.store(filter.get());
+    const unsigned epoch = m_epoch.fetch_add(1);
+    while (m_readers[epoch & 1].load(std::memory_order_acquire) != 0) {
+      std::this_thread::yield();
+    }
+    m_current = std::move(filter);
+    m_keys.store(keys);
+    m_capacity.store(capacity);
+    m_removed.store(0);
+    m_rebuilds.fetch_add(1);
+    m_lastRebuildMs.store(timer.elapsed());
+  }
+  m_pending.clear();
+  m_rebuilding.store(false);
+  locker.unlock();
+
+  if (ok) {
+    qInfo() << "成员索引已重建:" << m_name << "键数" << keys << "耗时"
+            << timer.elapsed() << "ms";
+  } else if (!m_cancel.load()) {
+    qWarning() << "成员索引重建失败，保留原过滤器:" << m_name;
+  }
+  return ok;
+}
+
+bool MembershipIndex::rebuildAsync() {
+  QMutexLocker locker(&m_threadMutex);
+  if (m_threadRunning.load()) return false;
+  if (m_thread.joinable()) m_thread.join();
+  m_threadRunning.store(true);
+  m_thread = std::thread([this]() {
+    rebuild();
+    m_threadRunning.store(false);
+  });
+  return true;
+}
+
+void MembershipIndex::stop() {
+  m_cancel.store(true);
+  QMutexLocker locker(&m_threadMutex);
+  if (m_thread.joinable()) m_thread.join();
+  m_cancel.store(false);
+}
+
+MembershipIndexStats MembershipIndex::stats() const {
+  MembershipIndexStats s;
+  const BloomFilter* filter = m_filter.load();
+  s.ready = filter != nullptr;
+  s.enabled = m_enabled.load();
+  s.keys = m_keys.load();
+  s.capacity = m_capacity.load();
+  s.bits = filter ? filter->bitCount() : 0;
+  s.lookups = m_lookups.load();
+  s.negatives = m_negatives.load();
+  s.falsePositives = m_falsePositives.load();
+  s.rebuilds = m_rebuilds.load();
+  s.lastRebuildMs = m_lastRebuildMs.load();
+  return s;
+}
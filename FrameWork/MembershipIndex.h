@@ -0,0 +1,198 @@
+﻿// MembershipIndex.h - 布隆过滤器与后台重建的成员索引
+#ifndef MEMBERSHIP_INDEX_H
+#define MEMBERSHIP_INDEX_H
+
+#include <QJsonObject>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+
+/**
+ * @brief 分块布隆过滤器
+ * 每个键的全部位落在同一个 64 字节块内，一次查询只访问一条缓存行；
+ * 位数组为原子字，加入与查询可并发进行，无需加锁。容量固定，超出后
+ * 误判率上升，由 MembershipIndex 按需重建。
+ */
+class BloomFilter {
+ public:
+  /**
+   * @brief 构造函数
+   * @param expectedKeys 预计键数
+   * @param bitsPerKey 每键位数（10 约 1% 误判率）
+   */
+  BloomFilter(qint64 expectedKeys, int bitsPerKey);
+
+  /**
+   * @brief 键的 64 位散列（加入与查询共用）
+   */
+  static quint64 hash(const QString& key);
+
+  void add(quint64 h);
+  bool mightContain(quint64 h) const;
+
+  qint64 bitCount() const { return m_blocks * kBlockBits; }
+  int hashCount() const { return m_hashes; }
+
+ private:
+  static constexpr int kBlockWords = 8;  ///< 每块 8 个 64 位字
+  static constexpr int kBlockBits = kBlockWords * 64;
+
+  qint64 m_blocks;                                  ///< 块数（2 的幂）
+  int m_hashes;                                     ///< 每键置位数
+  std::unique_ptr<std::atomic<quint64>[]> m_words;  ///< 位数组
+};
+
+/**
+ * @brief 成员索引统计
+ */
+struct MembershipIndexStats {
+  bool ready = false;          ///< 是否已完成首次加载
+  bool enabled = true;         ///< 是否启用
+  qint64 keys = 0;             ///< 已加入的键数（含已删除未重建的）
+  qint64 capacity = 0;         ///< 当前过滤器的设计容量
+  qint64 bits = 0;             ///< 位数组大小
+  quint64 lookups = 0;         ///< 查询次数
+  quint64 negatives = 0;       ///< 判定不存在（无需访问数据库）的次数
+  quint64 falsePositives = 0;  ///< 可能存在但数据库中没有的次数
+  int rebuilds = 0;            ///< 完成的重建次数
+  qint64 lastRebuildMs = 0;    ///< 最近一次重建耗时
+
+  /**
+   * @brief 实测误判率（误判数 / 判定可能存在的次数）
+   */
+  double falsePositiveRate() const {
+    const quint64 positives = lookups - negatives;
+    return positives > 0 ? static_cast<double>(falsePositives) / positives
+                         : 0.0;
+  }
+
+  QJsonObject toJson() const;
+};
+
+/**
+ * @brief 列取值的内存成员索引
+ * 以布隆过滤器回答"某值是否可能存在"：判定不存在时调用方直接跳过数据库
+ * 查询，可能存在时再查库确认。加入在写入提交后调用；删除无法从过滤器
+ * 移除，只计数，累积到一定比例或键数超过容量时在后台线程重建。
+ *
+ * 首次加载完成前、被关闭时一律判定为可能存在，退回查库。绕过表类写入
+ * 的行在下次重建前可能查不到，依赖该列的 UNIQUE 约束兜底。
+ *
+ * 重建时先扫描全表建新过滤器，期间的加入另记一份，换上新过滤器前补入。
+ * 查询路径不加锁：访问过滤器前在当前纪元的计数上登记，换代后翻转纪元，
+ * 等旧纪元的访问全部结束再释放旧过滤器。
+ */
+class MembershipIndex {
+ public:
+  /// 返回当前键数（用于确定新过滤器的容量，失败返回 -1）
+  using CountFn = std::function<qint64()>;
+  /// 逐个交出全部键；sink 返回 false 时应停止并返回 false
+  using ScanFn =
+      std::function<bool(const std::function<bool(const QString&)>& sink)>;
+
+  /**
+   * @brief 构造函数
+   * @param name 名称（日志用）
+   * @param count 取键数
+   * @param scan 扫描全部键
+   * @param bitsPerKey 每键位数
+   */
+  MembershipIndex(const QString& name, CountFn count, ScanFn scan,
+                  int bitsPerKey = 10);
+  ~MembershipIndex();
+
+  MembershipIndex(const MembershipIndex&) = delete;
+  MembershipIndex& operator=(const MembershipIndex&) = delete;
+
+  /**
+   * @brief 键是否可能存在
+   * @return false 表示一定不存在；未就绪或已关闭时总为 true
+   */
+  bool mightContain(const QString& key) const;
+
+  /**
+   * @brief 记录一次误判（mightContain 为 true 但查库不存在）
+   */
+  void recordFalsePositive() const {
+    m_falsePositives.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 加入键（写入提交后调用）
+   */
+  void add(const QString& key);
+
+  /**
+   * @brief 记录删除（过滤器中的位保留到重建）
+   */
+  void remove();
+
+  /**
+   * @brief 同步重建
+   * @return 是否成功（失败时保留原过滤器）
+   */
+  bool rebuild();
+
+  /**
+   * @brief 在后台线程重建
+   * @return 是否已启动（已有重建在进行时为false）
+   */
+  bool rebuildAsync();
+
+  /**
+   * @brief 取消进行中的重建并等待后台线程结束
+   */
+  void stop();
+
+  /**
+   * @brief 打开或关闭索引（关闭时总是退回查库，基准对比用）
+   */
+  void setEnabled(bool enabled) { m_enabled.store(enabled); }
+
+  bool isReady() const { return m_filter.load() != nullptr; }
+
+  MembershipIndexStats stats() const;
+
+ private:
+  /// 键数超过容量或删除累积过多时启动后台重建
+  void maybeRebuild();
+
+  /// 访问过滤器期间的纪元登记（见 rebuild 中的换代）
+  class ReadGuard;
+
+  QString m_name;
+  CountFn m_count;
+  ScanFn m_scan;
+  int m_bitsPerKey;
+
+  std::atomic<BloomFilter*> m_filter{nullptr};  ///< 查询用的当前过滤器
+  std::unique_ptr<BloomFilter> m_current;       ///< 当前过滤器（所有者）
+  mutable std::atomic<int> m_readers[2] = {};   ///< 两个纪元各自的访问数
+  std::atomic<unsigned> m_epoch{0};             ///< 当前纪元
+
+  std::atomic<bool> m_enabled{true};
+  std::atomic<qint64> m_keys{0};
+  std::atomic<qint64> m_capacity{0};
+  std::atomic<qint64> m_removed{0};
+  mutable std::atomic<quint64> m_lookups{0};
+  mutable std::atomic<quint64> m_negatives{0};
+  mutable std::atomic<quint64> m_falsePositives{0};
+  std::atomic<int> m_rebuilds{0};
+  std::atomic<qint64> m_lastRebuildMs{0};
+
+  QMutex m_rebuildMutex;                  ///< 同一时刻只有一次重建
+  QMutex m_pendingMutex;                  ///< 保护 m_pending 与换代
+  std::atomic<bool> m_rebuilding{false};  ///< 重建进行中
+  QVector<quint64> m_pending;             ///< 重建期间加入的键散列
+  std::atomic<bool> m_cancel{false};      ///< 取消进行中的重建
+
+  QMutex m_threadMutex;  ///< 保护 m_thread
+  std::thread m_thread;  ///< 后台重建线程
+  std::atomic<bool> m_threadRunning{false};
+};
+
+#endif  // MEMBERSHIP_INDEX_H
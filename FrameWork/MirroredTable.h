@@ -0,0 +1,520 @@
+﻿// MirroredTable.h - 内存镜像表：读取走内存快照，写入先落盘再应用
+#ifndef MIRRORED_TABLE_H
+#define MIRRORED_TABLE_H
+
+#include <QDebug>
+#include <QMutex>
+#include <QSet>
+#include <QVector>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include "ChangeFeed.h"
+#include "DatabaseFramework.h"
+
+/**
+ * @brief 内存镜像表
+ * 包装一个落盘的 BaseTable<T>，在内存中保存整表已提交状态的副本。读取
+ * 全部由不可变快照提供：读者只取快照指针，不做磁盘读取；拿到的快照在其
+ * 生命周期内不变（快照隔离），发布新快照只替换指针。
+ *
+ * 经本类的写入先落盘，提交后重读受影响的行并发布新快照：不在线程事务
+ * 中时写入返回即可见；在线程事务中时提交后进入镜像，回滚则不应用。当前
+ * 线程有活动线程事务时，读取改由落盘表在该事务的连接上完成，仍能读到
+ * 本事务的写入（snapshot() 始终是已提交状态）。
+ *
+ * 清空表在释放表锁后同步整表重载（事务中则提交后重载）。其余绕过本类
+ * 的写入（原始SQL、触发器、直接写落盘表）经变更流在提交后送达，由消费
+ * 线程刷新；flush() 可等待这些变更应用完毕。变更流队列溢出时整表重载。
+ *
+ * 适用于很小而读取频繁的表：有序列表按默认排序增量维护（二分定位，
+ * 不整表重排），selectAll() 只复制隐式共享的列表。被包装的表须比镜像
+ * 活得久，经镜像开启的事务须在镜像销毁前结束。
+ * @tparam T 数据实体类型（须有 int id 成员）
+ */
+template <typename T>
+class MirroredTable : public BaseTable<T> {
+ public:
+  /// 排序比较：a 是否排在 b 之前（相等的行再按id排序）
+  using Less = std::function<bool(const T&, const T&)>;
+
+  /**
+   * @brief 不可变快照
+   */
+  struct Snapshot {
+    QList<T> rows;              ///< 全部记录（按默认排序）
+    QHash<int, int> indexById;  ///< ID -> rows 中的位置
+    quint64 version = 0;        ///< 版本（每次发布递增）
+  };
+  using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
+  /**
+   * @brief 构造函数（调用 load() 后镜像才有数据）
+   * @param source 被包装的落盘表
+   * @param defaultOrder 默认排序（为空按id）
+   * @param sortKeys 分页查询可用的排序列（列名 -> 比较函数）
+   */
+  explicit MirroredTable(BaseTable<T>* source, Less defaultOrder = Less(),
+                         QHash<QString, Less> sortKeys = {})
+      : BaseTable<T>(source ? source->baseOperations() : nullptr),
+        m_source(source),
+        m_defaultOrder(std::move(defaultOrder)),
+        m_sortKeys(std::move(sortKeys)),
+        m_snapshot(std::make_shared<const Snapshot>()) {
+    BaseTableOperations* ops = this->m_baseOps;
+    if (!ops) return;
+
+    // 信号在释放表锁后发出，可以直接重读；事务中的清空等提交后再重载
+    m_resetConnection = QObject::connect(
+        ops, &BaseTableOperations::tableReset, [this]() {
+          this->m_baseOps->afterCommit([this]() {
+            markReset();
+            refreshPending();
+          });
+        });
+
+    // 变更流只发布已提交的事务（原生钩子或写入信号的提交后回退路径），
+    // 绕过镜像的写入在消费线程中刷新
+    ChangeFeed* feed = ops->changeFeed();
+    if (feed) {
+      ChangeFeed::SubscribeOptions options;
+      options.tables = {ops->tableName()};
+      m_feed = feed;
+      m_subscription = feed->subscribe(
+          [this](QVector<ChangeTransaction>& batch) {
+            if (m_closing.load()) return true;
+            for (const ChangeTransaction& tx : batch) {
+              for (const ChangeEvent& e : tx.changes) {
+                if (e.op == ChangeOp::RESET) {
+                  markReset();
+                } else {
+                  markDirty(static_cast<int>(e.rowid));
+                }
+              }
+            }
+            // 队列溢出丢弃过变更：无从逐行补回，整表重载
+            const quint64 dropped =
+                m_feed->subscriptionStats(m_subscription).dropped;
+            if (dropped != m_droppedSeen) {
+              m_droppedSeen = dropped;
+              markReset();
+            }
+            refreshPending();
+            return true;
+          },
+          options);
+    }
+  }
+
+  ~MirroredTable() override {
+    m_closing.store(true);
+    QObject::disconnect(m_resetConnection);
+    if (m_feed && m_subscription) m_feed->unsubscribe(m_subscription);
+  }
+
+  MirroredTable(const MirroredTable&) = delete;
+  MirroredTable& operator=(const MirroredTable&) = delete;
+
+  // ========================================================================
+  // 镜像管理
+  // ========================================================================
+
+  /**
+   * @brief 从磁盘整表加载（启动时调用，一条查询）
+   * @return 操作结果，包含加载的行数
+   */
+  DbResult<int> load() {
+    QMutexLocker locker(&m_writeMutex);
+    QString error;
+    if (!reloadLocked(&error)) {
+      markReset();  // 下一次刷新重试
+      return DbResult<int>::Error(error);
+    }
+    return DbResult<int>::Success(m_ordered.size());
+  }
+
+  /**
+   * @brief 等待已提交的变更应用到镜像
+   * 用于绕过镜像写入后需要立即读到结果的场景
+   * @param timeoutMs 超时（毫秒）
+   * @return 是否在超时前应用完毕（无变更流时立即返回 true）
+   */
+  bool flush(int timeoutMs = 5000) {
+    if (m_feed && m_subscription && !m_feed->flush(m_subscription, timeoutMs)) {
+      return false;
+    }
+    return refreshPending();
+  }
+
+  /**
+   * @brief 获取当前快照（只取指针，不读盘）
+   * 同一快照上的多次读取彼此一致
+   * @return 只读快照
+   */
+  SnapshotPtr snapshot() const {
+    QMutexLocker locker(&m_snapshotMutex);
+    return m_snapshot;
+  }
+
+  /**
+   * @brief 按条件筛选（默认排序）
+   * @param predicate 筛选条件
+   * @return 满足条件的记录
+   */
+  QList<T> select(const std::function<bool(const T&)>& predicate) const {
+    QList<T> result;
+    if (readFromSource()) {
+      for (const T& row : selectAll().data) {
+        if (predicate(row)) result.append(row);
+      }
+      return result;
+    }
+    const SnapshotPtr snap = snapshot();
+    for (const T& row : snap->rows) {
+      if (predicate(row)) result.append(row);
+    }
+    return result;
+  }
+
+  /**
+   * @brief 条件查询直接下发到落盘表（镜像不解释 SQL 条件）
+   */
+  QVector<ColumnSpec> queryColumns() const override {
+    return m_source ? m_source->queryColumns() : QVector<ColumnSpec>();
+  }
+
+  DbResult<QList<T>> select(const TableQuery& query) const override {
+    if (!m_source) return DbResult<QList<T>>::Error("镜像表未关联落盘表");
+    return m_source->select(query);
+  }
+
+  /**
+   * @brief 被包装的落盘表
+   * @return 表指针
+   */
+  BaseTable<T>* source() const { return m_source; }
+
+  // ========================================================================
+  // 写入：先落盘，再应用到镜像
+  // ========================================================================
+
+  DbResult<int> insert(const T& entity) override {
+    if (!m_source) return DbResult<int>::Error("镜像表未关联落盘表");
+    const DbResult<int> result = m_source->insert(entity);
+    if (result.success) applyAfterCommit(result.data);
+    return result;
+  }
+
+  DbResult<bool> update(const T& entity) override {
+    if (!m_source) return DbResult<bool>::Error("镜像表未关联落盘表");
+    const DbResult<bool> result = m_source->update(entity);
+    if (result.success) applyAfterCommit(entity.id);
+    return result;
+  }
+
+  DbResult<bool> deleteById(int id) override {
+    if (!m_source) return DbResult<bool>::Error("镜像表未关联落盘表");
+    const DbResult<bool> result = m_source->deleteById(id);
+    if (result.success) applyAfterCommit(id);
+    return result;
+  }
+
+  /// 批量插入不返回新ID，提交后整表重载
+  DbResult<int> batchInsert(const QList<T>& entities) override {
+    if (!m_source) return DbResult<int>::Error("镜像表未关联落盘表");
+    const DbResult<int> result = m_source->batchInsert(entities);
+    if (result.success) applyAfterCommit(-1);
+    return result;
+  }
+
+  // ========================================================================
+  // 读取：由内存快照提供（线程事务中改读落盘表）
+  // ========================================================================
+
+  DbResult<T> selectById(int id) const override {
+    if (readFromSource()) return m_source->selectById(id);
+    const SnapshotPtr snap = snapshot();
+    const auto it = snap->indexById.constFind(id);
+    if (it == snap->indexById.constEnd()) {
+      return DbResult<T>::Error("未找到指定的记录", DbErrorCode::NOT_FOUND);
+    }
+    return DbResult<T>::Success(snap->rows.at(*it));
+  }
+
+  DbResult<QList<T>> selectAll() const override {
+    if (readFromSource()) {
+      DbResult<QList<T>> all = m_source->selectAll();
+      if (all.success) {
+        std::sort(all.data.begin(), all.data.end(),
+                  [this](const T& a, const T& b) {
+                    return orderedBefore(a, b);
+                  });
+      }
+      return all;
+    }
+    return DbResult<QList<T>>::Success(snapshot()->rows);
+  }
+
+  DbResult<QHash<int, T>> selectByIds(const QList<int>& ids) const override {
+    if (readFromSource()) return m_source->selectByIds(ids);
+    const SnapshotPtr snap = snapshot();
+    QHash<int, T> rows;
+    for (int id : ids) {
+      const auto it = snap->indexById.constFind(id);
+      if (it != snap->indexById.constEnd()) rows.insert(id, snap->rows.at(*it));
+    }
+    return DbResult<QHash<int, T>>::Success(std::move(rows));
+  }
+
+  /// 未登记的排序列按默认排序
+  DbResult<PageResult<T>> selectByPage(
+      const PageParams& params) const override {
+    if (params.pageIndex < 1 || params.pageSize <= 0) {
+      return DbResult<PageResult<T>>::Error("无效的分页参数",
+                                            DbErrorCode::INVALID);
+    }
+    if (readFromSource()) return m_source->selectByPage(params);
+
+    const SnapshotPtr snap = snapshot();
+    QList<T> ordered = snap->rows;
+    if (params.orderBy == "id") {
+      std::sort(ordered.begin(), ordered.end(),
+                [](const T& a, const T& b) { return a.id < b.id; });
+    } else {
+      const auto key = m_sortKeys.constFind(params.orderBy);
+      if (key != m_sortKeys.constEnd()) {
+        const Less& less = *key;
+        std::sort(ordered.begin(), ordered.end(),
+                  [&less](const T& a, const T& b) {
+                    if (less(a, b)) return true;
+                    if (less(b, a)) return false;
+                    return a.id < b.id;
+                  });
+      }
+    }
+    if (!params.ascending) std::reverse(ordered.begin(), ordered.end());
+
+    return DbResult<PageResult<T>>::Success(PageResult<T>(
+        ordered.mid(params.offset(), params.pageSize), ordered.size(),
+        params));
+  }
+
+ private:
+  /// 当前线程有活动事务：快照看不到本事务的写入，读取改走落盘表
+  bool readFromSource() const {
+    return m_source && this->m_baseOps &&
+           this->m_baseOps->inThreadTransaction();
+  }
+
+  // ==========================================================================
+  // 经镜像的写入在提交后应用
+  // ==========================================================================
+
+  /**
+   * @brief 所在线程事务提交后应用写入（无活动事务时立即应用）
+   * 回滚时不做任何事：未提交的行从未进入镜像
+   * @param id 受影响的行（-1 表示整表重载）
+   */
+  void applyAfterCommit(int id) {
+    auto apply = [this, id]() {
+      if (id < 0) {
+        markReset();
+      } else {
+        markDirty(id);
+      }
+      refreshPending();
+    };
+    if (this->m_baseOps) {
+      this->m_baseOps->afterCommit(apply);
+    } else {
+      apply();
+    }
+  }
+
+  // ==========================================================================
+  // 待刷新标记（不持其他锁，可在写入方持表锁时调用）
+  // ==========================================================================
+
+  void markDirty(int id) {
+    QMutexLocker locker(&m_pendingMutex);
+    m_pendingIds.insert(id);
+    m_dirty.store(true);
+  }
+
+  void markReset() {
+    QMutexLocker locker(&m_pendingMutex);
+    m_pendingReset = true;
+    m_dirty.store(true);
+  }
+
+  // ==========================================================================
+  // 刷新与发布（持 m_writeMutex 时会取表锁，不可在写入信号中调用；只在
+  // 写入提交后与变更流消费线程中调用，读取路径从不刷新）
+  // ==========================================================================
+
+  /**
+   * @brief 重读待刷新的行并发布新快照
+   * @return 是否成功（失败时保留标记，下次刷新重试）
+   */
+  bool refreshPending() {
+    if (!m_dirty.load()) return true;
+
+    QMutexLocker locker(&m_writeMutex);
+    QSet<int> ids;
+    bool reset = false;
+    {
+      QMutexLocker pending(&m_pendingMutex);
+      ids.swap(m_pendingIds);
+      reset = m_pendingReset;
+      m_pendingReset = false;
+      m_dirty.store(false);
+    }
+
+    QString error;
+    if (reset) {
+      if (reloadLocked(&error)) return true;
+      qWarning() << "镜像表重载失败:" << error;
+      markReset();
+      return false;
+    }
+    if (ids.isEmpty()) return true;
+
+    const DbResult<QHash<int, T>> fresh = m_source->selectByIds(ids.values());
+    if (!fresh.success) {
+      qWarning() << "镜像表刷新失败:" << fresh.errorMessage;
+      for (int id : ids) markDirty(id);
+      return false;
+    }
+    for (int id : ids) {
+      const auto it = fresh.data.constFind(id);
+      if (it == fresh.data.constEnd()) {
+        removeLocked(id);
+      } else {
+        upsertLocked(*it);
+      }
+    }
+    publishLocked();
+    return true;
+  }
+
+  /**
+   * @brief 整表重载（持 m_writeMutex）
+   */
+  bool reloadLocked(QString* error) {
+    // 先清标记再读盘：读盘期间的新写入会重新标记
+    {
+      QMutexLocker pending(&m_pendingMutex);
+      m_pendingIds.clear();
+      m_pendingReset = false;
+      m_dirty.store(false);
+    }
+    if (!m_source) {
+      *error = "镜像表未关联落盘表";
+      return false;
+    }
+
+    const DbResult<QList<T>> all = m_source->selectAll();
+    if (!all.success) {
+      *error = all.errorMessage;
+      return false;
+    }
+    m_ordered = all.data;
+    std::sort(m_ordered.begin(), m_ordered.end(),
+              [this](const T& a, const T& b) { return orderedBefore(a, b); });
+    m_indexById.clear();
+    m_indexById.reserve(m_ordered.size());
+    reindexLocked(0);
+    publishLocked();
+    return true;
+  }
+
+  // ==========================================================================
+  // 有序列表的增量维护（持 m_writeMutex）
+  // ==========================================================================
+
+  /// 默认排序，相等的行再按id排序（全序，可二分定位）
+  bool orderedBefore(const T& a, const T& b) const {
+    if (m_defaultOrder) {
+      if (m_defaultOrder(a, b)) return true;
+      if (m_defaultOrder(b, a)) return false;
+    }
+    return a.id < b.id;
+  }
+
+  /// 从 from 起重写位置索引
+  void reindexLocked(int from) {
+    for (int i = from; i < m_ordered.size(); ++i) {
+      m_indexById.insert(m_ordered.at(i).id, i);
+    }
+  }
+
+  void removeLocked(int id) {
+    const auto it = m_indexById.find(id);
+    if (it == m_indexById.end()) return;
+    const int pos = *it;
+    m_indexById.erase(it);
+    m_ordered.removeAt(pos);
+    reindexLocked(pos);
+  }
+
+  void upsertLocked(const T& row) {
+    const auto it = m_indexById.constFind(row.id);
+    if (it != m_indexById.constEnd()) {
+      // 排序键未变（最常见）时原位替换，位置索引不变
+      const int pos = *it;
+      const bool afterPrev =
+          pos == 0 || orderedBefore(m_ordered.at(pos - 1), row);
+      const bool beforeNext = pos == m_ordered.size() - 1 ||
+                              orderedBefore(row, m_ordered.at(pos + 1));
+      if (afterPrev && beforeNext) {
+        m_ordered[pos] = row;
+        return;
+      }
+      removeLocked(row.id);
+    }
+    const auto at = std::lower_bound(
+        m_ordered.begin(), m_ordered.end(), row,
+        [this](const T& a, const T& b) { return orderedBefore(a, b); });
+    const int pos = static_cast<int>(at - m_ordered.begin());
+    m_ordered.insert(pos, row);
+    reindexLocked(pos);
+  }
+
+  /**
+   * @brief 以当前有序列表替换快照（持 m_writeMutex）
+   * 列表与索引隐式共享给快照，下一次修改时才复制
+   */
+  void publishLocked() {
+    auto snap = std::make_shared<Snapshot>();
+    snap->rows = m_ordered;
+    snap->indexById = m_indexById;
+
+    QMutexLocker locker(&m_snapshotMutex);
+    snap->version = m_snapshot->version + 1;
+    m_snapshot = std::move(snap);
+  }
+
+  BaseTable<T>* m_source;           ///< 被包装的落盘表（不拥有）
+  Less m_defaultOrder;              ///< 默认排序
+  QHash<QString, Less> m_sortKeys;  ///< 分页可用的排序列
+
+  QMetaObject::Connection m_resetConnection;  ///< 清空表信号连接
+  ChangeFeed* m_feed = nullptr;               ///< 变更流（不拥有）
+  quint64 m_subscription = 0;                 ///< 变更流订阅ID
+  quint64 m_droppedSeen = 0;                  ///< 已处理过的队列丢弃数
+  std::atomic<bool> m_closing{false};         ///< 析构中，忽略后续变更
+
+  QMutex m_writeMutex;               ///< 串行化刷新与发布
+  QList<T> m_ordered;                ///< 按默认排序的副本（持 m_writeMutex）
+  QHash<int, int> m_indexById;       ///< ID -> m_ordered 中的位置
+  mutable QMutex m_snapshotMutex;    ///< 保护快照指针
+  SnapshotPtr m_snapshot;            ///< 当前快照
+  QMutex m_pendingMutex;             ///< 保护待刷新标记
+  QSet<int> m_pendingIds;            ///< 待重读的行
+  bool m_pendingReset = false;       ///< 待整表重载
+  std::atomic<bool> m_dirty{false};  ///< 是否有待刷新项
+};
+
+#endif  // MIRRORED_TABLE_H
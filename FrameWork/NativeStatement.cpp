@@ -0,0 +1,318 @@
+﻿// NativeStatement.cpp - 绕过 QSqlQuery 的 sqlite3_stmt 执行路径实现
+#include "NativeStatement.h"
+
+#include <QDebug>
+#include <atomic>
+
+#include "SqliteNative.h"
+
+namespace {
+
+std::atomic<bool> g_enabled{true};
+std::atomic<bool> g_multiThread{false};
+
+#ifdef DB_SQLITE_NATIVE
+inline sqlite3_stmt* stmtOf(void* p) { return static_cast<sqlite3_stmt*>(p); }
+#endif
+
+}  // namespace
+
+// ============================================================================
+// NativeStatementCache
+// ============================================================================
+
+NativeStatementCache::NativeStatementCache(void* handle) : m_handle(handle) {}
+
+NativeStatementCache::~NativeStatementCache() { clear(); }
+
+void* NativeStatementCache::statement(const QString& sql) {
+#ifdef DB_SQLITE_NATIVE
+  auto it = m_statements.constFind(sql);
+  if (it != m_statements.constEnd()) return it.value();
+  if (!m_handle) return nullptr;
+
+  auto* db = static_cast<sqlite3*>(m_handle);
+  sqlite3_stmt* stmt = nullptr;
+  const int rc =
+      sqlite3_prepare16_v2(db, sql.utf16(), sql.size() * sizeof(ushort),
+                           &stmt, nullptr);
+  if (rc != SQLITE_OK || !stmt) {
+    qWarning() << "原生语句预编译失败:"
+               << QString::fromUtf8(sqlite3_errmsg(db)) << sql.simplified();
+    sqlite3_finalize(stmt);
+    return nullptr;
+  }
+  m_statements.insert(sql, stmt);
+  return stmt;
+#else
+  Q_UNUSED(sql);
+  return nullptr;
+#endif
+}
+
+void NativeStatementCache::clear() {
+#ifdef DB_SQLITE_NATIVE
+  for (void* stmt : m_statements) sqlite3_finalize(stmtOf(stmt));
+#endif
+  m_statements.clear();
+}
+
+// ============================================================================
+// NativeStatement
+// ============================================================================
+
+NativeStatement::NativeStatement(NativeStatementCache* cache,
+                                 const QString& sql)
+    : m_handle(cache ? cache->handle() : nullptr),
+      m_stmt(cache ? cache->statement(sql) : nullptr) {}
+
+NativeStatement::~NativeStatement() {
+#ifdef DB_SQLITE_NATIVE
+  // 及时 reset，缓存中的语句不会一直占着读事务（妨碍 WAL 检查点）
+  if (m_stmt) {
+    sqlite3_reset(stmtOf(m_stmt));
+    sqlite3_clear_bindings(stmtOf(m_stmt));
+  }
+#endif
+}
+
+void NativeStatement::bind(int index, int value) {
+#ifdef DB_SQLITE_NATIVE
+  sqlite3_bind_int(stmtOf(m_stmt), index, value);
+#else
+  Q_UNUSED(index);
+  Q_UNUSED(value);
+#endif
+}
+
+void NativeStatement::bind(int index, qint64 value) {
+#ifdef DB_SQLITE_NATIVE
+  sqlite3_bind_int64(stmtOf(m_stmt), index, value);
+#else
+  Q_UNUSED(index);
+  Q_UNUSED(value);
+#endif
+}
+
+void NativeStatement::bind(int index, double value) {
+#ifdef DB_SQLITE_NATIVE
+  sqlite3_bind_double(stmtOf(m_stmt), index, value);
+#else
+  Q_UNUSED(index);
+  Q_UNUSED(value);
+#endif
+}
+
+void NativeStatement::bind(int index, const QString& value) {
+#ifdef DB_SQLITE_NATIVE
+  if (value.isNull()) {
+    sqlite3_bind_null(stmtOf(m_stmt), index);
+    return;
+  }
+  sqlite3_bind_text16(stmtOf(m_stmt), index, value.utf16(),
+                      value.size() * sizeof(ushort), SQLITE_TRANSIENT);
+#else
+  Q_UNUSED(index);
+  Q_UNUSED(value);
+#endif
+}
+
+void NativeStatement::bind(int index, const QDateTime& value) {
+  bind(index, value.isValid() ? value.toString(Qt::ISODateWithMs) : QString());
+}
+
+void NativeStatement::bind(int index, const QVariant& value) {
+#ifdef DB_SQLITE_NATIVE
+  if (value.isNull()) {
+    sqlite3_bind_null(stmtOf(m_stmt), index);
+    return;
+  }
+  switch (value.type()) {
+    case QVariant::ByteArray: {
+      const QByteArray bytes = value.toByteArray();
+      sqlite3_bind_blob(stmtOf(m_stmt), index, bytes.constData(),
+                        bytes.size(), SQLITE_TRANSIENT);
+      return;
+    }
+    case QVariant::Bool:
+    case QVariant::Int:
+      bind(index, value.toInt());
+      return;
+    case QVariant::UInt:
+    case QVariant::LongLong:
+    case QVariant::ULongLong:
+      bind(index, value.toLongLong());
+      return;
+    case QVariant::Double:
+      bind(index, value.toDouble());
+      return;
+    case QVariant::DateTime:
+      bind(index, value.toDateTime());
+      return;
+    default:
+      bind(index, value.toString());
+      return;
+  }
+#else
+  Q_UNUSED(index);
+  Q_UNUSED(value);
+#endif
+}
+
+bool NativeStatement::next() {
+#ifdef DB_SQLITE_NATIVE
+  if (!m_stmt) return false;
+  m_rc = sqlite3_step(stmtOf(m_stmt));
+  return m_rc == SQLITE_ROW;
+#else
+  return false;
+#endif
+}
+
+bool NativeStatement::exec() {
+#ifdef DB_SQLITE_NATIVE
+  if (!m_stmt) return false;
+  do {
+    m_rc = sqlite3_step(stmtOf(m_stmt));
+  } while (m_rc == SQLITE_ROW);
+  return m_rc == SQLITE_DONE;
+#else
+  return false;
+#endif
+}
+
+int NativeStatement::columnInt(int column) const {
+#ifdef DB_SQLITE_NATIVE
+  return sqlite3_column_int(stmtOf(m_stmt), column);
+#else
+  Q_UNUSED(column);
+  return 0;
+#endif
+}
+
+qint64 NativeStatement::columnInt64(int column) const {
+#ifdef DB_SQLITE_NATIVE
+  return sqlite3_column_int64(stmtOf(m_stmt), column);
+#else
+  Q_UNUSED(column);
+  return 0;
+#endif
+}
+
+double NativeStatement::columnDouble(int column) const {
+#ifdef DB_SQLITE_NATIVE
+  return sqlite3_column_double(stmtOf(m_stmt), column);
+#else
+  Q_UNUSED(column);
+  return 0.0;
+#endif
+}
+
+bool NativeStatement::columnIsNull(int column) const {
+#ifdef DB_SQLITE_NATIVE
+  return sqlite3_column_type(stmtOf(m_stmt), column) == SQLITE_NULL;
+#else
+  Q_UNUSED(column);
+  return true;
+#endif
+}
+
+QString NativeStatement::columnText(int column) const {
+  // NULL 与 QSQLITE 一样读作空 QString
+  return columnTextView(column).toString();
+}
+
+QStringView NativeStatement::columnTextView(int column) const {
+#ifdef DB_SQLITE_NATIVE
+  const void* text = sqlite3_column_text16(stmtOf(m_stmt), column);
+  if (!text) return QStringView();
+  const int bytes = sqlite3_column_bytes16(stmtOf(m_stmt), column);
+  return QStringView(static_cast<const QChar*>(text),
+                     static_cast<qsizetype>(bytes / sizeof(QChar)));
+#else
+  Q_UNUSED(column);
+  return QStringView();
+#endif
+}
+
+QDateTime NativeStatement::columnDateTime(int column) const {
+  // 与 QVariant 由字符串转时间的规则相同
+  const QString text = columnText(column);
+  return text.isNull() ? QDateTime() : QDateTime::fromString(text, Qt::ISODate);
+}
+
+bool NativeStatement::failed() const {
+#ifdef DB_SQLITE_NATIVE
+  return m_rc != 0 && m_rc != SQLITE_ROW && m_rc != SQLITE_DONE;
+#else
+  return true;
+#endif
+}
+
+QString NativeStatement::lastError() const {
+#ifdef DB_SQLITE_NATIVE
+  if (!m_handle) return QString("无效的连接");
+  return QString::fromUtf8(sqlite3_errmsg(static_cast<sqlite3*>(m_handle)));
+#else
+  return QString("未以 sqlite_native 构建");
+#endif
+}
+
+int NativeStatement::lastErrorCode() const {
+#ifdef DB_SQLITE_NATIVE
+  if (!m_handle) return 0;
+  return sqlite3_errcode(static_cast<sqlite3*>(m_handle)) & 0xff;
+#else
+  return 0;
+#endif
+}
+
+qint64 NativeStatement::lastInsertId() const {
+#ifdef DB_SQLITE_NATIVE
+  return m_handle ? sqlite3_last_insert_rowid(static_cast<sqlite3*>(m_handle))
+                  : 0;
+#else
+  return 0;
+#endif
+}
+
+int NativeStatement::changes() const {
+#ifdef DB_SQLITE_NATIVE
+  return m_handle ? sqlite3_changes(static_cast<sqlite3*>(m_handle)) : 0;
+#else
+  return 0;
+#endif
+}
+
+bool NativeStatement::available() {
+#ifdef DB_SQLITE_NATIVE
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool NativeStatement::enabled() {
+  return available() && g_enabled.load(std::memory_order_relaxed);
+}
+
+void NativeStatement::setEnabled(bool enabled) {
+  g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool NativeStatement::enableMultiThreadMode() {
+#ifdef DB_SQLITE_NATIVE
+  if (g_multiThread.load()) return true;
+  // SQLite 已初始化（打开过连接）后返回 SQLITE_MISUSE
+  if (sqlite3_config(SQLITE_CONFIG_MULTITHREAD) != SQLITE_OK) {
+    qWarning() << "无法切换到SQLite多线程模式：须在打开任何连接之前调用";
+    return false;
+  }
+  g_multiThread.store(true);
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool NativeStatement::multiThreadMode() { return g_multiThread.load(); }
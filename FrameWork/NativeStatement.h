@@ -0,0 +1,176 @@
+﻿// NativeStatement.h - 绕过 QSqlQuery 的 sqlite3_stmt 执行路径
+#ifndef NATIVE_STATEMENT_H
+#define NATIVE_STATEMENT_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+#include <QStringView>
+#include <QVariant>
+#include <QtGlobal>
+
+/**
+ * @brief 单条连接的预编译语句缓存
+ * 按 SQL 文本缓存 sqlite3_stmt，随连接池中的一条连接存在：只在持有该
+ * 连接的线程上使用，连接关闭前由连接池 clear()（未终结的语句会使
+ * sqlite3_close 失败）。非 sqlite_native 构建时不会创建。
+ */
+class NativeStatementCache {
+ public:
+  /**
+   * @brief 构造函数
+   * @param handle 连接的 sqlite3 句柄
+   */
+  explicit NativeStatementCache(void* handle);
+  ~NativeStatementCache();
+
+  NativeStatementCache(const NativeStatementCache&) = delete;
+  NativeStatementCache& operator=(const NativeStatementCache&) = delete;
+
+  /**
+   * @brief 取得语句（首次使用时预编译并缓存）
+   * @param sql SQL 文本
+   * @return sqlite3_stmt 句柄（预编译失败为nullptr）
+   */
+  void* statement(const QString& sql);
+
+  /**
+   * @brief 终结全部缓存的语句
+   */
+  void clear();
+
+  void* handle() const { return m_handle; }
+  int size() const { return m_statements.size(); }
+
+ private:
+  void* m_handle;                      ///< sqlite3 句柄（不拥有）
+  QHash<QString, void*> m_statements;  ///< SQL -> sqlite3_stmt
+};
+
+/**
+ * @brief 一次原生语句执行（RAII）
+ * 从缓存取出语句，按位置绑定类型化参数，step 后以 sqlite3_column_*
+ * 直接读列；析构时 reset 并清空绑定，语句留在缓存中复用。不经过
+ * QVariant 装箱与 QSqlResult 的结果缓冲，文本按 UTF-16 绑定和读取，
+ * 与 QString 之间不再另做转换。绑定的字符串由 SQLite 复制，调用方无需
+ * 保持其有效。
+ * 绑定与读出的取值规则与 QSQLITE 一致（空 QString 为 NULL、时间按
+ * ISO 8601 带毫秒的文本存储），两条路径写入的数据可以互相读取。
+ */
+class NativeStatement {
+ public:
+  /**
+   * @brief 构造函数
+   * @param cache 连接的语句缓存
+   * @param sql SQL 文本
+   */
+  NativeStatement(NativeStatementCache* cache, const QString& sql);
+  ~NativeStatement();
+
+  NativeStatement(const NativeStatement&) = delete;
+  NativeStatement& operator=(const NativeStatement&) = delete;
+
+  /**
+   * @brief 语句是否可用（预编译失败时应退回 QSqlQuery）
+   */
+  bool isValid() const { return m_stmt != nullptr; }
+
+  /// @name 按位置绑定参数（index 从 1 开始，同 sqlite3_bind_*）
+  /// @{
+  void bind(int index, int value);
+  void bind(int index, qint64 value);
+  void bind(int index, double value);
+  void bind(int index, const QString& value);
+  void bind(int index, const QDateTime& value);
+  /// 按 QVariant 的类型绑定，规则同 QSQLITE（条件查询等动态取值用）
+  void bind(int index, const QVariant& value);
+  /// @}
+
+  /**
+   * @brief 取下一行
+   * @return 是否取到（结束或出错为false，出错见 failed()）
+   */
+  bool next();
+
+  /**
+   * @brief 执行不返回行的语句
+   * @return 是否执行成功
+   */
+  bool exec();
+
+  /// @name 读取当前行的列（column 从 0 开始）
+  /// @{
+  int columnInt(int column) const;
+  qint64 columnInt64(int column) const;
+  double columnDouble(int column) const;
+  bool columnIsNull(int column) const;
+  QString columnText(int column) const;
+  /// 列文本的零拷贝视图：指向 SQLite 的缓冲区，下次取行、复位或析构前
+  /// 有效；NULL 为空视图（isNull()）
+  QStringView columnTextView(int column) const;
+  QDateTime columnDateTime(int column) const;
+  /// @}
+
+  /**
+   * @brief 最近一次 step 是否出错
+   */
+  bool failed() const;
+
+  /**
+   * @brief 错误信息
+   */
+  QString lastError() const;
+
+  /**
+   * @brief 错误码（SQLite 主结果码，非 sqlite_native 构建时为0）
+   */
+  int lastErrorCode() const;
+
+  /**
+   * @brief 连接上最近插入行的 rowid
+   */
+  qint64 lastInsertId() const;
+
+  /**
+   * @brief 最近一次执行影响的行数
+   */
+  int changes() const;
+
+  /**
+   * @brief 本构建能否使用原生路径（sqlite_native 构建为true）
+   */
+  static bool available();
+
+  /**
+   * @brief 表类是否走原生路径（available() 且未被关闭）
+   */
+  static bool enabled();
+
+  /**
+   * @brief 打开或关闭原生路径（进程级，基准用来对比两条路径）
+   * @param enabled 是否启用
+   */
+  static void setEnabled(bool enabled);
+
+  /**
+   * @brief 把 SQLite 切到多线程模式（SQLITE_CONFIG_MULTITHREAD）
+   * QSQLITE 打开连接时不提供线程模式选项，只能修改进程默认值，此后打开
+   * 的连接不带连接级互斥锁（等同 SQLITE_OPEN_NOMUTEX）。必须在打开任何
+   * 连接之前调用；之后一条连接同一时刻只能由一个线程使用，连接池的
+   * 分配规则保证了这一点，内存统计也不再读取正被其他线程使用的连接。
+   * @return 是否切换成功（已初始化或非 sqlite_native 构建为false）
+   */
+  static bool enableMultiThreadMode();
+
+  /**
+   * @brief 是否已切到多线程模式
+   */
+  static bool multiThreadMode();
+
+ private:
+  void* m_handle = nullptr;  ///< sqlite3 句柄
+  void* m_stmt = nullptr;    ///< sqlite3_stmt 句柄（缓存所有）
+  int m_rc = 0;              ///< 最近一次 step 的返回值
+};
+
+#endif  // NATIVE_STATEMENT_H
@@ -0,0 +1,205 @@
+﻿// QueryPlanChecker.cpp - 查询计划回归检查实现
+#include "QueryPlanChecker.h"
+
+#include <QHash>
+#include <QRegularExpression>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QVariant>
+
+namespace {
+
+const QString kPrimaryKey = "INTEGER PRIMARY KEY";
+
+bool fail(QString* error, const QString& message) {
+  if (error) *error = message;
+  return false;
+}
+
+/// 计划中是否用到指定索引（含覆盖索引）或按主键查找
+bool usesIndex(const QStringList& plan, const QString& index) {
+  const QRegularExpression re(
+      index == kPrimaryKey
+          ? QString("USING INTEGER PRIMARY KEY")
+          : QString("INDEX %1(\\s|$)").arg(QRegularExpression::escape(index)));
+  for (const QString& step : plan) {
+    if (re.match(step).hasMatch()) return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+QString PlanCheckResult::describe() const {
+  QStringList lines;
+  lines << statement;
+  if (!error.isEmpty()) {
+    lines << QString("  无法取得计划: %1").arg(error);
+    return lines.join('\n');
+  }
+  lines << "  实际计划:";
+  for (const QString& step : plan) lines << "    " + step;
+  if (!violations.isEmpty()) {
+    lines << "  差异:";
+    for (const QString& v : violations) lines << "    " + v;
+  }
+  return lines.join('\n');
+}
+
+bool QueryPlanChecker::prepareFixture(const QSqlDatabase& source,
+                                      QSqlDatabase& target, qint64 rowsPerTable,
+                                      int rowsPerKey, QString* error) {
+  if (!source.isOpen() || !target.isOpen()) {
+    return fail(error, "数据库未打开");
+  }
+
+  // 先建表，再建索引、视图、触发器；sqlite_ 开头的内部表与自动索引不复制
+  QSqlQuery src(source);
+  src.setForwardOnly(true);
+  if (!src.exec(R"(
+        SELECT type, name, sql FROM sqlite_master
+        WHERE sql IS NOT NULL AND name NOT LIKE 'sqlite\_%' ESCAPE '\'
+        ORDER BY CASE type WHEN 'table' THEN 0 WHEN 'index' THEN 1
+                           WHEN 'view' THEN 2 ELSE 3 END)")) {
+    return fail(error, QString("读取数据库结构失败: %1")
+                           .arg(src.lastError().text()));
+  }
+
+  QStringList tables;
+  QSqlQuery q(target);
+  while (src.next()) {
+    const QString type = src.value(0).toString();
+    if (!q.exec(src.value(2).toString())) {
+      return fail(error, QString("重建 %1 失败: %2")
+                             .arg(src.value(1).toString(),
+                                  q.lastError().text()));
+    }
+    if (type == "table") tables.append(src.value(1).toString());
+  }
+
+  // ANALYZE 建出 sqlite_stat1，再换成按 rowsPerTable 估算的统计
+  if (!q.exec("ANALYZE") || !q.exec("DELETE FROM sqlite_stat1")) {
+    return fail(error, QString("初始化统计表失败: %1")
+                           .arg(q.lastError().text()));
+  }
+
+  QSqlQuery insert(target);
+  insert.prepare("INSERT INTO sqlite_stat1 (tbl, idx, stat) VALUES (?, ?, ?)");
+  auto addStat = [&insert](const QString& table, const QVariant& index,
+                           const QString& stat) {
+    insert.addBindValue(table);
+    insert.addBindValue(index);
+    insert.addBindValue(stat);
+    return insert.exec();
+  };
+
+  for (const QString& table : tables) {
+    if (!addStat(table, QVariant(QVariant::String),
+                 QString::number(rowsPerTable))) {
+      return fail(error, QString("写入统计失败: %1")
+                             .arg(insert.lastError().text()));
+    }
+
+    QSqlQuery indexes(target);
+    indexes.exec(QString("PRAGMA index_list(\"%1\")").arg(table));
+    while (indexes.next()) {
+      const QString index = indexes.value(1).toString();
+      const bool unique = indexes.value(2).toBool();
+
+      QSqlQuery info(target);
+      info.exec(QString("PRAGMA index_info(\"%1\")").arg(index));
+      int columns = 0;
+      while (info.next()) ++columns;
+
+      // 每个键前缀约 rowsPerKey 行，唯一索引的完整键只对应一行
+      QStringList stat{QString::number(rowsPerTable)};
+      for (int c = 0; c < columns; ++c) {
+        stat << (unique && c == columns - 1 ? QString("1")
+                                            : QString::number(rowsPerKey));
+      }
+      if (!addStat(table, index, stat.join(' '))) {
+        return fail(error, QString("写入统计失败: %1")
+                               .arg(insert.lastError().text()));
+      }
+    }
+  }
+
+  // 重新载入统计
+  if (!q.exec("ANALYZE sqlite_master")) {
+    return fail(error, QString("载入统计失败: %1")
+                           .arg(q.lastError().text()));
+  }
+  return true;
+}
+
+QStringList QueryPlanChecker::explain(const QSqlDatabase& db,
+                                      const QString& sql, QString* error) {
+  QSqlQuery query(db);
+  query.setForwardOnly(true);
+  if (!query.prepare("EXPLAIN QUERY PLAN " + sql)) {
+    fail(error, query.lastError().text());
+    return {};
+  }
+  const int params = sql.count('?');
+  for (int i = 0; i < params; ++i) query.addBindValue(QVariant());
+  if (!query.exec()) {
+    fail(error, query.lastError().text());
+    return {};
+  }
+
+  // 列依次为 id、parent、notused、detail；按 parent 计算缩进层级
+  QHash<int, int> depth;
+  QStringList plan;
+  while (query.next()) {
+    const int id = query.value(0).toInt();
+    const int parent = query.value(1).toInt();
+    const int level = parent == 0 ? 0 : depth.value(parent, 0) + 1;
+    depth.insert(id, level);
+    plan << QString(level * 2, ' ') + query.value(3).toString();
+  }
+  return plan;
+}
+
+PlanCheckResult QueryPlanChecker::check(const QSqlDatabase& db,
+                                        const PlanExpectation& expectation) {
+  PlanCheckResult result;
+  result.statement = expectation.statement;
+  result.plan = explain(db, expectation.sql, &result.error);
+  if (!result.error.isEmpty()) return result;
+
+  for (const QString& index : expectation.useIndexes) {
+    if (!usesIndex(result.plan, index)) {
+      result.violations << QString("- 未使用 %1").arg(index);
+    }
+  }
+
+  for (const QString& line : result.plan) {
+    const QString step = line.trimmed();
+    // 无 FROM 的标量查询只有一行常量，不算扫描
+    const bool scan =
+        step.startsWith("SCAN ") && !step.startsWith("SCAN CONSTANT ROW");
+    if (scan && !expectation.allowScan) {
+      result.violations << "+ " + step;
+    } else if (step.startsWith("USE TEMP B-TREE") &&
+               !expectation.allowTempBTree) {
+      result.violations << "+ " + step;
+    }
+  }
+  return result;
+}
+
+QList<PlanCheckResult> QueryPlanChecker::checkAll(
+    const QSqlDatabase& db, const QList<PlanExpectation>& expectations) {
+  QList<PlanCheckResult> results;
+  results.reserve(expectations.size());
+  for (const PlanExpectation& e : expectations) results.append(check(db, e));
+  return results;
+}
+
+QString QueryPlanChecker::report(const QList<PlanCheckResult>& results) {
+  QStringList failed;
+  for (const PlanCheckResult& r : results) {
+    if (!r.passed()) failed << r.describe();
+  }
+  return failed.join("\n\n");
+}
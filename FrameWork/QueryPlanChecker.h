@@ -0,0 +1,102 @@
+﻿// QueryPlanChecker.h - 查询计划回归检查
+#ifndef QUERY_PLAN_CHECKER_H
+#define QUERY_PLAN_CHECKER_H
+
+#include <QList>
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief 一条语句的查询计划期望
+ * 由各表类在 planExpectations() 中声明，SQL 中的 ? 在检查时绑定 NULL
+ * （SQL 本身不得含字面量 ?）。按整数主键查找时索引名写
+ * "INTEGER PRIMARY KEY"。
+ */
+struct PlanExpectation {
+  QString statement;            ///< 语句名（报告用），如 "类名::常量名"
+  QString sql;                  ///< 待检查的SQL
+  QStringList useIndexes;       ///< 必须用到的索引（主键查找见下）
+  bool allowScan = false;       ///< 是否允许 SCAN（全表或整个索引扫描）
+  bool allowTempBTree = false;  ///< 是否允许 USE TEMP B-TREE（额外排序或去重）
+};
+
+/**
+ * @brief 一条语句的检查结果
+ */
+struct PlanCheckResult {
+  QString statement;       ///< 语句名
+  QStringList plan;        ///< 实际计划（每步一行，子步骤缩进两格）
+  QStringList violations;  ///< 不满足的期望（为空表示通过）
+  QString error;           ///< 无法取得计划时的错误
+
+  bool passed() const { return error.isEmpty() && violations.isEmpty(); }
+
+  /**
+   * @brief 可读的差异描述
+   * 先列实际计划，再以 "- " 标出缺失的索引、以 "+ " 标出不允许的
+   * SCAN 或临时B树步骤
+   */
+  QString describe() const;
+};
+
+/**
+ * @brief 查询计划检查器
+ * 在内存库中重建业务库的表、索引、视图与触发器，并写入按固定行数估算的
+ * sqlite_stat1 统计，使规划器像面对满载的生产库一样选择计划，结果不随
+ * 测试数据多少或是否 ANALYZE 过而变化。随后对每条语句执行
+ * EXPLAIN QUERY PLAN 并与声明的期望比较，防止索引被删或查询被改写后
+ * 悄悄退化为全表扫描。
+ */
+class QueryPlanChecker {
+ public:
+  /**
+   * @brief 准备检查用的数据库
+   * @param source 业务库连接（读取其结构）
+   * @param target 空的目标连接（通常为 :memory:，须已打开）
+   * @param rowsPerTable 统计中每张表的行数
+   * @param rowsPerKey 非唯一索引每个键前缀对应的行数
+   * @param error 失败时的错误信息（可为nullptr）
+   * @return 是否成功
+   */
+  static bool prepareFixture(const QSqlDatabase& source, QSqlDatabase& target,
+                             qint64 rowsPerTable = 100000, int rowsPerKey = 10,
+                             QString* error = nullptr);
+
+  /**
+   * @brief 取得语句的查询计划
+   * @param db 数据库连接
+   * @param sql 待分析的SQL（? 绑定为 NULL）
+   * @param error 失败时的错误信息（可为nullptr）
+   * @return 计划各步骤（子步骤缩进两格）
+   */
+  static QStringList explain(const QSqlDatabase& db, const QString& sql,
+                             QString* error = nullptr);
+
+  /**
+   * @brief 检查一条语句
+   * @param db prepareFixture 准备好的连接
+   * @param expectation 期望
+   * @return 检查结果
+   */
+  static PlanCheckResult check(const QSqlDatabase& db,
+                               const PlanExpectation& expectation);
+
+  /**
+   * @brief 检查一组语句
+   * @param db prepareFixture 准备好的连接
+   * @param expectations 期望列表
+   * @return 各语句的检查结果（与输入同序）
+   */
+  static QList<PlanCheckResult> checkAll(
+      const QSqlDatabase& db, const QList<PlanExpectation>& expectations);
+
+  /**
+   * @brief 汇总未通过的语句
+   * @param results 检查结果
+   * @return 各失败项 describe() 的拼接（全部通过时为空）
+   */
+  static QString report(const QList<PlanCheckResult>& results);
+};
+
+#endif  // QUERY_PLAN_CHECKER_H
@@ -0,0 +1,259 @@
+﻿// SimdKernels.h - 数值列聚合内核（SSE2向量化，其他平台标量回退）
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SIMD_KERNELS_SSE2 1
+#endif
+
+namespace SimdKernels {
+
+/**
+ * @brief 区间统计结果
+ * 只统计落在 [lo, hi] 内的值；NaN 永远不在区间内
+ */
+struct RangeStats {
+  int64_t count = 0;  ///< 命中个数
+  double sum = 0.0;   ///< 命中值之和
+  double min = std::numeric_limits<double>::infinity();   ///< 命中最小值
+  double max = -std::numeric_limits<double>::infinity();  ///< 命中最大值
+
+  void merge(const RangeStats& o) {
+    count += o.count;
+    sum += o.sum;
+    min = std::min(min, o.min);
+    max = std::max(max, o.max);
+  }
+};
+
+namespace detail {
+
+inline void scalarStep(double x, double lo, double hi, RangeStats& s) {
+  if (x >= lo && x <= hi) {
+    ++s.count;
+    s.sum += x;
+    if (x < s.min) s.min = x;
+    if (x > s.max) s.max = x;
+  }
+}
+
+#ifdef SIMD_KERNELS_SSE2
+/**
+ * @brief 两路双精度累加器；float32 先扩展为 double 再累加，避免精度损失
+ */
+struct Acc2 {
+  __m128d lo, hi, sum, cnt, mn, mx, one, inf, ninf;
+
+  Acc2(double l, double h)
+      : lo(_mm_set1_pd(l)),
+        hi(_mm_set1_pd(h)),
+        sum(_mm_setzero_pd()),
+        cnt(_mm_setzero_pd()),
+        mn(_mm_set1_pd(std::numeric_limits<double>::infinity())),
+        mx(_mm_set1_pd(-std::numeric_limits<double>::infinity())),
+        one(_mm_set1_pd(1.0)),
+        inf(_mm_set1_pd(std::numeric_limits<double>::infinity())),
+        ninf(_mm_set1_pd(-std::numeric_limits<double>::infinity())) {}
+
+  inline void step(__m128d x) {
+    const __m128d m = _mm_and_pd(_mm_cmpge_pd(x, lo), _mm_cmple_pd(x, hi));
+    sum = _mm_add_pd(sum, _mm_and_pd(m, x));
+    cnt = _mm_add_pd(cnt, _mm_and_pd(m, one));
+    mn = _mm_min_pd(mn, _mm_or_pd(_mm_and_pd(m, x), _mm_andnot_pd(m, inf)));
+    mx = _mm_max_pd(mx, _mm_or_pd(_mm_and_pd(m, x), _mm_andnot_pd(m, ninf)));
+  }
+
+  inline RangeStats reduce() const {
+    alignas(16) double s[2], c[2], a[2], b[2];
+    _mm_store_pd(s, sum);
+    _mm_store_pd(c, cnt);
+    _mm_store_pd(a, mn);
+    _mm_store_pd(b, mx);
+    RangeStats r;
+    r.sum = s[0] + s[1];
+    r.count = static_cast<int64_t>(c[0] + c[1]);
+    r.min = std::min(a[0], a[1]);
+    r.max = std::max(b[0], b[1]);
+    return r;
+  }
+};
+#endif
+
+}  // namespace detail
+
+/**
+ * @brief 计算区间内的个数、和、最小值与最大值（float32）
+ * @param v 数据（无需对齐）
+ * @param n 个数
+ * @param lo 下界（含）
+ * @param hi 上界（含）
+ * @return 统计结果
+ */
+inline RangeStats rangeStats(const float* v, int64_t n, double lo, double hi) {
+  RangeStats r;
+  int64_t i = 0;
+#ifdef SIMD_KERNELS_SSE2
+  detail::Acc2 a(lo, hi), b(lo, hi);
+  for (; i + 4 <= n; i += 4) {
+    const __m128 x = _mm_loadu_ps(v + i);
+    a.step(_mm_cvtps_pd(x));
+    b.step(_mm_cvtps_pd(_mm_movehl_ps(x, x)));
+  }
+  r = a.reduce();
+  r.merge(b.reduce());
+#endif
+  for (; i < n; ++i) detail::scalarStep(v[i], lo, hi, r);
+  return r;
+}
+
+/**
+ * @brief 计算区间内的个数、和、最小值与最大值（float64）
+ * @param v 数据（无需对齐）
+ * @param n 个数
+ * @param lo 下界（含）
+ * @param hi 上界（含）
+ * @return 统计结果
+ */
+inline RangeStats rangeStats(const double* v, int64_t n, double lo,
+                             double hi) {
+  RangeStats r;
+  int64_t i = 0;
+#ifdef SIMD_KERNELS_SSE2
+  detail::Acc2 a(lo, hi), b(lo, hi);
+  for (; i + 4 <= n; i += 4) {
+    a.step(_mm_loadu_pd(v + i));
+    b.step(_mm_loadu_pd(v + i + 2));
+  }
+  r = a.reduce();
+  r.merge(b.reduce());
+#endif
+  for (; i < n; ++i) detail::scalarStep(v[i], lo, hi, r);
+  return r;
+}
+
+namespace detail {
+
+/**
+ * @brief 直方图公共实现
+ * 桶下标按两路向量计算，计数写入4组交错子直方图以减少写后读依赖，
+ * 最后合并。落在 [lo, hi] 外的值与NaN不计；hi 归入最后一个桶。
+ */
+template <typename T, typename Load2>
+inline void histogramImpl(const T* v, int64_t n, double lo, double hi,
+                          int bins, int64_t* out, Load2 load2) {
+  if (bins <= 0 || !(hi > lo)) return;
+  const double scale = bins / (hi - lo);
+  const int last = bins - 1;
+
+  // 4组子直方图（栈上小数组，否则堆上）
+  constexpr int kLanes = 4;
+  int64_t stackBuf[kLanes * 256];
+  int64_t* sub = stackBuf;
+  int64_t* heapBuf = nullptr;
+  if (bins > 256) {
+    heapBuf = new int64_t[static_cast<size_t>(kLanes) * bins];
+    sub = heapBuf;
+  }
+  std::memset(sub, 0, sizeof(int64_t) * kLanes * bins);
+
+  auto binOf = [&](double x) -> int {
+    const int b = static_cast<int>((x - lo) * scale);
+    return b > last ? last : b;
+  };
+
+  int64_t i = 0;
+#ifdef SIMD_KERNELS_SSE2
+  const __m128d vlo = _mm_set1_pd(lo);
+  const __m128d vhi = _mm_set1_pd(hi);
+  const __m128d vscale = _mm_set1_pd(scale);
+  for (; i + 4 <= n; i += 4) {
+    __m128d x0, x1;
+    load2(v + i, x0, x1);
+    const int m0 = _mm_movemask_pd(
+        _mm_and_pd(_mm_cmpge_pd(x0, vlo), _mm_cmple_pd(x0, vhi)));
+    const int m1 = _mm_movemask_pd(
+        _mm_and_pd(_mm_cmpge_pd(x1, vlo), _mm_cmple_pd(x1, vhi)));
+    // 掩码外的通道（NaN/越界）转换结果为 0x80000000，不会被使用
+    const __m128i i0 =
+        _mm_cvttpd_epi32(_mm_mul_pd(_mm_sub_pd(x0, vlo), vscale));
+    const __m128i i1 =
+        _mm_cvttpd_epi32(_mm_mul_pd(_mm_sub_pd(x1, vlo), vscale));
+    alignas(16) int32_t b0[4], b1[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(b0), i0);
+    _mm_store_si128(reinterpret_cast<__m128i*>(b1), i1);
+    if (m0 & 1) ++sub[std::min(b0[0], last)];
+    if (m0 & 2) ++sub[bins + std::min(b0[1], last)];
+    if (m1 & 1) ++sub[2 * bins + std::min(b1[0], last)];
+    if (m1 & 2) ++sub[3 * bins + std::min(b1[1], last)];
+  }
+#else
+  (void)load2;
+#endif
+  for (; i < n; ++i) {
+    const double x = v[i];
+    if (x >= lo && x <= hi) ++sub[(i & (kLanes - 1)) * bins + binOf(x)];
+  }
+
+  for (int b = 0; b < bins; ++b) {
+    out[b] += sub[b] + sub[bins + b] + sub[2 * bins + b] + sub[3 * bins + b];
+  }
+  delete[] heapBuf;
+}
+
+}  // namespace detail
+
+/**
+ * @brief 等宽直方图（float32），结果累加到out
+ * @param v 数据
+ * @param n 个数
+ * @param lo 下界（含）
+ * @param hi 上界（含，归入最后一个桶）
+ * @param bins 桶数
+ * @param out 长度为bins的计数数组（累加，不清零）
+ */
+inline void histogram(const float* v, int64_t n, double lo, double hi,
+                      int bins, int64_t* out) {
+#ifdef SIMD_KERNELS_SSE2
+  detail::histogramImpl(v, n, lo, hi, bins, out,
+                        [](const float* p, __m128d& a, __m128d& b) {
+                          const __m128 x = _mm_loadu_ps(p);
+                          a = _mm_cvtps_pd(x);
+                          b = _mm_cvtps_pd(_mm_movehl_ps(x, x));
+                        });
+#else
+  detail::histogramImpl(v, n, lo, hi, bins, out, 0);
+#endif
+}
+
+/**
+ * @brief 等宽直方图（float64），结果累加到out
+ * @param v 数据
+ * @param n 个数
+ * @param lo 下界（含）
+ * @param hi 上界（含，归入最后一个桶）
+ * @param bins 桶数
+ * @param out 长度为bins的计数数组（累加，不清零）
+ */
+inline void histogram(const double* v, int64_t n, double lo, double hi,
+                      int bins, int64_t* out) {
+#ifdef SIMD_KERNELS_SSE2
+  detail::histogramImpl(v, n, lo, hi, bins, out,
+                        [](const double* p, __m128d& a, __m128d& b) {
+                          a = _mm_loadu_pd(p);
+                          b = _mm_loadu_pd(p + 2);
+                        });
+#else
+  detail::histogramImpl(v, n, lo, hi, bins, out, 0);
+#endif
+}
+
+}  // namespace SimdKernels
+
+#endif  // SIMD_KERNELS_H
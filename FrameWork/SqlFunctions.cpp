@@ -0,0 +1,43 @@
+﻿// SqlFunctions.cpp - 按连接注册的原生 SQL 函数实现
+#include "SqlFunctions.h"
+
+bool SqlFunctions::available() {
+#ifdef DB_SQLITE_NATIVE
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool SqlFunctions::apply(const QSqlDatabase& db,
+                         const QList<SqlFunction>& functions, QString* error) {
+  if (functions.isEmpty()) return true;
+#ifdef DB_SQLITE_NATIVE
+  sqlite3* handle = SqliteNative::handle(db);
+  if (!handle) {
+    if (error) {
+      *error = QString("无法取得sqlite3句柄: %1").arg(db.connectionName());
+    }
+    return false;
+  }
+  for (const SqlFunction& f : functions) {
+    const int flags =
+        SQLITE_UTF8 | (f.deterministic ? SQLITE_DETERMINISTIC : 0);
+    const int rc = sqlite3_create_function_v2(
+        handle, f.name.toUtf8().constData(), f.argc, flags, nullptr, f.scalar,
+        f.scalar ? nullptr : f.step, f.scalar ? nullptr : f.finalize, nullptr);
+    if (rc != SQLITE_OK) {
+      if (error) {
+        *error = QString("注册SQL函数 %1 失败: %2")
+                     .arg(f.name, QString::fromUtf8(sqlite3_errmsg(handle)));
+      }
+      return false;
+    }
+  }
+  return true;
+#else
+  Q_UNUSED(db);
+  if (error) *error = "原生SQL函数需以 sqlite_native 构建";
+  return false;
+#endif
+}
@@ -0,0 +1,136 @@
+﻿// SqlFunctions.h - 按连接注册的原生 SQL 函数
+#ifndef SQL_FUNCTIONS_H
+#define SQL_FUNCTIONS_H
+
+#include <QDateTime>
+#include <QList>
+#include <QSqlDatabase>
+#include <QString>
+
+#include "SqliteNative.h"
+
+struct sqlite3_context;
+struct sqlite3_value;
+
+/// 标量函数与聚合函数 step 的回调（签名同 sqlite3_create_function_v2）
+using SqlFunctionCallback = void (*)(sqlite3_context*, int, sqlite3_value**);
+/// 聚合函数 finalize 的回调
+using SqlFinalCallback = void (*)(sqlite3_context*);
+
+/**
+ * @brief 一个应用定义的 SQL 函数
+ * scalar 非空为标量函数，否则 step/finalize 组成聚合函数。确定性函数
+ * （同样的参数总得到同样的结果）以 SQLITE_DETERMINISTIC 注册，可用于
+ * 表达式索引、CHECK 约束与生成列；注意此后每条写该表的连接都必须注册
+ * 同一函数，否则写入报 "no such function"。
+ */
+struct SqlFunction {
+  QString name;                          ///< 函数名
+  int argc = -1;                         ///< 参数个数（-1 为任意个数）
+  bool deterministic = true;             ///< 是否确定性
+  SqlFunctionCallback scalar = nullptr;  ///< 标量函数
+  SqlFunctionCallback step = nullptr;    ///< 聚合函数逐行回调
+  SqlFinalCallback finalize = nullptr;   ///< 聚合函数结束回调
+
+  /**
+   * @brief 构造标量函数
+   */
+  static SqlFunction Scalar(const QString& name, int argc,
+                            SqlFunctionCallback func,
+                            bool deterministic = true) {
+    SqlFunction f;
+    f.name = name;
+    f.argc = argc;
+    f.deterministic = deterministic;
+    f.scalar = func;
+    return f;
+  }
+
+  /**
+   * @brief 构造聚合函数
+   */
+  static SqlFunction Aggregate(const QString& name, int argc,
+                               SqlFunctionCallback step,
+                               SqlFinalCallback finalize,
+                               bool deterministic = true) {
+    SqlFunction f;
+    f.name = name;
+    f.argc = argc;
+    f.deterministic = deterministic;
+    f.step = step;
+    f.finalize = finalize;
+    return f;
+  }
+};
+
+/**
+ * @brief 原生 SQL 函数的注册
+ * 各数据库管理器通过 BaseDatabaseManager::sqlFunctions() 声明自己的函数，
+ * 主连接与连接池的每条连接在配置时注册。只在 sqlite_native 构建中可用，
+ * 其他构建调用方应以 available() 判断并退回 C++ 侧过滤。
+ */
+class SqlFunctions {
+ public:
+  /**
+   * @brief 本构建是否支持原生函数
+   */
+  static bool available();
+
+  /**
+   * @brief 在一条连接上注册函数
+   * @param db 已打开的QSQLITE连接
+   * @param functions 函数列表
+   * @param error 失败时的错误信息（可为nullptr）
+   * @return 是否全部注册成功（列表为空时为true）
+   */
+  static bool apply(const QSqlDatabase& db, const QList<SqlFunction>& functions,
+                    QString* error = nullptr);
+};
+
+#ifdef DB_SQLITE_NATIVE
+/**
+ * @brief 函数实现中读取参数、设置结果的辅助
+ */
+namespace SqlFunctionValue {
+
+/// 参数是否为 NULL
+inline bool isNull(sqlite3_value* v) {
+  return sqlite3_value_type(v) == SQLITE_NULL;
+}
+
+/// 以 QString 读取文本参数（NULL 为空 QString）
+inline QString text(sqlite3_value* v) {
+  const void* data = sqlite3_value_text16(v);
+  if (!data) return QString();
+  return QString(static_cast<const QChar*>(data),
+                 sqlite3_value_bytes16(v) / sizeof(QChar));
+}
+
+/// 读取时间参数：整数/实数为 Unix 秒，文本按 ISO 8601（同 QSQLITE 的存储）
+inline QDateTime dateTime(sqlite3_value* v) {
+  switch (sqlite3_value_type(v)) {
+    case SQLITE_INTEGER:
+    case SQLITE_FLOAT:
+      return QDateTime::fromMSecsSinceEpoch(
+          static_cast<qint64>(sqlite3_value_double(v) * 1000.0));
+    case SQLITE_TEXT:
+      return QDateTime::fromString(text(v), Qt::ISODate);
+    default:
+      return QDateTime();
+  }
+}
+
+/// 设置文本结果（空 QString 为 NULL）
+inline void resultText(sqlite3_context* ctx, const QString& s) {
+  if (s.isNull()) {
+    sqlite3_result_null(ctx);
+    return;
+  }
+  sqlite3_result_text16(ctx, s.utf16(), s.size() * sizeof(QChar),
+                        SQLITE_TRANSIENT);
+}
+
+}  // namespace SqlFunctionValue
+#endif  // DB_SQLITE_NATIVE
+
+#endif  // SQL_FUNCTIONS_H
@@ -0,0 +1,139 @@
+﻿// SqliteMemory.cpp - SQLite 内存与页缓存统计实现
+#include "SqliteMemory.h"
+
+#include "SqliteNative.h"
+
+namespace {
+
+#ifdef DB_SQLITE_NATIVE
+/// 读取一项连接状态；current 为当前值，highwater 为峰值
+void dbStatus(sqlite3* db, int op, qint64* current, qint64* highwater) {
+  int cur = 0;
+  int hi = 0;
+  if (sqlite3_db_status(db, op, &cur, &hi, 0) != SQLITE_OK) return;
+  if (current) *current = cur;
+  if (highwater) *highwater = hi;
+}
+
+/// 读取一项进程状态
+void processStatus(int op, qint64* current, qint64* highwater) {
+  sqlite3_int64 cur = 0;
+  sqlite3_int64 hi = 0;
+  if (sqlite3_status64(op, &cur, &hi, 0) != SQLITE_OK) return;
+  if (current) *current = cur;
+  if (highwater) *highwater = hi;
+}
+#endif
+
+}  // namespace
+
+void SqliteMemoryStats::merge(const SqliteMemoryStats& other) {
+  available = available || other.available;
+  connections += other.connections;
+  cacheUsedBytes += other.cacheUsedBytes;
+  cacheHits += other.cacheHits;
+  cacheMisses += other.cacheMisses;
+  cacheWrites += other.cacheWrites;
+  cacheSpills += other.cacheSpills;
+  schemaBytes += other.schemaBytes;
+  statementBytes += other.statementBytes;
+  lookasideUsed += other.lookasideUsed;
+  lookasideHits += other.lookasideHits;
+  lookasideMissSize += other.lookasideMissSize;
+  lookasideMissFull += other.lookasideMissFull;
+}
+
+QJsonObject SqliteMemoryStats::toJson() const {
+  QJsonObject o;
+  o["available"] = available;
+  o["connections"] = connections;
+  o["cacheUsedBytes"] = cacheUsedBytes;
+  o["cacheHits"] = cacheHits;
+  o["cacheMisses"] = cacheMisses;
+  o["cacheHitRate"] = cacheHitRate();
+  o["cacheWrites"] = cacheWrites;
+  o["cacheSpills"] = cacheSpills;
+  o["schemaBytes"] = schemaBytes;
+  o["statementBytes"] = statementBytes;
+  o["lookasideUsed"] = lookasideUsed;
+  o["lookasideHits"] = lookasideHits;
+  o["lookasideMissSize"] = lookasideMissSize;
+  o["lookasideMissFull"] = lookasideMissFull;
+  return o;
+}
+
+QJsonObject SqliteProcessStats::toJson() const {
+  QJsonObject o;
+  o["available"] = available;
+  o["memoryUsedBytes"] = memoryUsedBytes;
+  o["memoryHighwaterBytes"] = memoryHighwaterBytes;
+  o["mallocCount"] = mallocCount;
+  o["largestAllocationBytes"] = largestAllocationBytes;
+  o["pageCacheUsedPages"] = pageCacheUsedPages;
+  o["pageCacheOverflowBytes"] = pageCacheOverflowBytes;
+  return o;
+}
+
+bool SqliteMemory::available() {
+#ifdef DB_SQLITE_NATIVE
+  return true;
+#else
+  return false;
+#endif
+}
+
+void* SqliteMemory::nativeHandle(const QSqlDatabase& db) {
+#ifdef DB_SQLITE_NATIVE
+  return SqliteNative::handle(db);
+#else
+  Q_UNUSED(db);
+  return nullptr;
+#endif
+}
+
+SqliteMemoryStats SqliteMemory::connection(void* handle) {
+  SqliteMemoryStats st;
+#ifdef DB_SQLITE_NATIVE
+  auto* db = static_cast<sqlite3*>(handle);
+  if (!db) return st;
+  st.available = true;
+  st.connections = 1;
+  dbStatus(db, SQLITE_DBSTATUS_CACHE_USED, &st.cacheUsedBytes, nullptr);
+  dbStatus(db, SQLITE_DBSTATUS_CACHE_HIT, &st.cacheHits, nullptr);
+  dbStatus(db, SQLITE_DBSTATUS_CACHE_MISS, &st.cacheMisses, nullptr);
+  dbStatus(db, SQLITE_DBSTATUS_CACHE_WRITE, &st.cacheWrites, nullptr);
+#ifdef SQLITE_DBSTATUS_CACHE_SPILL
+  // 3.23 起提供
+  dbStatus(db, SQLITE_DBSTATUS_CACHE_SPILL, &st.cacheSpills, nullptr);
+#endif
+  dbStatus(db, SQLITE_DBSTATUS_SCHEMA_USED, &st.schemaBytes, nullptr);
+  dbStatus(db, SQLITE_DBSTATUS_STMT_USED, &st.statementBytes, nullptr);
+  dbStatus(db, SQLITE_DBSTATUS_LOOKASIDE_USED, &st.lookasideUsed, nullptr);
+  // lookaside 的三项计数放在峰值位
+  dbStatus(db, SQLITE_DBSTATUS_LOOKASIDE_HIT, nullptr, &st.lookasideHits);
+  dbStatus(db, SQLITE_DBSTATUS_LOOKASIDE_MISS_SIZE, nullptr,
+           &st.lookasideMissSize);
+  dbStatus(db, SQLITE_DBSTATUS_LOOKASIDE_MISS_FULL, nullptr,
+           &st.lookasideMissFull);
+#else
+  Q_UNUSED(handle);
+#endif
+  return st;
+}
+
+SqliteProcessStats SqliteMemory::process() {
+  SqliteProcessStats st;
+#ifdef DB_SQLITE_NATIVE
+  st.available = true;
+  processStatus(SQLITE_STATUS_MEMORY_USED, &st.memoryUsedBytes,
+                &st.memoryHighwaterBytes);
+  processStatus(SQLITE_STATUS_MALLOC_COUNT, &st.mallocCount, nullptr);
+  processStatus(SQLITE_STATUS_MALLOC_SIZE, nullptr,
+                &st.largestAllocationBytes);
+  processStatus(SQLITE_STATUS_PAGECACHE_USED, &st.pageCacheUsedPages,
+                nullptr);
+  processStatus(SQLITE_STATUS_PAGECACHE_OVERFLOW, &st.pageCacheOverflowBytes,
+                nullptr);
+#endif
+  return st;
+}
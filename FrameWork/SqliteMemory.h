@@ -0,0 +1,102 @@
+﻿// SqliteMemory.h - SQLite 内存与页缓存统计
+#ifndef SQLITE_MEMORY_H
+#define SQLITE_MEMORY_H
+
+#include <QJsonObject>
+#include <QSqlDatabase>
+#include <QString>
+#include <QtGlobal>
+
+/**
+ * @brief 连接级内存与页缓存统计（sqlite3_db_status）
+ * 单条连接的值，或同一数据库多条连接的合计（connections 为连接数）。
+ * 命中/未命中/写入/溢出为连接打开以来的累计值，连接关闭后随之消失。
+ */
+struct SqliteMemoryStats {
+  bool available = false;        ///< 是否采集到（非 sqlite_native 构建为false）
+  int connections = 0;           ///< 参与统计的连接数
+  qint64 cacheUsedBytes = 0;     ///< 页缓存占用字节
+  qint64 cacheHits = 0;          ///< 页缓存命中次数
+  qint64 cacheMisses = 0;        ///< 页缓存未命中次数
+  qint64 cacheWrites = 0;        ///< 写回磁盘的脏页数
+  qint64 cacheSpills = 0;        ///< 事务中途因缓存满溢出的脏页数
+  qint64 schemaBytes = 0;        ///< 模式（表结构）占用字节
+  qint64 statementBytes = 0;     ///< 预编译语句占用字节
+  qint64 lookasideUsed = 0;      ///< 当前占用的 lookaside 槽数
+  qint64 lookasideHits = 0;      ///< 由 lookaside 满足的分配次数
+  qint64 lookasideMissSize = 0;  ///< 因请求过大未用 lookaside 的次数
+  qint64 lookasideMissFull = 0;  ///< 因 lookaside 用尽未用的次数
+
+  /**
+   * @brief 页缓存命中率
+   * @return 0~1（无访问时为0）
+   */
+  double cacheHitRate() const {
+    const qint64 total = cacheHits + cacheMisses;
+    return total > 0 ? static_cast<double>(cacheHits) / total : 0.0;
+  }
+
+  /**
+   * @brief 累加另一条连接（或另一组连接）的统计
+   */
+  void merge(const SqliteMemoryStats& other);
+
+  /**
+   * @brief 转为JSON（字段名同成员名，另含 cacheHitRate）
+   */
+  QJsonObject toJson() const;
+};
+
+/**
+ * @brief 进程级内存统计（sqlite3_status64，进程内所有连接共享）
+ */
+struct SqliteProcessStats {
+  bool available = false;             ///< 是否采集到
+  qint64 memoryUsedBytes = 0;         ///< 当前经 SQLite 分配的内存
+  qint64 memoryHighwaterBytes = 0;    ///< 内存占用峰值
+  qint64 mallocCount = 0;             ///< 当前未释放的分配块数
+  qint64 largestAllocationBytes = 0;  ///< 单次分配的最大字节
+  qint64 pageCacheUsedPages = 0;      ///< 预分配页缓存中已用的页数
+  qint64 pageCacheOverflowBytes = 0;  ///< 预分配页缓存放不下而走堆的字节
+
+  /**
+   * @brief 转为JSON（字段名同成员名）
+   */
+  QJsonObject toJson() const;
+};
+
+/**
+ * @brief SQLite 内存统计的采集入口
+ * 仅以 sqlite_native 构建时可用，否则各函数返回 available 为 false 的
+ * 空统计。连接句柄在建立连接时取得并由连接池保存：sqlite3_db_status
+ * 在串行化线程模式（SQLite 默认）下持有连接自身的互斥锁，可从任意线程
+ * 读取其他线程正在使用的连接。
+ */
+class SqliteMemory {
+ public:
+  /**
+   * @brief 是否可以采集（即是否以 sqlite_native 构建）
+   */
+  static bool available();
+
+  /**
+   * @brief 取得连接的 sqlite3 句柄
+   * @param db 已打开的QSQLITE连接
+   * @return 句柄（不可用时为nullptr）
+   */
+  static void* nativeHandle(const QSqlDatabase& db);
+
+  /**
+   * @brief 采集单条连接的统计
+   * @param handle nativeHandle 返回的句柄（连接须仍打开）
+   * @return 连接统计（connections 为1）
+   */
+  static SqliteMemoryStats connection(void* handle);
+
+  /**
+   * @brief 采集进程级统计
+   */
+  static SqliteProcessStats process();
+};
+
+#endif  // SQLITE_MEMORY_H
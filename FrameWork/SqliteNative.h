@@ -0,0 +1,33 @@
+﻿// SqliteNative.h - 取得QSQLITE连接底层的sqlite3句柄
+#ifndef SQLITE_NATIVE_H
+#define SQLITE_NATIVE_H
+
+#include <QSqlDatabase>
+#include <QSqlDriver>
+#include <QVariant>
+
+// 以 qmake "CONFIG += sqlite_native" 构建时定义 DB_SQLITE_NATIVE。
+// 要求Qt的QSQLITE驱动与本程序链接同一份 sqlite3（驱动以 -system-sqlite
+// 构建），否则句柄属于驱动内置的另一份库，不可直接调用C API。
+#ifdef DB_SQLITE_NATIVE
+#include <sqlite3.h>
+
+namespace SqliteNative {
+
+/**
+ * @brief 取得连接的底层句柄
+ * @param db 已打开的QSQLITE连接
+ * @return sqlite3句柄（非QSQLITE或未打开时为nullptr）
+ */
+inline sqlite3* handle(const QSqlDatabase& db) {
+  if (!db.isOpen() || !db.driver()) return nullptr;
+  const QVariant v = db.driver()->handle();
+  if (!v.isValid() || qstrcmp(v.typeName(), "sqlite3*") != 0) return nullptr;
+  return *static_cast<sqlite3* const*>(v.constData());
+}
+
+}  // namespace SqliteNative
+
+#endif  // DB_SQLITE_NATIVE
+
+#endif  // SQLITE_NATIVE_H
@@ -0,0 +1,83 @@
+﻿// StartupProfile.cpp - 启动阶段计时实现
+#include "StartupProfile.h"
+
+#include <QJsonArray>
+#include <QStringList>
+
+StartupProfile::Scope::Scope(StartupProfile* profile, const QString& name)
+    : m_profile(profile->running() ? profile : nullptr),
+      m_index(profile->m_phases.size()) {
+  if (!m_profile) return;
+  StartupPhase phase;
+  phase.name = name;
+  phase.depth = profile->m_depth++;
+  phase.startUs = profile->m_clock.nsecsElapsed() / 1000;
+  phase.durationUs = -1;
+  profile->m_phases.append(phase);
+}
+
+StartupProfile::Scope::~Scope() { finish(); }
+
+void StartupProfile::Scope::finish() {
+  if (!m_profile) return;
+  StartupPhase& phase = m_profile->m_phases[m_index];
+  phase.durationUs = m_profile->m_clock.nsecsElapsed() / 1000 - phase.startUs;
+  --m_profile->m_depth;
+  m_profile = nullptr;
+}
+
+bool StartupProfile::Scope::fail() {
+  if (m_profile) m_profile->m_phases[m_index].ok = false;
+  return false;
+}
+
+void StartupProfile::begin() {
+  m_phases.clear();
+  m_depth = 0;
+  m_totalUs = -1;
+  m_ok = false;
+  m_clock.start();
+}
+
+void StartupProfile::finish(bool ok) {
+  m_totalUs = m_clock.nsecsElapsed() / 1000;
+  m_ok = ok;
+}
+
+qint64 StartupProfile::totalUs() const {
+  if (m_totalUs >= 0) return m_totalUs;
+  return m_clock.isValid() ? m_clock.nsecsElapsed() / 1000 : 0;
+}
+
+QJsonObject StartupProfile::toJson() const {
+  QJsonArray phases;
+  for (const StartupPhase& p : m_phases) {
+    QJsonObject o;
+    o["name"] = p.name;
+    o["depth"] = p.depth;
+    o["startUs"] = p.startUs;
+    o["durationUs"] = p.durationUs;
+    o["ok"] = p.ok;
+    phases.append(o);
+  }
+  QJsonObject root;
+  root["totalUs"] = totalUs();
+  root["ok"] = m_ok;
+  root["phases"] = phases;
+  return root;
+}
+
+QString StartupProfile::summary() const {
+  QStringList lines;
+  lines << QString("启动耗时 %1 ms%2")
+               .arg(totalUs() / 1000.0, 0, 'f', 2)
+               .arg(m_ok ? "" : "（失败）");
+  for (const StartupPhase& p : m_phases) {
+    lines << QString("%1%2 %3 ms%4")
+                 .arg(QString((p.depth + 1) * 2, ' '))
+                 .arg(p.name, -40 + p.depth * 2)
+                 .arg(p.durationUs / 1000.0, 8, 'f', 2)
+                 .arg(p.ok ? "" : "  失败");
+  }
+  return lines.join('\n') + '\n';
+}
@@ -0,0 +1,113 @@
+﻿// StartupProfile.h - 启动阶段计时
+#ifndef STARTUP_PROFILE_H
+#define STARTUP_PROFILE_H
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief 一个启动阶段
+ */
+struct StartupPhase {
+  QString name;           ///< 阶段名，如 "pragma.journal_mode"
+  int depth = 0;          ///< 嵌套层级（0 为顶层）
+  qint64 startUs = 0;     ///< 相对 begin() 的开始时间
+  qint64 durationUs = 0;  ///< 耗时（未结束时为 -1）
+  bool ok = true;         ///< 是否成功
+};
+
+/**
+ * @brief 启动阶段计时器
+ * 按开始顺序记录各阶段（可嵌套）的开始时间与耗时，供启动报告与启动
+ * 基准使用。只在初始化线程上使用，不加锁；每次 begin() 清空上一次的
+ * 记录，重新初始化的库只保留最近一次启动。begin() 与 finish() 之外
+ * 构造的 Scope 不记录（如启动后再次调用 createAllTables）。
+ */
+class StartupProfile {
+ public:
+  /**
+   * @brief 阶段守卫：构造时开始，析构时结束
+   */
+  class Scope {
+   public:
+    /**
+     * @brief 构造函数
+     * @param profile 计时器
+     * @param name 阶段名
+     */
+    Scope(StartupProfile* profile, const QString& name);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    /**
+     * @brief 提前结束本阶段（之后的工作不再计入）
+     */
+    void finish();
+
+    /**
+     * @brief 标记本阶段失败
+     * @return 总是 false，便于 return scope.fail();
+     */
+    bool fail();
+
+   private:
+    StartupProfile* m_profile;  ///< 计时器（不记录时为nullptr）
+    int m_index;                ///< 阶段在 m_phases 中的下标
+  };
+
+  /**
+   * @brief 开始一次启动（清空之前的记录）
+   */
+  void begin();
+
+  /**
+   * @brief 结束本次启动
+   * @param ok 启动是否成功
+   */
+  void finish(bool ok);
+
+  /**
+   * @brief 获取各阶段（按开始顺序）
+   */
+  const QVector<StartupPhase>& phases() const { return m_phases; }
+
+  /**
+   * @brief 是否处于 begin() 与 finish() 之间
+   */
+  bool running() const { return m_clock.isValid() && m_totalUs < 0; }
+
+  /**
+   * @brief 启动总耗时（微秒，未 finish 时为到目前为止的耗时）
+   */
+  qint64 totalUs() const;
+
+  /**
+   * @brief 启动是否成功
+   */
+  bool ok() const { return m_ok; }
+
+  /**
+   * @brief 转为JSON
+   * @return {"totalUs", "ok", "phases": [{name, depth, startUs, durationUs,
+   *         ok}]}
+   */
+  QJsonObject toJson() const;
+
+  /**
+   * @brief 可读的阶段耗时表（按嵌套缩进）
+   */
+  QString summary() const;
+
+ private:
+  QElapsedTimer m_clock;           ///< 自 begin() 起计时
+  QVector<StartupPhase> m_phases;  ///< 各阶段
+  int m_depth = 0;                 ///< 当前嵌套层级
+  qint64 m_totalUs = -1;           ///< 总耗时（finish 后有效）
+  bool m_ok = false;               ///< 启动是否成功
+};
+
+#endif  // STARTUP_PROFILE_H
@@ -0,0 +1,72 @@
+﻿// StringInterner.cpp - 低基数字符串列的驻留池实现
+#include "StringInterner.h"
+
+StringInterner::StringInterner(int maxEntries, int maxLength)
+    : m_maxEntries(maxEntries), m_maxLength(maxLength) {}
+
+QString StringInterner::intern(const QString& s) {
+  if (s.isEmpty()) return s;
+  return lookup(QStringView(s), &s);
+}
+
+QString StringInterner::intern(QStringView s) {
+  if (s.isNull()) return QString();
+  if (s.isEmpty()) return QStringLiteral("");
+  if (!m_viewLookup.load(std::memory_order_relaxed)) {
+    const QString owned = s.toString();
+    return lookup(QStringView(owned), &owned);
+  }
+  return lookup(s, nullptr);
+}
+
+QString StringInterner::lookup(QStringView s, const QString* source) {
+  if (s.size() > m_maxLength) {
+    m_rejected.fetch_add(1, std::memory_order_relaxed);
+    return source ? *source : s.toString();
+  }
+
+  const uint hash = qHash(s);
+  {
+    QReadLocker locker(&m_lock);
+    if (const QString* hit = findLocked(s, hash)) {
+      m_hits.fetch_add(1, std::memory_order_relaxed);
+      return *hit;
+    }
+  }
+
+  // 读锁与写锁之间可能已被其他线程驻留，持写锁后重查
+  QWriteLocker locker(&m_lock);
+  if (const QString* hit = findLocked(s, hash)) {
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    return *hit;
+  }
+  if (m_pool.size() >= m_maxEntries) {
+    m_rejected.fetch_add(1, std::memory_order_relaxed);
+    return source ? *source : s.toString();
+  }
+  m_misses.fetch_add(1, std::memory_order_relaxed);
+  return m_pool.insert(hash, source ? *source : s.toString()).value();
+}
+
+const QString* StringInterner::findLocked(QStringView s, uint hash) const {
+  for (auto it = m_pool.constFind(hash);
+       it != m_pool.constEnd() && it.key() == hash; ++it) {
+    if (QStringView(it.value()) == s) return &it.value();
+  }
+  return nullptr;
+}
+
+void StringInterner::clear() {
+  QWriteLocker locker(&m_lock);
+  m_pool.clear();
+}
+
+StringInterner::Stats StringInterner::stats() const {
+  Stats st;
+  st.hits = m_hits.load(std::memory_order_relaxed);
+  st.misses = m_misses.load(std::memory_order_relaxed);
+  st.rejected = m_rejected.load(std::memory_order_relaxed);
+  QReadLocker locker(&m_lock);
+  st.entries = m_pool.size();
+  return st;
+}
@@ -0,0 +1,118 @@
+﻿// StringInterner.h - 低基数字符串列的驻留池
+#ifndef STRING_INTERNER_H
+#define STRING_INTERNER_H
+
+#include <QMultiHash>
+#include <QReadWriteLock>
+#include <QString>
+#include <QStringView>
+#include <QVariant>
+#include <atomic>
+
+/**
+ * @brief 字符串驻留池
+ * 行解码时把低基数列（制造商、连接方式等）的值换成池中共享的隐式共享
+ * QString：相同取值的各行共用一份字符数据，解码出的临时串随即释放，
+ * 大结果集的内存占用随之下降。命中只取读锁，多线程解码互不阻塞。
+ * 池按内容哈希分桶，可直接用 QStringView 查找：原生路径的解码以列值在
+ * SQLite 缓冲区中的 UTF-16 视图查池，命中时不构造临时串。
+ *
+ * 池有界：条目数达到上限或字符串过长时不再驻留，原样返回输入，
+ * 因此误把高基数列声明为低基数只会损失驻留效果，不会无限增长。
+ */
+class StringInterner {
+ public:
+  static constexpr int kDefaultMaxEntries = 1024;  ///< 默认最大条目数
+  static constexpr int kDefaultMaxLength = 64;     ///< 默认可驻留的最大长度
+
+  /**
+   * @brief 运行计数
+   */
+  struct Stats {
+    quint64 hits = 0;      ///< 命中次数
+    quint64 misses = 0;    ///< 新驻留次数
+    quint64 rejected = 0;  ///< 因池满或过长未驻留的次数
+    int entries = 0;       ///< 当前条目数
+  };
+
+  /**
+   * @brief 构造函数
+   * @param maxEntries 最大条目数
+   * @param maxLength 可驻留的最大字符数
+   */
+  explicit StringInterner(int maxEntries = kDefaultMaxEntries,
+                          int maxLength = kDefaultMaxLength);
+
+  StringInterner(const StringInterner&) = delete;
+  StringInterner& operator=(const StringInterner&) = delete;
+
+  /**
+   * @brief 取得与输入相等的共享字符串
+   * 空串与空值（null）原样返回，保留二者的区别
+   * @param s 输入字符串
+   * @return 池中的共享副本（未驻留时为输入本身）
+   */
+  QString intern(const QString& s);
+
+  /**
+   * @brief 取得与视图内容相等的共享字符串（原生路径解码用）
+   * 命中时不分配内存，只在新驻留或未驻留时构造字符串
+   * @param s 字符视图（空视图读作空值，非空的零长视图读作空串）
+   * @return 池中的共享副本
+   */
+  QString intern(QStringView s);
+
+  /**
+   * @brief 取得列值对应的共享字符串（解码用）
+   * @param v 列值
+   * @return 池中的共享副本
+   */
+  QString intern(const QVariant& v) {
+    if (v.userType() == QMetaType::QString) {
+      return intern(*static_cast<const QString*>(v.constData()));
+    }
+    return intern(v.toString());
+  }
+
+  /**
+   * @brief 启用或停用视图查找（基准测试对比用）
+   * 停用时 intern(QStringView) 先构造字符串再查池，与按 QString 解码相同
+   * @param enabled 是否启用
+   */
+  void setViewLookup(bool enabled) { m_viewLookup.store(enabled); }
+
+  /**
+   * @brief 清空池（已返回的字符串不受影响）
+   */
+  void clear();
+
+  /**
+   * @brief 获取运行计数
+   * @return 计数快照
+   */
+  Stats stats() const;
+
+ private:
+  /**
+   * @brief 查池，未命中时驻留
+   * @param s 待查内容（非空）
+   * @param source 与 s 内容相同的现成字符串（可为nullptr，此时按需构造）
+   */
+  QString lookup(QStringView s, const QString* source);
+
+  /// 池中与 s 相等的条目（调用方持锁）
+  const QString* findLocked(QStringView s, uint hash) const;
+
+  const int m_maxEntries;
+  const int m_maxLength;
+  std::atomic<bool> m_viewLookup{true};
+
+  mutable QReadWriteLock m_lock;  ///< 命中取读锁，驻留取写锁
+  QMultiHash<uint, QString> m_pool;  ///< 内容哈希 → 字符串
+
+  std::atomic<quint64> m_hits{0};
+  std::atomic<quint64> m_misses{0};
+  std::atomic<quint64> m_rejected{0};
+};
+
+#endif  // STRING_INTERNER_H
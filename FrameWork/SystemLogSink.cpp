@@ -0,0 +1,169 @@
+﻿// SystemLogSink.cpp - 系统日志异步汇聚器实现
+#include "SystemLogSink.h"
+
+#include <QDateTime>
+#include <QThread>
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+QtMessageHandler s_previousHandler = nullptr;  ///< 安装前的消息处理器
+std::atomic<bool> s_handlerInstalled{false};
+
+LogLevel toLogLevel(QtMsgType type) {
+  switch (type) {
+    case QtDebugMsg:
+      return LogLevel::DEBUG;
+    case QtInfoMsg:
+      return LogLevel::INFO;
+    case QtWarningMsg:
+      return LogLevel::WARNING;
+    case QtCriticalMsg:
+      return LogLevel::ERROR;
+    case QtFatalMsg:
+      return LogLevel::CRITICAL;
+  }
+  return LogLevel::INFO;
+}
+
+QtMsgType toMsgType(LogLevel level) {
+  switch (level) {
+    case LogLevel::DEBUG:
+      return QtDebugMsg;
+    case LogLevel::INFO:
+      return QtInfoMsg;
+    case LogLevel::WARNING:
+      return QtWarningMsg;
+    case LogLevel::ERROR:
+    case LogLevel::CRITICAL:
+      return QtCriticalMsg;
+  }
+  return QtInfoMsg;
+}
+
+// 直接交给原处理器输出，绕开 qInfo() 以免再次进入汇聚器
+void forwardToPrevious(QtMsgType type, const QMessageLogContext& context,
+                       const QString& msg) {
+  if (s_previousHandler) {
+    s_previousHandler(type, context, msg);
+  } else {
+    fprintf(stderr, "%s\n", msg.toLocal8Bit().constData());
+    fflush(stderr);
+  }
+}
+
+}  // namespace
+
+// ============================================================================
+// SystemLogSink实现
+// ============================================================================
+
+SystemLogSink::~SystemLogSink() { stop(); }
+
+SystemLogSink* SystemLogSink::instance() {
+  // 函数内静态对象：首次调用时线程安全地构造，进程退出时停止写线程
+  static SystemLogSink sink;
+  return &sink;
+}
+
+bool SystemLogSink::start(StoreFn store, const Options& options) {
+  if (m_writer.isRunning()) return false;
+  m_options = options;
+  m_store = std::move(store);
+  return m_writer.start(m_options.writer,
+                        [this](QVector<SystemLogRecord>& batch) {
+                          return writeBatch(batch);
+                        });
+}
+
+void SystemLogSink::stop() {
+  m_writer.stop();
+  m_store = nullptr;
+}
+
+bool SystemLogSink::append(LogLevel level, const QString& source,
+                           const QString& operation, const QString& message) {
+  if (!m_writer.isRunning() || m_writer.isWriterThread()) return false;
+
+  SystemLogRecord record;
+  record.timestampMs = QDateTime::currentMSecsSinceEpoch();
+  record.level = level;
+  record.source = source;  // QString 隐式共享，仅增加引用计数
+  record.operation = operation;
+  record.message = message;
+  record.threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+
+  if (m_writer.push(std::move(record))) return true;
+  // 被丢弃的记录已计入 dropped；视为已接收，避免生产者退回同步 I/O
+  return m_options.writer.overflowPolicy == OverflowPolicy::DROP;
+}
+
+bool SystemLogSink::writeBatch(QVector<SystemLogRecord>& batch) {
+  if (m_options.echoToConsole) {
+    for (const SystemLogRecord& record : batch) echo(record);
+  }
+
+  // 低于落盘级别的记录只回显
+  const int minLevel = static_cast<int>(m_options.persistLevel);
+  auto it = std::remove_if(batch.begin(), batch.end(),
+                           [minLevel](const SystemLogRecord& r) {
+                             return static_cast<int>(r.level) < minLevel;
+                           });
+  batch.erase(it, batch.end());
+
+  if (batch.isEmpty() || !m_store) return true;
+  return m_store(batch);
+}
+
+void SystemLogSink::echo(const SystemLogRecord& record) const {
+  QString text;
+  if (record.operation.isEmpty()) {
+    text = record.message;
+  } else {
+    text = QString("[%1:%2] %3")
+               .arg(QDateTime::fromMSecsSinceEpoch(record.timestampMs)
+                        .toString("yyyy-MM-dd hh:mm:ss"))
+               .arg(record.source)
+               .arg(record.operation);
+    if (!record.message.isEmpty()) {
+      text += QString(" - %1").arg(record.message);
+    }
+  }
+  forwardToPrevious(toMsgType(record.level), QMessageLogContext(), text);
+}
+
+void SystemLogSink::installQtMessageHandler() {
+  if (s_handlerInstalled.exchange(true)) return;
+  s_previousHandler = qInstallMessageHandler(&SystemLogSink::qtMessageHandler);
+}
+
+void SystemLogSink::uninstallQtMessageHandler() {
+  if (!s_handlerInstalled.exchange(false)) return;
+  qInstallMessageHandler(s_previousHandler);
+  s_previousHandler = nullptr;
+}
+
+void SystemLogSink::qtMessageHandler(QtMsgType type,
+                                     const QMessageLogContext& context,
+                                     const QString& msg) {
+  SystemLogSink* sink = instance();
+
+  // 致命消息：先尽量写出积压日志，再交给原处理器终止进程
+  if (type == QtFatalMsg) {
+    sink->flush(1000);
+    forwardToPrevious(type, context, msg);
+    return;
+  }
+
+  static const QString kDefaultSource = QStringLiteral("Qt");
+  const bool isDefault =
+      !context.category || qstrcmp(context.category, "default") == 0;
+  const QString source =
+      isDefault ? kDefaultSource : QString::fromLatin1(context.category);
+
+  // 写线程自身产生的消息（如刷写失败告警）直接输出，避免自我回灌
+  if (!sink->append(toLogLevel(type), source, QString(), msg)) {
+    forwardToPrevious(type, context, msg);
+  }
+}
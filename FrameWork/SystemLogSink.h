@@ -0,0 +1,135 @@
+﻿// SystemLogSink.h - 系统日志异步汇聚器
+#ifndef SYSTEM_LOG_SINK_H
+#define SYSTEM_LOG_SINK_H
+
+#include <QString>
+#include <QtGlobal>
+
+#include "AsyncBatchWriter.h"
+#include "DatabaseFramework.h"
+
+/**
+ * @brief 系统日志记录
+ * 生产者只填充原始字段（时间戳为毫秒整数），格式化推迟到写线程
+ */
+struct SystemLogRecord {
+  qint64 id = -1;                  ///< 记录ID（落盘后有效）
+  qint64 timestampMs = 0;          ///< 时间戳（自纪元起毫秒）
+  LogLevel level = LogLevel::INFO;  ///< 日志级别
+  QString source;                  ///< 来源（表名或Qt日志分类）
+  QString operation;               ///< 操作名称（Qt消息为空）
+  QString message;                 ///< 详细信息
+  quint64 threadId = 0;            ///< 产生日志的线程ID
+};
+
+/**
+ * @brief 系统日志汇聚器（进程级单例）
+ * BaseTableOperations::logOperation() 与 Qt 消息处理器都把记录压入无锁队列，
+ * 由后台线程批量写入 SYSTEM_LOG 表并按需回显到控制台。
+ * 未启动时 append() 返回false，调用方退回同步输出。
+ */
+class SystemLogSink {
+ public:
+  /// 持久化回调：在写线程中调用，需在一个事务内写完整批记录
+  using StoreFn = std::function<bool(QVector<SystemLogRecord>&)>;
+
+  /**
+   * @brief 汇聚器参数
+   */
+  struct Options {
+    AsyncBatchWriter<SystemLogRecord>::Options writer;  ///< 队列与批次参数
+    LogLevel persistLevel = LogLevel::INFO;  ///< 落盘的最低级别
+    bool echoToConsole = true;               ///< 是否由写线程回显到控制台
+  };
+
+  using Stats = AsyncBatchWriter<SystemLogRecord>::Stats;
+
+ private:
+  AsyncBatchWriter<SystemLogRecord> m_writer;
+  Options m_options;
+  StoreFn m_store;
+
+  SystemLogSink() = default;
+
+  bool writeBatch(QVector<SystemLogRecord>& batch);
+  void echo(const SystemLogRecord& record) const;
+
+ public:
+  ~SystemLogSink();
+
+  SystemLogSink(const SystemLogSink&) = delete;
+  SystemLogSink& operator=(const SystemLogSink&) = delete;
+
+  /**
+   * @brief 获取单例
+   * @return 汇聚器指针
+   */
+  static SystemLogSink* instance();
+
+  /**
+   * @brief 启动后台写线程
+   * @param store 持久化回调（为空时只回显不落盘）
+   * @param options 汇聚器参数
+   * @return 是否启动（已运行时返回false）
+   */
+  bool start(StoreFn store, const Options& options = Options());
+
+  /**
+   * @brief 停止后台写线程，退出前写完队列中的记录
+   */
+  void stop();
+
+  /**
+   * @brief 是否正在运行
+   * @return 是否运行
+   */
+  bool isRunning() const { return m_writer.isRunning(); }
+
+  /**
+   * @brief 当前线程是否为汇聚器写线程
+   * @return 是否为写线程
+   */
+  bool isWriterThread() const { return m_writer.isWriterThread(); }
+
+  /**
+   * @brief 追加一条日志（仅拷贝参数并入队）
+   * @param level 日志级别
+   * @param source 来源
+   * @param operation 操作名称
+   * @param message 详细信息
+   * @return 是否已被汇聚器接收
+   */
+  bool append(LogLevel level, const QString& source, const QString& operation,
+              const QString& message);
+
+  /**
+   * @brief 等待已入队日志全部写出
+   * @param timeoutMs 最长等待时间（毫秒）
+   * @return 是否在超时前写完
+   */
+  bool flush(int timeoutMs = 5000) { return m_writer.flush(timeoutMs); }
+
+  /**
+   * @brief 获取运行计数（入队/丢弃/阻塞/写出/批次）
+   * @return 计数快照
+   */
+  Stats stats() const { return m_writer.stats(); }
+
+  /**
+   * @brief 安装 Qt 消息处理器，把 qDebug/qInfo/qWarning/qCritical 导入汇聚器
+   * 原处理器被保留，用于回显以及汇聚器未运行时的同步输出
+   */
+  static void installQtMessageHandler();
+
+  /**
+   * @brief 恢复安装前的 Qt 消息处理器
+   */
+  static void uninstallQtMessageHandler();
+
+ private:
+  static void qtMessageHandler(QtMsgType type,
+                               const QMessageLogContext& context,
+                               const QString& msg);
+};
+
+#endif  // SYSTEM_LOG_SINK_H
@@ -0,0 +1,158 @@
+﻿// TableQuery.cpp - 表的条件查询构建器实现
+#include "TableQuery.h"
+
+namespace {
+
+const char* opText(QueryOp op) {
+  switch (op) {
+    case QueryOp::EQ:
+      return " = ?";
+    case QueryOp::NE:
+      return " != ?";
+    case QueryOp::LT:
+      return " < ?";
+    case QueryOp::LE:
+      return " <= ?";
+    case QueryOp::GT:
+      return " > ?";
+    case QueryOp::GE:
+      return " >= ?";
+    case QueryOp::LIKE:
+      return " LIKE ?";
+    case QueryOp::IS_NULL:
+      return " IS NULL";
+    case QueryOp::NOT_NULL:
+      return " IS NOT NULL";
+  }
+  return " = ?";
+}
+
+/// IN 列表的分档长度：不小于 n 的 2 的幂
+int inBucket(int n) {
+  int bucket = 1;
+  while (bucket < n) bucket <<= 1;
+  return bucket;
+}
+
+}  // namespace
+
+TableQuery::TableQuery(const QString& table, const QVector<ColumnSpec>& columns)
+    : m_table(table), m_columns(columns) {
+  if (m_table.isEmpty() || m_columns.isEmpty()) fail("该表不支持条件查询");
+}
+
+TableQuery& TableQuery::select(const QStringList& columns) {
+  m_projection.clear();
+  for (const QString& column : columns) {
+    const int index = columnIndex(column);
+    if (index >= 0) m_projection.append(index);
+  }
+  return *this;
+}
+
+TableQuery& TableQuery::where(const QString& column, QueryOp op,
+                              const QVariant& value) {
+  const int index = columnIndex(column);
+  if (index < 0) return *this;
+  m_conditions << m_columns[index].name + opText(op);
+  if (op != QueryOp::IS_NULL && op != QueryOp::NOT_NULL) {
+    m_whereValues << value;
+  }
+  return *this;
+}
+
+TableQuery& TableQuery::whereIn(const QString& column,
+                                const QVariantList& values) {
+  const int index = columnIndex(column);
+  if (index < 0) return *this;
+  if (values.isEmpty()) {
+    m_conditions << "0";
+    return *this;
+  }
+  const int bucket = inBucket(values.size());
+  if (bucket > kMaxInValues) {
+    fail(QString("IN 列表过长: %1（上限 %2）")
+             .arg(values.size())
+             .arg(kMaxInValues));
+    return *this;
+  }
+  QStringList marks;
+  for (int i = 0; i < bucket; ++i) marks << "?";
+  m_conditions << m_columns[index].name + " IN (" + marks.join(", ") + ")";
+  m_whereValues << values;
+  for (int i = values.size(); i < bucket; ++i) m_whereValues << values.last();
+  return *this;
+}
+
+TableQuery& TableQuery::whereBetween(const QString& column,
+                                     const QVariant& low,
+                                     const QVariant& high) {
+  const int index = columnIndex(column);
+  if (index < 0) return *this;
+  m_conditions << m_columns[index].name + " BETWEEN ? AND ?";
+  m_whereValues << low << high;
+  return *this;
+}
+
+TableQuery& TableQuery::orderBy(const QString& column, bool ascending) {
+  const int index = columnIndex(column);
+  if (index >= 0) {
+    m_orderBy << m_columns[index].name + (ascending ? " ASC" : " DESC");
+  }
+  return *this;
+}
+
+TableQuery& TableQuery::limit(int count, qint64 offset) {
+  if (count < 0 || offset < 0) {
+    fail(QString("无效的行数限制: %1 OFFSET %2").arg(count).arg(offset));
+    return *this;
+  }
+  m_limit = count;
+  m_offset = offset;
+  return *this;
+}
+
+QVector<ColumnSpec> TableQuery::resultColumns() const {
+  if (m_projection.isEmpty()) return m_columns;
+  QVector<ColumnSpec> columns;
+  columns.reserve(m_projection.size());
+  for (int index : m_projection) columns.append(m_columns[index]);
+  return columns;
+}
+
+QString TableQuery::sql() const {
+  QStringList names;
+  for (const ColumnSpec& column : resultColumns()) names << column.name;
+  QString sql = "SELECT " + names.join(", ") + " FROM " + m_table;
+  sql += whereClause();
+  if (!m_orderBy.isEmpty()) sql += " ORDER BY " + m_orderBy.join(", ");
+  if (m_limit >= 0) sql += " LIMIT ? OFFSET ?";
+  return sql;
+}
+
+QVariantList TableQuery::bindValues() const {
+  QVariantList values = m_whereValues;
+  if (m_limit >= 0) values << m_limit << m_offset;
+  return values;
+}
+
+QString TableQuery::countSql() const {
+  return "SELECT COUNT(*) FROM " + m_table + whereClause();
+}
+
+int TableQuery::columnIndex(const QString& column) {
+  for (int i = 0; i < m_columns.size(); ++i) {
+    if (m_columns[i].name == column) return i;
+  }
+  fail(QString("列不在白名单内: %1.%2").arg(m_table, column));
+  return -1;
+}
+
+void TableQuery::fail(const QString& error) {
+  if (m_error.isEmpty()) m_error = error;
+}
+
+QString TableQuery::whereClause() const {
+  return m_conditions.isEmpty() ? QString()
+                                : " WHERE " + m_conditions.join(" AND ");
+}
@@ -0,0 +1,147 @@
+﻿// TableQuery.h - 表的条件查询构建器
+#ifndef TABLE_QUERY_H
+#define TABLE_QUERY_H
+
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVariantList>
+#include <QVector>
+
+#include "ColumnarResult.h"
+
+/**
+ * @brief 单列比较条件
+ */
+enum class QueryOp {
+  EQ,       ///< =
+  NE,       ///< !=
+  LT,       ///< <
+  LE,       ///< <=
+  GT,       ///< >
+  GE,       ///< >=
+  LIKE,     ///< LIKE（值为模式串）
+  IS_NULL,  ///< IS NULL（忽略值）
+  NOT_NULL  ///< IS NOT NULL（忽略值）
+};
+
+/**
+ * @brief 表的条件查询
+ * 以 where / whereIn / whereBetween（多个条件为 AND）、orderBy、limit 与
+ * select（投影）组合查询，列名须在表给出的白名单内，否则查询无效并
+ * 记录错误，执行时原样返回。
+ *
+ * 生成的 SQL 只含参数占位符，取值一律绑定：列、比较符、条件个数与顺序
+ * 相同的查询生成同一段 SQL，即 SQL 文本就是查询的"形状"，可直接作为
+ * 连接上原生语句缓存的键复用预编译语句。LIMIT/OFFSET 同样绑定；IN 列表
+ * 按 2 的幂分档，不足的以末值补齐，不同长度的列表只落在少数几种形状上。
+ *
+ * 由表的 BaseTable::tableQuery() 创建，经 select / selectColumnar / count
+ * 执行。
+ */
+class TableQuery {
+ public:
+  static constexpr int kMaxInValues = 512;  ///< IN 列表上限（补齐后不超过）
+
+  /**
+   * @brief 构造函数
+   * @param table 表名
+   * @param columns 允许的列（白名单，顺序即默认的结果列顺序）
+   */
+  TableQuery(const QString& table, const QVector<ColumnSpec>& columns);
+
+  /**
+   * @brief 只取指定列（投影，按给出顺序）
+   */
+  TableQuery& select(const QStringList& columns);
+
+  /**
+   * @brief 追加比较条件
+   * @param column 列名
+   * @param op 比较符
+   * @param value 比较值（IS_NULL/NOT_NULL 时忽略）
+   */
+  TableQuery& where(const QString& column, QueryOp op,
+                    const QVariant& value = QVariant());
+
+  /**
+   * @brief 追加 IN 条件（空列表不匹配任何行）
+   */
+  TableQuery& whereIn(const QString& column, const QVariantList& values);
+
+  /**
+   * @brief 追加闭区间条件 low <= column <= high
+   */
+  TableQuery& whereBetween(const QString& column, const QVariant& low,
+                           const QVariant& high);
+
+  /**
+   * @brief 追加排序列（可多次调用，按调用顺序）
+   */
+  TableQuery& orderBy(const QString& column, bool ascending = true);
+
+  /**
+   * @brief 限制行数
+   * @param count 最多返回的行数
+   * @param offset 跳过的行数
+   */
+  TableQuery& limit(int count, qint64 offset = 0);
+
+  bool isValid() const { return m_error.isEmpty(); }
+  const QString& error() const { return m_error; }
+  const QString& table() const { return m_table; }
+
+  /**
+   * @brief 是否指定了投影（实体查询要求取全部列）
+   */
+  bool hasProjection() const { return !m_projection.isEmpty(); }
+
+  /**
+   * @brief 结果列（未指定投影时为全部允许的列）
+   */
+  QVector<ColumnSpec> resultColumns() const;
+
+  /**
+   * @brief 查询语句（只含占位符）
+   */
+  QString sql() const;
+
+  /**
+   * @brief 与 sql() 的占位符一一对应的取值
+   */
+  QVariantList bindValues() const;
+
+  /**
+   * @brief 同条件的计数语句（忽略投影、排序与行数限制）
+   */
+  QString countSql() const;
+
+  /**
+   * @brief 与 countSql() 的占位符一一对应的取值
+   */
+  const QVariantList& countBindValues() const { return m_whereValues; }
+
+ private:
+  /**
+   * @brief 在白名单中查找列
+   * @return 列号（不在白名单内时记录错误并返回-1）
+   */
+  int columnIndex(const QString& column);
+
+  /// 只记录第一个错误
+  void fail(const QString& error);
+
+  QString whereClause() const;
+
+  QString m_table;                ///< 表名
+  QVector<ColumnSpec> m_columns;  ///< 允许的列
+  QVector<int> m_projection;      ///< 投影列号（为空表示全部列）
+  QStringList m_conditions;       ///< 条件片段（只含占位符）
+  QVariantList m_whereValues;     ///< 条件取值
+  QStringList m_orderBy;          ///< 排序片段
+  int m_limit = -1;               ///< 行数限制（-1 为不限）
+  qint64 m_offset = 0;            ///< 跳过的行数
+  QString m_error;                ///< 首个错误（为空表示有效）
+};
+
+#endif  // TABLE_QUERY_H
@@ -0,0 +1,180 @@
+﻿// TraceSpan.cpp - 耗时区间追踪实现
+#include "TraceSpan.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+#include <chrono>
+#include <memory>
+
+namespace {
+
+struct TraceEvent {
+  const char* name;
+  qint64 beginNs;
+  qint64 endNs;
+};
+
+/**
+ * @brief 单个线程的事件缓冲
+ * 只有本线程写入；锁用于与导出、清空互斥，平时无竞争
+ */
+struct ThreadBuffer {
+  QMutex mutex;
+  int tid = 0;         ///< 追踪内的线程序号（从1开始）
+  QString threadName;  ///< 线程名（导出为元数据事件）
+  QVector<TraceEvent> events;
+  quint64 dropped = 0;
+};
+
+struct Registry {
+  QMutex mutex;
+  QVector<std::shared_ptr<ThreadBuffer>> buffers;
+  int nextTid = 1;
+};
+
+Registry& registry() {
+  static Registry r;
+  return r;
+}
+
+ThreadBuffer* localBuffer() {
+  // 注册表与线程各持有一份，线程结束后缓冲保留到下一次 clear
+  thread_local std::shared_ptr<ThreadBuffer> buffer;
+  if (buffer) return buffer.get();
+
+  buffer = std::make_shared<ThreadBuffer>();
+  const QString objectName = QThread::currentThread()->objectName();
+  const quintptr nativeId =
+      reinterpret_cast<quintptr>(QThread::currentThreadId());
+
+  Registry& r = registry();
+  QMutexLocker locker(&r.mutex);
+  buffer->tid = r.nextTid++;
+  buffer->threadName =
+      objectName.isEmpty()
+          ? QString("线程 %1 (0x%2)").arg(buffer->tid).arg(nativeId, 0, 16)
+          : objectName;
+  r.buffers.append(buffer);
+  return buffer.get();
+}
+
+QString categoryOf(const char* name) {
+  const QString s = QString::fromLatin1(name);
+  const int dot = s.indexOf('.');
+  return dot > 0 ? s.left(dot) : s;
+}
+
+}  // namespace
+
+void Tracer::setEnabled(bool enabled) {
+  // 先取一次时钟，确保时间原点早于第一个区间
+  nowNs();
+  s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+qint64 Tracer::nowNs() {
+  using Clock = std::chrono::steady_clock;
+  static const Clock::time_point epoch = Clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                              epoch)
+      .count();
+}
+
+void Tracer::record(const char* name, qint64 beginNs, qint64 endNs) {
+  ThreadBuffer* b = localBuffer();
+  QMutexLocker locker(&b->mutex);
+  if (b->events.size() >= kMaxEventsPerThread) {
+    ++b->dropped;
+    return;
+  }
+  b->events.append(TraceEvent{name, beginNs, endNs});
+}
+
+QByteArray Tracer::toJson() {
+  QVector<std::shared_ptr<ThreadBuffer>> buffers;
+  {
+    Registry& r = registry();
+    QMutexLocker locker(&r.mutex);
+    buffers = r.buffers;
+  }
+
+  const qint64 pid = QCoreApplication::applicationPid();
+  QJsonArray events;
+  quint64 dropped = 0;
+  for (const auto& b : buffers) {
+    QVector<TraceEvent> snapshot;
+    {
+      QMutexLocker locker(&b->mutex);
+      snapshot = b->events;
+      dropped += b->dropped;
+    }
+
+    QJsonObject meta;
+    meta["name"] = "thread_name";
+    meta["ph"] = "M";
+    meta["pid"] = pid;
+    meta["tid"] = b->tid;
+    meta["args"] = QJsonObject{{"name", b->threadName}};
+    events.append(meta);
+
+    // 追踪事件的时间单位为微秒
+    for (const TraceEvent& e : snapshot) {
+      QJsonObject o;
+      o["name"] = QString::fromLatin1(e.name);
+      o["cat"] = categoryOf(e.name);
+      o["ph"] = "X";
+      o["ts"] = e.beginNs / 1000.0;
+      o["dur"] = (e.endNs - e.beginNs) / 1000.0;
+      o["pid"] = pid;
+      o["tid"] = b->tid;
+      events.append(o);
+    }
+  }
+
+  QJsonObject root;
+  root["traceEvents"] = events;
+  root["displayTimeUnit"] = "ns";
+  root["otherData"] =
+      QJsonObject{{"droppedEvents", static_cast<qint64>(dropped)}};
+  return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+bool Tracer::writeJson(const QString& path) {
+  QFile file(path);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+  return file.write(toJson()) >= 0;
+}
+
+void Tracer::clear() {
+  Registry& r = registry();
+  QMutexLocker locker(&r.mutex);
+  QVector<std::shared_ptr<ThreadBuffer>> alive;
+  for (const auto& b : r.buffers) {
+    // 只剩注册表持有说明线程已结束，直接释放
+    if (b.use_count() == 1) continue;
+    QMutexLocker bufferLocker(&b->mutex);
+    b->events.clear();
+    b->dropped = 0;
+    alive.append(b);
+  }
+  r.buffers.swap(alive);
+}
+
+Tracer::Stats Tracer::stats() {
+  Registry& r = registry();
+  QMutexLocker locker(&r.mutex);
+  Stats st;
+  st.threads = r.buffers.size();
+  for (const auto& b : r.buffers) {
+    QMutexLocker bufferLocker(&b->mutex);
+    st.events += static_cast<quint64>(b->events.size());
+    st.dropped += b->dropped;
+  }
+  return st;
+}
@@ -0,0 +1,125 @@
+﻿// TraceSpan.h - 耗时区间追踪（Chrome/Perfetto 追踪事件格式）
+#ifndef TRACE_SPAN_H
+#define TRACE_SPAN_H
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+
+/**
+ * @brief 区间追踪器
+ * 记录连接池获取、表锁等待、SQL执行、事务提交等区间的起止时间，
+ * 按需导出为 Chrome 追踪事件 JSON（chrome://tracing 或 ui.perfetto.dev
+ * 直接打开），用来回答"这次插入的 40ms 花在了哪里"。
+ *
+ * 每个线程首次记录时分配自己的缓冲区，记录只锁本线程的缓冲区（导出时
+ * 才有竞争）；单线程超过 kMaxEventsPerThread 个事件后丢弃并计数。
+ * 默认关闭：关闭时每个区间只有一次原子读和一次分支。
+ */
+class Tracer {
+ public:
+  static constexpr int kMaxEventsPerThread = 1 << 17;  ///< 单线程缓冲上限
+
+  /**
+   * @brief 运行计数
+   */
+  struct Stats {
+    quint64 events = 0;   ///< 缓冲中的事件数
+    quint64 dropped = 0;  ///< 因缓冲满丢弃的事件数
+    int threads = 0;      ///< 记录过事件的线程数
+  };
+
+  /**
+   * @brief 是否正在记录
+   */
+  static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief 开启或关闭记录（已记录的事件保留到 clear）
+   * @param enabled 是否记录
+   */
+  static void setEnabled(bool enabled);
+
+  /**
+   * @brief 追踪时钟（单调时钟，自首次调用起的纳秒数）
+   */
+  static qint64 nowNs();
+
+  /**
+   * @brief 记录一个已结束的区间
+   * @param name 区间名（必须是字符串字面量，只保存指针）
+   * @param beginNs 开始时间（nowNs）
+   * @param endNs 结束时间（nowNs）
+   */
+  static void record(const char* name, qint64 beginNs, qint64 endNs);
+
+  /**
+   * @brief 导出为追踪事件 JSON
+   * 区间名中第一个 '.' 之前的部分作为类别（pool/table/sql/tx ...）
+   * @return {"traceEvents": [...]} 形式的 JSON
+   */
+  static QByteArray toJson();
+
+  /**
+   * @brief 导出到文件
+   * @param path 文件路径
+   * @return 是否写入成功
+   */
+  static bool writeJson(const QString& path);
+
+  /**
+   * @brief 清空所有线程的缓冲（已结束线程的缓冲一并释放）
+   */
+  static void clear();
+
+  /**
+   * @brief 获取运行计数
+   */
+  static Stats stats();
+
+ private:
+  static inline std::atomic<bool> s_enabled{false};
+};
+
+/**
+ * @brief 区间守卫：构造时开始，析构或 finish() 时结束
+ * 追踪关闭时构造与析构各只有一次分支
+ */
+class TraceSpan {
+ public:
+  /**
+   * @brief 构造函数
+   * @param name 区间名（字符串字面量）
+   */
+  explicit TraceSpan(const char* name)
+      : m_name(Tracer::enabled() ? name : nullptr),
+        m_beginNs(m_name ? Tracer::nowNs() : 0) {}
+
+  ~TraceSpan() { finish(); }
+
+  TraceSpan(const TraceSpan&) = delete;
+  TraceSpan& operator=(const TraceSpan&) = delete;
+
+  /**
+   * @brief 提前结束区间（如锁已取得，后续工作不再计入）
+   */
+  void finish() {
+    if (!m_name) return;
+    Tracer::record(m_name, m_beginNs, Tracer::nowNs());
+    m_name = nullptr;
+  }
+
+ private:
+  const char* m_name;  ///< 区间名（为空表示未记录或已结束）
+  qint64 m_beginNs;    ///< 开始时间
+};
+
+#define DB_TRACE_CONCAT_INNER(a, b) a##b
+#define DB_TRACE_CONCAT(a, b) DB_TRACE_CONCAT_INNER(a, b)
+
+/// 追踪当前作用域：DB_TRACE_SPAN("pool.acquire");
+#define DB_TRACE_SPAN(name) \
+  TraceSpan DB_TRACE_CONCAT(traceSpan_, __LINE__)(name)
+
+#endif  // TRACE_SPAN_H
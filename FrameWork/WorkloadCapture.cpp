@@ -0,0 +1,325 @@
+﻿// WorkloadCapture.cpp - 生产负载采集实现
+#include "WorkloadCapture.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QHash>
+#include <QMessageAuthenticationCode>
+#include <QMutex>
+#include <QRandomGenerator>
+#include <QRegularExpression>
+#include <QThread>
+#include <algorithm>
+
+namespace {
+
+/// 记录标签
+enum : quint8 {
+  TAG_SQL = 1,        ///< SQL 字典项：序号、文本、指纹
+  TAG_THREAD = 2,     ///< 线程：序号、名称
+  TAG_STATEMENT = 3,  ///< 语句：偏移、线程、数据库、SQL 序号、耗时、结果、参数
+  TAG_DATABASE = 4,   ///< 数据库：序号、名称
+};
+
+/// 驱动上标记所属数据库的动态属性名
+constexpr char kDatabaseProperty[] = "workloadDatabase";
+
+constexpr QDataStream::Version kStreamVersion = QDataStream::Qt_5_12;
+
+/// 脱敏密钥字节数
+constexpr int kRedactionKeySize = 32;
+
+/// 脱敏结果的最短字节数（128 位，短值之间不致碰撞）
+constexpr int kMinPseudonymBytes = 16;
+
+struct CaptureState {
+  QMutex mutex;
+  QFile file;
+  QDataStream out;
+  WorkloadRedaction redaction = WorkloadRedaction::NONE;
+  /// 每次采集随机生成、不写入日志的脱敏密钥（start 时在开启记录前写好）
+  quint32 redactionKey[kRedactionKeySize / sizeof(quint32)] = {};
+  QHash<QString, quint32> sqlIds;
+  QHash<QString, quint32> databaseIds;
+  quint64 session = 0;  ///< 每次 start 加一，用来识别线程序号是否过期
+  quint32 nextThread = 0;
+  qint64 startNs = 0;
+  quint64 statements = 0;
+};
+
+CaptureState& state() {
+  static CaptureState s;
+  return s;
+}
+
+/// 本线程在当前采集中的序号
+struct ThreadSlot {
+  quint64 session = 0;
+  quint32 id = 0;
+};
+
+/// 以本次采集的密钥对 seed 做 HMAC-SHA256，重复铺满 size 字节
+QByteArray pseudonym(const QByteArray& seed, int size) {
+  const QByteArray key = QByteArray::fromRawData(
+      reinterpret_cast<const char*>(state().redactionKey), kRedactionKeySize);
+  const QByteArray digest = QMessageAuthenticationCode::hash(
+      seed, key, QCryptographicHash::Sha256);
+  QByteArray out;
+  out.reserve(size);
+  while (out.size() < size) out.append(digest);
+  out.truncate(size);
+  return out;
+}
+
+/**
+ * @brief 脱敏一个参数
+ * 文本替换为十六进制的带密钥摘要，二进制替换为摘要字节。密钥每次采集
+ * 随机生成且不落盘，日志中的值无法靠字典或彩虹表反推；同一次采集内相等
+ * 关系不变（唯一约束、按值查找的命中情况随之保留）。长度尽量不变，但
+ * 不短于 kMinPseudonymBytes 字节的摘要，短值之间不致碰撞
+ */
+QVariant redact(const QVariant& value) {
+  if (value.isNull()) return value;
+  if (value.type() == QVariant::String) {
+    const QString text = value.toString();
+    const int chars = qMax(text.size(), kMinPseudonymBytes * 2);
+    const QByteArray hex = pseudonym(text.toUtf8(), (chars + 1) / 2).toHex();
+    return QString::fromLatin1(hex.left(chars));
+  }
+  if (value.type() == QVariant::ByteArray) {
+    const QByteArray bytes = value.toByteArray();
+    return pseudonym(bytes, qMax(kMinPseudonymBytes, bytes.size()));
+  }
+  return value;
+}
+
+bool fail(QString* error, const QString& message) {
+  if (error) *error = message;
+  return false;
+}
+
+WorkloadCapture::Stats statsUnsafe(const CaptureState& s) {
+  WorkloadCapture::Stats st;
+  st.statements = s.statements;
+  st.bytes = s.file.isOpen() ? static_cast<quint64>(s.file.pos()) : 0;
+  st.sqlTexts = s.sqlIds.size();
+  st.threads = static_cast<int>(s.nextThread);
+  st.databases = s.databaseIds.size();
+  return st;
+}
+
+}  // namespace
+
+bool WorkloadCapture::start(const QString& path, WorkloadRedaction redaction,
+                            QString* error) {
+  stop();
+  CaptureState& s = state();
+  QMutexLocker locker(&s.mutex);
+  s.file.setFileName(path);
+  if (!s.file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    return fail(error, QString("无法创建负载日志 %1: %2")
+                           .arg(path, s.file.errorString()));
+  }
+  s.out.setDevice(&s.file);
+  s.out.setVersion(kStreamVersion);
+  s.redaction = redaction;
+  QRandomGenerator::system()->fillRange(s.redactionKey);
+  s.sqlIds.clear();
+  s.databaseIds.clear();
+  ++s.session;
+  s.nextThread = 0;
+  s.statements = 0;
+  s.startNs = Tracer::nowNs();
+  s.out << kMagic << kVersion << static_cast<quint8>(redaction)
+        << QDateTime::currentMSecsSinceEpoch();
+  s_enabled.store(true, std::memory_order_relaxed);
+  return true;
+}
+
+WorkloadCapture::Stats WorkloadCapture::stop() {
+  CaptureState& s = state();
+  s_enabled.store(false, std::memory_order_relaxed);
+  QMutexLocker locker(&s.mutex);
+  const Stats st = statsUnsafe(s);
+  if (s.file.isOpen()) {
+    s.out.setDevice(nullptr);
+    s.file.close();
+  }
+  return st;
+}
+
+WorkloadCapture::Stats WorkloadCapture::stats() {
+  CaptureState& s = state();
+  QMutexLocker locker(&s.mutex);
+  return statsUnsafe(s);
+}
+
+void WorkloadCapture::tagConnection(const QSqlDatabase& db,
+                                    const QString& database) {
+  if (QSqlDriver* driver = db.driver()) {
+    driver->setProperty(kDatabaseProperty, database);
+  }
+}
+
+QString WorkloadCapture::databaseOf(const QSqlDriver* driver) {
+  return driver ? driver->property(kDatabaseProperty).toString() : QString();
+}
+
+void WorkloadCapture::record(const QString& database, const QString& sql,
+                             const QVariantList& params, qint64 beginNs,
+                             qint64 endNs, bool ok) {
+  thread_local ThreadSlot slot;
+  CaptureState& s = state();
+
+  // 脱敏在锁外完成
+  QVariantList values = params;
+  const bool redactValues = s.redaction == WorkloadRedaction::VALUES;
+  if (redactValues) {
+    for (QVariant& v : values) v = redact(v);
+  }
+
+  QMutexLocker locker(&s.mutex);
+  // 锁内再确认一次：stop 之后、加锁之前到达的语句不再写入
+  if (!enabled() || !s.file.isOpen()) return;
+
+  if (slot.session != s.session) {
+    slot.session = s.session;
+    slot.id = s.nextThread++;
+    const QString name = QThread::currentThread()->objectName();
+    s.out << static_cast<quint8>(TAG_THREAD) << slot.id
+          << (name.isEmpty() ? QString("线程 %1").arg(slot.id) : name);
+  }
+
+  auto db = s.databaseIds.constFind(database);
+  if (db == s.databaseIds.constEnd()) {
+    const quint32 id = static_cast<quint32>(s.databaseIds.size());
+    db = s.databaseIds.insert(database, id);
+    s.out << static_cast<quint8>(TAG_DATABASE) << id << database;
+  }
+
+  auto it = s.sqlIds.constFind(sql);
+  if (it == s.sqlIds.constEnd()) {
+    const quint32 id = static_cast<quint32>(s.sqlIds.size());
+    it = s.sqlIds.insert(sql, id);
+    s.out << static_cast<quint8>(TAG_SQL) << id << sql << fingerprint(sql);
+  }
+
+  const qint64 offsetUs = qMax<qint64>(0, beginNs - s.startNs) / 1000;
+  const quint32 durationUs =
+      static_cast<quint32>(qBound<qint64>(0, (endNs - beginNs) / 1000,
+                                          0xFFFFFFFF));
+  s.out << static_cast<quint8>(TAG_STATEMENT) << offsetUs << slot.id
+        << db.value() << it.value() << durationUs
+        << static_cast<quint8>(ok ? 1 : 0)
+        << static_cast<quint16>(values.size());
+  for (const QVariant& v : values) s.out << v;
+  ++s.statements;
+}
+
+QString WorkloadCapture::fingerprint(const QString& sql) {
+  static const QRegularExpression strings("'(?:[^']|'')*'");
+  static const QRegularExpression numbers("\\b\\d+(?:\\.\\d+)?\\b");
+  static const QRegularExpression lists("\\?(?:\\s*,\\s*\\?)+");
+  static const QRegularExpression spaces("\\s+");
+  QString fp = sql;
+  fp.replace(strings, "?");
+  fp.replace(numbers, "?");
+  fp.replace(lists, "?...");
+  fp.replace(spaces, " ");
+  return fp.trimmed();
+}
+
+bool WorkloadCapture::read(const QString& path, WorkloadLog* log,
+                           QString* error) {
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly)) {
+    return fail(error, QString("无法打开负载日志 %1: %2")
+                           .arg(path, file.errorString()));
+  }
+  QDataStream in(&file);
+  in.setVersion(kStreamVersion);
+
+  quint32 magic = 0;
+  quint16 version = 0;
+  quint8 redaction = 0;
+  WorkloadLog result;
+  in >> magic >> version >> redaction >> result.startedAtMs;
+  if (in.status() != QDataStream::Ok || magic != kMagic) {
+    return fail(error, QString("%1 不是负载日志").arg(path));
+  }
+  if (version < 1 || version > kVersion) {
+    return fail(error, QString("不支持的负载日志版本 %1").arg(version));
+  }
+  result.redaction = static_cast<WorkloadRedaction>(redaction);
+  // 版本 1 不记录数据库：全部语句归入一个未命名的库
+  if (version == 1) result.databases << QString();
+
+  while (!in.atEnd()) {
+    quint8 tag = 0;
+    in >> tag;
+    if (tag == TAG_SQL) {
+      quint32 id = 0;
+      QString sql;
+      QString fp;
+      in >> id >> sql >> fp;
+      if (in.status() != QDataStream::Ok) break;
+      if (id != static_cast<quint32>(result.sql.size())) {
+        return fail(error, QString("SQL 字典序号不连续: %1").arg(id));
+      }
+      result.sql << sql;
+      result.fingerprints << fp;
+    } else if (tag == TAG_THREAD) {
+      quint32 id = 0;
+      QString name;
+      in >> id >> name;
+      if (in.status() != QDataStream::Ok) break;
+      if (id != static_cast<quint32>(result.threads.size())) {
+        return fail(error, QString("线程序号不连续: %1").arg(id));
+      }
+      result.threads << name;
+    } else if (tag == TAG_DATABASE && version >= 2) {
+      quint32 id = 0;
+      QString name;
+      in >> id >> name;
+      if (in.status() != QDataStream::Ok) break;
+      if (id != static_cast<quint32>(result.databases.size())) {
+        return fail(error, QString("数据库序号不连续: %1").arg(id));
+      }
+      result.databases << name;
+    } else if (tag == TAG_STATEMENT) {
+      CapturedStatement st;
+      quint8 ok = 0;
+      quint16 count = 0;
+      in >> st.offsetUs >> st.thread;
+      if (version >= 2) in >> st.database;
+      in >> st.sqlId >> st.durationUs >> ok >> count;
+      st.ok = ok != 0;
+      st.params.reserve(count);
+      for (int i = 0; i < count; ++i) {
+        QVariant v;
+        in >> v;
+        st.params.append(v);
+      }
+      // 进程异常退出时最后一条记录可能只写了一半
+      if (in.status() != QDataStream::Ok) break;
+      if (st.sqlId >= static_cast<quint32>(result.sql.size()) ||
+          st.thread >= static_cast<quint32>(result.threads.size()) ||
+          st.database >= static_cast<quint32>(result.databases.size())) {
+        return fail(error, "语句引用了未定义的 SQL、线程或数据库");
+      }
+      result.statements.append(st);
+    } else {
+      return fail(error, QString("未知的记录标签 %1").arg(tag));
+    }
+  }
+
+  // 各线程的记录按完成顺序写入，这里按发起时间排好（同时刻保持原序）
+  std::stable_sort(result.statements.begin(), result.statements.end(),
+                   [](const CapturedStatement& a, const CapturedStatement& b) {
+                     return a.offsetUs < b.offsetUs;
+                   });
+  *log = result;
+  return true;
+}
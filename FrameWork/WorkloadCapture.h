@@ -0,0 +1,229 @@
+﻿// WorkloadCapture.h - 语句执行层与生产负载采集
+#ifndef WORKLOAD_CAPTURE_H
+#define WORKLOAD_CAPTURE_H
+
+#include <QSqlDatabase>
+#include <QSqlDriver>
+#include <QSqlQuery>
+#include <QString>
+#include <QStringList>
+#include <QVariantList>
+#include <QVector>
+#include <atomic>
+
+#include "TraceSpan.h"
+
+/**
+ * @brief 采集时对参数的脱敏方式
+ */
+enum class WorkloadRedaction {
+  NONE,   ///< 原样记录参数
+  VALUES  ///< 文本与二进制参数替换为带密钥的摘要（同次采集内相同值仍相同）
+};
+
+/**
+ * @brief 负载日志中的一条语句
+ */
+struct CapturedStatement {
+  qint64 offsetUs = 0;     ///< 相对采集开始的发起时间
+  quint32 thread = 0;      ///< 发起线程序号（WorkloadLog::threads 下标）
+  quint32 database = 0;    ///< 数据库序号（WorkloadLog::databases 下标）
+  quint32 sqlId = 0;       ///< SQL 文本序号（WorkloadLog::sql 下标）
+  quint32 durationUs = 0;  ///< 采集时的执行耗时
+  bool ok = true;          ///< 采集时是否执行成功
+  QVariantList params;     ///< 按位置排列的绑定参数
+};
+
+/**
+ * @brief 读回的负载日志
+ */
+struct WorkloadLog {
+  qint64 startedAtMs = 0;                 ///< 采集开始时间（Unix 毫秒）
+  QStringList sql;                        ///< SQL 文本字典
+  QStringList fingerprints;               ///< 与 sql 同序的指纹
+  QStringList threads;                    ///< 线程名（下标即线程序号）
+  QStringList databases;                  ///< 数据库名（下标即数据库序号）
+  QVector<CapturedStatement> statements;  ///< 按发起时间排列的语句
+  /// 采集时的脱敏方式
+  WorkloadRedaction redaction = WorkloadRedaction::NONE;
+};
+
+/**
+ * @brief 生产负载采集器
+ * 框架的语句执行统一经过 SqlExec（见下），开启采集后每条语句的发起
+ * 时间、线程、所属数据库、SQL 指纹与参数写入紧凑的二进制日志，事务
+ * 边界记为 BEGIN/COMMIT/ROLLBACK 语句；配合 Replay 工具在各库的副本上
+ * 重放，用真实负载而不是合成负载评估改动。所属数据库取连接上由
+ * tagConnection() 标记的配置名（DatabaseConfig::dbName）。
+ *
+ * 日志格式（QDataStream，Qt 5.12 序列化版本）：文件头为魔数、版本、
+ * 脱敏方式与开始时间，其后是带标签的记录——SQL 文本、线程名与数据库名
+ * 各在首次出现时写一次，语句记录只引用其序号。版本 1 的日志不含数据库，
+ * 读回时全部归入名称为空的单个数据库。SQL 以 QString::arg 拼入字面量
+ * 时每种文本各占一个字典项，指纹（字面量替换为 ?）仍归为同一类。
+ *
+ * 默认关闭：关闭时每条语句只多一次原子读和一次分支。
+ */
+class WorkloadCapture {
+ public:
+  static constexpr quint32 kMagic = 0x44425750;  ///< "DBWP"
+  static constexpr quint16 kVersion = 2;         ///< 日志格式版本
+
+  /**
+   * @brief 运行计数
+   */
+  struct Stats {
+    quint64 statements = 0;  ///< 已记录的语句数
+    quint64 bytes = 0;       ///< 已写入的字节数
+    int sqlTexts = 0;        ///< SQL 字典项数
+    int threads = 0;         ///< 出现过的线程数
+    int databases = 0;       ///< 出现过的数据库数
+  };
+
+  /**
+   * @brief 是否正在采集
+   */
+  static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief 开始采集（已在采集时先结束上一份日志）
+   * @param path 日志文件路径（覆盖已有文件）
+   * @param redaction 参数脱敏方式
+   * @param error 失败时的错误信息（可为nullptr）
+   * @return 是否成功
+   */
+  static bool start(const QString& path,
+                    WorkloadRedaction redaction = WorkloadRedaction::NONE,
+                    QString* error = nullptr);
+
+  /**
+   * @brief 结束采集并关闭日志
+   * @return 本次采集的运行计数
+   */
+  static Stats stop();
+
+  /**
+   * @brief 获取当前运行计数
+   */
+  static Stats stats();
+
+  /**
+   * @brief 标记连接所属的数据库（建立连接时调用）
+   * @param db 连接
+   * @param database 数据库名（DatabaseConfig::dbName）
+   */
+  static void tagConnection(const QSqlDatabase& db, const QString& database);
+
+  /**
+   * @brief 取连接所属的数据库名
+   * @param driver 连接的驱动
+   * @return 数据库名（未标记时为空）
+   */
+  static QString databaseOf(const QSqlDriver* driver);
+
+  /**
+   * @brief 记录一条已执行的语句
+   * @param database 数据库名
+   * @param sql SQL 文本
+   * @param params 按位置排列的绑定参数
+   * @param beginNs 开始时间（Tracer::nowNs）
+   * @param endNs 结束时间（Tracer::nowNs）
+   * @param ok 是否执行成功
+   */
+  static void record(const QString& database, const QString& sql,
+                     const QVariantList& params, qint64 beginNs, qint64 endNs,
+                     bool ok);
+
+  /**
+   * @brief SQL 指纹
+   * 字符串与数字字面量替换为 ?，连续的 ?, ?, ? 合并为 ?...，空白折叠
+   * @param sql SQL 文本
+   * @return 指纹文本
+   */
+  static QString fingerprint(const QString& sql);
+
+  /**
+   * @brief 读取负载日志
+   * @param path 日志文件路径
+   * @param log 输出
+   * @param error 失败时的错误信息（可为nullptr）
+   * @return 是否成功（日志末尾不完整的记录忽略）
+   */
+  static bool read(const QString& path, WorkloadLog* log,
+                   QString* error = nullptr);
+
+ private:
+  static inline std::atomic<bool> s_enabled{false};
+};
+
+/**
+ * @brief 框架的语句执行入口
+ * 表类与管理器执行业务语句、开启和结束事务时都经过这里，采集开启时
+ * 顺带记录；连接初始化的 PRAGMA 与建表语句不经过这里，重放时由副本
+ * 自身的结构与连接配置提供。
+ */
+namespace SqlExec {
+
+/// 取出查询按位置排列的绑定参数
+inline QVariantList boundParams(const QSqlQuery& query) {
+  QVariantList params;
+  const int count = query.boundValues().size();
+  params.reserve(count);
+  for (int i = 0; i < count; ++i) params.append(query.boundValue(i));
+  return params;
+}
+
+/// 执行已 prepare 并绑定参数的查询
+inline bool run(QSqlQuery& query) {
+  if (!WorkloadCapture::enabled()) return query.exec();
+  const qint64 beginNs = Tracer::nowNs();
+  const bool ok = query.exec();
+  WorkloadCapture::record(WorkloadCapture::databaseOf(query.driver()),
+                          query.lastQuery(), boundParams(query), beginNs,
+                          Tracer::nowNs(), ok);
+  return ok;
+}
+
+/// 直接执行一条 SQL
+inline bool run(QSqlQuery& query, const QString& sql) {
+  if (!WorkloadCapture::enabled()) return query.exec(sql);
+  const qint64 beginNs = Tracer::nowNs();
+  const bool ok = query.exec(sql);
+  WorkloadCapture::record(WorkloadCapture::databaseOf(query.driver()), sql, {},
+                          beginNs, Tracer::nowNs(), ok);
+  return ok;
+}
+
+/// 开启事务
+inline bool begin(QSqlDatabase& db) {
+  if (!WorkloadCapture::enabled()) return db.transaction();
+  const qint64 beginNs = Tracer::nowNs();
+  const bool ok = db.transaction();
+  WorkloadCapture::record(WorkloadCapture::databaseOf(db.driver()), "BEGIN",
+                          {}, beginNs, Tracer::nowNs(), ok);
+  return ok;
+}
+
+/// 提交事务
+inline bool commit(QSqlDatabase& db) {
+  if (!WorkloadCapture::enabled()) return db.commit();
+  const qint64 beginNs = Tracer::nowNs();
+  const bool ok = db.commit();
+  WorkloadCapture::record(WorkloadCapture::databaseOf(db.driver()), "COMMIT",
+                          {}, beginNs, Tracer::nowNs(), ok);
+  return ok;
+}
+
+/// 回滚事务
+inline bool rollback(QSqlDatabase& db) {
+  if (!WorkloadCapture::enabled()) return db.rollback();
+  const qint64 beginNs = Tracer::nowNs();
+  const bool ok = db.rollback();
+  WorkloadCapture::record(WorkloadCapture::databaseOf(db.driver()), "ROLLBACK",
+                          {}, beginNs, Tracer::nowNs(), ok);
+  return ok;
+}
+
+}  // namespace SqlExec
+
+#endif  // WORKLOAD_CAPTURE_H
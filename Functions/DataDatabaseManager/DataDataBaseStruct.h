@@ -0,0 +1,62 @@
+﻿#ifndef DATADATABASESTRUCT_H
+#define DATADATABASESTRUCT_H
+
+#include <QDateTime>
+#include <QString>
+
+// ============================================================================
+// 数据实体定义
+// ============================================================================
+
+/**
+ * @brief 文件附件实体
+ * 对应数据库中的文件附件表；文件内容不入库，按 contentHash 存放在
+ * 内容寻址存储中，相同内容的附件共享一份文件并由内容表计数引用
+ */
+struct FileAttachment {
+  int id = -1;           ///< 附件ID（主键，自增）
+  QString ownerType;     ///< 所属对象类型（如"experiment"、"device"）
+  int ownerId = -1;      ///< 所属对象ID
+  QString fileName;      ///< 原始文件名
+  QString mimeType;      ///< MIME类型
+  qint64 byteSize = 0;   ///< 内容字节数（写入时由存储填充）
+  QString contentHash;   ///< 内容摘要（SHA-256）
+  QDateTime createdAt;   ///< 创建时间
+
+  /**
+   * @brief 默认构造函数
+   */
+  FileAttachment() { createdAt = QDateTime::currentDateTime(); }
+
+  /**
+   * @brief 验证元数据有效性（不含内容摘要）
+   * @return 数据是否有效
+   */
+  bool isValid() const {
+    return !ownerType.isEmpty() && ownerId > 0 && !fileName.isEmpty();
+  }
+};
+
+/**
+ * @brief 待入库的附件来源
+ */
+struct AttachmentSource {
+  QString filePath;   ///< 源文件路径
+  QString ownerType;  ///< 所属对象类型
+  int ownerId = -1;   ///< 所属对象ID
+  QString fileName;   ///< 附件名（为空时取源文件名）
+  QString mimeType;   ///< MIME类型
+};
+
+/**
+ * @brief 附件存储占用
+ */
+struct AttachmentStoreUsage {
+  int attachments = 0;      ///< 附件行数
+  int contents = 0;         ///< 内容对象数
+  int unreferenced = 0;     ///< 待回收（引用计数为0）的内容数
+  qint64 logicalBytes = 0;  ///< 按附件累计的字节数
+  qint64 storedBytes = 0;   ///< 实际存储的字节数（去重后）
+};
+
+#endif  // DATADATABASESTRUCT_H
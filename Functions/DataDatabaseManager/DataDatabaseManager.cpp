@@ -0,0 +1,101 @@
+﻿// ============================================================================
+// DataDatabaseManager.cpp - 实现文件
+// ============================================================================
+
+#include "DataDatabaseManager.h"
+
+#include "FileAttachmentTable.h"
+#include "SystemLogTable.h"
+
+// ============================================================================
+// DataDatabaseManager实现
+// ============================================================================
+
+DataDatabaseManager::DataDatabaseManager(const DatabaseConfig& config,
+                                         QObject* parent)
+    : BaseDatabaseManager(DatabaseType::DATA_DB, config, parent),
+      m_attachmentGcIntervalMs(FileAttachmentTable::kDefaultGcIntervalMs),
+      m_attachmentGcGraceSecs(FileAttachmentTable::kDefaultGcGraceSecs) {
+  qInfo() << "创建数据管理数据库管理器";
+}
+
+DataDatabaseManager::~DataDatabaseManager() { stopLogSink(); }
+
+bool DataDatabaseManager::initialize() {
+  if (!BaseDatabaseManager::initialize()) {
+    return false;
+  }
+
+  // 汇聚器写线程通过连接池取自己的连接，整批日志在一个事务内落盘
+  SystemLogTable* table = m_systemLogTable.get();
+  m_ownsLogSink = SystemLogSink::instance()->start(
+      [table](QVector<SystemLogRecord>& batch) {
+        return table->appendBatch(batch);
+      },
+      m_logSinkOptions);
+
+  if (!m_ownsLogSink) {
+    qWarning() << "系统日志汇聚器已在运行，本数据库不接管日志写入";
+  }
+
+  if (m_attachmentGcIntervalMs > 0) {
+    m_fileAttachmentTable->startGarbageCollector(m_attachmentGcIntervalMs,
+                                                 m_attachmentGcGraceSecs);
+  }
+  return true;
+}
+
+void DataDatabaseManager::close() {
+  stopLogSink();                  // 先写完积压日志，再释放表与连接池
+  m_fileAttachmentTable.reset();  // 析构时停止附件回收线程
+  m_systemLogTable.reset();       // 再释放业务表，避免悬空
+  BaseDatabaseManager::close();   // 最后做通用清理
+}
+
+void DataDatabaseManager::stopLogSink() {
+  if (m_ownsLogSink) {
+    SystemLogSink::instance()->stop();
+    m_ownsLogSink = false;
+  }
+}
+
+void DataDatabaseManager::registerTables() {
+  m_systemLogTable =
+      std::make_unique<SystemLogTable>(&m_database, m_connectionPool.get());
+
+  connect(m_systemLogTable->operations(), &BaseTableOperations::databaseError,
+          this, &DataDatabaseManager::databaseError);
+
+  // 交给基类接管“所有权”（唯一所有者）
+  registerTable(TableType::SYSTEM_LOG, std::unique_ptr<ITableOperations>(
+                                           m_systemLogTable->operations()));
+
+  m_fileAttachmentTable = std::make_unique<FileAttachmentTable>(
+      &m_database, m_connectionPool.get(), attachmentStorePath());
+
+  connect(m_fileAttachmentTable->operations(),
+          &BaseTableOperations::databaseError, this,
+          &DataDatabaseManager::databaseError);
+
+  registerTable(
+      TableType::FILE_ATTACHMENT,
+      std::unique_ptr<ITableOperations>(m_fileAttachmentTable->operations()));
+}
+
+SystemLogTable* DataDatabaseManager::systemLogTable() const {
+  return m_systemLogTable.get();
+}
+
+FileAttachmentTable* DataDatabaseManager::fileAttachmentTable() const {
+  return m_fileAttachmentTable.get();
+}
+
+QString DataDatabaseManager::attachmentStorePath() const {
+  QFileInfo info(m_config.filePath);
+  return info.absoluteDir().absoluteFilePath(info.completeBaseName() +
+                                             "_attachments");
+}
+
+SystemLogSink::Stats DataDatabaseManager::logSinkStats() const {
+  return SystemLogSink::instance()->stats();
+}
@@ -0,0 +1,114 @@
+﻿// DataDatabaseManager.h - 数据管理数据库管理器
+#ifndef DATA_DATABASE_MANAGER_H
+#define DATA_DATABASE_MANAGER_H
+
+#include "BaseDatabaseManager.h"
+#include "DatabaseFramework.h"
+#include "SystemLogSink.h"
+
+class FileAttachmentTable;
+class SystemLogTable;
+
+// ============================================================================
+// 数据管理数据库管理器
+// ============================================================================
+
+/**
+ * @brief 数据管理数据库管理器
+ * 管理系统日志、文件附件等数据表；初始化后把系统日志汇聚器接到SYSTEM_LOG表
+ */
+class DataDatabaseManager : public BaseDatabaseManager {
+  Q_OBJECT
+
+ private:
+  std::unique_ptr<SystemLogTable> m_systemLogTable;  ///< 系统日志表
+  SystemLogSink::Options m_logSinkOptions;           ///< 日志汇聚器参数
+  bool m_ownsLogSink = false;  ///< 汇聚器是否由本数据库启动
+  std::unique_ptr<FileAttachmentTable> m_fileAttachmentTable;  ///< 文件附件表
+  int m_attachmentGcIntervalMs;  ///< 附件内容回收周期（<=0 不启动）
+  int m_attachmentGcGraceSecs;   ///< 附件内容回收宽限期
+
+ public:
+  /**
+   * @brief 构造函数
+   * @param config 数据库配置
+   * @param parent 父对象
+   */
+  explicit DataDatabaseManager(const DatabaseConfig& config,
+                               QObject* parent = nullptr);
+
+  /**
+   * @brief 析构函数
+   */
+  ~DataDatabaseManager() override;
+
+  /**
+   * @brief 初始化数据库并启动系统日志汇聚器
+   * @return 是否成功
+   */
+  bool initialize() override;
+
+  void close() override;
+
+  // ========================================================================
+  // 表访问器
+  // ========================================================================
+
+  /**
+   * @brief 获取系统日志表操作对象
+   * @return 系统日志表指针
+   */
+  SystemLogTable* systemLogTable() const;
+
+  /**
+   * @brief 获取文件附件表操作对象
+   * @return 文件附件表指针
+   */
+  FileAttachmentTable* fileAttachmentTable() const;
+
+  /**
+   * @brief 附件内容存储目录（<数据库文件名>_attachments）
+   * @return 目录路径
+   */
+  QString attachmentStorePath() const;
+
+  /**
+   * @brief 设置附件内容后台回收参数（下次initialize()时生效）
+   * @param intervalMs 回收周期（毫秒，<=0 不启动后台回收）
+   * @param graceSecs 引用归零后保留的宽限期（秒）
+   */
+  void setAttachmentGcOptions(int intervalMs, int graceSecs) {
+    m_attachmentGcIntervalMs = intervalMs;
+    m_attachmentGcGraceSecs = graceSecs;
+  }
+
+  // ========================================================================
+  // 日志汇聚器
+  // ========================================================================
+
+  /**
+   * @brief 设置日志汇聚器参数（下次initialize()时生效）
+   * @param options 汇聚器参数
+   */
+  void setLogSinkOptions(const SystemLogSink::Options& options) {
+    m_logSinkOptions = options;
+  }
+
+  /**
+   * @brief 获取日志汇聚器运行计数
+   * @return 计数快照
+   */
+  SystemLogSink::Stats logSinkStats() const;
+
+ protected:
+  /**
+   * @brief 注册所有表
+   * 实现基类纯虚函数
+   */
+  void registerTables() override;
+
+ private:
+  void stopLogSink();
+};
+
+#endif  // DATA_DATABASE_MANAGER_H
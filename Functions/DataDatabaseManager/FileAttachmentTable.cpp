@@ -0,0 +1,872 @@
+﻿#include "FileAttachmentTable.h"
+
+#include <QFileInfo>
+#include <QSet>
+
+#include "AuditTrail.h"
+#include "WorkloadCapture.h"
+
+// ============================================================================
+// FileAttachmentTable SQL语句常量定义
+// ============================================================================
+
+const QString FileAttachmentTable::INSERT_SQL = R"(
+    INSERT INTO file_attachment (owner_type, owner_id, file_name, mime_type,
+                                 byte_size, content_hash, created_at)
+    VALUES (?, ?, ?, ?, ?, ?, ?)
+)";
+
+// 新内容行引用计数为0，随后插入附件行时由触发器加1（同一事务内）
+const QString FileAttachmentTable::INSERT_CONTENT_SQL = R"(
+    INSERT OR IGNORE INTO file_content (hash, byte_size, ref_count,
+                                        unreferenced_at)
+    VALUES (?, ?, 0, strftime('%s', 'now'))
+)";
+
+const QString FileAttachmentTable::UPDATE_SQL = R"(
+    UPDATE file_attachment
+    SET owner_type = ?, owner_id = ?, file_name = ?, mime_type = ?,
+        byte_size = ?, content_hash = ?
+    WHERE id = ?
+)";
+
+const QString FileAttachmentTable::DELETE_SQL = R"(
+    DELETE FROM file_attachment WHERE id = ?
+)";
+
+const QString FileAttachmentTable::SELECT_BY_ID_SQL = R"(
+    SELECT id, owner_type, owner_id, file_name, mime_type, byte_size,
+           content_hash, created_at
+    FROM file_attachment WHERE id = ?
+)";
+
+const QString FileAttachmentTable::SELECT_ALL_SQL = R"(
+    SELECT id, owner_type, owner_id, file_name, mime_type, byte_size,
+           content_hash, created_at
+    FROM file_attachment ORDER BY id
+)";
+
+const QString FileAttachmentTable::SELECT_BY_OWNER_SQL = R"(
+    SELECT id, owner_type, owner_id, file_name, mime_type, byte_size,
+           content_hash, created_at
+    FROM file_attachment WHERE owner_type = ? AND owner_id = ? ORDER BY id
+)";
+
+const QString FileAttachmentTable::SELECT_HASH_BY_ID_SQL = R"(
+    SELECT content_hash FROM file_attachment WHERE id = ?
+)";
+
+const QString FileAttachmentTable::SELECT_GARBAGE_SQL = R"(
+    SELECT hash FROM file_content
+    WHERE ref_count <= 0 AND unreferenced_at <= ?
+)";
+
+const QString FileAttachmentTable::DELETE_GARBAGE_SQL = R"(
+    DELETE FROM file_content WHERE hash = ? AND ref_count <= 0
+)";
+
+const QString FileAttachmentTable::SELECT_CONTENT_HASHES_SQL = R"(
+    SELECT hash FROM file_content
+)";
+
+const QString FileAttachmentTable::CONTENT_EXISTS_SQL = R"(
+    SELECT 1 FROM file_content WHERE hash = ?
+)";
+
+const QString FileAttachmentTable::USAGE_SQL = R"(
+    SELECT (SELECT COUNT(*) FROM file_attachment),
+           (SELECT COALESCE(SUM(byte_size), 0) FROM file_attachment),
+           (SELECT COUNT(*) FROM file_content),
+           (SELECT COALESCE(SUM(byte_size), 0) FROM file_content),
+           (SELECT COUNT(*) FROM file_content WHERE ref_count <= 0)
+)";
+
+QList<PlanExpectation> FileAttachmentTable::planExpectations() {
+  const QString pk = "INTEGER PRIMARY KEY";
+  QList<PlanExpectation> list = {
+      {"FileAttachmentTable::SELECT_BY_ID_SQL", SELECT_BY_ID_SQL, {pk}},
+      {"FileAttachmentTable::UPDATE_SQL", UPDATE_SQL, {pk}},
+      {"FileAttachmentTable::DELETE_SQL", DELETE_SQL, {pk}},
+      {"FileAttachmentTable::SELECT_HASH_BY_ID_SQL", SELECT_HASH_BY_ID_SQL,
+       {pk}},
+      {"FileAttachmentTable::SELECT_BY_OWNER_SQL", SELECT_BY_OWNER_SQL,
+       {"idx_file_attachment_owner"}},
+      {"FileAttachmentTable::SELECT_GARBAGE_SQL", SELECT_GARBAGE_SQL,
+       {"idx_file_content_unreferenced"}},
+      {"FileAttachmentTable::DELETE_GARBAGE_SQL", DELETE_GARBAGE_SQL,
+       {"sqlite_autoindex_file_content_1"}},
+      {"FileAttachmentTable::CONTENT_EXISTS_SQL", CONTENT_EXISTS_SQL,
+       {"sqlite_autoindex_file_content_1"}},
+      // 用量统计与孤立文件比对本就要读全表
+      {"FileAttachmentTable::USAGE_SQL", USAGE_SQL, {}, true},
+      {"FileAttachmentTable::SELECT_CONTENT_HASHES_SQL",
+       SELECT_CONTENT_HASHES_SQL, {}, true},
+      {"FileAttachmentTable::SELECT_ALL_SQL", SELECT_ALL_SQL, {}, true}};
+
+  // 分页按主键或属主索引顺序扫描，不得额外排序
+  for (bool ascending : {true, false}) {
+    const QString dir = ascending ? "ASC" : "DESC";
+    list.append({QString("FileAttachmentTable::selectByPage(id %1)").arg(dir),
+                 selectByPageSql(PageParams{3, 50, "id", ascending}),
+                 {},
+                 true});
+    list.append(
+        {QString("FileAttachmentTable::selectByPage(owner_type %1)").arg(dir),
+         selectByPageSql(PageParams{3, 50, "owner_type", ascending}),
+         {"idx_file_attachment_owner"},
+         true});
+  }
+  return list;
+}
+
+// ============================================================================
+// FileAttachmentTableOperations 实现
+// ============================================================================
+
+const QString FileAttachmentTableOperations::CREATE_CONTENT_TABLE_SQL = R"(
+  CREATE TABLE IF NOT EXISTS file_content (
+    hash TEXT PRIMARY KEY CHECK(length(hash) = 64),
+    byte_size INTEGER NOT NULL,
+    ref_count INTEGER NOT NULL DEFAULT 0,
+    unreferenced_at INTEGER,
+    created_at DATETIME DEFAULT CURRENT_TIMESTAMP
+  )
+)";
+
+const QString FileAttachmentTableOperations::CREATE_TABLE_SQL = R"(
+  CREATE TABLE IF NOT EXISTS file_attachment (
+    id INTEGER PRIMARY KEY AUTOINCREMENT,
+    owner_type TEXT NOT NULL,
+    owner_id INTEGER NOT NULL,
+    file_name TEXT NOT NULL,
+    mime_type TEXT,
+    byte_size INTEGER NOT NULL,
+    content_hash TEXT NOT NULL REFERENCES file_content(hash),
+    created_at DATETIME DEFAULT CURRENT_TIMESTAMP
+  )
+)";
+
+// 引用计数随附件行在同一事务内增减；归零时记下时间，供回收判断宽限期
+const QStringList FileAttachmentTableOperations::CREATE_TRIGGERS_SQL = {
+    R"(
+  CREATE TRIGGER IF NOT EXISTS trg_file_attachment_ref_insert
+  AFTER INSERT ON file_attachment
+  BEGIN
+    UPDATE file_content SET ref_count = ref_count + 1, unreferenced_at = NULL
+    WHERE hash = NEW.content_hash;
+  END
+)",
+    R"(
+  CREATE TRIGGER IF NOT EXISTS trg_file_attachment_ref_delete
+  AFTER DELETE ON file_attachment
+  BEGIN
+    UPDATE file_content SET ref_count = ref_count - 1,
+      unreferenced_at = CASE WHEN ref_count - 1 <= 0
+                             THEN strftime('%s', 'now') END
+    WHERE hash = OLD.content_hash;
+  END
+)",
+    R"(
+  CREATE TRIGGER IF NOT EXISTS trg_file_attachment_ref_update
+  AFTER UPDATE OF content_hash ON file_attachment
+  WHEN OLD.content_hash IS NOT NEW.content_hash
+  BEGIN
+    UPDATE file_content SET ref_count = ref_count + 1, unreferenced_at = NULL
+    WHERE hash = NEW.content_hash;
+    UPDATE file_content SET ref_count = ref_count - 1,
+      unreferenced_at = CASE WHEN ref_count - 1 <= 0
+                             THEN strftime('%s', 'now') END
+    WHERE hash = OLD.content_hash;
+  END
+)"};
+
+FileAttachmentTableOperations::FileAttachmentTableOperations(
+    QSqlDatabase* db, ConnectionPool* pool)
+    : BaseTableOperations(db, "file_attachment", TableType::FILE_ATTACHMENT,
+                          pool, nullptr) {}
+
+bool FileAttachmentTableOperations::createTable() {
+  ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
+
+  auto c = acquireDb();
+  if (!c.db.isOpen()) {
+    qCritical() << "数据库连接未打开!";
+    return false;
+  }
+
+  QSqlQuery query(c.db);
+  if (!query.exec(CREATE_CONTENT_TABLE_SQL) || !query.exec(CREATE_TABLE_SQL)) {
+    QString error = query.lastError().text();
+    qCritical() << "创建文件附件表失败:" << error;
+    logOperation("创建表失败", error);
+    return false;
+  }
+
+  for (const QString& sql : CREATE_TRIGGERS_SQL) {
+    if (!query.exec(sql)) {
+      QString error = query.lastError().text();
+      qCritical() << "创建附件引用计数触发器失败:" << error;
+      logOperation("创建触发器失败", error);
+      return false;
+    }
+  }
+
+  query.exec(
+      "CREATE INDEX IF NOT EXISTS idx_file_attachment_owner ON "
+      "file_attachment(owner_type, owner_id)");
+  query.exec(
+      "CREATE INDEX IF NOT EXISTS idx_file_attachment_hash ON "
+      "file_attachment(content_hash)");
+  query.exec(
+      "CREATE INDEX IF NOT EXISTS idx_file_content_unreferenced ON "
+      "file_content(unreferenced_at) WHERE ref_count <= 0");
+
+  logOperation("创建表成功", m_tableName);
+  return true;
+}
+
+// ============================================================================
+// FileAttachmentTable实现
+// ============================================================================
+
+FileAttachmentTable::FileAttachmentTable(QSqlDatabase* db, ConnectionPool* pool,
+                                         const QString& storeRoot)
+    : BaseTable<FileAttachment>(nullptr), m_store(storeRoot) {
+  m_ops = new FileAttachmentTableOperations(db, pool);
+  m_baseOps = m_ops;
+  if (!m_store.open()) {
+    m_ops->logOperation("打开附件存储失败", storeRoot);
+  }
+}
+
+FileAttachmentTable::~FileAttachmentTable() {
+  stopGarbageCollector();
+  m_baseOps = nullptr;
+}
+
+bool FileAttachmentTable::ensureContentRow(QSqlDatabase& db,
+                                           const QString& hash, qint64 size) {
+  QSqlQuery query(db);
+  query.prepare(INSERT_CONTENT_SQL);
+  query.addBindValue(hash);
+  query.addBindValue(size);
+  if (!SqlExec::run(query)) {
+    m_ops->logOperation("写入内容记录失败", query.lastError().text());
+    return false;
+  }
+  return true;
+}
+
+DbResult<int> FileAttachmentTable::insertRow(
+    QSqlDatabase& db, const FileAttachment& attachment) {
+  QSqlQuery query(db);
+  query.prepare(INSERT_SQL);
+  query.addBindValue(attachment.ownerType);
+  query.addBindValue(attachment.ownerId);
+  query.addBindValue(attachment.fileName);
+  query.addBindValue(attachment.mimeType);
+  query.addBindValue(attachment.byteSize);
+  query.addBindValue(attachment.contentHash);
+  query.addBindValue(QDateTime::currentDateTime());
+
+  if (!SqlExec::run(query)) {
+    QString error =
+        QString("插入文件附件失败: %1").arg(query.lastError().text());
+    m_ops->logOperation("插入失败", error);
+    emit m_ops->databaseError(error);
+    return DbResult<int>::Error(error);
+  }
+
+  const int newId = query.lastInsertId().toInt();
+  m_ops->logOperation(
+      "插入成功", QString("新附件ID: %1, 内容: %2").arg(newId).arg(
+                      attachment.contentHash.left(12)));
+  emit m_ops->recordInserted(newId);
+  return DbResult<int>::Success(newId);
+}
+
+DbResult<int> FileAttachmentTable::insert(const FileAttachment& attachment) {
+  if (!m_ops) {
+    return DbResult<int>::Error("文件附件表未初始化或已释放");
+  }
+  if (!attachment.isValid()) {
+    return DbResult<int>::Error("附件元数据无效");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<int>::Error("数据库未打开");
+  }
+
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+  if (!m_store.contains(attachment.contentHash)) {
+    return DbResult<int>::Error(
+        QString("附件内容不存在: %1").arg(attachment.contentHash));
+  }
+
+  FileAttachment row = attachment;
+  row.byteSize = m_store.sizeOf(attachment.contentHash);
+  if (!ensureContentRow(c.db, row.contentHash, row.byteSize)) {
+    return DbResult<int>::Error("写入内容记录失败");
+  }
+  return insertRow(c.db, row);
+}
+
+DbResult<bool> FileAttachmentTable::update(const FileAttachment& attachment) {
+  if (!m_ops) {
+    return DbResult<bool>::Error("文件附件表未初始化或已释放");
+  }
+  if (attachment.id <= 0) {
+    return DbResult<bool>::Error("无效的附件ID");
+  }
+  if (!attachment.isValid()) {
+    return DbResult<bool>::Error("附件元数据无效");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) return DbResult<bool>::Error("数据库未打开");
+
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+  if (!m_store.contains(attachment.contentHash)) {
+    return DbResult<bool>::Error(
+        QString("附件内容不存在: %1").arg(attachment.contentHash));
+  }
+
+  const qint64 size = m_store.sizeOf(attachment.contentHash);
+  if (!ensureContentRow(c.db, attachment.contentHash, size)) {
+    return DbResult<bool>::Error("写入内容记录失败");
+  }
+
+  // 更换内容时旧内容的引用计数由触发器扣减
+  QSqlQuery query(c.db);
+  query.prepare(UPDATE_SQL);
+  query.addBindValue(attachment.ownerType);
+  query.addBindValue(attachment.ownerId);
+  query.addBindValue(attachment.fileName);
+  query.addBindValue(attachment.mimeType);
+  query.addBindValue(size);
+  query.addBindValue(attachment.contentHash);
+  query.addBindValue(attachment.id);
+
+  if (!SqlExec::run(query)) {
+    QString error =
+        QString("更新文件附件失败: %1").arg(query.lastError().text());
+    m_ops->logOperation("更新失败", error);
+    emit m_ops->databaseError(error);
+    return DbResult<bool>::Error(error);
+  }
+  if (query.numRowsAffected() == 0) {
+    return DbResult<bool>::Error("未找到指定的附件", DbErrorCode::NOT_FOUND);
+  }
+
+  m_ops->logOperation("更新成功", QString("附件ID: %1").arg(attachment.id));
+  emit m_ops->recordUpdated(attachment.id);
+  return DbResult<bool>::Success(true);
+}
+
+DbResult<bool> FileAttachmentTable::deleteById(int id) {
+  if (!m_ops) {
+    return DbResult<bool>::Error("文件附件表未初始化或已释放");
+  }
+  if (id <= 0) {
+    return DbResult<bool>::Error("无效的附件ID");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) return DbResult<bool>::Error("数据库未打开");
+
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+  QSqlQuery query(c.db);
+  query.prepare(DELETE_SQL);
+  query.addBindValue(id);
+  if (!SqlExec::run(query)) {
+    QString error = QString("删除附件失败: %1").arg(query.lastError().text());
+    m_ops->logOperation("删除失败", error);
+    emit m_ops->databaseError(error);
+    return DbResult<bool>::Error(error);
+  }
+  if (query.numRowsAffected() == 0) {
+    return DbResult<bool>::Error("未找到要删除的附件", DbErrorCode::NOT_FOUND);
+  }
+
+  m_ops->logOperation("删除成功", QString("附件ID: %1").arg(id));
+  emit m_ops->recordDeleted(id);
+  return DbResult<bool>::Success(true);
+}
+
+DbResult<FileAttachment> FileAttachmentTable::selectById(int id) const {
+  if (!m_ops) {
+    return DbResult<FileAttachment>::Error("文件附件表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) return DbResult<FileAttachment>::Error("数据库未打开");
+
+  QSqlQuery query(c.db);
+  query.prepare(SELECT_BY_ID_SQL);
+  query.addBindValue(id);
+
+  if (!SqlExec::run(query)) {
+    return DbResult<FileAttachment>::Error(
+        QString("查询附件失败: %1").arg(query.lastError().text()));
+  }
+  if (query.next()) {
+    return DbResult<FileAttachment>::Success(buildAttachment(query));
+  }
+  return DbResult<FileAttachment>::Error(
+      "未找到指定的附件", DbErrorCode::NOT_FOUND);
+}
+
+DbResult<QList<FileAttachment>> FileAttachmentTable::selectAll() const {
+  if (!m_ops) {
+    return DbResult<QList<FileAttachment>>::Error(
+        "文件附件表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<QList<FileAttachment>>::Error("数据库未打开");
+  }
+
+  QSqlQuery query(c.db);
+  query.setForwardOnly(true);
+  if (!SqlExec::run(query, SELECT_ALL_SQL)) {
+    return DbResult<QList<FileAttachment>>::Error(
+        QString("查询附件失败: %1").arg(query.lastError().text()));
+  }
+
+  QList<FileAttachment> list;
+  while (query.next()) list.append(buildAttachment(query));
+  return DbResult<QList<FileAttachment>>::Success(std::move(list));
+}
+
+QString FileAttachmentTable::selectByPageSql(const PageParams& params) {
+  QString orderBy =
+      params.orderBy.isEmpty() ? "id" : sanitizeOrderBy(params.orderBy);
+  return QString(
+             "SELECT id, owner_type, owner_id, file_name, mime_type, "
+             "byte_size, content_hash, created_at FROM file_attachment "
+             "ORDER BY %1 %2 LIMIT %3 OFFSET %4")
+      .arg(orderBy)
+      .arg(params.ascending ? "ASC" : "DESC")
+      .arg(params.pageSize)
+      .arg(params.offset());
+}
+
+DbResult<PageResult<FileAttachment>> FileAttachmentTable::selectByPage(
+    const PageParams& params) const {
+  if (!m_ops) {
+    return DbResult<PageResult<FileAttachment>>::Error(
+        "文件附件表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<PageResult<FileAttachment>>::Error("数据库未打开");
+  }
+
+  int total = m_ops->getTotalCount();
+
+  QSqlQuery query(c.db);
+  query.setForwardOnly(true);
+  if (!SqlExec::run(query, selectByPageSql(params))) {
+    return DbResult<PageResult<FileAttachment>>::Error(
+        QString("分页查询附件失败: %1").arg(query.lastError().text()));
+  }
+
+  QList<FileAttachment> list;
+  while (query.next()) list.append(buildAttachment(query));
+  return DbResult<PageResult<FileAttachment>>::Success(
+      PageResult<FileAttachment>(std::move(list), total, params));
+}
+
+DbResult<int> FileAttachmentTable::batchInsert(
+    const QList<FileAttachment>& attachments) {
+  if (!m_ops) {
+    return DbResult<int>::Error("文件附件表未初始化或已释放");
+  }
+  if (attachments.isEmpty()) {
+    return DbResult<int>::Error("附件列表为空");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) return DbResult<int>::Error("数据库未打开");
+
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+  for (const FileAttachment& a : attachments) {
+    if (!a.isValid() || !m_store.contains(a.contentHash)) {
+      return DbResult<int>::Error(
+          QString("附件 '%1' 元数据无效或内容不存在").arg(a.fileName));
+    }
+  }
+
+  if (!SqlExec::begin(c.db)) {
+    return DbResult<int>::Error("无法开启事务");
+  }
+  AuditTrail::DeferredScope auditScope(m_ops->m_database);
+
+  int count = 0;
+  for (const FileAttachment& a : attachments) {
+    FileAttachment row = a;
+    row.byteSize = m_store.sizeOf(a.contentHash);
+    if (!ensureContentRow(c.db, row.contentHash, row.byteSize)) {
+      SqlExec::rollback(c.db);
+      return DbResult<int>::Error("写入内容记录失败");
+    }
+    auto r = insertRow(c.db, row);
+    if (!r.success) {
+      SqlExec::rollback(c.db);
+      return DbResult<int>::Error(
+          QString("批量插入附件失败: %1").arg(r.errorMessage));
+    }
+    ++count;
+  }
+
+  if (!SqlExec::commit(c.db)) {
+    SqlExec::rollback(c.db);
+    return DbResult<int>::Error("提交事务失败");
+  }
+  auditScope.commit();
+  return DbResult<int>::Success(count);
+}
+
+DbResult<int> FileAttachmentTable::attachFile(const AttachmentSource& source) {
+  auto r = attachFiles({source}, 1);
+  if (!r.success) return DbResult<int>::Error(r.errorMessage);
+  return DbResult<int>::Success(r.data.first());
+}
+
+DbResult<QList<int>> FileAttachmentTable::attachFiles(
+    const QList<AttachmentSource>& sources, int threads) {
+  if (!m_ops) {
+    return DbResult<QList<int>>::Error("文件附件表未初始化或已释放");
+  }
+  if (sources.isEmpty()) {
+    return DbResult<QList<int>>::Error("附件列表为空");
+  }
+
+  QStringList paths;
+  paths.reserve(sources.size());
+  for (const AttachmentSource& s : sources) {
+    if (s.filePath.isEmpty() || s.ownerType.isEmpty() || s.ownerId <= 0) {
+      return DbResult<QList<int>>::Error(
+          QString("附件来源无效: '%1'").arg(s.filePath));
+    }
+    paths.append(s.filePath);
+  }
+
+  // 第一阶段：多线程流式计算摘要，不占用数据库锁
+  const QVector<FileDigest> hashed =
+      ContentAddressedStore::hashFiles(paths, threads);
+  for (const FileDigest& d : hashed) {
+    if (d.digest.isEmpty()) {
+      return DbResult<QList<int>>::Error(
+          QString("计算文件摘要失败 '%1': %2").arg(d.path, d.error));
+    }
+  }
+
+  // 第二阶段：只复制存储中没有的内容，同批重复内容只复制一次
+  QStringList toCopy;
+  QStringList expected;
+  QSet<QString> seen;
+  for (const FileDigest& d : hashed) {
+    if (seen.contains(d.digest)) continue;
+    seen.insert(d.digest);
+    if (!m_store.contains(d.digest)) {
+      toCopy.append(d.path);
+      expected.append(d.digest);
+    }
+  }
+
+  const QVector<FileDigest> copied = m_store.putFiles(toCopy, threads);
+  for (int i = 0; i < copied.size(); ++i) {
+    if (copied[i].digest.isEmpty()) {
+      return DbResult<QList<int>>::Error(
+          QString("复制附件内容失败 '%1': %2")
+              .arg(copied[i].path, copied[i].error));
+    }
+    if (copied[i].digest != expected[i]) {
+      return DbResult<QList<int>>::Error(
+          QString("文件在导入过程中被修改: '%1'").arg(copied[i].path));
+    }
+  }
+
+  // 第三阶段：单事务写入附件行。已复制但未入库的内容（事务失败时）
+  // 没有内容行，过宽限期后由回收线程作为孤立文件清理
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) return DbResult<QList<int>>::Error("数据库未打开");
+
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+  if (!SqlExec::begin(c.db)) {
+    return DbResult<QList<int>>::Error("无法开启事务");
+  }
+  AuditTrail::DeferredScope auditScope(m_ops->m_database);
+
+  QList<int> ids;
+  ids.reserve(sources.size());
+  for (int i = 0; i < sources.size(); ++i) {
+    const AttachmentSource& s = sources[i];
+    const FileDigest& d = hashed[i];
+
+    // 摘要阶段与持锁之间内容可能已被回收，此时从源文件补回
+    if (!m_store.contains(d.digest)) {
+      QString error;
+      if (m_store.putFile(s.filePath, nullptr, &error) != d.digest) {
+        SqlExec::rollback(c.db);
+        return DbResult<QList<int>>::Error(
+            QString("补写附件内容失败 '%1': %2").arg(s.filePath, error));
+      }
+    }
+
+    if (!ensureContentRow(c.db, d.digest, d.size)) {
+      SqlExec::rollback(c.db);
+      return DbResult<QList<int>>::Error("写入内容记录失败");
+    }
+
+    FileAttachment row;
+    row.ownerType = s.ownerType;
+    row.ownerId = s.ownerId;
+    row.fileName =
+        s.fileName.isEmpty() ? QFileInfo(s.filePath).fileName() : s.fileName;
+    row.mimeType = s.mimeType;
+    row.byteSize = d.size;
+    row.contentHash = d.digest;
+
+    auto r = insertRow(c.db, row);
+    if (!r.success) {
+      SqlExec::rollback(c.db);
+      return DbResult<QList<int>>::Error(
+          QString("写入附件失败: %1").arg(r.errorMessage));
+    }
+    ids.append(r.data);
+  }
+
+  if (!SqlExec::commit(c.db)) {
+    SqlExec::rollback(c.db);
+    return DbResult<QList<int>>::Error("提交事务失败");
+  }
+  auditScope.commit();
+  return DbResult<QList<int>>::Success(std::move(ids));
+}
+
+DbResult<ContentView> FileAttachmentTable::openContent(int id) const {
+  if (!m_ops) {
+    return DbResult<ContentView>::Error("文件附件表未初始化或已释放");
+  }
+
+  QString hash;
+  {
+    auto c = m_ops->acquireDb();
+    if (!c.db.isOpen()) return DbResult<ContentView>::Error("数据库未打开");
+
+    QSqlQuery query(c.db);
+    query.prepare(SELECT_HASH_BY_ID_SQL);
+    query.addBindValue(id);
+    if (!SqlExec::run(query) || !query.next()) {
+      return DbResult<ContentView>::Error(
+          "未找到指定的附件", DbErrorCode::NOT_FOUND);
+    }
+    hash = query.value(0).toString();
+  }
+
+  ContentView view = m_store.view(hash);
+  if (!view.isValid()) {
+    return DbResult<ContentView>::Error(
+        QString("映射附件内容失败: %1").arg(hash));
+  }
+  return DbResult<ContentView>::Success(std::move(view));
+}
+
+DbResult<QList<FileAttachment>> FileAttachmentTable::selectByOwner(
+    const QString& ownerType, int ownerId) const {
+  if (!m_ops) {
+    return DbResult<QList<FileAttachment>>::Error(
+        "文件附件表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<QList<FileAttachment>>::Error("数据库未打开");
+  }
+
+  QSqlQuery query(c.db);
+  query.setForwardOnly(true);
+  query.prepare(SELECT_BY_OWNER_SQL);
+  query.addBindValue(ownerType);
+  query.addBindValue(ownerId);
+  if (!SqlExec::run(query)) {
+    return DbResult<QList<FileAttachment>>::Error(
+        QString("查询对象附件失败: %1").arg(query.lastError().text()));
+  }
+
+  QList<FileAttachment> list;
+  while (query.next()) list.append(buildAttachment(query));
+  return DbResult<QList<FileAttachment>>::Success(std::move(list));
+}
+
+DbResult<AttachmentStoreUsage> FileAttachmentTable::usage() const {
+  if (!m_ops) {
+    return DbResult<AttachmentStoreUsage>::Error("文件附件表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<AttachmentStoreUsage>::Error("数据库未打开");
+  }
+
+  QSqlQuery query(c.db);
+  if (!SqlExec::run(query, USAGE_SQL) || !query.next()) {
+    return DbResult<AttachmentStoreUsage>::Error(
+        QString("统计附件占用失败: %1").arg(query.lastError().text()));
+  }
+
+  AttachmentStoreUsage u;
+  u.attachments = query.value(0).toInt();
+  u.logicalBytes = query.value(1).toLongLong();
+  u.contents = query.value(2).toInt();
+  u.storedBytes = query.value(3).toLongLong();
+  u.unreferenced = query.value(4).toInt();
+  return DbResult<AttachmentStoreUsage>::Success(std::move(u));
+}
+
+DbResult<int> FileAttachmentTable::collectGarbage(int graceSecs) {
+  if (!m_ops) {
+    return DbResult<int>::Error("文件附件表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) return DbResult<int>::Error("数据库未打开");
+
+  const qint64 cutoff =
+      QDateTime::currentSecsSinceEpoch() - qMax(0, graceSecs);
+  int purged = 0;
+  QSet<QString> known;
+  {
+    // 与导入的持锁阶段互斥：导入在锁内确认内容存在后才写附件行
+    ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+    QSqlQuery query(c.db);
+    query.setForwardOnly(true);
+    query.prepare(SELECT_GARBAGE_SQL);
+    query.addBindValue(cutoff);
+    if (!SqlExec::run(query)) {
+      return DbResult<int>::Error(
+          QString("查询待回收内容失败: %1").arg(query.lastError().text()));
+    }
+
+    QStringList garbage;
+    while (query.next()) garbage.append(query.value(0).toString());
+    query.finish();
+
+    QStringList removed;
+    if (!garbage.isEmpty()) {
+      if (!SqlExec::begin(c.db)) {
+        return DbResult<int>::Error("无法开启事务");
+      }
+      query.prepare(DELETE_GARBAGE_SQL);
+      for (const QString& hash : garbage) {
+        query.bindValue(0, hash);
+        if (!SqlExec::run(query)) {
+          SqlExec::rollback(c.db);
+          return DbResult<int>::Error(
+              QString("删除内容记录失败: %1").arg(query.lastError().text()));
+        }
+        if (query.numRowsAffected() > 0) removed.append(hash);
+      }
+      if (!SqlExec::commit(c.db)) {
+        SqlExec::rollback(c.db);
+        return DbResult<int>::Error("提交事务失败");
+      }
+    }
+
+    // 文件随行在锁内删除：释放锁后同内容的导入会把已有文件当作去重命中。
+    // 行已删除而文件删除失败（Windows下仍被映射）时，文件留作孤立文件
+    for (const QString& hash : removed) {
+      if (m_store.remove(hash)) ++purged;
+    }
+
+    // 孤立文件的比对基准：此刻已有内容行的摘要
+    if (!SqlExec::run(query, SELECT_CONTENT_HASHES_SQL)) {
+      return DbResult<int>::Error(
+          QString("查询内容记录失败: %1").arg(query.lastError().text()));
+    }
+    while (query.next()) known.insert(query.value(0).toString());
+  }
+
+  // 没有内容行的孤立文件（导入中途失败或上一轮删除失败遗留）：遍历存储
+  // 目录与读取修改时间在锁外进行
+  QStringList orphans;
+  for (const QString& digest : m_store.digests()) {
+    if (known.contains(digest)) continue;
+    const qint64 mtime = m_store.modifiedSecs(digest);
+    if (mtime >= 0 && mtime <= cutoff) orphans.append(digest);
+  }
+
+  // 遍历期间导入可能复用了孤立文件并写入内容行，删除前在锁内逐个复核
+  if (!orphans.isEmpty()) {
+    ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+    QSqlQuery query(c.db);
+    query.setForwardOnly(true);
+    query.prepare(CONTENT_EXISTS_SQL);
+    for (const QString& digest : orphans) {
+      query.bindValue(0, digest);
+      if (!SqlExec::run(query)) {
+        return DbResult<int>::Error(
+            QString("复核孤立文件失败: %1").arg(query.lastError().text()));
+      }
+      const bool referenced = query.next();
+      query.finish();
+      if (!referenced && m_store.remove(digest)) ++purged;
+    }
+  }
+
+  if (purged > 0) {
+    m_ops->logOperation("回收附件内容", QString::number(purged));
+  }
+  return DbResult<int>::Success(purged);
+}
+
+void FileAttachmentTable::startGarbageCollector(int intervalMs,
+                                                int graceSecs) {
+  stopGarbageCollector();
+
+  m_gcStop = false;
+  m_gcThread = std::thread([this, intervalMs, graceSecs]() {
+    QMutexLocker locker(&m_gcMutex);
+    while (!m_gcStop) {
+      m_gcCond.wait(&m_gcMutex, static_cast<unsigned long>(
+                                    qMax(1, intervalMs)));
+      if (m_gcStop) break;
+
+      locker.unlock();
+      auto r = collectGarbage(graceSecs);
+      if (!r.success) qWarning() << "附件内容回收失败:" << r.errorMessage;
+      locker.relock();
+    }
+  });
+}
+
+void FileAttachmentTable::stopGarbageCollector() {
+  if (!m_gcThread.joinable()) return;
+  {
+    QMutexLocker locker(&m_gcMutex);
+    m_gcStop = true;
+    m_gcCond.wakeAll();
+  }
+  m_gcThread.join();
+}
+
+FileAttachment FileAttachmentTable::buildAttachment(
+    const QSqlQuery& query) const {
+  FileAttachment a;
+
+  a.id = query.value(0).toInt();
+  a.ownerType = m_interner.intern(query.value(1));
+  a.ownerId = query.value(2).toInt();
+  a.fileName = query.value(3).toString();
+  a.mimeType = m_interner.intern(query.value(4));
+  a.byteSize = query.value(5).toLongLong();
+  a.contentHash = query.value(6).toString();
+  a.createdAt = query.value(7).toDateTime();
+
+  return a;
+}
@@ -0,0 +1,264 @@
+﻿#ifndef FILEATTACHMENTTABLE_H
+#define FILEATTACHMENTTABLE_H
+
+#include <QPointer>
+#include <QWaitCondition>
+#include <thread>
+
+#include "BaseDatabaseManager.h"
+#include "ContentAddressedStore.h"
+#include "DataDataBaseStruct.h"
+#include "QueryPlanChecker.h"
+#include "StringInterner.h"
+
+// ============================================================================
+// 文件附件表操作类
+// ============================================================================
+
+/**
+ * @brief 文件附件表操作类
+ * 继承自BaseTableOperations并实现createTable方法；
+ * 同时创建内容表 file_content 及维护引用计数的触发器
+ */
+class FileAttachmentTableOperations : public BaseTableOperations {
+  Q_OBJECT
+ public:
+  explicit FileAttachmentTableOperations(QSqlDatabase* db,
+                                         ConnectionPool* pool);
+  ~FileAttachmentTableOperations() override = default;
+
+  bool createTable() override;
+
+ private:
+  static const QString CREATE_CONTENT_TABLE_SQL;
+  static const QString CREATE_TABLE_SQL;
+  static const QStringList CREATE_TRIGGERS_SQL;
+};
+
+/**
+ * @brief 文件附件表业务逻辑类
+ * 附件内容按 SHA-256 存入内容寻址存储，同一内容只存一份；
+ * file_content 表记录每份内容的引用计数，由触发器随附件行的增删改
+ * 在同一事务内维护。计数归零的内容由后台回收线程在宽限期后删除。
+ */
+class FileAttachmentTable : public BaseTable<FileAttachment> {
+ public:
+  static constexpr int kDefaultGcIntervalMs = 60 * 1000;  ///< 回收周期
+  static constexpr int kDefaultGcGraceSecs = 10 * 60;     ///< 回收宽限期
+
+ private:
+  // SQL语句常量
+  static const QString INSERT_SQL;
+  static const QString INSERT_CONTENT_SQL;
+  static const QString UPDATE_SQL;
+  static const QString DELETE_SQL;
+  static const QString SELECT_BY_ID_SQL;
+  static const QString SELECT_ALL_SQL;
+  static const QString SELECT_BY_OWNER_SQL;
+  static const QString SELECT_HASH_BY_ID_SQL;
+  static const QString SELECT_GARBAGE_SQL;
+  static const QString DELETE_GARBAGE_SQL;
+  static const QString SELECT_CONTENT_HASHES_SQL;
+  static const QString CONTENT_EXISTS_SQL;
+  static const QString USAGE_SQL;
+
+  QPointer<FileAttachmentTableOperations> m_ops;  ///< 安全弱引用，避免悬空
+  ContentAddressedStore m_store;                  ///< 附件内容存储
+  mutable StringInterner m_interner;              ///< 低基数列驻留池
+
+  // 后台回收线程
+  std::thread m_gcThread;
+  QMutex m_gcMutex;
+  QWaitCondition m_gcCond;
+  bool m_gcStop = false;
+
+ public:
+  /**
+   * @brief 构造函数
+   * @param db 数据库连接指针
+   * @param pool 连接池
+   * @param storeRoot 内容存储根目录
+   */
+  FileAttachmentTable(QSqlDatabase* db, ConnectionPool* pool,
+                      const QString& storeRoot);
+
+  /**
+   * @brief 析构函数（停止后台回收）
+   */
+  ~FileAttachmentTable() override;
+
+  // ========================================================================
+  // 实现BaseTable虚函数
+  // ========================================================================
+
+  /**
+   * @brief 插入附件元数据（内容须已在存储中）
+   * @param attachment 附件元数据
+   * @return 操作结果，包含新附件ID
+   */
+  DbResult<int> insert(const FileAttachment& attachment) override;
+
+  /**
+   * @brief 更新附件元数据（更换内容时引用计数随之调整）
+   * @param attachment 附件元数据
+   * @return 操作结果
+   */
+  DbResult<bool> update(const FileAttachment& attachment) override;
+
+  /**
+   * @brief 删除附件（内容在引用归零且过宽限期后由后台回收）
+   * @param id 附件ID
+   * @return 操作结果
+   */
+  DbResult<bool> deleteById(int id) override;
+
+  /**
+   * @brief 根据ID查询附件元数据
+   * @param id 附件ID
+   * @return 操作结果，包含附件元数据
+   */
+  DbResult<FileAttachment> selectById(int id) const override;
+
+  /**
+   * @brief 查询所有附件元数据
+   * @return 操作结果，包含附件列表
+   */
+  DbResult<QList<FileAttachment>> selectAll() const override;
+
+  /**
+   * @brief 分页查询附件元数据
+   * @param params 分页参数
+   * @return 操作结果，包含分页结果
+   */
+  DbResult<PageResult<FileAttachment>> selectByPage(
+      const PageParams& params) const override;
+
+  /**
+   * @brief 批量插入附件元数据（单事务，内容须已在存储中）
+   * @param attachments 附件列表
+   * @return 操作结果，包含成功插入的数量
+   */
+  DbResult<int> batchInsert(const QList<FileAttachment>& attachments) override;
+
+  // ========================================================================
+  // 附件操作
+  // ========================================================================
+
+  /**
+   * @brief 导入一个文件作为附件
+   * @param source 附件来源
+   * @return 操作结果，包含新附件ID
+   */
+  DbResult<int> attachFile(const AttachmentSource& source);
+
+  /**
+   * @brief 批量导入文件作为附件
+   * 先多线程流式计算摘要，只复制存储中尚不存在的内容（同批重复内容
+   * 只复制一次），最后在单个事务内写入全部附件行
+   * @param sources 附件来源列表
+   * @param threads 哈希/复制线程数（<=0 时取CPU核数）
+   * @return 操作结果，包含与输入一一对应的新附件ID
+   */
+  DbResult<QList<int>> attachFiles(const QList<AttachmentSource>& sources,
+                                   int threads = 0);
+
+  /**
+   * @brief 映射附件内容为只读视图（零拷贝）
+   * @param id 附件ID
+   * @return 操作结果，包含内容视图
+   */
+  DbResult<ContentView> openContent(int id) const;
+
+  /**
+   * @brief 查询某对象的全部附件
+   * @param ownerType 所属对象类型
+   * @param ownerId 所属对象ID
+   * @return 操作结果，包含附件列表
+   */
+  DbResult<QList<FileAttachment>> selectByOwner(const QString& ownerType,
+                                                int ownerId) const;
+
+  /**
+   * @brief 存储占用统计
+   * @return 操作结果，包含占用统计
+   */
+  DbResult<AttachmentStoreUsage> usage() const;
+
+  // ========================================================================
+  // 垃圾回收
+  // ========================================================================
+
+  /**
+   * @brief 回收一次未被引用的内容
+   * 删除引用计数为0且超过宽限期的内容行及文件，并清理没有内容行的
+   * 孤立文件（导入中途崩溃遗留）。表锁只在删除内容行与最后复核孤立
+   * 文件时持有，遍历存储目录不阻塞读写
+   * @param graceSecs 宽限期（秒），0表示立即回收
+   * @return 操作结果，包含回收的内容数
+   */
+  DbResult<int> collectGarbage(int graceSecs = kDefaultGcGraceSecs);
+
+  /**
+   * @brief 启动后台回收线程
+   * @param intervalMs 回收周期（毫秒）
+   * @param graceSecs 宽限期（秒）
+   */
+  void startGarbageCollector(int intervalMs = kDefaultGcIntervalMs,
+                             int graceSecs = kDefaultGcGraceSecs);
+
+  /**
+   * @brief 停止后台回收线程（等待当前一轮结束）
+   */
+  void stopGarbageCollector();
+
+  /**
+   * @brief 获取内容存储
+   * @return 存储引用
+   */
+  const ContentAddressedStore& contentStore() const { return m_store; }
+
+  /**
+   * @brief 获取基础操作对象
+   * @return 基础操作对象指针
+   */
+  FileAttachmentTableOperations* operations() const { return m_ops.data(); }
+
+  /**
+   * @brief 各SQL语句的查询计划期望（供 QueryPlanChecker 回归检查）
+   * @return 期望列表
+   */
+  static QList<PlanExpectation> planExpectations();
+
+ private:
+  /**
+   * @brief 确保内容行存在（调用方持锁，引用计数由触发器维护）
+   */
+  bool ensureContentRow(QSqlDatabase& db, const QString& hash, qint64 size);
+
+  /**
+   * @brief 在给定连接上插入附件行（调用方持锁）
+   */
+  DbResult<int> insertRow(QSqlDatabase& db, const FileAttachment& attachment);
+
+  /**
+   * @brief 从查询结果构建附件元数据
+   * @param query SQL查询对象
+   * @return 附件元数据
+   */
+  FileAttachment buildAttachment(const QSqlQuery& query) const;
+
+  /**
+   * @brief 生成分页查询SQL
+   * @param params 分页参数（排序列经 sanitizeOrderBy 过滤）
+   * @return SQL语句
+   */
+  static QString selectByPageSql(const PageParams& params);
+
+  static inline QString sanitizeOrderBy(const QString& col) {
+    static const QSet<QString> k = {"id",        "owner_type", "owner_id",
+                                    "file_name", "byte_size",  "created_at"};
+    return k.contains(col) ? col : "id";
+  }
+};
+
+#endif  // FILEATTACHMENTTABLE_H
@@ -0,0 +1,440 @@
+﻿#include "SystemLogTable.h"
+
+#include <QSet>
+
+#include "WorkloadCapture.h"
+
+// ============================================================================
+// SystemLogTable SQL语句常量定义
+// ============================================================================
+
+const QString SystemLogTable::INSERT_SQL = R"(
+    INSERT INTO system_log (ts_ms, level, source, operation, message, thread_id)
+    VALUES (?, ?, ?, ?, ?, ?)
+)";
+
+const QString SystemLogTable::SELECT_BY_ID_SQL = R"(
+    SELECT id, ts_ms, level, source, operation, message, thread_id
+    FROM system_log WHERE id = ?
+)";
+
+const QString SystemLogTable::SELECT_ALL_SQL = R"(
+    SELECT id, ts_ms, level, source, operation, message, thread_id
+    FROM system_log ORDER BY id
+)";
+
+const QVector<ColumnSpec> SystemLogTable::COLUMNAR_SCHEMA = {
+    {"id", ColumnType::INTEGER},
+    {"ts_ms", ColumnType::INTEGER},
+    {"level", ColumnType::INTEGER},
+    {"source", ColumnType::TEXT},
+    {"operation", ColumnType::TEXT},
+    {"message", ColumnType::TEXT},
+    {"thread_id", ColumnType::INTEGER}};
+
+const QString SystemLogTable::SELECT_BY_RANGE_SQL = R"(
+    SELECT id, ts_ms, level, source, operation, message, thread_id
+    FROM system_log
+    WHERE ts_ms BETWEEN ? AND ? AND level >= ?
+    ORDER BY ts_ms, id LIMIT ?
+)";
+
+const QString SystemLogTable::PURGE_SQL = R"(
+    DELETE FROM system_log WHERE ts_ms < ?
+)";
+
+QList<PlanExpectation> SystemLogTable::planExpectations() {
+  const QString pk = "INTEGER PRIMARY KEY";
+  QList<PlanExpectation> list = {
+      {"SystemLogTable::SELECT_BY_ID_SQL", SELECT_BY_ID_SQL, {pk}},
+      {"SystemLogTable::SELECT_BY_RANGE_SQL", SELECT_BY_RANGE_SQL,
+       {"idx_system_log_ts"}},
+      {"SystemLogTable::PURGE_SQL", PURGE_SQL, {"idx_system_log_ts"}},
+      {"SystemLogTable::SELECT_ALL_SQL", SELECT_ALL_SQL, {}, true}};
+
+  // 分页按主键或时间索引顺序扫描，不得额外排序
+  for (bool ascending : {true, false}) {
+    const QString dir = ascending ? "ASC" : "DESC";
+    list.append({QString("SystemLogTable::selectByPage(id %1)").arg(dir),
+                 pageQuery(PageParams{3, 50, "id", ascending}).sql(),
+                 {},
+                 true});
+    list.append({QString("SystemLogTable::selectByPage(ts_ms %1)").arg(dir),
+                 pageQuery(PageParams{3, 50, "ts_ms", ascending}).sql(),
+                 {"idx_system_log_ts"},
+                 true});
+  }
+  list.append({"SystemLogTable::selectByIds",
+               TableQuery("system_log", COLUMNAR_SCHEMA)
+                   .whereIn("id", {1, 2, 3})
+                   .sql(),
+               {pk}});
+  return list;
+}
+
+// ============================================================================
+// SystemLogTableOperations 实现
+// ============================================================================
+
+// 时间戳以整数毫秒存储：写入端无需格式化，范围查询可直接走索引
+const QString SystemLogTableOperations::CREATE_TABLE_SQL = R"(
+  CREATE TABLE IF NOT EXISTS system_log (
+    id INTEGER PRIMARY KEY,
+    ts_ms INTEGER NOT NULL,
+    level INTEGER NOT NULL,
+    source TEXT,
+    operation TEXT,
+    message TEXT,
+    thread_id INTEGER
+  )
+)";
+
+SystemLogTableOperations::SystemLogTableOperations(QSqlDatabase* db,
+                                                   ConnectionPool* pool)
+    : BaseTableOperations(db, "system_log", TableType::SYSTEM_LOG, pool,
+                          nullptr) {
+  setAuditEnabled(false);  // 系统日志为只追加的运行记录，不产生审计
+}
+
+bool SystemLogTableOperations::createTable() {
+  ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
+
+  auto c = acquireDb();
+  if (!c.db.isOpen()) {
+    qCritical() << "数据库连接未打开!";
+    return false;
+  }
+
+  QSqlQuery query(c.db);
+  if (!query.exec(CREATE_TABLE_SQL)) {
+    QString error = query.lastError().text();
+    qCritical() << "创建系统日志表失败:" << error;
+    logOperation("创建表失败", error);
+    return false;
+  }
+
+  query.exec(
+      "CREATE INDEX IF NOT EXISTS idx_system_log_ts ON system_log(ts_ms)");
+  query.exec(
+      "CREATE INDEX IF NOT EXISTS idx_system_log_level_ts ON "
+      "system_log(level, ts_ms)");
+
+  logOperation("创建表成功", m_tableName);
+  return true;
+}
+
+// ============================================================================
+// SystemLogTable实现
+// ============================================================================
+
+SystemLogTable::SystemLogTable(QSqlDatabase* db, ConnectionPool* pool)
+    : BaseTable<SystemLogRecord>(nullptr) {
+  m_ops = new SystemLogTableOperations(db, pool);
+  m_baseOps = m_ops;
+}
+
+SystemLogTable::~SystemLogTable() { m_baseOps = nullptr; }
+
+int SystemLogTable::insertRange(QSqlDatabase& db, const SystemLogRecord* begin,
+                                const SystemLogRecord* end,
+                                QString* error) const {
+  if (!SqlExec::begin(db)) {
+    if (error) *error = "无法开启事务";
+    return -1;
+  }
+
+  QSqlQuery query(db);
+  query.prepare(INSERT_SQL);
+
+  int count = 0;
+  for (const SystemLogRecord* r = begin; r != end; ++r) {
+    query.bindValue(0, r->timestampMs);
+    query.bindValue(1, static_cast<int>(r->level));
+    query.bindValue(2, r->source);
+    query.bindValue(3, r->operation);
+    query.bindValue(4, r->message);
+    query.bindValue(5, static_cast<qint64>(r->threadId));
+    if (!SqlExec::run(query)) {
+      if (error) *error = query.lastError().text();
+      query.finish();
+      SqlExec::rollback(db);
+      return -1;
+    }
+    ++count;
+  }
+
+  query.finish();
+  if (!SqlExec::commit(db)) {
+    if (error) *error = db.lastError().text();
+    SqlExec::rollback(db);
+    return -1;
+  }
+  return count;
+}
+
+DbResult<int> SystemLogTable::insert(const SystemLogRecord& record) {
+  if (!m_ops) {
+    return DbResult<int>::Error("系统日志表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<int>::Error("数据库未打开");
+  }
+
+  QSqlQuery query(c.db);
+  query.prepare(INSERT_SQL);
+  query.addBindValue(record.timestampMs);
+  query.addBindValue(static_cast<int>(record.level));
+  query.addBindValue(record.source);
+  query.addBindValue(record.operation);
+  query.addBindValue(record.message);
+  query.addBindValue(static_cast<qint64>(record.threadId));
+
+  if (!SqlExec::run(query)) {
+    return DbResult<int>::Error(
+        QString("写入系统日志失败: %1").arg(query.lastError().text()));
+  }
+  return DbResult<int>::Success(query.lastInsertId().toInt());
+}
+
+DbResult<bool> SystemLogTable::update(const SystemLogRecord&) {
+  return DbResult<bool>::Error("系统日志为只追加表，不支持更新");
+}
+
+DbResult<bool> SystemLogTable::deleteById(int) {
+  return DbResult<bool>::Error("系统日志为只追加表，请使用按时间清理");
+}
+
+DbResult<SystemLogRecord> SystemLogTable::selectById(int id) const {
+  if (!m_ops) {
+    return DbResult<SystemLogRecord>::Error("系统日志表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) return DbResult<SystemLogRecord>::Error("数据库未打开");
+
+  QSqlQuery query(c.db);
+  query.prepare(SELECT_BY_ID_SQL);
+  query.addBindValue(id);
+
+  if (!SqlExec::run(query)) {
+    return DbResult<SystemLogRecord>::Error(
+        QString("查询系统日志失败: %1").arg(query.lastError().text()));
+  }
+
+  if (query.next()) {
+    return DbResult<SystemLogRecord>::Success(buildRecord(query));
+  }
+  return DbResult<SystemLogRecord>::Error(
+      "未找到指定的日志记录", DbErrorCode::NOT_FOUND);
+}
+
+DbResult<QHash<int, SystemLogRecord>> SystemLogTable::selectByIds(
+    const QList<int>& ids) const {
+  if (!m_ops) {
+    return DbResult<QHash<int, SystemLogRecord>>::Error(
+        "系统日志表未初始化或已释放");
+  }
+  return selectRowsByIds(ids);
+}
+
+DbResult<QList<SystemLogRecord>> SystemLogTable::selectAll() const {
+  if (!m_ops) {
+    return DbResult<QList<SystemLogRecord>>::Error(
+        "系统日志表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<QList<SystemLogRecord>>::Error("数据库未打开");
+  }
+
+  QSqlQuery query(c.db);
+  query.setForwardOnly(true);
+  if (!SqlExec::run(query, SELECT_ALL_SQL)) {
+    return DbResult<QList<SystemLogRecord>>::Error(
+        QString("查询系统日志失败: %1").arg(query.lastError().text()));
+  }
+
+  QList<SystemLogRecord> records;
+  while (query.next()) records.append(buildRecord(query));
+  return DbResult<QList<SystemLogRecord>>::Success(std::move(records));
+}
+
+DbResult<ColumnarResult> SystemLogTable::selectAllColumnar() const {
+  if (!m_ops) {
+    return DbResult<ColumnarResult>::Error("系统日志表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<ColumnarResult>::Error("数据库未打开");
+  }
+
+  QSqlQuery query(c.db);
+  query.setForwardOnly(true);
+  if (!SqlExec::run(query, SELECT_ALL_SQL)) {
+    return DbResult<ColumnarResult>::Error(
+        QString("查询系统日志失败: %1").arg(query.lastError().text()));
+  }
+
+  ColumnarResult result(COLUMNAR_SCHEMA);
+  result.appendAll(query);
+  result.squeeze();
+  return DbResult<ColumnarResult>::Success(std::move(result));
+}
+
+TableQuery SystemLogTable::pageQuery(const PageParams& params) {
+  const QString orderBy =
+      params.orderBy.isEmpty() ? "id" : sanitizeOrderBy(params.orderBy);
+  return TableQuery("system_log", COLUMNAR_SCHEMA)
+      .orderBy(orderBy, params.ascending)
+      .limit(params.pageSize, params.offset());
+}
+
+DbResult<QList<SystemLogRecord>> SystemLogTable::select(
+    const TableQuery& query) const {
+  if (!m_ops) {
+    return DbResult<QList<SystemLogRecord>>::Error(
+        "系统日志表未初始化或已释放");
+  }
+  return selectRows(query, [this](const QSqlQuery& row) {
+    return buildRecord(row);
+  });
+}
+
+DbResult<PageResult<SystemLogRecord>> SystemLogTable::selectByPage(
+    const PageParams& params) const {
+  if (!m_ops) {
+    return DbResult<PageResult<SystemLogRecord>>::Error(
+        "系统日志表未初始化或已释放");
+  }
+
+  int total = m_ops->getTotalCount();
+
+  auto rows = select(pageQuery(params));
+  if (!rows.success) {
+    return DbResult<PageResult<SystemLogRecord>>::Error(
+        QString("分页查询系统日志失败: %1").arg(rows.errorMessage));
+  }
+  return DbResult<PageResult<SystemLogRecord>>::Success(
+      PageResult<SystemLogRecord>(std::move(rows.data), total, params));
+}
+
+DbResult<int> SystemLogTable::batchInsert(
+    const QList<SystemLogRecord>& records) {
+  if (!m_ops) {
+    return DbResult<int>::Error("系统日志表未初始化或已释放");
+  }
+  if (records.isEmpty()) {
+    return DbResult<int>::Success(0);
+  }
+
+  QVector<SystemLogRecord> batch;
+  batch.reserve(records.size());
+  for (const SystemLogRecord& r : records) batch.append(r);
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<int>::Error("数据库未打开");
+  }
+
+  QString error;
+  const int n =
+      insertRange(c.db, batch.constData(), batch.constData() + batch.size(),
+                  &error);
+  if (n < 0) {
+    return DbResult<int>::Error(QString("批量写入系统日志失败: %1").arg(error));
+  }
+  return DbResult<int>::Success(n);
+}
+
+bool SystemLogTable::appendBatch(const QVector<SystemLogRecord>& records) {
+  if (!m_ops) return false;
+  if (records.isEmpty()) return true;
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) return false;
+
+  QString error;
+  const int n =
+      insertRange(c.db, records.constData(),
+                  records.constData() + records.size(), &error);
+  if (n < 0) {
+    // 写线程中的告警由消息处理器直接输出，不会回灌到队列
+    qWarning() << "批量写入系统日志失败:" << error;
+    return false;
+  }
+  return true;
+}
+
+DbResult<QList<SystemLogRecord>> SystemLogTable::selectByTimeRange(
+    qint64 fromMs, qint64 toMs, LogLevel minLevel, int limit) const {
+  if (!m_ops) {
+    return DbResult<QList<SystemLogRecord>>::Error(
+        "系统日志表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<QList<SystemLogRecord>>::Error("数据库未打开");
+  }
+
+  QSqlQuery query(c.db);
+  query.setForwardOnly(true);
+  query.prepare(SELECT_BY_RANGE_SQL);
+  query.addBindValue(fromMs);
+  query.addBindValue(toMs);
+  query.addBindValue(static_cast<int>(minLevel));
+  query.addBindValue(limit);
+
+  if (!SqlExec::run(query)) {
+    return DbResult<QList<SystemLogRecord>>::Error(
+        QString("按时间查询系统日志失败: %1").arg(query.lastError().text()));
+  }
+
+  QList<SystemLogRecord> records;
+  while (query.next()) records.append(buildRecord(query));
+  return DbResult<QList<SystemLogRecord>>::Success(std::move(records));
+}
+
+DbResult<int> SystemLogTable::purgeOlderThan(qint64 cutoffMs) {
+  if (!m_ops) {
+    return DbResult<int>::Error("系统日志表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<int>::Error("数据库未打开");
+  }
+
+  QSqlQuery query(c.db);
+  query.prepare(PURGE_SQL);
+  query.addBindValue(cutoffMs);
+
+  if (!SqlExec::run(query)) {
+    QString error =
+        QString("清理系统日志失败: %1").arg(query.lastError().text());
+    emit m_ops->databaseError(error);
+    return DbResult<int>::Error(error);
+  }
+
+  const int removed = query.numRowsAffected();
+  m_ops->logOperation("清理日志", QString("删除 %1 条").arg(removed));
+  return DbResult<int>::Success(removed);
+}
+
+SystemLogRecord SystemLogTable::buildRecord(const QSqlQuery& query) const {
+  SystemLogRecord record;
+
+  record.id = query.value(0).toLongLong();
+  record.timestampMs = query.value(1).toLongLong();
+  record.level = static_cast<LogLevel>(query.value(2).toInt());
+  record.source = m_interner.intern(query.value(3));
+  record.operation = m_interner.intern(query.value(4));
+  record.message = query.value(5).toString();
+  record.threadId = query.value(6).toULongLong();
+
+  return record;
+}
@@ -0,0 +1,214 @@
+﻿#ifndef SYSTEMLOGTABLE_H
+#define SYSTEMLOGTABLE_H
+
+#include <QPointer>
+
+#include "BaseDatabaseManager.h"
+#include "QueryPlanChecker.h"
+#include "StringInterner.h"
+#include "SystemLogSink.h"
+
+// ============================================================================
+// 系统日志表操作类
+// ============================================================================
+
+/**
+ * @brief 系统日志表操作类
+ * 继承自BaseTableOperations并实现createTable方法
+ */
+class SystemLogTableOperations : public BaseTableOperations {
+  Q_OBJECT
+ public:
+  explicit SystemLogTableOperations(QSqlDatabase* db, ConnectionPool* pool);
+  ~SystemLogTableOperations() override = default;
+
+  bool createTable() override;
+
+ private:
+  static const QString CREATE_TABLE_SQL;
+};
+
+/**
+ * @brief 系统日志表业务逻辑类
+ * 只追加的日志存储：由 SystemLogSink 的写线程批量写入，
+ * 提供按时间/级别的查询与按时间清理
+ */
+class SystemLogTable : public BaseTable<SystemLogRecord> {
+ private:
+  // SQL语句常量
+  static const QString INSERT_SQL;
+  static const QString SELECT_BY_ID_SQL;
+  static const QString SELECT_ALL_SQL;
+  static const QVector<ColumnSpec> COLUMNAR_SCHEMA;
+  static const QString SELECT_BY_RANGE_SQL;
+  static const QString PURGE_SQL;
+
+  QPointer<SystemLogTableOperations> m_ops;  ///< 安全弱引用，避免悬空
+  mutable StringInterner m_interner;         ///< 低基数列驻留池
+
+ public:
+  /**
+   * @brief 构造函数
+   * @param db 数据库连接指针
+   * @param pool 连接池
+   */
+  explicit SystemLogTable(QSqlDatabase* db, ConnectionPool* pool);
+
+  /**
+   * @brief 析构函数
+   */
+  ~SystemLogTable() override;
+
+  // ========================================================================
+  // 实现BaseTable虚函数
+  // ========================================================================
+
+  /**
+   * @brief 插入单条日志
+   * @param record 日志记录
+   * @return 操作结果，包含新记录的ID
+   */
+  DbResult<int> insert(const SystemLogRecord& record) override;
+
+  /**
+   * @brief 日志只追加，不支持更新
+   */
+  DbResult<bool> update(const SystemLogRecord& record) override;
+
+  /**
+   * @brief 日志只追加，不支持按ID删除（请使用purgeOlderThan）
+   */
+  DbResult<bool> deleteById(int id) override;
+
+  /**
+   * @brief 根据ID查询日志
+   * @param id 记录ID
+   * @return 操作结果，包含日志记录
+   */
+  DbResult<SystemLogRecord> selectById(int id) const override;
+
+  /**
+   * @brief 按ID批量查询日志（每批一条 id IN (...) 查询）
+   * @param ids 记录ID列表
+   * @return 操作结果，ID到日志的映射
+   */
+  DbResult<QHash<int, SystemLogRecord>> selectByIds(
+      const QList<int>& ids) const override;
+
+  /**
+   * @brief 查询所有日志（按ID升序）
+   * @return 操作结果，包含日志列表
+   */
+  DbResult<QList<SystemLogRecord>> selectAll() const override;
+
+  /**
+   * @brief 以列式结果查询所有日志（按ID升序，导出用）
+   * @return 操作结果，列顺序见 COLUMNAR_SCHEMA
+   */
+  DbResult<ColumnarResult> selectAllColumnar() const override;
+
+  /**
+   * @brief 分页查询日志
+   * @param params 分页参数
+   * @return 操作结果，包含分页结果
+   */
+  DbResult<PageResult<SystemLogRecord>> selectByPage(
+      const PageParams& params) const override;
+
+  /**
+   * @brief 条件查询允许的列（同 COLUMNAR_SCHEMA）
+   */
+  QVector<ColumnSpec> queryColumns() const override { return COLUMNAR_SCHEMA; }
+
+  /**
+   * @brief 按条件查询日志（如级别、来源与时间范围的任意组合）
+   * @param query 由 tableQuery() 创建的条件查询（不带投影）
+   * @return 操作结果，包含日志列表
+   */
+  DbResult<QList<SystemLogRecord>> select(
+      const TableQuery& query) const override;
+
+  /**
+   * @brief 批量追加日志（单事务、复用预编译语句）
+   * 在汇聚器写线程中调用，内部不再调用logOperation以免自我回灌
+   * @param records 日志列表
+   * @return 操作结果，包含写入条数
+   */
+  DbResult<int> batchInsert(const QList<SystemLogRecord>& records) override;
+
+  // ========================================================================
+  // 扩展功能方法
+  // ========================================================================
+
+  /**
+   * @brief 追加一批日志（汇聚器刷写回调）
+   * @param records 日志批次
+   * @return 是否整批写入成功
+   */
+  bool appendBatch(const QVector<SystemLogRecord>& records);
+
+  /**
+   * @brief 按时间范围与最低级别查询
+   * @param fromMs 起始时间（毫秒，含）
+   * @param toMs 结束时间（毫秒，含）
+   * @param minLevel 最低级别
+   * @param limit 最大条数
+   * @return 操作结果，包含日志列表（按时间升序）
+   */
+  DbResult<QList<SystemLogRecord>> selectByTimeRange(
+      qint64 fromMs, qint64 toMs, LogLevel minLevel = LogLevel::DEBUG,
+      int limit = 1000) const;
+
+  /**
+   * @brief 清理早于指定时间的日志
+   * @param cutoffMs 截止时间（毫秒，不含）
+   * @return 操作结果，包含删除条数
+   */
+  DbResult<int> purgeOlderThan(qint64 cutoffMs);
+
+  /**
+   * @brief 获取基础操作对象
+   * @return 基础操作对象指针
+   */
+  SystemLogTableOperations* operations() const { return m_ops.data(); }
+
+  /**
+   * @brief 各SQL语句的查询计划期望（供 QueryPlanChecker 回归检查）
+   * @return 期望列表
+   */
+  static QList<PlanExpectation> planExpectations();
+
+ private:
+  /**
+   * @brief 从查询结果构建SystemLogRecord对象
+   * @param query SQL查询对象
+   * @return SystemLogRecord对象
+   */
+  SystemLogRecord buildRecord(const QSqlQuery& query) const;
+
+  /**
+   * @brief 在给定连接上以单事务写入一批日志
+   * @param db 数据库连接
+   * @param begin 起始记录
+   * @param end 结束记录（不含）
+   * @param error 失败时的错误信息
+   * @return 写入条数，失败返回-1
+   */
+  int insertRange(QSqlDatabase& db, const SystemLogRecord* begin,
+                  const SystemLogRecord* end, QString* error) const;
+
+  /**
+   * @brief 生成分页查询
+   * @param params 分页参数（排序列经 sanitizeOrderBy 过滤）
+   * @return 条件查询（页大小与偏移为绑定参数）
+   */
+  static TableQuery pageQuery(const PageParams& params);
+
+  static inline QString sanitizeOrderBy(const QString& col) {
+    static const QSet<QString> k = {"id", "ts_ms", "level", "source",
+                                    "operation"};
+    return k.contains(col) ? col : "id";
+  }
+};
+
+#endif  // SYSTEMLOGTABLE_H
@@ -2,6 +2,11 @@
 
 #include <QSet>
 #include <QStringList>
+#include <algorithm>
+
+#include "AuditTrail.h"
+#include "TraceSpan.h"
+#include "WorkloadCapture.h"
 
 // ============================================================================
 // CameraInfoTable SQL语句常量定义
@@ -33,6 +38,16 @@ const QString CameraInfoTable::SELECT_ALL_SQL = R"(
     FROM camera_info ORDER BY name
 )";
 
+const QVector<ColumnSpec> CameraInfoTable::COLUMNAR_SCHEMA = {
+    {"id", ColumnType::INTEGER},
+    {"name", ColumnType::TEXT},
+    {"version", ColumnType::TEXT},
+    {"connection_type", ColumnType::TEXT},
+    {"serial_number", ColumnType::TEXT},
+    {"manufacturer", ColumnType::TEXT},
+    {"created_at", ColumnType::DATETIME},
+    {"updated_at", ColumnType::DATETIME}};
+
 const QString CameraInfoTable::SELECT_BY_SERIAL_SQL = R"(
     SELECT id, name, version, connection_type, serial_number, manufacturer, created_at, updated_at
     FROM camera_info WHERE serial_number = ?
@@ -53,6 +68,94 @@ const QString CameraInfoTable::CHECK_SERIAL_EXISTS_SQL = R"(
     SELECT COUNT(*) FROM camera_info WHERE serial_number = ? AND id != ?
 )";
 
+const QString CameraInfoTable::SELECT_BY_MANUFACTURER_SQL = R"(
+    SELECT id, name, version, connection_type, serial_number, manufacturer, created_at, updated_at
+    FROM camera_info WHERE manufacturer = ? ORDER BY name
+)";
+
+const QString CameraInfoTable::SELECT_BY_CONNECTION_TYPE_SQL = R"(
+    SELECT id, name, version, connection_type, serial_number, manufacturer, created_at, updated_at
+    FROM camera_info WHERE connection_type = ? ORDER BY name
+)";
+
+const QString CameraInfoTable::SELECT_MANUFACTURERS_SQL = R"(
+    SELECT DISTINCT manufacturer FROM camera_info
+    WHERE manufacturer IS NOT NULL ORDER BY manufacturer
+)";
+
+// serial_valid 为设备库注册的原生函数（DeviceSqlFunctions），
+// 查询计划夹具连接上没有注册，不列入 planExpectations()
+const QString CameraInfoTable::SELECT_INVALID_SERIAL_SQL = R"(
+    SELECT id, name, version, connection_type, serial_number, manufacturer, created_at, updated_at
+    FROM camera_info WHERE serial_valid(serial_number) = 0 ORDER BY id
+)";
+
+const QString CameraInfoTable::SELECT_SERIALS_SQL = R"(
+    SELECT serial_number FROM camera_info
+)";
+
+const QString CameraInfoTable::SELECT_ID_BY_SERIAL_SQL = R"(
+    SELECT id FROM camera_info WHERE serial_number = ?
+)";
+
+QList<PlanExpectation> CameraInfoTable::planExpectations() {
+  const QString pk = "INTEGER PRIMARY KEY";
+  const QString serialIndex = "sqlite_autoindex_camera_info_1";
+  QList<PlanExpectation> list = {
+      {"CameraInfoTable::SELECT_BY_ID_SQL", SELECT_BY_ID_SQL, {pk}},
+      {"CameraInfoTable::UPDATE_SQL", UPDATE_SQL, {pk}},
+      {"CameraInfoTable::DELETE_SQL", DELETE_SQL, {pk}},
+      {"CameraInfoTable::SELECT_BY_SERIAL_SQL", SELECT_BY_SERIAL_SQL,
+       {serialIndex}},
+      {"CameraInfoTable::CHECK_SERIAL_EXISTS_SQL", CHECK_SERIAL_EXISTS_SQL,
+       {serialIndex}},
+      {"CameraInfoTable::SELECT_ID_BY_SERIAL_SQL", SELECT_ID_BY_SERIAL_SQL,
+       {serialIndex}},
+      // 按名称排序的是索引命中后的少量行，允许额外排序
+      {"CameraInfoTable::SELECT_BY_MANUFACTURER_SQL",
+       SELECT_BY_MANUFACTURER_SQL, {"idx_camera_info_mfr"}, false, true},
+      {"CameraInfoTable::SELECT_BY_CONNECTION_TYPE_SQL",
+       SELECT_BY_CONNECTION_TYPE_SQL, {"idx_camera_info_conn"}, false, true},
+      {"CameraInfoTable::SELECT_MANUFACTURERS_SQL", SELECT_MANUFACTURERS_SQL,
+       {"idx_camera_info_mfr"}},
+      // 全量列出、模糊搜索与计数本就要读全表
+      {"CameraInfoTable::SELECT_ALL_SQL", SELECT_ALL_SQL, {}, true, true},
+      {"CameraInfoTable::SEARCH_SQL", SEARCH_SQL, {}, true, true},
+      {"CameraInfoTable::COUNT_SQL", COUNT_SQL, {}, true},
+      // 加载序列号索引：只读唯一索引本身，不回表
+      {"CameraInfoTable::SELECT_SERIALS_SQL", SELECT_SERIALS_SQL,
+       {serialIndex}, true},
+      {"CameraInfoTable::selectByIds",
+       TableQuery("camera_info", COLUMNAR_SCHEMA)
+           .whereIn("id", {1, 2, 3})
+           .sql(),
+       {pk}}};
+
+  // 分页按排序列顺序扫描：有索引的列须走索引、不得额外排序，
+  // 主键顺序即表顺序，其余列没有索引，只能排序
+  const QHash<QString, QString> orderIndexes = {
+      {"serial_number", serialIndex},
+      {"manufacturer", "idx_camera_info_mfr"},
+      {"connection_type", "idx_camera_info_conn"}};
+  for (const ColumnSpec& column : COLUMNAR_SCHEMA) {
+    for (bool ascending : {true, false}) {
+      const PageParams params{3, 20, column.name, ascending};
+      PlanExpectation e;
+      e.statement = QString("CameraInfoTable::selectByPage(%1 %2)")
+                        .arg(column.name, ascending ? "ASC" : "DESC");
+      e.sql = pageQuery(params).sql();
+      e.allowScan = true;
+      if (orderIndexes.contains(column.name)) {
+        e.useIndexes << orderIndexes.value(column.name);
+      } else {
+        e.allowTempBTree = column.name != "id";
+      }
+      list.append(e);
+    }
+  }
+  return list;
+}
+
 // ============================================================================
 // CameraInfoTableOperations 实现
 // ============================================================================
@@ -82,7 +185,7 @@ CameraInfoTableOperations::CameraInfoTableOperations(QSqlDatabase* db,
 bool CameraInfoTableOperations::createTable() {
   qDebug() << "CameraInfoTableOperations::createTable() 开始";
 
-  QMutexLocker locker(&m_mutex);
+  ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
   qDebug() << "获取互斥锁成功";
 
   auto c = acquireDb();
@@ -149,15 +252,43 @@ bool CameraInfoTableOperations::createTable() {
 
 CameraInfoTable::CameraInfoTable(QSqlDatabase* db, ConnectionPool* pool,
                                  QObject*)
-    : BaseTable<CameraInfo>(nullptr) {
+    : BaseTable<CameraInfo>(nullptr),
+      m_serialIndex(
+          "camera_info.serial_number",
+          [this]() -> qint64 {
+            if (!m_ops) return -1;
+            auto c = m_ops->acquireDb();
+            if (!c.db.isOpen()) return -1;
+            QSqlQuery query(c.db);
+            if (!query.exec(COUNT_SQL) || !query.next()) return -1;
+            return query.value(0).toLongLong();
+          },
+          [this](const std::function<bool(const QString&)>& sink) {
+            // 在独立的池连接上流式读取，不持表锁：WAL 快照之后提交的
+            // 写入由 MembershipIndex 在换代前补入
+            if (!m_ops) return false;
+            auto c = m_ops->acquireDb();
+            if (!c.db.isOpen()) return false;
+            QSqlQuery query(c.db);
+            query.setForwardOnly(true);
+            if (!query.exec(SELECT_SERIALS_SQL)) return false;
+            while (query.next()) {
+              if (!sink(query.value(0).toString())) return false;
+            }
+            return !query.lastError().isValid();
+          }) {
   m_ops = new CameraInfoTableOperations(db, pool);  // QPointer 自动追踪生命周期
   m_baseOps = m_ops;
   m_ops->logOperation("构造函数", "相机信息表业务逻辑对象已创建");
 }
 
-CameraInfoTable::~CameraInfoTable() { m_baseOps = nullptr; }
+CameraInfoTable::~CameraInfoTable() {
+  m_serialIndex.stop();  // 后台重建会访问 m_ops，先停下
+  m_baseOps = nullptr;
+}
 
 DbResult<int> CameraInfoTable::insert(const CameraInfo& camera) {
+  DB_TRACE_SPAN("camera.insert");
   if (!m_ops) {
     return DbResult<int>::Error("相机信息表未初始化或已释放");
   }
@@ -170,7 +301,7 @@ DbResult<int> CameraInfoTable::insert(const CameraInfo& camera) {
   auto validation = validateCameraInfo(camera, false);
   if (!validation.success) {
     qCritical() << "数据验证失败:" << validation.errorMessage;
-    return DbResult<int>::Error(validation.errorMessage);
+    return DbResult<int>::Error(validation.errorMessage, DbErrorCode::INVALID);
   }
   qInfo() << "数据验证通过";
 
@@ -178,56 +309,90 @@ DbResult<int> CameraInfoTable::insert(const CameraInfo& camera) {
   if (serialNumberExists(camera.serialNumber)) {
     qCritical() << "序列号冲突:" << camera.serialNumber;
     return DbResult<int>::Error(
-        QString("序列号已存在: %1").arg(camera.serialNumber));
+        QString("序列号已存在: %1").arg(camera.serialNumber),
+        DbErrorCode::CONSTRAINT);
   }
   qInfo() << "序列号检查通过";
 
   // ✅ 统一使用连接池
   auto c = m_ops->acquireDb();
   if (!c.db.isOpen()) {
-    return DbResult<int>::Error("数据库未打开");
+    return DbResult<int>::Error("数据库未打开", DbErrorCode::NOT_OPEN);
   }
   qInfo() << "数据库连接正常";
 
-  QMutexLocker locker(&m_ops->m_mutex);
-  QSqlQuery query(c.db);  // ✅ 使用池连接而不是主连接
-  query.prepare(INSERT_SQL);
-  qInfo() << "SQL语句:" << INSERT_SQL;
-
-  QDateTime now = QDateTime::currentDateTime();
-
-  query.addBindValue(camera.name);
-  query.addBindValue(camera.version);
-  query.addBindValue(camera.connectionType);
-  query.addBindValue(camera.serialNumber);
-  query.addBindValue(camera.manufacturer);
-  query.addBindValue(now);
-  query.addBindValue(now);
-
-  qInfo() << "绑定参数完成，开始执行SQL";
+  TraceSpan lockSpan("table.lock");
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+  lockSpan.finish();
+  const QDateTime now = QDateTime::currentDateTime();
+  int newId = 0;
+
+  NativeStatement stmt(c.statements(), INSERT_SQL);
+  if (stmt.isValid()) {
+    stmt.bind(1, camera.name);
+    stmt.bind(2, camera.version);
+    stmt.bind(3, camera.connectionType);
+    stmt.bind(4, camera.serialNumber);
+    stmt.bind(5, camera.manufacturer);
+    stmt.bind(6, now);
+    stmt.bind(7, now);
+
+    TraceSpan execSpan("sql.exec");
+    const bool executed = stmt.exec();
+    execSpan.finish();
+    if (!executed) {
+      QString error = QString("插入相机信息失败: %1").arg(stmt.lastError());
+      qCritical() << "SQL执行失败:" << error;
+      m_ops->logOperation("插入失败", error);
+      emit m_ops->databaseError(error);
+      return DbResult<int>::Error(error, dbErrorCode(stmt.lastErrorCode()));
+    }
+    newId = static_cast<int>(stmt.lastInsertId());
+  } else {
+    QSqlQuery query(c.db);  // ✅ 使用池连接而不是主连接
+    query.prepare(INSERT_SQL);
+    qInfo() << "SQL语句:" << INSERT_SQL;
+
+    query.addBindValue(camera.name);
+    query.addBindValue(camera.version);
+    query.addBindValue(camera.connectionType);
+    query.addBindValue(camera.serialNumber);
+    query.addBindValue(camera.manufacturer);
+    query.addBindValue(now);
+    query.addBindValue(now);
+
+    qInfo() << "绑定参数完成，开始执行SQL";
+
+    TraceSpan execSpan("sql.exec");
+    const bool executed = SqlExec::run(query);
+    execSpan.finish();
+    if (!executed) {
+      QString error =
+          QString("插入相机信息失败: %1").arg(query.lastError().text());
+      qCritical() << "SQL执行失败:" << error;
+      qCritical() << "最后执行的SQL:" << query.lastQuery();
+      qCritical() << "绑定的值:" << query.boundValues();
+      m_ops->logOperation("插入失败", error);
+      emit m_ops->databaseError(error);
+      return DbResult<int>::Error(error, dbErrorCode(query.lastError()));
+    }
 
-  if (!query.exec()) {
-    QString error =
-        QString("插入相机信息失败: %1").arg(query.lastError().text());
-    qCritical() << "SQL执行失败:" << error;
-    qCritical() << "最后执行的SQL:" << query.lastQuery();
-    qCritical() << "绑定的值:" << query.boundValues();
-    m_ops->logOperation("插入失败", error);
-    emit m_ops->databaseError(error);
-    return DbResult<int>::Error(error);
+    newId = query.lastInsertId().toInt();
   }
-
-  int newId = query.lastInsertId().toInt();
   qInfo() << "SQL执行成功，新ID:" << newId;
 
   if (newId <= 0) {
-    qCritical() << "获取新ID失败，lastInsertId()返回:" << query.lastInsertId();
+    qCritical() << "获取新ID失败:" << newId;
     return DbResult<int>::Error("获取新记录ID失败");
   }
 
   m_ops->logOperation(
       "插入成功",
       QString("新相机ID: %1, 序列号: %2").arg(newId).arg(camera.serialNumber));
+  // 外层线程事务提交后才加入索引：提交前开始的重建快照看不到这一行，
+  // 提前加入会在重建替换过滤器时丢失
+  const QString serial = camera.serialNumber;
+  m_ops->afterCommit([this, serial] { m_serialIndex.add(serial); });
   emit m_ops->recordInserted(newId);
 
   qInfo() << "=== 插入相机完成 ===";
@@ -235,33 +400,43 @@ DbResult<int> CameraInfoTable::insert(const CameraInfo& camera) {
 }
 
 DbResult<bool> CameraInfoTable::update(const CameraInfo& camera) {
+  DB_TRACE_SPAN("camera.update");
   if (!m_ops) {
     return DbResult<bool>::Error("相机信息表未初始化或已释放");
   }
   if (camera.id <= 0) {
-    return DbResult<bool>::Error("无效的相机ID");
+    return DbResult<bool>::Error("无效的相机ID", DbErrorCode::INVALID);
   }
 
   // 验证数据
   auto validation = validateCameraInfo(camera, true);
   if (!validation.success) {
-    return DbResult<bool>::Error(validation.errorMessage);
-  }
-
-  // 检查序列号是否被其他记录使用
-  if (serialNumberExists(camera.serialNumber, camera.id)) {
-    return DbResult<bool>::Error(
-        QString("序列号已被其他设备使用: %1").arg(camera.serialNumber));
+    return DbResult<bool>::Error(validation.errorMessage, DbErrorCode::INVALID);
   }
 
   // ✅ 统一使用连接池
   auto c = m_ops->acquireDb();
   if (!c.db.isOpen()) {
-    return DbResult<bool>::Error("数据库未打开");
+    return DbResult<bool>::Error("数据库未打开", DbErrorCode::NOT_OPEN);
   }
   qInfo() << "数据库连接正常";
 
-  QMutexLocker locker(&m_ops->m_mutex);
+  TraceSpan lockSpan("table.lock");
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+  lockSpan.finish();
+
+  // 一次按序列号取ID同时回答两件事：属于其他记录即被占用；属于本记录
+  // 说明序列号未变，不动索引（避免键数虚增触发无谓的重建）。索引判定
+  // 不存在时两者都不成立，不访问数据库
+  int owner = 0;
+  if (m_serialIndex.mightContain(camera.serialNumber)) {
+    owner = serialOwner(c, camera.serialNumber);
+  }
+  if (owner > 0 && owner != camera.id) {
+    return DbResult<bool>::Error(
+        QString("序列号已被其他设备使用: %1").arg(camera.serialNumber));
+  }
+
   QSqlQuery query(c.db);  // ✅ 使用池连接而不是主连接
   query.prepare(UPDATE_SQL);
   qInfo() << "SQL语句:" << UPDATE_SQL;
@@ -276,98 +451,140 @@ DbResult<bool> CameraInfoTable::update(const CameraInfo& camera) {
   query.addBindValue(now);
   query.addBindValue(camera.id);
 
-  if (!query.exec()) {
+  TraceSpan execSpan("sql.exec");
+  const bool executed = SqlExec::run(query);
+  execSpan.finish();
+  if (!executed) {
     QString error =
         QString("更新相机信息失败: %1").arg(query.lastError().text());
     m_ops->logOperation("更新失败", error);
     emit m_ops->databaseError(error);
-    return DbResult<bool>::Error(error);
+    return DbResult<bool>::Error(error, dbErrorCode(query.lastError()));
   }
 
   if (query.numRowsAffected() == 0) {
-    return DbResult<bool>::Error("未找到指定的相机记录");
+    return DbResult<bool>::Error(
+        "未找到指定的相机记录", DbErrorCode::NOT_FOUND);
   }
 
   m_ops->logOperation("更新成功", QString("相机ID: %1, 序列号: %2")
                                       .arg(camera.id)
                                       .arg(camera.serialNumber));
+  if (owner != camera.id) {
+    // 旧序列号的位留到下次重建，只会多一次误判；新序列号提交后加入。
+    // 查询失败（owner 为 -1）时按已变处理，至多多计一个键
+    const QString serial = camera.serialNumber;
+    m_ops->afterCommit([this, serial] {
+      m_serialIndex.remove();
+      m_serialIndex.add(serial);
+    });
+  }
   emit m_ops->recordUpdated(camera.id);
 
   return DbResult<bool>::Success(true);
 }
 
 DbResult<bool> CameraInfoTable::deleteById(int id) {
+  DB_TRACE_SPAN("camera.delete");
   if (!m_ops) {
     return DbResult<bool>::Error("相机信息表未初始化或已释放");
   }
   if (id <= 0) {
-    return DbResult<bool>::Error("无效的相机ID");
+    return DbResult<bool>::Error("无效的相机ID", DbErrorCode::INVALID);
   }
 
   // ✅ 统一使用连接池
   auto c = m_ops->acquireDb();
   if (!c.db.isOpen()) {
-    return DbResult<bool>::Error("数据库未打开");
+    return DbResult<bool>::Error("数据库未打开", DbErrorCode::NOT_OPEN);
   }
   qInfo() << "数据库连接正常";
 
-  QMutexLocker locker(&m_ops->m_mutex);
+  TraceSpan lockSpan("table.lock");
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+  lockSpan.finish();
   QSqlQuery query(c.db);  // ✅ 使用池连接而不是主连接
   query.prepare(DELETE_SQL);
   qInfo() << "SQL语句:" << DELETE_SQL;
   query.addBindValue(id);
 
-  if (!query.exec()) {
+  TraceSpan execSpan("sql.exec");
+  const bool executed = SqlExec::run(query);
+  execSpan.finish();
+  if (!executed) {
     QString error = QString("删除相机失败: %1").arg(query.lastError().text());
     m_ops->logOperation("删除失败", error);
     emit m_ops->databaseError(error);
-    return DbResult<bool>::Error(error);
+    return DbResult<bool>::Error(error, dbErrorCode(query.lastError()));
   }
 
   if (query.numRowsAffected() == 0) {
-    return DbResult<bool>::Error("未找到指定的相机记录");
+    return DbResult<bool>::Error(
+        "未找到指定的相机记录", DbErrorCode::NOT_FOUND);
   }
 
   m_ops->logOperation("删除成功", QString("相机ID: %1").arg(id));
+  m_ops->afterCommit([this] { m_serialIndex.remove(); });
   emit m_ops->recordDeleted(id);
 
   return DbResult<bool>::Success(true);
 }
 
 DbResult<CameraInfo> CameraInfoTable::selectById(int id) const {
+  DB_TRACE_SPAN("camera.selectById");
   if (!m_ops) {
     return DbResult<CameraInfo>::Error("相机信息表未初始化或已释放");
   }
 
   if (id <= 0) {
-    return DbResult<CameraInfo>::Error("无效的相机ID");
+    return DbResult<CameraInfo>::Error("无效的相机ID", DbErrorCode::INVALID);
   }
 
   // ✅ 统一使用连接池
   auto c = m_ops->acquireDb();
   if (!c.db.isOpen()) {
-    QString error = QString("数据库未打开");
-    return DbResult<CameraInfo>::Error(error);
+    return DbResult<CameraInfo>::Error("数据库未打开", DbErrorCode::NOT_OPEN);
+  }
+
+  TraceSpan lockSpan("table.lock");
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+  lockSpan.finish();
+
+  NativeStatement stmt(c.statements(), SELECT_BY_ID_SQL);
+  if (stmt.isValid()) {
+    stmt.bind(1, id);
+    TraceSpan execSpan("sql.exec");
+    if (stmt.next()) {
+      return DbResult<CameraInfo>::Success(buildCameraInfo(stmt));
+    }
+    if (stmt.failed()) {
+      return DbResult<CameraInfo>::Error(
+          QString("查询相机失败: %1").arg(stmt.lastError()),
+          dbErrorCode(stmt.lastErrorCode()));
+    }
+    return DbResult<CameraInfo>::Error(
+        "未找到指定的相机记录", DbErrorCode::NOT_FOUND);
   }
-  qInfo() << "数据库连接正常";
 
-  QMutexLocker locker(&m_ops->m_mutex);
   QSqlQuery query(c.db);  // ✅ 使用池连接而不是主连接
   query.prepare(SELECT_BY_ID_SQL);
-  qInfo() << "SQL语句:" << SELECT_BY_ID_SQL;
   query.addBindValue(id);
 
-  if (!query.exec()) {
+  TraceSpan execSpan("sql.exec");
+  const bool executed = SqlExec::run(query);
+  execSpan.finish();
+  if (!executed) {
     QString error = QString("查询相机失败: %1").arg(query.lastError().text());
-    return DbResult<CameraInfo>::Error(error);
+    return DbResult<CameraInfo>::Error(error, dbErrorCode(query.lastError()));
   }
 
   if (query.next()) {
     CameraInfo camera = buildCameraInfo(query);
-    return DbResult<CameraInfo>::Success(camera);
+    return DbResult<CameraInfo>::Success(std::move(camera));
   }
 
-  return DbResult<CameraInfo>::Error("未找到指定的相机记录");
+  return DbResult<CameraInfo>::Error(
+      "未找到指定的相机记录", DbErrorCode::NOT_FOUND);
 }
 
 DbResult<QList<CameraInfo>> CameraInfoTable::selectAll() const {
@@ -378,14 +595,15 @@ DbResult<QList<CameraInfo>> CameraInfoTable::selectAll() const {
   // ✅ 统一使用连接池
   auto c = m_ops->acquireDb();
   if (!c.db.isOpen()) {
-    return DbResult<QList<CameraInfo>>::Error("数据库未打开");
+    return DbResult<QList<CameraInfo>>::Error(
+        "数据库未打开", DbErrorCode::NOT_OPEN);
   }
-  qInfo() << "数据库连接正常";
 
-  QMutexLocker locker(&m_ops->m_mutex);
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
   QSqlQuery query(c.db);  // ✅ 使用池连接而不是主连接
+  query.setForwardOnly(true);
 
-  if (!query.exec(SELECT_ALL_SQL)) {
+  if (!SqlExec::run(query, SELECT_ALL_SQL)) {
     QString error =
         QString("查询所有相机失败: %1").arg(query.lastError().text());
     return DbResult<QList<CameraInfo>>::Error(error);
@@ -396,7 +614,43 @@ DbResult<QList<CameraInfo>> CameraInfoTable::selectAll() const {
     cameras.append(buildCameraInfo(query));
   }
 
-  return DbResult<QList<CameraInfo>>::Success(cameras);
+  return DbResult<QList<CameraInfo>>::Success(std::move(cameras));
+}
+
+DbResult<ColumnarResult> CameraInfoTable::selectAllColumnar() const {
+  if (!m_ops) {
+    return DbResult<ColumnarResult>::Error("相机信息表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<ColumnarResult>::Error(
+        "数据库未打开", DbErrorCode::NOT_OPEN);
+  }
+
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+  QSqlQuery query(c.db);
+  query.setForwardOnly(true);
+
+  if (!SqlExec::run(query, SELECT_ALL_SQL)) {
+    QString error =
+        QString("查询所有相机失败: %1").arg(query.lastError().text());
+    return DbResult<ColumnarResult>::Error(error);
+  }
+
+  ColumnarResult result(COLUMNAR_SCHEMA);
+  result.appendAll(query);
+  result.squeeze();
+  return DbResult<ColumnarResult>::Success(std::move(result));
+}
+
+DbResult<QHash<int, CameraInfo>> CameraInfoTable::selectByIds(
+    const QList<int>& ids) const {
+  if (!m_ops) {
+    return DbResult<QHash<int, CameraInfo>>::Error(
+        "相机信息表未初始化或已释放");
+  }
+  return selectRowsByIds(ids);
 }
 
 DbResult<PageResult<CameraInfo>> CameraInfoTable::selectByPage(
@@ -405,38 +659,39 @@ DbResult<PageResult<CameraInfo>> CameraInfoTable::selectByPage(
     return DbResult<PageResult<CameraInfo>>::Error(
         "相机信息表未初始化或已释放");
   }
-  auto c = m_ops->acquireDb();
-  if (!c.db.isOpen())
-    return DbResult<PageResult<CameraInfo>>::Error("数据库未打开");
 
   int total = m_ops->getTotalCount();
-  QMutexLocker locker(&m_ops->m_mutex);
-
-  QString orderBy =
-      params.orderBy.isEmpty() ? "name" : sanitizeOrderBy(params.orderBy);
-  QString sql = QString(
-                    "SELECT "
-                    "id,name,version,connection_type,serial_number,"
-                    "manufacturer,created_at,updated_at "
-                    "FROM camera_info ORDER BY %1 %2 LIMIT %3 OFFSET %4")
-                    .arg(orderBy)
-                    .arg(params.ascending ? "ASC" : "DESC")
-                    .arg(params.pageSize)
-                    .arg(params.offset());
 
-  QSqlQuery query(c.db);
-  if (!query.exec(sql)) {
+  // 页大小与偏移为绑定参数，同一排序的各页复用同一条预编译语句
+  auto rows = select(pageQuery(params));
+  if (!rows.success) {
     return DbResult<PageResult<CameraInfo>>::Error(
-        QString("分页查询相机失败: %1").arg(query.lastError().text()));
+        QString("分页查询相机失败: %1").arg(rows.errorMessage), rows.errorCode);
   }
-
-  QList<CameraInfo> list;
-  while (query.next()) list.append(buildCameraInfo(query));
   return DbResult<PageResult<CameraInfo>>::Success(
-      PageResult<CameraInfo>(list, total, params));
+      PageResult<CameraInfo>(std::move(rows.data), total, params));
+}
+
+TableQuery CameraInfoTable::pageQuery(const PageParams& params) {
+  const QString orderBy =
+      params.orderBy.isEmpty() ? "name" : sanitizeOrderBy(params.orderBy);
+  return TableQuery("camera_info", COLUMNAR_SCHEMA)
+      .orderBy(orderBy, params.ascending)
+      .limit(params.pageSize, params.offset());
+}
+
+DbResult<QList<CameraInfo>> CameraInfoTable::select(
+    const TableQuery& query) const {
+  DB_TRACE_SPAN("camera.select");
+  if (!m_ops) {
+    return DbResult<QList<CameraInfo>>::Error("相机信息表未初始化或已释放");
+  }
+  return selectRows(query,
+                    [this](const auto& row) { return buildCameraInfo(row); });
 }
 
 DbResult<int> CameraInfoTable::batchInsert(const QList<CameraInfo>& cameras) {
+  DB_TRACE_SPAN("camera.batchInsert");
   if (!m_ops) {
     return DbResult<int>::Error("相机信息表未初始化或已释放");
   }
@@ -477,21 +732,26 @@ DbResult<int> CameraInfoTable::batchInsert(const QList<CameraInfo>& cameras) {
   // 2) 获取池连接
   auto c = m_ops->acquireDb();
   if (!c.db.isOpen()) {
-    return DbResult<int>::Error("数据库未打开");
+    return DbResult<int>::Error("数据库未打开", DbErrorCode::NOT_OPEN);
   }
   qInfo() << "数据库连接正常";
 
   // 3) 事务 + 批量插入（持锁）。与库内数据的冲突依赖 UNIQUE(serial_number)
-  QMutexLocker locker(&m_ops->m_mutex);
+  TraceSpan lockSpan("table.lock");
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+  lockSpan.finish();
   QSqlQuery query(c.db);
   query.prepare(INSERT_SQL);
   qInfo() << "SQL语句:" << INSERT_SQL;
 
-  if (!c.db.transaction()) {
+  if (!SqlExec::begin(c.db)) {
     return DbResult<int>::Error("无法开启事务");
   }
+  // 本事务内的插入审计在提交后才入队；提前返回即丢弃
+  AuditTrail::DeferredScope auditScope(m_ops->m_database);
 
   int successCount = 0;
+  QStringList inserted;  // 提交后加入序列号索引
   QDateTime now = QDateTime::currentDateTime();
 
   for (const CameraInfo& cam : deduped) {
@@ -504,8 +764,9 @@ DbResult<int> CameraInfoTable::batchInsert(const QList<CameraInfo>& cameras) {
     query.bindValue(5, now);
     query.bindValue(6, now);
 
-    if (query.exec()) {
+    if (SqlExec::run(query)) {
       successCount++;
+      inserted.append(cam.serialNumber);
       const int newId = query.lastInsertId().toInt();
       emit m_ops->recordInserted(newId);
     } else {
@@ -516,10 +777,15 @@ DbResult<int> CameraInfoTable::batchInsert(const QList<CameraInfo>& cameras) {
   }
 
   if (successCount > 0) {
-    if (!c.db.commit()) {
-      c.db.rollback();
+    TraceSpan commitSpan("sql.commit");
+    const bool committed = SqlExec::commit(c.db);
+    commitSpan.finish();
+    if (!committed) {
+      SqlExec::rollback(c.db);
       return DbResult<int>::Error("提交事务失败");
     }
+    auditScope.commit();
+    for (const QString& serial : inserted) m_serialIndex.add(serial);
     m_ops->logOperation("批量插入成功",
                         QString("成功插入 %1 个相机").arg(successCount));
     if (!errors.isEmpty()) {
@@ -527,7 +793,7 @@ DbResult<int> CameraInfoTable::batchInsert(const QList<CameraInfo>& cameras) {
     }
     return DbResult<int>::Success(successCount);
   } else {
-    c.db.rollback();
+    SqlExec::rollback(c.db);
     return DbResult<int>::Error(
         QString("批量插入失败: %1").arg(errors.join("; ")));
   }
@@ -547,14 +813,31 @@ DbResult<CameraInfo> CameraInfoTable::selectBySerialNumber(
     return DbResult<CameraInfo>::Error("相机信息表未初始化或已释放");
   }
   auto c = m_ops->acquireDb();
-  if (!c.db.isOpen()) return DbResult<CameraInfo>::Error("数据库未打开");
+  if (!c.db.isOpen()) {
+    return DbResult<CameraInfo>::Error("数据库未打开", DbErrorCode::NOT_OPEN);
+  }
+
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+
+  NativeStatement stmt(c.statements(), SELECT_BY_SERIAL_SQL);
+  if (stmt.isValid()) {
+    stmt.bind(1, serialNumber);
+    if (stmt.next()) {
+      return DbResult<CameraInfo>::Success(buildCameraInfo(stmt));
+    }
+    if (stmt.failed()) {
+      return DbResult<CameraInfo>::Error(
+          QString("根据序列号查询失败: %1").arg(stmt.lastError()));
+    }
+    return DbResult<CameraInfo>::Error(
+        "未找到指定序列号的相机", DbErrorCode::NOT_FOUND);
+  }
 
-  QMutexLocker locker(&m_ops->m_mutex);
   QSqlQuery query(c.db);
   query.prepare(SELECT_BY_SERIAL_SQL);
   query.addBindValue(serialNumber);
 
-  if (!query.exec()) {
+  if (!SqlExec::run(query)) {
     QString error =
         QString("根据序列号查询失败: %1").arg(query.lastError().text());
     return DbResult<CameraInfo>::Error(error);
@@ -562,32 +845,74 @@ DbResult<CameraInfo> CameraInfoTable::selectBySerialNumber(
 
   if (query.next()) {
     CameraInfo camera = buildCameraInfo(query);
-    return DbResult<CameraInfo>::Success(camera);
+    return DbResult<CameraInfo>::Success(std::move(camera));
   }
 
-  return DbResult<CameraInfo>::Error("未找到指定序列号的相机");
+  return DbResult<CameraInfo>::Error(
+      "未找到指定序列号的相机", DbErrorCode::NOT_FOUND);
 }
 
 bool CameraInfoTable::serialNumberExists(const QString& serialNumber,
                                          int excludeId) const {
+  DB_TRACE_SPAN("camera.serialExists");
   if (!m_ops) return false;
+  // 索引判定不存在即一定不存在（绕过本类写入的行由 UNIQUE 约束兜底）；
+  // 带 excludeId 时命中的可能就是被排除的那行，不计为误判
+  if (!m_serialIndex.mightContain(serialNumber)) return false;
   auto c = m_ops->acquireDb();
   if (!c.db.isOpen()) return false;
 
-  QMutexLocker locker(&m_ops->m_mutex);
+  TraceSpan lockSpan("table.lock");
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+  lockSpan.finish();
+
+  NativeStatement stmt(c.statements(), CHECK_SERIAL_EXISTS_SQL);
+  if (stmt.isValid()) {
+    stmt.bind(1, serialNumber);
+    stmt.bind(2, excludeId);
+    TraceSpan execSpan("sql.exec");
+    const bool exists = stmt.next() && stmt.columnInt(0) > 0;
+    if (!exists && !stmt.failed() && excludeId < 0) {
+      m_serialIndex.recordFalsePositive();
+    }
+    return exists;
+  }
 
   QSqlQuery query(c.db);
   query.prepare(CHECK_SERIAL_EXISTS_SQL);
   query.addBindValue(serialNumber);
   query.addBindValue(excludeId);
 
-  if (query.exec() && query.next()) {
-    return query.value(0).toInt() > 0;
+  TraceSpan execSpan("sql.exec");
+  if (SqlExec::run(query) && query.next()) {
+    const bool exists = query.value(0).toInt() > 0;
+    if (!exists && excludeId < 0) m_serialIndex.recordFalsePositive();
+    return exists;
   }
 
   return false;
 }
 
+int CameraInfoTable::serialOwner(const BaseTableOperations::ScopedDb& c,
+                                 const QString& serialNumber) const {
+  NativeStatement stmt(c.statements(), SELECT_ID_BY_SERIAL_SQL);
+  if (stmt.isValid()) {
+    stmt.bind(1, serialNumber);
+    TraceSpan execSpan("sql.exec");
+    if (stmt.next()) return stmt.columnInt(0);
+    return stmt.failed() ? -1 : 0;
+  }
+
+  QSqlQuery query(c.db);
+  query.setForwardOnly(true);
+  query.prepare(SELECT_ID_BY_SERIAL_SQL);
+  query.addBindValue(serialNumber);
+
+  TraceSpan execSpan("sql.exec");
+  if (!SqlExec::run(query)) return -1;
+  return query.next() ? query.value(0).toInt() : 0;
+}
+
 DbResult<QList<CameraInfo>> CameraInfoTable::search(
     const QString& keyword) const {
   if (!m_ops) {
@@ -597,10 +922,14 @@ DbResult<QList<CameraInfo>> CameraInfoTable::search(
   if (keyword.isEmpty()) return selectAll();
 
   auto c = m_ops->acquireDb();
-  if (!c.db.isOpen()) return DbResult<QList<CameraInfo>>::Error("数据库未打开");
+  if (!c.db.isOpen()) {
+    return DbResult<QList<CameraInfo>>::Error(
+        "数据库未打开", DbErrorCode::NOT_OPEN);
+  }
 
-  QMutexLocker locker(&m_ops->m_mutex);
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
   QSqlQuery query(c.db);
+  query.setForwardOnly(true);
   query.prepare(SEARCH_SQL);
 
   const QString pattern = "%" + keyword + "%";  // ✅ 修正
@@ -608,14 +937,14 @@ DbResult<QList<CameraInfo>> CameraInfoTable::search(
   query.addBindValue(pattern);
   query.addBindValue(pattern);
 
-  if (!query.exec()) {
+  if (!SqlExec::run(query)) {
     return DbResult<QList<CameraInfo>>::Error(
         QString("搜索相机失败: %1").arg(query.lastError().text()));
   }
 
   QList<CameraInfo> out;
   while (query.next()) out.append(buildCameraInfo(query));
-  return DbResult<QList<CameraInfo>>::Success(out);
+  return DbResult<QList<CameraInfo>>::Success(std::move(out));
 }
 
 DbResult<QList<CameraInfo>> CameraInfoTable::selectByManufacturer(
@@ -625,20 +954,19 @@ DbResult<QList<CameraInfo>> CameraInfoTable::selectByManufacturer(
   }
 
   auto c = m_ops->acquireDb();
-  if (!c.db.isOpen()) return DbResult<QList<CameraInfo>>::Error("数据库未打开");
-
-  QMutexLocker locker(&m_ops->m_mutex);
+  if (!c.db.isOpen()) {
+    return DbResult<QList<CameraInfo>>::Error(
+        "数据库未打开", DbErrorCode::NOT_OPEN);
+  }
 
-  QString sql = R"(
-        SELECT id, name, version, connection_type, serial_number, manufacturer, created_at, updated_at
-        FROM camera_info WHERE manufacturer = ? ORDER BY name
-    )";
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
 
   QSqlQuery query(c.db);
-  query.prepare(sql);
+  query.setForwardOnly(true);
+  query.prepare(SELECT_BY_MANUFACTURER_SQL);
   query.addBindValue(manufacturer);
 
-  if (!query.exec()) {
+  if (!SqlExec::run(query)) {
     QString error =
         QString("根据制造商查询失败: %1").arg(query.lastError().text());
     return DbResult<QList<CameraInfo>>::Error(error);
@@ -649,7 +977,7 @@ DbResult<QList<CameraInfo>> CameraInfoTable::selectByManufacturer(
     cameras.append(buildCameraInfo(query));
   }
 
-  return DbResult<QList<CameraInfo>>::Success(cameras);
+  return DbResult<QList<CameraInfo>>::Success(std::move(cameras));
 }
 
 QStringList CameraInfoTable::getAllManufacturers() const {
@@ -657,14 +985,11 @@ QStringList CameraInfoTable::getAllManufacturers() const {
   auto c = m_ops->acquireDb();
   if (!c.db.isOpen()) return {};
 
-  QMutexLocker locker(&m_ops->m_mutex);
-
-  QString sql =
-      "SELECT DISTINCT manufacturer FROM camera_info WHERE manufacturer IS NOT "
-      "NULL ORDER BY manufacturer";
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
 
   QSqlQuery query(c.db);
-  if (!query.exec(sql)) {
+  query.setForwardOnly(true);
+  if (!SqlExec::run(query, SELECT_MANUFACTURERS_SQL)) {
     return QStringList();
   }
 
@@ -684,20 +1009,19 @@ DbResult<QList<CameraInfo>> CameraInfoTable::selectByConnectionType(
   if (!m_ops)
     return DbResult<QList<CameraInfo>>::Error("相机信息表未初始化或已释放");
   auto c = m_ops->acquireDb();
-  if (!c.db.isOpen()) return DbResult<QList<CameraInfo>>::Error("数据库未打开");
-
-  QMutexLocker locker(&m_ops->m_mutex);
+  if (!c.db.isOpen()) {
+    return DbResult<QList<CameraInfo>>::Error(
+        "数据库未打开", DbErrorCode::NOT_OPEN);
+  }
 
-  QString sql = R"(
-        SELECT id, name, version, connection_type, serial_number, manufacturer, created_at, updated_at
-        FROM camera_info WHERE connection_type = ? ORDER BY name
-    )";
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
 
   QSqlQuery query(c.db);
-  query.prepare(sql);
+  query.setForwardOnly(true);
+  query.prepare(SELECT_BY_CONNECTION_TYPE_SQL);
   query.addBindValue(connectionType);
 
-  if (!query.exec()) {
+  if (!SqlExec::run(query)) {
     QString error =
         QString("根据连接类型查询失败: %1").arg(query.lastError().text());
     return DbResult<QList<CameraInfo>>::Error(error);
@@ -708,7 +1032,48 @@ DbResult<QList<CameraInfo>> CameraInfoTable::selectByConnectionType(
     cameras.append(buildCameraInfo(query));
   }
 
-  return DbResult<QList<CameraInfo>>::Success(cameras);
+  return DbResult<QList<CameraInfo>>::Success(std::move(cameras));
+}
+
+DbResult<QList<CameraInfo>> CameraInfoTable::selectInvalidSerials() const {
+  if (!SqlFunctions::available()) {
+    // 没有原生函数时取回全部行在本地过滤
+    auto all = selectAll();
+    if (!all.success) return all;
+    QList<CameraInfo> invalid;
+    for (const CameraInfo& camera : all.data) {
+      if (!DeviceRules::isValidSerial(camera.serialNumber)) {
+        invalid.append(camera);
+      }
+    }
+    std::sort(invalid.begin(), invalid.end(),
+              [](const CameraInfo& a, const CameraInfo& b) {
+                return a.id < b.id;
+              });
+    return DbResult<QList<CameraInfo>>::Success(std::move(invalid));
+  }
+
+  if (!m_ops) {
+    return DbResult<QList<CameraInfo>>::Error("相机信息表未初始化或已释放");
+  }
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<QList<CameraInfo>>::Error(
+        "数据库未打开", DbErrorCode::NOT_OPEN);
+  }
+
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+  QSqlQuery query(c.db);
+  query.setForwardOnly(true);
+  if (!SqlExec::run(query, SELECT_INVALID_SERIAL_SQL)) {
+    QString error =
+        QString("查询无效序列号失败: %1").arg(query.lastError().text());
+    return DbResult<QList<CameraInfo>>::Error(error);
+  }
+
+  QList<CameraInfo> cameras;
+  while (query.next()) cameras.append(buildCameraInfo(query));
+  return DbResult<QList<CameraInfo>>::Success(std::move(cameras));
 }
 
 CameraInfo CameraInfoTable::buildCameraInfo(const QSqlQuery& query) const {
@@ -716,16 +1081,33 @@ CameraInfo CameraInfoTable::buildCameraInfo(const QSqlQuery& query) const {
 
   camera.id = query.value(0).toInt();
   camera.name = query.value(1).toString();
-  camera.version = query.value(2).toString();
-  camera.connectionType = query.value(3).toString();
+  camera.version = m_interner.intern(query.value(2));
+  camera.connectionType = m_interner.intern(query.value(3));
   camera.serialNumber = query.value(4).toString();
-  camera.manufacturer = query.value(5).toString();
+  camera.manufacturer = m_interner.intern(query.value(5));
   camera.createdAt = query.value(6).toDateTime();
   camera.updatedAt = query.value(7).toDateTime();
 
   return camera;
 }
 
+CameraInfo CameraInfoTable::buildCameraInfo(
+    const NativeStatement& stmt) const {
+  CameraInfo camera;
+
+  camera.id = stmt.columnInt(0);
+  camera.name = stmt.columnText(1);
+  // 低基数列直接以 SQLite 缓冲区中的 UTF-16 查池，命中时不构造临时串
+  camera.version = m_interner.intern(stmt.columnTextView(2));
+  camera.connectionType = m_interner.intern(stmt.columnTextView(3));
+  camera.serialNumber = stmt.columnText(4);
+  camera.manufacturer = m_interner.intern(stmt.columnTextView(5));
+  camera.createdAt = stmt.columnDateTime(6);
+  camera.updatedAt = stmt.columnDateTime(7);
+
+  return camera;
+}
+
 // 在 DeviceDatabaseManager.cpp 的 validateCameraInfo 方法中修改序列号验证
 
 DbResult<bool> CameraInfoTable::validateCameraInfo(const CameraInfo& camera,
@@ -744,7 +1126,7 @@ DbResult<bool> CameraInfoTable::validateCameraInfo(const CameraInfo& camera,
     return DbResult<bool>::Error("相机名称长度不能超过255个字符");
   }
 
-  if (camera.serialNumber.length() > 100) {
+  if (camera.serialNumber.length() > DeviceRules::kMaxSerialLength) {
     return DbResult<bool>::Error("序列号长度不能超过100个字符");
   }
 
@@ -761,11 +1143,9 @@ DbResult<bool> CameraInfoTable::validateCameraInfo(const CameraInfo& camera,
   }
 
   // 序列号格式验证 - 更宽松的验证，只检查是否包含可打印字符
-  // 可以根据实际需求调整这个验证规则
-  for (const QChar& ch : camera.serialNumber) {
-    if (!ch.isPrint() || ch.isSpace()) {
-      return DbResult<bool>::Error("序列号不能包含空白字符或不可打印字符");
-    }
+  // 规则与 SQL 函数 serial_valid 共用（DeviceRules）
+  if (!DeviceRules::isValidSerial(camera.serialNumber)) {
+    return DbResult<bool>::Error("序列号不能包含空白字符或不可打印字符");
   }
 
   // 如果需要严格的格式验证，可以启用下面的代码：
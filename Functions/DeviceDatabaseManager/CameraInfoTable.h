@@ -5,6 +5,10 @@
 
 #include "BaseDatabaseManager.h"
 #include "DeviceDataBaseStruct.h"
+#include "MembershipIndex.h"
+#include "QueryPlanChecker.h"
+#include "StringInterner.h"
+#include "WorkloadCapture.h"
 
 // ============================================================================
 // 相机信息表操作类
@@ -20,13 +24,13 @@ class CameraInfoTableOperations : public BaseTableOperations {
   struct TxGuard {
     QSqlDatabase& db;
     bool active = false;
-    explicit TxGuard(QSqlDatabase& d) : db(d) { active = db.transaction(); }
+    explicit TxGuard(QSqlDatabase& d) : db(d) { active = SqlExec::begin(db); }
     ~TxGuard() {
-      if (active) db.rollback();
+      if (active) SqlExec::rollback(db);
     }
     bool commit() {
       if (!active) return false;
-      bool ok = db.commit();
+      bool ok = SqlExec::commit(db);
       active = false;
       return ok;
     }
@@ -54,12 +58,21 @@ class CameraInfoTable : public BaseTable<CameraInfo> {
   static const QString DELETE_SQL;
   static const QString SELECT_BY_ID_SQL;
   static const QString SELECT_ALL_SQL;
+  static const QVector<ColumnSpec> COLUMNAR_SCHEMA;
   static const QString SELECT_BY_SERIAL_SQL;
   static const QString SEARCH_SQL;
   static const QString COUNT_SQL;
   static const QString CHECK_SERIAL_EXISTS_SQL;
+  static const QString SELECT_BY_MANUFACTURER_SQL;
+  static const QString SELECT_BY_CONNECTION_TYPE_SQL;
+  static const QString SELECT_MANUFACTURERS_SQL;
+  static const QString SELECT_INVALID_SERIAL_SQL;
+  static const QString SELECT_SERIALS_SQL;
+  static const QString SELECT_ID_BY_SERIAL_SQL;
 
   QPointer<CameraInfoTableOperations> m_ops;  ///< 安全弱引用，避免悬空
+  mutable StringInterner m_interner;          ///< 低基数列驻留池
+  MembershipIndex m_serialIndex;              ///< 序列号存在性的前置过滤
  public:
   /**
    * @brief 构造函数
@@ -111,6 +124,12 @@ class CameraInfoTable : public BaseTable<CameraInfo> {
    */
   DbResult<QList<CameraInfo>> selectAll() const override;
 
+  /**
+   * @brief 以列式结果查询所有相机（按名称排序）
+   * @return 操作结果，列顺序见 COLUMNAR_SCHEMA
+   */
+  DbResult<ColumnarResult> selectAllColumnar() const override;
+
   /**
    * @brief 分页查询相机
    * @param params 分页参数
@@ -126,6 +145,26 @@ class CameraInfoTable : public BaseTable<CameraInfo> {
    */
   DbResult<int> batchInsert(const QList<CameraInfo>& cameras) override;
 
+  /**
+   * @brief 按ID批量查询相机（按批 IN 查询，见 selectRowsByIds）
+   * @param ids 相机ID列表
+   * @return 操作结果，ID到相机信息的映射
+   */
+  DbResult<QHash<int, CameraInfo>> selectByIds(
+      const QList<int>& ids) const override;
+
+  /**
+   * @brief 条件查询允许的列（同 COLUMNAR_SCHEMA）
+   */
+  QVector<ColumnSpec> queryColumns() const override { return COLUMNAR_SCHEMA; }
+
+  /**
+   * @brief 按条件查询相机
+   * @param query 由 tableQuery() 创建的条件查询（不带投影）
+   * @return 操作结果，包含相机列表
+   */
+  DbResult<QList<CameraInfo>> select(const TableQuery& query) const override;
+
   // ========================================================================
   // 扩展功能方法
   // ========================================================================
@@ -139,6 +178,7 @@ class CameraInfoTable : public BaseTable<CameraInfo> {
 
   /**
    * @brief 检查序列号是否存在
+   * 先查序列号成员索引，判定不存在时不访问数据库
    * @param serialNumber 序列号
    * @param excludeId 排除的ID（用于更新时检查）
    * @return 是否存在
@@ -175,12 +215,40 @@ class CameraInfoTable : public BaseTable<CameraInfo> {
   DbResult<QList<CameraInfo>> selectByConnectionType(
       const QString& connectionType) const;
 
+  /**
+   * @brief 查询序列号不合法的相机（如绕过校验直接写入的数据）
+   * sqlite_native 构建在库内以 serial_valid() 过滤，否则取回全部行在
+   * 本地按 DeviceRules::isValidSerial 过滤
+   * @return 操作结果，按ID排序的相机列表
+   */
+  DbResult<QList<CameraInfo>> selectInvalidSerials() const;
+
   /**
    * @brief 获取基础操作对象
    * @return 基础操作对象指针
    */
   CameraInfoTableOperations* operations() const { return m_ops.data(); }
 
+  /**
+   * @brief 获取序列号成员索引
+   * 构造时为空（未就绪时 serialNumberExists 直接查库），由数据库管理器
+   * 初始化时在后台加载
+   * @return 成员索引
+   */
+  MembershipIndex* serialIndex() { return &m_serialIndex; }
+
+  /**
+   * @brief 获取低基数列的驻留池（基准测试对比解码路径用）
+   * @return 驻留池
+   */
+  StringInterner* interner() { return &m_interner; }
+
+  /**
+   * @brief 各SQL语句的查询计划期望（供 QueryPlanChecker 回归检查）
+   * @return 期望列表，含各排序列、两个方向的分页语句
+   */
+  static QList<PlanExpectation> planExpectations();
+
  private:
   /**
    * @brief 从查询结果构建CameraInfo对象
@@ -189,6 +257,22 @@ class CameraInfoTable : public BaseTable<CameraInfo> {
    */
   CameraInfo buildCameraInfo(const QSqlQuery& query) const;
 
+  /**
+   * @brief 从原生语句的当前行构建CameraInfo对象（列顺序同上）
+   * @param stmt 已取到一行的原生语句
+   * @return CameraInfo对象
+   */
+  CameraInfo buildCameraInfo(const NativeStatement& stmt) const;
+
+  /**
+   * @brief 查询持有该序列号的记录ID（调用方持锁）
+   * @param c 当前操作的连接
+   * @param serialNumber 序列号
+   * @return 记录ID；不存在为0，查询失败为-1
+   */
+  int serialOwner(const BaseTableOperations::ScopedDb& c,
+                  const QString& serialNumber) const;
+
   /**
    * @brief 验证相机信息
    * @param camera 相机信息
@@ -198,6 +282,13 @@ class CameraInfoTable : public BaseTable<CameraInfo> {
   DbResult<bool> validateCameraInfo(const CameraInfo& camera,
                                     bool isUpdate = false) const;
 
+  /**
+   * @brief 生成分页查询
+   * @param params 分页参数（排序列经 sanitizeOrderBy 过滤）
+   * @return 条件查询（页大小与偏移为绑定参数）
+   */
+  static TableQuery pageQuery(const PageParams& params);
+
   static inline QString sanitizeOrderBy(const QString& col) {
     static const QSet<QString> k = {"id",
                                     "name",
@@ -1,6 +1,8 @@
 ﻿#ifndef DEVICEDATABASESTRUCT_H
 #define DEVICEDATABASESTRUCT_H
 
+#include "DeviceSqlFunctions.h"
+
 // ============================================================================
 // 数据实体定义
 // ============================================================================
@@ -74,6 +76,16 @@ struct CameraConfig {
    * @return 数据是否有效
    */
   bool isValid() const { return cameraId > 0 && !resolution.isEmpty(); }
+
+  /**
+   * @brief 解析分辨率（与 SQL 函数 resolution_width/height 相同规则）
+   * @param width 宽度输出
+   * @param height 高度输出
+   * @return 是否解析成功
+   */
+  bool resolutionSize(int* width, int* height) const {
+    return DeviceRules::parseResolution(resolution, width, height);
+  }
 };
 
 /**
@@ -113,8 +125,8 @@ struct CameraStatus {
    * @return 是否在线
    */
   bool isOnline(int timeoutSeconds = 30) const {
-    if (!onlineStatus) return false;
-    return lastHeartbeat.secsTo(QDateTime::currentDateTime()) <= timeoutSeconds;
+    return DeviceRules::isOnline(onlineStatus, lastHeartbeat, timeoutSeconds,
+                                 QDateTime::currentDateTime());
   }
 };
 
@@ -6,6 +6,18 @@
 
 #include "CameraInfoTable.h"
 
+namespace {
+
+// 按成员升序比较，供相机信息镜像排序
+template <typename Field>
+MirroredTable<CameraInfo>::Less byField(Field CameraInfo::*field) {
+  return [field](const CameraInfo& a, const CameraInfo& b) {
+    return a.*field < b.*field;
+  };
+}
+
+}  // namespace
+
 // ============================================================================
 // DeviceDatabaseManager实现
 // ============================================================================
@@ -16,9 +28,44 @@ DeviceDatabaseManager::DeviceDatabaseManager(const DatabaseConfig& config,
   qInfo() << "创建设备数据库管理器";
 }
 
+bool DeviceDatabaseManager::initialize() {
+  if (!BaseDatabaseManager::initialize()) {
+    return false;
+  }
+  if (m_cameraInfoMirror) {
+    return true;
+  }
+
+  // 相机信息表很小而逐帧读取：读取全部走内存镜像，启动时一条查询加载
+  using Less = MirroredTable<CameraInfo>::Less;
+  // 与 CameraInfoTable::sanitizeOrderBy 的白名单一致
+  const QHash<QString, Less> sortKeys = {
+      {"id", byField(&CameraInfo::id)},
+      {"name", byField(&CameraInfo::name)},
+      {"version", byField(&CameraInfo::version)},
+      {"connection_type", byField(&CameraInfo::connectionType)},
+      {"serial_number", byField(&CameraInfo::serialNumber)},
+      {"manufacturer", byField(&CameraInfo::manufacturer)},
+      {"created_at", byField(&CameraInfo::createdAt)},
+      {"updated_at", byField(&CameraInfo::updatedAt)}};
+  m_cameraInfoMirror = std::make_unique<MirroredTable<CameraInfo>>(
+      m_cameraInfoTable.get(), sortKeys.value("name"), sortKeys);
+  auto loaded = m_cameraInfoMirror->load();
+  if (!loaded.success) {
+    // 镜像保留待重载标记，下一次写入或变更时重试
+    qWarning() << "相机信息镜像加载失败:" << loaded.errorMessage;
+  } else {
+    qInfo() << "相机信息镜像已加载:" << loaded.data << "条";
+  }
+  // 序列号索引在后台加载，就绪前 serialNumberExists 照常查库
+  m_cameraInfoTable->serialIndex()->rebuildAsync();
+  return true;
+}
+
 void DeviceDatabaseManager::close() {
-  m_cameraInfoTable.reset();     // 先释放业务表，避免悬空
-  BaseDatabaseManager::close();  // 再做通用清理
+  m_cameraInfoMirror.reset();    // 镜像包装业务表，最先释放
+  m_cameraInfoTable.reset();     // 再释放业务表，避免悬空
+  BaseDatabaseManager::close();  // 最后做通用清理
 }
 
 void DeviceDatabaseManager::registerTables() {
@@ -52,53 +99,67 @@ CameraInfoTable* DeviceDatabaseManager::cameraInfoTable() const {
   return m_cameraInfoTable.get();
 }
 
+MirroredTable<CameraInfo>* DeviceDatabaseManager::cameraInfoMirror() const {
+  return m_cameraInfoMirror.get();
+}
+
 DbResult<int> DeviceDatabaseManager::addCamera(const CameraInfo& camera) {
-  if (!m_cameraInfoTable) {
+  if (!m_cameraInfoMirror) {
     return DbResult<int>::Error("相机信息表未初始化");
   }
 
-  return m_cameraInfoTable->insert(camera);
+  return m_cameraInfoMirror->insert(camera);
 }
 
 DbResult<bool> DeviceDatabaseManager::updateCamera(const CameraInfo& camera) {
-  if (!m_cameraInfoTable) {
+  if (!m_cameraInfoMirror) {
     return DbResult<bool>::Error("相机信息表未初始化");
   }
 
-  return m_cameraInfoTable->update(camera);
+  return m_cameraInfoMirror->update(camera);
 }
 
 DbResult<bool> DeviceDatabaseManager::removeCamera(int cameraId) {
-  if (!m_cameraInfoTable) {
+  if (!m_cameraInfoMirror) {
     return DbResult<bool>::Error("相机信息表未初始化");
   }
 
-  return m_cameraInfoTable->deleteById(cameraId);
+  return m_cameraInfoMirror->deleteById(cameraId);
 }
 
 DbResult<CameraInfo> DeviceDatabaseManager::getCamera(int cameraId) const {
-  if (!m_cameraInfoTable) {
+  if (!m_cameraInfoMirror) {
     return DbResult<CameraInfo>::Error("相机信息表未初始化");
   }
 
-  return m_cameraInfoTable->selectById(cameraId);
+  return m_cameraInfoMirror->selectById(cameraId);
 }
 
 DbResult<QList<CameraInfo>> DeviceDatabaseManager::getAllCameras() const {
-  if (!m_cameraInfoTable) {
+  if (!m_cameraInfoMirror) {
     return DbResult<QList<CameraInfo>>::Error("相机信息表未初始化");
   }
 
-  return m_cameraInfoTable->selectAll();
+  return m_cameraInfoMirror->selectAll();
 }
 
 DbResult<CameraInfo> DeviceDatabaseManager::getCameraBySerialNumber(
     const QString& serialNumber) const {
-  if (!m_cameraInfoTable) {
+  if (!m_cameraInfoMirror) {
     return DbResult<CameraInfo>::Error("相机信息表未初始化");
   }
 
-  return m_cameraInfoTable->selectBySerialNumber(serialNumber);
+  if (serialNumber.isEmpty()) {
+    return DbResult<CameraInfo>::Error("序列号不能为空");
+  }
+
+  const QList<CameraInfo> matched = m_cameraInfoMirror->select(
+      [&](const CameraInfo& c) { return c.serialNumber == serialNumber; });
+  if (matched.isEmpty()) {
+    return DbResult<CameraInfo>::Error(
+        "未找到指定序列号的相机", DbErrorCode::NOT_FOUND);
+  }
+  return DbResult<CameraInfo>::Success(matched.first());
 }
 
 DbResult<QList<CameraInfo>> DeviceDatabaseManager::searchCameras(
@@ -107,26 +168,27 @@ DbResult<QList<CameraInfo>> DeviceDatabaseManager::searchCameras(
     return DbResult<QList<CameraInfo>>::Error("相机信息表未初始化");
   }
 
+  // 模糊匹配保持 SQL LIKE 的语义（大小写规则与通配符），不走镜像
   return m_cameraInfoTable->search(keyword);
 }
 
 DbResult<int> DeviceDatabaseManager::importCameras(
     const QList<CameraInfo>& cameras) {
-  if (!m_cameraInfoTable) {
+  if (!m_cameraInfoMirror) {
     return DbResult<int>::Error("相机信息表未初始化");
   }
 
-  return m_cameraInfoTable->batchInsert(cameras);
+  return m_cameraInfoMirror->batchInsert(cameras);
 }
 
 QMap<QString, int> DeviceDatabaseManager::getCameraStatistics() const {
   QMap<QString, int> statistics;
 
-  if (!m_cameraInfoTable) {
+  if (!m_cameraInfoMirror) {
     return statistics;
   }
 
-  auto allCameras = m_cameraInfoTable->selectAll();
+  auto allCameras = m_cameraInfoMirror->selectAll();
   if (!allCameras.success) {
     return statistics;
   }
@@ -10,6 +10,8 @@
 #include "BaseDatabaseManager.h"
 #include "DatabaseFramework.h"
 #include "DeviceDataBaseStruct.h"
+#include "DeviceSqlFunctions.h"
+#include "MirroredTable.h"
 
 class CameraInfoTable;
 
@@ -26,6 +28,8 @@ class DeviceDatabaseManager : public BaseDatabaseManager {
 
  private:
   std::unique_ptr<CameraInfoTable> m_cameraInfoTable;  ///< 相机信息表
+  /// 相机信息内存镜像（包装 m_cameraInfoTable，须先于其释放）
+  std::unique_ptr<MirroredTable<CameraInfo>> m_cameraInfoMirror;
 
  public:
   /**
@@ -41,18 +45,32 @@ class DeviceDatabaseManager : public BaseDatabaseManager {
    */
   ~DeviceDatabaseManager() override = default;
 
+  /**
+   * @brief 初始化数据库并加载相机信息镜像
+   * @return 是否成功
+   */
+  bool initialize() override;
+
+  void close() override;
+
   // ========================================================================
   // 表访问器
   // ========================================================================
 
-  void close() override;
-
   /**
    * @brief 获取相机信息表操作对象
    * @return 相机信息表指针
    */
   CameraInfoTable* cameraInfoTable() const;
 
+  /**
+   * @brief 获取相机信息内存镜像
+   * 读取走内存快照（线程事务中读落盘表）；除模糊搜索外，业务方法的读写
+   * 均经由镜像
+   * @return 镜像表指针（未初始化时为nullptr）
+   */
+  MirroredTable<CameraInfo>* cameraInfoMirror() const;
+
   // 后续可以添加其他表的访问器
   // CameraConfigTable* cameraConfigTable() const;
   // CameraStatusTable* cameraStatusTable() const;
@@ -133,6 +151,14 @@ class DeviceDatabaseManager : public BaseDatabaseManager {
    */
   void registerTables() override;
 
+  /**
+   * @brief 设备库的原生SQL函数（序列号、分辨率、在线判断）
+   * @return DeviceSqlFunctions::all()
+   */
+  QList<SqlFunction> sqlFunctions() const override {
+    return DeviceSqlFunctions::all();
+  }
+
  signals:
   /**
    * @brief 相机添加信号
@@ -0,0 +1,150 @@
+﻿// DeviceSqlFunctions.cpp - 设备库的业务规则与对应的原生 SQL 函数实现
+#include "DeviceSqlFunctions.h"
+
+// ============================================================================
+// 业务规则
+// ============================================================================
+
+QString DeviceRules::normalizeSerial(const QString& serial) {
+  if (serial.isNull()) return serial;
+  QString out;
+  out.reserve(serial.size());
+  for (const QChar& ch : serial) {
+    if (ch.isPrint() && !ch.isSpace()) out.append(ch);
+  }
+  return out;
+}
+
+bool DeviceRules::isValidSerial(const QString& serial) {
+  if (serial.isEmpty() || serial.length() > kMaxSerialLength) return false;
+  for (const QChar& ch : serial) {
+    if (!ch.isPrint() || ch.isSpace()) return false;
+  }
+  return true;
+}
+
+bool DeviceRules::parseResolution(const QString& text, int* width,
+                                  int* height) {
+  const QString t = text.trimmed();
+  int sep = -1;
+  for (int i = 0; i < t.size(); ++i) {
+    const QChar ch = t.at(i);
+    if (ch == 'x' || ch == 'X' || ch == '*' || ch == QChar(0x00D7)) {
+      sep = i;
+      break;
+    }
+  }
+  if (sep <= 0) return false;
+  bool okW = false;
+  bool okH = false;
+  const int w = t.leftRef(sep).trimmed().toInt(&okW);
+  const int h = t.midRef(sep + 1).trimmed().toInt(&okH);
+  if (!okW || !okH || w <= 0 || h <= 0) return false;
+  if (width) *width = w;
+  if (height) *height = h;
+  return true;
+}
+
+bool DeviceRules::isOnline(bool onlineStatus, const QDateTime& lastHeartbeat,
+                           int timeoutSeconds, const QDateTime& now) {
+  if (!onlineStatus) return false;
+  return lastHeartbeat.secsTo(now) <= timeoutSeconds;
+}
+
+// ============================================================================
+// SQL 函数
+// ============================================================================
+
+#ifdef DB_SQLITE_NATIVE
+namespace {
+
+using namespace SqlFunctionValue;
+
+void serialNormalize(sqlite3_context* ctx, int, sqlite3_value** argv) {
+  resultText(ctx, DeviceRules::normalizeSerial(text(argv[0])));
+}
+
+void serialValid(sqlite3_context* ctx, int, sqlite3_value** argv) {
+  sqlite3_result_int(ctx, DeviceRules::isValidSerial(text(argv[0])));
+}
+
+/// 分辨率的某一维：0 宽、1 高、2 像素数
+template <int Part>
+void resolutionPart(sqlite3_context* ctx, int, sqlite3_value** argv) {
+  int w = 0;
+  int h = 0;
+  if (isNull(argv[0]) || !DeviceRules::parseResolution(text(argv[0]), &w, &h)) {
+    sqlite3_result_null(ctx);
+    return;
+  }
+  if (Part == 0) sqlite3_result_int(ctx, w);
+  if (Part == 1) sqlite3_result_int(ctx, h);
+  if (Part == 2) sqlite3_result_int64(ctx, static_cast<sqlite3_int64>(w) * h);
+}
+
+void cameraOnline(sqlite3_context* ctx, int argc, sqlite3_value** argv) {
+  const QDateTime now =
+      argc > 3 ? dateTime(argv[3]) : QDateTime::currentDateTime();
+  sqlite3_result_int(
+      ctx, DeviceRules::isOnline(sqlite3_value_int(argv[0]) != 0,
+                                 dateTime(argv[1]), sqlite3_value_int(argv[2]),
+                                 now));
+}
+
+/// resolution_max 的聚合状态（由 sqlite3_aggregate_context 清零分配）
+struct ResolutionMax {
+  sqlite3_int64 pixels;
+  int width;
+  int height;
+};
+
+void resolutionMaxStep(sqlite3_context* ctx, int, sqlite3_value** argv) {
+  int w = 0;
+  int h = 0;
+  if (isNull(argv[0]) || !DeviceRules::parseResolution(text(argv[0]), &w, &h)) {
+    return;
+  }
+  auto* st = static_cast<ResolutionMax*>(
+      sqlite3_aggregate_context(ctx, sizeof(ResolutionMax)));
+  if (!st) {
+    sqlite3_result_error_nomem(ctx);
+    return;
+  }
+  const sqlite3_int64 pixels = static_cast<sqlite3_int64>(w) * h;
+  if (pixels > st->pixels) {
+    st->pixels = pixels;
+    st->width = w;
+    st->height = h;
+  }
+}
+
+void resolutionMaxFinal(sqlite3_context* ctx) {
+  // 传 0 只查询，不为空组分配
+  auto* st = static_cast<ResolutionMax*>(sqlite3_aggregate_context(ctx, 0));
+  if (!st || st->pixels == 0) {
+    sqlite3_result_null(ctx);
+    return;
+  }
+  resultText(ctx, QString("%1x%2").arg(st->width).arg(st->height));
+}
+
+}  // namespace
+#endif  // DB_SQLITE_NATIVE
+
+QList<SqlFunction> DeviceSqlFunctions::all() {
+#ifdef DB_SQLITE_NATIVE
+  return {
+      SqlFunction::Scalar("serial_normalize", 1, serialNormalize),
+      SqlFunction::Scalar("serial_valid", 1, serialValid),
+      SqlFunction::Scalar("resolution_width", 1, resolutionPart<0>),
+      SqlFunction::Scalar("resolution_height", 1, resolutionPart<1>),
+      SqlFunction::Scalar("resolution_pixels", 1, resolutionPart<2>),
+      SqlFunction::Scalar("camera_online", 4, cameraOnline),
+      SqlFunction::Scalar("camera_online", 3, cameraOnline, false),
+      SqlFunction::Aggregate("resolution_max", 1, resolutionMaxStep,
+                             resolutionMaxFinal),
+  };
+#else
+  return {};
+#endif
+}
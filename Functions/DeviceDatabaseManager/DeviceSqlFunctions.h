@@ -0,0 +1,75 @@
+﻿// DeviceSqlFunctions.h - 设备库的业务规则与对应的原生 SQL 函数
+#ifndef DEVICE_SQL_FUNCTIONS_H
+#define DEVICE_SQL_FUNCTIONS_H
+
+#include <QDateTime>
+#include <QList>
+#include <QString>
+
+#include "SqlFunctions.h"
+
+/**
+ * @brief 设备实体的业务规则
+ * 实体校验与 SQL 函数共用同一实现，库内过滤与 C++ 侧判断结果一致。
+ */
+namespace DeviceRules {
+
+constexpr int kMaxSerialLength = 100;  ///< 序列号最大长度
+
+/**
+ * @brief 规范化序列号：去掉空白与不可打印字符
+ * @param serial 序列号
+ * @return 规范化结果（空值保持为空值）
+ */
+QString normalizeSerial(const QString& serial);
+
+/**
+ * @brief 序列号是否合法：非空、不超长，且已是规范形式
+ * @param serial 序列号
+ */
+bool isValidSerial(const QString& serial);
+
+/**
+ * @brief 解析分辨率文本（如 "1920x1080"，分隔符可为 x、X、×、*）
+ * @param text 分辨率文本
+ * @param width 宽度输出（可为nullptr）
+ * @param height 高度输出（可为nullptr）
+ * @return 是否解析成功（宽高均为正整数）
+ */
+bool parseResolution(const QString& text, int* width, int* height);
+
+/**
+ * @brief 设备是否在线：在线标志为真且心跳未超时
+ * @param onlineStatus 在线标志
+ * @param lastHeartbeat 最后心跳时间
+ * @param timeoutSeconds 超时时间（秒）
+ * @param now 当前时间
+ */
+bool isOnline(bool onlineStatus, const QDateTime& lastHeartbeat,
+              int timeoutSeconds, const QDateTime& now);
+
+}  // namespace DeviceRules
+
+/**
+ * @brief 设备库注册的原生 SQL 函数
+ *   serial_normalize(s)            规范化序列号
+ *   serial_valid(s)                序列号是否合法（0/1）
+ *   resolution_width(r)            分辨率宽度（无法解析为 NULL）
+ *   resolution_height(r)           分辨率高度
+ *   resolution_pixels(r)           像素数
+ *   camera_online(o, hb, t, now)   是否在线（0/1），时间为 ISO 文本或
+ *                                  Unix 秒
+ *   camera_online(o, hb, t)        同上，以当前时间判断（非确定性）
+ *   resolution_max(r)              聚合：像素数最大的分辨率（"宽x高"）
+ * 除三参数的 camera_online 外均为确定性函数，可用于表达式索引。
+ */
+namespace DeviceSqlFunctions {
+
+/**
+ * @brief 全部函数（非 sqlite_native 构建为空）
+ */
+QList<SqlFunction> all();
+
+}  // namespace DeviceSqlFunctions
+
+#endif  // DEVICE_SQL_FUNCTIONS_H
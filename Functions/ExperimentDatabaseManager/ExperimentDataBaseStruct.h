@@ -0,0 +1,137 @@
+﻿#ifndef EXPERIMENTDATABASESTRUCT_H
+#define EXPERIMENTDATABASESTRUCT_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QString>
+#include <QtEndian>
+
+// ============================================================================
+// 数据实体定义
+// ============================================================================
+
+/**
+ * @brief 图像元数据实体
+ * 对应数据库中的图像数据表；像素数据不入库，按 contentHash
+ * 存放在内容寻址的旁路文件中，查询元数据不会读取像素
+ */
+struct ImageData {
+  int id = -1;             ///< 图像ID（主键，自增）
+  int experimentId = -1;   ///< 所属实验ID（-1表示未关联）
+  QString name;            ///< 图像名称
+  int width = 0;           ///< 宽（像素）
+  int height = 0;          ///< 高（像素）
+  int channels = 1;        ///< 通道数
+  int bitDepth = 8;        ///< 每通道位深
+  QString pixelFormat;     ///< 像素格式（如"Mono8"、"RGB8"）
+  qint64 byteSize = 0;     ///< 像素数据字节数（写入时由存储填充）
+  QString contentHash;     ///< 像素内容摘要（SHA-256）
+  QDateTime capturedAt;    ///< 采集时间
+  QDateTime createdAt;     ///< 创建时间
+
+  /**
+   * @brief 默认构造函数
+   */
+  ImageData() {
+    QDateTime now = QDateTime::currentDateTime();
+    capturedAt = now;
+    createdAt = now;
+  }
+
+  /**
+   * @brief 按宽高、通道与位深计算的理论字节数
+   * @return 字节数
+   */
+  qint64 expectedByteSize() const {
+    return static_cast<qint64>(width) * height * channels *
+           ((bitDepth + 7) / 8);
+  }
+
+  /**
+   * @brief 验证元数据有效性（不含内容摘要）
+   * @return 数据是否有效
+   */
+  bool isValid() const {
+    return !name.isEmpty() && width > 0 && height > 0 && channels > 0 &&
+           bitDepth > 0;
+  }
+};
+
+/**
+ * @brief 实验数据样本类型
+ */
+enum class SampleType {
+  FLOAT32 = 0,  ///< 单精度浮点
+  FLOAT64 = 1   ///< 双精度浮点
+};
+
+/**
+ * @brief 样本类型字节数
+ * @param type 样本类型
+ * @return 每个样本的字节数
+ */
+inline int sampleTypeSize(SampleType type) {
+  return type == SampleType::FLOAT32 ? 4 : 8;
+}
+
+// 数据块以小端原始数组存储，按内存直接解码
+static_assert(Q_BYTE_ORDER == Q_LITTLE_ENDIAN,
+              "ExperimentDataChunk 以小端原始数组存储");
+
+/**
+ * @brief 实验数据块实体
+ * 对应数据库中的实验数据表；一个序列按固定样本数切块存储，
+ * 每块带 min/max/count 区间索引（zone map），聚合时据此跳过整块
+ */
+struct ExperimentDataChunk {
+  int id = -1;                                ///< 块ID（主键，自增）
+  int experimentId = -1;                      ///< 所属实验ID
+  QString series;                             ///< 序列名（如通道名）
+  int chunkIndex = 0;                         ///< 块序号（从0开始）
+  SampleType sampleType = SampleType::FLOAT64;  ///< 样本类型
+  int sampleCount = 0;                        ///< 块内样本数
+  int nanCount = 0;                           ///< 块内NaN个数
+  double minValue = 0.0;                      ///< 块内最小值（不含NaN）
+  double maxValue = 0.0;                      ///< 块内最大值（不含NaN）
+  double sumValue = 0.0;                      ///< 块内求和（不含NaN）
+  QByteArray data;                            ///< 样本原始数组
+  QDateTime createdAt;                        ///< 创建时间
+
+  /**
+   * @brief 块内有效（非NaN）样本数
+   * @return 个数
+   */
+  int validCount() const { return sampleCount - nanCount; }
+
+  /**
+   * @brief 验证数据有效性
+   * @return 数据是否有效
+   */
+  bool isValid() const {
+    return experimentId > 0 && !series.isEmpty() && chunkIndex >= 0 &&
+           sampleCount >= 0 &&
+           data.size() == sampleCount * sampleTypeSize(sampleType);
+  }
+};
+
+/**
+ * @brief 序列聚合结果
+ */
+struct SeriesAggregate {
+  qint64 count = 0;          ///< 命中样本数
+  double sum = 0.0;          ///< 命中样本之和
+  double min = 0.0;          ///< 命中最小值（count为0时无意义）
+  double max = 0.0;          ///< 命中最大值（count为0时无意义）
+  int chunksTotal = 0;       ///< 序列总块数
+  int chunksSkipped = 0;     ///< 由区间索引整体跳过的块数
+  int chunksFromZoneMap = 0;  ///< 整块命中、直接用区间索引作答的块数
+  int chunksDecoded = 0;     ///< 需要解码扫描的块数
+
+  /**
+   * @brief 平均值
+   * @return 命中样本均值（无命中返回0）
+   */
+  double mean() const { return count > 0 ? sum / count : 0.0; }
+};
+
+#endif  // EXPERIMENTDATABASESTRUCT_H
@@ -0,0 +1,881 @@
+﻿#include "ExperimentDataTable.h"
+
+#include <QSet>
+#include <cmath>
+
+#include "AuditTrail.h"
+#include "SimdKernels.h"
+#include "WorkloadCapture.h"
+
+// ============================================================================
+// ExperimentDataTable SQL语句常量定义
+// ============================================================================
+
+const QString ExperimentDataTable::INSERT_SQL = R"(
+    INSERT INTO experiment_data (experiment_id, series, chunk_index,
+                                 sample_type, sample_count, nan_count,
+                                 min_value, max_value, sum_value, data)
+    VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+)";
+
+const QString ExperimentDataTable::UPDATE_SQL = R"(
+    UPDATE experiment_data
+    SET experiment_id = ?, series = ?, chunk_index = ?, sample_type = ?,
+        sample_count = ?, nan_count = ?, min_value = ?, max_value = ?,
+        sum_value = ?, data = ?
+    WHERE id = ?
+)";
+
+const QString ExperimentDataTable::DELETE_SQL = R"(
+    DELETE FROM experiment_data WHERE id = ?
+)";
+
+const QString ExperimentDataTable::SELECT_BY_ID_SQL = R"(
+    SELECT id, experiment_id, series, chunk_index, sample_type, sample_count,
+           nan_count, min_value, max_value, sum_value, created_at, data
+    FROM experiment_data WHERE id = ?
+)";
+
+const QString ExperimentDataTable::SELECT_ALL_SQL = R"(
+    SELECT id, experiment_id, series, chunk_index, sample_type, sample_count,
+           nan_count, min_value, max_value, sum_value, created_at
+    FROM experiment_data ORDER BY experiment_id, series, chunk_index
+)";
+
+const QString ExperimentDataTable::SELECT_TAIL_SQL = R"(
+    SELECT id, experiment_id, series, chunk_index, sample_type, sample_count,
+           nan_count, min_value, max_value, sum_value, created_at, data
+    FROM experiment_data WHERE experiment_id = ? AND series = ?
+    ORDER BY chunk_index DESC LIMIT 1
+)";
+
+const QString ExperimentDataTable::SELECT_RANGE_SQL = R"(
+    SELECT sample_type, sample_count, data
+    FROM experiment_data
+    WHERE experiment_id = ? AND series = ? AND chunk_index BETWEEN ? AND ?
+    ORDER BY chunk_index
+)";
+
+// 区间索引过滤；整块落在区间内时不读取数据列（返回NULL）
+const QString ExperimentDataTable::AGGREGATE_SQL = R"(
+    SELECT sample_type, sample_count, nan_count, min_value, max_value,
+           sum_value,
+           CASE WHEN min_value >= ? AND max_value <= ? THEN NULL ELSE data END
+    FROM experiment_data
+    WHERE experiment_id = ? AND series = ? AND max_value >= ? AND min_value <= ?
+    ORDER BY chunk_index
+)";
+
+// 常量块（min = max）整块落在一个桶内，同样不读取数据列
+const QString ExperimentDataTable::HISTOGRAM_SQL = R"(
+    SELECT sample_type, sample_count, nan_count, min_value, max_value,
+           sum_value,
+           CASE WHEN min_value = max_value THEN NULL ELSE data END
+    FROM experiment_data
+    WHERE experiment_id = ? AND series = ? AND max_value >= ? AND min_value <= ?
+    ORDER BY chunk_index
+)";
+
+const QString ExperimentDataTable::COUNT_CHUNKS_SQL = R"(
+    SELECT COUNT(*) FROM experiment_data WHERE experiment_id = ? AND series = ?
+)";
+
+const QString ExperimentDataTable::DELETE_SERIES_SQL = R"(
+    DELETE FROM experiment_data WHERE experiment_id = ? AND series = ?
+)";
+
+const QString ExperimentDataTable::SELECT_SERIES_SQL = R"(
+    SELECT DISTINCT series FROM experiment_data WHERE experiment_id = ?
+    ORDER BY series
+)";
+
+QList<PlanExpectation> ExperimentDataTable::planExpectations() {
+  const QString pk = "INTEGER PRIMARY KEY";
+  // UNIQUE(experiment_id, series, chunk_index) 的自动索引
+  const QString chunkIndex = "sqlite_autoindex_experiment_data_1";
+  QList<PlanExpectation> list = {
+      {"ExperimentDataTable::SELECT_BY_ID_SQL", SELECT_BY_ID_SQL, {pk}},
+      {"ExperimentDataTable::UPDATE_SQL", UPDATE_SQL, {pk}},
+      {"ExperimentDataTable::DELETE_SQL", DELETE_SQL, {pk}},
+      {"ExperimentDataTable::SELECT_TAIL_SQL", SELECT_TAIL_SQL, {chunkIndex}},
+      {"ExperimentDataTable::SELECT_RANGE_SQL", SELECT_RANGE_SQL,
+       {chunkIndex}},
+      {"ExperimentDataTable::AGGREGATE_SQL", AGGREGATE_SQL, {chunkIndex}},
+      {"ExperimentDataTable::HISTOGRAM_SQL", HISTOGRAM_SQL, {chunkIndex}},
+      {"ExperimentDataTable::COUNT_CHUNKS_SQL", COUNT_CHUNKS_SQL,
+       {chunkIndex}},
+      {"ExperimentDataTable::DELETE_SERIES_SQL", DELETE_SERIES_SQL,
+       {chunkIndex}},
+      {"ExperimentDataTable::SELECT_SERIES_SQL", SELECT_SERIES_SQL,
+       {chunkIndex}},
+      // 按索引顺序整表扫描，免去排序
+      {"ExperimentDataTable::SELECT_ALL_SQL", SELECT_ALL_SQL, {chunkIndex},
+       true}};
+
+  // 分页按主键或实验索引顺序扫描，不得额外排序
+  for (bool ascending : {true, false}) {
+    const QString dir = ascending ? "ASC" : "DESC";
+    list.append({QString("ExperimentDataTable::selectByPage(id %1)").arg(dir),
+                 selectByPageSql(PageParams{3, 50, "id", ascending}),
+                 {},
+                 true});
+    list.append(
+        {QString("ExperimentDataTable::selectByPage(experiment_id %1)")
+             .arg(dir),
+         selectByPageSql(PageParams{3, 50, "experiment_id", ascending}),
+         {chunkIndex},
+         true});
+  }
+  return list;
+}
+
+// ============================================================================
+// ExperimentDataTableOperations 实现
+// ============================================================================
+
+const QString ExperimentDataTableOperations::CREATE_TABLE_SQL = R"(
+  CREATE TABLE IF NOT EXISTS experiment_data (
+    id INTEGER PRIMARY KEY AUTOINCREMENT,
+    experiment_id INTEGER NOT NULL,
+    series TEXT NOT NULL,
+    chunk_index INTEGER NOT NULL,
+    sample_type INTEGER NOT NULL,
+    sample_count INTEGER NOT NULL,
+    nan_count INTEGER NOT NULL DEFAULT 0,
+    min_value REAL,
+    max_value REAL,
+    sum_value REAL NOT NULL DEFAULT 0,
+    data BLOB NOT NULL,
+    created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
+    UNIQUE(experiment_id, series, chunk_index)
+  )
+)";
+
+ExperimentDataTableOperations::ExperimentDataTableOperations(
+    QSqlDatabase* db, ConnectionPool* pool)
+    : BaseTableOperations(db, "experiment_data", TableType::EXPERIMENT_DATA,
+                          pool, nullptr) {}
+
+bool ExperimentDataTableOperations::createTable() {
+  ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
+
+  auto c = acquireDb();
+  if (!c.db.isOpen()) {
+    qCritical() << "数据库连接未打开!";
+    return false;
+  }
+
+  // 唯一约束同时提供 (experiment_id, series, chunk_index) 索引
+  QSqlQuery query(c.db);
+  if (!query.exec(CREATE_TABLE_SQL)) {
+    QString error = query.lastError().text();
+    qCritical() << "创建实验数据表失败:" << error;
+    logOperation("创建表失败", error);
+    return false;
+  }
+
+  logOperation("创建表成功", m_tableName);
+  return true;
+}
+
+// ============================================================================
+// 内部工具
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief 区间索引中的最值列（块内无有效样本时为NULL，区间过滤自然跳过）
+ */
+QVariant zoneValue(const ExperimentDataChunk& chunk, double v) {
+  return chunk.validCount() > 0 ? QVariant(v) : QVariant();
+}
+
+void bindChunk(QSqlQuery& query, const ExperimentDataChunk& chunk) {
+  query.addBindValue(chunk.experimentId);
+  query.addBindValue(chunk.series);
+  query.addBindValue(chunk.chunkIndex);
+  query.addBindValue(static_cast<int>(chunk.sampleType));
+  query.addBindValue(chunk.sampleCount);
+  query.addBindValue(chunk.nanCount);
+  query.addBindValue(zoneValue(chunk, chunk.minValue));
+  query.addBindValue(zoneValue(chunk, chunk.maxValue));
+  query.addBindValue(chunk.sumValue);
+  query.addBindValue(chunk.data);
+}
+
+/**
+ * @brief 对一块原始数据执行区间统计
+ */
+SimdKernels::RangeStats chunkStats(SampleType type, const QByteArray& data,
+                                   int count, double lo, double hi) {
+  if (type == SampleType::FLOAT32) {
+    return SimdKernels::rangeStats(
+        reinterpret_cast<const float*>(data.constData()), count, lo, hi);
+  }
+  return SimdKernels::rangeStats(
+      reinterpret_cast<const double*>(data.constData()), count, lo, hi);
+}
+
+/**
+ * @brief 查询结果中的块数据列是否与声明的样本数一致
+ */
+bool chunkDataMatches(SampleType type, const QByteArray& data, int count) {
+  return data.size() == count * sampleTypeSize(type);
+}
+
+}  // namespace
+
+// ============================================================================
+// ExperimentDataTable实现
+// ============================================================================
+
+ExperimentDataTable::ExperimentDataTable(QSqlDatabase* db,
+                                         ConnectionPool* pool)
+    : BaseTable<ExperimentDataChunk>(nullptr) {
+  m_ops = new ExperimentDataTableOperations(db, pool);
+  m_baseOps = m_ops;
+}
+
+ExperimentDataTable::~ExperimentDataTable() { m_baseOps = nullptr; }
+
+void ExperimentDataTable::computeZoneMap(ExperimentDataChunk& chunk) {
+  const int size = sampleTypeSize(chunk.sampleType);
+  chunk.sampleCount = chunk.data.size() / size;
+
+  const auto stats =
+      chunkStats(chunk.sampleType, chunk.data, chunk.sampleCount,
+                 -std::numeric_limits<double>::infinity(),
+                 std::numeric_limits<double>::infinity());
+  chunk.nanCount = chunk.sampleCount - static_cast<int>(stats.count);
+  chunk.sumValue = stats.sum;
+  chunk.minValue = stats.count > 0 ? stats.min : 0.0;
+  chunk.maxValue = stats.count > 0 ? stats.max : 0.0;
+}
+
+DbResult<int> ExperimentDataTable::insertChunk(
+    QSqlDatabase& db, const ExperimentDataChunk& chunk) {
+  QSqlQuery query(db);
+  query.prepare(INSERT_SQL);
+  bindChunk(query, chunk);
+
+  if (!SqlExec::run(query)) {
+    QString error =
+        QString("插入实验数据块失败: %1").arg(query.lastError().text());
+    m_ops->logOperation("插入失败", error);
+    emit m_ops->databaseError(error);
+    return DbResult<int>::Error(error);
+  }
+
+  const int newId = query.lastInsertId().toInt();
+  emit m_ops->recordInserted(newId);
+  return DbResult<int>::Success(newId);
+}
+
+DbResult<int> ExperimentDataTable::insert(const ExperimentDataChunk& chunk) {
+  if (!m_ops) {
+    return DbResult<int>::Error("实验数据表未初始化或已释放");
+  }
+
+  ExperimentDataChunk row = chunk;
+  computeZoneMap(row);
+  if (!row.isValid()) {
+    return DbResult<int>::Error("实验数据块无效");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) return DbResult<int>::Error("数据库未打开");
+
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+  auto result = insertChunk(c.db, row);
+  if (result.success) {
+    m_ops->logOperation("插入成功", QString("序列 %1 块 %2")
+                                        .arg(row.series)
+                                        .arg(row.chunkIndex));
+  }
+  return result;
+}
+
+DbResult<bool> ExperimentDataTable::update(const ExperimentDataChunk& chunk) {
+  if (!m_ops) {
+    return DbResult<bool>::Error("实验数据表未初始化或已释放");
+  }
+  if (chunk.id <= 0) {
+    return DbResult<bool>::Error("无效的数据块ID");
+  }
+
+  ExperimentDataChunk row = chunk;
+  computeZoneMap(row);
+  if (!row.isValid()) {
+    return DbResult<bool>::Error("实验数据块无效");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) return DbResult<bool>::Error("数据库未打开");
+
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+  QSqlQuery query(c.db);
+  query.prepare(UPDATE_SQL);
+  bindChunk(query, row);
+  query.addBindValue(row.id);
+
+  if (!SqlExec::run(query)) {
+    QString error =
+        QString("更新实验数据块失败: %1").arg(query.lastError().text());
+    m_ops->logOperation("更新失败", error);
+    emit m_ops->databaseError(error);
+    return DbResult<bool>::Error(error);
+  }
+  if (query.numRowsAffected() == 0) {
+    return DbResult<bool>::Error(
+        "未找到要更新的数据块", DbErrorCode::NOT_FOUND);
+  }
+
+  m_ops->logOperation("更新成功", QString("数据块ID: %1").arg(row.id));
+  emit m_ops->recordUpdated(row.id);
+  return DbResult<bool>::Success(true);
+}
+
+DbResult<bool> ExperimentDataTable::deleteById(int id) {
+  if (!m_ops) {
+    return DbResult<bool>::Error("实验数据表未初始化或已释放");
+  }
+  if (id <= 0) {
+    return DbResult<bool>::Error("无效的数据块ID");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) return DbResult<bool>::Error("数据库未打开");
+
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+  QSqlQuery query(c.db);
+  query.prepare(DELETE_SQL);
+  query.addBindValue(id);
+
+  if (!SqlExec::run(query)) {
+    QString error =
+        QString("删除实验数据块失败: %1").arg(query.lastError().text());
+    m_ops->logOperation("删除失败", error);
+    emit m_ops->databaseError(error);
+    return DbResult<bool>::Error(error);
+  }
+  if (query.numRowsAffected() == 0) {
+    return DbResult<bool>::Error(
+        "未找到要删除的数据块", DbErrorCode::NOT_FOUND);
+  }
+
+  m_ops->logOperation("删除成功", QString("数据块ID: %1").arg(id));
+  emit m_ops->recordDeleted(id);
+  return DbResult<bool>::Success(true);
+}
+
+DbResult<ExperimentDataChunk> ExperimentDataTable::selectById(int id) const {
+  if (!m_ops) {
+    return DbResult<ExperimentDataChunk>::Error("实验数据表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<ExperimentDataChunk>::Error("数据库未打开");
+  }
+
+  QSqlQuery query(c.db);
+  query.prepare(SELECT_BY_ID_SQL);
+  query.addBindValue(id);
+
+  if (!SqlExec::run(query)) {
+    return DbResult<ExperimentDataChunk>::Error(
+        QString("查询实验数据块失败: %1").arg(query.lastError().text()));
+  }
+  if (query.next()) {
+    return DbResult<ExperimentDataChunk>::Success(buildChunk(query, true));
+  }
+  return DbResult<ExperimentDataChunk>::Error(
+      "未找到指定的数据块", DbErrorCode::NOT_FOUND);
+}
+
+DbResult<QList<ExperimentDataChunk>> ExperimentDataTable::selectAll() const {
+  if (!m_ops) {
+    return DbResult<QList<ExperimentDataChunk>>::Error(
+        "实验数据表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<QList<ExperimentDataChunk>>::Error("数据库未打开");
+  }
+
+  QSqlQuery query(c.db);
+  query.setForwardOnly(true);
+  if (!SqlExec::run(query, SELECT_ALL_SQL)) {
+    return DbResult<QList<ExperimentDataChunk>>::Error(
+        QString("查询实验数据块失败: %1").arg(query.lastError().text()));
+  }
+
+  QList<ExperimentDataChunk> chunks;
+  while (query.next()) chunks.append(buildChunk(query, false));
+  return DbResult<QList<ExperimentDataChunk>>::Success(std::move(chunks));
+}
+
+QString ExperimentDataTable::selectByPageSql(const PageParams& params) {
+  QString orderBy =
+      params.orderBy.isEmpty() ? "id" : sanitizeOrderBy(params.orderBy);
+  return QString(
+             "SELECT id, experiment_id, series, chunk_index, sample_type, "
+             "sample_count, nan_count, min_value, max_value, sum_value, "
+             "created_at FROM experiment_data "
+             "ORDER BY %1 %2 LIMIT %3 OFFSET %4")
+      .arg(orderBy)
+      .arg(params.ascending ? "ASC" : "DESC")
+      .arg(params.pageSize)
+      .arg(params.offset());
+}
+
+DbResult<PageResult<ExperimentDataChunk>> ExperimentDataTable::selectByPage(
+    const PageParams& params) const {
+  if (!m_ops) {
+    return DbResult<PageResult<ExperimentDataChunk>>::Error(
+        "实验数据表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<PageResult<ExperimentDataChunk>>::Error("数据库未打开");
+  }
+
+  int total = m_ops->getTotalCount();
+
+  QSqlQuery query(c.db);
+  query.setForwardOnly(true);
+  if (!SqlExec::run(query, selectByPageSql(params))) {
+    return DbResult<PageResult<ExperimentDataChunk>>::Error(
+        QString("分页查询实验数据块失败: %1").arg(query.lastError().text()));
+  }
+
+  QList<ExperimentDataChunk> list;
+  while (query.next()) list.append(buildChunk(query, false));
+  return DbResult<PageResult<ExperimentDataChunk>>::Success(
+      PageResult<ExperimentDataChunk>(std::move(list), total, params));
+}
+
+DbResult<int> ExperimentDataTable::batchInsert(
+    const QList<ExperimentDataChunk>& chunks) {
+  if (!m_ops) {
+    return DbResult<int>::Error("实验数据表未初始化或已释放");
+  }
+  if (chunks.isEmpty()) {
+    return DbResult<int>::Error("数据块列表为空");
+  }
+
+  QList<ExperimentDataChunk> rows;
+  rows.reserve(chunks.size());
+  for (const ExperimentDataChunk& chunk : chunks) {
+    ExperimentDataChunk row = chunk;
+    computeZoneMap(row);
+    if (!row.isValid()) {
+      return DbResult<int>::Error(
+          QString("序列 %1 块 %2 无效").arg(row.series).arg(row.chunkIndex));
+    }
+    rows.append(row);
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) return DbResult<int>::Error("数据库未打开");
+
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+  if (!SqlExec::begin(c.db)) {
+    return DbResult<int>::Error("无法开启事务");
+  }
+  AuditTrail::DeferredScope auditScope(m_ops->m_database);
+
+  for (const ExperimentDataChunk& row : rows) {
+    auto r = insertChunk(c.db, row);
+    if (!r.success) {
+      SqlExec::rollback(c.db);
+      return DbResult<int>::Error(
+          QString("批量插入数据块失败: %1").arg(r.errorMessage));
+    }
+  }
+
+  if (!SqlExec::commit(c.db)) {
+    SqlExec::rollback(c.db);
+    return DbResult<int>::Error("提交事务失败");
+  }
+  auditScope.commit();
+  m_ops->logOperation("批量插入成功",
+                      QString("插入 %1 个数据块").arg(rows.size()));
+  return DbResult<int>::Success(rows.size());
+}
+
+DbResult<qint64> ExperimentDataTable::appendSamples(
+    int experimentId, const QString& series, const QVector<float>& samples) {
+  return appendEncoded(experimentId, series, SampleType::FLOAT32,
+                       reinterpret_cast<const char*>(samples.constData()),
+                       samples.size());
+}
+
+DbResult<qint64> ExperimentDataTable::appendSamples(
+    int experimentId, const QString& series, const QVector<double>& samples) {
+  return appendEncoded(experimentId, series, SampleType::FLOAT64,
+                       reinterpret_cast<const char*>(samples.constData()),
+                       samples.size());
+}
+
+DbResult<qint64> ExperimentDataTable::appendEncoded(int experimentId,
+                                                    const QString& series,
+                                                    SampleType type,
+                                                    const char* bytes,
+                                                    qint64 count) {
+  if (!m_ops) {
+    return DbResult<qint64>::Error("实验数据表未初始化或已释放");
+  }
+  if (experimentId <= 0 || series.isEmpty()) {
+    return DbResult<qint64>::Error("实验ID或序列名无效");
+  }
+  if (count <= 0) {
+    return DbResult<qint64>::Success(0);
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) return DbResult<qint64>::Error("数据库未打开");
+
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+  if (!SqlExec::begin(c.db)) {
+    return DbResult<qint64>::Error("无法开启事务");
+  }
+  AuditTrail::DeferredScope auditScope(m_ops->m_database);
+
+  auto fail = [&](const QString& error) {
+    SqlExec::rollback(c.db);
+    m_ops->logOperation("追加样本失败", error);
+    return DbResult<qint64>::Error(error);
+  };
+
+  const int size = sampleTypeSize(type);
+  qint64 offset = 0;
+  int nextIndex = 0;
+
+  // 1) 先填满尾块
+  QSqlQuery query(c.db);
+  query.prepare(SELECT_TAIL_SQL);
+  query.addBindValue(experimentId);
+  query.addBindValue(series);
+  if (!SqlExec::run(query)) {
+    return fail(QString("查询尾块失败: %1").arg(query.lastError().text()));
+  }
+  if (query.next()) {
+    ExperimentDataChunk tail = buildChunk(query, true);
+    query.finish();
+    if (tail.sampleType != type) {
+      return fail(QString("序列 %1 的样本类型与已有数据不一致").arg(series));
+    }
+    nextIndex = tail.chunkIndex + 1;
+
+    if (tail.sampleCount < kChunkSamples) {
+      const qint64 take = qMin<qint64>(count, kChunkSamples - tail.sampleCount);
+      tail.data.append(bytes, static_cast<int>(take * size));
+      computeZoneMap(tail);
+
+      QSqlQuery update(c.db);
+      update.prepare(UPDATE_SQL);
+      bindChunk(update, tail);
+      update.addBindValue(tail.id);
+      if (!SqlExec::run(update)) {
+        return fail(QString("更新尾块失败: %1").arg(update.lastError().text()));
+      }
+      emit m_ops->recordUpdated(tail.id);
+      offset = take;
+    }
+  } else {
+    query.finish();
+  }
+
+  // 2) 余下样本按固定大小切新块
+  while (offset < count) {
+    const qint64 take = qMin<qint64>(count - offset, kChunkSamples);
+
+    ExperimentDataChunk chunk;
+    chunk.experimentId = experimentId;
+    chunk.series = series;
+    chunk.chunkIndex = nextIndex++;
+    chunk.sampleType = type;
+    chunk.data =
+        QByteArray(bytes + offset * size, static_cast<int>(take * size));
+    computeZoneMap(chunk);
+
+    auto r = insertChunk(c.db, chunk);
+    if (!r.success) return fail(r.errorMessage);
+    offset += take;
+  }
+
+  if (!SqlExec::commit(c.db)) {
+    return fail("提交事务失败");
+  }
+  auditScope.commit();
+
+  m_ops->logOperation("追加样本成功",
+                      QString("序列 %1 追加 %2 个样本").arg(series).arg(count));
+  return DbResult<qint64>::Success(count);
+}
+
+DbResult<QVector<double>> ExperimentDataTable::readSamples(
+    int experimentId, const QString& series, qint64 offset,
+    qint64 count) const {
+  if (!m_ops) {
+    return DbResult<QVector<double>>::Error("实验数据表未初始化或已释放");
+  }
+  if (offset < 0) {
+    return DbResult<QVector<double>>::Error("起始样本序号无效");
+  }
+  if (count == 0) {
+    return DbResult<QVector<double>>::Success(QVector<double>());
+  }
+
+  // 块大小固定，样本序号可直接换算为块序号范围
+  const qint64 firstChunk = offset / kChunkSamples;
+  const qint64 lastChunk = count < 0
+                               ? std::numeric_limits<int>::max()
+                               : (offset + count - 1) / kChunkSamples;
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<QVector<double>>::Error("数据库未打开");
+  }
+
+  QSqlQuery query(c.db);
+  query.setForwardOnly(true);
+  query.prepare(SELECT_RANGE_SQL);
+  query.addBindValue(experimentId);
+  query.addBindValue(series);
+  query.addBindValue(firstChunk);
+  query.addBindValue(lastChunk);
+  if (!SqlExec::run(query)) {
+    return DbResult<QVector<double>>::Error(
+        QString("读取样本失败: %1").arg(query.lastError().text()));
+  }
+
+  QVector<double> samples;
+  if (count > 0) samples.reserve(static_cast<int>(count));
+
+  qint64 skip = offset - firstChunk * kChunkSamples;
+  while (query.next()) {
+    const SampleType type = static_cast<SampleType>(query.value(0).toInt());
+    const int n = query.value(1).toInt();
+    const QByteArray data = query.value(2).toByteArray();
+    if (!chunkDataMatches(type, data, n)) {
+      return DbResult<QVector<double>>::Error("数据块长度与样本数不一致");
+    }
+
+    const auto* f32 = reinterpret_cast<const float*>(data.constData());
+    const auto* f64 = reinterpret_cast<const double*>(data.constData());
+    for (int i = static_cast<int>(skip); i < n; ++i) {
+      if (count >= 0 && samples.size() >= count) break;
+      samples.append(type == SampleType::FLOAT32 ? f32[i] : f64[i]);
+    }
+    skip = 0;
+  }
+
+  return DbResult<QVector<double>>::Success(std::move(samples));
+}
+
+DbResult<SeriesAggregate> ExperimentDataTable::aggregate(
+    int experimentId, const QString& series, double lo, double hi) const {
+  if (!m_ops) {
+    return DbResult<SeriesAggregate>::Error("实验数据表未初始化或已释放");
+  }
+  if (std::isnan(lo) || std::isnan(hi) || lo > hi) {
+    return DbResult<SeriesAggregate>::Error("聚合区间无效");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<SeriesAggregate>::Error("数据库未打开");
+  }
+
+  SeriesAggregate result;
+  QSqlQuery query(c.db);
+  query.setForwardOnly(true);
+
+  query.prepare(COUNT_CHUNKS_SQL);
+  query.addBindValue(experimentId);
+  query.addBindValue(series);
+  if (SqlExec::run(query) && query.next()) {
+    result.chunksTotal = query.value(0).toInt();
+  }
+  query.finish();
+
+  query.prepare(AGGREGATE_SQL);
+  query.addBindValue(lo);
+  query.addBindValue(hi);
+  query.addBindValue(experimentId);
+  query.addBindValue(series);
+  query.addBindValue(lo);
+  query.addBindValue(hi);
+  if (!SqlExec::run(query)) {
+    return DbResult<SeriesAggregate>::Error(
+        QString("聚合查询失败: %1").arg(query.lastError().text()));
+  }
+
+  SimdKernels::RangeStats total;
+  int matched = 0;
+  while (query.next()) {
+    ++matched;
+    const SampleType type = static_cast<SampleType>(query.value(0).toInt());
+    const int n = query.value(1).toInt();
+
+    if (query.value(6).isNull()) {
+      // 整块落在区间内：直接使用区间索引
+      SimdKernels::RangeStats s;
+      s.count = n - query.value(2).toInt();
+      s.min = query.value(3).toDouble();
+      s.max = query.value(4).toDouble();
+      s.sum = query.value(5).toDouble();
+      total.merge(s);
+      ++result.chunksFromZoneMap;
+      continue;
+    }
+
+    const QByteArray data = query.value(6).toByteArray();
+    if (!chunkDataMatches(type, data, n)) {
+      return DbResult<SeriesAggregate>::Error("数据块长度与样本数不一致");
+    }
+    total.merge(chunkStats(type, data, n, lo, hi));
+    ++result.chunksDecoded;
+  }
+
+  result.chunksSkipped = result.chunksTotal - matched;
+  result.count = total.count;
+  result.sum = total.sum;
+  if (total.count > 0) {
+    result.min = total.min;
+    result.max = total.max;
+  }
+  return DbResult<SeriesAggregate>::Success(std::move(result));
+}
+
+DbResult<QVector<qint64>> ExperimentDataTable::histogram(
+    int experimentId, const QString& series, double lo, double hi,
+    int bins) const {
+  if (!m_ops) {
+    return DbResult<QVector<qint64>>::Error("实验数据表未初始化或已释放");
+  }
+  if (bins <= 0 || !std::isfinite(lo) || !std::isfinite(hi) || !(hi > lo)) {
+    return DbResult<QVector<qint64>>::Error("直方图参数无效");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<QVector<qint64>>::Error("数据库未打开");
+  }
+
+  QSqlQuery query(c.db);
+  query.setForwardOnly(true);
+  query.prepare(HISTOGRAM_SQL);
+  query.addBindValue(experimentId);
+  query.addBindValue(series);
+  query.addBindValue(lo);
+  query.addBindValue(hi);
+  if (!SqlExec::run(query)) {
+    return DbResult<QVector<qint64>>::Error(
+        QString("直方图查询失败: %1").arg(query.lastError().text()));
+  }
+
+  QVector<qint64> counts(bins, 0);
+  const double scale = bins / (hi - lo);
+  while (query.next()) {
+    const SampleType type = static_cast<SampleType>(query.value(0).toInt());
+    const int n = query.value(1).toInt();
+
+    if (query.value(6).isNull()) {
+      // 常量块：全部有效样本落入同一个桶
+      const double v = query.value(3).toDouble();
+      const int bin = qMin(bins - 1, static_cast<int>((v - lo) * scale));
+      counts[bin] += n - query.value(2).toInt();
+      continue;
+    }
+
+    const QByteArray data = query.value(6).toByteArray();
+    if (!chunkDataMatches(type, data, n)) {
+      return DbResult<QVector<qint64>>::Error("数据块长度与样本数不一致");
+    }
+    if (type == SampleType::FLOAT32) {
+      SimdKernels::histogram(reinterpret_cast<const float*>(data.constData()),
+                             n, lo, hi, bins, counts.data());
+    } else {
+      SimdKernels::histogram(reinterpret_cast<const double*>(data.constData()),
+                             n, lo, hi, bins, counts.data());
+    }
+  }
+
+  return DbResult<QVector<qint64>>::Success(std::move(counts));
+}
+
+DbResult<int> ExperimentDataTable::deleteSeries(int experimentId,
+                                                const QString& series) {
+  if (!m_ops) {
+    return DbResult<int>::Error("实验数据表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) return DbResult<int>::Error("数据库未打开");
+
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+  QSqlQuery query(c.db);
+  query.prepare(DELETE_SERIES_SQL);
+  query.addBindValue(experimentId);
+  query.addBindValue(series);
+  if (!SqlExec::run(query)) {
+    QString error = QString("删除序列失败: %1").arg(query.lastError().text());
+    m_ops->logOperation("删除失败", error);
+    emit m_ops->databaseError(error);
+    return DbResult<int>::Error(error);
+  }
+
+  const int removed = query.numRowsAffected();
+  m_ops->logOperation("删除序列成功",
+                      QString("序列 %1 删除 %2 块").arg(series).arg(removed));
+  return DbResult<int>::Success(removed);
+}
+
+DbResult<QStringList> ExperimentDataTable::seriesNames(
+    int experimentId) const {
+  if (!m_ops) {
+    return DbResult<QStringList>::Error("实验数据表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) return DbResult<QStringList>::Error("数据库未打开");
+
+  QSqlQuery query(c.db);
+  query.setForwardOnly(true);
+  query.prepare(SELECT_SERIES_SQL);
+  query.addBindValue(experimentId);
+  if (!SqlExec::run(query)) {
+    return DbResult<QStringList>::Error(
+        QString("查询序列失败: %1").arg(query.lastError().text()));
+  }
+
+  QStringList names;
+  while (query.next()) names.append(query.value(0).toString());
+  return DbResult<QStringList>::Success(std::move(names));
+}
+
+ExperimentDataChunk ExperimentDataTable::buildChunk(const QSqlQuery& query,
+                                                    bool withData) const {
+  ExperimentDataChunk chunk;
+
+  chunk.id = query.value(0).toInt();
+  chunk.experimentId = query.value(1).toInt();
+  chunk.series = query.value(2).toString();
+  chunk.chunkIndex = query.value(3).toInt();
+  chunk.sampleType = static_cast<SampleType>(query.value(4).toInt());
+  chunk.sampleCount = query.value(5).toInt();
+  chunk.nanCount = query.value(6).toInt();
+  chunk.minValue = query.value(7).toDouble();
+  chunk.maxValue = query.value(8).toDouble();
+  chunk.sumValue = query.value(9).toDouble();
+  chunk.createdAt = query.value(10).toDateTime();
+  if (withData) chunk.data = query.value(11).toByteArray();
+
+  return chunk;
+}
@@ -0,0 +1,256 @@
+﻿#ifndef EXPERIMENTDATATABLE_H
+#define EXPERIMENTDATATABLE_H
+
+#include <QPointer>
+#include <limits>
+
+#include "BaseDatabaseManager.h"
+#include "ExperimentDataBaseStruct.h"
+#include "QueryPlanChecker.h"
+
+// ============================================================================
+// 实验数据表操作类
+// ============================================================================
+
+/**
+ * @brief 实验数据表操作类
+ * 继承自BaseTableOperations并实现createTable方法
+ */
+class ExperimentDataTableOperations : public BaseTableOperations {
+  Q_OBJECT
+ public:
+  explicit ExperimentDataTableOperations(QSqlDatabase* db,
+                                         ConnectionPool* pool);
+  ~ExperimentDataTableOperations() override = default;
+
+  bool createTable() override;
+
+ private:
+  static const QString CREATE_TABLE_SQL;
+};
+
+/**
+ * @brief 实验数据表业务逻辑类
+ * 数值序列按固定样本数切块、以类型化数组存储，每块带区间索引；
+ * 区间过滤先用区间索引跳过或整块作答，其余块解码后用向量化内核聚合
+ */
+class ExperimentDataTable : public BaseTable<ExperimentDataChunk> {
+ public:
+  static constexpr int kChunkSamples = 16384;  ///< 每块样本数
+
+ private:
+  // SQL语句常量
+  static const QString INSERT_SQL;
+  static const QString UPDATE_SQL;
+  static const QString DELETE_SQL;
+  static const QString SELECT_BY_ID_SQL;
+  static const QString SELECT_ALL_SQL;
+  static const QString SELECT_TAIL_SQL;
+  static const QString SELECT_RANGE_SQL;
+  static const QString AGGREGATE_SQL;
+  static const QString HISTOGRAM_SQL;
+  static const QString COUNT_CHUNKS_SQL;
+  static const QString DELETE_SERIES_SQL;
+  static const QString SELECT_SERIES_SQL;
+
+  QPointer<ExperimentDataTableOperations> m_ops;  ///< 安全弱引用，避免悬空
+
+ public:
+  /**
+   * @brief 构造函数
+   * @param db 数据库连接指针
+   * @param pool 连接池
+   */
+  explicit ExperimentDataTable(QSqlDatabase* db, ConnectionPool* pool);
+
+  /**
+   * @brief 析构函数
+   */
+  ~ExperimentDataTable() override;
+
+  // ========================================================================
+  // 实现BaseTable虚函数（按块）
+  // ========================================================================
+
+  /**
+   * @brief 插入数据块（区间索引由数据重新计算）
+   * @param chunk 数据块
+   * @return 操作结果，包含新块ID
+   */
+  DbResult<int> insert(const ExperimentDataChunk& chunk) override;
+
+  /**
+   * @brief 更新数据块（区间索引由数据重新计算）
+   * @param chunk 数据块
+   * @return 操作结果
+   */
+  DbResult<bool> update(const ExperimentDataChunk& chunk) override;
+
+  /**
+   * @brief 删除数据块
+   * @param id 块ID
+   * @return 操作结果
+   */
+  DbResult<bool> deleteById(int id) override;
+
+  /**
+   * @brief 根据ID查询数据块（含样本数据）
+   * @param id 块ID
+   * @return 操作结果，包含数据块
+   */
+  DbResult<ExperimentDataChunk> selectById(int id) const override;
+
+  /**
+   * @brief 查询所有数据块的区间索引（不含样本数据）
+   * @return 操作结果，包含数据块列表
+   */
+  DbResult<QList<ExperimentDataChunk>> selectAll() const override;
+
+  /**
+   * @brief 分页查询数据块的区间索引（不含样本数据）
+   * @param params 分页参数
+   * @return 操作结果，包含分页结果
+   */
+  DbResult<PageResult<ExperimentDataChunk>> selectByPage(
+      const PageParams& params) const override;
+
+  /**
+   * @brief 批量插入数据块（单事务）
+   * @param chunks 数据块列表
+   * @return 操作结果，包含成功插入的块数
+   */
+  DbResult<int> batchInsert(const QList<ExperimentDataChunk>& chunks) override;
+
+  // ========================================================================
+  // 序列操作
+  // ========================================================================
+
+  /**
+   * @brief 追加单精度样本（先填满尾块，再按固定大小切新块）
+   * @param experimentId 实验ID
+   * @param series 序列名
+   * @param samples 样本
+   * @return 操作结果，包含追加的样本数
+   */
+  DbResult<qint64> appendSamples(int experimentId, const QString& series,
+                                 const QVector<float>& samples);
+
+  /**
+   * @brief 追加双精度样本（先填满尾块，再按固定大小切新块）
+   * @param experimentId 实验ID
+   * @param series 序列名
+   * @param samples 样本
+   * @return 操作结果，包含追加的样本数
+   */
+  DbResult<qint64> appendSamples(int experimentId, const QString& series,
+                                 const QVector<double>& samples);
+
+  /**
+   * @brief 读取序列的一段样本（只读取覆盖该段的块）
+   * @param experimentId 实验ID
+   * @param series 序列名
+   * @param offset 起始样本序号
+   * @param count 样本数（-1表示到末尾）
+   * @return 操作结果，包含样本（统一为双精度）
+   */
+  DbResult<QVector<double>> readSamples(int experimentId, const QString& series,
+                                        qint64 offset = 0,
+                                        qint64 count = -1) const;
+
+  /**
+   * @brief 区间聚合：统计值落在 [lo, hi] 内样本的个数、和、最值
+   * @param experimentId 实验ID
+   * @param series 序列名
+   * @param lo 下界（含）
+   * @param hi 上界（含）
+   * @return 操作结果，包含聚合结果与块跳过统计
+   */
+  DbResult<SeriesAggregate> aggregate(
+      int experimentId, const QString& series,
+      double lo = -std::numeric_limits<double>::infinity(),
+      double hi = std::numeric_limits<double>::infinity()) const;
+
+  /**
+   * @brief 等宽直方图
+   * @param experimentId 实验ID
+   * @param series 序列名
+   * @param lo 下界（含）
+   * @param hi 上界（含，归入最后一个桶）
+   * @param bins 桶数
+   * @return 操作结果，包含各桶计数
+   */
+  DbResult<QVector<qint64>> histogram(int experimentId, const QString& series,
+                                      double lo, double hi, int bins) const;
+
+  /**
+   * @brief 删除整个序列
+   * @param experimentId 实验ID
+   * @param series 序列名
+   * @return 操作结果，包含删除的块数
+   */
+  DbResult<int> deleteSeries(int experimentId, const QString& series);
+
+  /**
+   * @brief 查询实验下的序列名
+   * @param experimentId 实验ID
+   * @return 操作结果，包含序列名列表
+   */
+  DbResult<QStringList> seriesNames(int experimentId) const;
+
+  /**
+   * @brief 由样本数据计算块的样本数与区间索引
+   * @param chunk 数据块（data与sampleType须已设置）
+   */
+  static void computeZoneMap(ExperimentDataChunk& chunk);
+
+  /**
+   * @brief 获取基础操作对象
+   * @return 基础操作对象指针
+   */
+  ExperimentDataTableOperations* operations() const { return m_ops.data(); }
+
+  /**
+   * @brief 各SQL语句的查询计划期望（供 QueryPlanChecker 回归检查）
+   * @return 期望列表
+   */
+  static QList<PlanExpectation> planExpectations();
+
+ private:
+  /**
+   * @brief 追加已编码样本（单事务）
+   */
+  DbResult<qint64> appendEncoded(int experimentId, const QString& series,
+                                 SampleType type, const char* bytes,
+                                 qint64 count);
+
+  /**
+   * @brief 在给定连接上插入数据块（调用方持锁）
+   */
+  DbResult<int> insertChunk(QSqlDatabase& db,
+                            const ExperimentDataChunk& chunk);
+
+  /**
+   * @brief 从查询结果构建数据块（区间索引列）
+   * @param query SQL查询对象
+   * @param withData 是否读取样本数据列
+   * @return 数据块
+   */
+  ExperimentDataChunk buildChunk(const QSqlQuery& query, bool withData) const;
+
+  /**
+   * @brief 生成分页查询SQL
+   * @param params 分页参数（排序列经 sanitizeOrderBy 过滤）
+   * @return SQL语句
+   */
+  static QString selectByPageSql(const PageParams& params);
+
+  static inline QString sanitizeOrderBy(const QString& col) {
+    static const QSet<QString> k = {"id",          "experiment_id",
+                                    "series",      "chunk_index",
+                                    "sample_count", "min_value",
+                                    "max_value",   "created_at"};
+    return k.contains(col) ? col : "id";
+  }
+};
+
+#endif  // EXPERIMENTDATATABLE_H
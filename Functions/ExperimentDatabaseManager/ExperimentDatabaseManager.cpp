@@ -0,0 +1,61 @@
+﻿// ============================================================================
+// ExperimentDatabaseManager.cpp - 实现文件
+// ============================================================================
+
+#include "ExperimentDatabaseManager.h"
+
+#include "ExperimentDataTable.h"
+#include "ImageDataTable.h"
+
+// ============================================================================
+// ExperimentDatabaseManager实现
+// ============================================================================
+
+ExperimentDatabaseManager::ExperimentDatabaseManager(
+    const DatabaseConfig& config, QObject* parent)
+    : BaseDatabaseManager(DatabaseType::EXPERIMENT_DB, config, parent) {
+  qInfo() << "创建实验项目数据库管理器";
+}
+
+void ExperimentDatabaseManager::close() {
+  m_imageDataTable.reset();  // 先释放业务表，避免悬空
+  m_experimentDataTable.reset();
+  BaseDatabaseManager::close();  // 再做通用清理
+}
+
+QString ExperimentDatabaseManager::imageStorePath() const {
+  QFileInfo info(m_config.filePath);
+  return info.absoluteDir().absoluteFilePath(info.completeBaseName() +
+                                             "_images");
+}
+
+void ExperimentDatabaseManager::registerTables() {
+  m_imageDataTable = std::make_unique<ImageDataTable>(
+      &m_database, m_connectionPool.get(), imageStorePath());
+
+  connect(m_imageDataTable->operations(), &BaseTableOperations::databaseError,
+          this, &ExperimentDatabaseManager::databaseError);
+
+  // 交给基类接管“所有权”（唯一所有者）
+  registerTable(TableType::IMAGE_DATA, std::unique_ptr<ITableOperations>(
+                                           m_imageDataTable->operations()));
+
+  m_experimentDataTable = std::make_unique<ExperimentDataTable>(
+      &m_database, m_connectionPool.get());
+
+  connect(m_experimentDataTable->operations(),
+          &BaseTableOperations::databaseError, this,
+          &ExperimentDatabaseManager::databaseError);
+
+  registerTable(
+      TableType::EXPERIMENT_DATA,
+      std::unique_ptr<ITableOperations>(m_experimentDataTable->operations()));
+}
+
+ImageDataTable* ExperimentDatabaseManager::imageDataTable() const {
+  return m_imageDataTable.get();
+}
+
+ExperimentDataTable* ExperimentDatabaseManager::experimentDataTable() const {
+  return m_experimentDataTable.get();
+}
@@ -0,0 +1,73 @@
+﻿// ExperimentDatabaseManager.h - 实验项目数据库管理器
+#ifndef EXPERIMENT_DATABASE_MANAGER_H
+#define EXPERIMENT_DATABASE_MANAGER_H
+
+#include "BaseDatabaseManager.h"
+#include "DatabaseFramework.h"
+#include "ExperimentDataBaseStruct.h"
+
+class ExperimentDataTable;
+class ImageDataTable;
+
+// ============================================================================
+// 实验项目数据库管理器
+// ============================================================================
+
+/**
+ * @brief 实验项目数据库管理器
+ * 管理图像数据、实验数据等表；图像像素存放在数据库文件旁的内容存储目录
+ */
+class ExperimentDatabaseManager : public BaseDatabaseManager {
+  Q_OBJECT
+
+ private:
+  std::unique_ptr<ImageDataTable> m_imageDataTable;  ///< 图像数据表
+  std::unique_ptr<ExperimentDataTable> m_experimentDataTable;  ///< 实验数据表
+
+ public:
+  /**
+   * @brief 构造函数
+   * @param config 数据库配置
+   * @param parent 父对象
+   */
+  explicit ExperimentDatabaseManager(const DatabaseConfig& config,
+                                     QObject* parent = nullptr);
+
+  /**
+   * @brief 析构函数
+   */
+  ~ExperimentDatabaseManager() override = default;
+
+  void close() override;
+
+  // ========================================================================
+  // 表访问器
+  // ========================================================================
+
+  /**
+   * @brief 获取图像数据表操作对象
+   * @return 图像数据表指针
+   */
+  ImageDataTable* imageDataTable() const;
+
+  /**
+   * @brief 获取实验数据表操作对象
+   * @return 实验数据表指针
+   */
+  ExperimentDataTable* experimentDataTable() const;
+
+  /**
+   * @brief 图像像素存储目录（<数据库文件名>_images）
+   * @return 目录路径
+   */
+  QString imageStorePath() const;
+
+ protected:
+  /**
+   * @brief 注册所有表
+   * 实现基类纯虚函数
+   */
+  void registerTables() override;
+};
+
+#endif  // EXPERIMENT_DATABASE_MANAGER_H
@@ -0,0 +1,662 @@
+﻿#include "ImageDataTable.h"
+
+#include <QSet>
+
+#include "AuditTrail.h"
+#include "WorkloadCapture.h"
+
+// ============================================================================
+// ImageDataTable SQL语句常量定义
+// ============================================================================
+
+const QString ImageDataTable::INSERT_SQL = R"(
+    INSERT INTO image_data (experiment_id, name, width, height, channels,
+                            bit_depth, pixel_format, byte_size, content_hash,
+                            captured_at, created_at)
+    VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+)";
+
+const QString ImageDataTable::UPDATE_SQL = R"(
+    UPDATE image_data
+    SET experiment_id = ?, name = ?, width = ?, height = ?, channels = ?,
+        bit_depth = ?, pixel_format = ?, byte_size = ?, content_hash = ?,
+        captured_at = ?
+    WHERE id = ?
+)";
+
+const QString ImageDataTable::DELETE_SQL = R"(
+    DELETE FROM image_data WHERE id = ?
+)";
+
+const QString ImageDataTable::SELECT_BY_ID_SQL = R"(
+    SELECT id, experiment_id, name, width, height, channels, bit_depth,
+           pixel_format, byte_size, content_hash, captured_at, created_at
+    FROM image_data WHERE id = ?
+)";
+
+const QString ImageDataTable::SELECT_ALL_SQL = R"(
+    SELECT id, experiment_id, name, width, height, channels, bit_depth,
+           pixel_format, byte_size, content_hash, captured_at, created_at
+    FROM image_data ORDER BY id
+)";
+
+const QString ImageDataTable::SELECT_BY_EXPERIMENT_SQL = R"(
+    SELECT id, experiment_id, name, width, height, channels, bit_depth,
+           pixel_format, byte_size, content_hash, captured_at, created_at
+    FROM image_data WHERE experiment_id = ? ORDER BY captured_at, id
+)";
+
+const QString ImageDataTable::SELECT_HASH_BY_ID_SQL = R"(
+    SELECT content_hash FROM image_data WHERE id = ?
+)";
+
+const QString ImageDataTable::COUNT_HASH_REFS_SQL = R"(
+    SELECT COUNT(*) FROM image_data WHERE content_hash = ?
+)";
+
+const QVector<ColumnSpec> ImageDataTable::QUERY_COLUMNS = {
+    {"id", ColumnType::INTEGER},
+    {"experiment_id", ColumnType::INTEGER},
+    {"name", ColumnType::TEXT},
+    {"width", ColumnType::INTEGER},
+    {"height", ColumnType::INTEGER},
+    {"channels", ColumnType::INTEGER},
+    {"bit_depth", ColumnType::INTEGER},
+    {"pixel_format", ColumnType::TEXT},
+    {"byte_size", ColumnType::INTEGER},
+    {"content_hash", ColumnType::TEXT},
+    {"captured_at", ColumnType::DATETIME},
+    {"created_at", ColumnType::DATETIME}};
+
+QList<PlanExpectation> ImageDataTable::planExpectations() {
+  const QString pk = "INTEGER PRIMARY KEY";
+  QList<PlanExpectation> list = {
+      {"ImageDataTable::SELECT_BY_ID_SQL", SELECT_BY_ID_SQL, {pk}},
+      {"ImageDataTable::UPDATE_SQL", UPDATE_SQL, {pk}},
+      {"ImageDataTable::DELETE_SQL", DELETE_SQL, {pk}},
+      {"ImageDataTable::SELECT_HASH_BY_ID_SQL", SELECT_HASH_BY_ID_SQL, {pk}},
+      {"ImageDataTable::SELECT_BY_EXPERIMENT_SQL", SELECT_BY_EXPERIMENT_SQL,
+       {"idx_image_data_experiment"}},
+      {"ImageDataTable::COUNT_HASH_REFS_SQL", COUNT_HASH_REFS_SQL,
+       {"idx_image_data_hash"}},
+      {"ImageDataTable::SELECT_ALL_SQL", SELECT_ALL_SQL, {}, true},
+      {"ImageDataTable::selectByIds",
+       TableQuery("image_data", QUERY_COLUMNS).whereIn("id", {1, 2, 3}).sql(),
+       {pk}}};
+
+  // 分页按主键或实验索引顺序扫描，不得额外排序
+  for (bool ascending : {true, false}) {
+    const QString dir = ascending ? "ASC" : "DESC";
+    list.append({QString("ImageDataTable::selectByPage(id %1)").arg(dir),
+                 selectByPageSql(PageParams{3, 50, "id", ascending}),
+                 {},
+                 true});
+    list.append(
+        {QString("ImageDataTable::selectByPage(experiment_id %1)").arg(dir),
+         selectByPageSql(PageParams{3, 50, "experiment_id", ascending}),
+         {"idx_image_data_experiment"},
+         true});
+  }
+  return list;
+}
+
+// ============================================================================
+// ImageDataTableOperations 实现
+// ============================================================================
+
+const QString ImageDataTableOperations::CREATE_TABLE_SQL = R"(
+  CREATE TABLE IF NOT EXISTS image_data (
+    id INTEGER PRIMARY KEY AUTOINCREMENT,
+    experiment_id INTEGER,
+    name TEXT NOT NULL,
+    width INTEGER NOT NULL CHECK(width > 0),
+    height INTEGER NOT NULL CHECK(height > 0),
+    channels INTEGER NOT NULL DEFAULT 1,
+    bit_depth INTEGER NOT NULL DEFAULT 8,
+    pixel_format TEXT,
+    byte_size INTEGER NOT NULL,
+    content_hash TEXT NOT NULL CHECK(length(content_hash) = 64),
+    captured_at DATETIME,
+    created_at DATETIME DEFAULT CURRENT_TIMESTAMP
+  )
+)";
+
+ImageDataTableOperations::ImageDataTableOperations(QSqlDatabase* db,
+                                                   ConnectionPool* pool)
+    : BaseTableOperations(db, "image_data", TableType::IMAGE_DATA, pool,
+                          nullptr) {}
+
+bool ImageDataTableOperations::createTable() {
+  ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
+
+  auto c = acquireDb();
+  if (!c.db.isOpen()) {
+    qCritical() << "数据库连接未打开!";
+    return false;
+  }
+
+  QSqlQuery query(c.db);
+  if (!query.exec(CREATE_TABLE_SQL)) {
+    QString error = query.lastError().text();
+    qCritical() << "创建图像数据表失败:" << error;
+    logOperation("创建表失败", error);
+    return false;
+  }
+
+  query.exec(
+      "CREATE INDEX IF NOT EXISTS idx_image_data_experiment ON "
+      "image_data(experiment_id, captured_at)");
+  query.exec(
+      "CREATE INDEX IF NOT EXISTS idx_image_data_hash ON "
+      "image_data(content_hash)");
+
+  logOperation("创建表成功", m_tableName);
+  return true;
+}
+
+// ============================================================================
+// ImageStreamWriter实现
+// ============================================================================
+
+DbResult<int> ImageStreamWriter::commit() {
+  if (!m_table) {
+    return DbResult<int>::Error("图像写入器无效");
+  }
+  return m_table->commitImage(m_image, m_writer);
+}
+
+// ============================================================================
+// ImageDataTable实现
+// ============================================================================
+
+ImageDataTable::ImageDataTable(QSqlDatabase* db, ConnectionPool* pool,
+                               const QString& storeRoot)
+    : BaseTable<ImageData>(nullptr), m_store(storeRoot) {
+  m_ops = new ImageDataTableOperations(db, pool);
+  m_baseOps = m_ops;
+  if (!m_store.open()) {
+    m_ops->logOperation("打开像素存储失败", storeRoot);
+  }
+}
+
+ImageDataTable::~ImageDataTable() { m_baseOps = nullptr; }
+
+DbResult<int> ImageDataTable::insertRow(QSqlDatabase& db,
+                                        const ImageData& image) {
+  QSqlQuery query(db);
+  query.prepare(INSERT_SQL);
+  query.addBindValue(image.experimentId > 0 ? QVariant(image.experimentId)
+                                            : QVariant());
+  query.addBindValue(image.name);
+  query.addBindValue(image.width);
+  query.addBindValue(image.height);
+  query.addBindValue(image.channels);
+  query.addBindValue(image.bitDepth);
+  query.addBindValue(image.pixelFormat);
+  query.addBindValue(image.byteSize);
+  query.addBindValue(image.contentHash);
+  query.addBindValue(image.capturedAt);
+  query.addBindValue(QDateTime::currentDateTime());
+
+  if (!SqlExec::run(query)) {
+    QString error =
+        QString("插入图像元数据失败: %1").arg(query.lastError().text());
+    m_ops->logOperation("插入失败", error);
+    emit m_ops->databaseError(error);
+    return DbResult<int>::Error(error);
+  }
+
+  const int newId = query.lastInsertId().toInt();
+  m_ops->logOperation(
+      "插入成功", QString("新图像ID: %1, 内容: %2").arg(newId).arg(
+                      image.contentHash.left(12)));
+  emit m_ops->recordInserted(newId);
+  return DbResult<int>::Success(newId);
+}
+
+void ImageDataTable::releaseContentAfterCommit(const QString& hash) {
+  if (hash.isEmpty()) return;
+  m_ops->afterCommit([this, hash]() { releaseContentIfUnreferenced(hash); });
+}
+
+void ImageDataTable::releaseContentIfUnreferenced(const QString& hash) {
+  if (!m_ops) return;
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) return;  // 保守保留，留给 purgeOrphanContent() 回收
+
+  // 与 commitImage 同锁：引用计数与删除之间不会有新行引用该内容
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+  QSqlQuery query(c.db);
+  query.prepare(COUNT_HASH_REFS_SQL);
+  query.addBindValue(hash);
+  if (!SqlExec::run(query) || !query.next()) return;  // 查询失败时保守保留内容
+
+  if (query.value(0).toInt() == 0 && !m_store.remove(hash)) {
+    // 仍被映射（Windows）时删除失败，留给 purgeOrphanContent() 回收
+    m_ops->logOperation("回收像素内容失败", hash);
+  }
+}
+
+DbResult<int> ImageDataTable::commitImage(ImageData image,
+                                          ContentWriter& writer) {
+  if (!m_ops) {
+    writer.abort();
+    return DbResult<int>::Error("图像数据表未初始化或已释放");
+  }
+  if (!image.isValid()) {
+    writer.abort();
+    return DbResult<int>::Error("图像元数据无效");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    writer.abort();
+    return DbResult<int>::Error("数据库未打开");
+  }
+
+  // 内容改名入库与元数据插入在同一把锁内，避免被并发的删除回收
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+  bool existed = false;
+  image.byteSize = writer.bytesWritten();
+  image.contentHash = writer.commit(&existed);
+  if (image.contentHash.isEmpty()) {
+    return DbResult<int>::Error(
+        QString("写入像素数据失败: %1").arg(writer.errorString()));
+  }
+
+  auto result = insertRow(c.db, image);
+  if (!result.success && !existed) {
+    m_store.remove(image.contentHash);  // 新内容无人引用，立即撤回
+  }
+  return result;
+}
+
+DbResult<int> ImageDataTable::insert(const ImageData& image) {
+  if (!m_ops) {
+    return DbResult<int>::Error("图像数据表未初始化或已释放");
+  }
+  if (!image.isValid()) {
+    return DbResult<int>::Error("图像元数据无效");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<int>::Error("数据库未打开");
+  }
+
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+  if (!m_store.contains(image.contentHash)) {
+    return DbResult<int>::Error(
+        QString("像素内容不存在: %1").arg(image.contentHash));
+  }
+
+  ImageData row = image;
+  row.byteSize = m_store.sizeOf(image.contentHash);
+  return insertRow(c.db, row);
+}
+
+DbResult<bool> ImageDataTable::update(const ImageData& image) {
+  if (!m_ops) {
+    return DbResult<bool>::Error("图像数据表未初始化或已释放");
+  }
+  if (image.id <= 0) {
+    return DbResult<bool>::Error("无效的图像ID");
+  }
+  if (!image.isValid()) {
+    return DbResult<bool>::Error("图像元数据无效");
+  }
+
+  QString oldHash;
+  {
+    auto c = m_ops->acquireDb();
+    if (!c.db.isOpen()) return DbResult<bool>::Error("数据库未打开");
+
+    ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+    if (!m_store.contains(image.contentHash)) {
+      return DbResult<bool>::Error(
+          QString("像素内容不存在: %1").arg(image.contentHash));
+    }
+
+    QSqlQuery query(c.db);
+    query.prepare(SELECT_HASH_BY_ID_SQL);
+    query.addBindValue(image.id);
+    if (!SqlExec::run(query) || !query.next()) {
+      return DbResult<bool>::Error("未找到指定的图像", DbErrorCode::NOT_FOUND);
+    }
+    oldHash = query.value(0).toString();
+    query.finish();
+
+    query.prepare(UPDATE_SQL);
+    query.addBindValue(image.experimentId > 0 ? QVariant(image.experimentId)
+                                              : QVariant());
+    query.addBindValue(image.name);
+    query.addBindValue(image.width);
+    query.addBindValue(image.height);
+    query.addBindValue(image.channels);
+    query.addBindValue(image.bitDepth);
+    query.addBindValue(image.pixelFormat);
+    query.addBindValue(m_store.sizeOf(image.contentHash));
+    query.addBindValue(image.contentHash);
+    query.addBindValue(image.capturedAt);
+    query.addBindValue(image.id);
+
+    if (!SqlExec::run(query)) {
+      QString error =
+          QString("更新图像元数据失败: %1").arg(query.lastError().text());
+      m_ops->logOperation("更新失败", error);
+      emit m_ops->databaseError(error);
+      return DbResult<bool>::Error(error);
+    }
+
+    m_ops->logOperation("更新成功", QString("图像ID: %1").arg(image.id));
+    emit m_ops->recordUpdated(image.id);
+  }
+
+  // 旧内容在更新持久提交后才回收：回滚会恢复对它的引用
+  if (oldHash != image.contentHash) releaseContentAfterCommit(oldHash);
+  return DbResult<bool>::Success(true);
+}
+
+DbResult<bool> ImageDataTable::deleteById(int id) {
+  if (!m_ops) {
+    return DbResult<bool>::Error("图像数据表未初始化或已释放");
+  }
+  if (id <= 0) {
+    return DbResult<bool>::Error("无效的图像ID");
+  }
+
+  QString hash;
+  {
+    auto c = m_ops->acquireDb();
+    if (!c.db.isOpen()) return DbResult<bool>::Error("数据库未打开");
+
+    ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+    QSqlQuery query(c.db);
+    query.prepare(SELECT_HASH_BY_ID_SQL);
+    query.addBindValue(id);
+    if (!SqlExec::run(query) || !query.next()) {
+      return DbResult<bool>::Error("未找到要删除的图像",
+                                   DbErrorCode::NOT_FOUND);
+    }
+    hash = query.value(0).toString();
+    query.finish();
+
+    query.prepare(DELETE_SQL);
+    query.addBindValue(id);
+    if (!SqlExec::run(query)) {
+      QString error =
+          QString("删除图像失败: %1").arg(query.lastError().text());
+      m_ops->logOperation("删除失败", error);
+      emit m_ops->databaseError(error);
+      return DbResult<bool>::Error(error);
+    }
+
+    m_ops->logOperation("删除成功", QString("图像ID: %1").arg(id));
+    emit m_ops->recordDeleted(id);
+  }
+
+  // 删除持久提交后才回收内容：回滚会恢复该行
+  releaseContentAfterCommit(hash);
+  return DbResult<bool>::Success(true);
+}
+
+DbResult<ImageData> ImageDataTable::selectById(int id) const {
+  if (!m_ops) {
+    return DbResult<ImageData>::Error("图像数据表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) return DbResult<ImageData>::Error("数据库未打开");
+
+  QSqlQuery query(c.db);
+  query.prepare(SELECT_BY_ID_SQL);
+  query.addBindValue(id);
+
+  if (!SqlExec::run(query)) {
+    return DbResult<ImageData>::Error(
+        QString("查询图像失败: %1").arg(query.lastError().text()));
+  }
+  if (query.next()) {
+    return DbResult<ImageData>::Success(buildImageData(query));
+  }
+  return DbResult<ImageData>::Error("未找到指定的图像", DbErrorCode::NOT_FOUND);
+}
+
+DbResult<QHash<int, ImageData>> ImageDataTable::selectByIds(
+    const QList<int>& ids) const {
+  if (!m_ops) {
+    return DbResult<QHash<int, ImageData>>::Error(
+        "图像数据表未初始化或已释放");
+  }
+  return selectRowsByIds(ids);
+}
+
+DbResult<QList<ImageData>> ImageDataTable::selectAll() const {
+  if (!m_ops) {
+    return DbResult<QList<ImageData>>::Error("图像数据表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<QList<ImageData>>::Error("数据库未打开");
+  }
+
+  QSqlQuery query(c.db);
+  query.setForwardOnly(true);
+  if (!SqlExec::run(query, SELECT_ALL_SQL)) {
+    return DbResult<QList<ImageData>>::Error(
+        QString("查询图像失败: %1").arg(query.lastError().text()));
+  }
+
+  QList<ImageData> images;
+  while (query.next()) images.append(buildImageData(query));
+  return DbResult<QList<ImageData>>::Success(std::move(images));
+}
+
+QString ImageDataTable::selectByPageSql(const PageParams& params) {
+  QString orderBy =
+      params.orderBy.isEmpty() ? "id" : sanitizeOrderBy(params.orderBy);
+  return QString(
+             "SELECT id, experiment_id, name, width, height, channels, "
+             "bit_depth, pixel_format, byte_size, content_hash, captured_at, "
+             "created_at FROM image_data ORDER BY %1 %2 LIMIT %3 OFFSET %4")
+      .arg(orderBy)
+      .arg(params.ascending ? "ASC" : "DESC")
+      .arg(params.pageSize)
+      .arg(params.offset());
+}
+
+DbResult<PageResult<ImageData>> ImageDataTable::selectByPage(
+    const PageParams& params) const {
+  if (!m_ops) {
+    return DbResult<PageResult<ImageData>>::Error(
+        "图像数据表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<PageResult<ImageData>>::Error("数据库未打开");
+  }
+
+  int total = m_ops->getTotalCount();
+
+  QSqlQuery query(c.db);
+  query.setForwardOnly(true);
+  if (!SqlExec::run(query, selectByPageSql(params))) {
+    return DbResult<PageResult<ImageData>>::Error(
+        QString("分页查询图像失败: %1").arg(query.lastError().text()));
+  }
+
+  QList<ImageData> list;
+  while (query.next()) list.append(buildImageData(query));
+  return DbResult<PageResult<ImageData>>::Success(
+      PageResult<ImageData>(std::move(list), total, params));
+}
+
+DbResult<QList<ImageData>> ImageDataTable::select(
+    const TableQuery& query) const {
+  if (!m_ops) {
+    return DbResult<QList<ImageData>>::Error("图像数据表未初始化或已释放");
+  }
+  return selectRows(query, [this](const QSqlQuery& row) {
+    return buildImageData(row);
+  });
+}
+
+DbResult<int> ImageDataTable::batchInsert(const QList<ImageData>& images) {
+  if (!m_ops) {
+    return DbResult<int>::Error("图像数据表未初始化或已释放");
+  }
+  if (images.isEmpty()) {
+    return DbResult<int>::Error("图像列表为空");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) return DbResult<int>::Error("数据库未打开");
+
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+  for (const ImageData& image : images) {
+    if (!image.isValid() || !m_store.contains(image.contentHash)) {
+      return DbResult<int>::Error(
+          QString("图像 '%1' 元数据无效或像素内容不存在").arg(image.name));
+    }
+  }
+
+  if (!SqlExec::begin(c.db)) {
+    return DbResult<int>::Error("无法开启事务");
+  }
+  AuditTrail::DeferredScope auditScope(m_ops->m_database);
+
+  int count = 0;
+  for (const ImageData& image : images) {
+    ImageData row = image;
+    row.byteSize = m_store.sizeOf(image.contentHash);
+    auto r = insertRow(c.db, row);
+    if (!r.success) {
+      SqlExec::rollback(c.db);
+      return DbResult<int>::Error(
+          QString("批量插入图像失败: %1").arg(r.errorMessage));
+    }
+    ++count;
+  }
+
+  if (!SqlExec::commit(c.db)) {
+    SqlExec::rollback(c.db);
+    return DbResult<int>::Error("提交事务失败");
+  }
+  auditScope.commit();
+  return DbResult<int>::Success(count);
+}
+
+DbResult<int> ImageDataTable::insertImage(const ImageData& image,
+                                          const QByteArray& pixels) {
+  ContentWriter writer = m_store.writer();
+  if (!writer.write(pixels)) {
+    return DbResult<int>::Error(
+        QString("写入像素数据失败: %1").arg(writer.errorString()));
+  }
+  return commitImage(image, writer);
+}
+
+ImageStreamWriter ImageDataTable::beginImage(const ImageData& image) {
+  return ImageStreamWriter(this, image, m_store.writer());
+}
+
+DbResult<ContentView> ImageDataTable::openPixels(int id) const {
+  if (!m_ops) {
+    return DbResult<ContentView>::Error("图像数据表未初始化或已释放");
+  }
+
+  QString hash;
+  {
+    auto c = m_ops->acquireDb();
+    if (!c.db.isOpen()) return DbResult<ContentView>::Error("数据库未打开");
+
+    QSqlQuery query(c.db);
+    query.prepare(SELECT_HASH_BY_ID_SQL);
+    query.addBindValue(id);
+    if (!SqlExec::run(query) || !query.next()) {
+      return DbResult<ContentView>::Error(
+          "未找到指定的图像", DbErrorCode::NOT_FOUND);
+    }
+    hash = query.value(0).toString();
+  }
+
+  ContentView view = m_store.view(hash);
+  if (!view.isValid()) {
+    return DbResult<ContentView>::Error(
+        QString("映射像素数据失败: %1").arg(hash));
+  }
+  return DbResult<ContentView>::Success(std::move(view));
+}
+
+DbResult<QList<ImageData>> ImageDataTable::selectByExperiment(
+    int experimentId) const {
+  if (!m_ops) {
+    return DbResult<QList<ImageData>>::Error("图像数据表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<QList<ImageData>>::Error("数据库未打开");
+  }
+
+  QSqlQuery query(c.db);
+  query.setForwardOnly(true);
+  query.prepare(SELECT_BY_EXPERIMENT_SQL);
+  query.addBindValue(experimentId);
+  if (!SqlExec::run(query)) {
+    return DbResult<QList<ImageData>>::Error(
+        QString("查询实验图像失败: %1").arg(query.lastError().text()));
+  }
+
+  QList<ImageData> images;
+  while (query.next()) images.append(buildImageData(query));
+  return DbResult<QList<ImageData>>::Success(std::move(images));
+}
+
+int ImageDataTable::purgeOrphanContent() {
+  if (!m_ops) return 0;
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) return 0;
+
+  ProfiledMutexLocker locker(&m_ops->m_mutex, DB_LOCK_SITE);
+  QSqlQuery query(c.db);
+  query.setForwardOnly(true);
+  if (!SqlExec::run(query, "SELECT DISTINCT content_hash FROM image_data")) {
+    return 0;
+  }
+
+  QSet<QString> referenced;
+  while (query.next()) referenced.insert(query.value(0).toString());
+
+  int purged = 0;
+  for (const QString& digest : m_store.digests()) {
+    if (!referenced.contains(digest) && m_store.remove(digest)) ++purged;
+  }
+  if (purged > 0) {
+    m_ops->logOperation("回收孤立像素内容", QString::number(purged));
+  }
+  return purged;
+}
+
+ImageData ImageDataTable::buildImageData(const QSqlQuery& query) const {
+  ImageData image;
+
+  image.id = query.value(0).toInt();
+  image.experimentId =
+      query.value(1).isNull() ? -1 : query.value(1).toInt();
+  image.name = query.value(2).toString();
+  image.width = query.value(3).toInt();
+  image.height = query.value(4).toInt();
+  image.channels = query.value(5).toInt();
+  image.bitDepth = query.value(6).toInt();
+  image.pixelFormat = m_interner.intern(query.value(7));
+  image.byteSize = query.value(8).toLongLong();
+  image.contentHash = query.value(9).toString();
+  image.capturedAt = query.value(10).toDateTime();
+  image.createdAt = query.value(11).toDateTime();
+
+  return image;
+}
@@ -0,0 +1,299 @@
+﻿#ifndef IMAGEDATATABLE_H
+#define IMAGEDATATABLE_H
+
+#include <QPointer>
+
+#include "BaseDatabaseManager.h"
+#include "ContentAddressedStore.h"
+#include "ExperimentDataBaseStruct.h"
+#include "QueryPlanChecker.h"
+#include "StringInterner.h"
+
+class ImageDataTable;
+
+// ============================================================================
+// 图像数据表操作类
+// ============================================================================
+
+/**
+ * @brief 图像数据表操作类
+ * 继承自BaseTableOperations并实现createTable方法
+ */
+class ImageDataTableOperations : public BaseTableOperations {
+  Q_OBJECT
+ public:
+  explicit ImageDataTableOperations(QSqlDatabase* db, ConnectionPool* pool);
+  ~ImageDataTableOperations() override = default;
+
+  bool createTable() override;
+
+ private:
+  static const QString CREATE_TABLE_SQL;
+};
+
+/**
+ * @brief 图像流式写入器
+ * 像素按块写入内容存储（不经过QSqlQuery绑定，不在内存中拼整帧），
+ * commit() 时入库内容并写入元数据行；未提交即析构视为放弃
+ */
+class ImageStreamWriter {
+ public:
+  ImageStreamWriter(ImageStreamWriter&&) = default;
+  ImageStreamWriter& operator=(ImageStreamWriter&&) = default;
+  ~ImageStreamWriter() = default;
+
+  /**
+   * @brief 写入一块像素数据
+   * @param data 数据指针
+   * @param size 字节数
+   * @return 是否成功
+   */
+  bool write(const char* data, qint64 size) {
+    return m_writer.write(data, size);
+  }
+  bool write(const QByteArray& chunk) { return m_writer.write(chunk); }
+
+  /**
+   * @brief 已写入字节数
+   * @return 字节数
+   */
+  qint64 bytesWritten() const { return m_writer.bytesWritten(); }
+
+  /**
+   * @brief 提交像素并插入元数据
+   * @return 操作结果，包含新图像ID
+   */
+  DbResult<int> commit();
+
+  /**
+   * @brief 放弃本次写入
+   */
+  void abort() { m_writer.abort(); }
+
+ private:
+  friend class ImageDataTable;
+
+  ImageStreamWriter(ImageDataTable* table, const ImageData& image,
+                    ContentWriter&& writer)
+      : m_table(table), m_image(image), m_writer(std::move(writer)) {}
+
+  ImageDataTable* m_table;
+  ImageData m_image;
+  ContentWriter m_writer;
+};
+
+/**
+ * @brief 图像数据表业务逻辑类
+ * 元数据存于SQLite，像素存于数据库旁的内容寻址目录并按需映射读取；
+ * 同一像素内容只存一份，最后一条引用删除时回收
+ */
+class ImageDataTable : public BaseTable<ImageData> {
+ private:
+  // SQL语句常量
+  static const QString INSERT_SQL;
+  static const QString UPDATE_SQL;
+  static const QString DELETE_SQL;
+  static const QString SELECT_BY_ID_SQL;
+  static const QString SELECT_ALL_SQL;
+  static const QString SELECT_BY_EXPERIMENT_SQL;
+  static const QString SELECT_HASH_BY_ID_SQL;
+  static const QString COUNT_HASH_REFS_SQL;
+  static const QVector<ColumnSpec> QUERY_COLUMNS;  ///< 条件查询列白名单
+
+  QPointer<ImageDataTableOperations> m_ops;  ///< 安全弱引用，避免悬空
+  ContentAddressedStore m_store;             ///< 像素内容存储
+  mutable StringInterner m_interner;         ///< 低基数列驻留池
+
+ public:
+  /**
+   * @brief 构造函数
+   * @param db 数据库连接指针
+   * @param pool 连接池
+   * @param storeRoot 像素内容存储根目录
+   */
+  ImageDataTable(QSqlDatabase* db, ConnectionPool* pool,
+                 const QString& storeRoot);
+
+  /**
+   * @brief 析构函数
+   */
+  ~ImageDataTable() override;
+
+  // ========================================================================
+  // 实现BaseTable虚函数（仅元数据）
+  // ========================================================================
+
+  /**
+   * @brief 插入元数据行（像素内容须已在存储中）
+   * @param image 图像元数据
+   * @return 操作结果，包含新图像ID
+   */
+  DbResult<int> insert(const ImageData& image) override;
+
+  /**
+   * @brief 更新元数据；内容摘要变化时回收不再引用的旧内容
+   * @param image 图像元数据
+   * @return 操作结果
+   */
+  DbResult<bool> update(const ImageData& image) override;
+
+  /**
+   * @brief 删除图像；最后一条引用删除时回收像素内容
+   * @param id 图像ID
+   * @return 操作结果
+   */
+  DbResult<bool> deleteById(int id) override;
+
+  /**
+   * @brief 根据ID查询元数据（不读取像素）
+   * @param id 图像ID
+   * @return 操作结果，包含图像元数据
+   */
+  DbResult<ImageData> selectById(int id) const override;
+
+  /**
+   * @brief 按ID批量查询元数据（每批一条 id IN (...) 查询）
+   * @param ids 图像ID列表
+   * @return 操作结果，ID到元数据的映射
+   */
+  DbResult<QHash<int, ImageData>> selectByIds(
+      const QList<int>& ids) const override;
+
+  /**
+   * @brief 查询所有图像元数据
+   * @return 操作结果，包含元数据列表
+   */
+  DbResult<QList<ImageData>> selectAll() const override;
+
+  /**
+   * @brief 分页查询图像元数据
+   * @param params 分页参数
+   * @return 操作结果，包含分页结果
+   */
+  DbResult<PageResult<ImageData>> selectByPage(
+      const PageParams& params) const override;
+
+  /**
+   * @brief 条件查询允许的列（元数据全部列）
+   */
+  QVector<ColumnSpec> queryColumns() const override { return QUERY_COLUMNS; }
+
+  /**
+   * @brief 按条件查询元数据
+   * @param query 由 tableQuery() 创建的条件查询（不带投影）
+   * @return 操作结果，包含元数据列表
+   */
+  DbResult<QList<ImageData>> select(const TableQuery& query) const override;
+
+  /**
+   * @brief 批量插入元数据行（单事务）
+   * @param images 图像元数据列表
+   * @return 操作结果，包含成功插入的记录数
+   */
+  DbResult<int> batchInsert(const QList<ImageData>& images) override;
+
+  // ========================================================================
+  // 像素读写
+  // ========================================================================
+
+  /**
+   * @brief 写入一帧图像（像素写入存储，元数据入库）
+   * @param image 图像元数据
+   * @param pixels 像素数据
+   * @return 操作结果，包含新图像ID
+   */
+  DbResult<int> insertImage(const ImageData& image, const QByteArray& pixels);
+
+  /**
+   * @brief 开始流式写入一帧图像
+   * @param image 图像元数据
+   * @return 写入器
+   */
+  ImageStreamWriter beginImage(const ImageData& image);
+
+  /**
+   * @brief 以只读映射打开图像像素（零拷贝）
+   * @param id 图像ID
+   * @return 操作结果，包含像素视图
+   */
+  DbResult<ContentView> openPixels(int id) const;
+
+  /**
+   * @brief 查询某实验的图像元数据
+   * @param experimentId 实验ID
+   * @return 操作结果，包含元数据列表
+   */
+  DbResult<QList<ImageData>> selectByExperiment(int experimentId) const;
+
+  /**
+   * @brief 回收没有元数据引用的像素内容（异常退出后的补偿）
+   * @return 回收的对象数
+   */
+  int purgeOrphanContent();
+
+  /**
+   * @brief 获取像素内容存储
+   * @return 存储引用
+   */
+  const ContentAddressedStore& contentStore() const { return m_store; }
+
+  /**
+   * @brief 获取基础操作对象
+   * @return 基础操作对象指针
+   */
+  ImageDataTableOperations* operations() const { return m_ops.data(); }
+
+  /**
+   * @brief 各SQL语句的查询计划期望（供 QueryPlanChecker 回归检查）
+   * @return 期望列表
+   */
+  static QList<PlanExpectation> planExpectations();
+
+ private:
+  friend class ImageStreamWriter;
+
+  /**
+   * @brief 提交内容并插入元数据（持锁，防止与回收并发）
+   */
+  DbResult<int> commitImage(ImageData image, ContentWriter& writer);
+
+  /**
+   * @brief 在给定连接上插入元数据行（调用方持锁）
+   */
+  DbResult<int> insertRow(QSqlDatabase& db, const ImageData& image);
+
+  /**
+   * @brief 所在线程事务提交后回收不再被引用的内容
+   * 回滚会恢复引用，故只在持久提交后检查；无活动事务时立即检查。调用方
+   * 须已释放表锁与连接
+   */
+  void releaseContentAfterCommit(const QString& hash);
+
+  /**
+   * @brief 内容不再被引用时删除（自取连接并持锁）
+   */
+  void releaseContentIfUnreferenced(const QString& hash);
+
+  /**
+   * @brief 从查询结果构建ImageData对象
+   * @param query SQL查询对象
+   * @return ImageData对象
+   */
+  ImageData buildImageData(const QSqlQuery& query) const;
+
+  /**
+   * @brief 生成分页查询SQL
+   * @param params 分页参数（排序列经 sanitizeOrderBy 过滤）
+   * @return SQL语句
+   */
+  static QString selectByPageSql(const PageParams& params);
+
+  static inline QString sanitizeOrderBy(const QString& col) {
+    static const QSet<QString> k = {"id",          "experiment_id", "name",
+                                    "width",       "height",        "byte_size",
+                                    "captured_at", "created_at"};
+    return k.contains(col) ? col : "id";
+  }
+};
+
+#endif  // IMAGEDATATABLE_H
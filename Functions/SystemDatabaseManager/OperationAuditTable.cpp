@@ -0,0 +1,436 @@
+﻿#include "OperationAuditTable.h"
+
+#include <QSet>
+
+#include "WorkloadCapture.h"
+
+// ============================================================================
+// OperationAuditTable SQL语句常量定义
+// ============================================================================
+
+const QString OperationAuditTable::INSERT_SQL = R"(
+    INSERT INTO operation_audit (ts_ms, table_name, action, record_id, actor,
+                                 details, thread_id, prev_hash, hash)
+    VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)
+)";
+
+const QString OperationAuditTable::SELECT_BY_ID_SQL = R"(
+    SELECT id, ts_ms, table_name, action, record_id, actor, details, thread_id,
+           prev_hash, hash
+    FROM operation_audit WHERE id = ?
+)";
+
+const QString OperationAuditTable::SELECT_ALL_SQL = R"(
+    SELECT id, ts_ms, table_name, action, record_id, actor, details, thread_id,
+           prev_hash, hash
+    FROM operation_audit ORDER BY id
+)";
+
+const QString OperationAuditTable::SELECT_BY_RECORD_SQL = R"(
+    SELECT id, ts_ms, table_name, action, record_id, actor, details, thread_id,
+           prev_hash, hash
+    FROM operation_audit WHERE table_name = ? AND record_id = ?
+    ORDER BY id
+)";
+
+const QString OperationAuditTable::SELECT_LAST_HASH_SQL = R"(
+    SELECT hash FROM operation_audit ORDER BY id DESC LIMIT 1
+)";
+
+const QString OperationAuditTable::SELECT_CHAIN_SQL = SELECT_ALL_SQL;
+
+QList<PlanExpectation> OperationAuditTable::planExpectations() {
+  const QString pk = "INTEGER PRIMARY KEY";
+  QList<PlanExpectation> list = {
+      {"OperationAuditTable::SELECT_BY_ID_SQL", SELECT_BY_ID_SQL, {pk}},
+      {"OperationAuditTable::SELECT_BY_RECORD_SQL", SELECT_BY_RECORD_SQL,
+       {"idx_operation_audit_record"}},
+      // 倒序扫描主键、取到一行即停
+      {"OperationAuditTable::SELECT_LAST_HASH_SQL", SELECT_LAST_HASH_SQL, {},
+       true},
+      {"OperationAuditTable::SELECT_ALL_SQL", SELECT_ALL_SQL, {}, true}};
+
+  // 分页按主键或时间索引顺序扫描，不得额外排序
+  for (bool ascending : {true, false}) {
+    const QString dir = ascending ? "ASC" : "DESC";
+    list.append({QString("OperationAuditTable::selectByPage(id %1)").arg(dir),
+                 selectByPageSql(PageParams{3, 50, "id", ascending}),
+                 {},
+                 true});
+    list.append(
+        {QString("OperationAuditTable::selectByPage(ts_ms %1)").arg(dir),
+         selectByPageSql(PageParams{3, 50, "ts_ms", ascending}),
+         {"idx_operation_audit_ts"},
+         true});
+  }
+  return list;
+}
+
+// ============================================================================
+// OperationAuditTableOperations 实现
+// ============================================================================
+
+const QString OperationAuditTableOperations::CREATE_TABLE_SQL = R"(
+  CREATE TABLE IF NOT EXISTS operation_audit (
+    id INTEGER PRIMARY KEY,
+    ts_ms INTEGER NOT NULL,
+    table_name TEXT NOT NULL,
+    action INTEGER NOT NULL,
+    record_id INTEGER,
+    actor TEXT,
+    details TEXT,
+    thread_id INTEGER,
+    prev_hash BLOB NOT NULL,
+    hash BLOB NOT NULL,
+    CHECK(length(hash) = 32)
+  )
+)";
+
+OperationAuditTableOperations::OperationAuditTableOperations(
+    QSqlDatabase* db, ConnectionPool* pool)
+    : BaseTableOperations(db, "operation_audit", TableType::OPERATION_AUDIT,
+                          pool, nullptr) {
+  setAuditEnabled(false);  // 审计表自身不再产生审计记录
+}
+
+bool OperationAuditTableOperations::createTable() {
+  ProfiledMutexLocker locker(&m_mutex, DB_LOCK_SITE);
+
+  auto c = acquireDb();
+  if (!c.db.isOpen()) {
+    qCritical() << "数据库连接未打开!";
+    return false;
+  }
+
+  QSqlQuery query(c.db);
+  if (!query.exec(CREATE_TABLE_SQL)) {
+    QString error = query.lastError().text();
+    qCritical() << "创建操作审计表失败:" << error;
+    logOperation("创建表失败", error);
+    return false;
+  }
+
+  // 审计记录一经写入不可修改或删除
+  const char* NO_UPDATE_SQL = R"(
+      CREATE TRIGGER IF NOT EXISTS trg_operation_audit_no_update
+      BEFORE UPDATE ON operation_audit
+      BEGIN SELECT RAISE(ABORT, 'operation_audit is append-only'); END;
+    )";
+  const char* NO_DELETE_SQL = R"(
+      CREATE TRIGGER IF NOT EXISTS trg_operation_audit_no_delete
+      BEFORE DELETE ON operation_audit
+      BEGIN SELECT RAISE(ABORT, 'operation_audit is append-only'); END;
+    )";
+  if (!query.exec(NO_UPDATE_SQL) || !query.exec(NO_DELETE_SQL)) {
+    qWarning() << "创建审计保护触发器失败:" << query.lastError().text();
+    logOperation("创建触发器失败", query.lastError().text());
+  }
+
+  query.exec(
+      "CREATE INDEX IF NOT EXISTS idx_operation_audit_record ON "
+      "operation_audit(table_name, record_id)");
+  query.exec(
+      "CREATE INDEX IF NOT EXISTS idx_operation_audit_ts ON "
+      "operation_audit(ts_ms)");
+
+  logOperation("创建表成功", m_tableName);
+  return true;
+}
+
+bool OperationAuditTableOperations::truncateTable() {
+  logOperation("清空表失败", "操作审计表为只追加表");
+  return false;
+}
+
+// ============================================================================
+// OperationAuditTable实现
+// ============================================================================
+
+OperationAuditTable::OperationAuditTable(QSqlDatabase* db,
+                                         ConnectionPool* pool)
+    : BaseTable<AuditRecord>(nullptr) {
+  m_ops = new OperationAuditTableOperations(db, pool);
+  m_baseOps = m_ops;
+}
+
+OperationAuditTable::~OperationAuditTable() { m_baseOps = nullptr; }
+
+int OperationAuditTable::insertRange(QSqlDatabase& db, const AuditRecord* begin,
+                                     const AuditRecord* end,
+                                     QString* error) const {
+  if (!SqlExec::begin(db)) {
+    if (error) *error = "无法开启事务";
+    return -1;
+  }
+
+  QSqlQuery query(db);
+  query.prepare(INSERT_SQL);
+
+  int count = 0;
+  for (const AuditRecord* r = begin; r != end; ++r) {
+    query.bindValue(0, r->timestampMs);
+    query.bindValue(1, r->tableName);
+    query.bindValue(2, static_cast<int>(r->action));
+    query.bindValue(3, r->recordId);
+    query.bindValue(4, r->actor);
+    query.bindValue(5, r->details);
+    query.bindValue(6, static_cast<qint64>(r->threadId));
+    query.bindValue(7, r->prevHash);
+    query.bindValue(8, r->hash);
+    if (!SqlExec::run(query)) {
+      if (error) *error = query.lastError().text();
+      query.finish();
+      SqlExec::rollback(db);
+      return -1;
+    }
+    ++count;
+  }
+
+  query.finish();
+  if (!SqlExec::commit(db)) {
+    if (error) *error = db.lastError().text();
+    SqlExec::rollback(db);
+    return -1;
+  }
+  return count;
+}
+
+DbResult<int> OperationAuditTable::insert(const AuditRecord&) {
+  return DbResult<int>::Error("审计记录需经AuditTrail写入以维护哈希链");
+}
+
+DbResult<bool> OperationAuditTable::update(const AuditRecord&) {
+  return DbResult<bool>::Error("审计记录不可修改");
+}
+
+DbResult<bool> OperationAuditTable::deleteById(int) {
+  return DbResult<bool>::Error("审计记录不可删除");
+}
+
+DbResult<AuditRecord> OperationAuditTable::selectById(int id) const {
+  if (!m_ops) {
+    return DbResult<AuditRecord>::Error("操作审计表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) return DbResult<AuditRecord>::Error("数据库未打开");
+
+  QSqlQuery query(c.db);
+  query.prepare(SELECT_BY_ID_SQL);
+  query.addBindValue(id);
+
+  if (!SqlExec::run(query)) {
+    return DbResult<AuditRecord>::Error(
+        QString("查询审计记录失败: %1").arg(query.lastError().text()));
+  }
+
+  if (query.next()) {
+    return DbResult<AuditRecord>::Success(buildRecord(query));
+  }
+  return DbResult<AuditRecord>::Error(
+      "未找到指定的审计记录", DbErrorCode::NOT_FOUND);
+}
+
+DbResult<QList<AuditRecord>> OperationAuditTable::selectAll() const {
+  if (!m_ops) {
+    return DbResult<QList<AuditRecord>>::Error("操作审计表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<QList<AuditRecord>>::Error("数据库未打开");
+  }
+
+  QSqlQuery query(c.db);
+  query.setForwardOnly(true);
+  if (!SqlExec::run(query, SELECT_ALL_SQL)) {
+    return DbResult<QList<AuditRecord>>::Error(
+        QString("查询审计记录失败: %1").arg(query.lastError().text()));
+  }
+
+  QList<AuditRecord> records;
+  while (query.next()) records.append(buildRecord(query));
+  return DbResult<QList<AuditRecord>>::Success(std::move(records));
+}
+
+QString OperationAuditTable::selectByPageSql(const PageParams& params) {
+  QString orderBy =
+      params.orderBy.isEmpty() ? "id" : sanitizeOrderBy(params.orderBy);
+  return QString(
+             "SELECT id, ts_ms, table_name, action, record_id, actor, "
+             "details, thread_id, prev_hash, hash FROM operation_audit "
+             "ORDER BY %1 %2 LIMIT %3 OFFSET %4")
+      .arg(orderBy)
+      .arg(params.ascending ? "ASC" : "DESC")
+      .arg(params.pageSize)
+      .arg(params.offset());
+}
+
+DbResult<PageResult<AuditRecord>> OperationAuditTable::selectByPage(
+    const PageParams& params) const {
+  if (!m_ops) {
+    return DbResult<PageResult<AuditRecord>>::Error(
+        "操作审计表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<PageResult<AuditRecord>>::Error("数据库未打开");
+  }
+
+  int total = m_ops->getTotalCount();
+
+  QSqlQuery query(c.db);
+  query.setForwardOnly(true);
+  if (!SqlExec::run(query, selectByPageSql(params))) {
+    return DbResult<PageResult<AuditRecord>>::Error(
+        QString("分页查询审计记录失败: %1").arg(query.lastError().text()));
+  }
+
+  QList<AuditRecord> list;
+  while (query.next()) list.append(buildRecord(query));
+  return DbResult<PageResult<AuditRecord>>::Success(
+      PageResult<AuditRecord>(std::move(list), total, params));
+}
+
+DbResult<int> OperationAuditTable::batchInsert(
+    const QList<AuditRecord>& records) {
+  if (!m_ops) {
+    return DbResult<int>::Error("操作审计表未初始化或已释放");
+  }
+  if (records.isEmpty()) {
+    return DbResult<int>::Success(0);
+  }
+
+  for (const AuditRecord& r : records) {
+    if (r.hash.size() != 32 || r.prevHash.size() != 32) {
+      return DbResult<int>::Error("审计记录缺少哈希链字段");
+    }
+  }
+
+  QVector<AuditRecord> batch;
+  batch.reserve(records.size());
+  for (const AuditRecord& r : records) batch.append(r);
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<int>::Error("数据库未打开");
+  }
+
+  QString error;
+  const int n = insertRange(c.db, batch.constData(),
+                            batch.constData() + batch.size(), &error);
+  if (n < 0) {
+    return DbResult<int>::Error(QString("批量写入审计记录失败: %1").arg(error));
+  }
+  return DbResult<int>::Success(n);
+}
+
+bool OperationAuditTable::appendBatch(const QVector<AuditRecord>& records) {
+  if (!m_ops) return false;
+  if (records.isEmpty()) return true;
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) return false;
+
+  QString error;
+  const int n = insertRange(c.db, records.constData(),
+                            records.constData() + records.size(), &error);
+  if (n < 0) {
+    qWarning() << "批量写入审计记录失败:" << error;
+    return false;
+  }
+  return true;
+}
+
+DbResult<QList<AuditRecord>> OperationAuditTable::selectByRecord(
+    const QString& tableName, qint64 recordId) const {
+  if (!m_ops) {
+    return DbResult<QList<AuditRecord>>::Error("操作审计表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) {
+    return DbResult<QList<AuditRecord>>::Error("数据库未打开");
+  }
+
+  QSqlQuery query(c.db);
+  query.setForwardOnly(true);
+  query.prepare(SELECT_BY_RECORD_SQL);
+  query.addBindValue(tableName);
+  query.addBindValue(recordId);
+
+  if (!SqlExec::run(query)) {
+    return DbResult<QList<AuditRecord>>::Error(
+        QString("查询审计历史失败: %1").arg(query.lastError().text()));
+  }
+
+  QList<AuditRecord> records;
+  while (query.next()) records.append(buildRecord(query));
+  return DbResult<QList<AuditRecord>>::Success(std::move(records));
+}
+
+QByteArray OperationAuditTable::lastHash() const {
+  if (!m_ops) return QByteArray();
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) return QByteArray();
+
+  QSqlQuery query(c.db);
+  if (SqlExec::run(query, SELECT_LAST_HASH_SQL) && query.next()) {
+    return query.value(0).toByteArray();
+  }
+  return QByteArray();
+}
+
+DbResult<qint64> OperationAuditTable::verifyChain() const {
+  if (!m_ops) {
+    return DbResult<qint64>::Error("操作审计表未初始化或已释放");
+  }
+
+  auto c = m_ops->acquireDb();
+  if (!c.db.isOpen()) return DbResult<qint64>::Error("数据库未打开");
+
+  QSqlQuery query(c.db);
+  query.setForwardOnly(true);
+  if (!SqlExec::run(query, SELECT_CHAIN_SQL)) {
+    return DbResult<qint64>::Error(
+        QString("读取审计链失败: %1").arg(query.lastError().text()));
+  }
+
+  QByteArray expectedPrev = AuditTrail::genesisHash();
+  qint64 verified = 0;
+  while (query.next()) {
+    const AuditRecord r = buildRecord(query);
+    if (r.prevHash != expectedPrev) {
+      return DbResult<qint64>::Error(
+          QString("审计链断裂于记录 %1：前向哈希不匹配（记录缺失或被插入）")
+              .arg(r.id));
+    }
+    if (AuditTrail::computeHash(r.prevHash, r) != r.hash) {
+      return DbResult<qint64>::Error(
+          QString("审计链断裂于记录 %1：内容哈希不匹配（记录被篡改）")
+              .arg(r.id));
+    }
+    expectedPrev = r.hash;
+    ++verified;
+  }
+
+  return DbResult<qint64>::Success(verified);
+}
+
+AuditRecord OperationAuditTable::buildRecord(const QSqlQuery& query) const {
+  AuditRecord record;
+
+  record.id = query.value(0).toLongLong();
+  record.timestampMs = query.value(1).toLongLong();
+  record.tableName = m_interner.intern(query.value(2));
+  record.action = static_cast<AuditAction>(query.value(3).toInt());
+  record.recordId = query.value(4).toLongLong();
+  record.actor = m_interner.intern(query.value(5));
+  record.details = query.value(6).toString();
+  record.threadId = query.value(7).toULongLong();
+  record.prevHash = query.value(8).toByteArray();
+  record.hash = query.value(9).toByteArray();
+
+  return record;
+}
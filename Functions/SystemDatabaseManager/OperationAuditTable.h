@@ -0,0 +1,189 @@
+﻿#ifndef OPERATIONAUDITTABLE_H
+#define OPERATIONAUDITTABLE_H
+
+#include <QPointer>
+
+#include "AuditTrail.h"
+#include "BaseDatabaseManager.h"
+#include "QueryPlanChecker.h"
+#include "StringInterner.h"
+
+// ============================================================================
+// 操作审计表操作类
+// ============================================================================
+
+/**
+ * @brief 操作审计表操作类
+ * 继承自BaseTableOperations并实现createTable方法；
+ * 表上的触发器拒绝UPDATE/DELETE，审计记录只能追加
+ */
+class OperationAuditTableOperations : public BaseTableOperations {
+  Q_OBJECT
+ public:
+  explicit OperationAuditTableOperations(QSqlDatabase* db,
+                                         ConnectionPool* pool);
+  ~OperationAuditTableOperations() override = default;
+
+  bool createTable() override;
+
+  /**
+   * @brief 审计表不可清空（触发器拒绝删除）
+   */
+  bool truncateTable() override;
+
+ private:
+  static const QString CREATE_TABLE_SQL;
+};
+
+/**
+ * @brief 操作审计表业务逻辑类
+ * 由 AuditTrail 的写线程批量写入；提供查询与哈希链校验
+ */
+class OperationAuditTable : public BaseTable<AuditRecord> {
+ private:
+  // SQL语句常量
+  static const QString INSERT_SQL;
+  static const QString SELECT_BY_ID_SQL;
+  static const QString SELECT_ALL_SQL;
+  static const QString SELECT_BY_RECORD_SQL;
+  static const QString SELECT_LAST_HASH_SQL;
+  static const QString SELECT_CHAIN_SQL;
+
+  QPointer<OperationAuditTableOperations> m_ops;  ///< 安全弱引用，避免悬空
+  mutable StringInterner m_interner;              ///< 低基数列驻留池
+
+ public:
+  /**
+   * @brief 构造函数
+   * @param db 数据库连接指针
+   * @param pool 连接池
+   */
+  explicit OperationAuditTable(QSqlDatabase* db, ConnectionPool* pool);
+
+  /**
+   * @brief 析构函数
+   */
+  ~OperationAuditTable() override;
+
+  // ========================================================================
+  // 实现BaseTable虚函数
+  // ========================================================================
+
+  /**
+   * @brief 审计记录只能经AuditTrail写入（需要哈希链），不支持直接插入
+   */
+  DbResult<int> insert(const AuditRecord& record) override;
+
+  /**
+   * @brief 审计记录不可修改
+   */
+  DbResult<bool> update(const AuditRecord& record) override;
+
+  /**
+   * @brief 审计记录不可删除
+   */
+  DbResult<bool> deleteById(int id) override;
+
+  /**
+   * @brief 根据ID查询审计记录
+   * @param id 记录ID
+   * @return 操作结果，包含审计记录
+   */
+  DbResult<AuditRecord> selectById(int id) const override;
+
+  /**
+   * @brief 查询所有审计记录（按ID升序）
+   * @return 操作结果，包含审计记录列表
+   */
+  DbResult<QList<AuditRecord>> selectAll() const override;
+
+  /**
+   * @brief 分页查询审计记录
+   * @param params 分页参数
+   * @return 操作结果，包含分页结果
+   */
+  DbResult<PageResult<AuditRecord>> selectByPage(
+      const PageParams& params) const override;
+
+  /**
+   * @brief 批量写入已串好哈希链的审计记录（单事务）
+   * @param records 审计记录列表
+   * @return 操作结果，包含写入条数
+   */
+  DbResult<int> batchInsert(const QList<AuditRecord>& records) override;
+
+  // ========================================================================
+  // 扩展功能方法
+  // ========================================================================
+
+  /**
+   * @brief 追加一批审计记录（AuditTrail刷写回调）
+   * @param records 审计记录批次（prevHash/hash已填充）
+   * @return 是否整批写入成功
+   */
+  bool appendBatch(const QVector<AuditRecord>& records);
+
+  /**
+   * @brief 查询某条业务记录的审计历史
+   * @param tableName 表名
+   * @param recordId 记录ID
+   * @return 操作结果，包含审计记录列表（按时间升序）
+   */
+  DbResult<QList<AuditRecord>> selectByRecord(const QString& tableName,
+                                              qint64 recordId) const;
+
+  /**
+   * @brief 获取链尾哈希（用于重启后续接哈希链）
+   * @return 链尾哈希，空表返回空
+   */
+  QByteArray lastHash() const;
+
+  /**
+   * @brief 校验整条哈希链
+   * 逐条复算哈希并比对前后链接，发现篡改、删除或插入时返回首个断点
+   * @return 操作结果，成功时包含已校验的记录数
+   */
+  DbResult<qint64> verifyChain() const;
+
+  /**
+   * @brief 获取基础操作对象
+   * @return 基础操作对象指针
+   */
+  OperationAuditTableOperations* operations() const { return m_ops.data(); }
+
+  /**
+   * @brief 各SQL语句的查询计划期望（供 QueryPlanChecker 回归检查）
+   * @return 期望列表
+   */
+  static QList<PlanExpectation> planExpectations();
+
+ private:
+  /**
+   * @brief 从查询结果构建AuditRecord对象
+   * @param query SQL查询对象
+   * @return AuditRecord对象
+   */
+  AuditRecord buildRecord(const QSqlQuery& query) const;
+
+  /**
+   * @brief 在给定连接上以单事务写入一批审计记录
+   * @return 写入条数，失败返回-1
+   */
+  int insertRange(QSqlDatabase& db, const AuditRecord* begin,
+                  const AuditRecord* end, QString* error) const;
+
+  /**
+   * @brief 生成分页查询SQL
+   * @param params 分页参数（排序列经 sanitizeOrderBy 过滤）
+   * @return SQL语句
+   */
+  static QString selectByPageSql(const PageParams& params);
+
+  static inline QString sanitizeOrderBy(const QString& col) {
+    static const QSet<QString> k = {"id", "ts_ms", "table_name", "action",
+                                    "record_id", "actor"};
+    return k.contains(col) ? col : "id";
+  }
+};
+
+#endif  // OPERATIONAUDITTABLE_H
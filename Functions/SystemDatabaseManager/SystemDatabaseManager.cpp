@@ -0,0 +1,71 @@
+﻿// ============================================================================
+// SystemDatabaseManager.cpp - 实现文件
+// ============================================================================
+
+#include "SystemDatabaseManager.h"
+
+#include "OperationAuditTable.h"
+
+// ============================================================================
+// SystemDatabaseManager实现
+// ============================================================================
+
+SystemDatabaseManager::SystemDatabaseManager(const DatabaseConfig& config,
+                                             QObject* parent)
+    : BaseDatabaseManager(DatabaseType::SYSTEM_DB, config, parent) {
+  qInfo() << "创建系统管理数据库管理器";
+}
+
+SystemDatabaseManager::~SystemDatabaseManager() { stopAuditTrail(); }
+
+bool SystemDatabaseManager::initialize() {
+  if (!BaseDatabaseManager::initialize()) {
+    return false;
+  }
+
+  // 从已落盘的链尾续接；写线程通过连接池取自己的连接
+  OperationAuditTable* table = m_auditTable.get();
+  m_ownsAuditTrail = AuditTrail::instance()->start(
+      [table](QVector<AuditRecord>& batch) {
+        return table->appendBatch(batch);
+      },
+      table->lastHash(), m_auditOptions);
+
+  if (!m_ownsAuditTrail) {
+    qWarning() << "操作审计采集器已在运行，本数据库不接管审计写入";
+  }
+  return true;
+}
+
+void SystemDatabaseManager::close() {
+  stopAuditTrail();              // 先写完积压审计记录
+  m_auditTable.reset();          // 再释放业务表，避免悬空
+  BaseDatabaseManager::close();  // 最后做通用清理
+}
+
+void SystemDatabaseManager::stopAuditTrail() {
+  if (m_ownsAuditTrail) {
+    AuditTrail::instance()->stop();
+    m_ownsAuditTrail = false;
+  }
+}
+
+void SystemDatabaseManager::registerTables() {
+  m_auditTable =
+      std::make_unique<OperationAuditTable>(&m_database, m_connectionPool.get());
+
+  connect(m_auditTable->operations(), &BaseTableOperations::databaseError,
+          this, &SystemDatabaseManager::databaseError);
+
+  // 交给基类接管“所有权”（唯一所有者）
+  registerTable(TableType::OPERATION_AUDIT,
+                std::unique_ptr<ITableOperations>(m_auditTable->operations()));
+}
+
+OperationAuditTable* SystemDatabaseManager::operationAuditTable() const {
+  return m_auditTable.get();
+}
+
+AuditTrail::Stats SystemDatabaseManager::auditStats() const {
+  return AuditTrail::instance()->stats();
+}
@@ -0,0 +1,89 @@
+﻿// SystemDatabaseManager.h - 系统管理数据库管理器
+#ifndef SYSTEM_DATABASE_MANAGER_H
+#define SYSTEM_DATABASE_MANAGER_H
+
+#include "AuditTrail.h"
+#include "BaseDatabaseManager.h"
+#include "DatabaseFramework.h"
+
+class OperationAuditTable;
+
+// ============================================================================
+// 系统管理数据库管理器
+// ============================================================================
+
+/**
+ * @brief 系统管理数据库管理器
+ * 管理操作审计等系统表；初始化后把审计采集器接到OPERATION_AUDIT表，
+ * 并从表尾哈希续接哈希链
+ */
+class SystemDatabaseManager : public BaseDatabaseManager {
+  Q_OBJECT
+
+ private:
+  std::unique_ptr<OperationAuditTable> m_auditTable;  ///< 操作审计表
+  AuditTrail::Options m_auditOptions = AuditTrail::defaultOptions();
+  bool m_ownsAuditTrail = false;  ///< 采集器是否由本数据库启动
+
+ public:
+  /**
+   * @brief 构造函数
+   * @param config 数据库配置
+   * @param parent 父对象
+   */
+  explicit SystemDatabaseManager(const DatabaseConfig& config,
+                                 QObject* parent = nullptr);
+
+  /**
+   * @brief 析构函数
+   */
+  ~SystemDatabaseManager() override;
+
+  /**
+   * @brief 初始化数据库并启动操作审计采集器
+   * @return 是否成功
+   */
+  bool initialize() override;
+
+  void close() override;
+
+  // ========================================================================
+  // 表访问器
+  // ========================================================================
+
+  /**
+   * @brief 获取操作审计表操作对象
+   * @return 操作审计表指针
+   */
+  OperationAuditTable* operationAuditTable() const;
+
+  // ========================================================================
+  // 审计采集器
+  // ========================================================================
+
+  /**
+   * @brief 设置审计采集器参数（下次initialize()时生效）
+   * @param options 采集器参数
+   */
+  void setAuditOptions(const AuditTrail::Options& options) {
+    m_auditOptions = options;
+  }
+
+  /**
+   * @brief 获取审计采集器运行计数
+   * @return 计数快照
+   */
+  AuditTrail::Stats auditStats() const;
+
+ protected:
+  /**
+   * @brief 注册所有表
+   * 实现基类纯虚函数
+   */
+  void registerTables() override;
+
+ private:
+  void stopAuditTrail();
+};
+
+#endif  // SYSTEM_DATABASE_MANAGER_H
@@ -5,9 +5,11 @@
 
 // 静态成员初始化
 std::unique_ptr<DatabaseRegistry> DatabaseRegistry::s_instance = nullptr;
-QMutex DatabaseRegistry::s_instanceMutex;
+ProfiledMutex DatabaseRegistry::s_instanceMutex(
+    "DatabaseRegistry::s_instanceMutex");
 
-DatabaseRegistry::DatabaseRegistry(QObject* parent) : QObject(parent) {
+DatabaseRegistry::DatabaseRegistry(QObject* parent)
+    : QObject(parent), m_registryMutex("DatabaseRegistry::m_registryMutex") {
   qInfo() << "创建数据库注册中心";
 
   // 设置默认数据路径
@@ -26,7 +28,7 @@ DatabaseRegistry::~DatabaseRegistry() {
 }
 
 DatabaseRegistry* DatabaseRegistry::getInstance() {
-  QMutexLocker locker(&s_instanceMutex);
+  ProfiledMutexLocker locker(&s_instanceMutex, DB_LOCK_SITE);
   if (!s_instance) {
     s_instance = std::unique_ptr<DatabaseRegistry>(new DatabaseRegistry());
   }
@@ -34,12 +36,12 @@ DatabaseRegistry* DatabaseRegistry::getInstance() {
 }
 
 void DatabaseRegistry::destroyInstance() {
-  QMutexLocker locker(&s_instanceMutex);
+  ProfiledMutexLocker locker(&s_instanceMutex, DB_LOCK_SITE);
   s_instance.reset();
 }
 
 bool DatabaseRegistry::initialize(const QString& dataPath) {
-  QMutexLocker locker(&m_registryMutex);
+  ProfiledMutexLocker locker(&m_registryMutex, DB_LOCK_SITE);
 
   if (m_initialized) {
     qWarning() << "数据库注册中心已经初始化";
@@ -53,8 +55,17 @@ bool DatabaseRegistry::initialize(const QString& dataPath) {
     m_baseDataPath = dataPath;
   }
 
+  m_startupProfile.begin();
+  m_databaseProfiles.clear();
+
   // 确保数据目录存在
-  if (!ensureDataDirectoryExists()) {
+  bool directoryOk = false;
+  {
+    StartupProfile::Scope phase(&m_startupProfile, "dataDirectory");
+    directoryOk = ensureDataDirectoryExists() || phase.fail();
+  }
+  if (!directoryOk) {
+    m_startupProfile.finish(false);
     QString error = "创建数据目录失败: " + m_baseDataPath;
     qCritical() << error;
     emit initializationCompleted(false, error);
@@ -72,6 +83,27 @@ bool DatabaseRegistry::initialize(const QString& dataPath) {
     errors.append("设备管理数据库注册失败");
   }
 
+  // 注册数据管理数据库（系统日志、文件附件）
+  if (registerDatabase(DatabaseType::DATA_DB)) {
+    successCount++;
+  } else {
+    errors.append("数据管理数据库注册失败");
+  }
+
+  // 注册实验项目数据库（图像数据）
+  if (registerDatabase(DatabaseType::EXPERIMENT_DB)) {
+    successCount++;
+  } else {
+    errors.append("实验项目数据库注册失败");
+  }
+
+  // 注册系统管理数据库（操作审计）
+  if (registerDatabase(DatabaseType::SYSTEM_DB)) {
+    successCount++;
+  } else {
+    errors.append("系统管理数据库注册失败");
+  }
+
   // 后续可以注册其他数据库
   // if (registerDatabase(DatabaseType::CONFIG_DB)) {
   //     successCount++;
@@ -82,6 +114,7 @@ bool DatabaseRegistry::initialize(const QString& dataPath) {
   // 检查结果
   bool success = (successCount > 0);
   m_initialized = success;
+  m_startupProfile.finish(success);
 
   QString message;
   if (success) {
@@ -92,6 +125,7 @@ bool DatabaseRegistry::initialize(const QString& dataPath) {
           QString("，%1 个失败: %2").arg(errors.size()).arg(errors.join(", "));
     }
     qInfo() << message;
+    qInfo().noquote() << m_startupProfile.summary();
   } else {
     message = QString("数据库注册中心初始化失败: %1").arg(errors.join(", "));
     qCritical() << message;
@@ -102,7 +136,7 @@ bool DatabaseRegistry::initialize(const QString& dataPath) {
 }
 
 void DatabaseRegistry::shutdown() {
-  QMutexLocker locker(&m_registryMutex);
+  ProfiledMutexLocker locker(&m_registryMutex, DB_LOCK_SITE);
 
   if (!m_initialized) {
     return;
@@ -129,15 +163,29 @@ DeviceDatabaseManager* DatabaseRegistry::deviceDatabase() const {
       getDatabase(DatabaseType::DEVICE_DB));
 }
 
+DataDatabaseManager* DatabaseRegistry::dataDatabase() const {
+  return static_cast<DataDatabaseManager*>(getDatabase(DatabaseType::DATA_DB));
+}
+
+ExperimentDatabaseManager* DatabaseRegistry::experimentDatabase() const {
+  return static_cast<ExperimentDatabaseManager*>(
+      getDatabase(DatabaseType::EXPERIMENT_DB));
+}
+
+SystemDatabaseManager* DatabaseRegistry::systemDatabase() const {
+  return static_cast<SystemDatabaseManager*>(
+      getDatabase(DatabaseType::SYSTEM_DB));
+}
+
 BaseDatabaseManager* DatabaseRegistry::getDatabase(DatabaseType dbType) const {
-  QMutexLocker locker(&m_registryMutex);
+  ProfiledMutexLocker locker(&m_registryMutex, DB_LOCK_SITE);
 
   auto it = m_databases.find(dbType);
   return (it != m_databases.end()) ? it->second.get() : nullptr;
 }
 
 bool DatabaseRegistry::isDatabaseAvailable(DatabaseType dbType) const {
-  QMutexLocker locker(&m_registryMutex);
+  ProfiledMutexLocker locker(&m_registryMutex, DB_LOCK_SITE);
 
   auto it = m_databases.find(dbType);
   if (it == m_databases.end()) {
@@ -148,7 +196,7 @@ bool DatabaseRegistry::isDatabaseAvailable(DatabaseType dbType) const {
 }
 
 int DatabaseRegistry::createAllDatabases() {
-  QMutexLocker locker(&m_registryMutex);
+  ProfiledMutexLocker locker(&m_registryMutex, DB_LOCK_SITE);
 
   int successCount = 0;
 
@@ -173,7 +221,7 @@ int DatabaseRegistry::createAllDatabases() {
 }
 
 DbResult<int> DatabaseRegistry::backupAllDatabases(const QString& backupDir) {
-  QMutexLocker locker(&m_registryMutex);
+  ProfiledMutexLocker locker(&m_registryMutex, DB_LOCK_SITE);
 
   // 确保备份目录存在
   QDir dir(backupDir);
@@ -223,7 +271,7 @@ DbResult<int> DatabaseRegistry::backupAllDatabases(const QString& backupDir) {
 }
 
 DbResult<int> DatabaseRegistry::restoreAllDatabases(const QString& backupDir) {
-  QMutexLocker locker(&m_registryMutex);
+  ProfiledMutexLocker locker(&m_registryMutex, DB_LOCK_SITE);
 
   QDir dir(backupDir);
   if (!dir.exists()) {
@@ -282,7 +330,7 @@ DbResult<int> DatabaseRegistry::restoreAllDatabases(const QString& backupDir) {
 }
 
 QMap<DatabaseType, bool> DatabaseRegistry::getDatabaseHealthStatus() const {
-  QMutexLocker locker(&m_registryMutex);
+  ProfiledMutexLocker locker(&m_registryMutex, DB_LOCK_SITE);
 
   QMap<DatabaseType, bool> healthStatus;
 
@@ -299,7 +347,7 @@ QMap<DatabaseType, bool> DatabaseRegistry::getDatabaseHealthStatus() const {
 
 QMap<DatabaseType, BaseDatabaseManager::DatabaseStats>
 DatabaseRegistry::getAllDatabaseStats() const {
-  QMutexLocker locker(&m_registryMutex);
+  ProfiledMutexLocker locker(&m_registryMutex, DB_LOCK_SITE);
 
   QMap<DatabaseType, BaseDatabaseManager::DatabaseStats> allStats;
 
@@ -316,7 +364,7 @@ DatabaseRegistry::getAllDatabaseStats() const {
 }
 
 DbResult<int> DatabaseRegistry::optimizeAllDatabases() {
-  QMutexLocker locker(&m_registryMutex);
+  ProfiledMutexLocker locker(&m_registryMutex, DB_LOCK_SITE);
 
   int successCount = 0;
   QStringList errors;
@@ -356,15 +404,31 @@ DatabaseConfig DatabaseRegistry::getDefaultConfig(DatabaseType dbType) const {
 }
 
 bool DatabaseRegistry::registerDatabase(DatabaseType dbType) {
+  const QString typeName = getDatabaseTypeName(dbType);
+  StartupProfile::Scope phase(&m_startupProfile,
+                              QString("register[%1]").arg(typeName));
   try {
     DatabaseConfig config = createDatabaseConfig(dbType);
     std::unique_ptr<BaseDatabaseManager> database;
 
+    StartupProfile::Scope construct(&m_startupProfile, "construct");
     switch (dbType) {
       case DatabaseType::DEVICE_DB:
         database = std::make_unique<DeviceDatabaseManager>(config, this);
         break;
 
+      case DatabaseType::DATA_DB:
+        database = std::make_unique<DataDatabaseManager>(config, this);
+        break;
+
+      case DatabaseType::EXPERIMENT_DB:
+        database = std::make_unique<ExperimentDatabaseManager>(config, this);
+        break;
+
+      case DatabaseType::SYSTEM_DB:
+        database = std::make_unique<SystemDatabaseManager>(config, this);
+        break;
+
         // 后续可以添加其他数据库类型
         // case DatabaseType::CONFIG_DB:
         //     database = std::make_unique<ConfigDatabaseManager>(config, this);
@@ -372,21 +436,30 @@ bool DatabaseRegistry::registerDatabase(DatabaseType dbType) {
 
       default:
         qWarning() << "不支持的数据库类型:" << static_cast<int>(dbType);
-        return false;
+        construct.fail();
+        return phase.fail();
     }
 
     if (!database) {
       qWarning() << "创建数据库管理器失败:" << getDatabaseTypeName(dbType);
-      return false;
+      construct.fail();
+      return phase.fail();
     }
 
     // 连接信号槽
     connectDatabaseSignals(database.get(), dbType);
+    construct.finish();
 
-    // 初始化数据库
-    if (!database->initialize()) {
+    // 初始化数据库（失败的库也保留其阶段耗时）
+    bool initialized = false;
+    {
+      StartupProfile::Scope initPhase(&m_startupProfile, "initialize");
+      initialized = database->initialize() || initPhase.fail();
+    }
+    m_databaseProfiles.insert(typeName, database->startupProfile());
+    if (!initialized) {
       qWarning() << "初始化数据库失败:" << getDatabaseTypeName(dbType);
-      return false;
+      return phase.fail();
     }
 
     // 注册到映射表
@@ -400,8 +473,30 @@ bool DatabaseRegistry::registerDatabase(DatabaseType dbType) {
   } catch (const std::exception& e) {
     qCritical() << "注册数据库异常:" << getDatabaseTypeName(dbType) << "-"
                 << e.what();
-    return false;
+    return phase.fail();
+  }
+}
+
+QJsonObject DatabaseRegistry::startupReport() const {
+  ProfiledMutexLocker locker(&m_registryMutex, DB_LOCK_SITE);
+  QJsonObject report = m_startupProfile.toJson();
+  QJsonObject databases;
+  for (auto it = m_databaseProfiles.cbegin(); it != m_databaseProfiles.cend();
+       ++it) {
+    databases[it.key()] = it.value().toJson();
+  }
+  report["databases"] = databases;
+  return report;
+}
+
+QString DatabaseRegistry::startupSummary() const {
+  ProfiledMutexLocker locker(&m_registryMutex, DB_LOCK_SITE);
+  QString text = m_startupProfile.summary();
+  for (auto it = m_databaseProfiles.cbegin(); it != m_databaseProfiles.cend();
+       ++it) {
+    text += QString("[%1] ").arg(it.key()) + it.value().summary();
   }
+  return text;
 }
 
 DatabaseConfig DatabaseRegistry::createDatabaseConfig(
@@ -3,6 +3,8 @@
 #define DATABASE_REGISTRY_H
 
 #include <QDir>
+#include <QJsonObject>
+#include <QMap>
 #include <QMutex>
 #include <QObject>
 #include <QStandardPaths>
@@ -10,7 +12,10 @@
 #include <unordered_map>
 
 #include "BaseDatabaseManager.h"
+#include "DataDatabaseManager/DataDatabaseManager.h"
 #include "DeviceDatabaseManager/DeviceDatabaseManager.h"
+#include "ExperimentDatabaseManager/ExperimentDatabaseManager.h"
+#include "SystemDatabaseManager/SystemDatabaseManager.h"
 
 /**
  * @brief 数据库注册中心
@@ -22,11 +27,15 @@ class DatabaseRegistry : public QObject {
 
  private:
   static std::unique_ptr<DatabaseRegistry> s_instance;  ///< 单例实例
-  static QMutex s_instanceMutex;  ///< 实例创建互斥锁
+  static ProfiledMutex s_instanceMutex;                 ///< 实例创建互斥锁
 
-  mutable QMutex m_registryMutex;  ///< 注册表互斥锁
-  QString m_baseDataPath;          ///< 数据库文件基础路径
-  bool m_initialized = false;      ///< 是否已初始化
+  mutable ProfiledMutex m_registryMutex;  ///< 注册表互斥锁
+  QString m_baseDataPath;                 ///< 数据库文件基础路径
+  bool m_initialized = false;             ///< 是否已初始化
+  StartupProfile m_startupProfile;        ///< 最近一次启动的阶段耗时
+
+  // 各库最近一次启动的阶段耗时（库名 -> 计时）
+  QMap<QString, StartupProfile> m_databaseProfiles;
 
   // 数据库管理器映射
   std::unordered_map<DatabaseType, std::unique_ptr<BaseDatabaseManager>>
@@ -88,6 +97,20 @@ class DatabaseRegistry : public QObject {
    */
   QString basePath() const { return m_baseDataPath; }
 
+  /**
+   * @brief 获取最近一次 initialize() 的启动报告
+   * 注册中心自身的阶段为 dataDirectory 与每个库的 register[库名]（其下
+   * 为 construct、initialize）；databases 按库名给出各库管理器的阶段，
+   * 注册失败的库也保留
+   * @return {"totalUs", "ok", "phases", "databases": {库名: 阶段耗时}}
+   */
+  QJsonObject startupReport() const;
+
+  /**
+   * @brief 可读的启动报告（注册中心及各库的阶段耗时表）
+   */
+  QString startupSummary() const;
+
   // ========================================================================
   // 数据库访问接口
   // ========================================================================
@@ -98,6 +121,24 @@ class DatabaseRegistry : public QObject {
    */
   DeviceDatabaseManager* deviceDatabase() const;
 
+  /**
+   * @brief 获取数据管理数据库
+   * @return 数据管理数据库管理器指针
+   */
+  DataDatabaseManager* dataDatabase() const;
+
+  /**
+   * @brief 获取实验项目数据库
+   * @return 实验项目数据库管理器指针
+   */
+  ExperimentDatabaseManager* experimentDatabase() const;
+
+  /**
+   * @brief 获取系统管理数据库
+   * @return 系统管理数据库管理器指针
+   */
+  SystemDatabaseManager* systemDatabase() const;
+
   /**
    * @brief 获取指定类型的数据库管理器
    * @param dbType 数据库类型
@@ -272,6 +313,21 @@ class DatabaseRegistry : public QObject {
  */
 #define DEVICE_DB() DatabaseRegistry::getInstance()->deviceDatabase()
 
+/**
+ * @brief 便利宏：获取数据管理数据库
+ */
+#define DATA_DB() DatabaseRegistry::getInstance()->dataDatabase()
+
+/**
+ * @brief 便利宏：获取实验项目数据库
+ */
+#define EXPERIMENT_DB() DatabaseRegistry::getInstance()->experimentDatabase()
+
+/**
+ * @brief 便利宏：获取系统管理数据库
+ */
+#define SYSTEM_DB() DatabaseRegistry::getInstance()->systemDatabase()
+
 /**
  * @brief 便利宏：获取指定类型数据库
  */
@@ -0,0 +1,30 @@
+# Replay.pro - 负载日志重放程序（与主程序共用框架源文件）
+include($$PWD/../DataBase.pri)
+
+# 输出目录配置（与主程序、基准测试分开，避免目标文件互相覆盖）
+DESTDIR = $$PWD/../bin
+OBJECTS_DIR = $$PWD/../build/replay/obj
+MOC_DIR = $$PWD/../build/replay/moc
+RCC_DIR = $$PWD/../build/replay/rcc
+
+# 延迟直方图与运行环境信息沿用基准测试的实现
+INCLUDEPATH += $$PWD $$PWD/../Benchmark
+
+CONFIG(debug, debug|release) {
+    DEFINES += DEBUG_MODE
+    TARGET = DataBaseReplay_d
+} else {
+    TARGET = DataBaseReplay
+}
+
+HEADERS += \
+    ../Benchmark/BenchmarkRunner.h \
+    ../Benchmark/LatencyHistogram.h \
+    ReplaySelfTest.h \
+    WorkloadReplayer.h
+
+SOURCES += \
+    ../Benchmark/BenchmarkRunner.cpp \
+    ReplaySelfTest.cpp \
+    WorkloadReplayer.cpp \
+    main.cpp
@@ -0,0 +1,17 @@
+﻿// ReplaySelfTest.h - 负载采集与重放的往返自检
+#ifndef REPLAY_SELF_TEST_H
+#define REPLAY_SELF_TEST_H
+
+class QTextStream;
+
+/**
+ * @brief 采集—重放往返自检
+ * 在两个临时库上采集一段跨库负载（一个库的事务中读另一个库），再在采集
+ * 前留的副本上重放：每条语句应回到所属库的副本、无错误且成败与采集一致。
+ * 原样与脱敏两种采集各做一遍（脱敏后相等关系不变，唯一约束照常命中）
+ * @param out 逐项输出检查结果
+ * @return 是否全部通过
+ */
+bool runReplaySelfTest(QTextStream& out);
+
+#endif  // REPLAY_SELF_TEST_H
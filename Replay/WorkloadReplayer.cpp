@@ -0,0 +1,305 @@
+﻿// WorkloadReplayer.cpp - 负载日志重放实现
+#include "WorkloadReplayer.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonArray>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "BaseDatabaseManager.h"
+#include "DeviceDatabaseManager/DeviceSqlFunctions.h"
+#include "LatencyHistogram.h"
+
+namespace {
+
+constexpr int kMaxErrorSamples = 20;  // 报告中保留的错误条数
+
+/// 一组指纹相同的语句的统计
+struct FingerprintStats {
+  LatencyHistogram replay;    ///< 重放延迟
+  LatencyHistogram captured;  ///< 采集时的延迟
+  quint64 errors = 0;         ///< 重放失败次数
+  quint64 divergent = 0;      ///< 成败与采集时不一致的次数
+};
+
+}  // namespace
+
+/**
+ * @brief 单个重放线程的状态
+ */
+struct WorkloadReplayer::Worker {
+  QVector<QVector<int>> streams;  ///< 承接的各原线程的语句下标（按发起时间）
+  qint64* latencyNs = nullptr;    ///< 指向 m_latencyNs（各线程写不同下标）
+  bool* ok = nullptr;             ///< 指向 m_ok
+  LatencyHistogram lag;           ///< 调度滞后（仅按原时序重放）
+  QStringList errors;             ///< 前若干条错误
+};
+
+WorkloadReplayer::WorkloadReplayer(const WorkloadLog& log,
+                                   const ReplayOptions& options)
+    : m_log(log), m_options(options) {}
+
+void WorkloadReplayer::runWorker(Worker* w,
+                                 const QVector<ConnectionPool*>& pools,
+                                 const QElapsedTimer* clock) {
+  QVector<QString> names(pools.size());  // 各库的连接（首次用到时获取）
+
+  {
+    QVector<QSqlDatabase> dbs(pools.size());
+    QVector<int> cursor(w->streams.size(), 0);
+    QVector<int> txOwner(pools.size(), -1);  // 各库上事务未结束的原线程
+    int pinned = -1;  // 有未结束事务的原线程（-1 为无）
+    QElapsedTimer timer;
+
+    for (;;) {
+      int s = pinned;
+      if (s >= 0 && cursor[s] >= w->streams[s].size()) {
+        // 采集在事务中途结束，剩余的原线程照常交错
+        txOwner.fill(-1);
+        s = pinned = -1;
+      }
+      if (s < 0) {
+        qint64 earliest = std::numeric_limits<qint64>::max();
+        for (int i = 0; i < w->streams.size(); ++i) {
+          if (cursor[i] >= w->streams[i].size()) continue;
+          const qint64 offset =
+              m_log.statements[w->streams[i][cursor[i]]].offsetUs;
+          if (offset < earliest) {
+            earliest = offset;
+            s = i;
+          }
+        }
+        if (s < 0) break;
+      }
+
+      const int index = w->streams[s][cursor[s]++];
+      const CapturedStatement& st = m_log.statements[index];
+      const QString& sql = m_log.sql[st.sqlId];
+      const int d = static_cast<int>(st.database);
+
+      if (names[d].isEmpty()) {
+        names[d] = pools[d]->acquireConnection();
+        if (names[d].isEmpty()) {
+          w->errors << QString("获取连接失败: %1").arg(m_log.databases[d]);
+          break;
+        }
+        dbs[d] = QSqlDatabase::database(names[d]);
+      }
+
+      if (m_options.originalTiming) {
+        const qint64 dueNs = st.offsetUs * 1000;
+        qint64 nowNs = clock->nsecsElapsed();
+        if (nowNs < dueNs) {
+          std::this_thread::sleep_for(std::chrono::nanoseconds(dueNs - nowNs));
+          nowNs = clock->nsecsElapsed();
+        }
+        w->lag.record(nowNs - dueNs);
+      }
+
+      // 与采集口径一致：只计 exec()，prepare 与读取结果集不计
+      QSqlQuery query(dbs[d]);
+      query.setForwardOnly(true);
+      bool ok = false;
+      qint64 ns = 0;
+      if (st.params.isEmpty()) {
+        timer.start();
+        ok = query.exec(sql);
+        ns = timer.nsecsElapsed();
+      } else if (query.prepare(sql)) {
+        for (const QVariant& v : st.params) query.addBindValue(v);
+        timer.start();
+        ok = query.exec();
+        ns = timer.nsecsElapsed();
+      }
+      if (ok) {
+        while (query.next()) {
+          // 读完结果集，与业务代码对连接的占用一致
+        }
+      } else if (w->errors.size() < kMaxErrorSamples) {
+        w->errors << QString("[%1] %2: %3")
+                         .arg(m_log.databases[d], m_log.fingerprints[st.sqlId],
+                              query.lastError().text());
+      }
+      w->latencyNs[index] = ns;
+      w->ok[index] = ok;
+
+      // 事务按库跟踪：只有本线程在某个库上仍有事务时才保持钉住
+      if (sql == "BEGIN") {
+        if (ok) txOwner[d] = s;
+      } else if (sql == "COMMIT" || sql == "ROLLBACK") {
+        txOwner[d] = -1;
+      }
+      pinned = txOwner.contains(s) ? s : -1;
+    }
+  }
+  for (int d = 0; d < names.size(); ++d) {
+    if (!names[d].isEmpty()) pools[d]->releaseConnection(names[d]);
+  }
+}
+
+QJsonObject WorkloadReplayer::run() {
+  const int captured = m_log.threads.size();
+  const int threads =
+      m_options.threads > 0 ? m_options.threads : qMax(1, captured);
+  const int count = m_log.statements.size();
+  m_latencyNs.fill(-1, count);
+  m_ok.fill(false, count);
+
+  // 每个给出副本的库一个连接池；采集的语句与表达式索引可能用到设备库的
+  // 原生函数，各池都注册
+  std::vector<std::unique_ptr<ConnectionPool>> ownedPools;
+  QVector<ConnectionPool*> pools(m_log.databases.size(), nullptr);
+  QJsonArray replayedDatabases;
+  for (int d = 0; d < m_log.databases.size(); ++d) {
+    const QString& name = m_log.databases[d];
+    const QString path = m_options.databases.value(name);
+    if (path.isEmpty()) continue;
+    DatabaseConfig config(QString("REPLAY_%1").arg(name), path);
+    config.maxConnections = threads;
+    config.busyTimeout = m_options.busyTimeoutMs;
+    ownedPools.push_back(std::make_unique<ConnectionPool>(config));
+    pools[d] = ownedPools.back().get();
+    pools[d]->setSqlFunctions(DeviceSqlFunctions::all());
+    replayedDatabases.append(name);
+  }
+
+  // 原线程 t 交给重放线程 t % threads，作为其第 t / threads 条流
+  QVector<Worker> workers(threads);
+  for (Worker& w : workers) {
+    w.streams.resize(captured / threads + 1);
+    w.latencyNs = m_latencyNs.data();
+    w.ok = m_ok.data();
+  }
+  qint64 unmapped = 0;
+  for (int i = 0; i < count; ++i) {
+    const CapturedStatement& st = m_log.statements[i];
+    if (!pools[static_cast<int>(st.database)]) {
+      ++unmapped;
+      continue;
+    }
+    const int t = static_cast<int>(st.thread);
+    workers[t % threads].streams[t / threads].append(i);
+  }
+
+  std::atomic<int> ready{0};
+  std::atomic<bool> go{false};
+  QElapsedTimer clock;
+  std::vector<std::thread> runners;
+  runners.reserve(threads);
+  for (int i = 0; i < threads; ++i) {
+    Worker* w = &workers[i];
+    runners.emplace_back([this, w, &pools, &clock, &ready, &go]() {
+      ready.fetch_add(1);
+      while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+      runWorker(w, pools, &clock);
+    });
+  }
+  // 所有线程就绪后再开始计时，原时序的零点对齐到这里
+  while (ready.load() < threads) std::this_thread::yield();
+  clock.start();
+  go.store(true, std::memory_order_release);
+  for (auto& t : runners) t.join();
+  const qint64 elapsedNs = clock.nsecsElapsed();
+
+  // 按指纹分组汇总
+  QHash<QString, int> groupOf;
+  QVector<FingerprintStats> groups;
+  QStringList groupNames;
+  LatencyHistogram replayAll;
+  LatencyHistogram capturedAll;
+  quint64 executed = 0;
+  quint64 errors = 0;
+  quint64 divergent = 0;
+  for (int i = 0; i < count; ++i) {
+    if (m_latencyNs[i] < 0) continue;
+    const CapturedStatement& st = m_log.statements[i];
+    const QString& fp = m_log.fingerprints[st.sqlId];
+    auto it = groupOf.constFind(fp);
+    if (it == groupOf.constEnd()) {
+      it = groupOf.insert(fp, groups.size());
+      groups.append(FingerprintStats());
+      groupNames << fp;
+    }
+    FingerprintStats& g = groups[it.value()];
+    const qint64 capturedNs = static_cast<qint64>(st.durationUs) * 1000;
+    g.replay.record(m_latencyNs[i]);
+    g.captured.record(capturedNs);
+    replayAll.record(m_latencyNs[i]);
+    capturedAll.record(capturedNs);
+    ++executed;
+    if (!m_ok[i]) {
+      ++g.errors;
+      ++errors;
+    }
+    if (m_ok[i] != st.ok) {
+      ++g.divergent;
+      ++divergent;
+    }
+  }
+
+  // 按重放总耗时降序，最值得优化的语句排在前面
+  QVector<int> order(groups.size());
+  QVector<QJsonObject> replayJson(groups.size());
+  QVector<double> totalUs(groups.size());
+  for (int i = 0; i < order.size(); ++i) {
+    order[i] = i;
+    replayJson[i] = groups[i].replay.toJson();
+    totalUs[i] = replayJson[i]["mean"].toDouble() * groups[i].replay.count();
+  }
+  std::sort(order.begin(), order.end(),
+            [&totalUs](int a, int b) { return totalUs[a] > totalUs[b]; });
+
+  QJsonArray fingerprints;
+  for (int i : order) {
+    QJsonObject o;
+    o["fingerprint"] = groupNames[i];
+    o["latencyUs"] = replayJson[i];
+    o["capturedUs"] = groups[i].captured.toJson();
+    o["totalMs"] = totalUs[i] / 1000.0;
+    o["errors"] = static_cast<qint64>(groups[i].errors);
+    o["divergent"] = static_cast<qint64>(groups[i].divergent);
+    fingerprints.append(o);
+  }
+
+  LatencyHistogram lag;
+  QJsonArray errorSamples;
+  for (const Worker& w : workers) {
+    lag.merge(w.lag);
+    for (const QString& e : w.errors) {
+      if (errorSamples.size() < kMaxErrorSamples) errorSamples.append(e);
+    }
+  }
+
+  const qint64 capturedSpanUs =
+      count > 0 ? m_log.statements.last().offsetUs : 0;
+  QJsonObject summary;
+  summary["threads"] = threads;
+  summary["capturedThreads"] = captured;
+  summary["databases"] = replayedDatabases;
+  summary["timing"] = m_options.originalTiming ? "original" : "fast";
+  summary["statements"] = static_cast<qint64>(executed);
+  summary["skipped"] = count - static_cast<qint64>(executed);
+  summary["unmapped"] = unmapped;
+  summary["errors"] = static_cast<qint64>(errors);
+  summary["divergent"] = static_cast<qint64>(divergent);
+  summary["elapsedMs"] = elapsedNs / 1e6;
+  summary["capturedSpanMs"] = capturedSpanUs / 1000.0;
+  summary["opsPerSec"] = elapsedNs > 0 ? executed * 1e9 / elapsedNs : 0.0;
+  summary["latencyUs"] = replayAll.toJson();
+  summary["capturedUs"] = capturedAll.toJson();
+  if (m_options.originalTiming) summary["lagUs"] = lag.toJson();
+
+  QJsonObject report;
+  report["run"] = summary;
+  report["fingerprints"] = fingerprints;
+  report["errors"] = errorSamples;
+  return report;
+}
@@ -0,0 +1,67 @@
+﻿// WorkloadReplayer.h - 负载日志重放
+#ifndef WORKLOAD_REPLAYER_H
+#define WORKLOAD_REPLAYER_H
+
+#include <QHash>
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+
+#include "WorkloadCapture.h"
+
+class ConnectionPool;
+class QElapsedTimer;
+
+/**
+ * @brief 重放参数
+ */
+struct ReplayOptions {
+  /// 数据库名 → 重放用的副本；日志中未列出的库的语句不重放（计入跳过）
+  QHash<QString, QString> databases;
+  int threads = 0;              ///< 重放线程数（0 为采集时的线程数）
+  bool originalTiming = false;  ///< 按采集时的发起时间重放，否则尽快重放
+  int busyTimeoutMs = 5000;     ///< 连接的忙等超时
+};
+
+/**
+ * @brief 负载重放器
+ * 采集时的线程 t 映射到重放线程 t % threads，同一原线程的语句保持原序。
+ * 每条语句在其所属库的副本上执行：重放线程对每个库各持一条连接，事务
+ * 按（原线程，库）跟踪，一个库上的 COMMIT 不会结束另一个库上的事务。
+ * 一个重放线程承接多个原线程时按发起时间交错执行，但某个原线程开启的
+ * 事务在它提交或回滚之前不切换到其他原线程，避免在同一连接上嵌套事务。
+ *
+ * 延迟只计 exec()（与采集口径一致），结果集随后读完但不计时。按原时序
+ * 重放时另报告调度滞后：实际发起时间晚于计划时间的程度，滞后持续偏大
+ * 说明重放线程不够或副本跟不上原负载。
+ */
+class WorkloadReplayer {
+ public:
+  /**
+   * @brief 构造函数
+   * @param log 已读取的负载日志
+   * @param options 重放参数
+   */
+  WorkloadReplayer(const WorkloadLog& log, const ReplayOptions& options);
+
+  /**
+   * @brief 执行重放
+   * @return 报告：run 为总体统计，fingerprints 为按指纹分组的延迟
+   * （按重放总耗时降序），errors 为前若干条错误
+   */
+  QJsonObject run();
+
+ private:
+  struct Worker;
+
+  /// 重放一个线程承接的全部语句（pools 按日志的数据库序号索引）
+  void runWorker(Worker* w, const QVector<ConnectionPool*>& pools,
+                 const QElapsedTimer* clock);
+
+  const WorkloadLog& m_log;     ///< 负载日志
+  ReplayOptions m_options;      ///< 重放参数
+  QVector<qint64> m_latencyNs;  ///< 各语句的重放延迟（-1 为未执行）
+  QVector<bool> m_ok;           ///< 各语句重放是否成功
+};
+
+#endif  // WORKLOAD_REPLAYER_H
@@ -0,0 +1,193 @@
+﻿// main.cpp - 负载日志重放程序
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QTextStream>
+
+#include "BenchmarkRunner.h"
+#include "ReplaySelfTest.h"
+#include "WorkloadReplayer.h"
+
+namespace {
+
+bool g_verbose = false;
+
+// 重放期间只保留警告以上的框架日志
+void replayMessageHandler(QtMsgType type, const QMessageLogContext&,
+                          const QString& msg) {
+  if (!g_verbose && (type == QtDebugMsg || type == QtInfoMsg)) return;
+  QTextStream(stderr) << msg << '\n';
+}
+
+/**
+ * @brief 把源库（连同未检查点的 -wal）复制为重放副本
+ * @return 是否成功
+ */
+bool copyDatabase(const QString& source, const QString& target) {
+  for (const QString& suffix : {QString(), QString("-wal"), QString("-shm")}) {
+    QFile::remove(target + suffix);
+  }
+  if (!QFile::copy(source, target)) return false;
+  // -shm 由首个连接重建，只需带上 -wal
+  if (QFile::exists(source + "-wal") &&
+      !QFile::copy(source + "-wal", target + "-wal")) {
+    return false;
+  }
+  return true;
+}
+
+void removeDatabase(const QString& path) {
+  for (const QString& suffix : {QString(), QString("-wal"), QString("-shm")}) {
+    QFile::remove(path + suffix);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  QCoreApplication app(argc, argv);
+  app.setApplicationName("DataBaseReplay");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      "在数据库副本上重放 WorkloadCapture 采集的负载日志并报告延迟分布");
+  parser.addHelpOption();
+  parser.addOptions({
+      {"log", "负载日志文件", "file"},
+      {"database",
+       "源数据库 NAME=file（可重复，NAME 为采集时的库名；日志只含一个库时"
+       "可只给 file）。只读取，重放在其副本上进行，未给出的库的语句跳过",
+       "file"},
+      {"work", "副本路径（仅一个库时可用，默认源库旁的 .replay.db）", "file"},
+      {"keep", "结束后保留副本"},
+      {"threads", "重放线程数（0 为采集时的线程数）", "n", "0"},
+      {"timing", "original 按原时序重放，fast 尽快重放", "mode", "fast"},
+      {"busy-timeout", "连接的忙等超时（毫秒）", "ms", "5000"},
+      {"output", "JSON结果文件（默认输出到标准输出）", "file"},
+      {"verbose", "保留框架的调试与信息日志"},
+      {"self-test", "在临时库上做一次采集—重放往返自检后退出"},
+  });
+  parser.process(app);
+
+  g_verbose = parser.isSet("verbose");
+  qInstallMessageHandler(replayMessageHandler);
+  QTextStream err(stderr);
+
+  if (parser.isSet("self-test")) return runReplaySelfTest(err) ? 0 : 1;
+
+  if (!parser.isSet("log") || !parser.isSet("database")) {
+    err << "必须指定 --log 与 --database\n";
+    return 2;
+  }
+  const QString timing = parser.value("timing");
+  if (timing != "original" && timing != "fast") {
+    err << "无效的重放时序: " << timing << '\n';
+    return 2;
+  }
+
+  WorkloadLog log;
+  QString error;
+  if (!WorkloadCapture::read(parser.value("log"), &log, &error)) {
+    err << error << '\n';
+    return 1;
+  }
+
+  // 语句按采集时所属的库在各自的副本上重放
+  QHash<QString, QString> sources;
+  for (const QString& value : parser.values("database")) {
+    const int eq = value.indexOf('=');
+    if (eq > 0) {
+      sources.insert(value.left(eq), value.mid(eq + 1));
+    } else if (log.databases.size() == 1) {
+      sources.insert(log.databases.first(), value);
+    } else {
+      err << "日志含多个数据库，须以 NAME=file 指定: "
+          << log.databases.join(", ") << '\n';
+      return 2;
+    }
+  }
+  for (auto it = sources.constBegin(); it != sources.constEnd(); ++it) {
+    if (!log.databases.contains(it.key())) {
+      err << "日志中没有数据库: " << it.key() << '\n';
+      return 2;
+    }
+  }
+  if (parser.isSet("work") && sources.size() != 1) {
+    err << "--work 只能与一个数据库同用\n";
+    return 2;
+  }
+
+  ReplayOptions options;
+  QJsonObject databases;
+  for (auto it = sources.constBegin(); it != sources.constEnd(); ++it) {
+    const QString& source = it.value();
+    const QString work =
+        parser.isSet("work") ? parser.value("work") : source + ".replay.db";
+    if (QFileInfo(work).absoluteFilePath() ==
+        QFileInfo(source).absoluteFilePath()) {
+      err << "副本路径不能与源库相同\n";
+      return 2;
+    }
+    if (!copyDatabase(source, work)) {
+      err << "复制数据库失败: " << source << " -> " << work << '\n';
+      return 1;
+    }
+    options.databases.insert(it.key(), work);
+    databases[it.key()] = source;
+  }
+  options.threads = qMax(0, parser.value("threads").toInt());
+  options.originalTiming = timing == "original";
+  options.busyTimeoutMs = qMax(0, parser.value("busy-timeout").toInt());
+
+  err << QString("重放 %1 条语句（%2 个原线程）\n")
+             .arg(log.statements.size())
+             .arg(log.threads.size());
+  err.flush();
+
+  WorkloadReplayer replayer(log, options);
+  QJsonObject report = replayer.run();
+  if (!parser.isSet("keep")) {
+    for (const QString& work : options.databases) removeDatabase(work);
+  }
+
+  const QJsonObject run = report["run"].toObject();
+  err << QString("完成: %1 ms，%2 ops/s，失败 %3，与采集不一致 %4，"
+                 "p50 %5 us，p99 %6 us\n")
+             .arg(run["elapsedMs"].toDouble(), 0, 'f', 1)
+             .arg(run["opsPerSec"].toDouble(), 0, 'f', 1)
+             .arg(run["errors"].toInt())
+             .arg(run["divergent"].toInt())
+             .arg(run["latencyUs"].toObject()["p50"].toDouble(), 0, 'f', 1)
+             .arg(run["latencyUs"].toObject()["p99"].toDouble(), 0, 'f', 1);
+
+  QJsonObject meta = BenchmarkRunner::environment();
+  meta["mode"] = "replay";
+  meta["log"] = parser.value("log");
+  meta["databases"] = databases;
+  meta["capturedAt"] =
+      QDateTime::fromMSecsSinceEpoch(log.startedAtMs).toString(Qt::ISODate);
+  meta["redacted"] = log.redaction != WorkloadRedaction::NONE;
+#ifdef DB_SQLITE_NATIVE
+  meta["sqliteNative"] = true;
+#else
+  meta["sqliteNative"] = false;
+#endif
+  report["schema"] = 1;
+  report["meta"] = meta;
+
+  const QByteArray json = QJsonDocument(report).toJson();
+  if (parser.isSet("output")) {
+    QFile file(parser.value("output"));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+      err << "无法写入结果文件: " << file.fileName() << '\n';
+      return 1;
+    }
+    file.write(json);
+  } else {
+    QTextStream(stdout) << json;
+  }
+  return 0;
+}
@@ -5,13 +5,30 @@
 #include <QCoreApplication>
 #include <QDebug>
 #include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QTemporaryDir>
 #include <QTextCodec>
+#include <QThread>
 #include <QTimer>
+#include <limits>
 #include <thread>
 
+#include "DataDatabaseManager/FileAttachmentTable.h"
+#include "DataDatabaseManager/SystemLogTable.h"
 #include "DatabaseRegistry.h"
 #include "DeviceDatabaseManager/CameraInfoTable.h"
 #include "DeviceDatabaseManager/DeviceDataBaseStruct.h"
+#include "ExperimentDatabaseManager/ExperimentDataTable.h"
+#include "ExperimentDatabaseManager/ImageDataTable.h"
+#include "LazyTableModel.h"
+#include "LiveQuery.h"
+#include "QueryPlanChecker.h"
+#include "SystemDatabaseManager/OperationAuditTable.h"
+#include "TraceSpan.h"
+#include "WorkloadCapture.h"
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -86,12 +103,33 @@ class DatabaseTestExample : public QObject {
 
     // 基础功能测试
     testDatabaseRegistry();
+    testStartupReport();
     testDeviceDatabaseBasicOperations();
     testCameraInfoCRUD();
     testCameraInfoAdvancedQueries();
     testBatchOperations();
     testTransactionOperations();
     testDatabaseMaintenance();
+    testSystemLog();
+    testOperationAudit();
+    testChangeFeed();
+    testLiveQuery();
+    testMirroredTable();
+    testLazyTableModel();
+    testImageData();
+    testExperimentData();
+    testFileAttachment();
+    testDbResultMoves();
+    testStringInterning();
+    testColumnarResult();
+    testTracing();
+    testLockProfiler();
+    testQueryPlans();
+    testWorkloadCapture();
+    testNativeStatements();
+    testSqlFunctions();
+    testSerialIndex();
+    testTableQuery();
     testPerformance();
     testConcurrency();
 
@@ -169,6 +207,46 @@ class DatabaseTestExample : public QObject {
     TEST_ASSERT(deviceDb->isOpen(), "设备数据库已打开");
   }
 
+  /**
+   * @brief 测试启动阶段报告
+   */
+  void testStartupReport() {
+    qInfo() << "\n[测试启动阶段报告]";
+
+    const QJsonObject report = m_registry->startupReport();
+    QSet<QString> registryPhases;
+    for (const QJsonValue& v : report["phases"].toArray()) {
+      registryPhases.insert(v.toObject()["name"].toString());
+    }
+    TEST_ASSERT(report["ok"].toBool() && report["totalUs"].toDouble() > 0 &&
+                    registryPhases.contains("dataDirectory") &&
+                    registryPhases.contains("register[DeviceDB]"),
+                "注册中心记录了目录与各库注册阶段");
+
+    const QJsonObject device =
+        report["databases"].toObject()["DeviceDB"].toObject();
+    QSet<QString> phases;
+    bool finished = true;
+    qint64 childUs = 0;
+    qint64 createTablesUs = 0;
+    for (const QJsonValue& v : device["phases"].toArray()) {
+      const QJsonObject p = v.toObject();
+      const QString name = p["name"].toString();
+      const qint64 us = static_cast<qint64>(p["durationUs"].toDouble());
+      phases.insert(name);
+      finished = finished && us >= 0;
+      if (name == "createTables") createTablesUs = us;
+      if (name.startsWith("createTable[")) childUs += us;
+    }
+    TEST_ASSERT(phases.contains("open") && phases.contains("configure") &&
+                    phases.contains("pragma.journal_mode") &&
+                    phases.contains("createTable[camera_info]") &&
+                    phases.contains("healthTimer"),
+                "设备库记录了打开、PRAGMA、建表与健康检查阶段");
+    TEST_ASSERT(finished && childUs <= createTablesUs,
+                "各阶段均已结束且子阶段耗时不超过父阶段");
+  }
+
   /**
    * @brief 测试设备数据库基本操作
    */
@@ -461,7 +539,1478 @@ class DatabaseTestExample : public QObject {
     if (allStats.contains(DatabaseType::DEVICE_DB)) {
       auto deviceStats = allStats[DatabaseType::DEVICE_DB];
       TEST_ASSERT(deviceStats.totalQueries > 0, "设备数据库有查询统计");
+
+      // 内存统计至少覆盖主连接；未以 sqlite_native 构建时为空
+      if (SqliteMemory::available()) {
+        TEST_ASSERT(deviceStats.sqlite.connections >= 1, "内存统计覆盖连接");
+        TEST_ASSERT(deviceStats.sqlite.cacheUsedBytes > 0, "页缓存占用已采集");
+        TEST_ASSERT(deviceStats.sqliteProcess.memoryUsedBytes > 0,
+                    "进程级内存已采集");
+      } else {
+        TEST_ASSERT(!deviceStats.sqlite.available, "非原生构建无内存统计");
+      }
+    }
+  }
+
+  /**
+   * @brief 测试系统日志汇聚器
+   */
+  void testSystemLog() {
+    qInfo() << "\n[测试系统日志汇聚器]";
+
+    DataDatabaseManager* dataDb = DATA_DB();
+    TEST_ASSERT(dataDb != nullptr, "获取数据管理数据库");
+    if (!dataDb) return;
+
+    SystemLogTable* logTable = dataDb->systemLogTable();
+    TEST_ASSERT(logTable != nullptr, "获取系统日志表");
+    TEST_ASSERT(SystemLogSink::instance()->isRunning(), "日志汇聚器已启动");
+
+    const qint64 since = QDateTime::currentMSecsSinceEpoch();
+    const QString marker = "sink_" + QUuid::createUuid().toString();
+
+    // logOperation() 只入队，由写线程批量落盘
+    auto* ops = DEVICE_DB()->cameraInfoTable()->operations();
+    for (int i = 0; i < 20; ++i) {
+      ops->logOperation("日志汇聚测试", marker);
+    }
+    qWarning() << "日志汇聚测试告警" << marker;
+
+    TEST_ASSERT(SystemLogSink::instance()->flush(5000), "日志已全部写出");
+
+    auto logs = logTable->selectByTimeRange(
+        since, QDateTime::currentMSecsSinceEpoch(), LogLevel::DEBUG, 10000);
+    TEST_ASSERT(logs.success, "按时间范围查询日志");
+
+    int fromOps = 0;
+    int fromQt = 0;
+    for (const SystemLogRecord& r : logs.data) {
+      if (r.message == marker && r.source == "camera_info") fromOps++;
+      if (r.level == LogLevel::WARNING && r.message.contains(marker)) fromQt++;
+    }
+    TEST_ASSERT(fromOps == 20, "logOperation记录已落盘");
+    TEST_ASSERT(fromQt == 1, "Qt消息处理器记录已落盘");
+
+    // 按ID批量重读：一条 IN 查询，不存在的ID不出现在结果中
+    QList<int> ids;
+    for (const SystemLogRecord& r : logs.data) ids.append(r.id);
+    ids.append(std::numeric_limits<int>::max());
+    auto byIds = logTable->selectByIds(ids);
+    TEST_ASSERT(byIds.success && byIds.data.size() == logs.data.size() &&
+                    byIds.data.value(logs.data.first().id).message ==
+                        logs.data.first().message,
+                "按ID批量查询日志");
+
+    auto stats = dataDb->logSinkStats();
+    TEST_ASSERT(stats.batches > 0 && stats.written > 0, "汇聚器批量写入计数");
+    qInfo() << QString("  汇聚器: 入队 %1, 写出 %2, 批次 %3, 丢弃 %4")
+                   .arg(stats.enqueued)
+                   .arg(stats.written)
+                   .arg(stats.batches)
+                   .arg(stats.dropped);
+  }
+
+  /**
+   * @brief 测试操作审计与哈希链
+   */
+  void testOperationAudit() {
+    qInfo() << "\n[测试操作审计]";
+
+    SystemDatabaseManager* systemDb = SYSTEM_DB();
+    TEST_ASSERT(systemDb != nullptr, "获取系统管理数据库");
+    if (!systemDb) return;
+
+    OperationAuditTable* auditTable = systemDb->operationAuditTable();
+    TEST_ASSERT(auditTable != nullptr, "获取操作审计表");
+    TEST_ASSERT(AuditTrail::instance()->isRunning(), "审计采集器已启动");
+
+    DeviceDatabaseManager* deviceDb = DEVICE_DB();
+    const QString table = deviceDb->cameraInfoTable()->operations()->tableName();
+
+    // 插入、更新、删除各产生一条审计记录
+    CameraInfo camera = createTestCamera("_audit");
+    auto added = deviceDb->addCamera(camera);
+    TEST_ASSERT(added.success, "审计测试插入相机");
+    if (!added.success) return;
+    const int cameraId = added.data;
+
+    camera.id = cameraId;
+    camera.name = "审计更新";
+    TEST_ASSERT(deviceDb->updateCamera(camera).success, "审计测试更新相机");
+    TEST_ASSERT(deviceDb->removeCamera(cameraId).success, "审计测试删除相机");
+
+    TEST_ASSERT(AuditTrail::instance()->flush(5000), "审计记录已全部写出");
+
+    auto history = auditTable->selectByRecord(table, cameraId);
+    TEST_ASSERT(history.success, "按记录查询审计历史");
+    TEST_ASSERT(history.data.size() >= 3, "插入/更新/删除均有审计记录");
+    if (history.data.size() >= 3) {
+      const int n = history.data.size();
+      TEST_ASSERT(history.data[n - 3].action == AuditAction::INSERT &&
+                      history.data[n - 2].action == AuditAction::UPDATE &&
+                      history.data[n - 1].action == AuditAction::REMOVE,
+                  "审计动作顺序正确");
+    }
+
+    // 回滚的事务不产生审计记录
+    const quint64 enqueuedBefore = systemDb->auditStats().enqueued;
+    TEST_ASSERT(deviceDb->beginTransaction(), "开始事务");
+    auto rolledBack = deviceDb->addCamera(createTestCamera("_audit_rb"));
+    TEST_ASSERT(rolledBack.success, "事务内插入相机");
+    TEST_ASSERT(deviceDb->rollbackTransaction(), "回滚事务");
+    TEST_ASSERT(systemDb->auditStats().enqueued == enqueuedBefore,
+                "回滚事务无审计记录");
+
+    // 延迟缓冲按数据库区分：另一个库的提交不会释放回滚事务中的记录
+    DataDatabaseManager* dataDb = DATA_DB();
+    TEST_ASSERT(deviceDb->beginTransaction(), "开始设备库事务");
+    auto interleaved = deviceDb->addCamera(createTestCamera("_audit_x"));
+    TEST_ASSERT(interleaved.success, "设备库事务内插入相机");
+    TEST_ASSERT(dataDb->beginTransaction(), "开始数据库事务");
+    TEST_ASSERT(deviceDb->rollbackTransaction(), "回滚设备库事务");
+    TEST_ASSERT(dataDb->commitTransaction(), "提交数据库事务");
+    TEST_ASSERT(systemDb->auditStats().enqueued == enqueuedBefore,
+                "交错事务中回滚的记录未入队");
+
+    // 落盘失败的批次留在队首，恢复后按原顺序写出
+    {
+      AsyncBatchWriter<int> writer;
+      AsyncBatchWriter<int>::Options options;
+      options.flushIntervalMs = 10;
+      options.retainFailedBatches = true;
+      QVector<int> stored;
+      int failures = 2;
+      writer.start(options, [&](QVector<int>& batch) {
+        if (failures > 0) {
+          --failures;
+          return false;
+        }
+        stored += batch;
+        return true;
+      });
+      for (int i = 0; i < 5; ++i) writer.push(int(i));
+      TEST_ASSERT(writer.flush(5000), "失败批次重试后写出");
+      writer.stop();
+      TEST_ASSERT(stored == (QVector<int>{0, 1, 2, 3, 4}), "重试保持原顺序");
+      TEST_ASSERT(writer.stats().failed == 0, "重试成功的批次不计失败");
+    }
+
+    // 落盘持续失败使队列满：阻塞的生产者限时等待后丢弃，不会无限停顿
+    {
+      AsyncBatchWriter<int> writer;
+      AsyncBatchWriter<int>::Options options;
+      options.capacity = 4;
+      options.batchSize = 2;
+      options.flushIntervalMs = 10;
+      options.overflowPolicy = OverflowPolicy::BLOCK;
+      options.retainFailedBatches = true;
+      options.blockTimeoutMs = 50;
+      std::atomic<bool> storeDown(true);
+      writer.start(options, [&](QVector<int>&) { return !storeDown.load(); });
+      QElapsedTimer timer;
+      timer.start();
+      for (int i = 0; i < 100; ++i) writer.push(int(i));
+      TEST_ASSERT(timer.elapsed() < 2000 && writer.stats().dropped > 0,
+                  "队列满时限时等待后丢弃");
+      storeDown.store(false);
+      TEST_ASSERT(writer.flush(5000) && writer.push(int(100)),
+                  "落盘恢复后继续入队");
+      writer.stop();
+    }
+
+    // 审计表只追加，哈希链完整
+    TEST_ASSERT(!auditTable->deleteById(1).success, "审计记录不可删除");
+    auto verified = auditTable->verifyChain();
+    TEST_ASSERT(verified.success, "审计哈希链校验通过");
+    qInfo() << QString("  哈希链已校验 %1 条记录").arg(verified.data);
+  }
+
+  /**
+   * @brief 测试变更捕获流
+   */
+  void testChangeFeed() {
+    qInfo() << "\n[测试变更捕获流]";
+
+    DeviceDatabaseManager* deviceDb = DEVICE_DB();
+    ChangeFeed* feed = deviceDb->changeFeed();
+    TEST_ASSERT(feed != nullptr, "获取设备数据库变更流");
+    if (!feed) return;
+
+    QMutex mutex;
+    QVector<ChangeTransaction> received;
+    ChangeFeed::SubscribeOptions options;
+    options.tables = {"camera_info"};
+    const quint64 id = feed->subscribe(
+        [&](QVector<ChangeTransaction>& batch) {
+          QMutexLocker locker(&mutex);
+          received += batch;
+          return true;
+        },
+        options);
+
+    auto added = deviceDb->addCamera(createTestCamera("_cdc"));
+    TEST_ASSERT(added.success, "写入相机产生变更");
+    deviceDb->cameraInfoTable()->deleteById(added.data);
+    TEST_ASSERT(feed->flush(id, 5000), "订阅已消费全部变更");
+
+    {
+      QMutexLocker locker(&mutex);
+      bool sawInsert = false, sawRemove = false, ordered = true;
+      quint64 lastSequence = 0;
+      for (const ChangeTransaction& tx : received) {
+        ordered = ordered && tx.sequence > lastSequence;
+        lastSequence = tx.sequence;
+        for (const ChangeEvent& e : tx.changes) {
+          if (e.rowid != added.data) continue;
+          sawInsert = sawInsert || e.op == ChangeOp::INSERT;
+          sawRemove = sawRemove || e.op == ChangeOp::REMOVE;
+        }
+      }
+      TEST_ASSERT(sawInsert && sawRemove, "收到插入与删除变更");
+      TEST_ASSERT(ordered, "事务按提交序号递增");
+    }
+
+    // 原始SQL绕过表类，只有原生钩子能捕获
+    if (ChangeFeed::nativeHooksAvailable()) {
+      auto raw = deviceDb->addCamera(createTestCamera("_cdc_raw"));
+      deviceDb->cameraInfoTable()->operations()->executeQuery(
+          "UPDATE camera_info SET version = 'raw' WHERE id = ?", {raw.data});
+      TEST_ASSERT(feed->flush(id, 5000), "原始SQL变更已消费");
+
+      QMutexLocker locker(&mutex);
+      bool sawRawUpdate = false;
+      for (const ChangeTransaction& tx : received) {
+        for (const ChangeEvent& e : tx.changes) {
+          sawRawUpdate = sawRawUpdate ||
+                         (e.rowid == raw.data && e.op == ChangeOp::UPDATE);
+        }
+      }
+      TEST_ASSERT(sawRawUpdate, "捕获原始SQL更新");
+    }
+
+    // 变更只在事务提交后发布，回滚的写入从不发布
+    auto sawRow = [&](int rowid) {
+      QMutexLocker locker(&mutex);
+      for (const ChangeTransaction& tx : received) {
+        for (const ChangeEvent& e : tx.changes) {
+          if (e.rowid == rowid) return true;
+        }
+      }
+      return false;
+    };
+    TEST_ASSERT(deviceDb->beginTransaction(), "开始事务");
+    auto pending = deviceDb->addCamera(createTestCamera("_cdc_tx"));
+    feed->flush(id, 5000);
+    TEST_ASSERT(!sawRow(pending.data), "未提交的写入不发布");
+    TEST_ASSERT(deviceDb->commitTransaction(), "提交事务");
+    TEST_ASSERT(feed->flush(id, 5000) && sawRow(pending.data),
+                "提交后发布事务变更");
+
+    TEST_ASSERT(deviceDb->beginTransaction(), "开始待回滚事务");
+    auto discarded = deviceDb->addCamera(createTestCamera("_cdc_rb"));
+    TEST_ASSERT(deviceDb->rollbackTransaction(), "回滚事务");
+    feed->flush(id, 5000);
+    TEST_ASSERT(!sawRow(discarded.data), "回滚的写入不发布");
+
+    feed->unsubscribe(id);
+  }
+
+  /**
+   * @brief 测试实时查询（初始结果 + 行级差异）
+   */
+  void testLiveQuery() {
+    qInfo() << "\n[测试实时查询]";
+
+    DeviceDatabaseManager* deviceDb = DEVICE_DB();
+    auto addNamed = [&](const QString& name) {
+      CameraInfo camera = createTestCamera("_live");
+      camera.name = name;
+      return deviceDb->addCamera(camera).data;
+    };
+    auto names = [](const QList<CameraInfo>& cameras) {
+      QStringList list;
+      for (const CameraInfo& c : cameras) list.append(c.name);
+      return list;
+    };
+
+    const int idB = addNamed("Live B");
+    const int idD = addNamed("Live D");
+
+    LiveQuerySpec spec;
+    spec.where = "manufacturer = ?";
+    spec.params = {"Framework Test Corp_live"};
+    spec.orderBy = "name";
+    spec.limit = 2;
+
+    // 按顺序应用差异，结果应始终与实时查询的快照一致
+    QMutex mutex;
+    QList<CameraInfo> applied;
+    LiveQuery<CameraInfo> live(
+        deviceDb->cameraInfoTable(), spec,
+        [&](const QVector<LiveRowChange<CameraInfo>>& diff) {
+          QMutexLocker locker(&mutex);
+          for (const auto& change : diff) {
+            switch (change.kind) {
+              case LiveChangeKind::INSERTED:
+                applied.insert(change.index, change.row);
+                break;
+              case LiveChangeKind::UPDATED:
+                applied[change.index] = change.row;
+                break;
+              case LiveChangeKind::REMOVED:
+                applied.removeAt(change.index);
+                break;
+              case LiveChangeKind::MOVED:
+                applied.move(change.fromIndex, change.index);
+                break;
+            }
+          }
+        });
+
+    auto initial = live.start();
+    TEST_ASSERT(initial.success, "启动实时查询");
+    if (!initial.success) return;
+    TEST_ASSERT(names(initial.data) == QStringList({"Live B", "Live D"}),
+                "初始结果按名称排序并受限");
+    {
+      QMutexLocker locker(&mutex);
+      applied = initial.data;
+    }
+
+    auto check = [&](const QStringList& expected, const QString& msg) {
+      live.flush(5000);
+      QMutexLocker locker(&mutex);
+      TEST_ASSERT(names(applied) == expected &&
+                      names(live.snapshot()) == expected,
+                  msg);
+    };
+
+    // 插入到窗口首位，末行被挤出
+    const int idA = addNamed("Live A");
+    check({"Live A", "Live B"}, "插入差异与窗口挤出");
+
+    // 排序键变化使行移出窗口，窗口由后续行补齐
+    CameraInfo b = deviceDb->cameraInfoTable()->selectById(idB).data;
+    b.name = "Live E";
+    deviceDb->updateCamera(b);
+    check({"Live A", "Live D"}, "更新移出窗口并补齐");
+
+    // 删除窗口内的行，补齐时取回已移出的行
+    deviceDb->cameraInfoTable()->deleteById(idA);
+    check({"Live D", "Live E"}, "删除差异与补齐");
+
+    live.stop();
+    deviceDb->cameraInfoTable()->deleteById(idB);
+    deviceDb->cameraInfoTable()->deleteById(idD);
+
+    // 队列溢出：回调阻塞期间的变更被丢弃，恢复后整体重载，结果不缺行
+    LiveQuerySpec overflowSpec;
+    overflowSpec.where = "manufacturer = ?";
+    overflowSpec.params = {"Framework Test Corp_live_of"};
+    overflowSpec.orderBy = "name";
+    overflowSpec.queueCapacity = 2;
+
+    std::atomic<bool> hold{true};
+    std::atomic<bool> entered{false};
+    QList<CameraInfo> overflowApplied;
+    LiveQuery<CameraInfo> overflowLive(
+        deviceDb->cameraInfoTable(), overflowSpec,
+        [&](const QVector<LiveRowChange<CameraInfo>>& diff) {
+          entered = true;
+          while (hold.load()) QThread::msleep(5);
+          QMutexLocker locker(&mutex);
+          for (const auto& change : diff) {
+            switch (change.kind) {
+              case LiveChangeKind::INSERTED:
+                overflowApplied.insert(change.index, change.row);
+                break;
+              case LiveChangeKind::UPDATED:
+                overflowApplied[change.index] = change.row;
+                break;
+              case LiveChangeKind::REMOVED:
+                overflowApplied.removeAt(change.index);
+                break;
+              case LiveChangeKind::MOVED:
+                overflowApplied.move(change.fromIndex, change.index);
+                break;
+            }
+          }
+        });
+    TEST_ASSERT(overflowLive.start().success, "启动小队列实时查询");
+
+    QList<int> overflowIds;
+    QStringList overflowNames;
+    auto addOverflow = [&](int i) {
+      CameraInfo camera = createTestCamera("_live_of");
+      camera.name = QString("Overflow %1").arg(i, 2, 10, QChar('0'));
+      overflowIds.append(deviceDb->addCamera(camera).data);
+      overflowNames.append(camera.name);
+    };
+    addOverflow(0);
+    QElapsedTimer waited;
+    waited.start();
+    while (!entered.load() && waited.elapsed() < 5000) QThread::msleep(5);
+    for (int i = 1; i < 12; ++i) addOverflow(i);
+    hold = false;
+
+    overflowLive.flush(5000);
+    {
+      QMutexLocker locker(&mutex);
+      TEST_ASSERT(names(overflowApplied) == overflowNames &&
+                      names(overflowLive.snapshot()) == overflowNames,
+                  "队列溢出后整体重载，结果完整");
+    }
+    overflowLive.stop();
+    for (int id : overflowIds) deviceDb->cameraInfoTable()->deleteById(id);
+  }
+
+  /**
+   * @brief 测试内存镜像表（写穿、快照隔离、绕过镜像的写入）
+   */
+  void testMirroredTable() {
+    qInfo() << "\n[测试内存镜像表]";
+
+    DeviceDatabaseManager* deviceDb = DEVICE_DB();
+    MirroredTable<CameraInfo>* mirror = deviceDb->cameraInfoMirror();
+    TEST_ASSERT(mirror != nullptr, "获取相机信息镜像");
+    if (!mirror) return;
+
+    deviceDb->cameraInfoTable()->operations()->truncateTable();
+    TEST_ASSERT(mirror->selectAll().data.isEmpty(), "清空表后镜像同步重载");
+
+    // 写穿：返回时镜像已包含该写入
+    auto added = deviceDb->addCamera(createTestCamera("_mirror"));
+    TEST_ASSERT(added.success, "经镜像写入相机");
+    auto cached = mirror->selectById(added.data);
+    TEST_ASSERT(cached.success && cached.data.createdAt.isValid(),
+                "镜像包含落盘后的完整行");
+
+    // 快照隔离：已取得的快照不受后续写入影响
+    const auto before = mirror->snapshot();
+    CameraInfo renamed = cached.data;
+    renamed.name = "Mirror Renamed";
+    TEST_ASSERT(deviceDb->updateCamera(renamed).success, "经镜像更新相机");
+    const auto after = mirror->snapshot();
+    TEST_ASSERT(before->rows.first().name != "Mirror Renamed" &&
+                    after->rows.first().name == "Mirror Renamed",
+                "旧快照保持不变，新快照可见更新");
+    TEST_ASSERT(after->version > before->version, "快照版本递增");
+
+    // 绕过镜像直接写表，经变更流在提交后应用
+    auto direct =
+        deviceDb->cameraInfoTable()->insert(createTestCamera("_mirror_direct"));
+    TEST_ASSERT(direct.success && mirror->flush() &&
+                    mirror->selectById(direct.data).success,
+                "绕过镜像的插入可见");
+    deviceDb->cameraInfoTable()->deleteById(direct.data);
+    TEST_ASSERT(mirror->flush() && !mirror->selectById(direct.data).success,
+                "绕过镜像的删除可见");
+
+    // 事务内的写入提交后才进入快照，本线程在事务中仍能读到自己的写入；
+    // 回滚的写入从不进入
+    TEST_ASSERT(deviceDb->beginTransaction(), "开始事务");
+    auto staged = deviceDb->addCamera(createTestCamera("_mirror_tx"));
+    TEST_ASSERT(staged.success && deviceDb->getCamera(staged.data).success,
+                "事务中读到本事务的写入");
+    TEST_ASSERT(!mirror->snapshot()->indexById.contains(staged.data),
+                "未提交的写入不进入快照");
+    TEST_ASSERT(deviceDb->commitTransaction(), "提交事务");
+    TEST_ASSERT(mirror->selectById(staged.data).success, "提交后镜像可见");
+
+    TEST_ASSERT(deviceDb->beginTransaction(), "开始待回滚事务");
+    auto discarded = deviceDb->addCamera(createTestCamera("_mirror_rb"));
+    CameraInfo unsaved = mirror->selectById(staged.data).data;
+    unsaved.name = "Mirror Rolled Back";
+    deviceDb->updateCamera(unsaved);
+    TEST_ASSERT(deviceDb->rollbackTransaction(), "回滚事务");
+    mirror->flush();
+    TEST_ASSERT(!mirror->selectById(discarded.data).success &&
+                    mirror->selectById(staged.data).data.name !=
+                        "Mirror Rolled Back",
+                "回滚的插入与更新不进入镜像");
+
+    // 增量维护的有序列表与默认排序一致
+    const auto ordered = mirror->snapshot();
+    bool sorted = true;
+    for (int i = 1; i < ordered->rows.size(); ++i) {
+      const QString& prev = ordered->rows.at(i - 1).name;
+      sorted = sorted && prev <= ordered->rows.at(i).name;
+    }
+    TEST_ASSERT(sorted, "快照按默认排序");
+    deviceDb->removeCamera(staged.data);
+
+    // 重新加载与增量应用结果一致
+    const auto incremental = mirror->selectAll().data;
+    TEST_ASSERT(mirror->load().success, "镜像整表重载");
+    TEST_ASSERT(mirror->selectAll().data.size() == incremental.size(),
+                "重载结果与增量结果一致");
+
+    deviceDb->removeCamera(added.data);
+  }
+
+  /**
+   * @brief 测试按需加载的表格模型
+   */
+  void testLazyTableModel() {
+    qInfo() << "\n[测试按需加载表格模型]";
+
+    CameraInfoTable* table = DEVICE_DB()->cameraInfoTable();
+    QList<int> ids;
+    for (int i = 0; i < 25; ++i) {
+      ids.append(table->insert(createTestCamera(QString("_lazy_%1").arg(i)))
+                     .data);
+    }
+    const int total = table->selectAll().data.size();
+
+    LazyTableModelOptions options;
+    options.pageSize = 10;
+    options.maxResidentPages = 2;
+    options.prefetchPages = 0;
+    LazyTableModel<CameraInfo> model(
+        table,
+        {{"名称", [](const CameraInfo& c) { return QVariant(c.name); }}},
+        options);
+    model.waitForIdle();
+    TEST_ASSERT(model.rowCount() == 10, "首页按页大小加载");
+
+    while (model.canFetchMore(QModelIndex())) {
+      model.fetchMore(QModelIndex());
+      model.waitForIdle();
+    }
+    TEST_ASSERT(model.rowCount() == total, "逐页加载到表末尾");
+    TEST_ASSERT(model.residentRowCount() <= 20, "常驻行数受页数上限约束");
+
+    // 首页已被淘汰，访问时在后台重读
+    const QModelIndex first = model.index(0, 0);
+    model.data(first);
+    model.waitForIdle();
+    auto expected = table->selectById(model.idAt(0));
+    TEST_ASSERT(model.data(first).toString() == expected.data.name,
+                "淘汰的行按需重读");
+
+    // 写入通知增量更新
+    auto added = table->insert(createTestCamera("_lazy_new"));
+    model.waitForIdle();
+    TEST_ASSERT(model.rowCount() == total + 1 &&
+                    model.idAt(total) == added.data,
+                "新增行追加到末尾");
+    table->deleteById(added.data);
+    model.waitForIdle();
+    TEST_ASSERT(model.rowCount() == total, "删除行从模型移除");
+
+    // 回滚的写入不进入模型
+    DeviceDatabaseManager* deviceDb = DEVICE_DB();
+    TEST_ASSERT(deviceDb->beginTransaction(), "开始事务");
+    TEST_ASSERT(table->insert(createTestCamera("_lazy_rb")).success,
+                "事务内插入相机");
+    TEST_ASSERT(deviceDb->rollbackTransaction(), "回滚事务");
+    model.waitForIdle();
+    TEST_ASSERT(model.rowCount() == total, "回滚的插入不留在模型中");
+
+    for (int id : ids) table->deleteById(id);
+  }
+
+  /**
+   * @brief 测试图像存储（内容寻址、映射读取、流式写入）
+   */
+  void testImageData() {
+    qInfo() << "\n[测试图像存储]";
+
+    ExperimentDatabaseManager* experimentDb = EXPERIMENT_DB();
+    TEST_ASSERT(experimentDb != nullptr, "获取实验项目数据库");
+    if (!experimentDb) return;
+
+    ImageDataTable* imageTable = experimentDb->imageDataTable();
+    TEST_ASSERT(imageTable != nullptr, "获取图像数据表");
+
+    ImageData image;
+    image.name = "test_frame";
+    image.width = 64;
+    image.height = 48;
+    image.pixelFormat = "Mono8";
+
+    QByteArray pixels(static_cast<int>(image.expectedByteSize()),
+                      Qt::Uninitialized);
+    for (int i = 0; i < pixels.size(); ++i) {
+      pixels[i] = static_cast<char>(i * 7);
     }
+
+    auto first = imageTable->insertImage(image, pixels);
+    TEST_ASSERT(first.success, "整帧写入图像");
+    if (!first.success) return;
+
+    // 元数据查询不读取像素
+    auto meta = imageTable->selectById(first.data);
+    TEST_ASSERT(meta.success && meta.data.byteSize == pixels.size(),
+                "查询图像元数据");
+
+    {
+      auto view = imageTable->openPixels(first.data);
+      TEST_ASSERT(view.success && view.data.size() == pixels.size(),
+                  "映射读取像素");
+      TEST_ASSERT(view.success && view.data.bytes() == pixels, "像素内容一致");
+    }
+
+    // 分块流式写入相同内容，应与第一帧共用一个内容对象
+    ImageStreamWriter writer = imageTable->beginImage(image);
+    for (int offset = 0; offset < pixels.size(); offset += 1000) {
+      writer.write(pixels.constData() + offset,
+                   qMin(1000, pixels.size() - offset));
+    }
+    auto second = writer.commit();
+    TEST_ASSERT(second.success, "流式写入图像");
+    if (!second.success) return;
+
+    const QString hash = meta.data.contentHash;
+    TEST_ASSERT(imageTable->selectById(second.data).data.contentHash == hash,
+                "相同像素内容去重");
+
+    auto byIds = imageTable->selectByIds({first.data, second.data, 0});
+    TEST_ASSERT(byIds.success && byIds.data.size() == 2 &&
+                    byIds.data.value(second.data).contentHash == hash,
+                "按ID批量查询图像元数据");
+
+    TEST_ASSERT(imageTable->deleteById(first.data).success, "删除第一帧");
+    TEST_ASSERT(imageTable->contentStore().contains(hash),
+                "仍被引用的像素内容保留");
+    TEST_ASSERT(imageTable->deleteById(second.data).success, "删除第二帧");
+    TEST_ASSERT(!imageTable->contentStore().contains(hash),
+                "无引用的像素内容已回收");
+
+    // 事务内删除后回滚：行恢复，像素内容不能已被回收
+    auto kept = imageTable->insertImage(image, pixels);
+    TEST_ASSERT(kept.success, "写入待回滚删除的图像");
+    TEST_ASSERT(experimentDb->beginTransaction(), "开始事务");
+    TEST_ASSERT(imageTable->deleteById(kept.data).success, "事务内删除图像");
+    TEST_ASSERT(imageTable->contentStore().contains(hash),
+                "提交前不回收像素内容");
+    TEST_ASSERT(experimentDb->rollbackTransaction(), "回滚事务");
+    {
+      auto view = imageTable->openPixels(kept.data);
+      TEST_ASSERT(view.success && view.data.bytes() == pixels,
+                  "回滚后像素内容仍可读取");
+    }
+
+    TEST_ASSERT(experimentDb->beginTransaction(), "开始事务");
+    TEST_ASSERT(imageTable->deleteById(kept.data).success, "事务内删除图像");
+    TEST_ASSERT(experimentDb->commitTransaction(), "提交事务");
+    TEST_ASSERT(!imageTable->contentStore().contains(hash),
+                "提交后回收像素内容");
+  }
+
+  /**
+   * @brief 测试实验数据分块存储与区间聚合
+   */
+  void testExperimentData() {
+    qInfo() << "\n[测试实验数据分块存储]";
+
+    ExperimentDatabaseManager* experimentDb = EXPERIMENT_DB();
+    TEST_ASSERT(experimentDb != nullptr, "获取实验项目数据库");
+    if (!experimentDb) return;
+
+    ExperimentDataTable* dataTable = experimentDb->experimentDataTable();
+    TEST_ASSERT(dataTable != nullptr, "获取实验数据表");
+
+    const int experimentId = 1;
+    const QString series = "test_ramp";
+    dataTable->deleteSeries(experimentId, series);
+
+    // 单调递增序列：值等于样本序号，分两次追加以覆盖尾块续写
+    const int total = ExperimentDataTable::kChunkSamples * 3 + 100;
+    QVector<double> first, second;
+    for (int i = 0; i < total; ++i) {
+      (i < 1000 ? first : second).append(static_cast<double>(i));
+    }
+    TEST_ASSERT(dataTable->appendSamples(experimentId, series, first).success,
+                "追加样本（首批）");
+    TEST_ASSERT(dataTable->appendSamples(experimentId, series, second).success,
+                "追加样本（续写尾块）");
+
+    auto all = dataTable->aggregate(experimentId, series);
+    TEST_ASSERT(all.success && all.data.count == total, "全序列计数");
+    TEST_ASSERT(all.success && all.data.chunksTotal == 4, "按固定大小切块");
+    TEST_ASSERT(all.success && all.data.chunksDecoded == 0,
+                "无过滤时全部由区间索引作答");
+    TEST_ASSERT(
+        all.success && qFuzzyCompare(all.data.mean(), (total - 1) / 2.0),
+        "全序列均值");
+
+    // 区间只覆盖第二块内部：其余块被跳过
+    const double lo = ExperimentDataTable::kChunkSamples + 10;
+    const double hi = ExperimentDataTable::kChunkSamples + 109;
+    auto ranged = dataTable->aggregate(experimentId, series, lo, hi);
+    TEST_ASSERT(ranged.success && ranged.data.count == 100, "区间计数");
+    TEST_ASSERT(ranged.success && ranged.data.min == lo &&
+                    ranged.data.max == hi,
+                "区间最值");
+    TEST_ASSERT(ranged.success && ranged.data.chunksSkipped == 3 &&
+                    ranged.data.chunksDecoded == 1,
+                "区间索引跳过无关块");
+
+    auto hist = dataTable->histogram(experimentId, series, 0, total - 1, 4);
+    qint64 histTotal = 0;
+    for (qint64 n : hist.data) histTotal += n;
+    TEST_ASSERT(hist.success && histTotal == total, "直方图计数守恒");
+
+    auto slice = dataTable->readSamples(
+        experimentId, series, ExperimentDataTable::kChunkSamples - 2, 4);
+    TEST_ASSERT(slice.success && slice.data.size() == 4 &&
+                    slice.data.first() ==
+                        ExperimentDataTable::kChunkSamples - 2,
+                "跨块读取样本");
+
+    auto removed = dataTable->deleteSeries(experimentId, series);
+    TEST_ASSERT(removed.success && removed.data == 4, "删除序列");
+  }
+
+  /**
+   * @brief 测试文件附件的内容去重、引用计数与回收
+   */
+  void testFileAttachment() {
+    qInfo() << "\n[测试文件附件存储]";
+
+    DataDatabaseManager* dataDb = DATA_DB();
+    TEST_ASSERT(dataDb != nullptr, "获取数据管理数据库");
+    if (!dataDb) return;
+
+    FileAttachmentTable* attachmentTable = dataDb->fileAttachmentTable();
+    TEST_ASSERT(attachmentTable != nullptr, "获取文件附件表");
+
+    QTemporaryDir dir;
+    TEST_ASSERT(dir.isValid(), "创建临时目录");
+    if (!dir.isValid()) return;
+
+    // 两份相同内容与一份不同内容
+    const QByteArray same(300 * 1024, 'a');
+    const QByteArray other = QUuid::createUuid().toByteArray().repeated(1000);
+    const QList<QPair<QString, QByteArray>> files = {
+        {"a.bin", same}, {"b.bin", same}, {"c.bin", other}};
+
+    const int ownerId = static_cast<int>(QDateTime::currentSecsSinceEpoch());
+    QList<AttachmentSource> sources;
+    for (const auto& f : files) {
+      QFile out(dir.filePath(f.first));
+      out.open(QIODevice::WriteOnly);
+      out.write(f.second);
+      out.close();
+
+      AttachmentSource source;
+      source.filePath = out.fileName();
+      source.ownerType = "test";
+      source.ownerId = ownerId;
+      sources.append(source);
+    }
+
+    auto ids = attachmentTable->attachFiles(sources, 3);
+    TEST_ASSERT(ids.success && ids.data.size() == 3, "并行导入附件");
+    if (!ids.success) return;
+
+    auto owned = attachmentTable->selectByOwner("test", ownerId);
+    TEST_ASSERT(owned.success && owned.data.size() == 3, "按对象查询附件");
+
+    const QString sameHash = attachmentTable->selectById(ids.data[0])
+                                 .data.contentHash;
+    TEST_ASSERT(
+        attachmentTable->selectById(ids.data[1]).data.contentHash == sameHash,
+        "相同内容共用一个对象");
+
+    {
+      auto view = attachmentTable->openContent(ids.data[2]);
+      TEST_ASSERT(view.success && view.data.bytes() == other, "附件内容一致");
+    }
+
+    for (int id : ids.data) attachmentTable->deleteById(id);
+    TEST_ASSERT(attachmentTable->contentStore().contains(sameHash),
+                "宽限期内的无引用内容保留");
+
+    auto purged = attachmentTable->collectGarbage(0);
+    TEST_ASSERT(purged.success && purged.data >= 2, "回收无引用内容");
+    TEST_ASSERT(!attachmentTable->contentStore().contains(sameHash),
+                "无引用内容已删除");
+  }
+
+  /**
+   * @brief 测试结果类型的移动语义与错误结果
+   */
+  void testDbResultMoves() {
+    qInfo() << "\n[测试结果类型移动语义]";
+
+    // 移入结果：节点地址不变，原列表被搬空
+    QList<CameraInfo> cameras{createTestCamera("_move")};
+    const CameraInfo* node = &cameras.constFirst();
+    auto moved = DbResult<QList<CameraInfo>>::Success(std::move(cameras));
+    TEST_ASSERT(moved.success && cameras.isEmpty() &&
+                    &moved.data.constFirst() == node,
+                "移入结果不复制列表");
+
+    // 错误结果复制共享空值，不再逐次默认构造T
+    struct Counted {
+      static int& constructions() {
+        static int n = 0;
+        return n;
+      }
+      Counted() { ++constructions(); }
+    };
+    DbResult<Counted>::Error("预热");
+    const int before = Counted::constructions();
+    for (int i = 0; i < 100; ++i) DbResult<Counted>::Error("失败");
+    TEST_ASSERT(Counted::constructions() == before, "错误结果不构造新的T");
+
+    PageParams params;
+    params.pageSize = 10;
+    auto page = DbResult<PageResult<CameraInfo>>::Emplace(
+        QList<CameraInfo>{createTestCamera("_page")}, 1, params);
+    TEST_ASSERT(page.success && page.data.totalCount == 1 &&
+                    page.data.totalPages == 1 && page.data.data.size() == 1,
+                "分页结果原地构造");
+
+    // 失败结果带错误类别，调用方不必匹配错误信息文本
+    CameraInfoTable* table = DEVICE_DB()->cameraInfoTable();
+    auto missing = table->selectById(std::numeric_limits<int>::max());
+    auto invalid = table->deleteById(0);
+    TEST_ASSERT(!missing.success &&
+                    missing.errorCode == DbErrorCode::NOT_FOUND &&
+                    invalid.errorCode == DbErrorCode::INVALID,
+                "失败结果带错误类别");
+    TEST_ASSERT(DbResult<int>::Success(1).errorCode == DbErrorCode::NONE &&
+                    DbResult<int>::Error("失败").errorCode ==
+                        DbErrorCode::OTHER,
+                "默认错误类别");
+  }
+
+  /**
+   * @brief 测试低基数列的字符串驻留
+   */
+  void testStringInterning() {
+    qInfo() << "\n[测试字符串驻留]";
+
+    // 有界：过长或池满时原样返回，不驻留
+    StringInterner interner(2, 8);
+    const QString a = interner.intern(QString("USB"));
+    TEST_ASSERT(interner.intern(QString("USB")).constData() == a.constData(),
+                "相同取值共享同一份数据");
+    interner.intern(QString("GigE"));
+    interner.intern(QString("CameraLink"));
+    interner.intern(QString("CoaXPress"));
+    const auto st = interner.stats();
+    TEST_ASSERT(st.entries == 2 && st.hits == 1 && st.rejected == 2,
+                "超长与池满的取值不驻留");
+    TEST_ASSERT(interner.intern(QString()).isNull(), "空值保持为空值");
+
+    // 行解码：同一制造商的各行共用一份字符串
+    CameraInfoTable* table = DEVICE_DB()->cameraInfoTable();
+    CameraInfo first = createTestCamera("_intern_1");
+    CameraInfo second = createTestCamera("_intern_2");
+    first.manufacturer = second.manufacturer = "Intern Test Corp";
+    auto id1 = table->insert(first);
+    auto id2 = table->insert(second);
+    auto r1 = table->selectById(id1.data);
+    auto r2 = table->selectById(id2.data);
+    TEST_ASSERT(r1.success && r2.success &&
+                    r1.data.manufacturer == "Intern Test Corp" &&
+                    r1.data.manufacturer.constData() ==
+                        r2.data.manufacturer.constData(),
+                "解码结果共享低基数列");
+    table->deleteById(id1.data);
+    table->deleteById(id2.data);
+  }
+
+  /**
+   * @brief 测试列式批量查询结果
+   */
+  void testColumnarResult() {
+    qInfo() << "\n[测试列式查询结果]";
+
+    CameraInfoTable* table = DEVICE_DB()->cameraInfoTable();
+    auto id1 = table->insert(createTestCamera("_columnar_1"));
+    auto id2 = table->insert(createTestCamera("_columnar_2"));
+
+    auto rows = table->selectAll();
+    auto columns = table->selectAllColumnar();
+    TEST_ASSERT(columns.success &&
+                    columns.data.rowCount() == rows.data.size() &&
+                    columns.data.columnCount() == 8,
+                "列式结果行数与逐行结果一致");
+
+    // 行视图逐列与实体一致，文本直接指向字符区
+    const int nameCol = columns.data.columnIndex("name");
+    const int createdCol = columns.data.columnIndex("created_at");
+    bool same = true;
+    int i = 0;
+    for (const auto row : columns.data) {
+      const CameraInfo& camera = rows.data.at(i++);
+      same = same && row.integer(0) == camera.id &&
+             row.text(nameCol).toString() == camera.name &&
+             row.dateTime(createdCol) == camera.createdAt;
+    }
+    TEST_ASSERT(same, "行视图访问结果一致");
+    TEST_ASSERT(columns.data.integers(0).size() == rows.data.size(),
+                "整数列连续存放");
+
+    table->deleteById(id1.data);
+    table->deleteById(id2.data);
+  }
+
+  /**
+   * @brief 测试区间追踪与追踪事件导出
+   */
+  void testTracing() {
+    qInfo() << "\n[测试区间追踪]";
+
+    CameraInfoTable* table = DEVICE_DB()->cameraInfoTable();
+    Tracer::clear();
+    Tracer::setEnabled(true);
+    auto id = table->insert(createTestCamera("_trace"));
+    Tracer::setEnabled(false);
+    TEST_ASSERT(id.success, "追踪期间插入成功");
+
+    QSet<QString> names;
+    bool wellFormed = true;
+    const QJsonObject root = QJsonDocument::fromJson(Tracer::toJson()).object();
+    for (const QJsonValue& v : root["traceEvents"].toArray()) {
+      const QJsonObject e = v.toObject();
+      if (e["ph"].toString() != "X") continue;
+      names.insert(e["name"].toString());
+      wellFormed = wellFormed && e["dur"].toDouble() >= 0 && e.contains("tid");
+    }
+    TEST_ASSERT(wellFormed && names.contains("camera.insert") &&
+                    names.contains("camera.serialExists") &&
+                    names.contains("pool.acquire") &&
+                    names.contains("table.lock") &&
+                    names.contains("sql.exec"),
+                "插入的各阶段均有区间记录");
+
+    // 关闭后不再记录
+    const quint64 before = Tracer::stats().events;
+    table->deleteById(id.data);
+    TEST_ASSERT(Tracer::stats().events == before, "关闭追踪后不再记录");
+    Tracer::clear();
+  }
+
+  /**
+   * @brief 测试互斥锁争用剖析
+   */
+  void testLockProfiler() {
+    qInfo() << "\n[测试互斥锁争用剖析]";
+
+    CameraInfoTable* table = DEVICE_DB()->cameraInfoTable();
+    LockProfiler::reset();
+    LockProfiler::setEnabled(true);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 2; ++t) {
+      threads.emplace_back([=]() {
+        for (int i = 0; i < 5; ++i) {
+          auto id = table->insert(
+              createTestCamera(QString("_lockprof_%1_%2").arg(t).arg(i)));
+          if (id.success) table->deleteById(id.data);
+        }
+      });
+    }
+    for (auto& thread : threads) thread.join();
+    LockProfiler::setEnabled(false);
+
+    QJsonObject tableLock;
+    QJsonObject poolLock;
+    for (const QJsonValue& v : LockProfiler::report()) {
+      const QJsonObject o = v.toObject();
+      const QString name = o["name"].toString();
+      if (name == "BaseTableOperations::m_mutex[camera_info]") tableLock = o;
+      if (name.startsWith("ConnectionPool::m_mutex[")) poolLock = o;
+    }
+    const QJsonArray sites = tableLock["topSites"].toArray();
+    const QString topSite =
+        sites.isEmpty() ? QString()
+                        : sites.first().toObject()["site"].toString();
+    TEST_ASSERT(tableLock["acquisitions"].toDouble() >= 20 &&
+                    !poolLock.isEmpty(),
+                "表锁与连接池锁均有加锁计数");
+    TEST_ASSERT(topSite.startsWith("CameraInfoTable.cpp:"), "记录了加锁位置");
+    TEST_ASSERT(tableLock["hold"].toObject()["totalNs"].toDouble() > 0,
+                "记录了持有时间");
+
+    // 关闭后不再计数
+    const double before = tableLock["acquisitions"].toDouble();
+    table->selectById(1);
+    double after = 0;
+    for (const QJsonValue& v : LockProfiler::report()) {
+      const QJsonObject o = v.toObject();
+      if (o["name"].toString() == tableLock["name"].toString()) {
+        after = o["acquisitions"].toDouble();
+      }
+    }
+    TEST_ASSERT(after == before, "关闭剖析后不再计数");
+    qInfo().noquote() << LockProfiler::summary();
+    LockProfiler::reset();
+  }
+
+  /**
+   * @brief 测试查询计划回归
+   */
+  void testQueryPlans() {
+    qInfo() << "\n[测试查询计划回归]";
+
+    struct Suite {
+      QString label;
+      BaseTableOperations* ops;  // 借其连接读取所属库的结构
+      QList<PlanExpectation> expectations;
+    };
+    const QList<Suite> suites = {
+        {"相机信息表", DEVICE_DB()->cameraInfoTable()->operations(),
+         CameraInfoTable::planExpectations()},
+        {"系统日志表", DATA_DB()->systemLogTable()->operations(),
+         SystemLogTable::planExpectations()},
+        {"文件附件表", DATA_DB()->fileAttachmentTable()->operations(),
+         FileAttachmentTable::planExpectations()},
+        {"操作审计表", SYSTEM_DB()->operationAuditTable()->operations(),
+         OperationAuditTable::planExpectations()},
+        {"图像数据表", EXPERIMENT_DB()->imageDataTable()->operations(),
+         ImageDataTable::planExpectations()},
+        {"实验数据表", EXPERIMENT_DB()->experimentDataTable()->operations(),
+         ExperimentDataTable::planExpectations()}};
+
+    const QString fixtureName = "query_plan_fixture";
+    for (const Suite& suite : suites) {
+      QString error;
+      QString report;
+      int checked = 0;
+      const bool probeRegression = suite.ops->tableName() == "camera_info";
+      bool detectsRegression = false;
+      {
+        auto source = suite.ops->acquireDb();
+        QSqlDatabase fixture =
+            QSqlDatabase::addDatabase("QSQLITE", fixtureName);
+        fixture.setDatabaseName(":memory:");
+        if (!fixture.open()) {
+          error = fixture.lastError().text();
+        } else if (QueryPlanChecker::prepareFixture(source.db, fixture, 100000,
+                                                    10, &error)) {
+          const auto results =
+              QueryPlanChecker::checkAll(fixture, suite.expectations);
+          checked = results.size();
+          report = QueryPlanChecker::report(results);
+
+          // 删掉索引后，同一期望应当报告退化
+          if (probeRegression) {
+            QSqlQuery(fixture).exec("DROP INDEX idx_camera_info_mfr");
+            const PlanCheckResult r = QueryPlanChecker::check(
+                fixture, {"mfr", "SELECT id FROM camera_info WHERE "
+                                 "manufacturer = ?",
+                          {"idx_camera_info_mfr"}});
+            const QString diff = r.describe();
+            qInfo().noquote() << diff;
+            detectsRegression = !r.passed() &&
+                                diff.contains("- 未使用 idx_camera_info_mfr") &&
+                                diff.contains(QRegularExpression(
+                                    "\\+ SCAN (TABLE )?camera_info"));
+          }
+        }
+        fixture.close();
+      }
+      QSqlDatabase::removeDatabase(fixtureName);
+
+      TEST_ASSERT(error.isEmpty(), suite.label + " 准备查询计划检查库", error);
+      TEST_ASSERT(checked > 0 && report.isEmpty(),
+                  QString("%1 %2 条语句的查询计划符合期望")
+                      .arg(suite.label)
+                      .arg(checked),
+                  report);
+      if (probeRegression) {
+        TEST_ASSERT(detectsRegression, "删除索引后报告计划退化");
+      }
+    }
+  }
+
+  /**
+   * @brief 测试负载采集
+   */
+  void testWorkloadCapture() {
+    qInfo() << "\n[测试负载采集]";
+
+    TEST_ASSERT(WorkloadCapture::fingerprint(
+                    "SELECT a FROM t  WHERE id IN (1, 2, 3) AND b = 'x''y'") ==
+                    "SELECT a FROM t WHERE id IN (?...) AND b = ?",
+                "指纹替换字面量并合并参数列表");
+
+    QTemporaryDir dir;
+    CameraInfoTable* table = DEVICE_DB()->cameraInfoTable();
+    const CameraInfo camera = createTestCamera("_capture");
+    const QString plainPath = dir.filePath("plain.bin");
+    TEST_ASSERT(WorkloadCapture::start(plainPath), "开始采集");
+    auto id = table->insert(camera);
+    if (id.success) table->selectById(id.data);
+    const WorkloadCapture::Stats stats = WorkloadCapture::stop();
+    TEST_ASSERT(id.success && stats.statements >= 3, "采集到插入与查询语句");
+
+    WorkloadLog log;
+    QString error;
+    bool foundSerial = false;
+    bool insertCaptured = false;
+    if (WorkloadCapture::read(plainPath, &log, &error)) {
+      for (const CapturedStatement& st : log.statements) {
+        insertCaptured = insertCaptured ||
+                         log.sql[st.sqlId].contains("INSERT INTO camera_info");
+        foundSerial = foundSerial || st.params.contains(camera.serialNumber);
+      }
+    }
+    TEST_ASSERT(error.isEmpty() && insertCaptured && foundSerial &&
+                    log.threads.size() == 1,
+                "读回的日志含插入语句与原始参数");
+
+    // 脱敏：序列号（插入语句的第4个参数）不再是原值，摘要不短于128位；
+    // 同次采集内相同值的摘要相同，两次采集的密钥不同、摘要也不同
+    const CameraInfo secret = createTestCamera("_redact");
+    const QString redactedPath = dir.filePath("redacted.bin");
+    WorkloadCapture::start(redactedPath, WorkloadRedaction::VALUES);
+    auto secretId = table->insert(secret);
+    if (secretId.success) table->selectBySerialNumber(secret.serialNumber);
+    WorkloadCapture::stop();
+    WorkloadLog redacted;
+    bool leaked = false;
+    QString insertedSerial;
+    QString queriedSerial;
+    if (WorkloadCapture::read(redactedPath, &redacted)) {
+      for (const CapturedStatement& st : redacted.statements) {
+        for (const QVariant& v : st.params) {
+          leaked = leaked || v.toString() == secret.serialNumber;
+        }
+        const QString& sql = redacted.sql[st.sqlId];
+        if (sql.contains("INSERT INTO camera_info") && st.params.size() > 3) {
+          insertedSerial = st.params[3].toString();
+        } else if (sql.contains("WHERE serial_number = ?") &&
+                   st.params.size() == 1) {
+          queriedSerial = st.params[0].toString();
+        }
+      }
+    }
+    TEST_ASSERT(secretId.success && !leaked &&
+                    insertedSerial.size() >=
+                        qMax(32, secret.serialNumber.size()) &&
+                    insertedSerial == queriedSerial &&
+                    redacted.redaction == WorkloadRedaction::VALUES,
+                "脱敏后参数不含原值、摘要足够长且相等关系不变");
+
+    const QString secondPath = dir.filePath("redacted2.bin");
+    WorkloadCapture::start(secondPath, WorkloadRedaction::VALUES);
+    table->selectBySerialNumber(secret.serialNumber);
+    WorkloadCapture::stop();
+    WorkloadLog second;
+    bool reused = false;
+    if (WorkloadCapture::read(secondPath, &second)) {
+      for (const CapturedStatement& st : second.statements) {
+        reused = reused || st.params.contains(insertedSerial);
+      }
+    }
+    TEST_ASSERT(!insertedSerial.isEmpty() && !reused,
+                "每次采集的脱敏密钥不同");
+
+    // 结束后不再记录
+    const quint64 before = WorkloadCapture::stats().statements;
+    table->deleteById(id.data);
+    table->deleteById(secretId.data);
+    TEST_ASSERT(!WorkloadCapture::enabled() &&
+                    WorkloadCapture::stats().statements == before,
+                "结束采集后不再记录");
+
+  }
+
+  /**
+   * @brief 测试设备库的业务规则与原生SQL函数
+   */
+  void testSqlFunctions() {
+    qInfo() << "\n[测试原生SQL函数]";
+
+    TEST_ASSERT(DeviceRules::normalizeSerial(" AB C\t1") == "ABC1" &&
+                    DeviceRules::isValidSerial("ABC1") &&
+                    !DeviceRules::isValidSerial("AB C1") &&
+                    !DeviceRules::isValidSerial(QString()),
+                "序列号规范化与校验");
+    int w = 0;
+    int h = 0;
+    TEST_ASSERT(DeviceRules::parseResolution(" 1920 x 1080", &w, &h) &&
+                    w == 1920 && h == 1080 &&
+                    !DeviceRules::parseResolution("1920", &w, &h) &&
+                    !DeviceRules::parseResolution("0x1080", &w, &h),
+                "分辨率解析");
+    const QDateTime now = QDateTime::currentDateTime();
+    TEST_ASSERT(DeviceRules::isOnline(true, now.addSecs(-10), 30, now) &&
+                    !DeviceRules::isOnline(true, now.addSecs(-40), 30, now) &&
+                    !DeviceRules::isOnline(false, now, 30, now),
+                "心跳超时判断");
+
+    // 绕过校验直接写入一条非法序列号，两种构建都应查得到
+    CameraInfoTable* table = DEVICE_DB()->cameraInfoTable();
+    {
+      auto c = table->operations()->acquireDb();
+      QSqlQuery query(c.db);
+      query.exec(
+          "INSERT INTO camera_info (name, serial_number) "
+          "VALUES ('Invalid Serial Camera', 'BAD SERIAL_fn')");
+    }
+    auto invalid = table->selectInvalidSerials();
+    bool found = false;
+    for (const CameraInfo& camera : invalid.data) {
+      found = found || camera.serialNumber == "BAD SERIAL_fn";
+    }
+    TEST_ASSERT(invalid.success && found, "查询非法序列号");
+
+    if (SqlFunctions::available()) {
+      auto c = table->operations()->acquireDb();
+      QSqlQuery query(c.db);
+      const bool scalars =
+          query.exec(
+              "SELECT serial_normalize(' a b'), serial_valid('A B'), "
+              "resolution_width('640x480'), resolution_pixels('1920x1080'), "
+              "resolution_height('bad'), "
+              "camera_online(1, '2026-01-01T00:00:00', 30, "
+              "'2026-01-01T00:00:20'), "
+              "camera_online(1, '2026-01-01T00:00:00', 30, "
+              "'2026-01-01T00:01:00')") &&
+          query.next();
+      TEST_ASSERT(scalars && query.value(0).toString() == "ab" &&
+                      query.value(1).toInt() == 0 &&
+                      query.value(2).toInt() == 640 &&
+                      query.value(3).toLongLong() == 1920 * 1080 &&
+                      query.value(4).isNull() && query.value(5).toInt() == 1 &&
+                      query.value(6).toInt() == 0,
+                  "标量函数在查询内求值",
+                  query.lastError().text());
+
+      const bool aggregate =
+          query.exec(
+              "SELECT resolution_max(column1) FROM (VALUES ('640x480'), "
+              "('1920x1080'), ('bad'), ('1280X720'))") &&
+          query.next();
+      TEST_ASSERT(aggregate && query.value(0).toString() == "1920x1080",
+                  "聚合函数", query.lastError().text());
+
+      // 确定性函数可用于表达式索引
+      query.exec("CREATE TEMP TABLE fn_res (resolution TEXT)");
+      const bool indexed = query.exec(
+          "CREATE INDEX temp.idx_fn_res_pixels ON "
+          "fn_res(resolution_pixels(resolution))");
+      query.exec(
+          "EXPLAIN QUERY PLAN SELECT * FROM fn_res "
+          "WHERE resolution_pixels(resolution) > 1000000");
+      QString plan;
+      while (query.next()) plan += query.value(3).toString() + ";";
+      TEST_ASSERT(indexed && plan.contains("idx_fn_res_pixels"),
+                  "表达式索引命中", plan);
+      query.exec("DROP TABLE temp.fn_res");
+    }
+
+    auto c = table->operations()->acquireDb();
+    QSqlQuery(c.db).exec(
+        "DELETE FROM camera_info WHERE serial_number = 'BAD SERIAL_fn'");
+  }
+
+  /**
+   * @brief 测试序列号成员索引
+   */
+  void testSerialIndex() {
+    qInfo() << "\n[测试序列号成员索引]";
+
+    CameraInfoTable* table = DEVICE_DB()->cameraInfoTable();
+    MembershipIndex* index = table->serialIndex();
+    TEST_ASSERT(index->rebuild() && index->isReady(), "同步重建索引");
+
+    CameraInfo camera = createTestCamera("_bloom_1");
+    auto id = table->insert(camera);
+    TEST_ASSERT(id.success && table->serialNumberExists(camera.serialNumber),
+                "插入后立即可见");
+
+    // 序列号未变的更新不计入键数，不会引发无谓的重建
+    const qint64 keys = index->stats().keys;
+    camera.id = id.data;
+    camera.name += "_renamed";
+    TEST_ASSERT(table->update(camera).success && index->stats().keys == keys,
+                "序列号未变的更新不改动索引");
+
+    // 线程事务内的插入提交后才加入索引，回滚则不加入
+    DeviceDatabaseManager* deviceDb = DEVICE_DB();
+    CameraInfo txCamera = createTestCamera("_bloom_tx");
+    TEST_ASSERT(deviceDb->beginTransaction(), "开始事务");
+    auto txId = table->insert(txCamera);
+    const qint64 keysInTx = index->stats().keys;
+    deviceDb->rollbackTransaction();
+    TEST_ASSERT(txId.success && keysInTx == keys &&
+                    index->stats().keys == keys,
+                "回滚的插入不加入索引");
+    TEST_ASSERT(deviceDb->beginTransaction(), "开始事务");
+    txId = table->insert(txCamera);
+    TEST_ASSERT(index->stats().keys == keys, "提交前不加入索引");
+    TEST_ASSERT(deviceDb->commitTransaction() && txId.success &&
+                    index->stats().keys == keys + 1 &&
+                    table->serialNumberExists(txCamera.serialNumber),
+                "提交后加入索引");
+    table->deleteById(txId.data);
+
+    // 不存在的序列号绝大多数由索引直接判定（10 位/键，误判约 1%）
+    const MembershipIndexStats before = index->stats();
+    bool anyFound = false;
+    for (int i = 0; i < 200; ++i) {
+      anyFound = anyFound ||
+                 table->serialNumberExists(QString("BLOOM_MISS_%1").arg(i));
+    }
+    const MembershipIndexStats after = index->stats();
+    TEST_ASSERT(!anyFound && after.lookups - before.lookups == 200 &&
+                    after.negatives - before.negatives >= 180,
+                "不存在的序列号不查库",
+                QString::number(after.negatives - before.negatives));
+
+    // 绕过表类写入的行在重建后可见
+    {
+      auto c = table->operations()->acquireDb();
+      QSqlQuery(c.db).exec(
+          "INSERT INTO camera_info (name, serial_number) "
+          "VALUES ('Bypass Camera', 'BLOOM_BYPASS')");
+    }
+    CameraInfo duplicate = createTestCamera("_bloom_2");
+    duplicate.serialNumber = "BLOOM_BYPASS";
+    TEST_ASSERT(!table->insert(duplicate).success, "唯一约束兜底");
+    TEST_ASSERT(index->rebuild() && table->serialNumberExists("BLOOM_BYPASS"),
+                "重建后包含绕过写入的行");
+
+    index->setEnabled(false);
+    const quint64 lookups = index->stats().lookups;
+    table->serialNumberExists("BLOOM_MISS_0");
+    TEST_ASSERT(index->stats().lookups == lookups, "关闭后直接查库");
+    index->setEnabled(true);
+
+    table->deleteById(id.data);
+    auto c = table->operations()->acquireDb();
+    QSqlQuery(c.db).exec(
+        "DELETE FROM camera_info WHERE serial_number = 'BLOOM_BYPASS'");
+  }
+
+  /**
+   * @brief 测试条件查询构建器
+   */
+  void testTableQuery() {
+    qInfo() << "\n[测试条件查询构建器]";
+
+    CameraInfoTable* table = DEVICE_DB()->cameraInfoTable();
+    // 取值不同、形状相同的查询生成同一段 SQL（即同一条缓存语句）
+    TableQuery a = table->tableQuery()
+                       .where("manufacturer", QueryOp::EQ, "A")
+                       .whereIn("id", {1, 2, 3})
+                       .orderBy("name")
+                       .limit(10, 0);
+    TableQuery b = table->tableQuery()
+                       .where("manufacturer", QueryOp::EQ, "B")
+                       .whereIn("id", {7, 8, 9, 10})
+                       .orderBy("name")
+                       .limit(20, 40);
+    TableQuery c = table->tableQuery().whereIn("id", {1, 2, 3, 4, 5});
+    TEST_ASSERT(a.isValid() && a.sql() == b.sql() &&
+                    !a.sql().contains("'") && a.bindValues().size() == 7 &&
+                    c.bindValues().size() == 8,
+                "同形状同SQL，IN 列表按 2 的幂补齐", a.sql());
+
+    TableQuery bad = table->tableQuery().where("id; DROP TABLE camera_info",
+                                               QueryOp::EQ, 1);
+    TEST_ASSERT(!bad.isValid() && !table->select(bad).success &&
+                    !table->count(bad).success,
+                "白名单外的列被拒绝", bad.error());
+
+    const QString maker = "Criteria Test Corp";
+    QList<int> ids;
+    for (int i = 0; i < 5; ++i) {
+      CameraInfo camera = createTestCamera(QString("_criteria_%1").arg(i));
+      camera.manufacturer = maker;
+      ids << table->insert(camera).data;
+    }
+
+    auto rows = table->select(table->tableQuery()
+                                  .where("manufacturer", QueryOp::EQ, maker)
+                                  .whereBetween("id", ids[1], ids[3])
+                                  .orderBy("id", false)
+                                  .limit(2));
+    TEST_ASSERT(rows.success && rows.data.size() == 2 &&
+                    rows.data[0].id == ids[3] && rows.data[1].id == ids[2] &&
+                    rows.data[0].manufacturer == maker,
+                "条件、区间、排序与行数限制", rows.errorMessage);
+
+    auto total = table->count(table->tableQuery()
+                                  .where("manufacturer", QueryOp::EQ, maker)
+                                  .limit(1));
+    TEST_ASSERT(total.success && total.data == 5, "计数忽略行数限制");
+
+    TableQuery projected = table->tableQuery()
+                               .select({"serial_number", "id"})
+                               .where("manufacturer", QueryOp::LIKE,
+                                      "Criteria%")
+                               .orderBy("id");
+    auto columnar = table->selectColumnar(projected);
+    TEST_ASSERT(columnar.success && columnar.data.rowCount() == 5 &&
+                    columnar.data.columnCount() == 2 &&
+                    columnar.data.row(0).integer(1) == ids[0] &&
+                    !table->select(projected).success,
+                "投影只能取列式结果", columnar.errorMessage);
+
+    for (int id : ids) table->deleteById(id);
+  }
+
+  /**
+   * @brief 测试原生语句路径与 QSqlQuery 路径结果一致
+   */
+  void testNativeStatements() {
+    qInfo() << "\n[测试原生语句路径]";
+    qInfo() << "原生路径可用:" << NativeStatement::available();
+
+    CameraInfoTable* table = DEVICE_DB()->cameraInfoTable();
+    // 两条路径各写一行，再交叉读出比较
+    CameraInfo nativeCamera = createTestCamera("_native_1");
+    nativeCamera.version = QString();  // NULL 列
+    CameraInfo qtCamera = createTestCamera("_native_2");
+    qtCamera.manufacturer = QString();
+
+    auto nativeId = table->insert(nativeCamera);
+    NativeStatement::setEnabled(false);
+    auto qtId = table->insert(qtCamera);
+    auto qtRead1 = table->selectById(nativeId.data);
+    auto qtRead2 = table->selectById(qtId.data);
+    auto qtSerial = table->selectBySerialNumber(qtCamera.serialNumber);
+    const bool qtExists = table->serialNumberExists(nativeCamera.serialNumber);
+    NativeStatement::setEnabled(true);
+    auto nativeRead1 = table->selectById(nativeId.data);
+    auto nativeRead2 = table->selectById(qtId.data);
+    auto nativeSerial = table->selectBySerialNumber(qtCamera.serialNumber);
+
+    TEST_ASSERT(nativeId.success && qtId.success &&
+                    qtId.data > nativeId.data,
+                "两条路径插入并返回新ID");
+    auto same = [](const CameraInfo& a, const CameraInfo& b) {
+      return a.id == b.id && a.name == b.name && a.version == b.version &&
+             a.version.isNull() == b.version.isNull() &&
+             a.connectionType == b.connectionType &&
+             a.serialNumber == b.serialNumber &&
+             a.manufacturer == b.manufacturer &&
+             a.manufacturer.isNull() == b.manufacturer.isNull() &&
+             a.createdAt == b.createdAt && a.updatedAt == b.updatedAt;
+    };
+    TEST_ASSERT(nativeRead1.success && qtRead1.success &&
+                    same(nativeRead1.data, qtRead1.data) &&
+                    nativeRead1.data.version.isNull() &&
+                    nativeRead1.data.createdAt.isValid(),
+                "原生路径写入的行两条路径读出一致");
+    TEST_ASSERT(nativeRead2.success && qtRead2.success &&
+                    same(nativeRead2.data, qtRead2.data) &&
+                    nativeRead2.data.manufacturer.isNull(),
+                "QSqlQuery 路径写入的行两条路径读出一致");
+    TEST_ASSERT(nativeSerial.success && qtSerial.success &&
+                    same(nativeSerial.data, qtSerial.data),
+                "按序列号查询结果一致");
+    TEST_ASSERT(qtExists &&
+                    table->serialNumberExists(nativeCamera.serialNumber) &&
+                    !table->serialNumberExists(nativeCamera.serialNumber,
+                                               nativeId.data),
+                "序列号存在性检查一致");
+    TEST_ASSERT(!table->selectById(std::numeric_limits<int>::max()).success &&
+                    !table->insert(nativeCamera).success,
+                "未找到与序列号冲突照常报错");
+
+    table->deleteById(nativeId.data);
+    table->deleteById(qtId.data);
   }
 
   /**
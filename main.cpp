@@ -3,6 +3,7 @@
 #include <QTextCodec>
 
 #include "DatabaseTestExample.h"
+#include "SystemLogSink.h"
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -29,6 +30,9 @@ int main(int argc, char* argv[]) {
   QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
   setupConsoleEncoding();
 
+  // 日志经汇聚器异步回显并写入 SYSTEM_LOG（数据管理数据库就绪后生效）
+  SystemLogSink::installQtMessageHandler();
+
   qInfo() << "数据库框架测试程序启动";
   qInfo() << "应用程序:" << app.applicationName() << app.applicationVersion();
   qInfo() << "Qt版本:" << QT_VERSION_STR;